@@ -0,0 +1,148 @@
+/**
+ * AI智能植物养护机器人 - ADC校准服务实现
+ */
+
+#include "AdcCalibration.h"
+#include <ArduinoJson.h>
+
+uint16_t* AdcCalibration::lookupTables[ADC_ATTEN_MAX] = {nullptr};
+esp_adc_cal_characteristics_t AdcCalibration::characteristics[ADC_ATTEN_MAX];
+esp_adc_cal_value_t AdcCalibration::calibrationSources[ADC_ATTEN_MAX];
+bool AdcCalibration::characterized[ADC_ATTEN_MAX] = {false};
+bool AdcCalibration::initialized = false;
+
+/**
+ * 初始化校准服务
+ */
+bool AdcCalibration::begin() {
+    if (initialized) {
+        return true;
+    }
+
+    DEBUG_PRINTLN("初始化ADC校准服务...");
+
+    // 各模拟通道默认使用11dB衰减 (0-3.1V量程)
+    initialized = enableAttenuation(ADC_ATTEN_DB_11);
+    return initialized;
+}
+
+/**
+ * 为指定衰减建立查找表
+ */
+bool AdcCalibration::enableAttenuation(adc_atten_t atten) {
+    if (atten < 0 || atten >= ADC_ATTEN_MAX) {
+        return false;
+    }
+    if (lookupTables[atten] != nullptr) {
+        return true;
+    }
+    return buildTable(atten);
+}
+
+/**
+ * 读取eFuse特性参数并建立查找表
+ */
+bool AdcCalibration::buildTable(adc_atten_t atten) {
+    calibrationSources[atten] = esp_adc_cal_characterize(
+        ADC_UNIT_1, atten, ADC_WIDTH_BIT_12, DEFAULT_VREF, &characteristics[atten]
+    );
+    characterized[atten] = true;
+
+    switch (calibrationSources[atten]) {
+        case ESP_ADC_CAL_VAL_EFUSE_TP:
+            DEBUG_PRINTF("ADC衰减%d: 使用eFuse两点校准\n", (int)atten);
+            break;
+        case ESP_ADC_CAL_VAL_EFUSE_TP_FIT:
+            // ESP32-S3 出厂写入两点值和拟合曲线系数
+            DEBUG_PRINTF("ADC衰减%d: 使用eFuse两点拟合校准\n", (int)atten);
+            break;
+        case ESP_ADC_CAL_VAL_EFUSE_VREF:
+            DEBUG_PRINTF("ADC衰减%d: 使用eFuse参考电压\n", (int)atten);
+            break;
+        default:
+            DEBUG_PRINTF("ADC衰减%d: 无eFuse数据，使用默认参考电压\n", (int)atten);
+            break;
+    }
+
+    uint16_t* table = (uint16_t*)malloc(TABLE_SIZE * sizeof(uint16_t));
+    if (table == nullptr) {
+        // 内存不足时退回逐次计算，结果一致但速度较慢
+        DEBUG_PRINTLN("✗ ADC查找表内存分配失败，使用逐次换算");
+        return false;
+    }
+
+    for (int raw = 0; raw < TABLE_SIZE; raw++) {
+        uint32_t millivolts = esp_adc_cal_raw_to_voltage(raw, &characteristics[atten]);
+        table[raw] = millivolts > MAX_MILLIVOLTS ? MAX_MILLIVOLTS : millivolts;
+    }
+    lookupTables[atten] = table;
+
+    DEBUG_PRINTF("✓ ADC查找表就绪: 衰减%d, 0->%umV, %d->%umV\n",
+                 (int)atten, table[0], TABLE_SIZE - 1, table[TABLE_SIZE - 1]);
+    return true;
+}
+
+/**
+ * 原始ADC值转换为毫伏
+ */
+uint16_t AdcCalibration::rawToMillivolts(int raw, adc_atten_t atten) {
+    if (raw < 0) {
+        raw = 0;
+    } else if (raw >= TABLE_SIZE) {
+        raw = TABLE_SIZE - 1;
+    }
+
+    const uint16_t* table = lookupTables[atten];
+    if (table != nullptr) {
+        return table[raw];
+    }
+
+    if (!characterized[atten]) {
+        enableAttenuation(atten);
+        if (lookupTables[atten] != nullptr) {
+            return lookupTables[atten][raw];
+        }
+    }
+
+    uint32_t millivolts = esp_adc_cal_raw_to_voltage(raw, &characteristics[atten]);
+    return millivolts > MAX_MILLIVOLTS ? MAX_MILLIVOLTS : millivolts;
+}
+
+/**
+ * 读取引脚并返回校准后的毫伏值
+ */
+uint16_t AdcCalibration::readMillivolts(int pin, adc_atten_t atten) {
+    return rawToMillivolts(analogRead(pin), atten);
+}
+
+/**
+ * 是否使用了eFuse中的校准数据
+ */
+bool AdcCalibration::isEfuseCalibrated(adc_atten_t atten) {
+    return characterized[atten] &&
+           calibrationSources[atten] != ESP_ADC_CAL_VAL_DEFAULT_VREF;
+}
+
+/**
+ * 获取校准信息
+ */
+String AdcCalibration::getCalibrationInfo() {
+    DynamicJsonDocument doc(512);
+
+    doc["initialized"] = initialized;
+    JsonArray attenuations = doc.createNestedArray("attenuations");
+    for (int atten = 0; atten < ADC_ATTEN_MAX; atten++) {
+        if (!characterized[atten]) {
+            continue;
+        }
+        JsonObject entry = attenuations.createNestedObject();
+        entry["atten"] = atten;
+        entry["efuse"] = isEfuseCalibrated((adc_atten_t)atten);
+        entry["source"] = (int)calibrationSources[atten];
+        entry["table"] = lookupTables[atten] != nullptr;
+    }
+
+    String result;
+    serializeJson(doc, result);
+    return result;
+}
@@ -0,0 +1,76 @@
+/**
+ * AI智能植物养护机器人 - ADC校准服务
+ * 读取芯片eFuse中的ADC校准参数，启动时为每种衰减建立 原始值->毫伏 查找表
+ * 土壤湿度、光照、电池和触摸通道统一使用整数查表转换
+ */
+
+#ifndef ADC_CALIBRATION_H
+#define ADC_CALIBRATION_H
+
+#include <Arduino.h>
+#include <esp_adc_cal.h>
+#include "config.h"
+
+/**
+ * ADC校准服务 (全局共享，静态方法)
+ */
+class AdcCalibration {
+public:
+    static const int TABLE_SIZE = 1 << ADC_RESOLUTION;   // 查找表大小 (12位: 4096)
+    static const uint32_t DEFAULT_VREF = 1100;          // 无eFuse数据时的参考电压 (mV)
+    static const uint16_t MAX_MILLIVOLTS = 3300;        // 转换结果上限 (mV)
+
+private:
+    static uint16_t* lookupTables[ADC_ATTEN_MAX];       // 各衰减的查找表 (按需建立)
+    static esp_adc_cal_characteristics_t characteristics[ADC_ATTEN_MAX];
+    static esp_adc_cal_value_t calibrationSources[ADC_ATTEN_MAX];
+    static bool characterized[ADC_ATTEN_MAX];
+    static bool initialized;
+
+    static bool buildTable(adc_atten_t atten);
+
+public:
+    /**
+     * 初始化校准服务并建立默认衰减 (11dB) 的查找表
+     * 可重复调用，只在首次调用时执行
+     * @return 初始化是否成功
+     */
+    static bool begin();
+
+    /**
+     * 为指定衰减建立查找表
+     * @param atten ADC衰减
+     * @return 是否成功
+     */
+    static bool enableAttenuation(adc_atten_t atten);
+
+    /**
+     * 原始ADC值转换为毫伏 (一次查表)
+     * @param raw 原始ADC值
+     * @param atten 采样时使用的衰减
+     * @return 电压 (mV)
+     */
+    static uint16_t rawToMillivolts(int raw, adc_atten_t atten = ADC_ATTEN_DB_11);
+
+    /**
+     * 读取引脚并返回校准后的毫伏值
+     * @param pin ADC引脚
+     * @param atten 该引脚的衰减设置
+     * @return 电压 (mV)
+     */
+    static uint16_t readMillivolts(int pin, adc_atten_t atten = ADC_ATTEN_DB_11);
+
+    /**
+     * 是否使用了eFuse中的校准数据
+     * @param atten ADC衰减
+     */
+    static bool isEfuseCalibrated(adc_atten_t atten = ADC_ATTEN_DB_11);
+
+    /**
+     * 获取校准信息
+     * @return JSON格式的校准信息
+     */
+    static String getCalibrationInfo();
+};
+
+#endif // ADC_CALIBRATION_H
@@ -10,14 +10,45 @@ const unsigned long DEFAULT_REPEAT_INTERVAL = REPEAT_ALERT_INTERVAL;      // 2
 const unsigned long DEFAULT_SNOOZE_TIME = 30 * 60 * 1000;               // 30分钟
 const int DEFAULT_MAX_REPEAT_COUNT = 10;                                 // 最大重复10次
 
+// 提醒状态机表
+//   INACTIVE ──异常──▶ ABNORMAL{ PENDING ──到期──▶ ACTIVE ──确认/暂停/重复用尽──▶ ACKNOWLEDGED/SNOOZED ──到期──▶ PENDING }
+//   ABNORMAL 中报告新的异常类型重新进入 PENDING，报告正常回到 INACTIVE
+constexpr AlertStateTable AlertManager::stateTable = makeHsmTable<(size_t)AlertEvent::COUNT>(
+    std::array<HsmStateDef<AlertState, AlertManager>, ALERT_STATE_COUNT>{{
+        {AlertState::INACTIVE,     AlertState::INACTIVE, onInactiveEntry,     nullptr},
+        {AlertState::PENDING,      AlertState::ABNORMAL, onPendingEntry,      nullptr},
+        {AlertState::ACTIVE,       AlertState::ABNORMAL, onActiveEntry,       onActiveExit},
+        {AlertState::ACKNOWLEDGED, AlertState::ABNORMAL, onAcknowledgedEntry, nullptr},
+        {AlertState::SNOOZED,      AlertState::ABNORMAL, onSnoozedEntry,      nullptr},
+        {AlertState::ABNORMAL,     AlertState::ABNORMAL, nullptr,             nullptr}
+    }},
+    std::array<HsmTransition<AlertState, AlertEvent, AlertManager>, ALERT_TRANSITION_COUNT>{{
+        {AlertState::INACTIVE,     AlertEvent::ABNORMAL,    AlertState::PENDING,      nullptr,          beginAlert,          false},
+        {AlertState::ABNORMAL,     AlertEvent::ABNORMAL,    AlertState::PENDING,      nullptr,          beginAlert,          false},
+        {AlertState::ABNORMAL,     AlertEvent::NORMAL,      AlertState::INACTIVE,     nullptr,          nullptr,             false},
+        {AlertState::PENDING,      AlertEvent::ESCALATE,    AlertState::PENDING,      nullptr,          escalateAlert,       true},
+        {AlertState::PENDING,      AlertEvent::TIMEOUT,     AlertState::ACTIVE,       nullptr,          nullptr,             false},
+        {AlertState::ACTIVE,       AlertEvent::TIMEOUT,     AlertState::ACKNOWLEDGED, repeatsExhausted, nullptr,             false},
+        {AlertState::ACTIVE,       AlertEvent::TIMEOUT,     AlertState::ACTIVE,       nullptr,          repeatAlert,         true},
+        {AlertState::ACTIVE,       AlertEvent::ACKNOWLEDGE, AlertState::ACKNOWLEDGED, nullptr,          countAcknowledgment, false},
+        {AlertState::ACTIVE,       AlertEvent::SNOOZE,      AlertState::SNOOZED,      nullptr,          countSnooze,         false},
+        {AlertState::ACKNOWLEDGED, AlertEvent::TIMEOUT,     AlertState::PENDING,      nullptr,          nullptr,             false},
+        {AlertState::SNOOZED,      AlertEvent::TIMEOUT,     AlertState::PENDING,      nullptr,          nullptr,             false}
+    }}
+);
+
 AlertManager::AlertManager()
-    : alertDelay(DEFAULT_ALERT_DELAY)
+    : machine(stateTable, *this, AlertState::INACTIVE, AlertEvent::TIMEOUT, TraceSource::ALERT_MANAGER)
+    , alertDelay(DEFAULT_ALERT_DELAY)
     , repeatInterval(DEFAULT_REPEAT_INTERVAL)
     , snoozeTime(DEFAULT_SNOOZE_TIME)
     , maxRepeatCount(DEFAULT_MAX_REPEAT_COUNT)
     , isEnabled(true)
     , isAlerting(false)
     , lastUpdateTime(0)
+    , pendingType(AlertType::NONE)
+    , pendingUrgent(false)
+    , pendingSnooze(0)
     , alertCallback(nullptr)
     , stopCallback(nullptr)
     , totalAlerts(0)
@@ -33,6 +64,9 @@ AlertManager::AlertManager()
     currentAlert.repeatCount = 0;
     currentAlert.isUrgent = false;
     currentAlert.message = "";
+    
+    static_assert(stateTable.valid, "提醒状态定义的顺序与枚举值不一致或父状态无效");
+    machine.start();
 }
 
 AlertManager::~AlertManager() {
@@ -58,20 +92,11 @@ void AlertManager::update() {
         return;
     }
     
-    unsigned long currentTime = millis();
-    lastUpdateTime = currentTime;
-    
-    // 更新提醒状态
-    updateAlertState();
-    
-    // 检查是否需要触发提醒
-    if (shouldTriggerAlert()) {
-        triggerAlert();
-    }
+    lastUpdateTime = millis();
     
-    // 检查是否需要重复提醒
-    if (shouldRepeatAlert()) {
-        triggerAlert();
+    // 只有定时器到期时才运行状态机
+    if (machine.poll()) {
+        currentAlert.state = machine.getState();
     }
 }
 
@@ -80,88 +105,129 @@ void AlertManager::reportAbnormalState(AlertType type, bool isUrgent) {
         return;
     }
     
-    unsigned long currentTime = millis();
-    
     DEBUG_PRINTF("AlertManager: 报告异常状态 - 类型: %d, 紧急: %s\n", 
                  (int)type, isUrgent ? "是" : "否");
     
     // 如果是新的异常类型或者从正常状态转为异常状态
-    if (currentAlert.type != type || currentAlert.state == AlertState::INACTIVE) {
-        currentAlert.type = type;
-        currentAlert.state = AlertState::PENDING;
-        currentAlert.startTime = currentTime;
-        currentAlert.lastAlertTime = 0;
-        currentAlert.acknowledgeTime = 0;
-        currentAlert.repeatCount = 0;
-        currentAlert.isUrgent = isUrgent;
-        currentAlert.message = getAlertMessage(type);
-        
-        DEBUG_PRINTF("AlertManager: 开始异常状态监测，类型: %d\n", (int)type);
+    if (currentAlert.type != type || !machine.isIn(AlertState::ABNORMAL)) {
+        pendingType = type;
+        pendingUrgent = isUrgent;
+        dispatchEvent(AlertEvent::ABNORMAL);
+        return;
     }
     
     // 更新紧急状态
     if (isUrgent && !currentAlert.isUrgent) {
         currentAlert.isUrgent = true;
         DEBUG_PRINTLN("AlertManager: 状态升级为紧急");
+        dispatchEvent(AlertEvent::ESCALATE);
     }
 }
 
 void AlertManager::reportNormalState() {
-    if (currentAlert.state != AlertState::INACTIVE) {
+    if (machine.isIn(AlertState::ABNORMAL)) {
         DEBUG_PRINTLN("AlertManager: 报告正常状态，清除提醒");
-        
-        // 停止当前提醒
-        if (isAlerting) {
-            stopAlert();
-        }
-        
-        // 重置提醒状态
-        currentAlert.type = AlertType::NONE;
-        currentAlert.state = AlertState::INACTIVE;
-        currentAlert.startTime = 0;
-        currentAlert.lastAlertTime = 0;
-        currentAlert.acknowledgeTime = 0;
-        currentAlert.repeatCount = 0;
-        currentAlert.isUrgent = false;
-        currentAlert.message = "";
+        dispatchEvent(AlertEvent::NORMAL);
     }
 }
 
 void AlertManager::acknowledgeAlert() {
-    if (currentAlert.state == AlertState::ACTIVE) {
-        DEBUG_PRINTLN("AlertManager: 用户确认提醒");
-        
-        currentAlert.state = AlertState::ACKNOWLEDGED;
-        currentAlert.acknowledgeTime = millis();
-        totalAcknowledgments++;
-        
-        // 停止当前提醒
-        if (isAlerting) {
-            stopAlert();
-        }
-    }
+    dispatchEvent(AlertEvent::ACKNOWLEDGE);
 }
 
 void AlertManager::snoozeAlert(unsigned long duration) {
-    if (currentAlert.state == AlertState::ACTIVE) {
-        unsigned long snoozeDuration = (duration > 0) ? duration : snoozeTime;
-        
-        DEBUG_PRINTF("AlertManager: 暂停提醒 %lu 分钟\n", snoozeDuration / 60000);
-        
-        currentAlert.state = AlertState::SNOOZED;
-        currentAlert.acknowledgeTime = millis();
-        totalSnoozes++;
-        
-        // 停止当前提醒
-        if (isAlerting) {
-            stopAlert();
-        }
-        
-        // 设置下次提醒时间
-        currentAlert.lastAlertTime = millis() - repeatInterval + snoozeDuration;
+    pendingSnooze = (duration > 0) ? duration : snoozeTime;
+    dispatchEvent(AlertEvent::SNOOZE);
+}
+
+void AlertManager::dispatchEvent(AlertEvent event) {
+    machine.dispatch(event);
+    currentAlert.state = machine.getState();
+}
+
+void AlertManager::armRepeatTimer() {
+    // 重复次数用尽后立即到期，由 repeatsExhausted 转入已确认状态
+    machine.armTimer(currentAlert.repeatCount >= maxRepeatCount ? 0 : repeatInterval);
+}
+
+void AlertManager::onInactiveEntry(AlertManager& self) {
+    self.currentAlert.type = AlertType::NONE;
+    self.currentAlert.startTime = 0;
+    self.currentAlert.lastAlertTime = 0;
+    self.currentAlert.acknowledgeTime = 0;
+    self.currentAlert.repeatCount = 0;
+    self.currentAlert.isUrgent = false;
+    self.currentAlert.message = "";
+}
+
+void AlertManager::onPendingEntry(AlertManager& self) {
+    // 紧急状态立即提醒，否则等待剩余的延迟时间
+    unsigned long abnormalDuration = millis() - self.currentAlert.startTime;
+    if (self.currentAlert.isUrgent || abnormalDuration >= self.alertDelay) {
+        self.machine.armTimer(0);
+    } else {
+        self.machine.armTimer(self.alertDelay - abnormalDuration);
     }
 }
 
+void AlertManager::onActiveEntry(AlertManager& self) {
+    self.triggerAlert();
+    self.armRepeatTimer();
+}
+
+void AlertManager::onActiveExit(AlertManager& self) {
+    self.stopAlert();
+}
+
+void AlertManager::onAcknowledgedEntry(AlertManager& self) {
+    self.currentAlert.acknowledgeTime = millis();
+    self.machine.armTimer(self.snoozeTime);
+}
+
+void AlertManager::onSnoozedEntry(AlertManager& self) {
+    self.currentAlert.acknowledgeTime = millis();
+    self.machine.armTimer(self.pendingSnooze);
+}
+
+void AlertManager::beginAlert(AlertManager& self) {
+    self.currentAlert.type = self.pendingType;
+    self.currentAlert.startTime = millis();
+    self.currentAlert.lastAlertTime = 0;
+    self.currentAlert.acknowledgeTime = 0;
+    self.currentAlert.repeatCount = 0;
+    self.currentAlert.isUrgent = self.pendingUrgent;
+    self.currentAlert.message = self.getAlertMessage(self.pendingType);
+    
+    DEBUG_PRINTF("AlertManager: 开始异常状态监测，类型: %d\n", (int)self.pendingType);
+}
+
+void AlertManager::escalateAlert(AlertManager& self) {
+    self.machine.armTimer(0);
+}
+
+void AlertManager::repeatAlert(AlertManager& self) {
+    self.triggerAlert();
+    self.armRepeatTimer();
+}
+
+void AlertManager::countAcknowledgment(AlertManager& self) {
+    DEBUG_PRINTLN("AlertManager: 用户确认提醒");
+    self.totalAcknowledgments++;
+}
+
+void AlertManager::countSnooze(AlertManager& self) {
+    DEBUG_PRINTF("AlertManager: 暂停提醒 %lu 分钟\n", self.pendingSnooze / 60000);
+    self.totalSnoozes++;
+}
+
+bool AlertManager::repeatsExhausted(const AlertManager& self) {
+    if (self.currentAlert.repeatCount >= self.maxRepeatCount) {
+        DEBUG_PRINTLN("AlertManager: 达到最大重复次数，停止提醒");
+        return true;
+    }
+    return false;
+}
+
 void AlertManager::triggerAlert() {
     if (!isEnabled || currentAlert.type == AlertType::NONE) {
         return;
@@ -198,82 +264,6 @@ void AlertManager::stopAlert() {
     }
 }
 
-void AlertManager::updateAlertState() {
-    if (currentAlert.state == AlertState::INACTIVE) {
-        return;
-    }
-    
-    unsigned long currentTime = millis();
-    unsigned long abnormalDuration = currentTime - currentAlert.startTime;
-    
-    switch (currentAlert.state) {
-        case AlertState::PENDING:
-            // 检查是否到了提醒时间
-            if (abnormalDuration >= alertDelay || currentAlert.isUrgent) {
-                // 立即触发紧急提醒，或者等待时间已到
-                triggerAlert();
-            }
-            break;
-            
-        case AlertState::ACKNOWLEDGED:
-            // 已确认状态，检查是否需要重新进入等待状态
-            if (currentTime - currentAlert.acknowledgeTime > snoozeTime) {
-                currentAlert.state = AlertState::PENDING;
-                DEBUG_PRINTLN("AlertManager: 确认超时，重新进入等待状态");
-            }
-            break;
-            
-        case AlertState::SNOOZED:
-            // 暂停状态，检查是否可以重新提醒
-            if (currentTime - currentAlert.acknowledgeTime > snoozeTime) {
-                currentAlert.state = AlertState::PENDING;
-                DEBUG_PRINTLN("AlertManager: 暂停结束，重新进入等待状态");
-            }
-            break;
-            
-        case AlertState::ACTIVE:
-            // 活跃状态，检查是否达到最大重复次数
-            if (currentAlert.repeatCount >= maxRepeatCount) {
-                DEBUG_PRINTLN("AlertManager: 达到最大重复次数，停止提醒");
-                currentAlert.state = AlertState::ACKNOWLEDGED;
-                currentAlert.acknowledgeTime = currentTime;
-                stopAlert();
-            }
-            break;
-            
-        default:
-            break;
-    }
-}
-
-bool AlertManager::shouldTriggerAlert() const {
-    if (!isEnabled || isAlerting || currentAlert.state != AlertState::PENDING) {
-        return false;
-    }
-    
-    unsigned long currentTime = millis();
-    unsigned long abnormalDuration = currentTime - currentAlert.startTime;
-    
-    // 紧急状态立即提醒，否则等待延迟时间
-    return currentAlert.isUrgent || (abnormalDuration >= alertDelay);
-}
-
-bool AlertManager::shouldRepeatAlert() const {
-    if (!isEnabled || !isAlerting || currentAlert.state != AlertState::ACTIVE) {
-        return false;
-    }
-    
-    // 检查是否达到最大重复次数
-    if (currentAlert.repeatCount >= maxRepeatCount) {
-        return false;
-    }
-    
-    unsigned long currentTime = millis();
-    unsigned long timeSinceLastAlert = currentTime - currentAlert.lastAlertTime;
-    
-    return timeSinceLastAlert >= repeatInterval;
-}
-
 String AlertManager::getAlertMessage(AlertType type) const {
     switch (type) {
         case AlertType::NEEDS_WATER:
@@ -296,7 +286,7 @@ AlertInfo AlertManager::getCurrentAlert() const {
 }
 
 bool AlertManager::hasActiveAlert() const {
-    return currentAlert.state != AlertState::INACTIVE;
+    return machine.isIn(AlertState::ABNORMAL);
 }
 
 bool AlertManager::isCurrentlyAlerting() const {
@@ -337,9 +327,6 @@ void AlertManager::setEnabled(bool enabled) {
     isEnabled = enabled;
     if (!enabled) {
         // 禁用时停止所有提醒
-        if (isAlerting) {
-            stopAlert();
-        }
         reportNormalState();
     }
     DEBUG_PRINTF("AlertManager: 提醒管理器%s\n", enabled ? "启用" : "禁用");
@@ -361,37 +348,17 @@ unsigned long AlertManager::getAbnormalDuration() const {
 }
 
 unsigned long AlertManager::getTimeToNextAlert() const {
-    if (!hasActiveAlert() || currentAlert.state != AlertState::PENDING) {
+    if (machine.getState() != AlertState::PENDING) {
         return 0;
     }
-    
-    unsigned long currentTime = millis();
-    unsigned long abnormalDuration = currentTime - currentAlert.startTime;
-    
-    if (currentAlert.isUrgent || abnormalDuration >= alertDelay) {
-        return 0; // 立即提醒
-    }
-    
-    return alertDelay - abnormalDuration;
+    return machine.getTimeToTimer();
 }
 
 void AlertManager::reset() {
     DEBUG_PRINTLN("AlertManager: 重置提醒管理器");
     
-    // 停止当前提醒
-    if (isAlerting) {
-        stopAlert();
-    }
-    
-    // 重置提醒状态
-    currentAlert.type = AlertType::NONE;
-    currentAlert.state = AlertState::INACTIVE;
-    currentAlert.startTime = 0;
-    currentAlert.lastAlertTime = 0;
-    currentAlert.acknowledgeTime = 0;
-    currentAlert.repeatCount = 0;
-    currentAlert.isUrgent = false;
-    currentAlert.message = "";
+    // 退出异常状态 (退出动作会停止当前提醒)
+    dispatchEvent(AlertEvent::NORMAL);
 }
 
 void AlertManager::resetStatistics() {
@@ -431,7 +398,8 @@ String AlertManager::getSystemInfo() const {
     info += "    \"isUrgent\": " + String(currentAlert.isUrgent ? "true" : "false") + ",\n";
     info += "    \"message\": \"" + currentAlert.message + "\",\n";
     info += "    \"abnormalDuration\": " + String(getAbnormalDuration()) + ",\n";
-    info += "    \"timeToNextAlert\": " + String(getTimeToNextAlert()) + "\n";
+    info += "    \"timeToNextAlert\": " + String(getTimeToNextAlert()) + ",\n";
+    info += "    \"transitions\": " + String(machine.getTransitionCount()) + "\n";
     info += "  },\n";
     info += "  \"statistics\": {\n";
     info += "    \"totalAlerts\": " + String(totalAlerts) + ",\n";
@@ -8,6 +8,7 @@
 
 #include <Arduino.h>
 #include "config.h"
+#include "StateMachine.h"
 
 /**
  * 提醒类型
@@ -29,7 +30,21 @@ enum class AlertState {
     PENDING,        // 等待中（异常状态但未到提醒时间）
     ACTIVE,         // 激活中（正在提醒）
     ACKNOWLEDGED,   // 已确认（用户已响应）
-    SNOOZED        // 暂停中（暂时停止提醒）
+    SNOOZED,        // 暂停中（暂时停止提醒）
+    ABNORMAL        // 异常中（PENDING/ACTIVE/ACKNOWLEDGED/SNOOZED 的父状态）
+};
+
+/**
+ * 提醒状态机事件
+ */
+enum class AlertEvent : uint8_t {
+    ABNORMAL,       // 报告异常 (新的异常类型)
+    NORMAL,         // 报告正常
+    ESCALATE,       // 升级为紧急
+    ACKNOWLEDGE,    // 用户确认
+    SNOOZE,         // 用户暂停
+    TIMEOUT,        // 定时器到期
+    COUNT
 };
 
 /**
@@ -51,11 +66,28 @@ struct AlertInfo {
  */
 typedef void (*AlertCallback)(const AlertInfo& alert);
 
+#define ALERT_STATE_COUNT 6
+#define ALERT_TRANSITION_COUNT 11
+
+class AlertManager;
+
+typedef HsmTable<AlertState, AlertEvent, AlertManager,
+                 ALERT_STATE_COUNT, (size_t)AlertEvent::COUNT, ALERT_TRANSITION_COUNT> AlertStateTable;
+typedef StateMachine<AlertState, AlertEvent, AlertManager,
+                     ALERT_STATE_COUNT, (size_t)AlertEvent::COUNT, ALERT_TRANSITION_COUNT> AlertStateMachine;
+
 /**
  * 提醒管理器类
+ * 提醒状态由表驱动的层次状态机管理，等待/重复/暂停均由单个定时器驱动，
+ * 无提醒时 update() 只比较一次时间
  */
 class AlertManager {
 private:
+    // 状态机 (表在定义处以 constexpr 编译期生成，放在只读数据段)
+    static const AlertStateTable stateTable;
+    AlertStateMachine machine;
+    
+
     // 当前提醒信息
     AlertInfo currentAlert;
     
@@ -70,6 +102,11 @@ private:
     bool isAlerting;
     unsigned long lastUpdateTime;
     
+    // 待处理的事件参数
+    AlertType pendingType;
+    bool pendingUrgent;
+    unsigned long pendingSnooze;
+    
     // 回调函数
     AlertCallback alertCallback;
     AlertCallback stopCallback;
@@ -82,10 +119,23 @@ private:
     // 私有方法
     void triggerAlert();
     void stopAlert();
-    void updateAlertState();
-    bool shouldTriggerAlert() const;
-    bool shouldRepeatAlert() const;
+    void dispatchEvent(AlertEvent event);
+    void armRepeatTimer();
     String getAlertMessage(AlertType type) const;
+    
+    // 状态机动作
+    static void onInactiveEntry(AlertManager& self);
+    static void onPendingEntry(AlertManager& self);
+    static void onActiveEntry(AlertManager& self);
+    static void onActiveExit(AlertManager& self);
+    static void onAcknowledgedEntry(AlertManager& self);
+    static void onSnoozedEntry(AlertManager& self);
+    static void beginAlert(AlertManager& self);
+    static void escalateAlert(AlertManager& self);
+    static void repeatAlert(AlertManager& self);
+    static void countAcknowledgment(AlertManager& self);
+    static void countSnooze(AlertManager& self);
+    static bool repeatsExhausted(const AlertManager& self);
 
 public:
     /**
@@ -9,15 +9,24 @@ CommunicationProtocol* CommunicationProtocol::instance = nullptr;
 CommunicationProtocol::CommunicationProtocol(WiFiManager* wifiMgr)
   : wifiManager(wifiMgr)
   , webSocketConnected(false)
+  , nextStreamId(1)
+  , lastBulkProgress(0)
+  , linkSessionStart(0)
   , messageReceivedCallback(nullptr)
   , connectionStatusCallback(nullptr)
   , syncCompleteCallback(nullptr)
   , errorCallback(nullptr)
+  , bulkCompleteCallback(nullptr)
   , isInitialized(false)
   , lastHeartbeat(0)
   , lastSyncAttempt(0)
+  , lastUplink(0)
+  , idleHeartbeats(0)
+  , powerMode(PowerMode::NORMAL)
+  , serverLivenessLimit(0)
   , compressionEnabled(false)
   , encryptionEnabled(false)
+  , uploadsDeferred(false)
 {
   setDefaultConfig();
   
@@ -30,9 +39,22 @@ CommunicationProtocol::CommunicationProtocol(WiFiManager* wifiMgr)
     .averageLatency = 0.0f,
     .lastSuccessfulSync = 0,
     .totalDataTransferred = 0,
-    .currentQueueSize = 0
+    .currentQueueSize = 0,
+    .heartbeatsSent = 0,
+    .heartbeatsPiggybacked = 0,
+    .bulkChunksSent = 0,
+    .priorityPreemptions = 0,
+    .maxPriorityLatency = 0,
+    .uplinkBatchSize = UPLINK_BATCH_INITIAL,
+    .uplinkGoodput = 0.0f,
+    .uplinkErrorRate = 0.0f,
+    .linkDipDeferrals = 0
   };
   
+  for (int i = 0; i < UPLINK_MAX_STREAMS; i++) {
+    streams[i].active = false;
+  }
+  
   // 设置静态实例
   instance = this;
 }
@@ -89,7 +111,8 @@ void CommunicationProtocol::setDefaultConfig() {
     .primaryChannel = CommunicationChannel::HTTP_REST,
     .fallbackChannel = CommunicationChannel::WEBSOCKET,
     .dataFormat = DataFormat::JSON,
-    .heartbeatInterval = 60000, // 1分钟
+    .heartbeatInterval = 60000,     // 静默1分钟后发送心跳
+    .heartbeatMaxInterval = 1800000, // 持续空闲时拉长到30分钟
     .requestTimeout = 10000,    // 10秒
     .maxRetryAttempts = 3,
     .enableDataSync = true,
@@ -107,41 +130,40 @@ bool CommunicationProtocol::sendMessage(MessageType type, const String& payload,
   // 创建消息
   QueuedMessage message = createQueuedMessage(type, payload, priority);
   
+  // 推迟期间普通消息直接排队，不唤醒射频
+  if (uploadsDeferred && !priority) {
+    if (type != MessageType::HEARTBEAT) {
+      addToQueue(message);
+    }
+    return false;
+  }
+  
+  // 信号低谷时普通消息先排队，等信号恢复后成批发送 (心跳只是存活信号，照常发送)
+  if (!priority && type != MessageType::HEARTBEAT && !shouldSendDeferrable()) {
+    addToQueue(message);
+    return false;
+  }
+  
   // 如果网络连接可用，尝试立即发送
   if (wifiManager && wifiManager->isConnected()) {
-    bool success = false;
+    bool success = transmit(message.header, message.payload);
     
-    // 尝试主要通道
-    if (config.primaryChannel == CommunicationChannel::HTTP_REST) {
-      String response;
-      success = sendHTTPRequest(config.apiEndpoint + "/messages", 
-                               serializeMessage(message.header, message.payload), 
-                               response);
-    } else if (config.primaryChannel == CommunicationChannel::WEBSOCKET) {
+    // 主要通道失败，尝试备用通道
+    if (!success && config.fallbackChannel == CommunicationChannel::WEBSOCKET && 
+        config.primaryChannel != CommunicationChannel::WEBSOCKET) {
       success = sendWebSocketMessage(serializeMessage(message.header, message.payload));
     }
     
     if (success) {
-      stats.successfulTransmissions++;
-      stats.totalMessagesSent++;
+      recordDelivery(type);
       return true;
-    } else {
-      // 主要通道失败，尝试备用通道
-      if (config.fallbackChannel == CommunicationChannel::WEBSOCKET && 
-          config.primaryChannel != CommunicationChannel::WEBSOCKET) {
-        success = sendWebSocketMessage(serializeMessage(message.header, message.payload));
-      }
-      
-      if (success) {
-        stats.successfulTransmissions++;
-        stats.totalMessagesSent++;
-        return true;
-      }
     }
   }
   
-  // 发送失败或网络不可用，加入队列
-  addToQueue(message);
+  // 发送失败或网络不可用，加入队列 (过时的心跳没有意义，不排队)
+  if (type != MessageType::HEARTBEAT) {
+    addToQueue(message);
+  }
   return false;
 }
 
@@ -158,24 +180,52 @@ bool CommunicationProtocol::sendAlert(const String& alertData) {
 }
 
 bool CommunicationProtocol::sendHeartbeat() {
-  DynamicJsonDocument doc(256);
+  // 健康信息在消息信封的health字段中，心跳本身只需标识设备
+  DynamicJsonDocument doc(128);
   doc["deviceId"] = config.deviceToken;
   doc["timestamp"] = millis();
-  doc["uptime"] = millis() / 1000;
-  doc["freeHeap"] = ESP.getFreeHeap();
-  doc["wifiRSSI"] = wifiManager ? wifiManager->getRSSI() : 0;
   
   String payload;
   serializeJson(doc, payload);
   
+  lastHeartbeat = millis();
   bool success = sendMessage(MessageType::HEARTBEAT, payload, false);
   if (success) {
-    lastHeartbeat = millis();
+    stats.heartbeatsSent++;
+    if (idleHeartbeats < HEARTBEAT_MAX_BACKOFF_SHIFT) {
+      idleHeartbeats++;
+    }
   }
   
   return success;
 }
 
+void CommunicationProtocol::setPowerMode(PowerMode mode) {
+  powerMode = mode;
+}
+
+unsigned long CommunicationProtocol::getHeartbeatInterval() const {
+  // 连续空闲时每次心跳后间隔翻倍，直到上限
+  unsigned long interval = config.heartbeatInterval << idleHeartbeats;
+  if (interval > config.heartbeatMaxInterval) {
+    interval = config.heartbeatMaxInterval;
+  }
+  
+  // 省电模式下进一步拉长
+  if (powerMode == PowerMode::POWER_SAVE) {
+    interval *= 2;
+  } else if (powerMode == PowerMode::EMERGENCY) {
+    interval *= 4;
+  }
+  
+  // 不超过服务器要求的存活周期
+  if (serverLivenessLimit > 0 && interval > serverLivenessLimit) {
+    interval = serverLivenessLimit;
+  }
+  
+  return interval;
+}
+
 void CommunicationProtocol::update() {
   if (!isInitialized) {
     return;
@@ -189,13 +239,20 @@ void CommunicationProtocol::update() {
   // 处理传入消息
   processIncomingMessages();
   
-  // 发送心跳
-  if (currentTime - lastHeartbeat >= config.heartbeatInterval) {
-    sendHeartbeat();
+  // 只有在上行静默足够久时才发送独立心跳 (失败后同样按间隔重试)
+  unsigned long heartbeatInterval = getHeartbeatInterval();
+  if (currentTime - lastHeartbeat >= heartbeatInterval) {
+    if (currentTime - lastUplink >= heartbeatInterval) {
+      sendHeartbeat();
+    } else {
+      // 期间的业务消息已携带健康信息，视为本轮心跳
+      stats.heartbeatsPiggybacked++;
+      lastHeartbeat = lastUplink;
+    }
   }
   
-  // 数据同步
-  if (config.enableDataSync && 
+  // 数据同步 (推迟上传期间跳过)
+  if (config.enableDataSync && !uploadsDeferred &&
       currentTime - lastSyncAttempt >= config.syncInterval) {
     startDataSync();
     lastSyncAttempt = currentTime;
@@ -225,6 +282,9 @@ bool CommunicationProtocol::sendHTTPRequest(const String& endpoint, const String
   
   int httpResponseCode = httpClient.POST(data);
   
+  // 传输层失败计入发射功率调整 (HTTP错误码说明数据已送达)
+  wifiManager->recordTransmission(data.length(), httpResponseCode > 0);
+  
   if (httpResponseCode > 0) {
     response = httpClient.getString();
     
@@ -234,6 +294,8 @@ bool CommunicationProtocol::sendHTTPRequest(const String& endpoint, const String
     stats.totalDataTransferred += data.length() + response.length();
     
     if (httpResponseCode == 200) {
+      lastUplink = millis();
+      applyServerLiveness(response);
       return true;
     } else {
       Serial.print("HTTP Error: ");
@@ -254,8 +316,13 @@ bool CommunicationProtocol::sendWebSocketMessage(const String& data) {
   
   bool success = webSocketClient.sendTXT(data);
   
+  if (wifiManager) {
+    wifiManager->recordTransmission(data.length(), success);
+  }
+  
   if (success) {
     stats.totalDataTransferred += data.length();
+    lastUplink = millis();
   }
   
   return success;
@@ -308,6 +375,7 @@ void CommunicationProtocol::processWebSocketMessage(const String& message) {
   
   if (deserializeMessage(message, header, payload)) {
     if (validateMessage(header, payload)) {
+      applyServerLiveness(payload);
       if (messageReceivedCallback) {
         messageReceivedCallback(header, payload);
       }
@@ -319,8 +387,22 @@ void CommunicationProtocol::processWebSocketMessage(const String& message) {
   }
 }
 
+// 解析payload所需的文档容量：每个成员/元素一个槽位 (按分隔符计数，只会多估)，
+// 另加字符串副本 (不超过payload长度)。批量数据块的转义文本超过1KB，固定容量会解析失败
+static size_t payloadCapacity(const String& payload) {
+  size_t values = 1;
+  for (size_t i = 0; i < payload.length(); i++) {
+    char c = payload[i];
+    if (c == ',' || c == '[' || c == '{') {
+      values++;
+    }
+  }
+  return values * JSON_ARRAY_SIZE(1) + payload.length() + 1;
+}
+
 String CommunicationProtocol::serializeMessage(const MessageHeader& header, const String& payload) {
-  DynamicJsonDocument doc(2048);
+  size_t payloadSize = payloadCapacity(payload);
+  PsramJsonDocument doc(1024 + payloadSize);
   
   doc["messageId"] = header.messageId;
   doc["type"] = (int)header.type;
@@ -329,8 +411,11 @@ String CommunicationProtocol::serializeMessage(const MessageHeader& header, cons
   doc["version"] = header.version;
   doc["checksum"] = header.checksum;
   
+  // 每条上行消息都携带健康信息，服务器据此判断存活，不必单独发送心跳
+  addHealthFields(doc.createNestedObject("health"));
+  
   // 解析payload为JSON（如果可能）
-  DynamicJsonDocument payloadDoc(1024);
+  PsramJsonDocument payloadDoc(payloadSize);
   DeserializationError error = deserializeJson(payloadDoc, payload);
   
   if (error) {
@@ -346,8 +431,39 @@ String CommunicationProtocol::serializeMessage(const MessageHeader& header, cons
   return result;
 }
 
+void CommunicationProtocol::addHealthFields(JsonObject health) {
+  health["uptime"] = millis() / 1000;
+  health["freeHeap"] = ESP.getFreeHeap();
+  health["wifiRSSI"] = wifiManager ? wifiManager->getRSSI() : 0;
+}
+
+void CommunicationProtocol::applyServerLiveness(const String& json) {
+  // 大多数响应不含该字段，先做字符串检查避免解析
+  if (json.indexOf("livenessTimeout") < 0) {
+    return;
+  }
+  
+  StaticJsonDocument<32> filter;
+  filter["livenessTimeout"] = true;
+  StaticJsonDocument<64> doc;
+  if (deserializeJson(doc, json, DeserializationOption::Filter(filter))) {
+    return;
+  }
+  
+  // 服务器声明的超时时间 (秒)，在一半时间内上报以容忍一次丢失
+  unsigned long timeout = doc["livenessTimeout"] | 0UL;
+  unsigned long limit = timeout * 1000 / 2;
+  if (timeout > 0 && limit < HEARTBEAT_MIN_INTERVAL) {
+    limit = HEARTBEAT_MIN_INTERVAL;
+  }
+  if (limit != serverLivenessLimit) {
+    serverLivenessLimit = limit;
+    Serial.printf("Server liveness timeout: %lu s\n", timeout);
+  }
+}
+
 bool CommunicationProtocol::deserializeMessage(const String& data, MessageHeader& header, String& payload) {
-  DynamicJsonDocument doc(2048);
+  PsramJsonDocument doc(2048);
   DeserializationError error = deserializeJson(doc, data);
   
   if (error) {
@@ -424,6 +540,16 @@ QueuedMessage CommunicationProtocol::createQueuedMessage(MessageType type, const
   return message;
 }
 
+void CommunicationProtocol::recordDelivery(MessageType type) {
+  stats.successfulTransmissions++;
+  stats.totalMessagesSent++;
+  
+  // 有业务流量说明设备不再空闲，心跳间隔恢复基础值
+  if (type != MessageType::HEARTBEAT) {
+    idleHeartbeats = 0;
+  }
+}
+
 void CommunicationProtocol::addToQueue(const QueuedMessage& message) {
   if (message.isPriority) {
     priorityQueue.push_back(message);
@@ -432,7 +558,8 @@ void CommunicationProtocol::addToQueue(const QueuedMessage& message) {
   }
   
   // 检查队列大小限制
-  while (messageQueue.size() + priorityQueue.size() > config.maxQueueSize) {
+  size_t queueLimit = config.maxQueueSize > 0 ? (size_t)config.maxQueueSize : 0;
+  while (messageQueue.size() + priorityQueue.size() > queueLimit) {
     if (!messageQueue.empty()) {
       messageQueue.erase(messageQueue.begin());
     } else if (!priorityQueue.empty()) {
@@ -441,72 +568,272 @@ void CommunicationProtocol::addToQueue(const QueuedMessage& message) {
   }
 }
 
+bool CommunicationProtocol::transmit(const MessageHeader& header, const String& payload, bool uplinkRound) {
+  String data = serializeMessage(header, payload);
+  unsigned long startTime = millis();
+  bool success = false;
+  
+  if (config.primaryChannel == CommunicationChannel::HTTP_REST) {
+    String response;
+    success = sendHTTPRequest(config.apiEndpoint + "/messages", data, response);
+  } else if (config.primaryChannel == CommunicationChannel::WEBSOCKET) {
+    success = sendWebSocketMessage(data);
+  } else {
+    return false;
+  }
+  
+  // 只有普通队列和数据块的发送轮次计入上行窗口；立即发送和优先消息不受窗口限制，不参与调整
+  if (uplinkRound) {
+    uplink.recordTransmission(data.length(), success, millis() - startTime);
+  }
+  return success;
+}
+
+void CommunicationProtocol::refreshLinkState() {
+  if (!wifiManager) {
+    return;
+  }
+  
+  // 每次WiFi连接是一个新会话，上一会话的窗口和吞吐量不再适用
+  unsigned long sessionStart = wifiManager->getConnectionStats().lastConnectionTime;
+  if (sessionStart != linkSessionStart) {
+    linkSessionStart = sessionStart;
+    uplink.startSession();
+  }
+  
+  uplink.onSignalSample(wifiManager->getRSSI(), wifiManager->getRssiBaseline());
+}
+
+bool CommunicationProtocol::shouldSendDeferrable() {
+  refreshLinkState();
+  
+  unsigned long now = millis();
+  unsigned long waited = messageQueue.empty() ? 0 : now - messageQueue.front().timestamp;
+  if (isBulkTransferActive() && now - lastBulkProgress > waited) {
+    waited = now - lastBulkProgress;
+  }
+  float queueFill = config.maxQueueSize > 0 ?
+    (float)(messageQueue.size() + priorityQueue.size()) / config.maxQueueSize : 1.0f;
+  
+  if (uplink.shouldSendDeferrable(waited, queueFill)) {
+    return true;
+  }
+  stats.linkDipDeferrals = uplink.getDeferralCount();
+  return false;
+}
+
 void CommunicationProtocol::processMessageQueue() {
   if (!wifiManager || !wifiManager->isConnected()) {
     return;
   }
   
-  // 处理优先级队列
-  auto it = priorityQueue.begin();
-  while (it != priorityQueue.end()) {
-    bool success = false;
+  // 处理优先级队列 (本次更新中每条优先消息最多尝试一次)
+  size_t priorityAttempted = 0;
+  processPriorityQueue(priorityAttempted);
+  
+  // 推迟上传期间普通队列和批量传输留到早上
+  if (uploadsDeferred) {
+    return;
+  }
+  
+  // 信号低谷中不发送非紧急数据 (推迟时间和队列占用有上限)
+  if ((messageQueue.empty() && !isBulkTransferActive()) || !shouldSendDeferrable()) {
+    return;
+  }
+  
+  // 普通消息与批量数据块交替发送，每发一块都先检查优先队列；
+  // 超出时间预算后返回主循环，新产生的提醒最多等待一块的发送时间
+  unsigned long startTime = millis();
+  int processedCount = 0;
+  const int maxProcessPerUpdate = uplink.getBatchSize();
+  size_t index = 0;
+  bool stalled = false;
+  bool progress = true;
+  
+  while (progress && !stalled && millis() - startTime < UPLINK_UPDATE_BUDGET_MS) {
+    progress = false;
     
-    if (config.primaryChannel == CommunicationChannel::HTTP_REST) {
-      String response;
-      success = sendHTTPRequest(config.apiEndpoint + "/messages",
-                               serializeMessage(it->header, it->payload),
-                               response);
-    } else if (config.primaryChannel == CommunicationChannel::WEBSOCKET) {
-      success = sendWebSocketMessage(serializeMessage(it->header, it->payload));
+    // 只发送本次更新开始后新产生的优先消息，已失败的留到下次更新
+    UplinkStream* stream = activeStream();
+    if (priorityQueue.size() > priorityAttempted) {
+      int delivered = processPriorityQueue(priorityAttempted);
+      if (stream != nullptr && stream->offset > 0) {
+        stats.priorityPreemptions += delivered;
+      }
     }
     
-    if (success) {
-      stats.successfulTransmissions++;
-      stats.totalMessagesSent++;
-      it = priorityQueue.erase(it);
-    } else {
-      it->retryCount++;
-      if (it->retryCount >= config.maxRetryAttempts) {
-        stats.failedTransmissions++;
-        it = priorityQueue.erase(it);
+    // 批量数据块 (任何发送失败都结束本轮，不在变差的链路上继续重试)
+    if (stream != nullptr && processedCount < maxProcessPerUpdate) {
+      stalled = !sendNextChunk(*stream);
+      processedCount++;
+      progress = true;
+    }
+    
+    // 普通队列（每轮数量由上行窗口决定）
+    if (!stalled && processedCount < maxProcessPerUpdate && index < messageQueue.size()) {
+      QueuedMessage& message = messageQueue[index];
+      if (transmit(message.header, message.payload, true)) {
+        recordDelivery(message.header.type);
+        messageQueue.erase(messageQueue.begin() + index);
       } else {
-        ++it;
+        message.retryCount++;
+        if (message.retryCount >= config.maxRetryAttempts) {
+          stats.failedTransmissions++;
+          messageQueue.erase(messageQueue.begin() + index);
+        } else {
+          index++;
+        }
+        stalled = true;
       }
+      processedCount++;
+      progress = true;
     }
   }
   
-  // 处理普通队列（限制每次处理的数量）
-  int processedCount = 0;
-  const int maxProcessPerUpdate = 5;
-  
-  auto it2 = messageQueue.begin();
-  while (it2 != messageQueue.end() && processedCount < maxProcessPerUpdate) {
-    bool success = false;
-    
-    if (config.primaryChannel == CommunicationChannel::HTTP_REST) {
-      String response;
-      success = sendHTTPRequest(config.apiEndpoint + "/messages",
-                               serializeMessage(it2->header, it2->payload),
-                               response);
-    } else if (config.primaryChannel == CommunicationChannel::WEBSOCKET) {
-      success = sendWebSocketMessage(serializeMessage(it2->header, it2->payload));
-    }
-    
-    if (success) {
-      stats.successfulTransmissions++;
-      stats.totalMessagesSent++;
-      it2 = messageQueue.erase(it2);
+  // 按本轮结果调整窗口 (本轮只统计了上面循环中的普通消息和数据块)
+  uplink.endRound(processedCount >= maxProcessPerUpdate);
+  stats.uplinkBatchSize = uplink.getBatchSize();
+  stats.uplinkGoodput = uplink.getGoodput();
+  stats.uplinkErrorRate = uplink.getErrorRate();
+}
+
+int CommunicationProtocol::processPriorityQueue(size_t& attempted) {
+  int delivered = 0;
+  
+  // 本次更新已尝试过 (发送失败留在队列中) 的消息在队首，从其后开始
+  size_t index = attempted < priorityQueue.size() ? attempted : priorityQueue.size();
+  while (index < priorityQueue.size()) {
+    QueuedMessage& message = priorityQueue[index];
+    if (transmit(message.header, message.payload)) {
+      recordDelivery(message.header.type);
+      unsigned long latency = millis() - message.timestamp;
+      if (latency > stats.maxPriorityLatency) {
+        stats.maxPriorityLatency = latency;
+      }
+      delivered++;
+      priorityQueue.erase(priorityQueue.begin() + index);
     } else {
-      it2->retryCount++;
-      if (it2->retryCount >= config.maxRetryAttempts) {
+      message.retryCount++;
+      if (message.retryCount >= config.maxRetryAttempts) {
         stats.failedTransmissions++;
-        it2 = messageQueue.erase(it2);
+        priorityQueue.erase(priorityQueue.begin() + index);
       } else {
-        ++it2;
+        index++;
       }
     }
-    
-    processedCount++;
+  }
+  
+  attempted = priorityQueue.size();
+  return delivered;
+}
+
+// 批量传输
+int CommunicationProtocol::startBulkTransfer(MessageType type, UplinkChunkReader reader, uint32_t totalLength) {
+  if (reader == nullptr) {
+    return -1;
+  }
+  
+  for (int i = 0; i < UPLINK_MAX_STREAMS; i++) {
+    if (!streams[i].active) {
+      streams[i] = {
+        .streamId = nextStreamId++,
+        .type = type,
+        .reader = reader,
+        .totalLength = totalLength,
+        .offset = 0,
+        .chunkIndex = 0,
+        .retryCount = 0,
+        .active = true
+      };
+      lastBulkProgress = millis();
+      Serial.printf("Bulk transfer %d started, %lu bytes\n", streams[i].streamId, (unsigned long)totalLength);
+      return streams[i].streamId;
+    }
+  }
+  
+  Serial.println("Bulk transfer rejected: all streams busy");
+  return -1;
+}
+
+void CommunicationProtocol::cancelBulkTransfer(int streamId) {
+  for (int i = 0; i < UPLINK_MAX_STREAMS; i++) {
+    if (streams[i].active && streams[i].streamId == streamId) {
+      finishStream(streams[i], false);
+    }
+  }
+}
+
+bool CommunicationProtocol::isBulkTransferActive() const {
+  for (int i = 0; i < UPLINK_MAX_STREAMS; i++) {
+    if (streams[i].active) {
+      return true;
+    }
+  }
+  return false;
+}
+
+UplinkStream* CommunicationProtocol::activeStream() {
+  // 按启动顺序逐个完成，不在多个流之间交错
+  UplinkStream* oldest = nullptr;
+  for (int i = 0; i < UPLINK_MAX_STREAMS; i++) {
+    if (streams[i].active && (oldest == nullptr || streams[i].streamId < oldest->streamId)) {
+      oldest = &streams[i];
+    }
+  }
+  return oldest;
+}
+
+bool CommunicationProtocol::sendNextChunk(UplinkStream& stream) {
+  char buffer[UPLINK_CHUNK_SIZE + 1];
+  size_t length = stream.reader(stream.offset, buffer, UPLINK_CHUNK_SIZE);
+  if (length > UPLINK_CHUNK_SIZE) {
+    length = UPLINK_CHUNK_SIZE;
+  }
+  buffer[length] = '\0';
+  bool isFinal = length == 0 || stream.offset + length >= stream.totalLength;
+  
+  // 块头带偏移量，服务器据此重组，重传的块可按偏移去重
+  PsramJsonDocument doc(UPLINK_CHUNK_SIZE + 256);
+  doc["stream"] = stream.streamId;
+  doc["index"] = stream.chunkIndex;
+  doc["offset"] = stream.offset;
+  doc["total"] = stream.totalLength;
+  doc["final"] = isFinal;
+  doc["data"] = (const char*)buffer;
+  
+  String payload;
+  serializeJson(doc, payload);
+  QueuedMessage chunk = createQueuedMessage(stream.type, payload, false);
+  
+  if (!transmit(chunk.header, chunk.payload, true)) {
+    stream.retryCount++;
+    if (stream.retryCount >= config.maxRetryAttempts) {
+      stats.failedTransmissions++;
+      finishStream(stream, false);
+    }
+    return false;
+  }
+  
+  stats.bulkChunksSent++;
+  lastBulkProgress = millis();
+  stream.offset += length;
+  stream.chunkIndex++;
+  stream.retryCount = 0;
+  
+  if (isFinal) {
+    recordDelivery(stream.type);
+    finishStream(stream, true);
+  }
+  return true;
+}
+
+void CommunicationProtocol::finishStream(UplinkStream& stream, bool success) {
+  stream.active = false;
+  Serial.printf("Bulk transfer %d %s after %u chunks\n", stream.streamId,
+                success ? "completed" : "aborted", (unsigned)stream.chunkIndex);
+  
+  if (bulkCompleteCallback) {
+    bulkCompleteCallback(stream.streamId, success);
   }
 }
 
@@ -588,6 +915,28 @@ void CommunicationProtocol::printStats() const {
   Serial.println(" ms");
   Serial.print("Queue Size: ");
   Serial.println(stats.currentQueueSize);
+  Serial.print("Heartbeats: ");
+  Serial.print(stats.heartbeatsSent);
+  Serial.print(" sent, ");
+  Serial.print(stats.heartbeatsPiggybacked);
+  Serial.println(" piggybacked");
+  Serial.print("Bulk Chunks: ");
+  Serial.print(stats.bulkChunksSent);
+  Serial.print(", ");
+  Serial.print(stats.priorityPreemptions);
+  Serial.println(" priority preemptions");
+  Serial.print("Uplink Batch: ");
+  Serial.print(stats.uplinkBatchSize);
+  Serial.print(", goodput ");
+  Serial.print(stats.uplinkGoodput);
+  Serial.print(" B/s, error rate ");
+  Serial.print(stats.uplinkErrorRate * 100);
+  Serial.print("%, ");
+  Serial.print(stats.linkDipDeferrals);
+  Serial.println(" signal-dip deferrals");
+  Serial.print("Max Priority Latency: ");
+  Serial.print(stats.maxPriorityLatency);
+  Serial.println(" ms");
   Serial.println("===============================");
 }
 
@@ -608,6 +957,30 @@ void CommunicationProtocol::setErrorCallback(void (*callback)(const String&, int
   errorCallback = callback;
 }
 
+void CommunicationProtocol::setBulkCompleteCallback(void (*callback)(int streamId, bool success)) {
+  bulkCompleteCallback = callback;
+}
+
+// 推迟上传
+void CommunicationProtocol::setUploadsDeferred(bool deferred) {
+  if (uploadsDeferred == deferred) {
+    return;
+  }
+  
+  uploadsDeferred = deferred;
+  if (deferred) {
+    Serial.println("Uploads deferred");
+  } else {
+    // 恢复后立即同步夜间积压的消息
+    Serial.printf("Uploads resumed, %d messages queued\n", (int)messageQueue.size());
+    lastSyncAttempt = 0;
+  }
+}
+
+bool CommunicationProtocol::areUploadsDeferred() const {
+  return uploadsDeferred;
+}
+
 // MessageBuilder实现
 String MessageBuilder::buildSensorDataMessage(const String& deviceId, 
                                              float soilHumidity, 
@@ -660,4 +1033,4 @@ String MessageBuilder::buildAlertMessage(const String& deviceId,
   String result;
   serializeJson(doc, result);
   return result;
-}
\ No newline at end of file
+}
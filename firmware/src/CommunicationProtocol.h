@@ -7,6 +7,9 @@
 #include <HTTPClient.h>
 #include <WebSocketsClient.h>
 #include "WiFiManager.h"
+#include "PowerManager.h"
+#include "MemoryTier.h"
+#include "UplinkController.h"
 
 /**
  * 数据通信协议
@@ -68,7 +71,8 @@ struct CommunicationConfig {
   CommunicationChannel primaryChannel;
   CommunicationChannel fallbackChannel;
   DataFormat dataFormat;
-  unsigned long heartbeatInterval;
+  unsigned long heartbeatInterval;     // 无上行流量多久后发送独立心跳
+  unsigned long heartbeatMaxInterval;  // 空闲时心跳间隔的拉伸上限
   unsigned long requestTimeout;
   int maxRetryAttempts;
   
@@ -87,6 +91,21 @@ struct QueuedMessage {
   bool isPriority;
 };
 
+// 批量数据读取回调：从offset起最多读取capacity字节文本到buffer，返回实际字节数 (0表示结束)
+typedef size_t (*UplinkChunkReader)(uint32_t offset, char* buffer, size_t capacity);
+
+// 批量上行流 (历史同步、固件日志等)，按块发送，块之间让出给优先消息
+struct UplinkStream {
+  int streamId;
+  MessageType type;
+  UplinkChunkReader reader;
+  uint32_t totalLength;
+  uint32_t offset;          // 已确认送达的字节数
+  uint16_t chunkIndex;
+  int retryCount;
+  bool active;
+};
+
 struct CommunicationStats {
   unsigned long totalMessagesSent;
   unsigned long totalMessagesReceived;
@@ -96,6 +115,15 @@ struct CommunicationStats {
   unsigned long lastSuccessfulSync;
   unsigned long totalDataTransferred;
   int currentQueueSize;
+  unsigned long heartbeatsSent;        // 独立心跳次数
+  unsigned long heartbeatsPiggybacked; // 因已有上行流量而省去的心跳次数
+  unsigned long bulkChunksSent;        // 已发送的批量数据块
+  unsigned long priorityPreemptions;   // 批量传输中途插队发送的优先消息数
+  unsigned long maxPriorityLatency;    // 排队的优先消息从产生到送达的最长时间 (ms)
+  int uplinkBatchSize;                 // 当前每轮发送条数 (AIMD窗口)
+  float uplinkGoodput;                 // 平滑后的送达吞吐量 (字节/秒)
+  float uplinkErrorRate;               // 平滑后的发送失败率
+  unsigned long linkDipDeferrals;      // 因信号低谷推迟非紧急上传的次数
 };
 
 class CommunicationProtocol {
@@ -112,25 +140,45 @@ private:
   WebSocketsClient webSocketClient;
   bool webSocketConnected;
   
-  // 消息队列
-  std::vector<QueuedMessage> messageQueue;
-  std::vector<QueuedMessage> priorityQueue;
+  // 消息队列：普通消息是离线积压，放在PSRAM；优先消息数量少且需立即发送，留在内部SRAM
+  std::vector<QueuedMessage, TieredAllocator<QueuedMessage, MemoryTier::PSRAM>> messageQueue;
+  std::vector<QueuedMessage, TieredAllocator<QueuedMessage, MemoryTier::INTERNAL>> priorityQueue;
+  
+  // 批量上行流
+  static const int UPLINK_MAX_STREAMS = 2;   // 同时进行的批量传输数
+  UplinkStream streams[UPLINK_MAX_STREAMS];
+  int nextStreamId;
+  unsigned long lastBulkProgress;      // 批量传输上一次送达数据块的时刻
+  
+  // 上行自适应 (批量大小、避开信号低谷)
+  UplinkController uplink;
+  unsigned long linkSessionStart;      // 当前WiFi会话的连接时刻，变化时重置上行统计
   
   // 回调函数
   void (*messageReceivedCallback)(const MessageHeader& header, const String& payload);
   void (*connectionStatusCallback)(CommunicationChannel channel, bool connected);
   void (*syncCompleteCallback)(bool success, int messageCount);
   void (*errorCallback)(const String& error, int errorCode);
+  void (*bulkCompleteCallback)(int streamId, bool success);
   
   // 状态管理
   bool isInitialized;
   unsigned long lastHeartbeat;
   unsigned long lastSyncAttempt;
+  
+  // 自适应心跳
+  unsigned long lastUplink;            // 最近一次成功上行 (任何消息都携带健康信息)
+  uint8_t idleHeartbeats;              // 连续独立心跳次数，用于空闲时拉长间隔
+  PowerMode powerMode;
+  unsigned long serverLivenessLimit;   // 服务器要求的最长静默时间 (0表示未声明)
   String currentSessionId;
   
   // 数据压缩和加密
   bool compressionEnabled;
   bool encryptionEnabled;
+  
+  // 夜间推迟普通消息上传
+  bool uploadsDeferred;
 
 public:
   CommunicationProtocol(WiFiManager* wifiMgr);
@@ -153,6 +201,11 @@ public:
   bool hasIncomingMessage() const;
   String getNextMessage();
   
+  // 批量传输 (分块发送，优先消息在块之间插队)
+  int startBulkTransfer(MessageType type, UplinkChunkReader reader, uint32_t totalLength);
+  void cancelBulkTransfer(int streamId);
+  bool isBulkTransferActive() const;
+  
   // 数据同步
   bool startDataSync();
   bool syncQueuedMessages();
@@ -190,6 +243,7 @@ public:
   void setConnectionStatusCallback(void (*callback)(CommunicationChannel, bool));
   void setSyncCompleteCallback(void (*callback)(bool, int));
   void setErrorCallback(void (*callback)(const String&, int));
+  void setBulkCompleteCallback(void (*callback)(int streamId, bool success));
   
   // 安全和认证
   bool authenticateDevice();
@@ -209,6 +263,14 @@ public:
   void enableOfflineMode();
   void disableOfflineMode();
   bool isOfflineModeEnabled() const;
+  
+  // 推迟上传 (夜间只发送优先消息，普通消息排队到早上)
+  void setUploadsDeferred(bool deferred);
+  bool areUploadsDeferred() const;
+  
+  // 自适应心跳
+  void setPowerMode(PowerMode mode);
+  unsigned long getHeartbeatInterval() const;
 
 private:
   // 内部方法
@@ -216,6 +278,10 @@ private:
   bool sendWebSocketMessage(const String& data);
   void processHTTPResponse(const String& response);
   void processWebSocketMessage(const String& message);
+  bool transmit(const MessageHeader& header, const String& payload, bool uplinkRound = false);
+  void recordDelivery(MessageType type);
+  void addHealthFields(JsonObject health);
+  void applyServerLiveness(const String& json);
   
   // WebSocket事件处理
   void onWebSocketEvent(WStype_t type, uint8_t* payload, size_t length);
@@ -225,6 +291,12 @@ private:
   void addToQueue(const QueuedMessage& message);
   QueuedMessage createQueuedMessage(MessageType type, const String& payload, bool priority);
   void processMessageQueue();
+  int processPriorityQueue(size_t& attempted);
+  UplinkStream* activeStream();
+  bool sendNextChunk(UplinkStream& stream);   // 只在普通队列的发送轮次中调用
+  void finishStream(UplinkStream& stream, bool success);
+  void refreshLinkState();
+  bool shouldSendDeferrable();
   void sortMessageQueue();
   
   // 网络状态处理
@@ -246,6 +318,14 @@ private:
   void saveConfigToNVS();
   void loadConfigFromNVS();
   
+  // 心跳参数
+  static const uint8_t HEARTBEAT_MAX_BACKOFF_SHIFT = 5;     // 空闲时最多翻倍5次
+  static const unsigned long HEARTBEAT_MIN_INTERVAL = 10000; // 服务器声明的存活周期过短时的下限
+  
+  // 分块上行参数
+  static const size_t UPLINK_CHUNK_SIZE = 1024;              // 每块字节数，决定优先消息最多等待多久
+  static const unsigned long UPLINK_UPDATE_BUDGET_MS = 200;  // 每次update中普通消息和批量块的发送时间预算
+  
   // 静态实例（用于回调）
   static CommunicationProtocol* instance;
 };
@@ -30,6 +30,9 @@ void ConfigurationManager::loadDefaultConfiguration() {
   currentConfig.autoWatering = false;
   currentConfig.moistureThreshold = 30.0f;
   currentConfig.lightThreshold = 500.0f;
+  currentConfig.dliTarget = GROW_LIGHT_DEFAULT_DLI;
+  currentConfig.ledCount = LED_COUNT;
+  currentConfig.statusLedCount = LED_COUNT;
   currentConfig.isConfigured = false;
   currentConfig.configTimestamp = 0;
 }
@@ -45,6 +48,9 @@ void ConfigurationManager::saveConfiguration() {
   preferences.putBool("autoWatering", currentConfig.autoWatering);
   preferences.putFloat("moistureThreshold", currentConfig.moistureThreshold);
   preferences.putFloat("lightThreshold", currentConfig.lightThreshold);
+  preferences.putFloat("dliTarget", currentConfig.dliTarget);
+  preferences.putUShort("ledCount", currentConfig.ledCount);
+  preferences.putUShort("statusLeds", currentConfig.statusLedCount);
   preferences.putBool("isConfigured", currentConfig.isConfigured);
   preferences.putULong64("configTimestamp", currentConfig.configTimestamp);
   
@@ -65,6 +71,9 @@ void ConfigurationManager::loadConfiguration() {
     currentConfig.autoWatering = preferences.getBool("autoWatering", false);
     currentConfig.moistureThreshold = preferences.getFloat("moistureThreshold", 30.0f);
     currentConfig.lightThreshold = preferences.getFloat("lightThreshold", 500.0f);
+    currentConfig.dliTarget = preferences.getFloat("dliTarget", GROW_LIGHT_DEFAULT_DLI);
+    currentConfig.ledCount = preferences.getUShort("ledCount", LED_COUNT);
+    currentConfig.statusLedCount = preferences.getUShort("statusLeds", currentConfig.ledCount);
     currentConfig.isConfigured = preferences.getBool("isConfigured", false);
     currentConfig.configTimestamp = preferences.getULong64("configTimestamp", 0);
     
@@ -203,6 +212,9 @@ String ConfigurationManager::configurationToJson() const {
   doc["autoWatering"] = currentConfig.autoWatering;
   doc["moistureThreshold"] = currentConfig.moistureThreshold;
   doc["lightThreshold"] = currentConfig.lightThreshold;
+  doc["dliTarget"] = currentConfig.dliTarget;
+  doc["ledCount"] = currentConfig.ledCount;
+  doc["statusLedCount"] = currentConfig.statusLedCount;
   doc["isConfigured"] = currentConfig.isConfigured;
   doc["configTimestamp"] = currentConfig.configTimestamp;
   
@@ -230,6 +242,9 @@ bool ConfigurationManager::configurationFromJson(const String& json) {
   newConfig.autoWatering = doc["autoWatering"] | false;
   newConfig.moistureThreshold = doc["moistureThreshold"] | 30.0f;
   newConfig.lightThreshold = doc["lightThreshold"] | 500.0f;
+  newConfig.dliTarget = doc["dliTarget"] | currentConfig.dliTarget;
+  newConfig.ledCount = doc["ledCount"] | currentConfig.ledCount;
+  newConfig.statusLedCount = doc["statusLedCount"] | newConfig.ledCount;
   
   if (validateConfiguration(newConfig)) {
     setDeviceConfiguration(newConfig);
@@ -246,6 +261,11 @@ bool ConfigurationManager::validateConfiguration(const DeviceConfiguration& conf
   // 验证阈值范围
   if (config.moistureThreshold < 0 || config.moistureThreshold > 100) return false;
   if (config.lightThreshold < 0 || config.lightThreshold > 10000) return false;
+  if (config.dliTarget < 0 || config.dliTarget > 60) return false;
+  
+  // 验证灯带配置
+  if (config.ledCount == 0 || config.ledCount > LED_MAX_COUNT) return false;
+  if (config.statusLedCount == 0 || config.statusLedCount > config.ledCount) return false;
   
   return true;
 }
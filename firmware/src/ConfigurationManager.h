@@ -9,6 +9,8 @@
 #include <Arduino.h>
 #include <ArduinoJson.h>
 #include <Preferences.h>
+#include "config.h"
+#include "WiFiManager.h"
 
 struct DeviceConfiguration {
   String deviceName;
@@ -19,16 +21,13 @@ struct DeviceConfiguration {
   bool autoWatering;
   float moistureThreshold;
   float lightThreshold;
+  float dliTarget;            // 每日光照积分目标 (mol/m²/day)
+  uint16_t ledCount;          // 灯带LED总数
+  uint16_t statusLedCount;    // 状态显示LED数，其余为补光灯环
   bool isConfigured;
   unsigned long configTimestamp;
 };
 
-struct WiFiCredentials {
-  String ssid;
-  String password;
-  bool isSet;
-};
-
 class ConfigurationManager {
 private:
   Preferences preferences;
@@ -0,0 +1,105 @@
+/**
+ * AI智能植物养护机器人 - 协程调度器实现
+ */
+
+#include "Coroutine.h"
+#include <climits>
+
+Coroutine* CoScheduler::tasks[COROUTINE_MAX_TASKS] = {};
+uint8_t CoScheduler::taskCount = 0;
+uint32_t CoScheduler::resumeCount = 0;
+
+/**
+ * 启动协程并加入调度
+ */
+bool CoScheduler::spawn(Coroutine& task) {
+    task.restart();
+
+    for (uint8_t i = 0; i < taskCount; i++) {
+        if (tasks[i] == &task) {
+            return true;
+        }
+    }
+
+    if (taskCount >= COROUTINE_MAX_TASKS) {
+        task.stop();
+        DEBUG_PRINTLN("CoScheduler: 调度表已满");
+        return false;
+    }
+    tasks[taskCount++] = &task;
+    return true;
+}
+
+/**
+ * 结束协程并移出调度
+ */
+void CoScheduler::cancel(Coroutine& task) {
+    task.stop();
+    for (uint8_t i = 0; i < taskCount; i++) {
+        if (tasks[i] == &task) {
+            tasks[i] = tasks[--taskCount];
+            tasks[taskCount] = nullptr;
+            return;
+        }
+    }
+}
+
+/**
+ * 推进全部到期的协程
+ */
+void CoScheduler::update() {
+    uint8_t i = 0;
+    while (i < taskCount) {
+        Coroutine* task = tasks[i];
+        if (task->coState != CoState::SLEEPING || (long)(millis() - task->coWakeAt) >= 0) {
+            resumeCount++;
+        }
+
+        if (task->resume()) {
+            i++;
+        } else {
+            // 已结束，用最后一个填补空位
+            tasks[i] = tasks[--taskCount];
+            tasks[taskCount] = nullptr;
+        }
+    }
+}
+
+/**
+ * 距离下一个协程需要运行的时间
+ */
+unsigned long CoScheduler::getTimeToNextWake() {
+    unsigned long nearest = ULONG_MAX;
+    unsigned long now = millis();
+
+    for (uint8_t i = 0; i < taskCount; i++) {
+        const Coroutine* task = tasks[i];
+        if (task->coState == CoState::READY) {
+            return 0;
+        }
+        if (task->coState == CoState::SLEEPING) {
+            long remaining = (long)(task->coWakeAt - now);
+            if (remaining <= 0) {
+                return 0;
+            }
+            if ((unsigned long)remaining < nearest) {
+                nearest = remaining;
+            }
+        }
+    }
+    return nearest;
+}
+
+/**
+ * 获取调度中的协程数
+ */
+uint8_t CoScheduler::getTaskCount() {
+    return taskCount;
+}
+
+/**
+ * 获取累计恢复运行次数
+ */
+uint32_t CoScheduler::getResumeCount() {
+    return resumeCount;
+}
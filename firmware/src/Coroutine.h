@@ -0,0 +1,285 @@
+/**
+ * AI智能植物养护机器人 - 无栈协程
+ * 把需要等待的多步骤流程 (反馈动画、连接、校准、同步等) 写成顺序代码，
+ * 不再手写状态机，也不用delay()阻塞主循环。
+ *
+ * 工具链 (arduino-esp32 2.x, GCC 8) 不支持C++20协程，这里用switch续点实现：
+ * 协程对象只保存续点行号、状态和唤醒时刻，没有独立任务栈；
+ * 跨等待点的变量写成协程类的成员，协程对象可以静态分配 (作为所属模块的成员)。
+ *
+ * 写法：
+ *   class BlinkTask : public Coroutine {
+ *       int i;                          // 跨等待点的变量
+ *   protected:
+ *       void body() override {
+ *           CO_BEGIN();
+ *           for (i = 0; i < 3; i++) {
+ *               leds.turnOn();
+ *               CO_DELAY(200);
+ *               leds.turnOff();
+ *               CO_DELAY(200);
+ *           }
+ *           CO_END();
+ *       }
+ *   };
+ *   CoScheduler::spawn(blinkTask);
+ *
+ * 限制：同一行只能写一个等待宏；等待宏不能出现在协程体内的switch语句中；
+ * 协程体内的普通局部变量在等待点之后失效。
+ */
+
+#ifndef COROUTINE_H
+#define COROUTINE_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * 协程状态
+ */
+enum class CoState : uint8_t {
+    READY,          // 可以继续运行 (主动让出)
+    SLEEPING,       // 等待定时器到期
+    WAITING,        // 等待条件成立 (每次调度时检查)
+    DONE            // 已结束或未启动
+};
+
+/**
+ * 协程基类
+ */
+class Coroutine {
+    friend class CoScheduler;
+
+protected:
+    uint16_t coLine;                // 续点 (等待宏所在行号，0表示从头开始)
+    CoState coState;
+    bool coTimedOut;                // 上一次带超时的等待是否超时
+    unsigned long coWakeAt;         // 定时器到期时刻 / 等待超时时刻
+
+    /**
+     * 协程体 (用 CO_BEGIN / CO_END 包围)
+     */
+    virtual void body() = 0;
+
+public:
+    Coroutine() : coLine(0), coState(CoState::DONE), coTimedOut(false), coWakeAt(0) {
+    }
+
+    virtual ~Coroutine() {
+    }
+
+    /**
+     * 从头开始 (正在运行时放弃当前进度)
+     */
+    void restart() {
+        coLine = 0;
+        coState = CoState::READY;
+        coTimedOut = false;
+    }
+
+    /**
+     * 结束协程
+     */
+    void stop() {
+        coLine = 0;
+        coState = CoState::DONE;
+    }
+
+    /**
+     * 到期时运行到下一个等待点
+     * @return 是否仍在运行
+     */
+    bool resume() {
+        if (coState == CoState::DONE) {
+            return false;
+        }
+        if (coState == CoState::SLEEPING && (long)(millis() - coWakeAt) < 0) {
+            return true;
+        }
+        body();
+        return coState != CoState::DONE;
+    }
+
+    bool isRunning() const {
+        return coState != CoState::DONE;
+    }
+
+    CoState getState() const {
+        return coState;
+    }
+
+    /**
+     * 上一次 CO_AWAIT_TIMEOUT 是否因超时返回
+     */
+    bool timedOut() const {
+        return coTimedOut;
+    }
+};
+
+// 协程体开始/结束
+#define CO_BEGIN() switch (coLine) { case 0:
+#define CO_END() } coLine = 0; coState = CoState::DONE; return
+
+// 让出一次，下一次调度时继续
+#define CO_YIELD() \
+    do { coLine = __LINE__; coState = CoState::READY; return; case __LINE__:; } while (0)
+
+// 等待指定时间 (ms)
+#define CO_DELAY(ms) \
+    do { coWakeAt = millis() + (ms); coLine = __LINE__; coState = CoState::SLEEPING; return; \
+         case __LINE__:; } while (0)
+
+// 等待条件成立
+#define CO_AWAIT(condition) \
+    do { coLine = __LINE__; case __LINE__: \
+         if (!(condition)) { coState = CoState::WAITING; return; } } while (0)
+
+// 等待条件成立，最多等待指定时间 (ms)，之后用 timedOut() 区分结果
+#define CO_AWAIT_TIMEOUT(condition, ms) \
+    do { coWakeAt = millis() + (ms); coTimedOut = false; coLine = __LINE__; case __LINE__: \
+         if (!(condition)) { \
+             if ((long)(millis() - coWakeAt) < 0) { coState = CoState::WAITING; return; } \
+             coTimedOut = true; \
+         } } while (0)
+
+// 等待信号 (GPIO事件、网络请求完成等)
+#define CO_AWAIT_SIGNAL(signal) CO_AWAIT((signal).take())
+
+// 等待队列中有数据并取出
+#define CO_AWAIT_POP(queue, out) CO_AWAIT((queue).pop(out))
+
+/**
+ * 信号：由回调通知、由协程等待的计数事件
+ * 只应在主循环上下文中通知 (中断事件经 GpioEventManager::dispatch 转发到回调)
+ */
+class CoSignal {
+private:
+    uint16_t pending;
+
+public:
+    CoSignal() : pending(0) {
+    }
+
+    /**
+     * 通知一次
+     */
+    void notify() {
+        if (pending < 0xFFFF) {
+            pending++;
+        }
+    }
+
+    /**
+     * 取走一次通知
+     * @return 是否有未处理的通知
+     */
+    bool take() {
+        if (pending == 0) {
+            return false;
+        }
+        pending--;
+        return true;
+    }
+
+    /**
+     * 丢弃未处理的通知
+     */
+    void clear() {
+        pending = 0;
+    }
+
+    bool isPending() const {
+        return pending > 0;
+    }
+};
+
+/**
+ * 定长队列，供协程用 CO_AWAIT_POP 读取
+ */
+template <typename T, size_t N>
+class CoQueue {
+private:
+    T items[N];
+    size_t head;
+    size_t count;
+
+public:
+    CoQueue() : head(0), count(0) {
+    }
+
+    /**
+     * 写入 (满时返回false)
+     */
+    bool push(const T& item) {
+        if (count >= N) {
+            return false;
+        }
+        items[(head + count) % N] = item;
+        count++;
+        return true;
+    }
+
+    /**
+     * 取出 (空时返回false)
+     */
+    bool pop(T& item) {
+        if (count == 0) {
+            return false;
+        }
+        item = items[head];
+        head = (head + 1) % N;
+        count--;
+        return true;
+    }
+
+    size_t size() const { return count; }
+    bool isEmpty() const { return count == 0; }
+    bool isFull() const { return count >= N; }
+};
+
+/**
+ * 协程调度器 (全局唯一，在主循环中推进)
+ */
+class CoScheduler {
+private:
+    static Coroutine* tasks[COROUTINE_MAX_TASKS];
+    static uint8_t taskCount;
+    static uint32_t resumeCount;
+
+public:
+    /**
+     * 从头启动协程并加入调度 (已在调度中时重新开始)
+     * @param task 协程对象 (生命周期须长于运行期)
+     * @return 是否成功 (调度表已满时返回false)
+     */
+    static bool spawn(Coroutine& task);
+
+    /**
+     * 结束协程并移出调度
+     * @param task 协程对象
+     */
+    static void cancel(Coroutine& task);
+
+    /**
+     * 推进全部到期的协程，移除已结束的 (应在主循环中调用)
+     */
+    static void update();
+
+    /**
+     * 距离下一个协程需要运行的时间 (ms)
+     * 有可运行的协程时返回0，只有等待条件的协程时返回ULONG_MAX (按主循环节奏检查)
+     */
+    static unsigned long getTimeToNextWake();
+
+    /**
+     * 获取调度中的协程数
+     */
+    static uint8_t getTaskCount();
+
+    /**
+     * 获取累计恢复运行次数
+     */
+    static uint32_t getResumeCount();
+};
+
+#endif // COROUTINE_H
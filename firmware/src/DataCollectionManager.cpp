@@ -16,6 +16,8 @@ DataCollectionManager::DataCollectionManager(SensorManager* sensorMgr)
       currentStatus(CollectionStatus::IDLE),
       lastCollectionTime(0),
       nextCollectionTime(0),
+      unarchivedCount(0),
+      distributionStart(0),
       consecutiveErrors(0),
       maxConsecutiveErrors(5),
       errorRecoveryDelay(30000) { // 30秒错误恢复延迟
@@ -55,9 +57,16 @@ bool DataCollectionManager::initialize() {
     currentStatus = CollectionStatus::IDLE;
     consecutiveErrors = 0;
     
-    // 初始化缓冲区
+    // 分配并初始化缓冲区
+    if (!allocateBuffer()) {
+        DEBUG_PRINTLN("✗ 数据缓冲区分配失败");
+        return false;
+    }
     initializeBuffer();
     
+    // 映射闪存历史归档 (分区不存在时只保留内存中的历史)
+    HistoryLog::begin();
+    
     // 重置统计信息
     resetStats();
     
@@ -65,6 +74,35 @@ bool DataCollectionManager::initialize() {
     return true;
 }
 
+/**
+ * 指定传感器管理器并初始化
+ */
+bool DataCollectionManager::initialize(SensorManager* sensorMgr) {
+    sensorManager = sensorMgr;
+    return initialize();
+}
+
+/**
+ * 分配缓冲区 (有PSRAM时保存更长的历史)
+ * 在initialize中调用，此时PSRAM已完成初始化
+ */
+bool DataCollectionManager::allocateBuffer() {
+    if (dataBuffer.data.isAllocated()) {
+        return true;
+    }
+    
+    size_t capacity = MemoryTierManager::isPsramAvailable() ? SENSOR_HISTORY_PSRAM_SIZE : SENSOR_BUFFER_SIZE;
+    if (!dataBuffer.data.allocate(capacity)) {
+        // PSRAM历史分配失败时退回默认容量
+        if (capacity == SENSOR_BUFFER_SIZE || !dataBuffer.data.allocate(SENSOR_BUFFER_SIZE)) {
+            return false;
+        }
+    }
+    
+    DEBUG_PRINTF("数据缓冲区容量: %u 条\n", (unsigned)dataBuffer.data.size());
+    return true;
+}
+
 /**
  * 初始化缓冲区
  */
@@ -73,9 +111,10 @@ void DataCollectionManager::initializeBuffer() {
     dataBuffer.tail = 0;
     dataBuffer.count = 0;
     dataBuffer.isFull = false;
+    unarchivedCount = 0;
     
     // 清空缓冲区数据
-    for (int i = 0; i < SENSOR_BUFFER_SIZE; i++) {
+    for (size_t i = 0; i < dataBuffer.data.size(); i++) {
         dataBuffer.data[i] = {0, 0, 0, 0, 0, false};
     }
 }
@@ -158,6 +197,8 @@ SensorData DataCollectionManager::collectOnce() {
     if (data.isValid) {
         // 添加到缓冲区
         addToBuffer(data);
+        archiveSample(data);
+        updateDistributions(data);
         resetErrorState();
         currentStatus = CollectionStatus::IDLE;
         
@@ -237,7 +278,8 @@ CollectionStatus DataCollectionManager::getCurrentStatus() const {
  */
 SensorData DataCollectionManager::getLatestData() {
     if (dataBuffer.count > 0) {
-        int latestIndex = (dataBuffer.head - 1 + SENSOR_BUFFER_SIZE) % SENSOR_BUFFER_SIZE;
+        int capacity = dataBuffer.data.size();
+        int latestIndex = (dataBuffer.head - 1 + capacity) % capacity;
         return dataBuffer.data[latestIndex];
     }
     
@@ -255,9 +297,10 @@ int DataCollectionManager::getHistoryData(int count, SensorData* data) {
     }
     
     int actualCount = min(count, dataBuffer.count);
+    int capacity = dataBuffer.data.size();
     
     for (int i = 0; i < actualCount; i++) {
-        int index = (dataBuffer.head - 1 - i + SENSOR_BUFFER_SIZE) % SENSOR_BUFFER_SIZE;
+        int index = (dataBuffer.head - 1 - i + capacity) % capacity;
         data[i] = dataBuffer.data[index];
     }
     
@@ -268,15 +311,20 @@ int DataCollectionManager::getHistoryData(int count, SensorData* data) {
  * 添加数据到缓冲区
  */
 bool DataCollectionManager::addToBuffer(const SensorData& data) {
+    int capacity = dataBuffer.data.size();
+    if (capacity == 0) {
+        return false;
+    }
+    
     dataBuffer.data[dataBuffer.head] = data;
-    dataBuffer.head = (dataBuffer.head + 1) % SENSOR_BUFFER_SIZE;
+    dataBuffer.head = (dataBuffer.head + 1) % capacity;
     
     if (dataBuffer.isFull) {
         // 缓冲区已满，移动尾指针
-        dataBuffer.tail = (dataBuffer.tail + 1) % SENSOR_BUFFER_SIZE;
+        dataBuffer.tail = (dataBuffer.tail + 1) % capacity;
     } else {
         dataBuffer.count++;
-        if (dataBuffer.count == SENSOR_BUFFER_SIZE) {
+        if (dataBuffer.count == capacity) {
             dataBuffer.isFull = true;
         }
     }
@@ -284,6 +332,32 @@ bool DataCollectionManager::addToBuffer(const SensorData& data) {
     return true;
 }
 
+/**
+ * 把样本写入闪存归档
+ * 网络时间同步前只留在缓冲区；同步后先按与本样本的采集间隔 (millis) 推算出
+ * 之前样本的Unix时间补写 (最旧的先写)，再写入本样本。补写前被缓冲区覆盖的样本不再归档
+ */
+void DataCollectionManager::archiveSample(const SensorData& data) {
+    time_t now = time(nullptr);
+    if (!HistoryLog::isTimeSynced(now)) {
+        unarchivedCount = min(unarchivedCount + 1, dataBuffer.count);
+        return;
+    }
+
+    // 本样本已在缓冲区最后一位，之前未归档的样本紧挨在它前面
+    int backlog = min(unarchivedCount, dataBuffer.count - 1);
+    for (int i = backlog; i >= 1; i--) {
+        SensorData earlier = getFromBuffer(dataBuffer.count - 1 - i);
+        HistoryLog::append(earlier, now - (time_t)((data.timestamp - earlier.timestamp) / 1000));
+    }
+    if (backlog > 0) {
+        DEBUG_PRINTF("网络时间已同步，补写 %d 个历史样本\n", backlog);
+    }
+    unarchivedCount = 0;
+
+    HistoryLog::append(data, now);
+}
+
 /**
  * 从缓冲区获取数据
  */
@@ -293,7 +367,7 @@ SensorData DataCollectionManager::getFromBuffer(int index) {
         return emptyData;
     }
     
-    int actualIndex = (dataBuffer.tail + index) % SENSOR_BUFFER_SIZE;
+    int actualIndex = (dataBuffer.tail + index) % (int)dataBuffer.data.size();
     return dataBuffer.data[actualIndex];
 }
 
@@ -412,6 +486,73 @@ void DataCollectionManager::processCollectedData(const SensorData& data) {
     #endif
 }
 
+/**
+ * 把样本计入当日分布
+ */
+void DataCollectionManager::updateDistributions(const SensorData& data) {
+    if (distributionStart == 0) {
+        distributionStart = time(nullptr);
+    }
+    
+    distributions[(size_t)DistributionChannel::SOIL_MOISTURE].add(data.soilHumidity);
+    distributions[(size_t)DistributionChannel::AIR_HUMIDITY].add(data.airHumidity);
+    distributions[(size_t)DistributionChannel::TEMPERATURE].add(data.temperature);
+    distributions[(size_t)DistributionChannel::LIGHT].add(data.lightIntensity);
+}
+
+/**
+ * 获取当日某通道的分布草图
+ */
+const QuantileSketch& DataCollectionManager::getDistribution(DistributionChannel channel) const {
+    return distributions[(size_t)channel];
+}
+
+/**
+ * 获取当日分布报告
+ * 湿度和温度保留一位小数，光照取整数lux
+ */
+String DataCollectionManager::getDistributionReport() const {
+    PsramJsonDocument doc(10240);
+    
+    doc["type"] = "daily_distribution";
+    doc["start"] = (long)distributionStart;
+    doc["end"] = (long)time(nullptr);
+    
+    JsonObject channels = doc.createNestedObject("channels");
+    for (size_t i = 0; i < (size_t)DistributionChannel::COUNT; i++) {
+        DistributionChannel channel = (DistributionChannel)i;
+        float scale = channel == DistributionChannel::LIGHT ? 1.0f : 10.0f;
+        distributions[i].toJson(channels.createNestedObject(getChannelName(channel)), scale);
+    }
+    
+    String result;
+    serializeJson(doc, result);
+    return result;
+}
+
+/**
+ * 清空分布草图
+ */
+void DataCollectionManager::resetDistributions() {
+    for (size_t i = 0; i < (size_t)DistributionChannel::COUNT; i++) {
+        distributions[i].reset();
+    }
+    distributionStart = 0;
+}
+
+/**
+ * 获取通道名称
+ */
+const char* DataCollectionManager::getChannelName(DistributionChannel channel) {
+    switch (channel) {
+        case DistributionChannel::SOIL_MOISTURE: return "soil_moisture";
+        case DistributionChannel::AIR_HUMIDITY: return "air_humidity";
+        case DistributionChannel::TEMPERATURE: return "temperature";
+        case DistributionChannel::LIGHT: return "light";
+        default: return "unknown";
+    }
+}
+
 /**
  * 获取错误信息
  */
@@ -524,6 +665,7 @@ String DataCollectionManager::getSystemInfo() const {
     doc["consecutive_errors"] = consecutiveErrors;
     doc["max_consecutive_errors"] = maxConsecutiveErrors;
     doc["buffer_count"] = dataBuffer.count;
+    doc["buffer_capacity"] = dataBuffer.data.size();
     doc["buffer_full"] = dataBuffer.isFull;
     doc["next_collection_time"] = nextCollectionTime;
     doc["time_to_next"] = getTimeToNextCollection();
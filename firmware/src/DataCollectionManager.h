@@ -7,7 +7,11 @@
 #define DATA_COLLECTION_MANAGER_H
 
 #include <Arduino.h>
+#include <time.h>
 #include "SensorManager.h"
+#include "MemoryTier.h"
+#include "QuantileSketch.h"
+#include "HistoryLog.h"
 #include "config.h"
 
 /**
@@ -22,10 +26,21 @@ enum class CollectionStatus {
 };
 
 /**
- * 数据缓冲区结构
+ * 分布统计通道
+ */
+enum class DistributionChannel : uint8_t {
+    SOIL_MOISTURE,  // 土壤湿度 (%)
+    AIR_HUMIDITY,   // 空气湿度 (%)
+    TEMPERATURE,    // 温度 (°C)
+    LIGHT,          // 光照强度 (lux)
+    COUNT
+};
+
+/**
+ * 数据缓冲区结构 (历史数据顺序读写、访问不频繁，放在PSRAM)
  */
 struct DataBuffer {
-    SensorData data[SENSOR_BUFFER_SIZE];
+    TieredArray<SensorData, MemoryTier::PSRAM> data;
     int head;           // 头指针
     int tail;           // 尾指针
     int count;          // 当前数据量
@@ -63,10 +78,15 @@ private:
     
     // 数据缓冲
     DataBuffer dataBuffer;
+    int unarchivedCount;                // 网络时间同步前采集、尚未写入闪存归档的样本数 (在缓冲区末尾)
     
     // 统计信息
     CollectionStats stats;
     
+    // 当日各通道分布 (每个有效样本都计入，跨天时上传后清空)
+    QuantileSketch distributions[(size_t)DistributionChannel::COUNT];
+    time_t distributionStart;
+    
     // 错误处理
     int consecutiveErrors;
     int maxConsecutiveErrors;
@@ -74,6 +94,7 @@ private:
     
     // 私有方法
     void initializeBuffer();
+    bool allocateBuffer();
     bool addToBuffer(const SensorData& data);
     SensorData getFromBuffer(int index);
     void updateStats(bool success);
@@ -81,13 +102,15 @@ private:
     void resetErrorState();
     bool isTimeForCollection();
     void processCollectedData(const SensorData& data);
+    void updateDistributions(const SensorData& data);
+    void archiveSample(const SensorData& data);
 
 public:
     /**
      * 构造函数
-     * @param sensorMgr 传感器管理器指针
+     * @param sensorMgr 传感器管理器指针 (可在initialize时再指定)
      */
-    DataCollectionManager(SensorManager* sensorMgr);
+    DataCollectionManager(SensorManager* sensorMgr = nullptr);
     
     /**
      * 析构函数
@@ -101,7 +124,14 @@ public:
     bool initialize();
     
     /**
-     * 更新数据采集（应在主循环中调用）
+     * 指定传感器管理器并初始化
+     * @param sensorMgr 传感器管理器指针
+     * @return 初始化是否成功
+     */
+    bool initialize(SensorManager* sensorMgr);
+    
+    /**
+     * 更新数据采集（自动采集模式下应在主循环中调用；由数据管道调度采集时不必调用）
      */
     void update();
     
@@ -158,7 +188,7 @@ public:
     SensorData getLatestData();
     
     /**
-     * 获取历史数据
+     * 获取历史数据 (内存中的近期数据；更早的归档通过 HistoryLog 直接读取闪存)
      * @param count 要获取的数据条数
      * @param data 输出数组
      * @return 实际获取的数据条数
@@ -199,6 +229,29 @@ public:
      */
     void resetStats();
     
+    /**
+     * 获取当日某通道的分布草图
+     * @param channel 通道
+     * @return 分位数草图
+     */
+    const QuantileSketch& getDistribution(DistributionChannel channel) const;
+    
+    /**
+     * 获取当日分布报告 (各通道草图，供上传后由服务器合并查询)
+     * @return JSON格式的分布报告
+     */
+    String getDistributionReport() const;
+    
+    /**
+     * 清空分布草图，开始新的统计日
+     */
+    void resetDistributions();
+    
+    /**
+     * 获取通道名称
+     */
+    static const char* getChannelName(DistributionChannel channel);
+    
     /**
      * 获取错误信息
      * @return 错误信息字符串
@@ -0,0 +1,342 @@
+/**
+ * AI智能植物养护机器人 - 数据管道实现
+ */
+
+#include "DataPipeline.h"
+#include <ArduinoJson.h>
+#include <climits>
+#include "MemoryTier.h"
+
+/**
+ * 构造函数
+ */
+DataPipeline::DataPipeline()
+    : sequence(0),
+      paused(false),
+      startTime(0) {
+    for (int i = 0; i < (int)PipelineStage::COUNT; i++) {
+        configs[i] = {
+            .handler = nullptr,
+            .input = (PipelineStage)(i > 0 ? i - 1 : 0),
+            .minInterval = 0,
+            .queueCapacity = PIPELINE_QUEUE_SIZE,
+            .batchSize = 1,
+            .maxBatchWait = 0
+        };
+        queues[i].head = 0;
+        queues[i].count = 0;
+        nextRun[i] = 0;
+        flushRequested[i] = false;
+    }
+    resetStats();
+}
+
+/**
+ * 配置阶段
+ */
+void DataPipeline::configureStage(PipelineStage stage, const PipelineStageConfig& config) {
+    int index = (int)stage;
+    if (index >= (int)PipelineStage::COUNT) {
+        return;
+    }
+
+    configs[index] = config;
+    configs[index].queueCapacity = constrain(config.queueCapacity, 1, PIPELINE_QUEUE_SIZE);
+    if (configs[index].batchSize < 1) {
+        configs[index].batchSize = 1;
+    }
+
+    // 样本在一次update()中单向流动，上游必须排在前面
+    if (index > 0 && (int)config.input >= index) {
+        DEBUG_PRINTF("✗ 管道阶段 %s 的上游无效，改为前一阶段\n", getStageName(stage));
+        configs[index].input = (PipelineStage)(index - 1);
+    }
+}
+
+/**
+ * 修改阶段运行间隔
+ */
+void DataPipeline::setStageInterval(PipelineStage stage, unsigned long interval) {
+    int index = (int)stage;
+    if (index >= (int)PipelineStage::COUNT || configs[index].minInterval == interval) {
+        return;
+    }
+
+    // 间隔缩短时 (如退出夜间模式) 不必等满原来的间隔
+    if (interval < configs[index].minInterval && nextRun[index] != 0) {
+        unsigned long lastRun = nextRun[index] - configs[index].minInterval;
+        nextRun[index] = lastRun + interval;
+    }
+    configs[index].minInterval = interval;
+}
+
+/**
+ * 推进管道
+ */
+void DataPipeline::update() {
+    unsigned long now = millis();
+    if (startTime == 0) {
+        startTime = now;
+    }
+
+    if (!paused) {
+        runSource(now);
+    }
+
+    for (int i = 1; i < (int)PipelineStage::COUNT; i++) {
+        runStage(i, now);
+    }
+}
+
+/**
+ * 到期时采集一个样本
+ */
+void DataPipeline::runSource(unsigned long now) {
+    if ((long)(now - nextRun[0]) < 0 && !flushRequested[0]) {
+        return;
+    }
+    flushRequested[0] = false;
+    nextRun[0] = now + configs[0].minInterval;
+
+    PipelineSample sample = {};
+    sample.sequence = ++sequence;
+    sample.acquiredAt = now;
+    sample.state = PlantState::UNKNOWN;
+
+    StageResult result = invoke(0, sample);
+    if (result == StageResult::PASS) {
+        forward(0, sample);
+    } else if (result == StageResult::RETRY && configs[0].minInterval > PIPELINE_RETRY_DELAY) {
+        nextRun[0] = now + PIPELINE_RETRY_DELAY;
+    }
+}
+
+/**
+ * 处理阶段输入队列：到了运行时间且攒够一批时一次处理完队列中的样本，
+ * 遇到RETRY时停止并在 PIPELINE_RETRY_DELAY 后重试
+ */
+void DataPipeline::runStage(int stage, unsigned long now) {
+    StageQueue& queue = queues[stage];
+    if (queue.count == 0) {
+        return;
+    }
+    if ((long)(now - nextRun[stage]) < 0 && !flushRequested[stage]) {
+        return;
+    }
+    if (!isBatchReady(stage, now)) {
+        return;
+    }
+    flushRequested[stage] = false;
+    nextRun[stage] = now + configs[stage].minInterval;
+
+    uint8_t pending = queue.count;
+    while (pending-- > 0) {
+        PipelineSample sample = queue.items[queue.head];
+        StageResult result = invoke(stage, sample);
+        if (result == StageResult::RETRY) {
+            // 保留原样本，下次重新处理
+            nextRun[stage] = now + PIPELINE_RETRY_DELAY;
+            break;
+        }
+
+        queue.head = (queue.head + 1) % PIPELINE_QUEUE_SIZE;
+        queue.count--;
+        if (result == StageResult::PASS) {
+            forward(stage, sample);
+        }
+    }
+    stats[stage].queueDepth = queue.count;
+}
+
+/**
+ * 是否攒够一批 (或最旧样本已等待过久、或被要求立即处理)
+ */
+bool DataPipeline::isBatchReady(int stage, unsigned long now) const {
+    const StageQueue& queue = queues[stage];
+    if (flushRequested[stage] || queue.count >= configs[stage].batchSize) {
+        return true;
+    }
+    return now - queue.items[queue.head].acquiredAt >= configs[stage].maxBatchWait;
+}
+
+/**
+ * 调用阶段处理函数并统计耗时
+ */
+StageResult DataPipeline::invoke(int stage, PipelineSample& sample) {
+    PipelineStageStats& s = stats[stage];
+    float age = millis() - sample.acquiredAt;
+    s.avgAgeMs = s.processed == 0 ? age : s.avgAgeMs + (age - s.avgAgeMs) * PIPELINE_LATENCY_ALPHA;
+
+    StageResult result = StageResult::PASS;
+    if (configs[stage].handler != nullptr) {
+        unsigned long start = micros();
+        result = configs[stage].handler(sample);
+        uint32_t elapsed = micros() - start;
+
+        s.avgLatencyUs = s.processed == 0 ? elapsed :
+                         s.avgLatencyUs + (elapsed - s.avgLatencyUs) * PIPELINE_LATENCY_ALPHA;
+        if (elapsed > s.maxLatencyUs) {
+            s.maxLatencyUs = elapsed;
+        }
+    }
+
+    switch (result) {
+        case StageResult::PASS:
+            s.processed++;
+            break;
+        case StageResult::DROP:
+            s.processed++;
+            s.dropped++;
+            break;
+        case StageResult::RETRY:
+            s.retries++;
+            break;
+    }
+    return result;
+}
+
+/**
+ * 把样本交给以该阶段为上游的所有阶段
+ */
+void DataPipeline::forward(int stage, const PipelineSample& sample) {
+    for (int i = stage + 1; i < (int)PipelineStage::COUNT; i++) {
+        if ((int)configs[i].input == stage) {
+            push(i, sample);
+        }
+    }
+}
+
+/**
+ * 样本入队，队列满时丢弃最旧的样本
+ */
+void DataPipeline::push(int stage, const PipelineSample& sample) {
+    StageQueue& queue = queues[stage];
+    PipelineStageStats& s = stats[stage];
+
+    if (queue.count >= configs[stage].queueCapacity) {
+        queue.head = (queue.head + 1) % PIPELINE_QUEUE_SIZE;
+        queue.count--;
+        s.shed++;
+    }
+
+    queue.items[(queue.head + queue.count) % PIPELINE_QUEUE_SIZE] = sample;
+    queue.count++;
+
+    s.queueDepth = queue.count;
+    if (queue.count > s.queueHighWater) {
+        s.queueHighWater = queue.count;
+    }
+}
+
+/**
+ * 下一次update()时立即采集
+ */
+void DataPipeline::triggerAcquire() {
+    flushRequested[0] = true;
+}
+
+/**
+ * 下一次update()时立即处理阶段队列
+ */
+void DataPipeline::flush(PipelineStage stage) {
+    if ((int)stage < (int)PipelineStage::COUNT) {
+        flushRequested[(int)stage] = true;
+    }
+}
+
+/**
+ * 暂停/恢复采集
+ */
+void DataPipeline::setPaused(bool pause) {
+    paused = pause;
+}
+
+/**
+ * 距离阶段下一次运行的时间
+ */
+unsigned long DataPipeline::getTimeToNextRun(PipelineStage stage) const {
+    int index = (int)stage;
+    if (index >= (int)PipelineStage::COUNT || (index == 0 && paused)) {
+        return ULONG_MAX;
+    }
+    if (flushRequested[index]) {
+        return 0;
+    }
+    long remaining = (long)(nextRun[index] - millis());
+    return remaining > 0 ? remaining : 0;
+}
+
+/**
+ * 获取阶段统计
+ */
+PipelineStageStats DataPipeline::getStageStats(PipelineStage stage) const {
+    return stats[(int)stage];
+}
+
+/**
+ * 清零统计
+ */
+void DataPipeline::resetStats() {
+    for (int i = 0; i < (int)PipelineStage::COUNT; i++) {
+        stats[i] = {
+            .processed = 0,
+            .dropped = 0,
+            .shed = 0,
+            .retries = 0,
+            .avgLatencyUs = 0,
+            .maxLatencyUs = 0,
+            .avgAgeMs = 0,
+            .queueDepth = queues[i].count,
+            .queueHighWater = queues[i].count
+        };
+    }
+    startTime = millis();
+}
+
+/**
+ * 获取阶段名称
+ */
+const char* DataPipeline::getStageName(PipelineStage stage) {
+    switch (stage) {
+        case PipelineStage::ACQUIRE:  return "acquire";
+        case PipelineStage::FILTER:   return "filter";
+        case PipelineStage::DERIVE:   return "derive";
+        case PipelineStage::EVALUATE: return "evaluate";
+        case PipelineStage::ALERT:    return "alert";
+        case PipelineStage::PERSIST:  return "persist";
+        case PipelineStage::PUBLISH:  return "publish";
+        default:                      return "unknown";
+    }
+}
+
+/**
+ * 获取管道信息
+ */
+String DataPipeline::getInfo() const {
+    PsramJsonDocument doc(2048);
+    unsigned long elapsed = millis() - startTime;
+
+    doc["sequence"] = sequence;
+    doc["paused"] = paused;
+
+    JsonArray stages = doc.createNestedArray("stages");
+    for (int i = 0; i < (int)PipelineStage::COUNT; i++) {
+        const PipelineStageStats& s = stats[i];
+        JsonObject stage = stages.createNestedObject();
+        stage["name"] = getStageName((PipelineStage)i);
+        stage["processed"] = s.processed;
+        stage["per_hour"] = elapsed > 0 ? s.processed * 3600000.0f / elapsed : 0;
+        stage["dropped"] = s.dropped;
+        stage["shed"] = s.shed;
+        stage["retries"] = s.retries;
+        stage["avg_us"] = s.avgLatencyUs;
+        stage["max_us"] = s.maxLatencyUs;
+        stage["avg_age_ms"] = s.avgAgeMs;
+        stage["queue"] = s.queueDepth;
+        stage["queue_high"] = s.queueHighWater;
+    }
+
+    String result;
+    serializeJson(doc, result);
+    return result;
+}
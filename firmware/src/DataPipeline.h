@@ -0,0 +1,189 @@
+/**
+ * AI智能植物养护机器人 - 数据管道
+ * 采集 → 过滤 → 派生 → 状态评估 → 提醒 → 持久化 / 上传，
+ * 各阶段之间为有界队列，按声明的速率运行；慢阶段 (闪存、网络) 队列满时丢弃最旧数据或攒批处理，
+ * 不阻塞采集。记录每个阶段的处理耗时、排队延迟和吞吐量
+ */
+
+#ifndef DATA_PIPELINE_H
+#define DATA_PIPELINE_H
+
+#include <Arduino.h>
+#include "SensorManager.h"
+#include "StateManager.h"
+#include "config.h"
+
+/**
+ * 管道阶段
+ */
+enum class PipelineStage : uint8_t {
+    ACQUIRE,        // 采集 (数据源)
+    FILTER,         // 过滤无效数据
+    DERIVE,         // 计算派生量
+    EVALUATE,       // 植物状态评估
+    ALERT,          // 提醒与交互
+    PERSIST,        // 写入闪存
+    PUBLISH,        // 上传
+    COUNT
+};
+
+/**
+ * 阶段处理结果
+ */
+enum class StageResult {
+    PASS,           // 处理完成，交给下游
+    DROP,           // 处理完成，不再向下游传递
+    RETRY           // 暂时无法处理 (如网络不可用)，保留在队列中稍后重试
+};
+
+/**
+ * 在管道中流动的样本
+ */
+struct PipelineSample {
+    uint32_t sequence;          // 采集序号
+    unsigned long acquiredAt;   // 采集时间 (ms)
+    SensorData data;            // 传感器数据
+    float vpd;                  // 饱和水汽压差 (kPa)
+    PlantState state;           // 评估后的植物状态
+    int healthScore;            // 健康评分
+    bool needsAttention;        // 是否需要关注
+};
+
+/**
+ * 阶段处理函数类型
+ * @param sample 样本 (可修改后传给下游)
+ * @return 处理结果
+ */
+typedef StageResult (*PipelineStageHandler)(PipelineSample& sample);
+
+/**
+ * 阶段配置
+ */
+struct PipelineStageConfig {
+    PipelineStageHandler handler;   // 处理函数 (为空时直接透传)
+    PipelineStage input;            // 上游阶段 (ACQUIRE自身无上游；多个阶段可接同一上游)
+    unsigned long minInterval;      // 两次运行的最小间隔 (ms)，即声明的处理速率；ACQUIRE为采集间隔
+    uint8_t queueCapacity;          // 输入队列容量，满时丢弃最旧的样本 (1表示只保留最新)
+    uint8_t batchSize;              // 攒够多少条后一次处理完
+    unsigned long maxBatchWait;     // 最旧样本等待超过该时长时不足一批也处理 (ms)
+};
+
+/**
+ * 阶段统计
+ */
+struct PipelineStageStats {
+    uint32_t processed;         // 处理次数
+    uint32_t dropped;           // 处理后丢弃 (如无效数据)
+    uint32_t shed;              // 队列满被丢弃
+    uint32_t retries;           // 暂时无法处理的次数
+    float avgLatencyUs;         // 平均处理耗时 (µs)
+    uint32_t maxLatencyUs;      // 最大处理耗时 (µs)
+    float avgAgeMs;             // 样本从采集到进入该阶段的平均延迟 (ms)
+    uint8_t queueDepth;         // 当前队列深度
+    uint8_t queueHighWater;     // 队列深度峰值
+};
+
+/**
+ * 数据管道类
+ */
+class DataPipeline {
+private:
+    struct StageQueue {
+        PipelineSample items[PIPELINE_QUEUE_SIZE];
+        uint8_t head;
+        uint8_t count;
+    };
+
+    PipelineStageConfig configs[(int)PipelineStage::COUNT];
+    StageQueue queues[(int)PipelineStage::COUNT];
+    PipelineStageStats stats[(int)PipelineStage::COUNT];
+    unsigned long nextRun[(int)PipelineStage::COUNT];
+    bool flushRequested[(int)PipelineStage::COUNT];
+
+    uint32_t sequence;
+    bool paused;
+    unsigned long startTime;
+
+    void runSource(unsigned long now);
+    void runStage(int stage, unsigned long now);
+    bool isBatchReady(int stage, unsigned long now) const;
+    StageResult invoke(int stage, PipelineSample& sample);
+    void forward(int stage, const PipelineSample& sample);
+    void push(int stage, const PipelineSample& sample);
+
+public:
+    /**
+     * 构造函数 (各阶段默认透传、不限速、队列容量为 PIPELINE_QUEUE_SIZE)
+     */
+    DataPipeline();
+
+    /**
+     * 配置阶段
+     * @param stage 阶段
+     * @param config 阶段配置
+     */
+    void configureStage(PipelineStage stage, const PipelineStageConfig& config);
+
+    /**
+     * 修改阶段运行间隔 (如夜间或低功耗时拉长采集间隔)
+     * @param stage 阶段
+     * @param interval 最小运行间隔 (ms)
+     */
+    void setStageInterval(PipelineStage stage, unsigned long interval);
+
+    /**
+     * 推进管道 (应在主循环中调用)：到期时采集，然后各阶段按顺序处理其输入队列
+     */
+    void update();
+
+    /**
+     * 下一次update()时立即采集一次
+     */
+    void triggerAcquire();
+
+    /**
+     * 下一次update()时不等攒够一批即处理该阶段队列 (如上传时段开始)
+     * @param stage 阶段
+     */
+    void flush(PipelineStage stage);
+
+    /**
+     * 暂停/恢复采集 (已在队列中的样本继续向下游流动)
+     * @param pause 是否暂停
+     */
+    void setPaused(bool pause);
+
+    /**
+     * 距离阶段下一次运行的时间 (如提前给传感器上电)
+     * @param stage 阶段
+     * @return 剩余时间 (ms，已到期或已请求立即运行返回0，采集暂停时返回ULONG_MAX)
+     */
+    unsigned long getTimeToNextRun(PipelineStage stage) const;
+
+    /**
+     * 获取阶段统计
+     * @param stage 阶段
+     * @return 统计信息
+     */
+    PipelineStageStats getStageStats(PipelineStage stage) const;
+
+    /**
+     * 清零统计
+     */
+    void resetStats();
+
+    /**
+     * 获取阶段名称
+     * @param stage 阶段
+     * @return 名称
+     */
+    static const char* getStageName(PipelineStage stage);
+
+    /**
+     * 获取管道信息 (各阶段吞吐量、耗时和队列深度)
+     * @return JSON格式的管道信息
+     */
+    String getInfo() const;
+};
+
+#endif // DATA_PIPELINE_H
@@ -0,0 +1,650 @@
+/**
+ * AI智能植物养护机器人 - 产线工厂测试实现
+ */
+
+#include "FactoryTest.h"
+#include "PowerDomain.h"
+#include <ArduinoJson.h>
+#include <Preferences.h>
+#include <string.h>
+
+// 灭/红/绿/蓝/白
+static const uint8_t LIGHT_PHASE_COLORS[FactoryLightTask::PHASE_COUNT][3] = {
+    {0, 0, 0}, {255, 0, 0}, {0, 255, 0}, {0, 0, 255}, {255, 255, 255}
+};
+static const char* const LIGHT_PHASE_NAMES[FactoryLightTask::PHASE_COUNT] = {
+    "off", "red", "green", "blue", "white"
+};
+
+const uint16_t FactoryAudioTask::SWEEP_FREQUENCIES[FactoryAudioTask::STEP_COUNT] = {
+    500, 1000, 2000, 4000
+};
+
+bool FactoryTest::active = false;
+char FactoryTest::commandLine[32];
+uint8_t FactoryTest::commandLength = 0;
+
+/**
+ * 多次读取ADC取平均
+ */
+static int readAverage(int pin, uint8_t samples) {
+    long sum = 0;
+    for (uint8_t i = 0; i < samples; i++) {
+        sum += analogRead(pin);
+    }
+    return sum / samples;
+}
+
+/**
+ * 读数是否贴近0或满量程 (开路/短路)
+ */
+static bool isAtRail(int raw) {
+    return raw < FACTORY_ADC_RAIL_MARGIN || raw > 4095 - FACTORY_ADC_RAIL_MARGIN;
+}
+
+// ============= LED与光感 =============
+
+FactoryLightTask::FactoryLightTask(LEDController& leds)
+    : ledController(leds),
+      phase(0),
+      powered(false) {
+    for (uint8_t i = 0; i < PHASE_COUNT; i++) {
+        readings[i] = -1;
+    }
+}
+
+void FactoryLightTask::body() {
+    CO_BEGIN();
+
+    for (phase = 0; phase < PHASE_COUNT; phase++) {
+        readings[phase] = -1;
+    }
+    PowerDomainManager::acquire(PowerDomain::LED_STRIP);
+    powered = true;
+    CO_AWAIT(PowerDomainManager::isReady(PowerDomain::LED_STRIP));
+
+    // 每种颜色保持一段时间，让光感输出稳定后再采样
+    for (phase = 0; phase < PHASE_COUNT; phase++) {
+        ledController.setColor(LIGHT_PHASE_COLORS[phase][0], LIGHT_PHASE_COLORS[phase][1],
+                               LIGHT_PHASE_COLORS[phase][2]);
+        ledController.show();
+        CO_DELAY(FACTORY_LED_PHASE_MS);
+        readings[phase] = readAverage(LIGHT_SENSOR_PIN, 8);
+    }
+
+    abort();
+    CO_END();
+}
+
+void FactoryLightTask::abort() {
+    if (powered) {
+        ledController.clear();
+        ledController.show();
+        PowerDomainManager::release(PowerDomain::LED_STRIP);
+        powered = false;
+    }
+}
+
+int FactoryLightTask::getReading(uint8_t index) const {
+    return index < PHASE_COUNT ? readings[index] : -1;
+}
+
+// ============= 音频 =============
+
+FactoryAudioTask::FactoryAudioTask(SoundController& sound)
+    : soundController(sound),
+      step(0),
+      powered(false) {
+    for (uint8_t i = 0; i < STEP_COUNT; i++) {
+        measuredHz[i] = 0;
+        peakToPeak[i] = 0;
+    }
+}
+
+/**
+ * 测量检测引脚上的信号频率
+ * 先用窗口的前1/4确定中点和幅度，再带滞回计数上升沿，用首末上升沿之间的时间计算频率
+ * (ESP32-S3单次analogRead约20us，4kHz以内每周期有十几个采样点)
+ */
+float FactoryAudioTask::measureFrequency(int pin, unsigned long windowMs, int& amplitude) {
+    int low = 4095;
+    int high = 0;
+    unsigned long start = millis();
+    while (millis() - start < windowMs / 4) {
+        int value = analogRead(pin);
+        low = min(low, value);
+        high = max(high, value);
+    }
+    amplitude = high - low;
+    if (amplitude < FACTORY_AUDIO_MIN_P2P) {
+        return 0;
+    }
+
+    int mid = (low + high) / 2;
+    int hysteresis = amplitude / 4;
+    bool above = analogRead(pin) > mid;
+    uint16_t edges = 0;
+    unsigned long firstEdge = 0;
+    unsigned long lastEdge = 0;
+    start = millis();
+    while (millis() - start < windowMs) {
+        int value = analogRead(pin);
+        if (!above && value > mid + hysteresis) {
+            above = true;
+            lastEdge = micros();
+            if (edges == 0) {
+                firstEdge = lastEdge;
+            }
+            edges++;
+        } else if (above && value < mid - hysteresis) {
+            above = false;
+        }
+    }
+
+    if (edges < 2 || lastEdge == firstEdge) {
+        return 0;
+    }
+    return (edges - 1) * 1000000.0f / (lastEdge - firstEdge);
+}
+
+void FactoryAudioTask::body() {
+    CO_BEGIN();
+
+    for (step = 0; step < STEP_COUNT; step++) {
+        measuredHz[step] = 0;
+        peakToPeak[step] = 0;
+    }
+    PowerDomainManager::acquire(PowerDomain::AUDIO_AMP);
+    powered = true;
+    CO_AWAIT(PowerDomainManager::isReady(PowerDomain::AUDIO_AMP));
+
+    for (step = 0; step < STEP_COUNT; step++) {
+        soundController.playTone(SWEEP_FREQUENCIES[step], FACTORY_TONE_MS, 100);
+        CO_DELAY(FACTORY_TONE_SETTLE_MS);
+        // 测量期间阻塞，其他检测协程在两次测量之间推进
+        measuredHz[step] = measureFrequency(FACTORY_AUDIO_SENSE_PIN, FACTORY_TONE_MEASURE_MS, peakToPeak[step]);
+        CO_YIELD();
+        soundController.stopSound();
+    }
+
+    abort();
+    CO_END();
+}
+
+void FactoryAudioTask::abort() {
+    if (powered) {
+        soundController.stopSound();
+        PowerDomainManager::release(PowerDomain::AUDIO_AMP);
+        powered = false;
+    }
+}
+
+float FactoryAudioTask::getMeasuredHz(uint8_t index) const {
+    return index < STEP_COUNT ? measuredHz[index] : 0;
+}
+
+int FactoryAudioTask::getPeakToPeak(uint8_t index) const {
+    return index < STEP_COUNT ? peakToPeak[index] : 0;
+}
+
+// ============= 传感器 =============
+
+FactorySensorTask::FactorySensorTask(SensorManager& sensors)
+    : sensorManager(sensors),
+      powered(false),
+      soilRaw(-1),
+      temperature(NAN),
+      humidity(NAN),
+      dhtValid(false) {
+}
+
+void FactorySensorTask::body() {
+    CO_BEGIN();
+
+    soilRaw = -1;
+    temperature = NAN;
+    humidity = NAN;
+    dhtValid = false;
+
+    // 两路电源同时上电，土壤探头先稳定先读
+    PowerDomainManager::acquire(PowerDomain::SENSOR_RAIL);
+    powered = true;
+    sensorManager.prepareSoilReading();
+    CO_AWAIT(sensorManager.isSoilReadingReady());
+    soilRaw = readAverage(SOIL_MOISTURE_PIN, 8);
+    sensorManager.finishSoilReading();
+
+    CO_AWAIT(PowerDomainManager::isReady(PowerDomain::SENSOR_RAIL));
+    temperature = sensorManager.getTemperature();
+    dhtValid = sensorManager.getDHTStatus() == SensorStatus::OK;
+    humidity = sensorManager.getAirHumidity();
+    dhtValid = dhtValid && sensorManager.getDHTStatus() == SensorStatus::OK;
+
+    abort();
+    CO_END();
+}
+
+void FactorySensorTask::abort() {
+    sensorManager.finishSoilReading();
+    if (powered) {
+        PowerDomainManager::release(PowerDomain::SENSOR_RAIL);
+        powered = false;
+    }
+}
+
+int FactorySensorTask::getSoilRaw() const {
+    return soilRaw;
+}
+
+float FactorySensorTask::getTemperature() const {
+    return temperature;
+}
+
+float FactorySensorTask::getHumidity() const {
+    return humidity;
+}
+
+bool FactorySensorTask::isDhtValid() const {
+    return dhtValid;
+}
+
+// ============= 工厂测试 =============
+
+/**
+ * 构造函数
+ */
+FactoryTest::FactoryTest(SensorManager& sensors, LEDController& leds, SoundController& sound, StateManager& state)
+    : stateManager(state),
+      lightTask(leds),
+      audioTask(sound),
+      sensorTask(sensors),
+      running(false),
+      storageChecked(false),
+      timedOut(false),
+      startTime(0),
+      elapsed(0),
+      flashWriteMicros(0),
+      flashReadMicros(0) {
+    for (uint8_t i = 0; i < (uint8_t)FactoryCheck::COUNT; i++) {
+        results[i] = FactoryCheckResult::PENDING;
+        reasons[i] = nullptr;
+    }
+}
+
+/**
+ * 上电后等待进入工厂测试的命令或按键
+ * BOOT键 (GPIO0) 是启动模式引脚，复位时按住会进入下载模式，所以按键在窗口内按下即可，
+ * 按下后须连续保持 FACTORY_TEST_HOLD_MS (窗口结束时仍在按住则延长等待)，避免误触
+ */
+bool FactoryTest::checkEntry(unsigned long windowMs) {
+    pinMode(USER_BUTTON_PIN, INPUT_PULLUP);
+    unsigned long start = millis();
+    unsigned long pressStart = 0;
+    bool pressed = false;
+
+    while (pressed || millis() - start < windowMs) {
+        if (pollCommand()) {
+            return true;
+        }
+        if (digitalRead(USER_BUTTON_PIN) == LOW) {
+            if (!pressed) {
+                pressed = true;
+                pressStart = millis();
+            } else if (millis() - pressStart >= FACTORY_TEST_HOLD_MS) {
+                active = true;
+                return true;
+            }
+        } else {
+            pressed = false;
+        }
+        delay(10);
+    }
+
+    return false;
+}
+
+/**
+ * 读取串口输入
+ */
+bool FactoryTest::pollCommand() {
+    while (Serial.available() > 0) {
+        char c = Serial.read();
+        if (c == '\r' || c == '\n') {
+            commandLine[commandLength] = '\0';
+            bool match = commandLength > 0 && strcmp(commandLine, FACTORY_TEST_COMMAND) == 0;
+            commandLength = 0;
+            if (match) {
+                active = true;
+                return true;
+            }
+        } else if (commandLength < sizeof(commandLine) - 1) {
+            commandLine[commandLength++] = c;
+        }
+    }
+    return false;
+}
+
+/**
+ * 是否处于工厂测试模式
+ */
+bool FactoryTest::isActive() {
+    return active;
+}
+
+/**
+ * 开始测试
+ */
+void FactoryTest::start() {
+    for (uint8_t i = 0; i < (uint8_t)FactoryCheck::COUNT; i++) {
+        results[i] = FactoryCheckResult::PENDING;
+        reasons[i] = nullptr;
+    }
+    running = true;
+    storageChecked = false;
+    timedOut = false;
+    elapsed = 0;
+    startTime = millis();
+
+    if (!CoScheduler::spawn(lightTask)) {
+        setResult(FactoryCheck::LIGHT, false, "scheduler_full");
+    }
+    if (!CoScheduler::spawn(sensorTask)) {
+        setResult(FactoryCheck::DHT, false, "scheduler_full");
+        setResult(FactoryCheck::SOIL, false, "scheduler_full");
+    }
+    if (FACTORY_AUDIO_SENSE_PIN < 0) {
+        results[(size_t)FactoryCheck::AUDIO] = FactoryCheckResult::SKIP;
+        reasons[(size_t)FactoryCheck::AUDIO] = "no_sense_pin";
+    } else if (!CoScheduler::spawn(audioTask)) {
+        setResult(FactoryCheck::AUDIO, false, "scheduler_full");
+    }
+}
+
+/**
+ * 推进测试
+ */
+bool FactoryTest::update() {
+    if (!running) {
+        return false;
+    }
+
+    // 各协程已开始等待电源稳定，此时执行不需要等待的检测
+    if (!storageChecked) {
+        runStorageChecks();
+    }
+
+    evaluate();
+
+    bool pending = false;
+    for (uint8_t i = 0; i < (uint8_t)FactoryCheck::COUNT; i++) {
+        if (results[i] == FactoryCheckResult::PENDING) {
+            pending = true;
+        }
+    }
+
+    if (pending && millis() - startTime >= FACTORY_TEST_TIMEOUT_MS) {
+        timedOut = true;
+        CoScheduler::cancel(lightTask);
+        CoScheduler::cancel(audioTask);
+        CoScheduler::cancel(sensorTask);
+        lightTask.abort();
+        audioTask.abort();
+        sensorTask.abort();
+        for (uint8_t i = 0; i < (uint8_t)FactoryCheck::COUNT; i++) {
+            if (results[i] == FactoryCheckResult::PENDING) {
+                setResult((FactoryCheck)i, false, "timeout");
+            }
+        }
+        pending = false;
+    }
+
+    if (!pending) {
+        running = false;
+        elapsed = millis() - startTime;
+    }
+    return running;
+}
+
+/**
+ * 执行Flash读写和状态管理检测
+ */
+void FactoryTest::runStorageChecks() {
+    storageChecked = true;
+
+    const char* flashError = checkFlash();
+    setResult(FactoryCheck::FLASH, flashError == nullptr, flashError);
+    setResult(FactoryCheck::LOGIC, stateManager.performSelfTest(), "config");
+}
+
+/**
+ * Flash写入/读回/比较：使用单独的NVS命名空间，不影响已保存的用户数据
+ * 每次写入不同的数据，避免读到上一次测试残留的内容
+ * @return 失败原因 (通过时返回nullptr)
+ */
+const char* FactoryTest::checkFlash() {
+    Preferences preferences;
+    if (!preferences.begin(FACTORY_FLASH_NAMESPACE, false)) {
+        return "nvs_open";
+    }
+
+    uint8_t pattern[FACTORY_FLASH_TEST_BYTES];
+    uint8_t readback[FACTORY_FLASH_TEST_BYTES];
+    uint8_t seed = (uint8_t)micros();
+    for (size_t i = 0; i < sizeof(pattern); i++) {
+        pattern[i] = seed + i * 37;
+    }
+    memset(readback, 0, sizeof(readback));
+
+    unsigned long t0 = micros();
+    size_t written = preferences.putBytes("pattern", pattern, sizeof(pattern));
+    flashWriteMicros = micros() - t0;
+
+    t0 = micros();
+    size_t read = preferences.getBytes("pattern", readback, sizeof(readback));
+    flashReadMicros = micros() - t0;
+
+    preferences.remove("pattern");
+    preferences.end();
+
+    if (written != sizeof(pattern)) {
+        return "write";
+    }
+    if (read != sizeof(readback) || memcmp(pattern, readback, sizeof(pattern)) != 0) {
+        return "readback";
+    }
+    return nullptr;
+}
+
+/**
+ * 检查已结束的检测协程并判定结果
+ */
+void FactoryTest::evaluate() {
+    if (results[(size_t)FactoryCheck::LIGHT] == FactoryCheckResult::PENDING && !lightTask.isRunning()) {
+        int dark = lightTask.getReading(0);
+        const char* reason = nullptr;
+        if (dark < 0 || isAtRail(dark)) {
+            reason = "adc_rail";
+        } else if (lightTask.getReading(4) - dark < FACTORY_LIGHT_WHITE_DELTA) {
+            reason = "white";
+        } else {
+            // 单色无响应说明该颜色通道损坏
+            for (uint8_t i = 1; i < 4 && reason == nullptr; i++) {
+                if (lightTask.getReading(i) - dark < FACTORY_LIGHT_CHANNEL_DELTA) {
+                    reason = LIGHT_PHASE_NAMES[i];
+                }
+            }
+        }
+        setResult(FactoryCheck::LIGHT, reason == nullptr, reason);
+    }
+
+    if (results[(size_t)FactoryCheck::AUDIO] == FactoryCheckResult::PENDING && !audioTask.isRunning()) {
+        const char* reason = nullptr;
+        for (uint8_t i = 0; i < FactoryAudioTask::STEP_COUNT && reason == nullptr; i++) {
+            float expected = FactoryAudioTask::SWEEP_FREQUENCIES[i];
+            if (audioTask.getPeakToPeak(i) < FACTORY_AUDIO_MIN_P2P) {
+                reason = "no_signal";
+            } else if (fabsf(audioTask.getMeasuredHz(i) - expected) > expected * FACTORY_TONE_TOLERANCE) {
+                reason = "frequency";
+            }
+        }
+        setResult(FactoryCheck::AUDIO, reason == nullptr, reason);
+    }
+
+    if (results[(size_t)FactoryCheck::SOIL] == FactoryCheckResult::PENDING && sensorTask.getSoilRaw() >= 0) {
+        setResult(FactoryCheck::SOIL, !isAtRail(sensorTask.getSoilRaw()), "adc_rail");
+    }
+
+    if (results[(size_t)FactoryCheck::DHT] == FactoryCheckResult::PENDING && !sensorTask.isRunning()) {
+        float temperature = sensorTask.getTemperature();
+        float humidity = sensorTask.getHumidity();
+        if (!sensorTask.isDhtValid()) {
+            setResult(FactoryCheck::DHT, false, "no_response");
+        } else {
+            bool inRange = temperature >= FACTORY_TEMP_MIN && temperature <= FACTORY_TEMP_MAX &&
+                           humidity >= FACTORY_HUMIDITY_MIN && humidity <= FACTORY_HUMIDITY_MAX;
+            setResult(FactoryCheck::DHT, inRange, "out_of_range");
+        }
+    }
+}
+
+/**
+ * 记录检测结果 (通过时忽略原因)
+ */
+void FactoryTest::setResult(FactoryCheck check, bool pass, const char* reason) {
+    results[(size_t)check] = pass ? FactoryCheckResult::PASS : FactoryCheckResult::FAIL;
+    reasons[(size_t)check] = pass ? nullptr : reason;
+}
+
+/**
+ * 是否全部通过
+ */
+bool FactoryTest::passed() const {
+    for (uint8_t i = 0; i < (uint8_t)FactoryCheck::COUNT; i++) {
+        if (results[i] != FactoryCheckResult::PASS && results[i] != FactoryCheckResult::SKIP) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * 获取检测项结果
+ */
+FactoryCheckResult FactoryTest::getResult(FactoryCheck check) const {
+    return results[(size_t)check];
+}
+
+/**
+ * 写入设备标识 (记录头)
+ */
+static JsonObject beginRecord(JsonDocument& doc) {
+    JsonObject record = doc.createNestedObject("factory_test");
+    record["device"] = DEVICE_NAME;
+    record["fw"] = FIRMWARE_VERSION;
+    record["hw"] = HARDWARE_VERSION;
+
+    // 出厂MAC (eFuse)，低字节在前
+    uint64_t mac = ESP.getEfuseMac();
+    char macText[18];
+    snprintf(macText, sizeof(macText), "%02X:%02X:%02X:%02X:%02X:%02X",
+             (uint8_t)mac, (uint8_t)(mac >> 8), (uint8_t)(mac >> 16),
+             (uint8_t)(mac >> 24), (uint8_t)(mac >> 32), (uint8_t)(mac >> 40));
+    record["mac"] = macText;
+    return record;
+}
+
+/**
+ * 输出单行JSON结果记录
+ */
+void FactoryTest::printRecord(Print& out) const {
+    DynamicJsonDocument doc(2048);
+    JsonObject record = beginRecord(doc);
+    record["pass"] = passed();
+    record["ms"] = running ? millis() - startTime : elapsed;
+    if (timedOut) {
+        record["timeout"] = true;
+    }
+
+    JsonArray failed = record.createNestedArray("failed");
+    JsonObject checks = record.createNestedObject("checks");
+    for (uint8_t i = 0; i < (uint8_t)FactoryCheck::COUNT; i++) {
+        JsonObject check = checks.createNestedObject(getCheckName((FactoryCheck)i));
+        check["result"] = getResultName(results[i]);
+        if (reasons[i] != nullptr) {
+            check["reason"] = reasons[i];
+        }
+        if (results[i] == FactoryCheckResult::FAIL || results[i] == FactoryCheckResult::PENDING) {
+            failed.add(getCheckName((FactoryCheck)i));
+        }
+    }
+
+    // 原始测量值，便于产线统计和调整门限
+    JsonObject light = checks["light"];
+    for (uint8_t i = 0; i < FactoryLightTask::PHASE_COUNT; i++) {
+        light[LIGHT_PHASE_NAMES[i]] = lightTask.getReading(i);
+    }
+
+    if (results[(size_t)FactoryCheck::AUDIO] != FactoryCheckResult::SKIP) {
+        JsonObject audio = checks["audio"];
+        JsonArray hz = audio.createNestedArray("hz");
+        JsonArray p2p = audio.createNestedArray("p2p");
+        for (uint8_t i = 0; i < FactoryAudioTask::STEP_COUNT; i++) {
+            hz.add(lroundf(audioTask.getMeasuredHz(i)));
+            p2p.add(audioTask.getPeakToPeak(i));
+        }
+    }
+
+    JsonObject dht = checks["dht"];
+    if (sensorTask.isDhtValid()) {
+        dht["temp"] = sensorTask.getTemperature();
+        dht["hum"] = sensorTask.getHumidity();
+    }
+    checks["soil"]["raw"] = sensorTask.getSoilRaw();
+    checks["flash"]["write_us"] = flashWriteMicros;
+    checks["flash"]["read_us"] = flashReadMicros;
+
+    serializeJson(doc, out);
+    out.println();
+}
+
+/**
+ * 初始化失败时输出结果记录
+ */
+void FactoryTest::printAbortRecord(Print& out, const char* reason) {
+    DynamicJsonDocument doc(512);
+    JsonObject record = beginRecord(doc);
+    record["pass"] = false;
+    record["ms"] = 0;
+    record["reason"] = reason;
+
+    serializeJson(doc, out);
+    out.println();
+}
+
+/**
+ * 获取检测项名称
+ */
+const char* FactoryTest::getCheckName(FactoryCheck check) {
+    switch (check) {
+        case FactoryCheck::LIGHT: return "light";
+        case FactoryCheck::AUDIO: return "audio";
+        case FactoryCheck::DHT: return "dht";
+        case FactoryCheck::SOIL: return "soil";
+        case FactoryCheck::FLASH: return "flash";
+        case FactoryCheck::LOGIC: return "logic";
+        default: return "unknown";
+    }
+}
+
+/**
+ * 获取结果名称
+ */
+const char* FactoryTest::getResultName(FactoryCheckResult result) {
+    switch (result) {
+        case FactoryCheckResult::PENDING: return "pending";
+        case FactoryCheckResult::PASS: return "pass";
+        case FactoryCheckResult::FAIL: return "fail";
+        case FactoryCheckResult::SKIP: return "skip";
+        default: return "unknown";
+    }
+}
@@ -0,0 +1,241 @@
+/**
+ * AI智能植物养护机器人 - 产线工厂测试
+ * 原来的各模块自检 (LED、音效、传感器、持久化、状态管理) 依次执行、
+ * 中间用固定delay()等待，并且只输出给人看的文字。工厂测试模式把硬件检测写成协程并行执行：
+ * LED颜色序列期间采样光感、扫频播放时经ADC测量频率、等待传感器电源稳定的同时读写Flash，
+ * 总耗时取决于最慢的一项 (DHT22上电稳定)，约2秒。
+ *
+ * 结果以单行JSON经USB串口输出，供夹具解析：
+ *   {"factory_test":{"device":..., "fw":..., "hw":..., "mac":"...", "pass":true, "ms":耗时,
+ *    "failed":[未通过的检测项], "checks":{"light":{"result":"pass", ...}, "audio":{...}, ...}}}
+ * 各检测项的result为 "pass" / "fail" / "skip"，fail时附带reason。
+ *
+ * 进入方式：上电后 FACTORY_TEST_ENTRY_WINDOW_MS 内夹具发送 FACTORY_TEST_COMMAND 命令行，
+ * 或在窗口内按下BOOT键并按住 FACTORY_TEST_HOLD_MS (BOOT键是启动模式引脚，不能在复位时按住)。
+ * 测试模式下跳过启动流程的串行检查和WiFi，夹具可以再次发送命令重测。
+ */
+
+#ifndef FACTORY_TEST_H
+#define FACTORY_TEST_H
+
+#include <Arduino.h>
+#include "SensorManager.h"
+#include "LEDController.h"
+#include "SoundController.h"
+#include "StateManager.h"
+#include "Coroutine.h"
+#include "config.h"
+
+/**
+ * 检测项
+ */
+enum class FactoryCheck : uint8_t {
+    LIGHT,          // LED颜色序列 + 光感
+    AUDIO,          // 扫频 + ADC测频
+    DHT,            // 温湿度传感器
+    SOIL,           // 土壤探头
+    FLASH,          // Flash写入/读回
+    LOGIC,          // 状态管理配置
+    COUNT
+};
+
+/**
+ * 检测结果
+ */
+enum class FactoryCheckResult : uint8_t {
+    PENDING,
+    PASS,
+    FAIL,
+    SKIP
+};
+
+/**
+ * LED与光感检测协程：依次显示 灭/红/绿/蓝/白，每种颜色结束前采样光感
+ */
+class FactoryLightTask : public Coroutine {
+public:
+    static const uint8_t PHASE_COUNT = 5;
+
+private:
+    LEDController& ledController;
+    uint8_t phase;
+    bool powered;
+    int readings[PHASE_COUNT];
+
+protected:
+    void body() override;
+
+public:
+    explicit FactoryLightTask(LEDController& leds);
+
+    /**
+     * 中止时熄灯并释放电源
+     */
+    void abort();
+
+    /**
+     * 获取某种颜色下的光感读数 (-1表示未采样)
+     */
+    int getReading(uint8_t index) const;
+};
+
+/**
+ * 音频检测协程：依次播放扫频音，由夹具检测引脚的ADC过零计数估计频率
+ */
+class FactoryAudioTask : public Coroutine {
+public:
+    static const uint8_t STEP_COUNT = 4;
+    static const uint16_t SWEEP_FREQUENCIES[STEP_COUNT];
+
+private:
+    SoundController& soundController;
+    uint8_t step;
+    bool powered;
+    float measuredHz[STEP_COUNT];
+    int peakToPeak[STEP_COUNT];
+
+    static float measureFrequency(int pin, unsigned long windowMs, int& amplitude);
+
+protected:
+    void body() override;
+
+public:
+    explicit FactoryAudioTask(SoundController& sound);
+
+    /**
+     * 中止时停止播放并释放功放电源
+     */
+    void abort();
+
+    float getMeasuredHz(uint8_t index) const;
+    int getPeakToPeak(uint8_t index) const;
+};
+
+/**
+ * 传感器检测协程：土壤探头激励稳定后读数，传感器电源稳定后读取DHT22
+ */
+class FactorySensorTask : public Coroutine {
+private:
+    SensorManager& sensorManager;
+    bool powered;
+    int soilRaw;
+    float temperature;
+    float humidity;
+    bool dhtValid;
+
+protected:
+    void body() override;
+
+public:
+    explicit FactorySensorTask(SensorManager& sensors);
+
+    /**
+     * 中止时断开传感器电源和土壤探头激励
+     */
+    void abort();
+
+    int getSoilRaw() const;
+    float getTemperature() const;
+    float getHumidity() const;
+    bool isDhtValid() const;
+};
+
+/**
+ * 工厂测试
+ */
+class FactoryTest {
+private:
+    StateManager& stateManager;
+
+    FactoryLightTask lightTask;
+    FactoryAudioTask audioTask;
+    FactorySensorTask sensorTask;
+
+    FactoryCheckResult results[(size_t)FactoryCheck::COUNT];
+    const char* reasons[(size_t)FactoryCheck::COUNT];
+    bool running;
+    bool storageChecked;
+    bool timedOut;
+    unsigned long startTime;
+    unsigned long elapsed;
+    unsigned long flashWriteMicros;
+    unsigned long flashReadMicros;
+
+    static bool active;
+    static char commandLine[32];
+    static uint8_t commandLength;
+
+    void runStorageChecks();
+    const char* checkFlash();
+    void evaluate();
+    void setResult(FactoryCheck check, bool pass, const char* reason);
+
+public:
+    /**
+     * 构造函数
+     */
+    FactoryTest(SensorManager& sensors, LEDController& leds, SoundController& sound, StateManager& state);
+
+    /**
+     * 上电后等待进入工厂测试的命令或按键 (替代启动时的固定等待)
+     * @param windowMs 等待时间 (ms)
+     * @return 是否进入工厂测试模式
+     */
+    static bool checkEntry(unsigned long windowMs);
+
+    /**
+     * 读取串口输入，收到完整的测试命令行时返回true (不阻塞)
+     */
+    static bool pollCommand();
+
+    /**
+     * 是否处于工厂测试模式 (各模块据此跳过初始化时的串行自检)
+     */
+    static bool isActive();
+
+    /**
+     * 开始测试 (启动各检测协程)
+     */
+    void start();
+
+    /**
+     * 推进测试 (在 CoScheduler::update 之后调用)
+     * @return 是否仍在进行
+     */
+    bool update();
+
+    /**
+     * 是否全部通过
+     */
+    bool passed() const;
+
+    /**
+     * 获取检测项结果
+     */
+    FactoryCheckResult getResult(FactoryCheck check) const;
+
+    /**
+     * 输出单行JSON结果记录
+     * @param out 输出目标 (通常为Serial)
+     */
+    void printRecord(Print& out) const;
+
+    /**
+     * 初始化失败、无法开始测试时输出结果记录
+     * @param out 输出目标
+     * @param reason 失败原因
+     */
+    static void printAbortRecord(Print& out, const char* reason);
+
+    /**
+     * 获取检测项名称
+     */
+    static const char* getCheckName(FactoryCheck check);
+
+    /**
+     * 获取结果名称
+     */
+    static const char* getResultName(FactoryCheckResult result);
+};
+
+#endif // FACTORY_TEST_H
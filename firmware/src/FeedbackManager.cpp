@@ -8,8 +8,6 @@
 #include "SensorManager.h"
 #include "StateManager.h"
 
-extern LEDController ledController;
-extern SoundController soundController;
 extern SensorManager sensorManager;
 extern StateManager stateManager;
 
@@ -59,14 +57,17 @@ const FeedbackPattern FeedbackManager::ERROR_PATTERN = {
   200           // 音效200ms
 };
 
-FeedbackManager::FeedbackManager()
-  : immediateStatusEnabled(true),
+FeedbackManager::FeedbackManager(LEDController& leds, SoundController& sound)
+  : ledController(leds),
+    soundController(sound),
+    immediateStatusEnabled(true),
     touchFeedbackEnabled(true),
     celebrationEnabled(true),
     soundEnabled(true),
     lastFeedbackTime(0),
     currentFeedback(FeedbackType::STARTUP_STATUS),
-    feedbackActive(false) {
+    feedbackActive(false),
+    celebration(leds, sound) {
 }
 
 void FeedbackManager::begin() {
@@ -216,96 +217,108 @@ void FeedbackManager::celebrateWaterProblemSolved() {
   if (!celebrationEnabled) return;
   
   Serial.println("FeedbackManager: Celebrating water problem solved");
-  
-  // 蓝色到绿色的渐变庆祝
-  for (int i = 0; i <= 255; i += 51) {
-    ledController.setColor(0, i, 255 - i);
-    ledController.setBrightness(200);
-    ledController.turnOn();
-    delay(100);
-  }
-  
-  if (soundEnabled) {
-    // 播放上升音阶
-    soundController.playTone(523, 150); // C5
-    delay(50);
-    soundController.playTone(659, 150); // E5
-    delay(50);
-    soundController.playTone(784, 200); // G5
-  }
-  
-  // 最终显示绿色
-  ledController.setColor(0, 255, 0);
-  ledController.turnOn();
+  startCelebration(CelebrationType::WATER_SOLVED);
 }
 
 void FeedbackManager::celebrateLightProblemSolved() {
   if (!celebrationEnabled) return;
   
   Serial.println("FeedbackManager: Celebrating light problem solved");
-  
-  // 橙色到绿色的渐变庆祝
-  for (int i = 0; i <= 255; i += 51) {
-    ledController.setColor(255 - i, 255, 0);
-    ledController.setBrightness(200);
-    ledController.turnOn();
-    delay(100);
-  }
-  
-  if (soundEnabled) {
-    // 播放明亮的和弦
-    soundController.playTone(659, 150); // E5
-    delay(50);
-    soundController.playTone(784, 150); // G5
-    delay(50);
-    soundController.playTone(988, 200); // B5
-  }
-  
-  // 最终显示绿色
-  ledController.setColor(0, 255, 0);
-  ledController.turnOn();
+  startCelebration(CelebrationType::LIGHT_SOLVED);
 }
 
 void FeedbackManager::celebrateAllProblemsSolved() {
   if (!celebrationEnabled) return;
   
   Serial.println("FeedbackManager: Celebrating all problems solved");
+  startCelebration(CelebrationType::ALL_SOLVED);
+}
+
+void FeedbackManager::startCelebration(CelebrationType type) {
+  // 新的庆祝打断正在播放的庆祝
+  celebration.configure(type, soundEnabled);
+  CoScheduler::spawn(celebration);
+}
+
+// 彩虹庆祝颜色
+static const uint8_t RAINBOW_COLORS[][3] = {
+  {255, 0, 0},   // 红
+  {255, 165, 0}, // 橙
+  {255, 255, 0}, // 黄
+  {0, 255, 0},   // 绿
+  {0, 0, 255},   // 蓝
+  {75, 0, 130},  // 靛
+  {148, 0, 211}  // 紫
+};
+
+// 庆祝音效 {频率, 时长}，音符之间间隔50ms
+static const uint16_t WATER_NOTES[][2] = {{523, 150}, {659, 150}, {784, 200}};             // C5 E5 G5
+static const uint16_t LIGHT_NOTES[][2] = {{659, 150}, {784, 150}, {988, 200}};             // E5 G5 B5
+static const uint16_t VICTORY_NOTES[][2] = {{523, 200}, {659, 200}, {784, 200}, {1047, 400}}; // C5 E5 G5 C6
+
+CelebrationAnimation::CelebrationAnimation(LEDController& leds, SoundController& sound)
+  : ledController(leds),
+    soundController(sound),
+    type(CelebrationType::WATER_SOLVED),
+    withSound(false),
+    step(0),
+    cycle(0) {
+}
+
+void CelebrationAnimation::configure(CelebrationType celebrationType, bool playSound) {
+  type = celebrationType;
+  withSound = playSound;
+}
+
+void CelebrationAnimation::body() {
+  const uint16_t (*notes)[2] = WATER_NOTES;
+  uint8_t noteCount = 3;
+  if (type == CelebrationType::LIGHT_SOLVED) {
+    notes = LIGHT_NOTES;
+  } else if (type == CelebrationType::ALL_SOLVED) {
+    notes = VICTORY_NOTES;
+    noteCount = 4;
+  }
   
-  // 彩虹庆祝效果
-  uint8_t colors[][3] = {
-    {255, 0, 0},   // 红
-    {255, 165, 0}, // 橙
-    {255, 255, 0}, // 黄
-    {0, 255, 0},   // 绿
-    {0, 0, 255},   // 蓝
-    {75, 0, 130},  // 靛
-    {148, 0, 211}  // 紫
-  };
-  
-  for (int cycle = 0; cycle < 2; cycle++) {
-    for (int i = 0; i < 7; i++) {
-      ledController.setColor(colors[i][0], colors[i][1], colors[i][2]);
-      ledController.setBrightness(255);
+  CO_BEGIN();
+  
+  if (type == CelebrationType::ALL_SOLVED) {
+    // 彩虹庆祝效果
+    for (cycle = 0; cycle < 2; cycle++) {
+      for (step = 0; step < 7; step++) {
+        ledController.setColor(RAINBOW_COLORS[step][0], RAINBOW_COLORS[step][1], RAINBOW_COLORS[step][2]);
+        ledController.setBrightness(255);
+        ledController.turnOn();
+        CO_DELAY(200);
+      }
+    }
+  } else {
+    // 蓝色(缺水)或橙色(缺光)到绿色的渐变
+    for (cycle = 0; cycle <= 5; cycle++) {
+      if (type == CelebrationType::WATER_SOLVED) {
+        ledController.setColor(0, cycle * 51, 255 - cycle * 51);
+      } else {
+        ledController.setColor(255 - cycle * 51, 255, 0);
+      }
+      ledController.setBrightness(200);
       ledController.turnOn();
-      delay(200);
+      CO_DELAY(100);
     }
   }
   
-  if (soundEnabled) {
-    // 播放胜利音效
-    soundController.playTone(523, 200); // C5
-    delay(50);
-    soundController.playTone(659, 200); // E5
-    delay(50);
-    soundController.playTone(784, 200); // G5
-    delay(50);
-    soundController.playTone(1047, 400); // C6
+  if (withSound) {
+    for (step = 0; step < noteCount; step++) {
+      soundController.playTone(notes[step][0], notes[step][1], SPEAKER_VOLUME);
+      CO_DELAY(notes[step][1] + 50);
+    }
   }
   
   // 最终显示绿色
   ledController.setColor(0, 255, 0);
   ledController.setBrightness(200);
   ledController.turnOn();
+  
+  CO_END();
 }
 
 void FeedbackManager::executeFeedbackPattern(const FeedbackPattern& pattern, FeedbackIntensity intensity) {
@@ -7,6 +7,10 @@
 #define FEEDBACK_MANAGER_H
 
 #include <Arduino.h>
+#include "Coroutine.h"
+
+class LEDController;
+class SoundController;
 
 enum class FeedbackType {
   STARTUP_STATUS,
@@ -33,8 +37,35 @@ struct FeedbackPattern {
   uint16_t soundDuration;
 };
 
+enum class CelebrationType {
+  WATER_SOLVED,   // 蓝->绿渐变 + 上升音阶
+  LIGHT_SOLVED,   // 橙->绿渐变 + 明亮和弦
+  ALL_SOLVED      // 两轮彩虹 + 胜利音效
+};
+
+// 庆祝动画协程：灯光渐变、音阶依次播放，不阻塞主循环
+class CelebrationAnimation : public Coroutine {
+private:
+  LEDController& ledController;
+  SoundController& soundController;
+  CelebrationType type;
+  bool withSound;
+  uint8_t step;
+  uint8_t cycle;
+
+protected:
+  void body() override;
+
+public:
+  CelebrationAnimation(LEDController& leds, SoundController& sound);
+  void configure(CelebrationType celebrationType, bool playSound);
+};
+
 class FeedbackManager {
 private:
+  LEDController& ledController;
+  SoundController& soundController;
+  
   bool immediateStatusEnabled;
   bool touchFeedbackEnabled;
   bool celebrationEnabled;
@@ -44,6 +75,8 @@ private:
   FeedbackType currentFeedback;
   bool feedbackActive;
   
+  CelebrationAnimation celebration;
+  
   // 预定义反馈模式
   static const FeedbackPattern STARTUP_PATTERN;
   static const FeedbackPattern TOUCH_PATTERN;
@@ -54,9 +87,10 @@ private:
   void executeFeedbackPattern(const FeedbackPattern& pattern, FeedbackIntensity intensity);
   void playFeedbackSound(uint16_t frequency, uint16_t duration, FeedbackIntensity intensity);
   void showFeedbackLight(uint8_t r, uint8_t g, uint8_t b, uint16_t duration, FeedbackIntensity intensity);
+  void startCelebration(CelebrationType type);
 
 public:
-  FeedbackManager();
+  FeedbackManager(LEDController& leds, SoundController& sound);
   
   // 初始化和配置
   void begin();
@@ -0,0 +1,341 @@
+/**
+ * AI智能植物养护机器人 - GPIO事件管理器实现
+ */
+
+#include "GpioEventManager.h"
+#include <ArduinoJson.h>
+#include <driver/gpio.h>
+#include <esp_sleep.h>
+
+/**
+ * 构造函数
+ */
+GpioEventManager::GpioEventManager()
+    : eventQueue(nullptr),
+      initialized(false),
+      interruptCount(0),
+      eventCount(0),
+      dispatchCount(0),
+      dropCount(0) {
+
+    for (int i = 0; i < MAX_PINS; i++) {
+        entries[i] = {
+            .owner = this,
+            .pin = -1,
+            .callback = nullptr,
+            .debounceTimer = nullptr,
+            .stableLevel = -1,
+            .wakeSource = false,
+            .active = false
+        };
+    }
+}
+
+/**
+ * 析构函数
+ */
+GpioEventManager::~GpioEventManager() {
+    for (int i = 0; i < MAX_PINS; i++) {
+        if (entries[i].active) {
+            unregisterPin(entries[i].pin);
+        }
+    }
+    if (eventQueue != nullptr) {
+        vQueueDelete(eventQueue);
+    }
+}
+
+/**
+ * 初始化事件队列
+ */
+bool GpioEventManager::begin(int queueLength) {
+    if (initialized) {
+        return true;
+    }
+
+    eventQueue = xQueueCreate(queueLength, sizeof(GpioEvent));
+    if (eventQueue == nullptr) {
+        DEBUG_PRINTLN("✗ GPIO事件队列创建失败");
+        return false;
+    }
+
+    initialized = true;
+    DEBUG_PRINTF("✓ GPIO事件管理器初始化成功，队列长度: %d\n", queueLength);
+    return true;
+}
+
+/**
+ * 注册引脚
+ */
+bool GpioEventManager::registerPin(int pin, int mode, GpioEventCallback callback,
+                                   uint32_t debounceMs, bool wakeSource) {
+    if (!initialized || callback == nullptr) {
+        return false;
+    }
+
+    PinEntry* entry = findEntry(pin);
+    if (entry == nullptr) {
+        entry = findEntry(-1);
+    }
+    if (entry == nullptr) {
+        DEBUG_PRINTF("✗ GPIO%d注册失败：注册表已满\n", pin);
+        return false;
+    }
+
+    if (entry->debounceTimer == nullptr) {
+        // 单次定时器：每个边沿都会重置，电平稳定 debounceMs 后才触发
+        entry->debounceTimer = xTimerCreate("gpio_debounce",
+                                            pdMS_TO_TICKS(max(debounceMs, (uint32_t)1)),
+                                            pdFALSE, entry, handleDebounceTimer);
+        if (entry->debounceTimer == nullptr) {
+            DEBUG_PRINTF("✗ GPIO%d防抖定时器创建失败\n", pin);
+            return false;
+        }
+    } else {
+        xTimerChangePeriod(entry->debounceTimer, pdMS_TO_TICKS(max(debounceMs, (uint32_t)1)), 0);
+        xTimerStop(entry->debounceTimer, 0);
+    }
+
+    pinMode(pin, mode);
+
+    entry->pin = pin;
+    entry->callback = callback;
+    entry->stableLevel = digitalRead(pin);
+    entry->wakeSource = wakeSource;
+    entry->active = true;
+
+    attachInterruptArg(pin, handleInterrupt, entry, CHANGE);
+
+    DEBUG_PRINTF("GPIO%d已注册: 初始电平=%d, 防抖=%lums%s\n",
+                 pin, entry->stableLevel, (unsigned long)debounceMs,
+                 wakeSource ? ", 唤醒源" : "");
+    return true;
+}
+
+/**
+ * 注销引脚
+ */
+void GpioEventManager::unregisterPin(int pin) {
+    PinEntry* entry = findEntry(pin);
+    if (entry == nullptr || pin < 0) {
+        return;
+    }
+
+    detachInterrupt(pin);
+    if (entry->debounceTimer != nullptr) {
+        xTimerStop(entry->debounceTimer, 0);
+    }
+    if (entry->wakeSource) {
+        gpio_wakeup_disable((gpio_num_t)pin);
+    }
+
+    entry->active = false;
+    entry->callback = nullptr;
+    entry->pin = -1;
+}
+
+/**
+ * 边沿中断：仅重置防抖定时器
+ */
+void IRAM_ATTR GpioEventManager::handleInterrupt(void* arg) {
+    PinEntry* entry = static_cast<PinEntry*>(arg);
+    BaseType_t higherPriorityTaskWoken = pdFALSE;
+
+    entry->owner->interruptCount++;
+    xTimerResetFromISR(entry->debounceTimer, &higherPriorityTaskWoken);
+
+    if (higherPriorityTaskWoken) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+/**
+ * 防抖定时器到期 (定时器任务上下文)：采样稳定电平并入队
+ */
+void GpioEventManager::handleDebounceTimer(TimerHandle_t timer) {
+    PinEntry* entry = static_cast<PinEntry*>(pvTimerGetTimerID(timer));
+    if (!entry->active) {
+        return;
+    }
+
+    int level = digitalRead(entry->pin);
+    if (level != entry->stableLevel) {
+        entry->stableLevel = level;
+        entry->owner->postEvent(entry, level);
+    }
+}
+
+/**
+ * 事件入队
+ */
+void GpioEventManager::postEvent(PinEntry* entry, int level) {
+    GpioEvent event = {
+        .pin = entry->pin,
+        .level = level,
+        .timestamp = millis()
+    };
+
+    eventCount++;
+    if (xQueueSend(eventQueue, &event, 0) != pdTRUE) {
+        dropCount++;
+    }
+}
+
+/**
+ * 分发队列中的事件
+ */
+int GpioEventManager::dispatch() {
+    if (!initialized) {
+        return 0;
+    }
+
+    int count = 0;
+    GpioEvent event;
+
+    while (xQueueReceive(eventQueue, &event, 0) == pdTRUE) {
+        PinEntry* entry = findEntry(event.pin);
+        if (entry != nullptr && entry->callback != nullptr) {
+            entry->callback(event);
+        }
+        dispatchCount++;
+        count++;
+    }
+
+    return count;
+}
+
+/**
+ * 获取引脚当前的稳定电平
+ */
+int GpioEventManager::getStableLevel(int pin) {
+    PinEntry* entry = findEntry(pin);
+    return entry != nullptr ? entry->stableLevel : -1;
+}
+
+/**
+ * 进入浅睡眠
+ */
+bool GpioEventManager::lightSleep(uint32_t durationMs) {
+    if (!initialized || durationMs == 0) {
+        return false;
+    }
+
+    bool slept = false;
+    if (prepareLightSleep()) {
+        esp_sleep_enable_timer_wakeup((uint64_t)durationMs * 1000);
+        slept = esp_light_sleep_start() == ESP_OK;
+        esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_TIMER);
+    }
+
+    // 无论是否睡眠都恢复边沿中断
+    resumeFromLightSleep();
+    return slept;
+}
+
+/**
+ * 为浅睡眠配置唤醒源
+ * @return 是否可以睡眠 (有唤醒源的电平已偏离稳定电平时为false)
+ */
+bool GpioEventManager::prepareLightSleep() {
+    bool anyWakeSource = false;
+
+    for (int i = 0; i < MAX_PINS; i++) {
+        PinEntry& entry = entries[i];
+        if (!entry.active || !entry.wakeSource) {
+            continue;
+        }
+
+        // 电平唤醒会把中断类型改为电平触发，先关闭该引脚的中断，避免电平保持期间反复进入中断
+        gpio_intr_disable((gpio_num_t)entry.pin);
+
+        // 电平已变化、防抖尚未确认时立即唤醒也没有意义，直接放弃这次睡眠
+        if (digitalRead(entry.pin) != entry.stableLevel) {
+            return false;
+        }
+
+        // 浅睡眠只支持电平唤醒：以当前稳定电平的相反电平作为唤醒条件
+        gpio_int_type_t wakeLevel = entry.stableLevel == HIGH ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL;
+        if (gpio_wakeup_enable((gpio_num_t)entry.pin, wakeLevel) == ESP_OK) {
+            anyWakeSource = true;
+        }
+    }
+
+    if (anyWakeSource) {
+        esp_sleep_enable_gpio_wakeup();
+    }
+
+    return true;
+}
+
+/**
+ * 浅睡眠唤醒 (或放弃睡眠) 后恢复边沿中断并补发电平变化
+ */
+void GpioEventManager::resumeFromLightSleep() {
+    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_GPIO);
+
+    for (int i = 0; i < MAX_PINS; i++) {
+        PinEntry& entry = entries[i];
+        if (!entry.active || !entry.wakeSource) {
+            continue;
+        }
+
+        // 电平唤醒配置会覆盖中断类型，恢复为边沿中断并重新使能
+        gpio_wakeup_disable((gpio_num_t)entry.pin);
+        attachInterruptArg(entry.pin, handleInterrupt, &entry, CHANGE);
+
+        // 唤醒的电平变化交给防抖定时器确认
+        xTimerReset(entry.debounceTimer, 0);
+    }
+}
+
+/**
+ * 查找引脚注册项 (pin为-1时返回空闲项)
+ */
+GpioEventManager::PinEntry* GpioEventManager::findEntry(int pin) {
+    for (int i = 0; i < MAX_PINS; i++) {
+        if (pin < 0 ? !entries[i].active : (entries[i].active && entries[i].pin == pin)) {
+            return &entries[i];
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * 获取统计信息
+ */
+GpioEventStats GpioEventManager::getStats() const {
+    GpioEventStats stats = {
+        .interrupts = interruptCount,
+        .events = eventCount,
+        .dispatched = dispatchCount,
+        .dropped = dropCount
+    };
+    return stats;
+}
+
+/**
+ * 获取事件管理器信息
+ */
+String GpioEventManager::getInfo() const {
+    DynamicJsonDocument doc(512);
+
+    doc["initialized"] = initialized;
+    doc["interrupts"] = interruptCount;
+    doc["events"] = eventCount;
+    doc["dispatched"] = dispatchCount;
+    doc["dropped"] = dropCount;
+
+    JsonArray pins = doc.createNestedArray("pins");
+    for (int i = 0; i < MAX_PINS; i++) {
+        if (entries[i].active) {
+            JsonObject pin = pins.createNestedObject();
+            pin["pin"] = entries[i].pin;
+            pin["level"] = entries[i].stableLevel;
+            pin["wake"] = entries[i].wakeSource;
+        }
+    }
+
+    String result;
+    serializeJson(doc, result);
+    return result;
+}
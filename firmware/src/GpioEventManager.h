@@ -0,0 +1,152 @@
+/**
+ * AI智能植物养护机器人 - GPIO事件管理器
+ * 边沿中断 + 防抖定时器 + ISR安全队列，将引脚变化投递到主循环
+ * 注册的引脚可作为浅睡眠唤醒源
+ */
+
+#ifndef GPIO_EVENT_MANAGER_H
+#define GPIO_EVENT_MANAGER_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/timers.h>
+#include "config.h"
+
+/**
+ * GPIO事件 (防抖后的稳定电平变化)
+ */
+struct GpioEvent {
+    int pin;                    // 引脚号
+    int level;                  // 新的稳定电平 (HIGH/LOW)
+    unsigned long timestamp;    // 电平稳定的时间 (ms)
+};
+
+/**
+ * GPIO事件回调函数类型 (在主循环上下文中调用)
+ */
+typedef void (*GpioEventCallback)(const GpioEvent& event);
+
+/**
+ * GPIO事件统计
+ */
+struct GpioEventStats {
+    unsigned long interrupts;   // 边沿中断次数 (含抖动)
+    unsigned long events;       // 防抖后产生的事件数
+    unsigned long dispatched;   // 已分发的事件数
+    unsigned long dropped;      // 队列满丢弃的事件数
+};
+
+/**
+ * GPIO事件管理器类
+ */
+class GpioEventManager {
+public:
+    static const int MAX_PINS = 8;                    // 最多注册的引脚数
+    static const int DEFAULT_QUEUE_LENGTH = 16;       // 事件队列长度
+    static const uint32_t DEFAULT_DEBOUNCE_MS = 20;   // 默认防抖时间 (ms)
+
+private:
+    /**
+     * 引脚注册项
+     */
+    struct PinEntry {
+        GpioEventManager* owner;
+        int pin;
+        GpioEventCallback callback;
+        TimerHandle_t debounceTimer;
+        volatile int stableLevel;
+        bool wakeSource;
+        bool active;
+    };
+
+    PinEntry entries[MAX_PINS];
+    QueueHandle_t eventQueue;
+    bool initialized;
+
+    volatile unsigned long interruptCount;
+    unsigned long eventCount;
+    unsigned long dispatchCount;
+    unsigned long dropCount;
+
+    // 中断与定时器入口
+    static void IRAM_ATTR handleInterrupt(void* arg);
+    static void handleDebounceTimer(TimerHandle_t timer);
+
+    PinEntry* findEntry(int pin);
+    void postEvent(PinEntry* entry, int level);
+    bool prepareLightSleep();
+    void resumeFromLightSleep();
+
+public:
+    /**
+     * 构造函数
+     */
+    GpioEventManager();
+
+    /**
+     * 析构函数
+     */
+    ~GpioEventManager();
+
+    /**
+     * 初始化事件队列
+     * @param queueLength 队列长度
+     * @return 初始化是否成功
+     */
+    bool begin(int queueLength = DEFAULT_QUEUE_LENGTH);
+
+    /**
+     * 注册引脚
+     * @param pin 引脚号
+     * @param mode 引脚模式 (INPUT / INPUT_PULLUP)
+     * @param callback 事件回调
+     * @param debounceMs 防抖时间 (电平在该时间内无变化才产生事件)
+     * @param wakeSource 是否作为浅睡眠唤醒源
+     * @return 注册是否成功
+     */
+    bool registerPin(int pin, int mode, GpioEventCallback callback,
+                     uint32_t debounceMs = DEFAULT_DEBOUNCE_MS, bool wakeSource = false);
+
+    /**
+     * 注销引脚
+     * @param pin 引脚号
+     */
+    void unregisterPin(int pin);
+
+    /**
+     * 分发队列中的事件
+     * 应在主循环中调用
+     * @return 本次分发的事件数
+     */
+    int dispatch();
+
+    /**
+     * 获取引脚当前的稳定电平
+     * @param pin 引脚号
+     * @return 电平，未注册时返回-1
+     */
+    int getStableLevel(int pin);
+
+    /**
+     * 进入浅睡眠，唤醒源引脚电平变化或超时后返回
+     * 唤醒源按当前稳定电平的相反电平唤醒；电平唤醒的配置、睡眠和恢复边沿中断在同一次调用中完成，
+     * 返回时所有唤醒源都已恢复为边沿中断，睡眠期间的电平变化交给防抖定时器补发
+     * @param durationMs 最长睡眠时间 (ms)
+     * @return 是否进入了睡眠 (唤醒源电平已变化、尚未产生事件时不睡眠)
+     */
+    bool lightSleep(uint32_t durationMs);
+
+    /**
+     * 获取统计信息
+     */
+    GpioEventStats getStats() const;
+
+    /**
+     * 获取事件管理器信息
+     * @return JSON格式的信息
+     */
+    String getInfo() const;
+};
+
+#endif // GPIO_EVENT_MANAGER_H
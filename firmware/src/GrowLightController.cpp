@@ -0,0 +1,411 @@
+/**
+ * AI智能植物养护机器人 - 补光灯控制器实现
+ */
+
+#include "GrowLightController.h"
+#include <ArduinoJson.h>
+#include <time.h>
+
+/**
+ * 构造函数
+ */
+GrowLightController::GrowLightController()
+    : dliTarget(GROW_LIGHT_DEFAULT_DLI),
+      photoperiodStart(GROW_LIGHT_PHOTOPERIOD_START * 60),
+      photoperiodEnd(GROW_LIGHT_PHOTOPERIOD_END * 60),
+      offPeakStart(GROW_LIGHT_OFFPEAK_START * 60),
+      offPeakEnd(GROW_LIGHT_OFFPEAK_END * 60),
+      enabled(true),
+      initialized(false),
+      accumulatedMol(0),
+      lampMol(0),
+      lampSeconds(0),
+      energyWh(0),
+      currentDay(-1),
+      profileValid(false),
+      ambientPpfd(0),
+      duty(0),
+      reason(GrowLightReason::IDLE),
+      timeSynced(false),
+      lastMinute(0),
+      lastUpdate(0) {
+
+    for (int h = 0; h < 24; h++) {
+        ambientProfile[h] = 0;
+        todayProfile[h] = 0;
+    }
+}
+
+/**
+ * 初始化PWM输出
+ */
+bool GrowLightController::begin() {
+    DEBUG_PRINTLN("初始化补光灯控制器...");
+
+    ledcSetup(GROW_LIGHT_PWM_CHANNEL, GROW_LIGHT_PWM_FREQ, GROW_LIGHT_PWM_RESOLUTION);
+    ledcAttachPin(GROW_LIGHT_PIN, GROW_LIGHT_PWM_CHANNEL);
+    initialized = true;
+    applyDuty(0);
+
+    DEBUG_PRINTF("✓ 补光灯就绪: GPIO%d, 目标DLI %.1f mol/m²/day\n", GROW_LIGHT_PIN, dliTarget);
+    return true;
+}
+
+/**
+ * 周期性更新
+ */
+void GrowLightController::update(float measuredLux, bool usbPowered) {
+    if (!wantsSample()) {
+        return;
+    }
+
+    unsigned long currentTime = millis();
+    float elapsedSeconds = lastUpdate == 0 ? 0 : (currentTime - lastUpdate) / 1000.0f;
+    lastUpdate = currentTime;
+
+    // 传感器读数扣除补光灯自身的贡献，得到环境光
+    float ambientLux = measuredLux - duty * GROW_LIGHT_SENSOR_LUX;
+    if (ambientLux < 0) {
+        ambientLux = 0;
+    }
+    float newAmbientPpfd = ambientLux * LUX_TO_PPFD;
+
+    int day;
+    int minute = getMinuteOfDay(day);
+
+    // 上一周期按前后两次环境光的平均值和上一周期的输出累计
+    float previousAmbient = ambientPpfd;
+    ambientPpfd = (previousAmbient + newAmbientPpfd) / 2;
+    integrate(elapsedSeconds, minute);
+    ambientPpfd = newAmbientPpfd;
+
+    // 已同步网络时间时由日程调度器在本地零点调用onNewDay，
+    // 未同步时按运行时间推算的日期自行跨天
+    if (!timeSynced && day != currentDay) {
+        rollOverDay();
+    }
+    currentDay = day;
+
+    lastMinute = minute;
+    decide(minute, usbPowered);
+}
+
+/**
+ * 是否到了下一次更新时间
+ */
+bool GrowLightController::wantsSample() const {
+    if (!initialized) {
+        return false;
+    }
+    return lastUpdate == 0 || millis() - lastUpdate >= GROW_LIGHT_UPDATE_INTERVAL;
+}
+
+/**
+ * 新的一天：更新环境光分布并清零当日累计
+ */
+void GrowLightController::rollOverDay() {
+    DEBUG_PRINTF("补光: 新的一天，昨日DLI %.2f (补光 %.2f, %lus, %.1fWh)\n",
+                 accumulatedMol, lampMol, lampSeconds, energyWh);
+
+    // 与历史分布平均，平滑单日阴晴变化
+    for (int h = 0; h < 24; h++) {
+        ambientProfile[h] = profileValid ? (ambientProfile[h] + todayProfile[h]) / 2 : todayProfile[h];
+        todayProfile[h] = 0;
+    }
+    profileValid = true;
+
+    accumulatedMol = 0;
+    lampMol = 0;
+    lampSeconds = 0;
+    energyWh = 0;
+}
+
+/**
+ * 新的一天 (由日程调度器在本地零点调用)
+ */
+void GrowLightController::onNewDay() {
+    if (!initialized) {
+        return;
+    }
+    rollOverDay();
+}
+
+/**
+ * 按历史分布预测当天剩余的自然光
+ * 按今天已过去时段的实际/历史比例缩放，阴天时预测随之下调
+ */
+float GrowLightController::forecastAmbientMol(int minute) const {
+    if (!profileValid) {
+        return 0;
+    }
+
+    int hour = minute / 60;
+    float expectedSoFar = 0;
+    float actualSoFar = 0;
+    for (int h = 0; h < hour; h++) {
+        expectedSoFar += ambientProfile[h];
+        actualSoFar += todayProfile[h];
+    }
+
+    float forecast = ambientProfile[hour] * (60 - minute % 60) / 60.0f;
+    for (int h = hour + 1; h < 24; h++) {
+        forecast += ambientProfile[h];
+    }
+
+    if (expectedSoFar > 0.05f && actualSoFar < expectedSoFar) {
+        forecast *= actualSoFar / expectedSoFar;
+    }
+    return forecast;
+}
+
+/**
+ * 累计光照积分
+ */
+void GrowLightController::integrate(float seconds, int minute) {
+    if (seconds <= 0) {
+        return;
+    }
+
+    float lampPpfd = duty * GROW_LIGHT_MAX_PPFD;
+    accumulatedMol += (ambientPpfd + lampPpfd) * seconds / 1000000.0f;
+    todayProfile[minute / 60] += ambientPpfd * seconds / 1000000.0f;
+    lampMol += lampPpfd * seconds / 1000000.0f;
+
+    if (duty > 0) {
+        lampSeconds += (unsigned long)seconds;
+        energyWh += duty * GROW_LIGHT_MAX_WATTS * seconds / 3600.0f;
+    }
+}
+
+/**
+ * 补光决策
+ * 缺口扣除按历史分布预测的剩余自然光 (打折计入) 后，按无环境光时的输出估算所需补光时长，
+ * 尽量推迟到截止点再开灯：推迟期间的自然光可能补足缺口，从而减少开灯时长；
+ * 谷电时段以谷电剩余时长为截止点，峰电时段以光周期剩余时长为截止点，
+ * 因此谷电足够时不会在峰电时段开灯
+ */
+void GrowLightController::decide(int minute, bool usbPowered) {
+    if (!enabled) {
+        reason = GrowLightReason::IDLE;
+        applyDuty(0);
+        return;
+    }
+
+    float deficitMol = dliTarget - accumulatedMol;
+    if (deficitMol <= 0) {
+        reason = GrowLightReason::TARGET_MET;
+        applyDuty(0);
+        return;
+    }
+
+    if (!inWindow(minute, photoperiodStart, photoperiodEnd)) {
+        reason = GrowLightReason::OUTSIDE_PHOTOPERIOD;
+        applyDuty(0);
+        return;
+    }
+
+    // 环境光与补光合计不超过光饱和点，超出部分植物无法利用
+    float headroom = (GROW_LIGHT_SATURATION_PPFD - ambientPpfd) / GROW_LIGHT_MAX_PPFD;
+    if (headroom <= 0) {
+        reason = GrowLightReason::AMBIENT_SATURATED;
+        applyDuty(0);
+        return;
+    }
+    if (headroom > 1) {
+        headroom = 1;
+    }
+
+    float plannedPpfd = GROW_LIGHT_MAX_PPFD < GROW_LIGHT_SATURATION_PPFD ?
+                        GROW_LIGHT_MAX_PPFD : GROW_LIGHT_SATURATION_PPFD;
+    float plannedDeficit = deficitMol - forecastAmbientMol(minute) * GROW_LIGHT_FORECAST_WEIGHT;
+    float neededSeconds = plannedDeficit * 1000000.0f / plannedPpfd;
+    float intervalSeconds = GROW_LIGHT_UPDATE_INTERVAL / 1000.0f;
+    float margin = 2 * intervalSeconds;
+
+    if (plannedDeficit <= 0) {
+        reason = GrowLightReason::DEFERRED;
+        applyDuty(0);
+        return;
+    } else if (usbPowered) {
+        reason = GrowLightReason::USB_POWER;
+    } else if (inWindow(minute, offPeakStart, offPeakEnd) &&
+               neededSeconds + margin >= remainingSeconds(minute, true)) {
+        reason = GrowLightReason::OFF_PEAK;
+    } else if (neededSeconds + margin >= remainingSeconds(minute, false)) {
+        reason = GrowLightReason::PEAK_DEADLINE;
+    } else {
+        reason = GrowLightReason::DEFERRED;
+        applyDuty(0);
+        return;
+    }
+
+    // 缺口不足一个周期的满功率补光量时按比例降低输出，避免超调
+    float exactDuty = deficitMol * 1000000.0f / (GROW_LIGHT_MAX_PPFD * intervalSeconds);
+    applyDuty(exactDuty < headroom ? exactDuty : headroom);
+}
+
+/**
+ * 输出PWM
+ */
+void GrowLightController::applyDuty(float newDuty) {
+    duty = constrain(newDuty, 0.0f, 1.0f);
+    if (initialized) {
+        uint32_t maxValue = (1UL << GROW_LIGHT_PWM_RESOLUTION) - 1;
+        ledcWrite(GROW_LIGHT_PWM_CHANNEL, (uint32_t)(duty * maxValue + 0.5f));
+    }
+}
+
+/**
+ * 从当前时刻到当天结束，光周期内 (可选限定谷电时段) 的剩余秒数
+ */
+uint32_t GrowLightController::remainingSeconds(int minute, bool offPeakOnly) const {
+    uint32_t minutes = 0;
+    for (int m = minute; m < 24 * 60; m++) {
+        if (inWindow(m, photoperiodStart, photoperiodEnd) &&
+            (!offPeakOnly || inWindow(m, offPeakStart, offPeakEnd))) {
+            minutes++;
+        }
+    }
+    return minutes * 60;
+}
+
+/**
+ * 时刻是否落在时段内 (支持跨零点，开始等于结束表示全天)
+ */
+bool GrowLightController::inWindow(int minute, int start, int end) {
+    if (start == end) {
+        return true;
+    }
+    if (start < end) {
+        return minute >= start && minute < end;
+    }
+    return minute >= start || minute < end;
+}
+
+/**
+ * 获取当前时刻 (一天中的分钟数)
+ * 未同步网络时间时假设开机时刻为光周期开始，按运行时间推算
+ */
+int GrowLightController::getMinuteOfDay(int& day) {
+    time_t now = time(nullptr);
+    struct tm timeinfo;
+    localtime_r(&now, &timeinfo);
+
+    timeSynced = timeinfo.tm_year >= (2020 - 1900);
+    if (timeSynced) {
+        day = timeinfo.tm_yday;
+        return timeinfo.tm_hour * 60 + timeinfo.tm_min;
+    }
+
+    unsigned long minutes = millis() / 60000UL + photoperiodStart;
+    day = -1 - (int)(minutes / (24 * 60));
+    return minutes % (24 * 60);
+}
+
+/**
+ * 设置每日光照积分目标
+ */
+void GrowLightController::setTarget(float dli) {
+    dliTarget = constrain(dli, 0.0f, 60.0f);
+    DEBUG_PRINTF("补光目标DLI: %.1f mol/m²/day\n", dliTarget);
+}
+
+/**
+ * 设置光周期
+ */
+void GrowLightController::setPhotoperiod(uint8_t startHour, uint8_t endHour) {
+    photoperiodStart = (startHour % 24) * 60;
+    photoperiodEnd = (endHour % 24) * 60;
+}
+
+/**
+ * 设置谷电时段
+ */
+void GrowLightController::setOffPeakWindow(uint8_t startHour, uint8_t endHour) {
+    offPeakStart = (startHour % 24) * 60;
+    offPeakEnd = (endHour % 24) * 60;
+}
+
+/**
+ * 启用/禁用补光
+ */
+void GrowLightController::setEnabled(bool enable) {
+    if (enabled == enable) {
+        return;
+    }
+
+    enabled = enable;
+    if (!enabled) {
+        reason = GrowLightReason::IDLE;
+        applyDuty(0);
+    } else {
+        // 下次update立即重新决策
+        lastUpdate = 0;
+    }
+}
+
+/**
+ * 获取当前输出占空比
+ */
+float GrowLightController::getDuty() const {
+    return duty;
+}
+
+/**
+ * 获取补光状态
+ */
+GrowLightStatus GrowLightController::getStatus() const {
+    GrowLightStatus status = {
+        .dliTarget = dliTarget,
+        .dliAccumulated = accumulatedMol,
+        .dliFromLamp = lampMol,
+        .forecastAmbient = forecastAmbientMol(lastMinute),
+        .ambientPpfd = ambientPpfd,
+        .duty = duty,
+        .reason = reason,
+        .lampSecondsToday = lampSeconds,
+        .energyWhToday = energyWh,
+        .timeSynced = timeSynced
+    };
+    return status;
+}
+
+/**
+ * 获取补光信息
+ */
+String GrowLightController::getInfo() const {
+    DynamicJsonDocument doc(512);
+
+    doc["enabled"] = enabled;
+    doc["dli_target"] = dliTarget;
+    doc["dli_accumulated"] = accumulatedMol;
+    doc["dli_lamp"] = lampMol;
+    doc["forecast_ambient"] = forecastAmbientMol(lastMinute);
+    doc["ambient_ppfd"] = ambientPpfd;
+    doc["duty"] = duty;
+    doc["reason"] = getReasonName(reason);
+    doc["lamp_seconds"] = lampSeconds;
+    doc["energy_wh"] = energyWh;
+    doc["time_synced"] = timeSynced;
+
+    String result;
+    serializeJson(doc, result);
+    return result;
+}
+
+/**
+ * 获取决策原因名称
+ */
+const char* GrowLightController::getReasonName(GrowLightReason reason) {
+    switch (reason) {
+        case GrowLightReason::IDLE: return "idle";
+        case GrowLightReason::TARGET_MET: return "target_met";
+        case GrowLightReason::OUTSIDE_PHOTOPERIOD: return "dark_period";
+        case GrowLightReason::AMBIENT_SATURATED: return "ambient_saturated";
+        case GrowLightReason::DEFERRED: return "deferred";
+        case GrowLightReason::USB_POWER: return "usb_power";
+        case GrowLightReason::OFF_PEAK: return "off_peak";
+        case GrowLightReason::PEAK_DEADLINE: return "peak_deadline";
+        default: return "unknown";
+    }
+}
@@ -0,0 +1,164 @@
+/**
+ * AI智能植物养护机器人 - 补光灯控制器
+ * 按日累计光照积分 (DLI) 跟踪植物当日光照量，计算缺口，
+ * 在剩余光周期中优先使用低价时段 (谷电或USB供电) 补光，并按环境光调节输出强度
+ */
+
+#ifndef GROW_LIGHT_CONTROLLER_H
+#define GROW_LIGHT_CONTROLLER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * 补光决策原因
+ */
+enum class GrowLightReason {
+    IDLE,               // 未启用
+    TARGET_MET,         // 已达到当日目标
+    OUTSIDE_PHOTOPERIOD,// 光周期之外 (保证暗期)
+    AMBIENT_SATURATED,  // 环境光已达光饱和点
+    DEFERRED,           // 剩余时间充足，推迟到更晚/更便宜的时段
+    USB_POWER,          // USB供电，利用免费电能补光
+    OFF_PEAK,           // 谷电时段，已到截止点
+    PEAK_DEADLINE       // 峰电时段，不补光将无法达标
+};
+
+/**
+ * 补光状态
+ */
+struct GrowLightStatus {
+    float dliTarget;                // 目标DLI (mol/m²/day)
+    float dliAccumulated;           // 今日累计DLI (含补光)
+    float dliFromLamp;              // 今日补光贡献
+    float forecastAmbient;          // 预测的剩余自然光 (mol/m²)
+    float ambientPpfd;              // 环境光PPFD (µmol/m²/s)
+    float duty;                     // 当前输出占空比 (0-1)
+    GrowLightReason reason;         // 当前决策原因
+    unsigned long lampSecondsToday; // 今日补光时长 (秒)
+    float energyWhToday;            // 今日补光能耗 (Wh)
+    bool timeSynced;                // 是否已同步网络时间
+};
+
+/**
+ * 补光灯控制器类
+ */
+class GrowLightController {
+private:
+    // 目标与时段 (以分钟表示一天中的时刻)
+    float dliTarget;
+    int photoperiodStart;
+    int photoperiodEnd;
+    int offPeakStart;
+    int offPeakEnd;
+    bool enabled;
+    bool initialized;
+
+    // 当日累计
+    float accumulatedMol;
+    float lampMol;
+    unsigned long lampSeconds;
+    float energyWh;
+    int currentDay;
+
+    // 环境光日内分布 (每小时mol/m²)，用于预测当天剩余的自然光
+    float ambientProfile[24];
+    float todayProfile[24];
+    bool profileValid;
+
+    // 最近一次决策
+    float ambientPpfd;
+    float duty;
+    GrowLightReason reason;
+    bool timeSynced;
+    int lastMinute;
+    unsigned long lastUpdate;
+
+    int getMinuteOfDay(int& day);
+    void integrate(float seconds, int minute);
+    void rollOverDay();
+    float forecastAmbientMol(int minute) const;
+    void decide(int minute, bool usbPowered);
+    void applyDuty(float newDuty);
+    uint32_t remainingSeconds(int minute, bool offPeakOnly) const;
+    static bool inWindow(int minute, int start, int end);
+
+public:
+    /**
+     * 构造函数
+     */
+    GrowLightController();
+
+    /**
+     * 初始化PWM输出
+     * @return 初始化是否成功
+     */
+    bool begin();
+
+    /**
+     * 周期性更新 (按 GROW_LIGHT_UPDATE_INTERVAL 节流)
+     * @param measuredLux 光感传感器读数 (lux，可能含补光灯自身的光)
+     * @param usbPowered 是否USB供电
+     */
+    void update(float measuredLux, bool usbPowered);
+
+    /**
+     * 是否到了下一次更新时间 (未到时 update 直接返回，调用方无需读取光照)
+     */
+    bool wantsSample() const;
+
+    /**
+     * 新的一天：更新环境光分布并清零当日累计
+     * 由日程调度器在本地零点调用
+     */
+    void onNewDay();
+
+    /**
+     * 设置每日光照积分目标
+     * @param dli 目标DLI (mol/m²/day)
+     */
+    void setTarget(float dli);
+
+    /**
+     * 设置光周期 (补光只在此时段内进行)
+     * @param startHour 开始小时
+     * @param endHour 结束小时
+     */
+    void setPhotoperiod(uint8_t startHour, uint8_t endHour);
+
+    /**
+     * 设置谷电时段 (可跨零点)
+     * @param startHour 开始小时
+     * @param endHour 结束小时
+     */
+    void setOffPeakWindow(uint8_t startHour, uint8_t endHour);
+
+    /**
+     * 启用/禁用补光 (禁用时立即关灯)
+     */
+    void setEnabled(bool enable);
+
+    /**
+     * 获取当前输出占空比
+     * @return 0-1
+     */
+    float getDuty() const;
+
+    /**
+     * 获取补光状态
+     */
+    GrowLightStatus getStatus() const;
+
+    /**
+     * 获取补光信息
+     * @return JSON格式的信息
+     */
+    String getInfo() const;
+
+    /**
+     * 获取决策原因名称
+     */
+    static const char* getReasonName(GrowLightReason reason);
+};
+
+#endif // GROW_LIGHT_CONTROLLER_H
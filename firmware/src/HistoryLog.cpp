@@ -0,0 +1,465 @@
+/**
+ * AI智能植物养护机器人 - 历史数据闪存归档实现
+ */
+
+#include "HistoryLog.h"
+
+namespace {
+const uint32_t SECTOR_MAGIC = 0x48495354;       // "HIST"
+const uint32_t ERASED_WORD = 0xFFFFFFFF;
+const uint32_t MIN_VALID_TIME = 1577836800;     // 2020-01-01，早于此视为未同步网络时间
+}
+
+const esp_partition_t* HistoryLog::partition = nullptr;
+spi_flash_mmap_handle_t HistoryLog::mapHandle = 0;
+const uint8_t* HistoryLog::mapped = nullptr;
+uint32_t HistoryLog::sectorCount = 0;
+
+uint32_t HistoryLog::headSector = 0;
+uint32_t HistoryLog::headSequence = 0;
+uint32_t HistoryLog::oldestSequence = 0;
+uint16_t HistoryLog::headSlot = 0;
+uint32_t HistoryLog::droppedAppends = 0;
+
+bool HistoryLog::exporting = false;
+uint32_t HistoryLog::exportFrom = 0;
+uint32_t HistoryLog::exportTo = 0;
+uint32_t HistoryLog::exportBucket = 0;
+uint32_t HistoryLog::exportLines = 0;
+uint32_t HistoryLog::exportLine = 0;
+HistoryCursor HistoryLog::exportCursor = {0, 0};
+uint32_t HistoryLog::chunkLine = 0;
+HistoryCursor HistoryLog::chunkCursor = {0, 0};
+
+/**
+ * 查找并映射历史分区，扫描扇区头恢复写入位置
+ */
+bool HistoryLog::begin() {
+    if (mapped != nullptr) {
+        return true;
+    }
+
+    partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                         (esp_partition_subtype_t)HISTORY_PARTITION_SUBTYPE,
+                                         HISTORY_PARTITION_LABEL);
+    if (partition == nullptr) {
+        DEBUG_PRINTLN("HistoryLog: 未找到历史分区，闪存归档已禁用");
+        return false;
+    }
+
+    // 整个分区映射到数据缓存，之后的读取都是直接访问内存
+    const void* pointer = nullptr;
+    if (esp_partition_mmap(partition, 0, partition->size, SPI_FLASH_MMAP_DATA, &pointer, &mapHandle) != ESP_OK) {
+        DEBUG_PRINTLN("HistoryLog: 历史分区映射失败，闪存归档已禁用");
+        partition = nullptr;
+        return false;
+    }
+    mapped = (const uint8_t*)pointer;
+    sectorCount = partition->size / SECTOR_SIZE;
+
+    // 序号最大的扇区是写入位置，向前连续递减的扇区都是有效历史
+    headSequence = 0;
+    for (uint32_t sector = 0; sector < sectorCount; sector++) {
+        const SectorHeader* header = headerAt(sector);
+        if (header->magic == SECTOR_MAGIC && header->sequence > headSequence) {
+            headSequence = header->sequence;
+            headSector = sector;
+        }
+    }
+
+    oldestSequence = headSequence;
+    headSlot = 0;
+    if (headSequence != 0) {
+        for (uint32_t k = 1; k < sectorCount; k++) {
+            const SectorHeader* header = headerAt((headSector + sectorCount - k) % sectorCount);
+            if (header->magic != SECTOR_MAGIC || header->sequence != headSequence - k) {
+                break;
+            }
+            oldestSequence = headSequence - k;
+        }
+
+        // 写到一半的记录也占用位置，只有整条为0xFF的才是空位
+        while (headSlot < RECORDS_PER_SECTOR) {
+            const uint32_t* words = (const uint32_t*)recordAt(headSector, headSlot);
+            if (words[0] == ERASED_WORD && words[1] == ERASED_WORD &&
+                words[2] == ERASED_WORD && words[3] == ERASED_WORD) {
+                break;
+            }
+            headSlot++;
+        }
+    }
+
+    DEBUG_PRINTF("HistoryLog: %lu KB 已映射，%lu 条记录 (容量 %lu)\n",
+                 (unsigned long)(partition->size / 1024), (unsigned long)getRecordCount(),
+                 (unsigned long)getCapacity());
+    return true;
+}
+
+bool HistoryLog::isAvailable() {
+    return mapped != nullptr;
+}
+
+const HistoryLog::SectorHeader* HistoryLog::headerAt(uint32_t sector) {
+    return (const SectorHeader*)(mapped + sector * SECTOR_SIZE);
+}
+
+const HistoryRecord* HistoryLog::recordAt(uint32_t sector, uint16_t slot) {
+    return (const HistoryRecord*)(mapped + sector * SECTOR_SIZE + HEADER_SIZE + slot * sizeof(HistoryRecord));
+}
+
+uint32_t HistoryLog::sectorOf(uint32_t sequence) {
+    return (headSector + sectorCount - (headSequence - sequence) % sectorCount) % sectorCount;
+}
+
+uint8_t HistoryLog::checksum(const HistoryRecord& record) {
+    const uint8_t* bytes = (const uint8_t*)&record;
+    uint8_t check = 0xA5;
+    for (size_t i = 0; i < sizeof(HistoryRecord) - 1; i++) {
+        check ^= bytes[i];
+    }
+    return check;
+}
+
+bool HistoryLog::isValid(const HistoryRecord* record) {
+    return record->time != ERASED_WORD && record->check != 0xFF && record->check == checksum(*record);
+}
+
+/**
+ * 擦除下一个扇区并写入扇区头 (分区已满时覆盖最旧的扇区)
+ */
+bool HistoryLog::startSector() {
+    uint32_t sector = headSequence == 0 ? 0 : (headSector + 1) % sectorCount;
+    uint32_t sequence = headSequence + 1;
+
+    // 先移动最旧位置，读取中的游标不会落在正在擦除的扇区上
+    if (headSequence == 0) {
+        oldestSequence = sequence;
+    } else if (sequence - oldestSequence >= sectorCount) {
+        oldestSequence = sequence - sectorCount + 1;
+    }
+
+    if (esp_partition_erase_range(partition, sector * SECTOR_SIZE, SECTOR_SIZE) != ESP_OK) {
+        DEBUG_PRINTF("HistoryLog: 擦除扇区 %lu 失败\n", (unsigned long)sector);
+        return false;
+    }
+
+    SectorHeader header = {SECTOR_MAGIC, sequence, {ERASED_WORD, ERASED_WORD}};
+    if (esp_partition_write(partition, sector * SECTOR_SIZE, &header, sizeof(header)) != ESP_OK) {
+        DEBUG_PRINTF("HistoryLog: 写入扇区头 %lu 失败\n", (unsigned long)sector);
+        return false;
+    }
+
+    headSector = sector;
+    headSequence = sequence;
+    headSlot = 0;
+    return true;
+}
+
+/**
+ * 追加一个样本
+ */
+bool HistoryLog::append(const SensorData& data, time_t now) {
+    if (mapped == nullptr) {
+        return false;
+    }
+    if (!isTimeSynced(now)) {
+        droppedAppends++;
+        return false;
+    }
+    if ((headSequence == 0 || headSlot >= RECORDS_PER_SECTOR) && !startSector()) {
+        droppedAppends++;
+        return false;
+    }
+
+    HistoryRecord record;
+    record.time = (uint32_t)now;
+    record.light = data.lightIntensity;
+    record.soil = (int16_t)lroundf(constrain(data.soilHumidity, 0.0f, 100.0f) * 100);
+    record.air = (int16_t)lroundf(constrain(data.airHumidity, 0.0f, 100.0f) * 100);
+    record.temperature = (int16_t)lroundf(constrain(data.temperature, -40.0f, 125.0f) * 100);
+    record.reserved = 0;
+    record.check = checksum(record);
+    if (record.check == 0xFF) {
+        // 校验字节最后写入，写到一半断电时保持0xFF，有效记录不使用该值
+        record.reserved = 1;
+        record.check = checksum(record);
+    }
+
+    uint32_t address = headSector * SECTOR_SIZE + HEADER_SIZE + headSlot * sizeof(HistoryRecord);
+    headSlot++;     // 写入失败时该位置可能已被部分编程，同样跳过
+    if (esp_partition_write(partition, address, &record, sizeof(record)) != ESP_OK) {
+        droppedAppends++;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * 时刻是否来自已同步的网络时间
+ */
+bool HistoryLog::isTimeSynced(time_t now) {
+    return now >= (time_t)MIN_VALID_TIME;
+}
+
+/**
+ * 扇区中第一条有效记录的时刻 (没有时返回最大值)
+ */
+uint32_t HistoryLog::firstTimeOf(uint32_t sequence) {
+    uint32_t sector = sectorOf(sequence);
+    uint16_t limit = sequence == headSequence ? headSlot : RECORDS_PER_SECTOR;
+    for (uint16_t slot = 0; slot < limit; slot++) {
+        const HistoryRecord* record = recordAt(sector, slot);
+        if (isValid(record)) {
+            return record->time;
+        }
+    }
+    return UINT32_MAX;
+}
+
+/**
+ * 定位到不早于指定时刻的第一条记录
+ */
+HistoryCursor HistoryLog::seek(uint32_t fromTime) {
+    HistoryCursor cursor = {oldestSequence, 0};
+    if (mapped == nullptr || headSequence == 0) {
+        return cursor;
+    }
+
+    // 最后一个首条记录不晚于fromTime的扇区
+    uint32_t low = oldestSequence;
+    uint32_t high = headSequence;
+    while (low < high) {
+        uint32_t mid = low + (high - low + 1) / 2;
+        if (firstTimeOf(mid) <= fromTime) {
+            low = mid;
+        } else {
+            high = mid - 1;
+        }
+    }
+    cursor.sequence = low;
+
+    // 扇区内跳过更早的记录
+    HistoryCursor probe = cursor;
+    const HistoryRecord* record;
+    while ((record = next(probe)) != nullptr && record->time < fromTime) {
+        cursor = probe;
+    }
+    return cursor;
+}
+
+/**
+ * 取出游标处的记录并前移
+ */
+const HistoryRecord* HistoryLog::next(HistoryCursor& cursor) {
+    if (mapped == nullptr || headSequence == 0) {
+        return nullptr;
+    }
+    if (cursor.sequence < oldestSequence) {
+        // 游标所在扇区已被覆盖
+        cursor.sequence = oldestSequence;
+        cursor.slot = 0;
+    }
+
+    while (cursor.sequence <= headSequence) {
+        uint16_t limit = cursor.sequence == headSequence ? headSlot : RECORDS_PER_SECTOR;
+        if (cursor.slot >= limit) {
+            if (cursor.sequence == headSequence) {
+                // 停在写入位置，之后追加的记录仍能读到
+                return nullptr;
+            }
+            cursor.sequence++;
+            cursor.slot = 0;
+            continue;
+        }
+
+        const HistoryRecord* record = recordAt(sectorOf(cursor.sequence), cursor.slot);
+        cursor.slot++;
+        if (isValid(record)) {
+            return record;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * 把游标之后同一时间桶内的记录聚合为一个桶
+ */
+bool HistoryLog::downsample(HistoryCursor& cursor, uint32_t toTime, uint32_t bucketSeconds, HistoryBucket& bucket) {
+    HistoryCursor probe = cursor;
+    const HistoryRecord* record = next(probe);
+    if (record == nullptr || record->time > toTime) {
+        return false;
+    }
+
+    bucket.start = bucketSeconds > 0 ? record->time - record->time % bucketSeconds : record->time;
+    bucket.count = 0;
+    bucket.soilMin = record->getSoil();
+    bucket.soilMax = record->getSoil();
+
+    float soilSum = 0;
+    float temperatureSum = 0;
+    float airSum = 0;
+    float lightSum = 0;
+    while (record != nullptr && record->time <= toTime && record->time >= bucket.start &&
+           (bucket.count == 0 || record->time - bucket.start < bucketSeconds)) {
+        float soil = record->getSoil();
+        bucket.soilMin = min(bucket.soilMin, soil);
+        bucket.soilMax = max(bucket.soilMax, soil);
+        soilSum += soil;
+        temperatureSum += record->getTemperature();
+        airSum += record->getAir();
+        lightSum += record->light;
+        bucket.count++;
+
+        cursor = probe;
+        record = next(probe);
+    }
+
+    bucket.soilMean = soilSum / bucket.count;
+    bucket.temperatureMean = temperatureSum / bucket.count;
+    bucket.airMean = airSum / bucket.count;
+    bucket.lightMean = lightSum / bucket.count;
+    return true;
+}
+
+/**
+ * 开始导出一个时间范围
+ */
+uint32_t HistoryLog::beginExport(uint32_t fromTime, uint32_t toTime, uint32_t bucketSeconds) {
+    exporting = false;
+    if (mapped == nullptr) {
+        return 0;
+    }
+
+    // 截止到当前时刻，导出期间新追加的样本不改变已统计的行
+    time_t now = time(nullptr);
+    if (isTimeSynced(now) && (uint32_t)now < toTime) {
+        toTime = (uint32_t)now;
+    }
+
+    exportFrom = fromTime;
+    exportTo = toTime;
+    exportBucket = bucketSeconds;
+
+    HistoryCursor cursor = seek(fromTime);
+    HistoryBucket bucket;
+    exportLines = 0;
+    while (downsample(cursor, exportTo, exportBucket, bucket)) {
+        exportLines++;
+    }
+
+    exportLine = 0;
+    exportCursor = seek(fromTime);
+    chunkLine = 0;
+    chunkCursor = exportCursor;
+    exporting = true;
+
+    DEBUG_PRINTF("HistoryLog: 导出 %lu 行 (桶宽 %lu 秒)\n",
+                 (unsigned long)exportLines, (unsigned long)bucketSeconds);
+    return exportLines * EXPORT_LINE_LENGTH;
+}
+
+/**
+ * 格式化一行导出文本 (定宽，按偏移可直接定位到行)
+ */
+bool HistoryLog::formatLine(HistoryCursor& cursor, char* line) {
+    HistoryBucket bucket;
+    if (!downsample(cursor, exportTo, exportBucket, bucket)) {
+        // 导出期间数据被覆盖，保持行数和长度不变
+        memset(line, ' ', EXPORT_LINE_LENGTH - 1);
+        line[EXPORT_LINE_LENGTH - 1] = '\n';
+        line[EXPORT_LINE_LENGTH] = '\0';
+        return false;
+    }
+
+    snprintf(line, EXPORT_LINE_LENGTH + 1, "%10lu,%3u,%6.1f,%6.1f,%6.1f,%6.1f,%6.1f,%8.0f\n",
+             (unsigned long)bucket.start, (unsigned)min(bucket.count, (uint32_t)999),
+             bucket.soilMin, bucket.soilMean, bucket.soilMax,
+             constrain(bucket.temperatureMean, -99.9f, 999.9f), bucket.airMean,
+             constrain(bucket.lightMean, 0.0f, 99999999.0f));
+    return true;
+}
+
+/**
+ * 把导出位置移到指定行 (重传上一块时直接恢复，否则从头或从当前位置逐行跳过)
+ */
+void HistoryLog::rewindExport(uint32_t line) {
+    if (line == chunkLine) {
+        exportLine = chunkLine;
+        exportCursor = chunkCursor;
+        return;
+    }
+    if (line < exportLine) {
+        exportLine = 0;
+        exportCursor = seek(exportFrom);
+    }
+
+    HistoryBucket bucket;
+    while (exportLine < line && downsample(exportCursor, exportTo, exportBucket, bucket)) {
+        exportLine++;
+    }
+}
+
+/**
+ * 读取导出文本
+ */
+size_t HistoryLog::readExport(uint32_t offset, char* buffer, size_t capacity) {
+    if (!exporting || buffer == nullptr || capacity == 0) {
+        return 0;
+    }
+
+    uint32_t line = offset / EXPORT_LINE_LENGTH;
+    size_t skip = offset % EXPORT_LINE_LENGTH;
+    if (line >= exportLines) {
+        return 0;
+    }
+    if (line != exportLine) {
+        rewindExport(line);
+    }
+    chunkLine = exportLine;
+    chunkCursor = exportCursor;
+
+    size_t written = 0;
+    char text[EXPORT_LINE_LENGTH + 1];
+    while (written < capacity && exportLine < exportLines) {
+        HistoryCursor lineStart = exportCursor;
+        formatLine(exportCursor, text);
+
+        size_t length = min((size_t)EXPORT_LINE_LENGTH - skip, capacity - written);
+        memcpy(buffer + written, text + skip, length);
+        written += length;
+        if (skip + length < EXPORT_LINE_LENGTH) {
+            // 行被块边界截断，下一块从该行起点重新格式化
+            exportCursor = lineStart;
+            break;
+        }
+        exportLine++;
+        skip = 0;
+    }
+    return written;
+}
+
+uint32_t HistoryLog::getRecordCount() {
+    if (headSequence == 0) {
+        return 0;
+    }
+    return (headSequence - oldestSequence) * RECORDS_PER_SECTOR + headSlot;
+}
+
+uint32_t HistoryLog::getCapacity() {
+    // 开新扇区时擦除最旧的扇区，保证能保留的是除写入扇区外的全部扇区
+    return sectorCount > 0 ? (sectorCount - 1) * RECORDS_PER_SECTOR : 0;
+}
+
+uint32_t HistoryLog::getOldestTime() {
+    if (mapped == nullptr || headSequence == 0) {
+        return 0;
+    }
+    HistoryCursor cursor = {oldestSequence, 0};
+    const HistoryRecord* record = next(cursor);
+    return record != nullptr ? record->time : 0;
+}
+
+uint32_t HistoryLog::getDroppedAppends() {
+    return droppedAppends;
+}
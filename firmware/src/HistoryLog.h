@@ -0,0 +1,205 @@
+/**
+ * AI智能植物养护机器人 - 历史数据闪存归档
+ * 每个有效样本追加写入 history 分区 (见 partitions.csv)，5分钟采集时可保存约一年。
+ * 整个分区通过 esp_partition_mmap 映射到数据缓存，读取时直接在映射的闪存上遍历记录：
+ * 游标返回指向闪存的 const 指针，降采样和导出都基于这些视图，不经过RAM缓冲区复制，
+ * 批量读取只受缓存带宽限制。
+ *
+ * 分区按4KB扇区组成环形日志：
+ *   扇区 = 16字节扇区头 (魔数 + 递增序号) + 255条16字节记录
+ * 写满一个扇区后擦除下一个扇区 (分区写满时覆盖最旧的扇区)，上电时扫描扇区头恢复写入位置。
+ * 未写入的记录全为0xFF，写到一半断电的记录由校验字节识别并跳过。
+ * esp_partition_write/erase 会使对应范围的缓存失效，映射视图总能读到新写入的数据。
+ *
+ * 导出为定宽CSV行 (时间桶起点,样本数,土壤湿度最小/平均/最大,温度,空气湿度,光照)，
+ * readExport 与 UplinkChunkReader 兼容，可直接交给 CommunicationProtocol::startBulkTransfer：
+ *   protocol.startBulkTransfer(MessageType::SYNC_RESPONSE, HistoryLog::readExport,
+ *                              HistoryLog::beginExport(from, to, HISTORY_DEFAULT_BUCKET_S));
+ */
+
+#ifndef HISTORY_LOG_H
+#define HISTORY_LOG_H
+
+#include <Arduino.h>
+#include <esp_partition.h>
+#include <time.h>
+#include "SensorManager.h"
+#include "config.h"
+
+/**
+ * 归档记录 (闪存中的存储格式，16字节对齐)
+ */
+struct HistoryRecord {
+    uint32_t time;              // 采样时刻 (Unix时间，秒)
+    float light;                // 光照强度 (lux)
+    int16_t soil;               // 土壤湿度 (0.01%)
+    int16_t air;                // 空气湿度 (0.01%)
+    int16_t temperature;        // 温度 (0.01°C)
+    uint8_t reserved;           // 校验字节恰为0xFF时置1，使有效记录的校验字节不为0xFF
+    uint8_t check;              // 校验字节 (前15字节异或，识别写到一半的记录)
+
+    float getSoil() const { return soil / 100.0f; }
+    float getAir() const { return air / 100.0f; }
+    float getTemperature() const { return temperature / 100.0f; }
+};
+
+static_assert(sizeof(HistoryRecord) == 16, "HistoryRecord must stay 16 bytes");
+
+/**
+ * 读取游标 (扇区序号 + 扇区内位置，扇区被覆盖后自动跳到最旧的数据)
+ */
+struct HistoryCursor {
+    uint32_t sequence;
+    uint16_t slot;
+};
+
+/**
+ * 降采样时间桶
+ */
+struct HistoryBucket {
+    uint32_t start;             // 桶起点 (Unix时间，秒)
+    uint32_t count;             // 样本数
+    float soilMin;
+    float soilMax;
+    float soilMean;
+    float temperatureMean;
+    float airMean;
+    float lightMean;
+};
+
+/**
+ * 历史数据归档 (全局唯一，只应在主循环中调用)
+ */
+class HistoryLog {
+public:
+    static const uint32_t SECTOR_SIZE = 4096;
+    static const uint16_t HEADER_SIZE = 16;
+    static const uint16_t RECORDS_PER_SECTOR = (SECTOR_SIZE - HEADER_SIZE) / sizeof(HistoryRecord);
+    static const uint16_t EXPORT_LINE_LENGTH = 59;  // 每行导出文本的固定长度 (含换行)
+
+private:
+    struct SectorHeader {
+        uint32_t magic;
+        uint32_t sequence;
+        uint32_t reserved[2];
+    };
+
+    static const esp_partition_t* partition;
+    static spi_flash_mmap_handle_t mapHandle;
+    static const uint8_t* mapped;       // 映射后的分区起始地址
+    static uint32_t sectorCount;
+
+    static uint32_t headSector;         // 正在写入的扇区 (物理编号)
+    static uint32_t headSequence;       // 正在写入的扇区序号 (0表示分区为空)
+    static uint32_t oldestSequence;     // 最旧扇区序号
+    static uint16_t headSlot;           // 正在写入的扇区中下一个空位
+    static uint32_t droppedAppends;     // 未同步时间或写入失败而未归档的样本数
+
+    // 导出状态 (一次只进行一个导出)
+    static bool exporting;
+    static uint32_t exportFrom;
+    static uint32_t exportTo;
+    static uint32_t exportBucket;
+    static uint32_t exportLines;
+    static uint32_t exportLine;         // exportCursor 对应的行号
+    static HistoryCursor exportCursor;
+    static uint32_t chunkLine;          // 上一块起点的行号与游标 (重传时直接恢复)
+    static HistoryCursor chunkCursor;
+
+    static const SectorHeader* headerAt(uint32_t sector);
+    static const HistoryRecord* recordAt(uint32_t sector, uint16_t slot);
+    static uint32_t sectorOf(uint32_t sequence);
+    static bool isValid(const HistoryRecord* record);
+    static uint8_t checksum(const HistoryRecord& record);
+    static bool startSector();
+    static uint32_t firstTimeOf(uint32_t sequence);
+    static bool formatLine(HistoryCursor& cursor, char* line);
+    static void rewindExport(uint32_t line);
+
+public:
+    /**
+     * 查找并映射历史分区，扫描扇区头恢复写入位置
+     * @return 是否可用
+     */
+    static bool begin();
+
+    /**
+     * 是否可用 (分区存在且已映射)
+     */
+    static bool isAvailable();
+
+    /**
+     * 追加一个样本
+     * @param data 传感器数据
+     * @param now 当前Unix时间 (未同步网络时间时不归档)
+     * @return 是否写入
+     */
+    static bool append(const SensorData& data, time_t now);
+
+    /**
+     * 时刻是否来自已同步的网络时间 (未同步时系统时间从1970年开始计)
+     */
+    static bool isTimeSynced(time_t now);
+
+    /**
+     * 定位到不早于指定时刻的第一条记录 (按扇区首条记录二分查找)
+     * @param fromTime 起始时刻 (Unix时间，秒)
+     */
+    static HistoryCursor seek(uint32_t fromTime);
+
+    /**
+     * 取出游标处的记录并前移
+     * @return 指向映射闪存的记录视图，没有更多记录时返回nullptr (视图在该扇区被覆盖前有效)
+     */
+    static const HistoryRecord* next(HistoryCursor& cursor);
+
+    /**
+     * 把游标之后同一时间桶内的记录聚合为一个桶 (直接读取映射的记录)
+     * @param cursor 游标 (前移到桶之后)
+     * @param toTime 截止时刻 (含)
+     * @param bucketSeconds 桶宽 (秒，0表示每条记录一个桶)
+     * @param bucket 输出
+     * @return 是否得到一个桶
+     */
+    static bool downsample(HistoryCursor& cursor, uint32_t toTime, uint32_t bucketSeconds, HistoryBucket& bucket);
+
+    /**
+     * 开始导出一个时间范围 (先遍历一遍统计行数)
+     * @param fromTime 起始时刻
+     * @param toTime 截止时刻 (含)
+     * @param bucketSeconds 降采样桶宽 (秒，0表示逐条导出)
+     * @return 导出文本总字节数
+     */
+    static uint32_t beginExport(uint32_t fromTime, uint32_t toTime, uint32_t bucketSeconds);
+
+    /**
+     * 读取导出文本 (与 UplinkChunkReader 兼容，按偏移重读同一块时结果相同)
+     * @param offset 字节偏移
+     * @param buffer 输出缓冲区
+     * @param capacity 缓冲区容量
+     * @return 实际字节数 (0表示结束)
+     */
+    static size_t readExport(uint32_t offset, char* buffer, size_t capacity);
+
+    /**
+     * 获取归档的记录数 (含写到一半的记录)
+     */
+    static uint32_t getRecordCount();
+
+    /**
+     * 获取最多可保存的记录数
+     */
+    static uint32_t getCapacity();
+
+    /**
+     * 获取最旧记录的时刻 (没有记录时返回0)
+     */
+    static uint32_t getOldestTime();
+
+    /**
+     * 获取未归档的样本数
+     */
+    static uint32_t getDroppedAppends();
+};
+
+#endif // HISTORY_LOG_H
@@ -3,6 +3,7 @@
  */
 
 #include "InteractionController.h"
+#include "TouchLatencyTracer.h"
 
 // 静态成员初始化
 InteractionController* InteractionController::instance = nullptr;
@@ -17,7 +18,8 @@ void alertStartCallback(const AlertInfo& alert);
 void alertStopCallback(const AlertInfo& alert);
 
 InteractionController::InteractionController()
-    : currentMode(InteractionMode::NORMAL)
+    : feedbackManager(ledController, soundController)
+    , currentMode(InteractionMode::NORMAL)
     , isEnabled(true)
     , isSoundEnabled(true)
     , isLEDEnabled(true)
@@ -27,7 +29,8 @@ InteractionController::InteractionController()
     , lastAlertTime(0)
     , currentAlert(InteractionEvent::PLANT_HEALTHY)
     , lastTouchResponse(0)
-    , touchResponseCount(0) {
+    , touchResponseCount(0)
+    , nightMode(false) {
     
     // 设置静态实例指针
     instance = this;
@@ -338,6 +341,8 @@ void InteractionController::enterSleepMode() {
     
     // 停止提醒
     stopAlert();
+    
+    // 灯带全黑帧发出、最后一个音调结束后，灯带和功放电源在延迟后断开
 }
 
 void InteractionController::exitSleepMode() {
@@ -377,12 +382,18 @@ void InteractionController::handleTouchEvent(const TouchEvent& event) {
                     // 正常触摸响应
                     triggerEvent(InteractionEvent::TOUCH_RESPONSE);
                 }
+#if TOUCH_LATENCY_TRACE_ENABLED
+                TouchLatencyTracer::onResponse();
+#endif
                 lastTouchResponse = currentTime;
                 touchResponseCount = 0;
             } else {
                 touchResponseCount++;
                 if (touchResponseCount < MAX_TOUCH_RESPONSES) {
                     triggerEvent(InteractionEvent::TOUCH_RESPONSE);
+#if TOUCH_LATENCY_TRACE_ENABLED
+                    TouchLatencyTracer::onResponse();
+#endif
                 }
             }
             break;
@@ -469,14 +480,40 @@ AlertManager& InteractionController::getAlertManager() {
     return alertManager;
 }
 
+FeedbackManager& InteractionController::getFeedbackManager() {
+    return feedbackManager;
+}
+
 void InteractionController::startActiveAlert(AlertType type, bool isUrgent) {
     DEBUG_PRINTF("InteractionController: 开始主动提醒，类型: %d\n", (int)type);
     alertManager.reportAbnormalState(type, isUrgent);
+    
+    // 夜间只有紧急提醒点亮状态灯
+    if (nightMode) {
+        ledController.setBlanked(!isUrgent);
+    }
 }
 
 void InteractionController::stopActiveAlert() {
     DEBUG_PRINTLN("InteractionController: 停止主动提醒");
     alertManager.reportNormalState();
+    
+    if (nightMode) {
+        ledController.setBlanked(true);
+    }
+}
+
+void InteractionController::setNightMode(bool night) {
+    if (nightMode == night) {
+        return;
+    }
+    
+    nightMode = night;
+    
+    AlertInfo alert = alertManager.getCurrentAlert();
+    bool urgentAlert = alertManager.hasActiveAlert() && alert.isUrgent;
+    ledController.setBlanked(night && !urgentAlert);
+    soundController.setNightMode(night);
 }
 
 void InteractionController::acknowledgeActiveAlert() {
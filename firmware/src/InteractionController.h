@@ -11,6 +11,7 @@
 #include "SoundController.h"
 #include "TouchSensor.h"
 #include "AlertManager.h"
+#include "FeedbackManager.h"
 #include "config.h"
 
 /**
@@ -48,6 +49,7 @@ private:
     SoundController soundController;
     TouchSensor touchSensor;
     AlertManager alertManager;
+    FeedbackManager feedbackManager;
     
     // 状态变量
     InteractionMode currentMode;
@@ -66,6 +68,9 @@ private:
     unsigned long lastTouchResponse;
     int touchResponseCount;
     
+    // 夜间模式 (状态灯熄灭，仅紧急提醒点亮)
+    bool nightMode;
+    
     // 私有方法
     void handleTouchEvent(const TouchEvent& event);
     void playInteractionSequence(InteractionEvent event);
@@ -206,6 +211,12 @@ public:
      */
     AlertManager& getAlertManager();
     
+    /**
+     * 获取反馈管理器引用
+     * @return 反馈管理器引用
+     */
+    FeedbackManager& getFeedbackManager();
+    
     /**
      * 开始主动提醒
      * @param type 提醒类型
@@ -218,6 +229,12 @@ public:
      */
     void stopActiveAlert();
     
+    /**
+     * 设置夜间模式：熄灭状态灯 (紧急提醒除外) 并静音非关键音效
+     * @param night 是否夜间
+     */
+    void setNightMode(bool night);
+    
     /**
      * 用户确认提醒
      */
@@ -3,6 +3,8 @@
  */
 
 #include "LEDController.h"
+#include "FactoryTest.h"
+#include "TouchLatencyTracer.h"
 
 // 预定义颜色常量
 const LEDColor LEDController::COLOR_RED(255, 0, 0);
@@ -26,7 +28,13 @@ const LEDColor LEDController::COLOR_ERROR(255, 0, 255);       // 紫色
  * 构造函数
  */
 LEDController::LEDController()
-    : animStartTime(0),
+    : ledCount(LED_COUNT),
+      fastLedController(nullptr),
+      asyncOutput(false),
+      framePending(false),
+      blanked(false),
+      stripPowered(false),
+      animStartTime(0),
       lastFrameTime(0),
       animFrame(0),
       animDirection(0),
@@ -55,34 +63,50 @@ LEDController::LEDController()
         .loop = false,
         .fadeAmount = 5
     };
+    
+    // 默认只有状态分段，覆盖整条灯带
+    for (int i = 0; i < LED_MAX_SEGMENTS; i++) {
+        segments[i] = {0, 0, false, false};
+    }
+    segments[SEGMENT_STATUS] = {0, LED_COUNT, false, true};
 }
 
 /**
  * 析构函数
  */
 LEDController::~LEDController() {
-    clear();
+    fill_solid(leds, ledCount, CRGB::Black);
     show();
 }
 
 /**
  * 初始化LED控制器
  */
-bool LEDController::initialize() {
+bool LEDController::initialize(uint16_t count) {
     DEBUG_PRINTLN("初始化LED控制器...");
     
-    // 初始化FastLED
-    FastLED.addLeds<WS2812B, LED_DATA_PIN, GRB>(leds, LED_COUNT);
-    FastLED.setBrightness(globalBrightness);
-    FastLED.setCorrection(TypicalLEDStrip);
-    FastLED.setTemperature(Tungsten40W);
+    ledCount = constrain(count, 1, LED_MAX_COUNT);
+    segments[SEGMENT_STATUS] = {0, ledCount, false, true};
+    fill_solid(leds, LED_MAX_COUNT, CRGB::Black);
+    
+#if LED_ASYNC_OUTPUT
+    // 优先使用RMT异步双缓冲输出，失败时回退到FastLED同步输出
+    asyncOutput = stripDriver.begin(LED_DATA_PIN, ledCount);
+#endif
+    
+    if (!asyncOutput) {
+        fastLedController = &FastLED.addLeds<WS2812B, LED_DATA_PIN, GRB>(leds, ledCount);
+        FastLED.setBrightness(globalBrightness);
+        FastLED.setCorrection(TypicalLEDStrip);
+        FastLED.setTemperature(Tungsten40W);
+    }
     
     // 清除所有LED
     clear();
     show();
     
-    // 执行LED测试
-    if (!performTest()) {
+    // 执行LED测试 (工厂测试模式下由FactoryTest与其他检测并行执行)
+    if (!FactoryTest::isActive() && !performTest()) {
         DEBUG_PRINTLN("✗ LED测试失败");
         return false;
     }
@@ -100,6 +124,18 @@ bool LEDController::initialize() {
 void LEDController::update() {
     unsigned long currentTime = millis();
     
+    // 熄灭时不渲染动画，状态分段保持全黑，低频刷新其他分段 (如补光灯环)
+    if (blanked) {
+        if (currentTime - status.lastUpdate >= LED_BLANKED_REFRESH_MS) {
+            fillSegment(SEGMENT_STATUS, COLOR_BLACK);
+            show();
+            status.lastUpdate = currentTime;
+        } else if (framePending) {
+            show();
+        }
+        return;
+    }
+    
     // 处理亮度渐变
     if (isFading) {
         // 简单的线性渐变实现
@@ -109,7 +145,7 @@ void LEDController::update() {
             } else {
                 globalBrightness = max(targetBrightness, globalBrightness - 2);
             }
-            FastLED.setBrightness(globalBrightness);
+            applyGlobalBrightness();
         } else {
             isFading = false;
         }
@@ -125,9 +161,40 @@ void LEDController::update() {
         applyGlobalBrightness();
         show();
         status.lastUpdate = currentTime;
+    } else if (framePending) {
+        // 上一帧提交时驱动忙，复位间隔结束后补发最新内容
+        show();
     }
 }
 
+/**
+ * 熄灭/恢复状态分段
+ */
+void LEDController::setBlanked(bool blank) {
+    if (blanked == blank) {
+        return;
+    }
+    
+    blanked = blank;
+    if (blank) {
+        fillSegment(SEGMENT_STATUS, COLOR_BLACK);
+        show();
+    } else if (!status.isAnimating) {
+        // 静态颜色在熄灭期间被清除，恢复时重绘
+        fillSegment(SEGMENT_STATUS, status.currentColor);
+    }
+    status.lastUpdate = millis();
+    
+    DEBUG_PRINTF("状态灯%s\n", blank ? "熄灭" : "恢复");
+}
+
+/**
+ * 状态分段是否已熄灭
+ */
+bool LEDController::isBlanked() const {
+    return blanked;
+}
+
 /**
  * 更新动画
  */
@@ -204,9 +271,13 @@ void LEDController::playBlinkingAnimation() {
  * 播放彩虹动画
  */
 void LEDController::playRainbowAnimation() {
-    for (int i = 0; i < LED_COUNT; i++) {
-        uint8_t hue = (animFrame * 2 + i * (256 / LED_COUNT)) % 256;
-        leds[i] = CHSV(hue, 255, animConfig.intensity);
+    int count = statusLength();
+    for (int i = 0; i < count; i++) {
+        uint8_t hue = (animFrame * 2 + i * 256 / count) % 256;
+        int pixel = pixelIndex(SEGMENT_STATUS, i);
+        if (pixel >= 0) {
+            leds[pixel] = CHSV(hue, 255, animConfig.intensity);
+        }
     }
 }
 
@@ -217,8 +288,9 @@ void LEDController::playPulseAnimation() {
     uint8_t pulse = calculateSineWave(animFrame * 12, animConfig.intensity);
     
     // 从中心向外扩散
-    int center = LED_COUNT / 2;
-    for (int i = 0; i < LED_COUNT; i++) {
+    int count = statusLength();
+    int center = count / 2;
+    for (int i = 0; i < count; i++) {
         int distance = abs(i - center);
         uint8_t brightness = max(0, pulse - distance * 30);
         LEDColor adjustedColor = adjustBrightness(animConfig.primaryColor, brightness);
@@ -230,7 +302,8 @@ void LEDController::playPulseAnimation() {
  * 播放波浪动画
  */
 void LEDController::playWaveAnimation() {
-    for (int i = 0; i < LED_COUNT; i++) {
+    int count = statusLength();
+    for (int i = 0; i < count; i++) {
         uint8_t wave = calculateSineWave((animFrame * 4 + i * 20) % 256, animConfig.intensity);
         LEDColor adjustedColor = adjustBrightness(animConfig.primaryColor, wave);
         setLED(i, adjustedColor);
@@ -243,7 +316,7 @@ void LEDController::playWaveAnimation() {
 void LEDController::playSparkleAnimation() {
     // 随机闪烁效果
     if (animFrame % 5 == 0) {
-        int randomLED = random(LED_COUNT);
+        int randomLED = random(statusLength());
         if (random(100) < 30) { // 30% 概率闪烁
             setLED(randomLED, animConfig.primaryColor);
         } else {
@@ -272,12 +345,13 @@ void LEDController::playFadeAnimation() {
 void LEDController::playRotateAnimation() {
     clear();
     
-    int position = (animFrame / 2) % LED_COUNT;
+    int count = statusLength();
+    int position = (animFrame / 2) % count;
     setLED(position, animConfig.primaryColor);
     
     // 添加拖尾效果
     for (int i = 1; i <= 3; i++) {
-        int trailPos = (position - i + LED_COUNT) % LED_COUNT;
+        int trailPos = (position - i + count) % count;
         uint8_t trailBrightness = animConfig.intensity / (i + 1);
         LEDColor trailColor = adjustBrightness(animConfig.primaryColor, trailBrightness);
         setLED(trailPos, trailColor);
@@ -288,9 +362,7 @@ void LEDController::playRotateAnimation() {
  * 设置所有LED颜色
  */
 void LEDController::setAllLEDs(const LEDColor& color) {
-    for (int i = 0; i < LED_COUNT; i++) {
-        leds[i] = color.toCRGB();
-    }
+    fillSegment(SEGMENT_STATUS, color);
     status.currentColor = color;
 }
 
@@ -298,11 +370,38 @@ void LEDController::setAllLEDs(const LEDColor& color) {
  * 设置单个LED颜色
  */
 void LEDController::setLED(int index, const LEDColor& color) {
-    if (index >= 0 && index < LED_COUNT) {
-        leds[index] = color.toCRGB();
+    int pixel = pixelIndex(SEGMENT_STATUS, index);
+    if (pixel >= 0) {
+        leds[pixel] = color.toCRGB();
     }
 }
 
+/**
+ * 分段内索引映射到物理索引
+ * @return 物理索引，越界时返回-1
+ */
+int LEDController::pixelIndex(uint8_t segment, int index) const {
+    if (segment >= LED_MAX_SEGMENTS || !segments[segment].active) {
+        return -1;
+    }
+    
+    const LEDSegment& seg = segments[segment];
+    if (index < 0 || index >= seg.length) {
+        return -1;
+    }
+    
+    int pixel = seg.start + (seg.reversed ? seg.length - 1 - index : index);
+    return pixel < ledCount ? pixel : -1;
+}
+
+/**
+ * 状态分段长度 (动画使用，至少为1)
+ */
+uint16_t LEDController::statusLength() const {
+    uint16_t length = getSegmentLength(SEGMENT_STATUS);
+    return length > 0 ? length : 1;
+}
+
 /**
  * 混合两种颜色
  */
@@ -337,7 +436,9 @@ uint8_t LEDController::calculateSineWave(uint16_t phase, uint8_t amplitude) {
  * 应用全局亮度
  */
 void LEDController::applyGlobalBrightness() {
-    FastLED.setBrightness(globalBrightness);
+    if (!asyncOutput) {
+        FastLED.setBrightness(globalBrightness);
+    }
 }
 
 // ============= 公共方法实现 =============
@@ -366,7 +467,7 @@ void LEDController::setBrightness(uint8_t brightness) {
     globalBrightness = brightness;
     targetBrightness = brightness;
     status.brightness = brightness;
-    FastLED.setBrightness(globalBrightness);
+    applyGlobalBrightness();
     isFading = false;
 }
 
@@ -494,7 +595,7 @@ void LEDController::showHealthScore(int score) {
     
     // 根据评分点亮相应数量的LED
     clear();
-    int ledsToLight = map(score, 0, 100, 0, LED_COUNT);
+    int ledsToLight = map(score, 0, 100, 0, getSegmentLength(SEGMENT_STATUS));
     
     for (int i = 0; i < ledsToLight; i++) {
         setLED(i, scoreColor);
@@ -597,26 +698,174 @@ void LEDController::setLEDColor(int index, const LEDColor& color) {
  * 获取单个LED颜色
  */
 LEDColor LEDController::getLEDColor(int index) const {
-    if (index >= 0 && index < LED_COUNT) {
-        CRGB crgb = leds[index];
+    int pixel = pixelIndex(SEGMENT_STATUS, index);
+    if (pixel >= 0) {
+        CRGB crgb = leds[pixel];
         return LEDColor(crgb.r, crgb.g, crgb.b);
     }
     return COLOR_BLACK;
 }
 
 /**
- * 清除所有LED
+ * 设置LED数量
+ */
+bool LEDController::setLedCount(uint16_t count) {
+    if (count == 0 || count > LED_MAX_COUNT) {
+        DEBUG_PRINTF("✗ LED数量无效: %u\n", count);
+        return false;
+    }
+    if (count == ledCount) {
+        return true;
+    }
+    
+    if (asyncOutput && !stripDriver.resize(count)) {
+        DEBUG_PRINTLN("✗ LED输出缓冲区调整失败");
+        return false;
+    }
+    if (fastLedController != nullptr) {
+        fastLedController->setLeds(leds, count);
+    }
+    
+    // 缩短时熄灭多出的LED；状态分段原先覆盖整条灯带时随之伸缩
+    if (count < ledCount) {
+        fill_solid(leds + count, ledCount - count, CRGB::Black);
+    }
+    LEDSegment& statusSegment = segments[SEGMENT_STATUS];
+    if (statusSegment.start == 0 && statusSegment.length == ledCount) {
+        statusSegment.length = count;
+    }
+    ledCount = count;
+    
+    DEBUG_PRINTF("LED数量已设置为 %u\n", count);
+    return true;
+}
+
+/**
+ * 获取LED数量
+ */
+uint16_t LEDController::getLedCount() const {
+    return ledCount;
+}
+
+/**
+ * 定义分段
+ */
+bool LEDController::defineSegment(uint8_t id, uint16_t start, uint16_t length, bool reversed) {
+    if (id >= LED_MAX_SEGMENTS || length == 0 || start + length > ledCount) {
+        DEBUG_PRINTF("✗ 分段定义无效: id=%u, start=%u, length=%u\n", id, start, length);
+        return false;
+    }
+    
+    segments[id] = {start, length, reversed, true};
+    DEBUG_PRINTF("LED分段%u: %u-%u%s\n", id, start, start + length - 1, reversed ? " (反向)" : "");
+    return true;
+}
+
+/**
+ * 移除分段
+ */
+void LEDController::removeSegment(uint8_t id) {
+    if (id < LED_MAX_SEGMENTS) {
+        segments[id].active = false;
+    }
+}
+
+/**
+ * 获取分段LED数量
+ */
+uint16_t LEDController::getSegmentLength(uint8_t id) const {
+    if (id >= LED_MAX_SEGMENTS || !segments[id].active) {
+        return 0;
+    }
+    return segments[id].length;
+}
+
+/**
+ * 填充分段颜色
+ */
+void LEDController::fillSegment(uint8_t id, const LEDColor& color) {
+    uint16_t length = getSegmentLength(id);
+    for (uint16_t i = 0; i < length; i++) {
+        setSegmentPixel(id, i, color);
+    }
+}
+
+/**
+ * 设置分段内单个LED颜色
+ */
+void LEDController::setSegmentPixel(uint8_t id, uint16_t index, const LEDColor& color) {
+    int pixel = pixelIndex(id, index);
+    if (pixel >= 0) {
+        leds[pixel] = color.toCRGB();
+    }
+}
+
+/**
+ * 清除状态分段LED
  */
 void LEDController::clear() {
-    FastLED.clear();
+    fillSegment(SEGMENT_STATUS, COLOR_BLACK);
     status.currentColor = COLOR_BLACK;
 }
 
 /**
- * 立即刷新LED显示
+ * 提交当前帧
  */
 void LEDController::show() {
-    FastLED.show();
+    // 有像素点亮时才给灯带上电，上电稳定前保留帧，由update补发
+    bool lit = hasLitPixels();
+    if (lit && !stripPowered) {
+        PowerDomainManager::acquire(PowerDomain::LED_STRIP);
+        stripPowered = true;
+    }
+    if (stripPowered && !PowerDomainManager::isReady(PowerDomain::LED_STRIP)) {
+        framePending = true;
+        return;
+    }
+    
+    if (!asyncOutput) {
+        FastLED.show();
+        framePending = false;
+#if TOUCH_LATENCY_TRACE_ENABLED
+        TouchLatencyTracer::onFramePushed();
+#endif
+    } else {
+        // 亮度与色彩校正在编码时按通道缩放，与FastLED同步输出效果一致
+        CRGB adjustment = CLEDController::computeAdjustment(globalBrightness,
+                                                            CRGB(TypicalLEDStrip),
+                                                            CRGB(Tungsten40W));
+        if (stripDriver.submit(leds, adjustment)) {
+            framePending = false;
+#if TOUCH_LATENCY_TRACE_ENABLED
+            TouchLatencyTracer::onFramePushed();
+#endif
+        } else if (!framePending) {
+            // 驱动忙时不等待，保留渲染缓冲区，下次update补发
+            stripDriver.noteSkippedFrame();
+            framePending = true;
+        }
+    }
+    
+    // 全黑帧发出后释放电源 (电源域延迟断电，动画间隙不会反复开关)
+    if (!lit && stripPowered && !framePending) {
+        PowerDomainManager::release(PowerDomain::LED_STRIP);
+        stripPowered = false;
+    }
+}
+
+/**
+ * 是否有像素点亮
+ */
+bool LEDController::hasLitPixels() const {
+    if (globalBrightness == 0) {
+        return false;
+    }
+    for (uint16_t i = 0; i < ledCount; i++) {
+        if (leds[i].r != 0 || leds[i].g != 0 || leds[i].b != 0) {
+            return true;
+        }
+    }
+    return false;
 }
 
 /**
@@ -625,6 +874,10 @@ void LEDController::show() {
 bool LEDController::performTest() {
     DEBUG_PRINTLN("执行LED测试...");
     
+    // 测试期间保持灯带供电，第一帧不必等待update补发
+    PowerDomainManager::acquire(PowerDomain::LED_STRIP);
+    delay(PowerDomainManager::getTimeUntilReady(PowerDomain::LED_STRIP));
+    
     // 测试红色
     setColor(COLOR_RED);
     show();
@@ -643,6 +896,10 @@ bool LEDController::performTest() {
     // 清除
     clear();
     show();
+    if (asyncOutput) {
+        stripDriver.waitIdle();
+    }
+    PowerDomainManager::release(PowerDomain::LED_STRIP);
     
     DEBUG_PRINTLN("✓ LED测试完成");
     return true;
@@ -652,9 +909,10 @@ bool LEDController::performTest() {
  * 获取系统信息
  */
 String LEDController::getSystemInfo() const {
-    DynamicJsonDocument doc(512);
+    DynamicJsonDocument doc(1024);
     
-    doc["led_count"] = LED_COUNT;
+    doc["led_count"] = ledCount;
+    doc["async_output"] = asyncOutput;
     doc["is_on"] = status.isOn;
     doc["brightness"] = globalBrightness;
     doc["is_animating"] = status.isAnimating;
@@ -663,6 +921,25 @@ String LEDController::getSystemInfo() const {
     doc["current_color"]["g"] = status.currentColor.g;
     doc["current_color"]["b"] = status.currentColor.b;
     
+    JsonArray segmentArray = doc.createNestedArray("segments");
+    for (int i = 0; i < LED_MAX_SEGMENTS; i++) {
+        if (segments[i].active) {
+            JsonObject segment = segmentArray.createNestedObject();
+            segment["id"] = i;
+            segment["start"] = segments[i].start;
+            segment["length"] = segments[i].length;
+            segment["reversed"] = segments[i].reversed;
+        }
+    }
+    
+    if (asyncOutput) {
+        LEDStripStats stats = stripDriver.getStats();
+        doc["frames_sent"] = stats.framesSent;
+        doc["frames_skipped"] = stats.framesSkipped;
+        doc["encode_us"] = stats.lastEncodeMicros;
+        doc["frame_us"] = stats.lastFrameMicros;
+    }
+    
     String result;
     serializeJson(doc, result);
     return result;
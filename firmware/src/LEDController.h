@@ -8,7 +8,9 @@
 
 #include <Arduino.h>
 #include <FastLED.h>
+#include "LEDStripDriver.h"
 #include "StateManager.h"
+#include "PowerDomain.h"
 #include "config.h"
 
 /**
@@ -69,13 +71,37 @@ struct LEDStatus {
     bool isAnimating;           // 是否正在播放动画
 };
 
+/**
+ * LED分段 (将物理灯带划分为状态灯、补光灯环等逻辑区域)
+ */
+struct LEDSegment {
+    uint16_t start;             // 起始物理索引
+    uint16_t length;            // LED数量
+    bool reversed;              // 是否反向排列
+    bool active;                // 是否已定义
+};
+
 /**
  * LED控制器类
  */
 class LEDController {
+public:
+    static const uint8_t SEGMENT_STATUS = 0;   // 状态显示分段 (动画作用于此分段)
+    static const uint8_t SEGMENT_GROW = 1;     // 补光灯环分段
+
 private:
-    CRGB leds[LED_COUNT];       // LED数组
+    CRGB leds[LED_MAX_COUNT];   // 渲染缓冲区 (按最大数量预留)
+    uint16_t ledCount;          // 实际连接的LED数量
+    LEDSegment segments[LED_MAX_SEGMENTS]; // 分段映射
     LEDStatus status;           // LED状态
+    
+    // 输出驱动
+    LEDStripDriver stripDriver; // RMT异步双缓冲输出
+    CLEDController* fastLedController; // 同步输出回退
+    bool asyncOutput;           // 是否使用异步输出
+    bool framePending;          // 有帧等待发送
+    bool blanked;               // 状态灯熄灭 (夜间模式)
+    bool stripPowered;          // 已申请灯带电源域
     LEDAnimationConfig animConfig; // 动画配置
     
     // 动画状态
@@ -106,6 +132,9 @@ private:
     LEDColor adjustBrightness(const LEDColor& color, uint8_t brightness);
     uint8_t calculateSineWave(uint16_t phase, uint8_t amplitude = 255);
     void applyGlobalBrightness();
+    int pixelIndex(uint8_t segment, int index) const;
+    uint16_t statusLength() const;
+    bool hasLitPixels() const;
 
 public:
     /**
@@ -120,15 +149,78 @@ public:
     
     /**
      * 初始化LED控制器
+     * @param count 连接的LED数量
      * @return 初始化是否成功
      */
-    bool initialize();
+    bool initialize(uint16_t count = LED_COUNT);
+    
+    /**
+     * 设置LED数量 (运行时修改，状态分段随之调整)
+     * @param count LED数量 (1-LED_MAX_COUNT)
+     * @return 是否成功
+     */
+    bool setLedCount(uint16_t count);
+    
+    /**
+     * 获取LED数量
+     */
+    uint16_t getLedCount() const;
+    
+    /**
+     * 定义分段
+     * @param id 分段编号 (0-LED_MAX_SEGMENTS-1)
+     * @param start 起始物理索引
+     * @param length LED数量
+     * @param reversed 是否反向排列
+     * @return 是否成功
+     */
+    bool defineSegment(uint8_t id, uint16_t start, uint16_t length, bool reversed = false);
+    
+    /**
+     * 移除分段
+     * @param id 分段编号
+     */
+    void removeSegment(uint8_t id);
+    
+    /**
+     * 获取分段LED数量
+     * @param id 分段编号
+     * @return LED数量，未定义时为0
+     */
+    uint16_t getSegmentLength(uint8_t id) const;
+    
+    /**
+     * 填充分段颜色
+     * @param id 分段编号
+     * @param color 颜色
+     */
+    void fillSegment(uint8_t id, const LEDColor& color);
+    
+    /**
+     * 设置分段内单个LED颜色
+     * @param id 分段编号
+     * @param index 分段内索引
+     * @param color 颜色
+     */
+    void setSegmentPixel(uint8_t id, uint16_t index, const LEDColor& color);
     
     /**
      * 更新LED显示（应在主循环中调用）
      */
     void update();
     
+    /**
+     * 熄灭/恢复状态分段 (夜间模式)
+     * 熄灭时暂停动画渲染，仅低频刷新其他分段；恢复时重绘当前颜色或继续动画
+     * @param blank 是否熄灭
+     */
+    void setBlanked(bool blank);
+    
+    /**
+     * 状态分段是否已熄灭
+     */
+    bool isBlanked() const;
+    
     /**
      * 设置LED颜色
      * @param color LED颜色
@@ -273,25 +365,25 @@ public:
     
     /**
      * 设置单个LED颜色
-     * @param index LED索引 (0-LED_COUNT-1)
+     * @param index 状态分段内的LED索引
      * @param color LED颜色
      */
     void setLEDColor(int index, const LEDColor& color);
     
     /**
      * 获取单个LED颜色
-     * @param index LED索引 (0-LED_COUNT-1)
+     * @param index 状态分段内的LED索引
      * @return LED颜色
      */
     LEDColor getLEDColor(int index) const;
     
     /**
-     * 清除所有LED
+     * 清除状态分段LED
      */
     void clear();
     
     /**
-     * 立即刷新LED显示
+     * 提交当前帧 (异步输出时不等待传输完成)
      */
     void show();
     
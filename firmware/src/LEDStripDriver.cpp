@@ -0,0 +1,274 @@
+/**
+ * AI智能植物养护机器人 - LED灯带异步输出驱动实现
+ */
+
+#include "LEDStripDriver.h"
+
+// WS2812B 时序 (RMT时钟 80MHz / 2 = 40MHz，每tick 25ns)
+#define RMT_CLOCK_DIVIDER 2
+#define WS2812_T0H_TICKS 16   // 0.40us
+#define WS2812_T0L_TICKS 34   // 0.85us
+#define WS2812_T1H_TICKS 32   // 0.80us
+#define WS2812_T1L_TICKS 18   // 0.45us
+
+LEDStripDriver* LEDStripDriver::channelOwners[RMT_CHANNEL_MAX] = {nullptr};
+
+/**
+ * 构造函数
+ */
+LEDStripDriver::LEDStripDriver()
+    : channel(RMT_CHANNEL_0),
+      dataPin(-1),
+      ledCount(0),
+      initialized(false),
+      backIndex(0),
+      transmitting(false),
+      txStartMicros(0),
+      txEndMicros(0) {
+
+    frameBuffers[0] = nullptr;
+    frameBuffers[1] = nullptr;
+    stats = {0, 0, 0, 0};
+}
+
+/**
+ * 析构函数
+ */
+LEDStripDriver::~LEDStripDriver() {
+    if (initialized) {
+        waitIdle();
+        rmt_driver_uninstall(channel);
+        channelOwners[channel] = nullptr;
+    }
+    freeBuffers();
+}
+
+/**
+ * 初始化驱动
+ */
+bool LEDStripDriver::begin(int pin, uint16_t count, rmt_channel_t rmtChannel) {
+    if (initialized) {
+        return resize(count);
+    }
+
+    channel = rmtChannel;
+    dataPin = pin;
+
+    if (!allocateBuffers(count)) {
+        DEBUG_PRINTLN("✗ LED帧缓冲区分配失败");
+        return false;
+    }
+
+    rmt_config_t config = RMT_DEFAULT_CONFIG_TX((gpio_num_t)pin, rmtChannel);
+    config.clk_div = RMT_CLOCK_DIVIDER;
+    config.mem_block_num = 2;    // 双块RMT内存，减少中断补充次数
+
+    if (rmt_config(&config) != ESP_OK ||
+        rmt_driver_install(rmtChannel, 0, 0) != ESP_OK) {
+        DEBUG_PRINTLN("✗ RMT驱动安装失败");
+        freeBuffers();
+        return false;
+    }
+
+    rmt_translator_init(rmtChannel, translateSamples);
+    channelOwners[rmtChannel] = this;
+    rmt_register_tx_end_callback(handleTxEnd, nullptr);
+
+    initialized = true;
+    DEBUG_PRINTF("✓ LED异步输出就绪: GPIO%d, %u颗LED, RMT通道%d\n", pin, count, (int)rmtChannel);
+    return true;
+}
+
+/**
+ * 调整LED数量
+ */
+bool LEDStripDriver::resize(uint16_t count) {
+    if (count == ledCount) {
+        return true;
+    }
+
+    // RMT仍在读取前台缓冲区时不能释放，由调用方稍后重试
+    if (!waitIdle(50)) {
+        DEBUG_PRINTLN("✗ LED输出忙，暂不调整缓冲区");
+        return false;
+    }
+    freeBuffers();
+    return allocateBuffers(count);
+}
+
+/**
+ * 分配双缓冲
+ */
+bool LEDStripDriver::allocateBuffers(uint16_t count) {
+    if (count == 0 || count > LED_MAX_COUNT) {
+        return false;
+    }
+
+    size_t size = (size_t)count * 3;
+    frameBuffers[0] = (uint8_t*)malloc(size);
+    frameBuffers[1] = (uint8_t*)malloc(size);
+    if (frameBuffers[0] == nullptr || frameBuffers[1] == nullptr) {
+        freeBuffers();
+        return false;
+    }
+
+    memset(frameBuffers[0], 0, size);
+    memset(frameBuffers[1], 0, size);
+    ledCount = count;
+    backIndex = 0;
+    return true;
+}
+
+/**
+ * 释放缓冲区
+ */
+void LEDStripDriver::freeBuffers() {
+    free(frameBuffers[0]);
+    free(frameBuffers[1]);
+    frameBuffers[0] = nullptr;
+    frameBuffers[1] = nullptr;
+    ledCount = 0;
+}
+
+/**
+ * 是否可以提交新帧
+ */
+bool LEDStripDriver::isReady() const {
+    if (!initialized || transmitting) {
+        return false;
+    }
+    return (micros() - txEndMicros) >= RESET_TIME_US;
+}
+
+/**
+ * 提交一帧
+ */
+bool LEDStripDriver::submit(const CRGB* pixels, const CRGB& adjustment) {
+    // 发送完成中断丢失时以驱动状态为准，避免永久忙
+    if (initialized && transmitting && (micros() - txStartMicros) > 50000UL &&
+        rmt_wait_tx_done(channel, 0) == ESP_OK) {
+        transmitting = false;
+        txEndMicros = micros();
+    }
+
+    if (!isReady() || frameBuffers[0] == nullptr) {
+        return false;
+    }
+
+    unsigned long encodeStart = micros();
+
+    // 编码到后台缓冲区 (当前发送中的是另一块)
+    uint8_t* buffer = frameBuffers[backIndex];
+    for (uint16_t i = 0; i < ledCount; i++) {
+        buffer[i * 3]     = scale8(pixels[i].g, adjustment.g);
+        buffer[i * 3 + 1] = scale8(pixels[i].r, adjustment.r);
+        buffer[i * 3 + 2] = scale8(pixels[i].b, adjustment.b);
+    }
+
+    stats.lastEncodeMicros = micros() - encodeStart;
+
+    transmitting = true;
+    txStartMicros = micros();
+    if (rmt_write_sample(channel, buffer, (size_t)ledCount * 3, false) != ESP_OK) {
+        transmitting = false;
+        return false;
+    }
+
+    // 下一帧写入另一块缓冲区，不影响正在发送的数据
+    backIndex ^= 1;
+    stats.framesSent++;
+    return true;
+}
+
+/**
+ * 等待当前帧发送完成
+ */
+bool LEDStripDriver::waitIdle(uint32_t timeoutMs) {
+    if (!initialized) {
+        return true;
+    }
+    return rmt_wait_tx_done(channel, pdMS_TO_TICKS(timeoutMs)) == ESP_OK;
+}
+
+/**
+ * 记录一次帧合并
+ */
+void LEDStripDriver::noteSkippedFrame() {
+    stats.framesSkipped++;
+}
+
+/**
+ * 字节到RMT脉冲的转换 (RMT中断中按需调用)
+ */
+void IRAM_ATTR LEDStripDriver::translateSamples(const void* src, rmt_item32_t* dest, size_t srcSize,
+                                                size_t wantedNum, size_t* translatedSize, size_t* itemNum) {
+    if (src == nullptr || dest == nullptr) {
+        *translatedSize = 0;
+        *itemNum = 0;
+        return;
+    }
+
+    rmt_item32_t bit0;
+    bit0.duration0 = WS2812_T0H_TICKS;
+    bit0.level0 = 1;
+    bit0.duration1 = WS2812_T0L_TICKS;
+    bit0.level1 = 0;
+
+    rmt_item32_t bit1;
+    bit1.duration0 = WS2812_T1H_TICKS;
+    bit1.level0 = 1;
+    bit1.duration1 = WS2812_T1L_TICKS;
+    bit1.level1 = 0;
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(src);
+    size_t size = 0;
+    size_t num = 0;
+
+    while (size < srcSize && num + 8 <= wantedNum) {
+        uint8_t value = bytes[size];
+        for (int bit = 7; bit >= 0; bit--) {
+            dest->val = (value & (1 << bit)) ? bit1.val : bit0.val;
+            dest++;
+        }
+        num += 8;
+        size++;
+    }
+
+    *translatedSize = size;
+    *itemNum = num;
+}
+
+/**
+ * 发送完成中断
+ */
+void IRAM_ATTR LEDStripDriver::handleTxEnd(rmt_channel_t channel, void*) {
+    LEDStripDriver* driver = channelOwners[channel];
+    if (driver == nullptr) {
+        return;
+    }
+
+    driver->txEndMicros = micros();
+    driver->stats.lastFrameMicros = driver->txEndMicros - driver->txStartMicros;
+    driver->transmitting = false;
+}
+
+/**
+ * 获取LED数量
+ */
+uint16_t LEDStripDriver::getLedCount() const {
+    return ledCount;
+}
+
+/**
+ * 是否已初始化
+ */
+bool LEDStripDriver::isInitialized() const {
+    return initialized;
+}
+
+/**
+ * 获取统计信息
+ */
+LEDStripStats LEDStripDriver::getStats() const {
+    return stats;
+}
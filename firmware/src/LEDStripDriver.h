@@ -0,0 +1,128 @@
+/**
+ * AI智能植物养护机器人 - LED灯带异步输出驱动
+ * 通过RMT外设异步发送WS2812B数据，双缓冲：
+ * 一个缓冲区正在发送时，下一帧编码到另一个缓冲区，主循环不等待传输完成
+ */
+
+#ifndef LED_STRIP_DRIVER_H
+#define LED_STRIP_DRIVER_H
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include <driver/rmt.h>
+#include "config.h"
+
+/**
+ * 驱动统计信息
+ */
+struct LEDStripStats {
+    unsigned long framesSent;        // 已发送帧数
+    unsigned long framesSkipped;     // 因上一帧未发完而合并的帧数
+    unsigned long lastEncodeMicros;  // 最近一次编码耗时 (微秒)
+    unsigned long lastFrameMicros;   // 最近一帧的传输时长 (微秒)
+};
+
+/**
+ * LED灯带异步输出驱动类
+ */
+class LEDStripDriver {
+public:
+    static const uint32_t RESET_TIME_US = 300;   // 帧间复位时间 (WS2812B新版需>280us)
+
+private:
+    rmt_channel_t channel;
+    int dataPin;
+    uint16_t ledCount;
+    bool initialized;
+
+    // 双缓冲 (GRB字节序)
+    uint8_t* frameBuffers[2];
+    uint8_t backIndex;
+
+    // 传输状态 (由发送完成中断更新)
+    volatile bool transmitting;
+    volatile unsigned long txStartMicros;
+    volatile unsigned long txEndMicros;
+
+    LEDStripStats stats;
+
+    static LEDStripDriver* channelOwners[RMT_CHANNEL_MAX];
+
+    bool allocateBuffers(uint16_t count);
+    void freeBuffers();
+
+    // RMT回调
+    static void IRAM_ATTR translateSamples(const void* src, rmt_item32_t* dest, size_t srcSize,
+                                           size_t wantedNum, size_t* translatedSize, size_t* itemNum);
+    static void IRAM_ATTR handleTxEnd(rmt_channel_t channel, void* arg);
+
+public:
+    /**
+     * 构造函数
+     */
+    LEDStripDriver();
+
+    /**
+     * 析构函数
+     */
+    ~LEDStripDriver();
+
+    /**
+     * 初始化驱动
+     * @param pin 数据引脚
+     * @param count LED数量
+     * @param rmtChannel RMT通道
+     * @return 初始化是否成功
+     */
+    bool begin(int pin, uint16_t count, rmt_channel_t rmtChannel = RMT_CHANNEL_0);
+
+    /**
+     * 调整LED数量 (等待当前帧发送完成后重新分配缓冲区)
+     * @param count 新的LED数量
+     * @return 是否成功 (当前帧50ms内未发送完成时不调整，返回false)
+     */
+    bool resize(uint16_t count);
+
+    /**
+     * 提交一帧：编码到后台缓冲区并启动异步发送
+     * 上一帧仍在发送或处于复位间隔内时立即返回false，由调用方稍后重试
+     * @param pixels 像素数据
+     * @param adjustment 亮度与色彩校正系数 (每通道 scale8)
+     * @return 是否已开始发送
+     */
+    bool submit(const CRGB* pixels, const CRGB& adjustment);
+
+    /**
+     * 是否可以提交新帧
+     */
+    bool isReady() const;
+
+    /**
+     * 等待当前帧发送完成
+     * @param timeoutMs 超时时间
+     * @return 是否已完成
+     */
+    bool waitIdle(uint32_t timeoutMs = 20);
+
+    /**
+     * 记录一次帧合并 (调用方因驱动忙而推迟显示时调用)
+     */
+    void noteSkippedFrame();
+
+    /**
+     * 获取LED数量
+     */
+    uint16_t getLedCount() const;
+
+    /**
+     * 是否已初始化
+     */
+    bool isInitialized() const;
+
+    /**
+     * 获取统计信息
+     */
+    LEDStripStats getStats() const;
+};
+
+#endif // LED_STRIP_DRIVER_H
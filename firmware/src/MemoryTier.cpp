@@ -0,0 +1,153 @@
+/**
+ * AI智能植物养护机器人 - 分层内存管理实现
+ */
+
+#include "MemoryTier.h"
+#include <soc/soc_memory_layout.h>
+
+MemoryTierStats MemoryTierManager::stats[(size_t)MemoryTier::COUNT] = {};
+
+/**
+ * 内存层对应的heap_caps能力标志
+ */
+uint32_t MemoryTierManager::capsFor(MemoryTier tier) {
+    if (tier == MemoryTier::PSRAM) {
+        return MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT;
+    }
+    return MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT;
+}
+
+/**
+ * 指针所在的内存层
+ */
+MemoryTier MemoryTierManager::tierOf(const void* ptr) {
+    return esp_ptr_external_ram(ptr) ? MemoryTier::PSRAM : MemoryTier::INTERNAL;
+}
+
+/**
+ * 记录一次成功分配
+ */
+void MemoryTierManager::recordAllocation(MemoryTier tier, size_t size) {
+    MemoryTierStats& s = stats[(size_t)tier];
+    s.bytesInUse += size;
+    s.allocations++;
+    if (s.bytesInUse > s.peakBytes) {
+        s.peakBytes = s.bytesInUse;
+    }
+}
+
+/**
+ * 在指定内存层分配
+ */
+void* MemoryTierManager::allocate(MemoryTier tier, size_t size) {
+    if (size == 0) {
+        return nullptr;
+    }
+
+    if (tier == MemoryTier::PSRAM && isPsramAvailable()) {
+        void* ptr = heap_caps_malloc(size, capsFor(MemoryTier::PSRAM));
+        if (ptr != nullptr) {
+            recordAllocation(MemoryTier::PSRAM, size);
+            return ptr;
+        }
+    }
+
+    // PSRAM不可用或已满时退回内部SRAM，字节数记在内部SRAM上，回退次数记在PSRAM上
+    void* ptr = heap_caps_malloc(size, capsFor(MemoryTier::INTERNAL));
+    if (ptr == nullptr) {
+        stats[(size_t)tier].failures++;
+        DEBUG_PRINTF("MemoryTier: %s 分配 %u 字节失败\n", getTierName(tier), (unsigned)size);
+        return nullptr;
+    }
+    if (tier == MemoryTier::PSRAM) {
+        stats[(size_t)tier].fallbacks++;
+    }
+    recordAllocation(MemoryTier::INTERNAL, size);
+    return ptr;
+}
+
+/**
+ * 释放内存
+ */
+void MemoryTierManager::release(void* ptr, size_t size) {
+    if (ptr == nullptr) {
+        return;
+    }
+    MemoryTierStats& s = stats[(size_t)tierOf(ptr)];
+    heap_caps_free(ptr);
+    s.bytesInUse = s.bytesInUse > size ? s.bytesInUse - size : 0;
+}
+
+/**
+ * 是否有可用的PSRAM
+ */
+bool MemoryTierManager::isPsramAvailable() {
+#ifdef BOARD_HAS_PSRAM
+    return psramFound();
+#else
+    return false;
+#endif
+}
+
+/**
+ * 获取分配统计
+ */
+MemoryTierStats MemoryTierManager::getStats(MemoryTier tier) {
+    return stats[(size_t)tier];
+}
+
+/**
+ * 获取空闲字节数
+ */
+size_t MemoryTierManager::getFreeBytes(MemoryTier tier) {
+    if (tier == MemoryTier::PSRAM && !isPsramAvailable()) {
+        return 0;
+    }
+    return heap_caps_get_free_size(capsFor(tier));
+}
+
+/**
+ * 获取最大连续空闲块
+ */
+size_t MemoryTierManager::getLargestFreeBlock(MemoryTier tier) {
+    if (tier == MemoryTier::PSRAM && !isPsramAvailable()) {
+        return 0;
+    }
+    return heap_caps_get_largest_free_block(capsFor(tier));
+}
+
+/**
+ * 获取各层使用情况
+ */
+String MemoryTierManager::getInfo() {
+    DynamicJsonDocument doc(512);
+
+    doc["psram"] = isPsramAvailable();
+    for (size_t i = 0; i < (size_t)MemoryTier::COUNT; i++) {
+        MemoryTier tier = (MemoryTier)i;
+        const MemoryTierStats& s = stats[i];
+        JsonObject t = doc.createNestedObject(getTierName(tier));
+        t["in_use"] = s.bytesInUse;
+        t["peak"] = s.peakBytes;
+        t["allocations"] = s.allocations;
+        t["failures"] = s.failures;
+        t["fallbacks"] = s.fallbacks;
+        t["free"] = getFreeBytes(tier);
+        t["largest_block"] = getLargestFreeBlock(tier);
+    }
+
+    String result;
+    serializeJson(doc, result);
+    return result;
+}
+
+/**
+ * 获取内存层名称
+ */
+const char* MemoryTierManager::getTierName(MemoryTier tier) {
+    switch (tier) {
+        case MemoryTier::INTERNAL: return "internal";
+        case MemoryTier::PSRAM: return "psram";
+        default: return "unknown";
+    }
+}
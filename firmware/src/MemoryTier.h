@@ -0,0 +1,235 @@
+/**
+ * AI智能植物养护机器人 - 分层内存管理
+ * 按访问特性把缓冲区放到不同的内存层：
+ *   INTERNAL - 内部SRAM，低延迟，留给主循环热数据以及WiFi/TLS协议栈
+ *   PSRAM    - 外部PSRAM，容量大但较慢，存放历史数据、待发送积压和大型JSON文档
+ * 放置位置写在类型里 (TieredArray / TieredAllocator / PsramJsonDocument)，
+ * 没有PSRAM时PSRAM层自动退回内部SRAM，字节数记在实际提供内存的层上，
+ * 回退次数单独记在PSRAM层
+ */
+
+#ifndef MEMORY_TIER_H
+#define MEMORY_TIER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <esp_heap_caps.h>
+#include <new>
+#include "config.h"
+
+/**
+ * 内存层
+ */
+enum class MemoryTier : uint8_t {
+    INTERNAL,       // 内部SRAM
+    PSRAM,          // 外部PSRAM
+    COUNT
+};
+
+/**
+ * 每层的分配统计
+ */
+struct MemoryTierStats {
+    size_t bytesInUse;          // 本层实际提供且未释放的字节数
+    size_t peakBytes;           // 峰值
+    uint32_t allocations;       // 本层实际提供的分配次数
+    uint32_t failures;          // 请求本层但各层均分配失败的次数
+    uint32_t fallbacks;         // 请求本层但由内部SRAM提供的次数 (仅PSRAM层)
+};
+
+/**
+ * 分层内存管理器 (全局唯一)
+ */
+class MemoryTierManager {
+private:
+    static MemoryTierStats stats[(size_t)MemoryTier::COUNT];
+
+    static uint32_t capsFor(MemoryTier tier);
+    static MemoryTier tierOf(const void* ptr);
+    static void recordAllocation(MemoryTier tier, size_t size);
+
+public:
+    /**
+     * 在指定内存层分配 (PSRAM不足时退回内部SRAM)
+     * @param tier 内存层
+     * @param size 字节数
+     * @return 指针，失败时返回nullptr
+     */
+    static void* allocate(MemoryTier tier, size_t size);
+
+    /**
+     * 释放由allocate分配的内存 (按指针所在的层扣减统计)
+     * @param ptr 指针
+     * @param size 分配时的字节数
+     */
+    static void release(void* ptr, size_t size);
+
+    /**
+     * 是否有可用的PSRAM
+     */
+    static bool isPsramAvailable();
+
+    /**
+     * 获取指定层的分配统计
+     */
+    static MemoryTierStats getStats(MemoryTier tier);
+
+    /**
+     * 获取指定层的空闲字节数
+     */
+    static size_t getFreeBytes(MemoryTier tier);
+
+    /**
+     * 获取指定层的最大连续空闲块
+     */
+    static size_t getLargestFreeBlock(MemoryTier tier);
+
+    /**
+     * 获取各层使用情况
+     * @return JSON格式的内存信息
+     */
+    static String getInfo();
+
+    /**
+     * 获取内存层名称
+     */
+    static const char* getTierName(MemoryTier tier);
+};
+
+/**
+ * 标准容器分配器，元素存放在指定内存层
+ * 例: std::vector<QueuedMessage, TieredAllocator<QueuedMessage, MemoryTier::PSRAM>>
+ */
+template <typename T, MemoryTier Tier>
+struct TieredAllocator {
+    typedef T value_type;
+
+    TieredAllocator() = default;
+
+    template <typename U>
+    TieredAllocator(const TieredAllocator<U, Tier>&) {}
+
+    template <typename U>
+    struct rebind {
+        typedef TieredAllocator<U, Tier> other;
+    };
+
+    T* allocate(size_t n) {
+        void* ptr = MemoryTierManager::allocate(Tier, n * sizeof(T));
+        if (ptr == nullptr) {
+            // 各层均已耗尽，与禁用异常时的std::allocator行为一致
+            abort();
+        }
+        return static_cast<T*>(ptr);
+    }
+
+    void deallocate(T* ptr, size_t n) {
+        MemoryTierManager::release(ptr, n * sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(const TieredAllocator<U, Tier>&) const { return true; }
+
+    template <typename U>
+    bool operator!=(const TieredAllocator<U, Tier>&) const { return false; }
+};
+
+/**
+ * ArduinoJson 分配器，文档内存池放在指定内存层
+ * 释放时没有大小参数，因此在块前保存分配大小
+ */
+template <MemoryTier Tier>
+struct TieredJsonAllocator {
+    static const size_t HEADER_SIZE = 8;
+
+    void* allocate(size_t size) {
+        uint8_t* block = static_cast<uint8_t*>(MemoryTierManager::allocate(Tier, size + HEADER_SIZE));
+        if (block == nullptr) {
+            return nullptr;
+        }
+        *reinterpret_cast<size_t*>(block) = size + HEADER_SIZE;
+        return block + HEADER_SIZE;
+    }
+
+    void deallocate(void* ptr) {
+        if (ptr == nullptr) {
+            return;
+        }
+        uint8_t* block = static_cast<uint8_t*>(ptr) - HEADER_SIZE;
+        MemoryTierManager::release(block, *reinterpret_cast<size_t*>(block));
+    }
+
+    void* reallocate(void* ptr, size_t newSize) {
+        // 仅在shrinkToFit时调用，保留原块即可
+        (void)newSize;
+        return ptr;
+    }
+};
+
+/**
+ * 内存池放在PSRAM的JSON文档，用于大型、非实时的序列化
+ */
+typedef BasicJsonDocument<TieredJsonAllocator<MemoryTier::PSRAM>> PsramJsonDocument;
+
+/**
+ * 定长数组，存放在指定内存层，容量在运行时确定
+ */
+template <typename T, MemoryTier Tier>
+class TieredArray {
+private:
+    T* items;
+    size_t capacity;
+
+public:
+    TieredArray() : items(nullptr), capacity(0) {
+    }
+
+    ~TieredArray() {
+        release();
+    }
+
+    TieredArray(const TieredArray&) = delete;
+    TieredArray& operator=(const TieredArray&) = delete;
+
+    /**
+     * 分配数组 (已分配时先释放)，元素按值初始化
+     * @param count 元素个数
+     * @return 是否分配成功
+     */
+    bool allocate(size_t count) {
+        release();
+        void* ptr = MemoryTierManager::allocate(Tier, count * sizeof(T));
+        if (ptr == nullptr) {
+            return false;
+        }
+        items = static_cast<T*>(ptr);
+        for (size_t i = 0; i < count; i++) {
+            new (&items[i]) T();
+        }
+        capacity = count;
+        return true;
+    }
+
+    /**
+     * 释放数组
+     */
+    void release() {
+        if (items == nullptr) {
+            return;
+        }
+        for (size_t i = 0; i < capacity; i++) {
+            items[i].~T();
+        }
+        MemoryTierManager::release(items, capacity * sizeof(T));
+        items = nullptr;
+        capacity = 0;
+    }
+
+    T& operator[](size_t index) { return items[index]; }
+    const T& operator[](size_t index) const { return items[index]; }
+
+    size_t size() const { return capacity; }
+    bool isAllocated() const { return items != nullptr; }
+};
+
+#endif // MEMORY_TIER_H
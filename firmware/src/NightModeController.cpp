@@ -0,0 +1,154 @@
+/**
+ * AI智能植物养护机器人 - 夜间模式控制器实现
+ */
+
+#include "NightModeController.h"
+#include <ArduinoJson.h>
+
+/**
+ * 构造函数
+ */
+NightModeController::NightModeController()
+    : enabled(true),
+      night(false),
+      transitionPending(false),
+      transitionStartTime(0),
+      lastLux(0),
+      lastSampleTime(0),
+      sampled(false),
+      nightStartTime(0),
+      totalNightMs(0),
+      nightCount(0),
+      changeCallback(nullptr) {
+}
+
+/**
+ * 是否到了下一次光照检测时间
+ */
+bool NightModeController::wantsSample() const {
+    if (!enabled) {
+        return false;
+    }
+    if (!sampled) {
+        return true;
+    }
+
+    unsigned long interval = night ? NIGHT_LIGHT_SAMPLE_INTERVAL_NIGHT : NIGHT_LIGHT_SAMPLE_INTERVAL;
+    return millis() - lastSampleTime >= interval;
+}
+
+/**
+ * 输入一次环境光测量
+ * 白天低于进入阈值、夜间高于退出阈值，且持续足够时间才切换，
+ * 避免云层、人影或短暂开灯造成频繁切换
+ */
+void NightModeController::onLightSample(float lux) {
+    lastLux = lux;
+    lastSampleTime = millis();
+    sampled = true;
+
+    if (!enabled) {
+        return;
+    }
+
+    bool wantsSwitch = night ? lux > NIGHT_EXIT_LUX : lux < NIGHT_ENTER_LUX;
+    if (!wantsSwitch) {
+        transitionPending = false;
+        return;
+    }
+
+    if (!transitionPending) {
+        transitionPending = true;
+        transitionStartTime = lastSampleTime;
+        return;
+    }
+
+    unsigned long required = night ? NIGHT_EXIT_DELAY_MS : NIGHT_ENTER_DELAY_MS;
+    if (lastSampleTime - transitionStartTime >= required) {
+        setNight(!night);
+    }
+}
+
+/**
+ * 切换夜间模式并通知
+ */
+void NightModeController::setNight(bool newNight) {
+    transitionPending = false;
+    if (night == newNight) {
+        return;
+    }
+
+    night = newNight;
+    if (night) {
+        nightStartTime = millis();
+        nightCount++;
+        DEBUG_PRINTF("进入夜间模式 (%.1f lux)\n", lastLux);
+    } else {
+        totalNightMs += millis() - nightStartTime;
+        DEBUG_PRINTF("退出夜间模式 (%.1f lux)，持续 %lu 分钟\n",
+                     lastLux, (millis() - nightStartTime) / 60000);
+    }
+
+    if (changeCallback) {
+        changeCallback(night);
+    }
+}
+
+/**
+ * 启用/禁用夜间模式
+ */
+void NightModeController::setEnabled(bool enable) {
+    enabled = enable;
+    if (!enable) {
+        setNight(false);
+    }
+}
+
+/**
+ * 设置切换回调
+ */
+void NightModeController::setCallback(NightModeCallback callback) {
+    changeCallback = callback;
+}
+
+/**
+ * 是否处于夜间模式
+ */
+bool NightModeController::isNight() const {
+    return night;
+}
+
+/**
+ * 数据上传是否应推迟到早上
+ */
+bool NightModeController::shouldDeferUploads() const {
+    return night;
+}
+
+/**
+ * 获取数据采集间隔倍数
+ */
+uint8_t NightModeController::getSamplingFactor() const {
+    return night ? NIGHT_SAMPLING_FACTOR : 1;
+}
+
+/**
+ * 获取夜间模式信息
+ */
+String NightModeController::getInfo() const {
+    DynamicJsonDocument doc(256);
+
+    unsigned long nightMs = totalNightMs + (night ? millis() - nightStartTime : 0);
+
+    doc["enabled"] = enabled;
+    doc["night"] = night;
+    doc["lux"] = lastLux;
+    doc["pending"] = transitionPending;
+    doc["nights"] = nightCount;
+    doc["night_minutes"] = nightMs / 60000;
+    doc["night_ratio"] = millis() > 0 ? (float)nightMs / millis() : 0.0f;
+
+    String result;
+    serializeJson(doc, result);
+    return result;
+}
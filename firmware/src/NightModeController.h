@@ -0,0 +1,95 @@
+/**
+ * AI智能植物养护机器人 - 夜间模式控制器
+ * 根据环境光检测持续黑暗 (带滞回和持续时间判定)，
+ * 夜间熄灭状态灯、静音非关键音效、拉长采样间隔并推迟数据上传
+ */
+
+#ifndef NIGHT_MODE_CONTROLLER_H
+#define NIGHT_MODE_CONTROLLER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * 夜间模式切换回调函数类型
+ * @param night 是否进入夜间模式
+ */
+typedef void (*NightModeCallback)(bool night);
+
+/**
+ * 夜间模式控制器类
+ */
+class NightModeController {
+private:
+    bool enabled;
+    bool night;
+
+    // 滞回判定：满足切换条件的起始时间
+    bool transitionPending;
+    unsigned long transitionStartTime;
+
+    // 采样
+    float lastLux;
+    unsigned long lastSampleTime;
+    bool sampled;
+
+    // 统计
+    unsigned long nightStartTime;
+    unsigned long totalNightMs;
+    uint32_t nightCount;
+
+    NightModeCallback changeCallback;
+
+    void setNight(bool newNight);
+
+public:
+    /**
+     * 构造函数
+     */
+    NightModeController();
+
+    /**
+     * 是否到了下一次光照检测时间 (夜间检测间隔更长)
+     */
+    bool wantsSample() const;
+
+    /**
+     * 输入一次环境光测量
+     * @param lux 环境光照度 (lux，应扣除补光灯自身的光)
+     */
+    void onLightSample(float lux);
+
+    /**
+     * 启用/禁用夜间模式 (禁用时立即退出)
+     */
+    void setEnabled(bool enable);
+
+    /**
+     * 设置切换回调
+     */
+    void setCallback(NightModeCallback callback);
+
+    /**
+     * 是否处于夜间模式
+     */
+    bool isNight() const;
+
+    /**
+     * 数据上传是否应推迟到早上
+     */
+    bool shouldDeferUploads() const;
+
+    /**
+     * 获取数据采集间隔倍数
+     * @return 夜间为 NIGHT_SAMPLING_FACTOR，白天为1
+     */
+    uint8_t getSamplingFactor() const;
+
+    /**
+     * 获取夜间模式信息
+     * @return JSON格式的信息
+     */
+    String getInfo() const;
+};
+
+#endif // NIGHT_MODE_CONTROLLER_H
@@ -3,15 +3,26 @@
  */
 
 #include "PlantCareRobot.h"
+#include "CommunicationProtocol.h"
+
+PlantCareRobot* PlantCareRobot::instance = nullptr;
 
 PlantCareRobot::PlantCareRobot()
-    : currentMode(SystemMode::INITIALIZING)
+    : factoryTest(sensorManager, interactionController.getLEDController(),
+                  interactionController.getSoundController(), stateManager)
+    , dataPublisher(nullptr)
+    , reportPublisher(nullptr)
+    , communication(nullptr)
+    , currentMode(SystemMode::INITIALIZING)
     , isInitialized(false)
     , isFirstBoot(true)
-    , lastDataCollection(0)
     , lastHeartbeat(0)
+    , sensorPowered(false)
     , errorCount(0)
-    , lastError("") {
+    , lastError("")
+    , quietWindowId(-1)
+    , uploadWindowId(-1) {
+    instance = this;
 }
 
 PlantCareRobot::~PlantCareRobot() {
@@ -21,6 +32,9 @@ PlantCareRobot::~PlantCareRobot() {
 bool PlantCareRobot::initialize() {
     DEBUG_PRINTLN("PlantCareRobot: 开始初始化系统...");
     
+    // 外设电源默认断开，由各控制器按需申请
+    PowerDomainManager::initialize();
+    
     // 初始化传感器管理器
     if (!sensorManager.initialize()) {
         handleError("传感器管理器初始化失败");
@@ -42,6 +56,12 @@ bool PlantCareRobot::initialize() {
     }
     DEBUG_PRINTLN("✓ 状态管理器初始化成功");
     
+    // 状态持久化失败时仅不保存，不影响运行
+    if (!statePersistence.initialize()) {
+        DEBUG_PRINTLN("✗ 状态持久化初始化失败");
+    }
+    configurePipeline();
+    
     // 初始化交互控制器
     if (!interactionController.initialize()) {
         handleError("交互控制器初始化失败");
@@ -49,11 +69,43 @@ bool PlantCareRobot::initialize() {
     }
     DEBUG_PRINTLN("✓ 交互控制器初始化成功");
     
+    // 初始化GPIO事件层和电源管理 (USB检测、充电状态、按键均为中断驱动)
+    if (gpioEventManager.begin()) {
+        gpioEventManager.registerPin(USER_BUTTON_PIN, INPUT_PULLUP, onUserButtonEvent,
+                                     BUTTON_DEBOUNCE_MS, true);
+    }
+    powerManager.setPowerModeChangeCallback(onPowerModeChange);
+    powerManager.initialize();
+    powerManager.attachGpioEvents(&gpioEventManager);
+    DEBUG_PRINTLN("✓ 电源管理初始化成功");
+    
+    // 初始化补光灯和水泵 (失败不影响其他功能)
+    growLight.begin();
+    watering.setEventCallback(onWateringEvent);
+    watering.setFaultCallback(onWateringFault);
+    watering.begin();
+    wateringDetector.setCallback(onWateringDetected);
+    nightMode.setCallback(onNightModeChange);
+    
+    // 日程：静音时段、上传时段、每日汇总和本地零点跨天
+    quietWindowId = scheduler.addWindow("quiet", QUIET_HOURS_START_HOUR, 0, QUIET_HOURS_END_HOUR, 0,
+                                        SCHEDULE_EVERY_DAY, onScheduleWindow);
+    interactionController.getSoundController().setQuietHours(QUIET_HOURS_START_HOUR, 0, QUIET_HOURS_END_HOUR, 0);
+    uploadWindowId = scheduler.addWindow("upload", UPLOAD_WINDOW_START_HOUR, 0, UPLOAD_WINDOW_END_HOUR, 0,
+                                         SCHEDULE_EVERY_DAY, onScheduleWindow);
+    scheduler.addJob("daily_report", DAILY_REPORT_HOUR, 0, SCHEDULE_EVERY_DAY, onDailyReport);
+    scheduler.addDayRolloverHook(onDayRollover);
+    
     // 系统初始化完成
     isInitialized = true;
     currentMode = SystemMode::NORMAL;
     lastHeartbeat = millis();
     
+    // 以电池供电且电量不足启动时直接进入低功耗模式
+    if (powerManager.getPowerMode() != PowerMode::NORMAL) {
+        enterLowPowerMode();
+    }
+    
     // 显示系统就绪状态
     interactionController.triggerEvent(InteractionEvent::SYSTEM_READY);
     
@@ -71,13 +123,22 @@ void PlantCareRobot::update() {
     // 更新心跳
     lastHeartbeat = currentTime;
     
-    // 根据当前模式执行相应逻辑
+    // 分发GPIO事件 (电源来源变化、按键)，再更新电池电压
+    gpioEventManager.dispatch();
+    powerManager.update();
+    
+    // 日程任务、时段边界和跨天
+    scheduler.update();
+    
+    // 采集前提前给传感器上电
+    updateSensorPower();
+    
+    // 根据当前模式执行相应逻辑 (状态评估和提醒在数据管道中随每个样本执行)
     switch (currentMode) {
         case SystemMode::NORMAL:
             // 正常运行模式
-            performDataCollection();
-            updateSystemState();
-            handleAlerts();
+            updatePipelineRate();
+            pipeline.update();
             break;
             
         case SystemMode::CONFIGURATION:
@@ -85,10 +146,9 @@ void PlantCareRobot::update() {
             break;
             
         case SystemMode::LOW_POWER:
-            // 低功耗模式 - 减少更新频率
-            if (currentTime - lastDataCollection > DATA_COLLECTION_INTERVAL * 2) {
-                performDataCollection();
-            }
+            // 低功耗模式 - 减少采集频率，不触发提醒
+            updatePipelineRate();
+            pipeline.update();
             break;
             
         case SystemMode::ERROR:
@@ -100,9 +160,8 @@ void PlantCareRobot::update() {
             
         case SystemMode::OFFLINE:
             // 离线模式 - 仅本地功能
-            performDataCollection();
-            updateSystemState();
-            handleAlerts();
+            updatePipelineRate();
+            pipeline.update();
             break;
             
         case SystemMode::INITIALIZING:
@@ -110,27 +169,490 @@ void PlantCareRobot::update() {
             break;
     }
     
+    // 补光与浇水控制 (低功耗、错误模式下关灯停泵)
+    updateGrowLight();
+    updateWatering();
+    updateWateringDetector();
+    
+    // 没有待采集的样本且浇水控制和检测都不再等待读数时 (如中止或解除)，断开已提前上电的土壤探头
+    if (!sensorPowered && !watering.wantsSample() && !wateringDetector.wantsSample()) {
+        sensorManager.finishSoilReading();
+    }
+    updateNightMode();
+    
+    // 推进协程 (庆祝动画等多步骤流程)
+    CoScheduler::update();
+    
     // 更新交互控制器
     interactionController.update();
     
+    // 无人使用的外设电源域到期断电
+    PowerDomainManager::update();
+    
     // 执行系统维护
     performMaintenance();
+    
+    // 低功耗模式下距下一项工作足够久时浅睡眠
+    sleepWhenIdle();
 }
 
-void PlantCareRobot::performDataCollection() {
-    unsigned long currentTime = millis();
+/**
+ * 配置数据管道：采集 → 过滤 → 派生 → 评估 → 提醒，提醒之后分两路
+ * 写入闪存 (限速，只保留最新一条) 和上传 (攒批，上传受限时排队)
+ */
+void PlantCareRobot::configurePipeline() {
+    pipeline.configureStage(PipelineStage::ACQUIRE, {
+        .handler = acquireStage,
+        .input = PipelineStage::ACQUIRE,
+        .minInterval = DATA_COLLECTION_INTERVAL,
+        .queueCapacity = 1,
+        .batchSize = 1,
+        .maxBatchWait = 0
+    });
+    pipeline.configureStage(PipelineStage::FILTER, {
+        .handler = filterStage,
+        .input = PipelineStage::ACQUIRE,
+        .minInterval = 0,
+        .queueCapacity = PIPELINE_QUEUE_SIZE,
+        .batchSize = 1,
+        .maxBatchWait = 0
+    });
+    pipeline.configureStage(PipelineStage::DERIVE, {
+        .handler = deriveStage,
+        .input = PipelineStage::FILTER,
+        .minInterval = 0,
+        .queueCapacity = PIPELINE_QUEUE_SIZE,
+        .batchSize = 1,
+        .maxBatchWait = 0
+    });
+    pipeline.configureStage(PipelineStage::EVALUATE, {
+        .handler = evaluateStage,
+        .input = PipelineStage::DERIVE,
+        .minInterval = 0,
+        .queueCapacity = PIPELINE_QUEUE_SIZE,
+        .batchSize = 1,
+        .maxBatchWait = 0
+    });
+    pipeline.configureStage(PipelineStage::ALERT, {
+        .handler = alertStage,
+        .input = PipelineStage::EVALUATE,
+        .minInterval = 0,
+        .queueCapacity = PIPELINE_QUEUE_SIZE,
+        .batchSize = 1,
+        .maxBatchWait = 0
+    });
+    pipeline.configureStage(PipelineStage::PERSIST, {
+        .handler = persistStage,
+        .input = PipelineStage::ALERT,
+        .minInterval = PIPELINE_PERSIST_INTERVAL,
+        .queueCapacity = 1,
+        .batchSize = 1,
+        .maxBatchWait = 0
+    });
+    pipeline.configureStage(PipelineStage::PUBLISH, {
+        .handler = publishStage,
+        .input = PipelineStage::ALERT,
+        .minInterval = 0,
+        .queueCapacity = PIPELINE_QUEUE_SIZE,
+        .batchSize = PIPELINE_PUBLISH_BATCH,
+        .maxBatchWait = PIPELINE_PUBLISH_MAX_WAIT
+    });
+}
+
+/**
+ * 采集间隔：夜间按倍数拉长，低功耗模式再加倍
+ */
+void PlantCareRobot::updatePipelineRate() {
+    unsigned long interval = DATA_COLLECTION_INTERVAL * nightMode.getSamplingFactor();
+    if (currentMode == SystemMode::LOW_POWER) {
+        interval *= 2;
+    }
+    pipeline.setStageInterval(PipelineStage::ACQUIRE, interval);
+}
+
+/**
+ * 采集前提前给传感器上电 (提前量覆盖DHT22的上电稳定时间)，不采集的模式下断电
+ */
+void PlantCareRobot::updateSensorPower() {
+    bool sampling = currentMode == SystemMode::NORMAL ||
+                    currentMode == SystemMode::LOW_POWER ||
+                    currentMode == SystemMode::OFFLINE;
+    if (!sampling) {
+        if (sensorPowered) {
+            PowerDomainManager::release(PowerDomain::SENSOR_RAIL);
+            sensorPowered = false;
+        }
+        return;
+    }
     
-    // 检查是否到了数据采集时间
-    if (currentTime - lastDataCollection >= DATA_COLLECTION_INTERVAL) {
-        DEBUG_PRINTLN("PlantCareRobot: 执行数据采集");
-        
-        // 执行数据采集
-        dataCollectionManager.collectData();
-        lastDataCollection = currentTime;
-        
-        // 获取最新数据并更新状态
-        SensorData latestData = dataCollectionManager.getLatestData();
-        stateManager.updateState(latestData);
+    if (!sensorPowered && pipeline.getTimeToNextRun(PipelineStage::ACQUIRE) <= SENSOR_POWER_LEAD_MS) {
+        PowerDomainManager::acquire(PowerDomain::SENSOR_RAIL);
+        sensorPowered = true;
+    }
+    
+    // 电源稳定后给土壤探头上电，探头稳定后在后台采集数据块，到采集时刻已准备好
+    if (sensorPowered && PowerDomainManager::isReady(PowerDomain::SENSOR_RAIL)) {
+        sensorManager.prepareSoilReading();
+        sensorManager.startAcquisition();
+    }
+}
+
+/**
+ * 采集阶段：读取全部传感器 (数据同时进入采集管理器的历史缓冲区)，读取后传感器断电
+ * 土壤和光照使用提前在后台采集完成的数据块
+ */
+StageResult PlantCareRobot::acquireStage(PipelineSample& sample) {
+    // 立即采集请求来不及提前上电，先上电并稍后重试
+    if (!instance->sensorPowered) {
+        PowerDomainManager::acquire(PowerDomain::SENSOR_RAIL);
+        instance->sensorPowered = true;
+    }
+    if (!PowerDomainManager::isReady(PowerDomain::SENSOR_RAIL)) {
+        return StageResult::RETRY;
+    }
+    
+    // 探头稳定和数据块采集在后台进行，未完成时稍后重试，不在此等待
+    instance->sensorManager.prepareSoilReading();
+    instance->sensorManager.startAcquisition();
+    if (!instance->sensorManager.isAcquisitionComplete()) {
+        return StageResult::RETRY;
+    }
+    
+    sample.data = instance->dataCollectionManager.collectOnce();
+    
+    PowerDomainManager::release(PowerDomain::SENSOR_RAIL);
+    instance->sensorPowered = false;
+    return StageResult::PASS;
+}
+
+/**
+ * 过滤阶段：丢弃无效读数
+ */
+StageResult PlantCareRobot::filterStage(PipelineSample& sample) {
+    return sample.data.isValid ? StageResult::PASS : StageResult::DROP;
+}
+
+/**
+ * 派生阶段：由温湿度计算饱和水汽压差 (Tetens公式)
+ */
+StageResult PlantCareRobot::deriveStage(PipelineSample& sample) {
+    float t = sample.data.temperature;
+    float saturation = 0.6108f * expf(17.27f * t / (t + 237.3f));
+    sample.vpd = saturation * (1.0f - sample.data.airHumidity / 100.0f);
+    return StageResult::PASS;
+}
+
+/**
+ * 评估阶段：更新植物状态，并把土壤湿度交给浇水控制器
+ */
+StageResult PlantCareRobot::evaluateStage(PipelineSample& sample) {
+    PlantStatus status = instance->stateManager.evaluateState(sample.data);
+    sample.state = status.state;
+    sample.healthScore = status.healthScore;
+    sample.needsAttention = status.needsAttention;
+    
+    instance->watering.onMoistureSample(sample.data.soilHumidity);
+    return StageResult::PASS;
+}
+
+/**
+ * 提醒阶段：状态变化时触发交互事件并更新主动提醒 (低功耗模式下不提醒)
+ */
+StageResult PlantCareRobot::alertStage(PipelineSample& sample) {
+    SystemMode mode = instance->currentMode;
+    if (mode == SystemMode::NORMAL || mode == SystemMode::OFFLINE) {
+        instance->updateSystemState();
+        instance->handleAlerts();
+    }
+    return StageResult::PASS;
+}
+
+/**
+ * 持久化阶段：保存当前植物状态 (写闪存较慢，由阶段间隔限速)
+ */
+StageResult PlantCareRobot::persistStage(PipelineSample& sample) {
+    PlantStatus status = instance->stateManager.getCurrentStatus();
+    return instance->statePersistence.saveCurrentState(status) ? StageResult::PASS : StageResult::RETRY;
+}
+
+/**
+ * 上传阶段：不在上传时段或推迟上传时留在队列中 (队列满时丢弃最旧样本)
+ */
+StageResult PlantCareRobot::publishStage(PipelineSample& sample) {
+    if (instance->dataPublisher == nullptr) {
+        return StageResult::DROP;
+    }
+    if (!instance->isUploadAllowed()) {
+        return StageResult::RETRY;
+    }
+    return instance->dataPublisher(sample) ? StageResult::PASS : StageResult::RETRY;
+}
+
+/**
+ * 上传昨日分布报告 (与样本上传无关，失败时保留到下一次维护检查)
+ */
+void PlantCareRobot::publishPendingReport() {
+    if (pendingDistributionReport.length() == 0 || reportPublisher == nullptr) {
+        return;
+    }
+    if (reportPublisher(pendingDistributionReport)) {
+        pendingDistributionReport = "";
+    }
+}
+
+void PlantCareRobot::updateGrowLight() {
+    bool active = currentMode == SystemMode::NORMAL || currentMode == SystemMode::OFFLINE;
+    growLight.setEnabled(active);
+    if (active && growLight.wantsSample()) {
+        growLight.update(sensorManager.getLightIntensity(), powerManager.isUSBConnected());
+    }
+    
+    // 灯带上配置了补光灯环时同步输出 (红蓝光谱)
+    LEDController& leds = interactionController.getLEDController();
+    if (leds.getSegmentLength(LEDController::SEGMENT_GROW) > 0) {
+        uint8_t level = (uint8_t)(growLight.getDuty() * 255);
+        leds.fillSegment(LEDController::SEGMENT_GROW, LEDColor(level, 0, level * 3 / 4));
+    }
+}
+
+void PlantCareRobot::updateWatering() {
+    if (currentMode != SystemMode::NORMAL && currentMode != SystemMode::OFFLINE) {
+        watering.abort();
+        return;
+    }
+    
+    watering.update();
+    
+    // 入渗期间按较高频率采样，判断响应是否稳定 (探头激励稳定后再读数，等待期间不阻塞主循环)
+    if (watering.wantsSample()) {
+        sensorManager.prepareSoilReading();
+        if (sensorManager.isSoilReadingReady()) {
+            watering.onMoistureSample(sensorManager.getSoilMoisture());
+        }
+    }
+}
+
+/**
+ * 缺水提醒期间快速采样土壤湿度，检测用户浇水
+ */
+void PlantCareRobot::updateWateringDetector() {
+    bool waterAlert = false;
+    if (currentMode == SystemMode::NORMAL || currentMode == SystemMode::OFFLINE) {
+        AlertManager& alerts = interactionController.getAlertManager();
+        AlertType type = alerts.getCurrentAlert().type;
+        waterAlert = alerts.hasActiveAlert() &&
+                     (type == AlertType::NEEDS_WATER || type == AlertType::CRITICAL);
+    }
+    
+    // 自动浇水运行时湿度上升来自水泵，不作为用户浇水
+    if (!waterAlert || watering.isActive()) {
+        wateringDetector.disarm();
+        return;
+    }
+    
+    // 采样频繁，使用不阻塞主循环的短读数；探头激励在检测期间保持，解除后由 update 断开
+    wateringDetector.arm();
+    if (wateringDetector.wantsSample()) {
+        sensorManager.prepareSoilReading();
+        if (sensorManager.isSoilReadingReady()) {
+            wateringDetector.onSample(sensorManager.sampleSoilMoisture());
+        }
+    }
+}
+
+void PlantCareRobot::onWateringDetected(float moistureBefore, float moistureAfter) {
+    if (instance != nullptr) {
+        instance->handleWateringDetected(moistureBefore, moistureAfter);
+    }
+}
+
+/**
+ * 检测到用户浇水：记录事件并立即重新评估状态，缺水解除时结束提醒并庆祝
+ */
+void PlantCareRobot::handleWateringDetected(float moistureBefore, float moistureAfter) {
+    WateringEvent event = {
+        .timestamp = millis(),
+        .moistureBefore = moistureBefore,
+        .moistureAfter = moistureAfter,
+        .pumpSeconds = 0,
+        .pulses = 0,
+        .automatic = false
+    };
+    watering.recordEvent(event);
+    
+    // 不等下一次数据采集，立即用触发检测的土壤短读数评估 (其余通道沿用最近的有效读数)，
+    // 用户正在操作时不同步采集过采样数据块阻塞主循环
+    SensorData data = sensorManager.getLastValidData();
+    if (!data.isValid || isnan(moistureAfter)) {
+        return;
+    }
+    data.soilHumidity = moistureAfter;
+    data.timestamp = millis();
+    PlantStatus status = stateManager.evaluateState(data);
+    
+    bool stillDry = status.state == PlantState::NEEDS_WATER ||
+                    (status.state == PlantState::CRITICAL && status.soilMoisture < MOISTURE_THRESHOLD);
+    if (stillDry) {
+        DEBUG_PRINTF("PlantCareRobot: 已浇水但仍缺水 (%.1f%%)，继续提醒\n", status.soilMoisture);
+        return;
+    }
+    
+    DEBUG_PRINTLN("PlantCareRobot: 缺水已解除");
+    wateringDetector.disarm();
+    interactionController.stopActiveAlert();
+    interactionController.getFeedbackManager().celebrateWaterProblemSolved();
+}
+
+/**
+ * 按环境光判断昼夜 (补光灯开启时使用扣除灯光后的环境光估计)
+ */
+void PlantCareRobot::updateNightMode() {
+    if (!nightMode.wantsSample()) {
+        return;
+    }
+    
+    float lux = sensorManager.getLightIntensity();
+    if (growLight.getDuty() > 0) {
+        lux = growLight.getStatus().ambientPpfd / LUX_TO_PPFD;
+    }
+    nightMode.onLightSample(lux);
+}
+
+/**
+ * 低功耗模式下的浅睡眠：睡到下一次采集前的传感器上电时刻 (或协程到期)，按键可提前唤醒。
+ * USB供电时不睡眠 (浅睡眠会断开USB串口)，有外设通电或协程待运行时也不睡眠
+ */
+void PlantCareRobot::sleepWhenIdle() {
+#if LIGHT_SLEEP_ENABLED
+    if (currentMode != SystemMode::LOW_POWER || powerManager.isUSBConnected() || sensorPowered) {
+        return;
+    }
+    for (size_t i = 0; i < (size_t)PowerDomain::COUNT; i++) {
+        if (PowerDomainManager::getStatus((PowerDomain)i).powered) {
+            return;
+        }
+    }
+    
+    unsigned long sleepMs = LIGHT_SLEEP_MAX_MS;
+    unsigned long untilAcquire = pipeline.getTimeToNextRun(PipelineStage::ACQUIRE);
+    untilAcquire = untilAcquire > SENSOR_POWER_LEAD_MS ? untilAcquire - SENSOR_POWER_LEAD_MS : 0;
+    sleepMs = min(sleepMs, untilAcquire);
+    sleepMs = min(sleepMs, CoScheduler::getTimeToNextWake());
+    
+    // 日程事件 (零点、时段边界、定时任务) 按墙上时钟直接算出唤醒时间
+    if (scheduler.isTimeSynced()) {
+        sleepMs = min(sleepMs, scheduler.getMsUntilNextEvent());
+    }
+    if (sleepMs < LIGHT_SLEEP_MIN_MS) {
+        return;
+    }
+    
+    Serial.flush();
+    gpioEventManager.lightSleep(sleepMs);
+#endif
+}
+
+/**
+ * 夜间模式切换：熄灭状态灯、静音非关键音效 (采集间隔在updatePipelineRate中按倍数拉长)
+ */
+void PlantCareRobot::onNightModeChange(bool night) {
+    if (instance == nullptr) {
+        return;
+    }
+    
+    instance->interactionController.setNightMode(night);
+    if (instance->communication != nullptr) {
+        instance->communication->setUploadsDeferred(instance->nightMode.shouldDeferUploads());
+    }
+}
+
+/**
+ * 本地零点：补光DLI、水泵日限额和采集统计按自然日清零，
+ * 当日分布草图留作报告，允许上传时上传
+ */
+void PlantCareRobot::onDayRollover(int yearDay) {
+    if (instance == nullptr) {
+        return;
+    }
+    
+    instance->growLight.onNewDay();
+    instance->watering.resetDailyCounters();
+    
+    CollectionStats stats = instance->dataCollectionManager.getStats();
+    DEBUG_PRINTF("PlantCareRobot: 昨日采集 %lu 次，成功率 %.1f%%\n",
+                 stats.totalCollections, stats.successRate);
+    instance->dataCollectionManager.resetStats();
+    
+    if (instance->dataCollectionManager.getDistribution(DistributionChannel::SOIL_MOISTURE).getCount() > 0) {
+        instance->pendingDistributionReport = instance->dataCollectionManager.getDistributionReport();
+    }
+    instance->dataCollectionManager.resetDistributions();
+}
+
+/**
+ * 时段进入/退出
+ */
+void PlantCareRobot::onScheduleWindow(int windowId, bool active) {
+    if (instance == nullptr) {
+        return;
+    }
+    
+    if (windowId == instance->quietWindowId) {
+        instance->interactionController.getSoundController().setQuietHoursActive(active);
+    } else if (windowId == instance->uploadWindowId && active) {
+        // 上传时段开始时不等攒够一批
+        instance->pipeline.flush(PipelineStage::PUBLISH);
+    }
+}
+
+/**
+ * 每日汇总：输出当日补光与浇水情况，植物需要照料时再显示一次状态
+ */
+void PlantCareRobot::onDailyReport(int jobId) {
+    if (instance == nullptr) {
+        return;
+    }
+    
+    GrowLightStatus light = instance->growLight.getStatus();
+    DEBUG_PRINTF("PlantCareRobot: 今日DLI %.2f/%.2f (补光 %lus)\n",
+                 light.dliAccumulated, light.dliTarget, light.lampSecondsToday);
+    DEBUG_PRINTLN("PlantCareRobot: 浇水 " + instance->watering.getInfo());
+    
+    const QuantileSketch& soil = instance->dataCollectionManager.getDistribution(DistributionChannel::SOIL_MOISTURE);
+    if (soil.getCount() > 0) {
+        DEBUG_PRINTF("PlantCareRobot: 土壤湿度 P10/P50/P90 %.1f/%.1f/%.1f%%，%.0f%%的样本低于阈值\n",
+                     soil.getQuantile(0.1f), soil.getQuantile(0.5f), soil.getQuantile(0.9f),
+                     soil.getRank(MOISTURE_THRESHOLD) * 100);
+    }
+    
+#if TOUCH_LATENCY_TRACE_ENABLED
+    if (TouchLatencyTracer::getTraceCount() > 0) {
+        DEBUG_PRINTLN("PlantCareRobot: 触摸延迟 " + TouchLatencyTracer::getInfo());
+        TouchLatencyTracer::reset();
+    }
+#endif
+    
+    if (instance->getCurrentPlantStatus().needsAttention) {
+        instance->showCurrentStatus();
+    }
+}
+
+void PlantCareRobot::onWateringEvent(const WateringEvent& event) {
+    if (instance == nullptr) {
+        return;
+    }
+    
+    DEBUG_PRINTF("PlantCareRobot: 浇水完成 %.1f%% -> %.1f%%\n", event.moistureBefore, event.moistureAfter);
+    instance->interactionController.triggerEvent(InteractionEvent::PROBLEM_SOLVED);
+}
+
+void PlantCareRobot::onWateringFault(WateringFault fault) {
+    if (instance == nullptr) {
+        return;
+    }
+    
+    if (fault == WateringFault::DRY_RUN) {
+        instance->interactionController.triggerEvent(InteractionEvent::ERROR_OCCURRED);
     }
 }
 
@@ -216,6 +738,11 @@ void PlantCareRobot::performMaintenance() {
     if (currentTime - lastMaintenance > 60000) {
         lastMaintenance = currentTime;
         
+        // 上传时段内上传昨日分布报告
+        if (isUploadAllowed()) {
+            publishPendingReport();
+        }
+        
         // 检查系统健康状态
         if (!checkSystemHealth()) {
             errorCount++;
@@ -305,6 +832,12 @@ SensorData PlantCareRobot::getLatestSensorData() {
 void PlantCareRobot::handleTouchEvent() {
     DEBUG_PRINTLN("PlantCareRobot: 处理触摸事件");
     
+    // 水泵空转锁定后，用户补水并触摸确认即解除
+    if (watering.getState() == WateringState::LOCKED_OUT) {
+        watering.clearFault();
+        DEBUG_PRINTLN("PlantCareRobot: 浇水锁定已解除");
+    }
+    
     // 如果正在主动提醒，确认提醒
     if (interactionController.getAlertManager().isCurrentlyAlerting()) {
         interactionController.acknowledgeActiveAlert();
@@ -319,6 +852,38 @@ void PlantCareRobot::handleTouchEvent() {
     }
 }
 
+/**
+ * 用户按键事件：按下时等同于触摸确认
+ */
+void PlantCareRobot::onUserButtonEvent(const GpioEvent& event) {
+    if (instance == nullptr || event.level != LOW) {
+        return;
+    }
+    instance->handleTouchEvent();
+}
+
+/**
+ * 电源模式变化：USB接入或电量恢复时立即退出低功耗模式
+ */
+void PlantCareRobot::onPowerModeChange(PowerMode mode) {
+    if (instance == nullptr || !instance->isInitialized) {
+        return;
+    }
+    
+    // 省电时拉长心跳间隔
+    if (instance->communication != nullptr) {
+        instance->communication->setPowerMode(mode);
+    }
+    
+    if (mode == PowerMode::NORMAL) {
+        if (instance->currentMode == SystemMode::LOW_POWER) {
+            instance->resumeNormalMode();
+        }
+    } else if (instance->currentMode == SystemMode::NORMAL) {
+        instance->enterLowPowerMode();
+    }
+}
+
 void PlantCareRobot::enterConfigurationMode() {
     setMode(SystemMode::CONFIGURATION);
     DEBUG_PRINTLN("PlantCareRobot: 进入配置模式");
@@ -349,6 +914,27 @@ void PlantCareRobot::restart() {
     ESP.restart();
 }
 
+bool PlantCareRobot::runFactoryTest() {
+    if (!isInitialized) {
+        FactoryTest::printAbortRecord(Serial, lastError.length() > 0 ? lastError.c_str() : "not_initialized");
+        return false;
+    }
+    
+    DEBUG_PRINTLN("PlantCareRobot: 开始工厂测试");
+    factoryTest.start();
+    
+    // 只推进检测需要的部分：协程、功放释放和电源域，不运行动画和采集
+    do {
+        CoScheduler::update();
+        interactionController.getSoundController().update();
+        PowerDomainManager::update();
+        delay(1);
+    } while (factoryTest.update());
+    
+    factoryTest.printRecord(Serial);
+    return factoryTest.passed();
+}
+
 String PlantCareRobot::getSystemInfo() {
     String info = "{\n";
     info += "  \"device\": \"PlantCareRobot\",\n";
@@ -360,6 +946,8 @@ String PlantCareRobot::getSystemInfo() {
     info += "  \"errorCount\": " + String(errorCount) + ",\n";
     info += "  \"lastError\": \"" + lastError + "\",\n";
     info += "  \"healthy\": " + String(isSystemHealthy() ? "true" : "false") + ",\n";
+    info += "  \"memory\": " + MemoryTierManager::getInfo() + ",\n";
+    info += "  \"power_domains\": " + PowerDomainManager::getInfo() + ",\n";
     info += "  \"plantStatus\": {\n";
     
     PlantStatus status = getCurrentPlantStatus();
@@ -374,6 +962,38 @@ String PlantCareRobot::getSystemInfo() {
     return info;
 }
 
+void PlantCareRobot::setQuietHours(uint8_t startHour, uint8_t startMinute, uint8_t endHour, uint8_t endMinute) {
+    interactionController.getSoundController().setQuietHours(startHour, startMinute, endHour, endMinute);
+    scheduler.setWindow(quietWindowId, startHour, startMinute, endHour, endMinute, SCHEDULE_EVERY_DAY);
+}
+
+bool PlantCareRobot::isUploadAllowed() const {
+    if (nightMode.shouldDeferUploads()) {
+        return false;
+    }
+    return !scheduler.isTimeSynced() || scheduler.isWindowActive(uploadWindowId);
+}
+
+void PlantCareRobot::setDataPublisher(DataPublisher publisher) {
+    dataPublisher = publisher;
+}
+
+void PlantCareRobot::setReportPublisher(ReportPublisher publisher) {
+    reportPublisher = publisher;
+}
+
+void PlantCareRobot::attachCommunication(CommunicationProtocol* comm) {
+    communication = comm;
+    if (communication != nullptr) {
+        communication->setUploadsDeferred(nightMode.shouldDeferUploads());
+        communication->setPowerMode(powerManager.getPowerMode());
+    }
+}
+
+String PlantCareRobot::getPipelineInfo() const {
+    return pipeline.getInfo();
+}
+
 String PlantCareRobot::getLastError() const {
     return lastError;
 }
@@ -441,4 +1061,32 @@ void PlantCareRobot::showCurrentStatus() {
             interactionController.showUnknownState();
             break;
     }
+}
+
+/**
+ * 应用设备配置
+ */
+void PlantCareRobot::applyDeviceConfiguration(const DeviceConfiguration& config) {
+    LEDController& leds = interactionController.getLEDController();
+    
+    if (!leds.setLedCount(config.ledCount)) {
+        DEBUG_PRINTF("✗ 灯带配置无效，保持 %u 颗LED\n", leds.getLedCount());
+        return;
+    }
+    
+    // 前段为状态显示，剩余部分作为补光灯环
+    uint16_t statusCount = config.statusLedCount < leds.getLedCount() ? config.statusLedCount : leds.getLedCount();
+    leds.defineSegment(LEDController::SEGMENT_STATUS, 0, statusCount);
+    if (statusCount < leds.getLedCount()) {
+        leds.defineSegment(LEDController::SEGMENT_GROW, statusCount, leds.getLedCount() - statusCount);
+    } else {
+        leds.removeSegment(LEDController::SEGMENT_GROW);
+    }
+    
+    DEBUG_PRINTF("灯带配置: 共%u颗，状态%u颗\n", leds.getLedCount(), statusCount);
+    
+    growLight.setTarget(config.dliTarget);
+    
+    watering.setThreshold(config.moistureThreshold);
+    watering.setEnabled(config.autoWatering);
 }
\ No newline at end of file
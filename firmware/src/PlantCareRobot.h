@@ -12,8 +12,25 @@
 #include "StateManager.h"
 #include "InteractionController.h"
 #include "AlertManager.h"
+#include "GpioEventManager.h"
+#include "PowerManager.h"
+#include "GrowLightController.h"
+#include "WateringController.h"
+#include "WateringEventDetector.h"
+#include "NightModeController.h"
+#include "ScheduleManager.h"
+#include "DataPipeline.h"
+#include "StatePersistence.h"
+#include "ConfigurationManager.h"
+#include "MemoryTier.h"
+#include "PowerDomain.h"
+#include "Coroutine.h"
+#include "FactoryTest.h"
+#include "TouchLatencyTracer.h"
 #include "config.h"
 
+class CommunicationProtocol;
+
 /**
  * 系统运行模式
  */
@@ -26,6 +43,20 @@ enum class SystemMode {
     OFFLINE         // 离线模式
 };
 
+/**
+ * 数据上传函数类型 (由持有网络连接的模块提供)
+ * @param sample 管道样本
+ * @return 是否已送出 (false时稍后重试)
+ */
+typedef bool (*DataPublisher)(const PipelineSample& sample);
+
+/**
+ * 每日报告上传函数类型 (每日分布草图等)
+ * @param report JSON格式的报告
+ * @return 是否已送出 (false时在下一次维护检查时重试)
+ */
+typedef bool (*ReportPublisher)(const String& report);
+
 /**
  * 植物养护机器人主控制类
  */
@@ -36,26 +67,72 @@ private:
     DataCollectionManager dataCollectionManager;
     StateManager stateManager;
     InteractionController interactionController;
+    GpioEventManager gpioEventManager;
+    PowerManager powerManager;
+    GrowLightController growLight;
+    WateringController watering;
+    WateringEventDetector wateringDetector;
+    NightModeController nightMode;
+    ScheduleManager scheduler;
+    DataPipeline pipeline;
+    StatePersistence statePersistence;
+    FactoryTest factoryTest;
+    DataPublisher dataPublisher;
+    ReportPublisher reportPublisher;
+    CommunicationProtocol* communication;
+    String pendingDistributionReport;   // 昨日分布报告，允许上传时由维护检查上传
+    
+    // GPIO/电源事件回调使用的实例指针
+    static PlantCareRobot* instance;
     
     // 系统状态
     SystemMode currentMode;
     bool isInitialized;
     bool isFirstBoot;
-    unsigned long lastDataCollection;
     unsigned long lastHeartbeat;
+    bool sensorPowered;         // 已为下一次采集申请传感器电源
     
     // 错误处理
     int errorCount;
     String lastError;
     
+    // 日程时段编号
+    int quietWindowId;
+    int uploadWindowId;
+    
     // 私有方法
-    void performDataCollection();
+    void configurePipeline();
+    void updatePipelineRate();
+    void updateSensorPower();
+    void updateGrowLight();
+    void updateWatering();
+    void updateWateringDetector();
+    void handleWateringDetected(float moistureBefore, float moistureAfter);
+    void updateNightMode();
+    void sleepWhenIdle();
     void updateSystemState();
+    void publishPendingReport();
     void handleAlerts();
     void performMaintenance();
     bool checkSystemHealth();
     void handleError(const String& error);
     void resetSystem();
+    static void onUserButtonEvent(const GpioEvent& event);
+    static void onPowerModeChange(PowerMode mode);
+    static void onWateringEvent(const WateringEvent& event);
+    static void onWateringFault(WateringFault fault);
+    static void onWateringDetected(float moistureBefore, float moistureAfter);
+    static void onNightModeChange(bool night);
+    static void onDayRollover(int yearDay);
+    static void onScheduleWindow(int windowId, bool active);
+    static void onDailyReport(int jobId);
+    static StageResult acquireStage(PipelineSample& sample);
+    static StageResult filterStage(PipelineSample& sample);
+    static StageResult deriveStage(PipelineSample& sample);
+    static StageResult evaluateStage(PipelineSample& sample);
+    static StageResult alertStage(PipelineSample& sample);
+    static StageResult persistStage(PipelineSample& sample);
+    static StageResult publishStage(PipelineSample& sample);
 
 public:
     /**
@@ -124,6 +201,51 @@ public:
      */
     void showCurrentStatus();
     
+    /**
+     * 应用设备配置 (灯带LED数量与分段、补光目标、自动浇水)
+     * @param config 设备配置
+     */
+    void applyDeviceConfiguration(const DeviceConfiguration& config);
+    
+    /**
+     * 设置静音时段 (静音时段内仅播放关键音效)
+     * @param startHour 开始小时
+     * @param startMinute 开始分钟
+     * @param endHour 结束小时
+     * @param endMinute 结束分钟
+     */
+    void setQuietHours(uint8_t startHour, uint8_t startMinute, uint8_t endHour, uint8_t endMinute);
+    
+    /**
+     * 当前是否允许上传数据 (上传时段内且未因夜间模式推迟；未同步网络时间时不限制时段)
+     * @return 是否允许上传
+     */
+    bool isUploadAllowed() const;
+    
+    /**
+     * 设置数据上传函数 (未设置时上传阶段直接丢弃样本)
+     * @param publisher 上传函数
+     */
+    void setDataPublisher(DataPublisher publisher);
+    
+    /**
+     * 设置每日报告上传函数 (未设置时每日分布报告不上传)
+     * @param publisher 上传函数
+     */
+    void setReportPublisher(ReportPublisher publisher);
+    
+    /**
+     * 关联通信协议 (夜间推迟上传、电源模式等状态随之同步；未关联时只在本地生效)
+     * @param comm 通信协议实例
+     */
+    void attachCommunication(CommunicationProtocol* comm);
+    
+    /**
+     * 获取数据管道信息 (各阶段吞吐量、耗时和队列深度)
+     * @return JSON格式的管道信息
+     */
+    String getPipelineInfo() const;
+    
     /**
      * 进入低功耗模式
      */
@@ -149,6 +271,12 @@ public:
      */
     void restart();
     
+    /**
+     * 执行工厂测试并经串口输出单行JSON结果 (阻塞到测试结束，约2秒)
+     * @return 是否全部通过
+     */
+    bool runFactoryTest();
+    
     /**
      * 获取系统信息
      * @return JSON格式的系统信息
@@ -0,0 +1,213 @@
+/**
+ * AI智能植物养护机器人 - 外设电源域管理实现
+ */
+
+#include "PowerDomain.h"
+
+PowerDomainStatus PowerDomainManager::domains[(size_t)PowerDomain::COUNT] = {};
+
+/**
+ * 电源域对应的负载开关引脚
+ */
+int PowerDomainManager::pinFor(PowerDomain domain) {
+    switch (domain) {
+        case PowerDomain::LED_STRIP: return LED_POWER_PIN;
+        case PowerDomain::AUDIO_AMP: return AUDIO_POWER_PIN;
+        case PowerDomain::SENSOR_RAIL: return SENSOR_POWER_PIN;
+        case PowerDomain::SOIL_PROBE: return SOIL_EXCITATION_PIN;
+        default: return -1;
+    }
+}
+
+/**
+ * 上电稳定时间
+ */
+unsigned long PowerDomainManager::settleTimeFor(PowerDomain domain) {
+    switch (domain) {
+        case PowerDomain::LED_STRIP: return LED_POWER_SETTLE_MS;
+        case PowerDomain::AUDIO_AMP: return AUDIO_POWER_SETTLE_MS;
+        case PowerDomain::SENSOR_RAIL: return SENSOR_POWER_SETTLE_MS;
+        case PowerDomain::SOIL_PROBE: return SOIL_EXCITATION_SETTLE_MS;
+        default: return 0;
+    }
+}
+
+/**
+ * 无人使用后的断电延迟
+ */
+unsigned long PowerDomainManager::offDelayFor(PowerDomain domain) {
+    switch (domain) {
+        case PowerDomain::LED_STRIP: return LED_POWER_OFF_DELAY;
+        case PowerDomain::AUDIO_AMP: return AUDIO_POWER_OFF_DELAY;
+        case PowerDomain::SENSOR_RAIL: return SENSOR_POWER_OFF_DELAY;
+        case PowerDomain::SOIL_PROBE: return SOIL_EXCITATION_OFF_DELAY;
+        default: return 0;
+    }
+}
+
+/**
+ * 切换负载开关并更新通电统计
+ */
+void PowerDomainManager::setPower(PowerDomain domain, bool on) {
+    PowerDomainStatus& d = domains[(size_t)domain];
+    unsigned long now = millis();
+
+    int pin = pinFor(domain);
+    if (pin >= 0) {
+        digitalWrite(pin, on ? POWER_SWITCH_ACTIVE_LEVEL : !POWER_SWITCH_ACTIVE_LEVEL);
+    }
+
+    if (on) {
+        d.powered = true;
+        d.poweredAt = now;
+        d.readyAt = now + settleTimeFor(domain);
+        d.powerCycles++;
+    } else {
+        d.powered = false;
+        d.onTime += now - d.poweredAt;
+    }
+    d.offPending = false;
+
+    DEBUG_PRINTF("PowerDomain: %s %s\n", getDomainName(domain), on ? "上电" : "断电");
+}
+
+/**
+ * 配置负载开关引脚
+ */
+void PowerDomainManager::initialize() {
+    for (size_t i = 0; i < (size_t)PowerDomain::COUNT; i++) {
+        PowerDomain domain = (PowerDomain)i;
+        int pin = pinFor(domain);
+        if (pin >= 0) {
+            pinMode(pin, OUTPUT);
+            if (domains[i].users == 0) {
+                digitalWrite(pin, !POWER_SWITCH_ACTIVE_LEVEL);
+            }
+        }
+    }
+}
+
+/**
+ * 执行到期的延迟断电
+ */
+void PowerDomainManager::update() {
+    unsigned long now = millis();
+    for (size_t i = 0; i < (size_t)PowerDomain::COUNT; i++) {
+        PowerDomainStatus& d = domains[i];
+        if (d.offPending && d.users == 0 && (long)(now - d.offAt) >= 0) {
+            setPower((PowerDomain)i, false);
+        }
+    }
+}
+
+/**
+ * 申请使用电源域
+ */
+void PowerDomainManager::acquire(PowerDomain domain) {
+    PowerDomainStatus& d = domains[(size_t)domain];
+    if (d.users < 255) {
+        d.users++;
+    }
+    d.offPending = false;
+
+    if (!d.powered) {
+        setPower(domain, true);
+    }
+}
+
+/**
+ * 释放电源域
+ */
+void PowerDomainManager::release(PowerDomain domain) {
+    PowerDomainStatus& d = domains[(size_t)domain];
+    if (d.users == 0) {
+        DEBUG_PRINTF("PowerDomain: %s 释放次数多于申请次数\n", getDomainName(domain));
+        return;
+    }
+
+    d.users--;
+    if (d.users > 0 || !d.powered) {
+        return;
+    }
+
+    unsigned long delayMs = offDelayFor(domain);
+    if (delayMs == 0) {
+        setPower(domain, false);
+    } else {
+        d.offPending = true;
+        d.offAt = millis() + delayMs;
+    }
+}
+
+/**
+ * 电源域是否就绪
+ */
+bool PowerDomainManager::isReady(PowerDomain domain) {
+    if (pinFor(domain) < 0) {
+        return true;
+    }
+    const PowerDomainStatus& d = domains[(size_t)domain];
+    return d.powered && (long)(millis() - d.readyAt) >= 0;
+}
+
+/**
+ * 距离电源域就绪的时间
+ */
+unsigned long PowerDomainManager::getTimeUntilReady(PowerDomain domain) {
+    if (pinFor(domain) < 0) {
+        return 0;
+    }
+    const PowerDomainStatus& d = domains[(size_t)domain];
+    if (!d.powered) {
+        return settleTimeFor(domain);
+    }
+    long remaining = (long)(d.readyAt - millis());
+    return remaining > 0 ? remaining : 0;
+}
+
+/**
+ * 获取电源域状态
+ */
+PowerDomainStatus PowerDomainManager::getStatus(PowerDomain domain) {
+    return domains[(size_t)domain];
+}
+
+/**
+ * 获取各电源域信息
+ */
+String PowerDomainManager::getInfo() {
+    DynamicJsonDocument doc(768);
+    unsigned long now = millis();
+
+    for (size_t i = 0; i < (size_t)PowerDomain::COUNT; i++) {
+        PowerDomain domain = (PowerDomain)i;
+        const PowerDomainStatus& d = domains[i];
+        unsigned long onTime = d.onTime + (d.powered ? now - d.poweredAt : 0);
+
+        JsonObject o = doc.createNestedObject(getDomainName(domain));
+        o["gated"] = pinFor(domain) >= 0;
+        o["users"] = d.users;
+        o["powered"] = d.powered;
+        o["ready"] = isReady(domain);
+        o["power_cycles"] = d.powerCycles;
+        o["on_time"] = onTime;
+        o["duty"] = now > 0 ? (float)onTime / now : 0.0f;
+    }
+
+    String result;
+    serializeJson(doc, result);
+    return result;
+}
+
+/**
+ * 获取电源域名称
+ */
+const char* PowerDomainManager::getDomainName(PowerDomain domain) {
+    switch (domain) {
+        case PowerDomain::LED_STRIP: return "led_strip";
+        case PowerDomain::AUDIO_AMP: return "audio_amp";
+        case PowerDomain::SENSOR_RAIL: return "sensor_rail";
+        case PowerDomain::SOIL_PROBE: return "soil_probe";
+        default: return "unknown";
+    }
+}
@@ -0,0 +1,107 @@
+/**
+ * AI智能植物养护机器人 - 外设电源域管理
+ * 灯带、功放、温湿度传感器和土壤探头激励各由一个开关供电，外设只在使用时上电：
+ *   - 引用计数：多个使用者共享同一电源域，最后一个释放后才断电
+ *   - 上电稳定：上电后经过各域的稳定时间才报告就绪，使用者在此之前不输出
+ *   - 延迟断电：释放后保持一段时间，避免动画或音效间隙反复开关
+ * 引脚配置为-1的电源域视为常供电，acquire/release只计数
+ */
+
+#ifndef POWER_DOMAIN_H
+#define POWER_DOMAIN_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "config.h"
+
+/**
+ * 电源域
+ */
+enum class PowerDomain : uint8_t {
+    LED_STRIP,          // WS2812B灯带
+    AUDIO_AMP,          // 扬声器功放
+    SENSOR_RAIL,        // 温湿度传感器
+    SOIL_PROBE,         // 土壤湿度探头激励
+    COUNT
+};
+
+/**
+ * 电源域状态
+ */
+struct PowerDomainStatus {
+    uint8_t users;              // 当前使用者数量
+    bool powered;               // 负载开关是否导通
+    bool offPending;            // 已无人使用，等待延迟断电
+    unsigned long readyAt;      // 上电稳定时刻
+    unsigned long offAt;        // 计划断电时刻
+    unsigned long poweredAt;    // 本次上电时刻
+    uint32_t powerCycles;       // 累计上电次数
+    unsigned long onTime;       // 累计通电时间 (ms，不含本次)
+};
+
+/**
+ * 电源域管理器 (全局唯一，只应在主循环中调用)
+ */
+class PowerDomainManager {
+private:
+    static PowerDomainStatus domains[(size_t)PowerDomain::COUNT];
+
+    static int pinFor(PowerDomain domain);
+    static unsigned long settleTimeFor(PowerDomain domain);
+    static unsigned long offDelayFor(PowerDomain domain);
+    static void setPower(PowerDomain domain, bool on);
+
+public:
+    /**
+     * 配置负载开关引脚，全部电源域断电
+     */
+    static void initialize();
+
+    /**
+     * 执行到期的延迟断电 (应在主循环中调用)
+     */
+    static void update();
+
+    /**
+     * 申请使用电源域 (未上电时立即上电)
+     * @param domain 电源域
+     */
+    static void acquire(PowerDomain domain);
+
+    /**
+     * 释放电源域 (最后一个使用者释放后延迟断电)
+     * @param domain 电源域
+     */
+    static void release(PowerDomain domain);
+
+    /**
+     * 电源域是否已上电且度过稳定时间
+     * @param domain 电源域
+     */
+    static bool isReady(PowerDomain domain);
+
+    /**
+     * 距离电源域就绪的时间 (ms，已就绪返回0，未申请时返回稳定时间)
+     * @param domain 电源域
+     */
+    static unsigned long getTimeUntilReady(PowerDomain domain);
+
+    /**
+     * 获取电源域状态
+     * @param domain 电源域
+     */
+    static PowerDomainStatus getStatus(PowerDomain domain);
+
+    /**
+     * 获取各电源域信息 (使用者、通电时间占比、上电次数)
+     * @return JSON格式的电源域信息
+     */
+    static String getInfo();
+
+    /**
+     * 获取电源域名称
+     */
+    static const char* getDomainName(PowerDomain domain);
+};
+
+#endif // POWER_DOMAIN_H
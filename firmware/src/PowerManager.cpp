@@ -1,8 +1,12 @@
 #include "PowerManager.h"
-#include <esp_adc_cal.h>
+#include "AdcCalibration.h"
+#include "config.h"
+
+PowerManager* PowerManager::instance = nullptr;
 
 PowerManager::PowerManager() 
   : lastUpdateTime(0)
+  , gpioEvents(nullptr)
   , bufferIndex(0)
   , bufferFilled(false)
   , lowBatteryCallback(nullptr)
@@ -47,16 +51,11 @@ void PowerManager::initializeADC() {
   analogReadResolution(12); // 12位分辨率
   analogSetAttenuation(ADC_11db); // 0-3.3V范围
   
-  // ADC校准（如果需要）
-  esp_adc_cal_characteristics_t adc_chars;
-  esp_adc_cal_value_t val_type = esp_adc_cal_characterize(
-    ADC_UNIT_1, ADC_ATTEN_DB_11, ADC_WIDTH_BIT_12, 1100, &adc_chars
-  );
+  // 使用共享的eFuse ADC校准查找表
+  AdcCalibration::begin();
   
-  if (val_type == ESP_ADC_CAL_VAL_EFUSE_VREF) {
-    Serial.println("ADC calibrated using eFuse Vref");
-  } else if (val_type == ESP_ADC_CAL_VAL_EFUSE_TP) {
-    Serial.println("ADC calibrated using eFuse Two Point");
+  if (AdcCalibration::isEfuseCalibrated()) {
+    Serial.println("ADC calibrated using eFuse data");
   } else {
     Serial.println("ADC calibrated using default reference voltage");
   }
@@ -85,19 +84,28 @@ void PowerManager::update() {
   // 获取滤波后的电压
   float filteredVoltage = getFilteredVoltage();
   
-  // 检测电源来源
-  PowerSource newPowerSource = detectPowerSource();
-  
   // 更新状态
   PowerStatus oldStatus = currentStatus;
   
   currentStatus.batteryVoltage = filteredVoltage;
   currentStatus.batteryPercentage = voltageToPercentage(filteredVoltage);
-  currentStatus.powerSource = newPowerSource;
-  currentStatus.isCharging = (newPowerSource == PowerSource::USB_POWER) && 
-                            (digitalRead(CHARGE_STATUS_PIN) == LOW);
   currentStatus.lowBatteryWarning = (currentStatus.batteryPercentage <= LOW_BATTERY_THRESHOLD);
   
+  // 未挂接GPIO事件时退回轮询电源引脚
+  if (gpioEvents == nullptr) {
+    updatePowerSource();
+  }
+  
+  applyStatusChanges(oldStatus);
+}
+
+void PowerManager::updatePowerSource() {
+  currentStatus.powerSource = detectPowerSource();
+  currentStatus.isCharging = (currentStatus.powerSource == PowerSource::USB_POWER) && 
+                            (digitalRead(CHARGE_STATUS_PIN) == LOW);
+}
+
+void PowerManager::applyStatusChanges(const PowerStatus& oldStatus) {
   // 检查电源来源变化
   if (oldStatus.powerSource != currentStatus.powerSource) {
     handlePowerSourceChange(currentStatus.powerSource);
@@ -117,13 +125,59 @@ void PowerManager::update() {
   }
 }
 
+bool PowerManager::attachGpioEvents(GpioEventManager* events) {
+  if (events == nullptr) {
+    return false;
+  }
+  
+  instance = this;
+  
+  if (!events->registerPin(USB_DETECT_PIN, INPUT, handlePowerPinEvent, POWER_PIN_DEBOUNCE_MS, true)) {
+    Serial.println("PowerManager: USB detect interrupt unavailable, keep polling");
+    return false;
+  }
+  
+  // 充电状态引脚与触摸传感器共用时不挂中断，充电状态随USB事件和电压采样刷新
+  if (CHARGE_STATUS_PIN != TOUCH_SENSOR_PIN) {
+    events->registerPin(CHARGE_STATUS_PIN, INPUT, handlePowerPinEvent, POWER_PIN_DEBOUNCE_MS, false);
+  }
+  
+  gpioEvents = events;
+  
+  // 以当前引脚电平同步一次状态
+  PowerStatus oldStatus = currentStatus;
+  updatePowerSource();
+  applyStatusChanges(oldStatus);
+  
+  Serial.println("PowerManager: power pins switched to interrupt-driven events");
+  return true;
+}
+
+void PowerManager::handlePowerPinEvent(const GpioEvent& event) {
+  if (instance == nullptr) {
+    return;
+  }
+  
+  PowerStatus oldStatus = instance->currentStatus;
+  instance->updatePowerSource();
+  
+  // 充电状态引脚变化单独记录
+  if (event.pin == CHARGE_STATUS_PIN && instance->currentStatus.isCharging != oldStatus.isCharging) {
+    Serial.print("Charging state changed: ");
+    Serial.println(instance->currentStatus.isCharging ? "Charging" : "Not charging");
+  }
+  
+  instance->applyStatusChanges(oldStatus);
+}
+
 float PowerManager::readBatteryVoltage() {
-  // 读取ADC值
-  int adcValue = analogRead(BATTERY_ADC_PIN);
+  // 读取校准后的引脚电压 (mV)
+  uint16_t millivolts = AdcCalibration::readMillivolts(BATTERY_ADC_PIN);
   
-  // 转换为电压 (考虑分压电路)
+  // 转换为电池电压 (考虑分压电路)
   // 假设使用2:1分压电路，实际电池电压是测量值的2倍
-  float voltage = (adcValue / 4095.0f) * 3.3f * 2.0f * adcCalibrationFactor;
+  // adcCalibrationFactor 仅用于修正分压电阻误差
+  float voltage = millivolts * 0.002f * adcCalibrationFactor;
   
   return voltage;
 }
@@ -2,6 +2,7 @@
 #define POWER_MANAGER_H
 
 #include <Arduino.h>
+#include "GpioEventManager.h"
 
 /**
  * 电源管理器
@@ -47,7 +48,12 @@ private:
   
   PowerStatus currentStatus;
   unsigned long lastUpdateTime;
-  static const unsigned long UPDATE_INTERVAL = 30000; // 30秒更新间隔
+  static const unsigned long UPDATE_INTERVAL = 30000; // 30秒电压采样间隔
+  static const uint32_t POWER_PIN_DEBOUNCE_MS = 50;   // 电源引脚防抖时间
+  
+  // GPIO事件 (挂接后电源来源由引脚中断驱动，不再轮询)
+  static PowerManager* instance;
+  GpioEventManager* gpioEvents;
   
   // 电压滤波器
   static const int VOLTAGE_SAMPLES = 10;
@@ -69,6 +75,9 @@ public:
   // 更新电源状态
   void update();
   
+  // 挂接GPIO事件层，USB检测和充电状态改为中断驱动
+  bool attachGpioEvents(GpioEventManager* events);
+  
   // 获取电源状态
   PowerStatus getPowerStatus() const;
   float getBatteryVoltage() const;
@@ -107,12 +116,15 @@ private:
   float getFilteredVoltage();
   int voltageToPercentage(float voltage) const;
   PowerSource detectPowerSource();
+  void updatePowerSource();
+  void applyStatusChanges(const PowerStatus& oldStatus);
+  static void handlePowerPinEvent(const GpioEvent& event);
   void updatePowerMode();
   void handleLowBattery();
   void handlePowerSourceChange(PowerSource newSource);
   void handlePowerModeChange(PowerMode newMode);
   
-  // ADC校准
+  // 分压电路校准系数 (ADC本身的校准由AdcCalibration完成)
   float adcCalibrationFactor;
   void initializeADC();
 };
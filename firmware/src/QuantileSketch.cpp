@@ -0,0 +1,301 @@
+/**
+ * AI智能植物养护机器人 - 分位数草图实现
+ */
+
+#include "QuantileSketch.h"
+#include <algorithm>
+#include <string.h>
+
+/**
+ * 构造函数
+ */
+QuantileSketch::QuantileSketch() {
+    reset();
+}
+
+/**
+ * 清空草图
+ */
+void QuantileSketch::reset() {
+    levelCount = 1;
+    levelEnd[0] = 0;
+    count = 0;
+    minValue = NAN;
+    maxValue = NAN;
+    saturated = false;
+}
+
+/**
+ * 第h层的起始位置
+ */
+uint8_t QuantileSketch::levelStart(uint8_t level) const {
+    return level == 0 ? 0 : levelEnd[level - 1];
+}
+
+/**
+ * 第h层的样本数
+ */
+uint8_t QuantileSketch::levelSize(uint8_t level) const {
+    return levelEnd[level] - levelStart(level);
+}
+
+/**
+ * 保留的样本总数
+ */
+uint8_t QuantileSketch::retained() const {
+    return levelEnd[levelCount - 1];
+}
+
+/**
+ * 第h层容量：顶层为K，向下每层乘以2/3，最少2个
+ */
+uint8_t QuantileSketch::capacityOf(uint8_t level) const {
+    int depth = levelCount - level - 1;
+    return (uint8_t)ceilf(QUANTILE_SKETCH_K * powf(2.0f / 3.0f, depth)) + 1;
+}
+
+/**
+ * 当前层数下的保留上限
+ */
+uint16_t QuantileSketch::maxRetained() const {
+    uint16_t total = 0;
+    for (uint8_t h = 0; h < levelCount; h++) {
+        total += capacityOf(h);
+    }
+    return total;
+}
+
+/**
+ * 增加一层 (新的顶层)
+ */
+bool QuantileSketch::addLevel() {
+    if (levelCount >= QUANTILE_SKETCH_MAX_LEVELS) {
+        return false;
+    }
+    levelEnd[levelCount] = levelEnd[levelCount - 1];
+    levelCount++;
+    return true;
+}
+
+/**
+ * 在第h层末尾插入一个样本
+ */
+bool QuantileSketch::insertAt(uint8_t level, float value) {
+    uint8_t total = retained();
+    if (total >= QUANTILE_SKETCH_CAPACITY) {
+        return false;
+    }
+
+    uint8_t pos = levelEnd[level];
+    memmove(&items[pos + 1], &items[pos], (total - pos) * sizeof(float));
+    items[pos] = value;
+    for (uint8_t h = level; h < levelCount; h++) {
+        levelEnd[h]++;
+    }
+    return true;
+}
+
+/**
+ * 压缩第h层：排序后随机保留一半升到h+1层 (调用前须已有h+1层)
+ * 样本数为奇数时最小的一个留在本层，总权重保持不变
+ */
+void QuantileSketch::compact(uint8_t level) {
+    uint8_t start = levelStart(level);
+    uint8_t end = levelEnd[level];
+    uint8_t total = retained();
+    std::sort(&items[start], &items[end]);
+
+    uint8_t keep = (end - start) & 1;
+    uint8_t pairs = (end - start - keep) / 2;
+    uint8_t offset = random(2);
+    for (uint8_t i = 0; i < pairs; i++) {
+        items[start + keep + i] = items[start + keep + offset + 2 * i];
+    }
+
+    // 升上去的样本紧接着成为上一层的开头，移走多余的空位
+    memmove(&items[start + keep + pairs], &items[end], (total - end) * sizeof(float));
+    levelEnd[level] = start + keep;
+    for (uint8_t h = level + 1; h < levelCount; h++) {
+        levelEnd[h] -= pairs;
+    }
+}
+
+/**
+ * 从最低层开始压缩超出容量的层，直到总量低于上限
+ */
+bool QuantileSketch::compress() {
+    while (retained() >= maxRetained()) {
+        uint8_t level = 0;
+        while (level < levelCount && levelSize(level) < capacityOf(level)) {
+            level++;
+        }
+        if (level >= levelCount) {
+            return true;
+        }
+        if (level + 1 >= levelCount && !addLevel()) {
+            saturated = true;
+            return false;
+        }
+        compact(level);
+    }
+    return true;
+}
+
+/**
+ * 加入一个样本
+ */
+void QuantileSketch::add(float value) {
+    if (isnan(value)) {
+        return;
+    }
+
+    count++;
+    if (count == 1 || value < minValue) {
+        minValue = value;
+    }
+    if (count == 1 || value > maxValue) {
+        maxValue = value;
+    }
+
+    if (!saturated && insertAt(0, value)) {
+        compress();
+    }
+}
+
+/**
+ * 合并另一份草图
+ */
+bool QuantileSketch::merge(const QuantileSketch& other) {
+    if (other.count == 0) {
+        return true;
+    }
+
+    while (levelCount < other.levelCount) {
+        if (!addLevel()) {
+            return false;
+        }
+    }
+
+    for (uint8_t h = 0; h < other.levelCount; h++) {
+        for (uint8_t i = other.levelStart(h); i < other.levelEnd[h]; i++) {
+            if (saturated || !insertAt(h, other.items[i]) || !compress()) {
+                return false;
+            }
+        }
+    }
+
+    if (count == 0 || other.minValue < minValue) {
+        minValue = other.minValue;
+    }
+    if (count == 0 || other.maxValue > maxValue) {
+        maxValue = other.maxValue;
+    }
+    count += other.count;
+    return true;
+}
+
+/**
+ * 查询分位数：按值排序后累加权重，到达 q × 总权重 的样本即为结果
+ */
+float QuantileSketch::getQuantile(float q) const {
+    if (count == 0) {
+        return NAN;
+    }
+    if (q <= 0) {
+        return minValue;
+    }
+    if (q >= 1) {
+        return maxValue;
+    }
+
+    struct WeightedItem {
+        float value;
+        uint32_t weight;
+    };
+    WeightedItem sorted[QUANTILE_SKETCH_CAPACITY];
+    uint8_t n = 0;
+    uint32_t totalWeight = 0;
+    for (uint8_t h = 0; h < levelCount; h++) {
+        for (uint8_t i = levelStart(h); i < levelEnd[h]; i++) {
+            sorted[n++] = {items[i], (uint32_t)1 << h};
+            totalWeight += (uint32_t)1 << h;
+        }
+    }
+    std::sort(sorted, sorted + n, [](const WeightedItem& a, const WeightedItem& b) {
+        return a.value < b.value;
+    });
+
+    float target = q * totalWeight;
+    uint32_t cumulative = 0;
+    for (uint8_t i = 0; i < n; i++) {
+        cumulative += sorted[i].weight;
+        if (cumulative >= target) {
+            return sorted[i].value;
+        }
+    }
+    return maxValue;
+}
+
+/**
+ * 查询不大于给定值的样本比例
+ */
+float QuantileSketch::getRank(float value) const {
+    uint32_t below = 0;
+    uint32_t totalWeight = 0;
+    for (uint8_t h = 0; h < levelCount; h++) {
+        for (uint8_t i = levelStart(h); i < levelEnd[h]; i++) {
+            totalWeight += (uint32_t)1 << h;
+            if (items[i] <= value) {
+                below += (uint32_t)1 << h;
+            }
+        }
+    }
+    return totalWeight > 0 ? (float)below / totalWeight : 0.0f;
+}
+
+/**
+ * 获取样本数
+ */
+uint32_t QuantileSketch::getCount() const {
+    return count;
+}
+
+/**
+ * 获取最小值
+ */
+float QuantileSketch::getMin() const {
+    return minValue;
+}
+
+/**
+ * 获取最大值
+ */
+float QuantileSketch::getMax() const {
+    return maxValue;
+}
+
+/**
+ * 获取保留的样本数
+ */
+uint8_t QuantileSketch::getRetainedCount() const {
+    return retained();
+}
+
+/**
+ * 写入上传格式
+ */
+void QuantileSketch::toJson(JsonObject out, float scale) const {
+    out["n"] = count;
+    out["min"] = minValue;
+    out["max"] = maxValue;
+    out["k"] = QUANTILE_SKETCH_K;
+    out["scale"] = scale;
+
+    JsonArray levels = out.createNestedArray("levels");
+    for (uint8_t h = 0; h < levelCount; h++) {
+        JsonArray level = levels.createNestedArray();
+        for (uint8_t i = levelStart(h); i < levelEnd[h]; i++) {
+            level.add(lroundf(items[i] * scale));
+        }
+    }
+}
@@ -0,0 +1,108 @@
+/**
+ * AI智能植物养护机器人 - 分位数草图
+ * KLL草图：固定内存下近似记录一组样本的分布，可以查询任意分位数和"低于某值的比例"，
+ * 服务器可以把不同日期、不同设备的草图合并后再查询，不需要原始数据。
+ *
+ * 原理：第h层的每个样本代表 2^h 个原始样本。某层装满时排序，
+ * 随机保留奇数位或偶数位的一半升到上一层 (权重翻倍)；
+ * 越低的层容量越小 (按2/3几何递减)，总保留量约为 3K + 层数。
+ *
+ * 上传格式 (toJson)：
+ *   {"n":样本数, "min":最小值, "max":最大值, "k":K, "scale":缩放, "levels":[[第0层], [第1层], ...]}
+ * 各层数值为 round(值 × scale) 的整数，第h层每个值的权重为 2^h。
+ * 合并：逐层拼接两份草图的样本，按相同K压缩即可。
+ */
+
+#ifndef QUANTILE_SKETCH_H
+#define QUANTILE_SKETCH_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "config.h"
+
+/**
+ * 分位数草图类
+ */
+class QuantileSketch {
+private:
+    float items[QUANTILE_SKETCH_CAPACITY];
+    uint8_t levelEnd[QUANTILE_SKETCH_MAX_LEVELS];  // 第h层占 items[levelStart(h), levelEnd[h])
+    uint8_t levelCount;
+    uint32_t count;
+    float minValue;
+    float maxValue;
+    bool saturated;                                // 层数用尽 (样本过多)，之后的样本只计入n/min/max
+
+    uint8_t levelStart(uint8_t level) const;
+    uint8_t levelSize(uint8_t level) const;
+    uint8_t retained() const;
+    uint8_t capacityOf(uint8_t level) const;
+    uint16_t maxRetained() const;
+    bool addLevel();
+    bool insertAt(uint8_t level, float value);
+    bool compress();
+    void compact(uint8_t level);
+
+public:
+    /**
+     * 构造函数
+     */
+    QuantileSketch();
+
+    /**
+     * 清空草图
+     */
+    void reset();
+
+    /**
+     * 加入一个样本
+     * @param value 样本值 (NaN忽略)
+     */
+    void add(float value);
+
+    /**
+     * 合并另一份草图 (K相同)
+     * @param other 另一份草图
+     * @return 是否成功 (层数用尽时返回false)
+     */
+    bool merge(const QuantileSketch& other);
+
+    /**
+     * 查询分位数
+     * @param q 分位 (0-1)
+     * @return 近似分位数 (无样本时返回NAN)
+     */
+    float getQuantile(float q) const;
+
+    /**
+     * 查询不大于给定值的样本比例
+     * @param value 阈值
+     * @return 比例 (0-1，无样本时返回0)
+     */
+    float getRank(float value) const;
+
+    /**
+     * 获取样本数
+     */
+    uint32_t getCount() const;
+
+    /**
+     * 获取最小值/最大值 (无样本时返回NAN)
+     */
+    float getMin() const;
+    float getMax() const;
+
+    /**
+     * 获取保留的样本数
+     */
+    uint8_t getRetainedCount() const;
+
+    /**
+     * 写入上传格式
+     * @param out 目标JSON对象
+     * @param scale 数值缩放 (按所需分辨率取整，如10表示保留一位小数)
+     */
+    void toJson(JsonObject out, float scale) const;
+};
+
+#endif // QUANTILE_SKETCH_H
@@ -0,0 +1,378 @@
+/**
+ * AI智能植物养护机器人 - 日程调度器实现
+ */
+
+#include "ScheduleManager.h"
+#include <ArduinoJson.h>
+
+static const char* SCHEDULE_NAMESPACE = "schedule";
+static const long WEEK_SECONDS = 7L * 24 * 3600;
+
+/**
+ * 构造函数
+ */
+ScheduleManager::ScheduleManager()
+    : jobCount(0),
+      windowCount(0),
+      dayHookCount(0),
+      timeSynced(false),
+      jobsValidated(false),
+      currentDay(-1),
+      lastCheck(0) {
+}
+
+/**
+ * 周期性更新
+ */
+void ScheduleManager::update() {
+    unsigned long currentTime = millis();
+    if (lastCheck != 0 && currentTime - lastCheck < SCHEDULER_CHECK_INTERVAL) {
+        return;
+    }
+    lastCheck = currentTime;
+
+    time_t now = time(nullptr);
+    struct tm timeinfo;
+    localtime_r(&now, &timeinfo);
+
+    // 未同步网络时间前日期和时刻都不可信
+    if (timeinfo.tm_year < (2020 - 1900)) {
+        return;
+    }
+    if (!timeSynced) {
+        timeSynced = true;
+        DEBUG_PRINTF("日程: 本地时间 %04d-%02d-%02d %02d:%02d\n",
+                     timeinfo.tm_year + 1900, timeinfo.tm_mon + 1, timeinfo.tm_mday,
+                     timeinfo.tm_hour, timeinfo.tm_min);
+    }
+
+    checkDayRollover(timeinfo);
+    checkWindows(timeinfo);
+    checkJobs(now);
+}
+
+/**
+ * 本地日期变化时调用跨天回调
+ * 同步时间后的第一次检查只记录日期，不视为跨天
+ */
+void ScheduleManager::checkDayRollover(const struct tm& timeinfo) {
+    int day = timeinfo.tm_yday;
+    if (currentDay >= 0 && day != currentDay) {
+        DEBUG_PRINTF("日程: 新的一天 (%d)\n", day);
+        for (uint8_t i = 0; i < dayHookCount; i++) {
+            dayHooks[i](day);
+        }
+    }
+    currentDay = day;
+}
+
+/**
+ * 检查时段进入/退出
+ */
+void ScheduleManager::checkWindows(const struct tm& timeinfo) {
+    for (uint8_t i = 0; i < windowCount; i++) {
+        ScheduleWindow& window = windows[i];
+        bool active = isWindowActiveAt(window, timeinfo);
+        if (active == window.active) {
+            continue;
+        }
+
+        window.active = active;
+        DEBUG_PRINTF("日程: %s时段%s\n", window.name, active ? "开始" : "结束");
+        if (window.callback) {
+            window.callback(i, active);
+        }
+    }
+}
+
+/**
+ * 执行到期任务并计算下次执行时间
+ */
+void ScheduleManager::checkJobs(time_t now) {
+    for (uint8_t i = 0; i < jobCount; i++) {
+        ScheduleJob& job = jobs[i];
+
+        // 持久化的时间与当前规则不符 (规则修改、时钟跳变) 时重新计算
+        if (!jobsValidated && job.nextFire != 0 &&
+            (job.nextFire > now + WEEK_SECONDS || computeNextFire(job, job.nextFire - 1) != job.nextFire)) {
+            job.nextFire = 0;
+        }
+
+        if (job.nextFire == 0) {
+            job.nextFire = computeNextFire(job, now);
+            saveNextFire(job);
+            continue;
+        }
+        if (now < job.nextFire) {
+            continue;
+        }
+
+        // 休眠或断电期间错过的任务只在限定时长内补执行一次
+        bool stale = now - job.nextFire > SCHEDULER_CATCHUP_LIMIT_S;
+
+        // 先保存下次执行时间，回调中重启也不会重复执行
+        job.nextFire = computeNextFire(job, now);
+        saveNextFire(job);
+
+        if (stale) {
+            DEBUG_PRINTF("日程: 跳过过期任务 %s\n", job.name);
+            continue;
+        }
+
+        job.runCount++;
+        DEBUG_PRINTF("日程: 执行任务 %s\n", job.name);
+        if (job.callback) {
+            job.callback(i);
+        }
+    }
+    jobsValidated = true;
+}
+
+/**
+ * 保存任务的下次执行时间
+ */
+void ScheduleManager::saveNextFire(const ScheduleJob& job) {
+    preferences.begin(SCHEDULE_NAMESPACE, false);
+    preferences.putULong(job.name, (uint32_t)job.nextFire);
+    preferences.end();
+}
+
+/**
+ * 计算晚于给定时间的下一次执行时间 (按本地时间，最多向后查找一周)
+ */
+time_t ScheduleManager::computeNextFire(const ScheduleJob& job, time_t after) {
+    struct tm base;
+    localtime_r(&after, &base);
+
+    for (int d = 0; d <= 7; d++) {
+        struct tm candidate = base;
+        candidate.tm_mday += d;
+        candidate.tm_hour = job.hour;
+        candidate.tm_min = job.minute;
+        candidate.tm_sec = 0;
+        candidate.tm_isdst = -1;
+
+        // mktime规范化日期并填写星期
+        time_t fire = mktime(&candidate);
+        if (fire > after && (job.weekdays & (1 << candidate.tm_wday))) {
+            return fire;
+        }
+    }
+    return 0;
+}
+
+/**
+ * 时段在给定时刻是否生效
+ * 跨零点的时段按开始当天的星期判断
+ */
+bool ScheduleManager::isWindowActiveAt(const ScheduleWindow& window, const struct tm& timeinfo) {
+    int minute = timeinfo.tm_hour * 60 + timeinfo.tm_min;
+    int today = timeinfo.tm_wday;
+    int yesterday = (today + 6) % 7;
+
+    if (window.startMinute == window.endMinute) {
+        return window.weekdays & (1 << today);
+    }
+    if (window.startMinute < window.endMinute) {
+        return minute >= window.startMinute && minute < window.endMinute &&
+               (window.weekdays & (1 << today));
+    }
+    if (minute >= window.startMinute) {
+        return window.weekdays & (1 << today);
+    }
+    if (minute < window.endMinute) {
+        return window.weekdays & (1 << yesterday);
+    }
+    return false;
+}
+
+/**
+ * 下一次到达当天某分钟的时间 (当前分钟内则为明天)
+ */
+time_t ScheduleManager::nextMinuteOfDay(time_t now, const struct tm& timeinfo, uint16_t minuteOfDay) {
+    int current = timeinfo.tm_hour * 60 + timeinfo.tm_min;
+    int delta = ((int)minuteOfDay - current + 24 * 60) % (24 * 60);
+    if (delta == 0) {
+        delta = 24 * 60;
+    }
+    return now - timeinfo.tm_sec + delta * 60;
+}
+
+/**
+ * 添加定时任务
+ */
+int ScheduleManager::addJob(const char* name, uint8_t hour, uint8_t minute, uint8_t weekdays,
+                            ScheduleJobCallback callback) {
+    if (jobCount >= SCHEDULER_MAX_JOBS || weekdays == 0) {
+        DEBUG_PRINTF("日程: 无法添加任务 %s\n", name);
+        return -1;
+    }
+
+    ScheduleJob& job = jobs[jobCount];
+    job.name = name;
+    job.hour = hour % 24;
+    job.minute = minute % 60;
+    job.weekdays = weekdays & SCHEDULE_EVERY_DAY;
+    job.runCount = 0;
+    job.callback = callback;
+
+    // 恢复上次计算的执行时间，同步时间后校验
+    preferences.begin(SCHEDULE_NAMESPACE, true);
+    job.nextFire = (time_t)preferences.getULong(name, 0);
+    preferences.end();
+
+    jobsValidated = false;
+    return jobCount++;
+}
+
+/**
+ * 添加时段规则
+ */
+int ScheduleManager::addWindow(const char* name, uint8_t startHour, uint8_t startMinute,
+                               uint8_t endHour, uint8_t endMinute, uint8_t weekdays,
+                               ScheduleWindowCallback callback) {
+    if (windowCount >= SCHEDULER_MAX_WINDOWS) {
+        DEBUG_PRINTF("日程: 无法添加时段 %s\n", name);
+        return -1;
+    }
+
+    ScheduleWindow& window = windows[windowCount];
+    window.name = name;
+    window.active = false;
+    window.callback = callback;
+    int windowId = windowCount++;
+    setWindow(windowId, startHour, startMinute, endHour, endMinute, weekdays);
+    return windowId;
+}
+
+/**
+ * 修改时段规则
+ */
+void ScheduleManager::setWindow(int windowId, uint8_t startHour, uint8_t startMinute,
+                                uint8_t endHour, uint8_t endMinute, uint8_t weekdays) {
+    if (windowId < 0 || windowId >= windowCount) {
+        return;
+    }
+
+    ScheduleWindow& window = windows[windowId];
+    window.startMinute = (startHour % 24) * 60 + startMinute % 60;
+    window.endMinute = (endHour % 24) * 60 + endMinute % 60;
+    window.weekdays = weekdays & SCHEDULE_EVERY_DAY;
+
+    // 下次update立即重新判定
+    lastCheck = 0;
+}
+
+/**
+ * 添加跨天回调
+ */
+bool ScheduleManager::addDayRolloverHook(DayRolloverCallback callback) {
+    if (dayHookCount >= SCHEDULER_MAX_DAY_HOOKS || !callback) {
+        return false;
+    }
+    dayHooks[dayHookCount++] = callback;
+    return true;
+}
+
+/**
+ * 时段当前是否生效
+ */
+bool ScheduleManager::isWindowActive(int windowId) const {
+    if (windowId < 0 || windowId >= windowCount) {
+        return false;
+    }
+    return windows[windowId].active;
+}
+
+/**
+ * 是否已同步网络时间
+ */
+bool ScheduleManager::isTimeSynced() const {
+    return timeSynced;
+}
+
+/**
+ * 获取下一个日程事件的时间
+ */
+time_t ScheduleManager::getNextEventTime() const {
+    if (!timeSynced) {
+        return 0;
+    }
+
+    time_t now = time(nullptr);
+    struct tm timeinfo;
+    localtime_r(&now, &timeinfo);
+
+    // 零点 (跨天回调)
+    time_t next = nextMinuteOfDay(now, timeinfo, 0);
+
+    for (uint8_t i = 0; i < jobCount; i++) {
+        if (jobs[i].nextFire != 0 && jobs[i].nextFire < next) {
+            next = jobs[i].nextFire;
+        }
+    }
+
+    // 时段边界 (不区分星期，可能提前唤醒但不会错过)
+    for (uint8_t i = 0; i < windowCount; i++) {
+        const ScheduleWindow& window = windows[i];
+        if (window.startMinute == window.endMinute) {
+            continue;
+        }
+        time_t start = nextMinuteOfDay(now, timeinfo, window.startMinute);
+        time_t end = nextMinuteOfDay(now, timeinfo, window.endMinute);
+        if (start < next) {
+            next = start;
+        }
+        if (end < next) {
+            next = end;
+        }
+    }
+
+    return next;
+}
+
+/**
+ * 获取距下一个日程事件的毫秒数
+ */
+unsigned long ScheduleManager::getMsUntilNextEvent() const {
+    time_t next = getNextEventTime();
+    time_t now = time(nullptr);
+    if (next == 0 || next <= now) {
+        return 0;
+    }
+    return (unsigned long)(next - now) * 1000UL;
+}
+
+/**
+ * 获取调度信息
+ */
+String ScheduleManager::getInfo() const {
+    DynamicJsonDocument doc(1024);
+
+    time_t now = time(nullptr);
+    doc["time_synced"] = timeSynced;
+    doc["next_event_s"] = getMsUntilNextEvent() / 1000;
+
+    JsonArray jobArray = doc.createNestedArray("jobs");
+    for (uint8_t i = 0; i < jobCount; i++) {
+        JsonObject job = jobArray.createNestedObject();
+        job["name"] = jobs[i].name;
+        job["time"] = jobs[i].hour * 100 + jobs[i].minute;
+        job["weekdays"] = jobs[i].weekdays;
+        job["runs"] = jobs[i].runCount;
+        job["next_s"] = timeSynced && jobs[i].nextFire > now ? (long)(jobs[i].nextFire - now) : 0;
+    }
+
+    JsonArray windowArray = doc.createNestedArray("windows");
+    for (uint8_t i = 0; i < windowCount; i++) {
+        JsonObject window = windowArray.createNestedObject();
+        window["name"] = windows[i].name;
+        window["start"] = windows[i].startMinute;
+        window["end"] = windows[i].endMinute;
+        window["active"] = windows[i].active;
+    }
+
+    String result;
+    serializeJson(doc, result);
+    return result;
+}
@@ -0,0 +1,164 @@
+/**
+ * AI智能植物养护机器人 - 日程调度器
+ * 基于网络同步的本地时间，提供按天/按周的定时任务、时段规则 (静音、上传窗口)
+ * 和本地零点跨天回调；任务的下次执行时间持久化保存，休眠唤醒后可直接计算唤醒时间
+ */
+
+#ifndef SCHEDULE_MANAGER_H
+#define SCHEDULE_MANAGER_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <time.h>
+#include "config.h"
+
+/**
+ * 定时任务回调函数类型
+ * @param jobId 任务编号
+ */
+typedef void (*ScheduleJobCallback)(int jobId);
+
+/**
+ * 时段进入/退出回调函数类型
+ * @param windowId 时段编号
+ * @param active 是否进入时段
+ */
+typedef void (*ScheduleWindowCallback)(int windowId, bool active);
+
+/**
+ * 跨天回调函数类型
+ * @param yearDay 新的一天在年内的序号 (0-365)
+ */
+typedef void (*DayRolloverCallback)(int yearDay);
+
+/**
+ * 定时任务 (星期掩码为 SCHEDULE_EVERY_DAY 时即每日任务)
+ */
+struct ScheduleJob {
+    const char* name;               // 名称 (同时作为持久化键，不超过15字符)
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t weekdays;               // 星期掩码 (bit0 = 周日)
+    time_t nextFire;                // 下次执行时间 (0 表示未计算)
+    uint32_t runCount;
+    ScheduleJobCallback callback;
+};
+
+/**
+ * 时段规则 (可跨零点，开始等于结束表示全天)
+ */
+struct ScheduleWindow {
+    const char* name;
+    uint16_t startMinute;           // 开始 (当天零点起的分钟数)
+    uint16_t endMinute;             // 结束 (当天零点起的分钟数)
+    uint8_t weekdays;               // 时段开始当天的星期掩码
+    bool active;
+    ScheduleWindowCallback callback;
+};
+
+/**
+ * 日程调度器类
+ */
+class ScheduleManager {
+private:
+    ScheduleJob jobs[SCHEDULER_MAX_JOBS];
+    uint8_t jobCount;
+    ScheduleWindow windows[SCHEDULER_MAX_WINDOWS];
+    uint8_t windowCount;
+    DayRolloverCallback dayHooks[SCHEDULER_MAX_DAY_HOOKS];
+    uint8_t dayHookCount;
+
+    Preferences preferences;
+    bool timeSynced;
+    bool jobsValidated;
+    int currentDay;
+    unsigned long lastCheck;
+
+    void checkDayRollover(const struct tm& timeinfo);
+    void checkWindows(const struct tm& timeinfo);
+    void checkJobs(time_t now);
+    void saveNextFire(const ScheduleJob& job);
+    static time_t computeNextFire(const ScheduleJob& job, time_t after);
+    static bool isWindowActiveAt(const ScheduleWindow& window, const struct tm& timeinfo);
+    static time_t nextMinuteOfDay(time_t now, const struct tm& timeinfo, uint16_t minuteOfDay);
+
+public:
+    /**
+     * 构造函数
+     */
+    ScheduleManager();
+
+    /**
+     * 周期性更新 (按 SCHEDULER_CHECK_INTERVAL 节流)
+     * 未同步网络时间前不执行任何任务
+     */
+    void update();
+
+    /**
+     * 添加定时任务，并恢复持久化的下次执行时间
+     * @param name 名称 (不超过15字符，须为静态字符串)
+     * @param hour 小时 (0-23)
+     * @param minute 分钟 (0-59)
+     * @param weekdays 星期掩码 (SCHEDULE_EVERY_DAY、SCHEDULE_WEEKDAYS等)
+     * @param callback 执行回调
+     * @return 任务编号，失败返回-1
+     */
+    int addJob(const char* name, uint8_t hour, uint8_t minute, uint8_t weekdays, ScheduleJobCallback callback);
+
+    /**
+     * 添加时段规则
+     * @param name 名称 (须为静态字符串)
+     * @param startHour 开始小时
+     * @param startMinute 开始分钟
+     * @param endHour 结束小时
+     * @param endMinute 结束分钟
+     * @param weekdays 星期掩码
+     * @param callback 进入/退出回调
+     * @return 时段编号，失败返回-1
+     */
+    int addWindow(const char* name, uint8_t startHour, uint8_t startMinute,
+                  uint8_t endHour, uint8_t endMinute, uint8_t weekdays,
+                  ScheduleWindowCallback callback);
+
+    /**
+     * 修改时段规则 (下次检查时按新时段触发进入/退出)
+     */
+    void setWindow(int windowId, uint8_t startHour, uint8_t startMinute,
+                   uint8_t endHour, uint8_t endMinute, uint8_t weekdays);
+
+    /**
+     * 添加本地零点跨天回调
+     * @return 是否添加成功
+     */
+    bool addDayRolloverHook(DayRolloverCallback callback);
+
+    /**
+     * 时段当前是否生效 (未同步网络时间时均不生效)
+     */
+    bool isWindowActive(int windowId) const;
+
+    /**
+     * 是否已同步网络时间
+     */
+    bool isTimeSynced() const;
+
+    /**
+     * 获取下一个日程事件 (任务、时段边界、零点) 的时间
+     * @return 本地时间戳，未同步网络时间时返回0
+     */
+    time_t getNextEventTime() const;
+
+    /**
+     * 获取距下一个日程事件的毫秒数，供休眠前设置唤醒定时器
+     * @return 毫秒数，未同步网络时间时返回0
+     */
+    unsigned long getMsUntilNextEvent() const;
+
+    /**
+     * 获取调度信息
+     * @return JSON格式的信息
+     */
+    String getInfo() const;
+};
+
+#endif // SCHEDULE_MANAGER_H
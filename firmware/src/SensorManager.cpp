@@ -3,13 +3,14 @@
  */
 
 #include "SensorManager.h"
+#include "FactoryTest.h"
 #include <EEPROM.h>
 #include <ArduinoJson.h>
 
 // EEPROM地址定义
 #define EEPROM_CALIBRATION_ADDR 0
 #define EEPROM_CALIBRATION_SIZE sizeof(CalibrationData)
-#define CALIBRATION_MAGIC_NUMBER 0xABCD
+#define CALIBRATION_MAGIC_NUMBER 0xABCE  // 校准单位改为mV后更新
 
 /**
  * 构造函数
@@ -23,15 +24,20 @@ SensorManager::SensorManager()
       soilMoistureErrorCount(0),
       lightSensorErrorCount(0),
       samplingCount(5),
-      lastReadTime(0) {
+      lastReadTime(0),
+      soilProbePowered(false),
+      soilProbeWaits(0),
+      samplerTimer(nullptr),
+      sampledCount(0),
+      acquisitionActive(false) {
     
     // 初始化校准数据
     calibrationData = {
-        .soilMoistureMin = 3000,    // 默认干燥值
-        .soilMoistureMax = 1000,    // 默认湿润值
-        .lightSensorMin = 0,        // 默认黑暗值
-        .lightSensorMax = 4095,     // 默认明亮值
-        .lightConversionFactor = 2.44, // 默认转换系数
+        .soilMoistureMin = 850,     // 默认湿润电压 (mV)
+        .soilMoistureMax = 2450,    // 默认干燥电压 (mV)
+        .lightSensorMin = 0,        // 默认黑暗电压 (mV)
+        .lightSensorMax = 3100,     // 默认明亮电压 (mV)
+        .lightConversionFactor = 3.2, // 默认转换系数 (lux/mV)
         .temperatureOffset = 0.0,   // 默认无偏移
         .isCalibrated = false
     };
@@ -45,7 +51,10 @@ SensorManager::SensorManager()
  * 析构函数
  */
 SensorManager::~SensorManager() {
-    // 清理资源
+    if (samplerTimer != nullptr) {
+        esp_timer_stop(samplerTimer);
+        esp_timer_delete(samplerTimer);
+    }
 }
 
 /**
@@ -55,14 +64,42 @@ bool SensorManager::initialize() {
     DEBUG_PRINTLN("初始化传感器管理器...");
     
     // 初始化EEPROM
-    EEPROM.begin(512);
+    EEPROM.begin(EEPROM_SIZE);
     
     // 初始化ADC
     analogReadResolution(ADC_RESOLUTION);
     analogSetAttenuation(ADC_11db);
+    AdcCalibration::begin();
+    
+    // 初始化过采样滤波器和后台采样定时器 (创建失败时退回同步采样)
+    soilFilter.begin();
+    lightFilter.begin();
+    soilFilter.benchmark();
+    if (samplerTimer == nullptr) {
+        esp_timer_create_args_t timerArgs = {};
+        timerArgs.callback = samplerCallback;
+        timerArgs.arg = this;
+        timerArgs.name = "adc_sampler";
+        if (esp_timer_create(&timerArgs, &samplerTimer) != ESP_OK) {
+            DEBUG_PRINTLN("✗ ADC采样定时器创建失败，使用同步采样");
+            samplerTimer = nullptr;
+        }
+    }
+    
+    // 加载学习到的土壤探头温度系数
+    soilEstimator.begin();
     
-    // 初始化DHT22传感器
+    // 初始化DHT22传感器 (初始化和自检期间保持传感器电源)
+    PowerDomainManager::acquire(PowerDomain::SENSOR_RAIL);
     dht.begin();
+    
+    // 工厂测试模式下由FactoryTest在等待上电稳定的同时完成检测，这里不做串行等待和自检
+    if (FactoryTest::isActive()) {
+        PowerDomainManager::release(PowerDomain::SENSOR_RAIL);
+        loadCalibrationFromEEPROM();
+        return true;
+    }
+    
     delay(2000); // DHT22需要2秒启动时间
     
     // 测试DHT22
@@ -78,7 +115,9 @@ bool SensorManager::initialize() {
     }
     
     // 测试土壤湿度传感器
+    waitForSoilProbe();
     int soilTest = analogRead(SOIL_MOISTURE_PIN);
+    finishSoilReading();
     if (soilTest < 0 || soilTest > 4095) {
         DEBUG_PRINTLN("✗ 土壤湿度传感器初始化失败");
         soilMoistureStatus = SensorStatus::ERROR;
@@ -106,6 +145,7 @@ bool SensorManager::initialize() {
     
     // 执行自检
     bool selfTestResult = performSelfTest();
+    PowerDomainManager::release(PowerDomain::SENSOR_RAIL);
     
     DEBUG_PRINTF("传感器初始化完成，自检结果: %s\n", 
                  selfTestResult ? "通过" : "失败");
@@ -127,14 +167,18 @@ bool SensorManager::calibrate(bool autoCalibrate) {
         DEBUG_PRINTLN("请确保土壤湿度传感器处于干燥状态，10秒后开始校准...");
         delay(10000);
         
+        waitForSoilProbe();
         int dryValue = getMedianReading(SOIL_MOISTURE_PIN, 10);
-        DEBUG_PRINTF("干燥状态ADC值: %d\n", dryValue);
+        finishSoilReading();
+        DEBUG_PRINTF("干燥状态电压: %dmV\n", dryValue);
         
         DEBUG_PRINTLN("请将土壤湿度传感器放入水中，10秒后继续校准...");
         delay(10000);
         
+        waitForSoilProbe();
         int wetValue = getMedianReading(SOIL_MOISTURE_PIN, 10);
-        DEBUG_PRINTF("湿润状态ADC值: %d\n", wetValue);
+        finishSoilReading();
+        DEBUG_PRINTF("湿润状态电压: %dmV\n", wetValue);
         
         if (!calibrateSoilMoisture(dryValue, wetValue)) {
             DEBUG_PRINTLN("✗ 土壤湿度传感器校准失败");
@@ -146,13 +190,13 @@ bool SensorManager::calibrate(bool autoCalibrate) {
         delay(10000);
         
         int darkValue = getMedianReading(LIGHT_SENSOR_PIN, 10);
-        DEBUG_PRINTF("黑暗状态ADC值: %d\n", darkValue);
+        DEBUG_PRINTF("黑暗状态电压: %dmV\n", darkValue);
         
         DEBUG_PRINTLN("请将光感传感器置于强光下，10秒后继续校准...");
         delay(10000);
         
         int brightValue = getMedianReading(LIGHT_SENSOR_PIN, 10);
-        DEBUG_PRINTF("明亮状态ADC值: %d\n", brightValue);
+        DEBUG_PRINTF("明亮状态电压: %dmV\n", brightValue);
         
         if (!calibrateLightSensor(darkValue, brightValue, 10000.0)) {
             DEBUG_PRINTLN("✗ 光感传感器校准失败");
@@ -183,7 +227,10 @@ bool SensorManager::calibrateSoilMoisture(int dryValue, int wetValue) {
     calibrationData.soilMoistureMin = wetValue;
     calibrationData.soilMoistureMax = dryValue;
     
-    DEBUG_PRINTF("土壤湿度传感器校准: 干燥=%d, 湿润=%d\n", dryValue, wetValue);
+    // 重新校准通常意味着更换了探头，温度系数需要重新学习
+    soilEstimator.resetProbe();
+    
+    DEBUG_PRINTF("土壤湿度传感器校准: 干燥=%dmV, 湿润=%dmV\n", dryValue, wetValue);
     return true;
 }
 
@@ -200,7 +247,7 @@ bool SensorManager::calibrateLightSensor(int darkValue, int brightValue, float m
     calibrationData.lightSensorMax = brightValue;
     calibrationData.lightConversionFactor = maxLux / (brightValue - darkValue);
     
-    DEBUG_PRINTF("光感传感器校准: 黑暗=%d, 明亮=%d, 系数=%.2f\n", 
+    DEBUG_PRINTF("光感传感器校准: 黑暗=%dmV, 明亮=%dmV, 系数=%.2f\n", 
                  darkValue, brightValue, calibrationData.lightConversionFactor);
     return true;
 }
@@ -211,15 +258,27 @@ bool SensorManager::calibrateLightSensor(int darkValue, int brightValue, float m
 SensorData SensorManager::readAll() {
     currentData.timestamp = millis();
     
-    // 读取各传感器数据
-    currentData.soilHumidity = readSoilMoisture();
+    // 没有后台采集好的数据块时在此采集 (等待期间让出CPU)
+    waitForAcquisition();
+    currentData.lightIntensity = lightFromMillivolts(
+        getFilteredReading(LIGHT_SENSOR_PIN, lightBlock, lightFilter, lightSensorErrorCount));
+    currentData.soilHumidity = soilFromMillivolts(
+        getFilteredReading(SOIL_MOISTURE_PIN, soilBlock, soilFilter, soilMoistureErrorCount));
+    sampledCount = 0;
+    finishSoilReading();
+    
     currentData.airHumidity = readAirHumidity();
     currentData.temperature = readTemperature();
-    currentData.lightIntensity = readLightIntensity();
     
-    // 应用校准
+    // 应用校准 (温湿度没有读数时为NAN，土壤补偿不使用)
     applyCalibration(currentData);
     
+    // 电源未就绪时温湿度沿用上次有效值供评估 (状态保持NOT_READY)
+    if (dhtStatus == SensorStatus::NOT_READY) {
+        currentData.airHumidity = lastValidData.airHumidity;
+        currentData.temperature = lastValidData.temperature;
+    }
+    
     // 验证数据有效性
     currentData.isValid = validateSensorData(currentData);
     
@@ -240,19 +299,111 @@ SensorData SensorManager::readAll() {
 }
 
 /**
- * 读取土壤湿度
+ * 开始后台采集
  */
-float SensorManager::readSoilMoisture() {
-    int rawValue = getMedianReading(SOIL_MOISTURE_PIN, samplingCount);
+bool SensorManager::startAcquisition() {
+    // 正在采集或已有未读取的数据块
+    if (acquisitionActive || sampledCount >= ADC_OVERSAMPLE_COUNT) {
+        return true;
+    }
+    if (!isSoilReadingReady()) {
+        return false;
+    }
+    
+    sampledCount = 0;
+    acquisitionActive = true;
+    if (samplerTimer == nullptr ||
+        esp_timer_start_periodic(samplerTimer, 1000000ULL / ADC_OVERSAMPLE_RATE_HZ) != ESP_OK) {
+        sampleBlocks();
+    }
+    return true;
+}
+
+/**
+ * 后台采集是否已完成
+ */
+bool SensorManager::isAcquisitionComplete() const {
+    return !acquisitionActive && sampledCount >= ADC_OVERSAMPLE_COUNT;
+}
+
+/**
+ * 采样定时器回调 (esp_timer任务上下文)：两个通道各采一个样本，采满后停止
+ */
+void SensorManager::samplerCallback(void* arg) {
+    SensorManager* self = static_cast<SensorManager*>(arg);
+    int index = self->sampledCount;
+    if (index >= ADC_OVERSAMPLE_COUNT) {
+        return;
+    }
     
-    if (rawValue < 0) {
+    self->lightBlock[index] = AdcCalibration::readMillivolts(LIGHT_SENSOR_PIN);
+    self->soilBlock[index] = AdcCalibration::readMillivolts(SOIL_MOISTURE_PIN);
+    self->sampledCount = index + 1;
+    
+    if (index + 1 >= ADC_OVERSAMPLE_COUNT) {
+        esp_timer_stop(self->samplerTimer);
+        self->acquisitionActive = false;
+    }
+}
+
+/**
+ * 同步采集数据块 (采样定时器不可用时)
+ */
+void SensorManager::sampleBlocks() {
+    const unsigned long samplePeriod = 1000000UL / ADC_OVERSAMPLE_RATE_HZ;
+    unsigned long nextSampleTime = micros();
+    
+    for (int i = 0; i < ADC_OVERSAMPLE_COUNT; i++) {
+        long waitTime = (long)(nextSampleTime - micros());
+        if (waitTime > 0) {
+            delayMicroseconds(waitTime);
+        }
+        lightBlock[i] = AdcCalibration::readMillivolts(LIGHT_SENSOR_PIN);
+        soilBlock[i] = AdcCalibration::readMillivolts(SOIL_MOISTURE_PIN);
+        nextSampleTime += samplePeriod;
+    }
+    sampledCount = ADC_OVERSAMPLE_COUNT;
+    acquisitionActive = false;
+}
+
+/**
+ * 等待数据块采集完成 (尚未开始时先给探头上电并开始采集)
+ */
+void SensorManager::waitForAcquisition() {
+    if (isAcquisitionComplete()) {
+        return;
+    }
+    if (!acquisitionActive) {
+        waitForSoilProbe();
+        startAcquisition();
+    }
+    while (acquisitionActive) {
+        delay(1);
+    }
+}
+
+/**
+ * 读取土壤湿度 (快速读数，读完立即断开激励)
+ */
+float SensorManager::readSoilMoisture() {
+    waitForSoilProbe();
+    float millivolts = getQuickReading(SOIL_MOISTURE_PIN);
+    finishSoilReading();
+    return soilFromMillivolts(millivolts);
+}
+
+/**
+ * 土壤探头电压换算为湿度百分比
+ */
+float SensorManager::soilFromMillivolts(float millivolts) {
+    if (!isfinite(millivolts)) {
         soilMoistureErrorCount++;
         soilMoistureStatus = SensorStatus::ERROR;
         return lastValidData.soilHumidity;
     }
     
     // 转换为百分比 (注意：土壤湿度传感器值越大表示越干燥)
-    float moisture = mapFloat(rawValue, 
+    float moisture = mapFloat(millivolts, 
                              calibrationData.soilMoistureMax, 
                              calibrationData.soilMoistureMin, 
                              0.0, 100.0);
@@ -265,19 +416,24 @@ float SensorManager::readSoilMoisture() {
 }
 
 /**
- * 读取光照强度
+ * 读取光照强度 (快速读数)
  */
 float SensorManager::readLightIntensity() {
-    int rawValue = getMedianReading(LIGHT_SENSOR_PIN, samplingCount);
-    
-    if (rawValue < 0) {
+    return lightFromMillivolts(getQuickReading(LIGHT_SENSOR_PIN));
+}
+
+/**
+ * 光感电压换算为lux
+ */
+float SensorManager::lightFromMillivolts(float millivolts) {
+    if (!isfinite(millivolts)) {
         lightSensorErrorCount++;
         lightSensorStatus = SensorStatus::ERROR;
         return lastValidData.lightIntensity;
     }
     
     // 转换为lux
-    float lux = (rawValue - calibrationData.lightSensorMin) * 
+    float lux = (millivolts - calibrationData.lightSensorMin) * 
                 calibrationData.lightConversionFactor;
     
     // 限制范围
@@ -291,6 +447,12 @@ float SensorManager::readLightIntensity() {
  * 读取温度
  */
 float SensorManager::readTemperature() {
+    // 传感器电源未就绪时没有读数，不计为故障
+    if (!PowerDomainManager::isReady(PowerDomain::SENSOR_RAIL)) {
+        dhtStatus = SensorStatus::NOT_READY;
+        return NAN;
+    }
+    
     float temp = dht.readTemperature();
     
     if (isnan(temp)) {
@@ -310,6 +472,11 @@ float SensorManager::readTemperature() {
  * 读取空气湿度
  */
 float SensorManager::readAirHumidity() {
+    if (!PowerDomainManager::isReady(PowerDomain::SENSOR_RAIL)) {
+        dhtStatus = SensorStatus::NOT_READY;
+        return NAN;
+    }
+    
     float humidity = dht.readHumidity();
     
     if (isnan(humidity)) {
@@ -341,7 +508,14 @@ bool SensorManager::validateSensorData(const SensorData& data) {
 void SensorManager::applyCalibration(SensorData& data) {
     // 温度校准已在读取时应用
     // 其他传感器的校准也已在读取时应用
-    // 这里可以添加额外的校准逻辑
+    
+#if SOIL_COMP_ENABLED
+    // 土壤湿度温度补偿 (DHT22读取失败时不输入温度，只做预测和更新)
+    if (soilMoistureStatus == SensorStatus::OK) {
+        float temperature = dhtStatus == SensorStatus::OK ? data.temperature : NAN;
+        data.soilHumidity = soilEstimator.update(data.soilHumidity, temperature, data.timestamp);
+    }
+#endif
 }
 
 /**
@@ -352,14 +526,14 @@ float SensorManager::mapFloat(float value, float inMin, float inMax, float outMi
 }
 
 /**
- * 获取中位数读数
+ * 获取中位数读数 (mV)
  */
 int SensorManager::getMedianReading(int pin, int samples) {
     int readings[samples];
     
     // 采集多个样本
     for (int i = 0; i < samples; i++) {
-        readings[i] = analogRead(pin);
+        readings[i] = AdcCalibration::readMillivolts(pin);
         delay(10); // 短暂延时
     }
     
@@ -378,6 +552,91 @@ int SensorManager::getMedianReading(int pin, int samples) {
     return readings[samples / 2];
 }
 
+/**
+ * 获取过采样滤波后的读数 (mV)
+ * 对采集好的数据块 (已逐样本查表换算为毫伏) 做陷波和抽取低通后取均值
+ * 滤波器不可用时计入该通道的错误次数并退回中位数采样
+ */
+float SensorManager::getFilteredReading(int pin, const float* block, SignalFilter& filter, int& errorCount) {
+    float filtered;
+    if (!filter.filterBlock(block, ADC_OVERSAMPLE_COUNT, filtered)) {
+        errorCount++;
+        return getMedianReading(pin, samplingCount);
+    }
+    return filtered;
+}
+
+/**
+ * 获取快速读数 (mV)
+ * 样本均匀分布在一个工频周期内，平均后工频及其谐波相互抵消，无需完整的数据块
+ */
+float SensorManager::getQuickReading(int pin) {
+    const unsigned long samplePeriod = 1000000UL / (MAINS_FREQUENCY_HZ * ADC_QUICK_SAMPLE_COUNT);
+    unsigned long nextSampleTime = micros();
+    float sum = 0;
+    
+    for (int i = 0; i < ADC_QUICK_SAMPLE_COUNT; i++) {
+        long waitTime = (long)(nextSampleTime - micros());
+        if (waitTime > 0) {
+            delayMicroseconds(waitTime);
+        }
+        sum += AdcCalibration::readMillivolts(pin);
+        nextSampleTime += samplePeriod;
+    }
+    
+    return sum / ADC_QUICK_SAMPLE_COUNT;
+}
+
+/**
+ * 短读数：连续采样求平均，不对齐工频周期
+ */
+float SensorManager::getBurstReading(int pin) {
+    float sum = 0;
+    for (int i = 0; i < ADC_BURST_SAMPLE_COUNT; i++) {
+        sum += AdcCalibration::readMillivolts(pin);
+    }
+    return sum / ADC_BURST_SAMPLE_COUNT;
+}
+
+/**
+ * 提前给土壤探头激励上电
+ */
+void SensorManager::prepareSoilReading() {
+    if (!soilProbePowered) {
+        PowerDomainManager::acquire(PowerDomain::SOIL_PROBE);
+        soilProbePowered = true;
+    }
+}
+
+/**
+ * 土壤探头是否已稳定
+ */
+bool SensorManager::isSoilReadingReady() const {
+    return soilProbePowered && PowerDomainManager::isReady(PowerDomain::SOIL_PROBE);
+}
+
+/**
+ * 断开土壤探头激励
+ */
+void SensorManager::finishSoilReading() {
+    if (soilProbePowered && !acquisitionActive) {
+        PowerDomainManager::release(PowerDomain::SOIL_PROBE);
+        soilProbePowered = false;
+    }
+}
+
+/**
+ * 等待土壤探头稳定 (未提前上电时在此上电)
+ */
+void SensorManager::waitForSoilProbe() {
+    prepareSoilReading();
+    unsigned long remaining = PowerDomainManager::getTimeUntilReady(PowerDomain::SOIL_PROBE);
+    if (remaining > 0) {
+        soilProbeWaits++;
+        delay(remaining);
+    }
+}
+
 /**
  * 获取传感器状态
  */
@@ -415,7 +674,7 @@ bool SensorManager::isAllSensorsOK() const {
 String SensorManager::getErrorInfo() const {
     String errorInfo = "";
     
-    if (dhtStatus != SensorStatus::OK) {
+    if (dhtStatus != SensorStatus::OK && dhtStatus != SensorStatus::NOT_READY) {
         errorInfo += "DHT22错误(" + String(dhtErrorCount) + "); ";
     }
     if (soilMoistureStatus != SensorStatus::OK) {
@@ -495,9 +754,12 @@ bool SensorManager::performSelfTest() {
     
     bool allPassed = true;
     
-    // 测试DHT22
+    // 测试DHT22 (传感器电源未就绪时先等待上电稳定)
+    PowerDomainManager::acquire(PowerDomain::SENSOR_RAIL);
+    delay(PowerDomainManager::getTimeUntilReady(PowerDomain::SENSOR_RAIL));
     float testTemp = dht.readTemperature();
     float testHum = dht.readHumidity();
+    PowerDomainManager::release(PowerDomain::SENSOR_RAIL);
     if (isnan(testTemp) || isnan(testHum)) {
         DEBUG_PRINTLN("✗ DHT22自检失败");
         dhtStatus = SensorStatus::ERROR;
@@ -507,7 +769,9 @@ bool SensorManager::performSelfTest() {
     }
     
     // 测试土壤湿度传感器
+    waitForSoilProbe();
     int soilReading = analogRead(SOIL_MOISTURE_PIN);
+    finishSoilReading();
     if (soilReading < 0 || soilReading > 4095) {
         DEBUG_PRINTLN("✗ 土壤湿度传感器自检失败");
         soilMoistureStatus = SensorStatus::ERROR;
@@ -543,6 +807,14 @@ String SensorManager::getSensorInfo() const {
     doc["error_counts"]["dht"] = dhtErrorCount;
     doc["error_counts"]["soil"] = soilMoistureErrorCount;
     doc["error_counts"]["light"] = lightSensorErrorCount;
+    doc["dsp"]["vectorized"] = SignalFilter::isVectorized();
+    doc["dsp"]["soil_block_us"] = soilFilter.getStats().lastBlockMicros;
+    doc["dsp"]["light_block_us"] = lightFilter.getStats().lastBlockMicros;
+    doc["soil_probe_waits"] = soilProbeWaits;
+    doc["soil_compensation"]["coefficient"] = soilEstimator.getCoefficient();
+    doc["soil_compensation"]["coefficient_sd"] = soilEstimator.getCoefficientStdDev();
+    doc["soil_compensation"]["rate_per_hour"] = soilEstimator.getRate();
+    doc["soil_compensation"]["steps"] = soilEstimator.getStepCount();
     
     String result;
     serializeJson(doc, result);
@@ -558,7 +830,27 @@ void SensorManager::setTemperatureOffset(float offset) {
 
 // 单独的getter方法实现
 float SensorManager::getSoilMoisture() {
+#if SOIL_COMP_ENABLED
+    // 快速采样 (浇水、浇水检测) 只做补偿，不输入滤波器，避免短时间内的连续样本压低方差
+    return soilEstimator.compensate(readSoilMoisture());
+#else
     return readSoilMoisture();
+#endif
+}
+
+float SensorManager::sampleSoilMoisture() {
+    if (!isSoilReadingReady()) {
+        return NAN;
+    }
+    float moisture = soilFromMillivolts(getBurstReading(SOIL_MOISTURE_PIN));
+#if SOIL_COMP_ENABLED
+    moisture = soilEstimator.compensate(moisture);
+#endif
+    return moisture;
+}
+
+const SoilMoistureEstimator& SensorManager::getSoilEstimator() const {
+    return soilEstimator;
 }
 
 float SensorManager::getAirHumidity() {
@@ -8,7 +8,12 @@
 
 #include <Arduino.h>
 #include <DHT.h>
+#include <esp_timer.h>
 #include "config.h"
+#include "SignalFilter.h"
+#include "AdcCalibration.h"
+#include "SoilMoistureEstimator.h"
+#include "PowerDomain.h"
 
 /**
  * 传感器数据结构
@@ -29,20 +34,21 @@ enum class SensorStatus {
     OK,                 // 正常
     ERROR,              // 错误
     CALIBRATING,        // 校准中
-    NOT_INITIALIZED     // 未初始化
+    NOT_INITIALIZED,    // 未初始化
+    NOT_READY           // 电源未就绪，本次没有读数 (不计为故障)
 };
 
 /**
- * 传感器校准数据
+ * 传感器校准数据 (电压值均为经ADC校准后的毫伏)
  */
 struct CalibrationData {
     // 土壤湿度校准
-    int soilMoistureMin;    // 干燥时的ADC值
-    int soilMoistureMax;    // 完全湿润时的ADC值
+    int soilMoistureMin;    // 完全湿润时的电压 (mV)
+    int soilMoistureMax;    // 干燥时的电压 (mV)
     
     // 光感传感器校准
-    int lightSensorMin;     // 黑暗时的ADC值
-    int lightSensorMax;     // 强光时的ADC值
+    int lightSensorMin;     // 黑暗时的电压 (mV)
+    int lightSensorMax;     // 强光时的电压 (mV)
     float lightConversionFactor; // 转换系数
     
     // 温度补偿
@@ -80,15 +86,42 @@ private:
     int samplingCount;          // 采样次数
     unsigned long lastReadTime; // 上次读取时间
     
+    // 土壤探头激励 (只在测量窗口内通电)
+    bool soilProbePowered;      // 已申请激励电源
+    uint32_t soilProbeWaits;    // 读数时仍需同步等待探头稳定的次数
+    
+    // 过采样数字滤波 (每个模拟通道独立的滤波器)
+    SignalFilter soilFilter;
+    SignalFilter lightFilter;
+    
+    // 后台采样：定时器按过采样率同时采集两个通道的数据块，主循环不等待
+    float soilBlock[ADC_OVERSAMPLE_COUNT];
+    float lightBlock[ADC_OVERSAMPLE_COUNT];
+    esp_timer_handle_t samplerTimer;
+    volatile int sampledCount;          // 已采集的样本数 (达到块大小即采集完成)
+    volatile bool acquisitionActive;    // 定时器正在采集
+    
+    // 土壤湿度温度补偿
+    SoilMoistureEstimator soilEstimator;
+    
     // 私有方法
     float readSoilMoisture();
     float readLightIntensity();
     float readTemperature();
     float readAirHumidity();
+    float soilFromMillivolts(float millivolts);
+    float lightFromMillivolts(float millivolts);
     bool validateSensorData(const SensorData& data);
     void applyCalibration(SensorData& data);
     float mapFloat(float value, float inMin, float inMax, float outMin, float outMax);
     int getMedianReading(int pin, int samples = 5);
+    float getFilteredReading(int pin, const float* block, SignalFilter& filter, int& errorCount);
+    float getQuickReading(int pin);
+    float getBurstReading(int pin);
+    void sampleBlocks();
+    void waitForAcquisition();
+    void waitForSoilProbe();
+    static void samplerCallback(void* arg);
 
 public:
     /**
@@ -116,16 +149,16 @@ public:
     
     /**
      * 手动校准土壤湿度传感器
-     * @param dryValue 干燥时的ADC值
-     * @param wetValue 湿润时的ADC值
+     * @param dryValue 干燥时的电压 (mV)
+     * @param wetValue 湿润时的电压 (mV)
      * @return 校准是否成功
      */
     bool calibrateSoilMoisture(int dryValue, int wetValue);
     
     /**
      * 手动校准光感传感器
-     * @param darkValue 黑暗时的ADC值
-     * @param brightValue 明亮时的ADC值
+     * @param darkValue 黑暗时的电压 (mV)
+     * @param brightValue 明亮时的电压 (mV)
      * @param maxLux 最大光照强度
      * @return 校准是否成功
      */
@@ -133,18 +166,60 @@ public:
     
     /**
      * 读取所有传感器数据
+     * 使用后台采集完成的数据块；没有时先同步采集一块 (约 ADC_OVERSAMPLE_COUNT / ADC_OVERSAMPLE_RATE_HZ 秒)
      * @return 传感器数据结构
      */
     SensorData readAll();
     
+    /**
+     * 开始在后台采集土壤湿度和光照的过采样数据块 (土壤探头需已稳定，见 prepareSoilReading)
+     * 已有未被 readAll() 读取的数据块时保留该数据块
+     * @return 是否已开始 (或正在采集、已采集完成)
+     */
+    bool startAcquisition();
+    
+    /**
+     * 后台采集是否已完成，此时 readAll() 不再等待
+     */
+    bool isAcquisitionComplete() const;
+    
     /**
      * 读取单个传感器数据
+     * 土壤湿度和光照为快速读数：一个工频周期内的均匀采样平均 (约20ms)，不经过采集数据块的滤波器
      */
     float getSoilMoisture();
     float getAirHumidity();
     float getTemperature();
     float getLightIntensity();
     
+    /**
+     * 土壤湿度短读数：连续 ADC_BURST_SAMPLE_COUNT 次采样平均 (不足1ms)
+     * 不等待探头稳定也不断开激励 (调用前需 isSoilReadingReady)，供高频检测使用
+     * @return 土壤湿度 (%)，探头未就绪时为NAN
+     */
+    float sampleSoilMoisture();
+    
+    /**
+     * 获取土壤湿度温度补偿状态 (变化速率、温度系数)
+     */
+    const SoilMoistureEstimator& getSoilEstimator() const;
+    
+    /**
+     * 提前给土壤探头激励上电，经过 SOIL_EXCITATION_SETTLE_MS 后读数才稳定
+     * (读取土壤湿度时若尚未上电则同步上电并等待)
+     */
+    void prepareSoilReading();
+    
+    /**
+     * 土壤探头是否已上电且稳定，可以不等待地读取
+     */
+    bool isSoilReadingReady() const;
+    
+    /**
+     * 断开土壤探头激励 (读取土壤湿度后自动调用，放弃读数时手动调用；后台采集期间保持激励)
+     */
+    void finishSoilReading();
+    
     /**
      * 获取传感器状态
      */
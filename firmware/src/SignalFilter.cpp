@@ -0,0 +1,347 @@
+/**
+ * AI智能植物养护机器人 - 信号滤波器实现
+ */
+
+#include "SignalFilter.h"
+#include <ArduinoJson.h>
+
+#if SIGNAL_FILTER_USE_ESP_DSP
+#include <esp_dsp.h>
+#endif
+
+/**
+ * 构造函数
+ */
+SignalFilter::SignalFilter()
+    : sampleRate(ADC_OVERSAMPLE_RATE_HZ),
+      mainsFrequency(MAINS_FREQUENCY_HZ),
+      decimationFactor(DSP_DECIMATION_FACTOR),
+      initialized(false),
+      notchCount(0) {
+
+    memset(notchCoeffs, 0, sizeof(notchCoeffs));
+    memset(notchState, 0, sizeof(notchState));
+    memset(firCoeffs, 0, sizeof(firCoeffs));
+    memset(workBuffer, 0, sizeof(workBuffer));
+    stats = {0, 0, 0};
+}
+
+/**
+ * 初始化滤波器
+ */
+bool SignalFilter::begin(float sampleRateHz, float mainsHz, int decimation) {
+    if (sampleRateHz <= 0 || decimation < 1 || decimation > MAX_BLOCK_SIZE) {
+        DEBUG_PRINTLN("✗ 滤波器参数错误");
+        return false;
+    }
+
+    sampleRate = sampleRateHz;
+    mainsFrequency = mainsHz;
+    decimationFactor = decimation;
+
+    // 在奈奎斯特频率以下的工频谐波处放置陷波器
+    notchCount = 0;
+    for (int harmonic = 1; harmonic <= DSP_NOTCH_HARMONICS && notchCount < MAX_NOTCHES; harmonic++) {
+        float frequency = mainsFrequency * harmonic;
+        if (frequency >= sampleRate * 0.45f) {
+            break;
+        }
+        designNotch(frequency, DSP_NOTCH_Q, notchCoeffs[notchCount]);
+        notchCount++;
+    }
+
+    // 抽取前的抗混叠低通，截止频率为输出奈奎斯特频率的80%
+    designLowPass(sampleRate / (2.0f * decimationFactor) * 0.8f);
+
+    reset();
+    initialized = true;
+
+    DEBUG_PRINTF("信号滤波器就绪: %.0fHz, 陷波器%d个, 抽取%d倍, %s\n",
+                 sampleRate, notchCount, decimationFactor,
+                 isVectorized() ? "esp-dsp向量路径" : "标量路径");
+    return true;
+}
+
+/**
+ * 设计陷波器 (RBJ 二阶陷波，归一化 a0)
+ */
+void SignalFilter::designNotch(float frequency, float q, float* coeffs) {
+    float w0 = 2.0f * PI * frequency / sampleRate;
+    float cosW0 = cosf(w0);
+    float alpha = sinf(w0) / (2.0f * q);
+    float a0 = 1.0f + alpha;
+
+    coeffs[0] = 1.0f / a0;               // b0
+    coeffs[1] = -2.0f * cosW0 / a0;      // b1
+    coeffs[2] = 1.0f / a0;               // b2
+    coeffs[3] = -2.0f * cosW0 / a0;      // a1
+    coeffs[4] = (1.0f - alpha) / a0;     // a2
+}
+
+/**
+ * 设计FIR低通 (Hamming 窗 sinc，直流增益归一化为1)
+ */
+void SignalFilter::designLowPass(float cutoff) {
+    float fc = cutoff / sampleRate;
+    float center = (FIR_TAPS - 1) / 2.0f;
+    float sum = 0;
+
+    for (int i = 0; i < FIR_TAPS; i++) {
+        float n = i - center;
+        float sinc = (n == 0) ? 2.0f * fc : sinf(2.0f * PI * fc * n) / (PI * n);
+        float window = 0.54f - 0.46f * cosf(2.0f * PI * i / (FIR_TAPS - 1));
+        firCoeffs[i] = sinc * window;
+        sum += firCoeffs[i];
+    }
+
+    for (int i = 0; i < FIR_TAPS; i++) {
+        firCoeffs[i] /= sum;
+    }
+}
+
+/**
+ * 重置滤波器状态
+ */
+void SignalFilter::reset() {
+    memset(notchState, 0, sizeof(notchState));
+    memset(workBuffer, 0, sizeof(workBuffer));
+}
+
+/**
+ * 以稳态值预置滤波器状态
+ */
+void SignalFilter::prime(float value) {
+    // 直接II型结构在恒定输入下的稳态: w = x / (1 + a1 + a2)
+    for (int i = 0; i < notchCount; i++) {
+        float* c = notchCoeffs[i];
+        float w = value / (1.0f + c[3] + c[4]);
+        notchState[i][0] = w;
+        notchState[i][1] = w;
+    }
+
+    for (int i = 0; i < FIR_TAPS - 1; i++) {
+        workBuffer[i] = value;
+    }
+}
+
+/**
+ * 标量陷波 (直接II型，与 esp-dsp 的 ANSI 实现一致)
+ */
+void SignalFilter::applyNotchScalar(float* data, int length, float* coeffs, float* state) {
+    for (int i = 0; i < length; i++) {
+        float d0 = data[i] - coeffs[3] * state[0] - coeffs[4] * state[1];
+        data[i] = coeffs[0] * d0 + coeffs[1] * state[0] + coeffs[2] * state[1];
+        state[1] = state[0];
+        state[0] = d0;
+    }
+}
+
+/**
+ * 标量抽取滤波
+ */
+int SignalFilter::decimateScalar(int length, float* output) {
+    int outputCount = length / decimationFactor;
+
+    for (int k = 0; k < outputCount; k++) {
+        const float* window = workBuffer + (k + 1) * decimationFactor - 1;
+        float acc = 0;
+        for (int j = 0; j < FIR_TAPS; j++) {
+            acc += window[j] * firCoeffs[j];
+        }
+        output[k] = acc;
+    }
+
+    return outputCount;
+}
+
+#if SIGNAL_FILTER_USE_ESP_DSP
+/**
+ * 向量陷波 (esp-dsp biquad，S3 上为 PIE 优化版本)
+ */
+void SignalFilter::applyNotchVector(float* data, int length, float* coeffs, float* state) {
+    dsps_biquad_f32(data, data, length, coeffs, state);
+}
+
+/**
+ * 向量抽取滤波 (每个输出样本一次 esp-dsp 点积)
+ */
+int SignalFilter::decimateVector(int length, float* output) {
+    int outputCount = length / decimationFactor;
+
+    for (int k = 0; k < outputCount; k++) {
+        const float* window = workBuffer + (k + 1) * decimationFactor - 1;
+        dsps_dotprod_f32(window, firCoeffs, &output[k], FIR_TAPS);
+    }
+
+    return outputCount;
+}
+#endif
+
+/**
+ * 使用指定路径处理数据块
+ */
+int SignalFilter::processWith(bool vectorized, const float* input, int length, float* output) {
+    if (!initialized || length <= 0) {
+        return 0;
+    }
+    if (length > MAX_BLOCK_SIZE) {
+        length = MAX_BLOCK_SIZE;
+    }
+
+    unsigned long startTime = micros();
+
+    // 新样本接在历史数据之后，陷波器原地处理
+    float* samples = workBuffer + FIR_TAPS - 1;
+    memcpy(samples, input, length * sizeof(float));
+
+    int outputCount;
+#if SIGNAL_FILTER_USE_ESP_DSP
+    if (vectorized) {
+        for (int i = 0; i < notchCount; i++) {
+            applyNotchVector(samples, length, notchCoeffs[i], notchState[i]);
+        }
+        outputCount = decimateVector(length, output);
+    } else
+#else
+    (void)vectorized;   // 没有向量内核时只有标量路径
+#endif
+    {
+        for (int i = 0; i < notchCount; i++) {
+            applyNotchScalar(samples, length, notchCoeffs[i], notchState[i]);
+        }
+        outputCount = decimateScalar(length, output);
+    }
+
+    // 保留最后 FIR_TAPS-1 个样本作为下一块的历史
+    memmove(workBuffer, workBuffer + length, (FIR_TAPS - 1) * sizeof(float));
+
+    stats.lastBlockMicros = micros() - startTime;
+    stats.maxBlockMicros = max(stats.maxBlockMicros, stats.lastBlockMicros);
+    stats.blocksProcessed++;
+
+    return outputCount;
+}
+
+/**
+ * 处理一个数据块
+ */
+int SignalFilter::process(const float* input, int length, float* output) {
+    return processWith(isVectorized(), input, length, output);
+}
+
+/**
+ * 对独立采集的数据块滤波并返回均值
+ */
+bool SignalFilter::filterBlock(const float* input, int length, float& mean) {
+    static float decimated[MAX_BLOCK_SIZE];
+
+    if (length <= 0) {
+        return false;
+    }
+
+    // 以块均值预置，避免首样本中的工频分量激起陷波器振铃
+    float blockMean = 0;
+    for (int i = 0; i < length; i++) {
+        blockMean += input[i];
+    }
+    prime(blockMean / length);
+
+    int count = process(input, length, decimated);
+    if (count <= 0) {
+        return false;
+    }
+
+    float sum = 0;
+    for (int i = 0; i < count; i++) {
+        sum += decimated[i];
+    }
+    mean = sum / count;
+    return true;
+}
+
+/**
+ * 基准测试
+ */
+SignalFilterBenchmark SignalFilter::benchmark(int iterations) {
+    static float testBlock[MAX_BLOCK_SIZE];
+    static float testOutput[MAX_BLOCK_SIZE];
+
+    SignalFilterBenchmark result = {
+        .blockSize = MAX_BLOCK_SIZE,
+        .scalarMicros = 0,
+        .vectorMicros = 0,
+        .vectorAvailable = isVectorized()
+    };
+
+    if (!initialized || iterations <= 0) {
+        return result;
+    }
+
+    // 合成测试信号: 直流 + 工频干扰 + 二次谐波
+    for (int i = 0; i < MAX_BLOCK_SIZE; i++) {
+        float t = i / sampleRate;
+        testBlock[i] = 2000.0f +
+                       200.0f * sinf(2.0f * PI * mainsFrequency * t) +
+                       80.0f * sinf(4.0f * PI * mainsFrequency * t);
+    }
+
+    SignalFilterStats savedStats = stats;
+
+    reset();
+    unsigned long startTime = micros();
+    for (int i = 0; i < iterations; i++) {
+        processWith(false, testBlock, MAX_BLOCK_SIZE, testOutput);
+    }
+    result.scalarMicros = (float)(micros() - startTime) / iterations;
+
+#if SIGNAL_FILTER_USE_ESP_DSP
+    reset();
+    startTime = micros();
+    for (int i = 0; i < iterations; i++) {
+        processWith(true, testBlock, MAX_BLOCK_SIZE, testOutput);
+    }
+    result.vectorMicros = (float)(micros() - startTime) / iterations;
+#endif
+
+    reset();
+    stats = savedStats;
+
+    DEBUG_PRINTF("滤波基准(%d样本): 标量 %.1fus, 向量 %.1fus\n",
+                 result.blockSize, result.scalarMicros, result.vectorMicros);
+    return result;
+}
+
+/**
+ * 向量路径是否可用
+ */
+bool SignalFilter::isVectorized() {
+    return SIGNAL_FILTER_USE_ESP_DSP != 0;
+}
+
+/**
+ * 获取运行统计
+ */
+SignalFilterStats SignalFilter::getStats() const {
+    return stats;
+}
+
+/**
+ * 获取滤波器信息
+ */
+String SignalFilter::getFilterInfo() const {
+    DynamicJsonDocument doc(512);
+
+    doc["sample_rate"] = sampleRate;
+    doc["mains_frequency"] = mainsFrequency;
+    doc["decimation"] = decimationFactor;
+    doc["notch_count"] = notchCount;
+    doc["fir_taps"] = FIR_TAPS;
+    doc["vectorized"] = isVectorized();
+    doc["blocks_processed"] = stats.blocksProcessed;
+    doc["last_block_us"] = stats.lastBlockMicros;
+    doc["max_block_us"] = stats.maxBlockMicros;
+
+    String result;
+    serializeJson(doc, result);
+    return result;
+}
@@ -0,0 +1,157 @@
+/**
+ * AI智能植物养护机器人 - 信号滤波器
+ * 对过采样的ADC数据块进行工频陷波和抽取低通滤波
+ *
+ * ESP32-S3 上使用 esp-dsp 的向量化内核 (biquad / 点积)，
+ * 其他平台退化为可移植的标量实现，两条路径输出一致。
+ */
+
+#ifndef SIGNAL_FILTER_H
+#define SIGNAL_FILTER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// 是否启用 esp-dsp 向量化内核 (可通过 -DSIGNAL_FILTER_USE_ESP_DSP=0 强制使用标量路径)
+#ifndef SIGNAL_FILTER_USE_ESP_DSP
+    #if defined(ESP_PLATFORM) && defined(__has_include)
+        #if __has_include(<esp_dsp.h>)
+            #define SIGNAL_FILTER_USE_ESP_DSP 1
+        #endif
+    #endif
+#endif
+#ifndef SIGNAL_FILTER_USE_ESP_DSP
+    #define SIGNAL_FILTER_USE_ESP_DSP 0
+#endif
+
+/**
+ * 滤波器运行统计
+ */
+struct SignalFilterStats {
+    unsigned long blocksProcessed;   // 已处理数据块数
+    unsigned long lastBlockMicros;   // 最近一个数据块耗时 (微秒)
+    unsigned long maxBlockMicros;    // 最长数据块耗时 (微秒)
+};
+
+/**
+ * 基准测试结果
+ */
+struct SignalFilterBenchmark {
+    int blockSize;                   // 数据块大小
+    float scalarMicros;              // 标量路径平均耗时 (微秒/块)
+    float vectorMicros;              // 向量路径平均耗时 (微秒/块)，不可用时为0
+    bool vectorAvailable;            // 向量路径是否可用
+};
+
+/**
+ * 信号滤波器类
+ * 每个模拟通道持有一个实例，处理流程：
+ *   原始数据块 -> 工频谐波陷波 (biquad 级联) -> FIR 低通 + 抽取 -> 输出
+ */
+class SignalFilter {
+public:
+    static const int MAX_NOTCHES = 4;                    // 最多陷波器数量
+    static const int FIR_TAPS = DSP_FIR_TAPS;            // FIR 抽头数
+    static const int MAX_BLOCK_SIZE = ADC_OVERSAMPLE_COUNT; // 单块最大样本数
+
+private:
+    // 配置
+    float sampleRate;                // 采样率 (Hz)
+    float mainsFrequency;            // 工频 (Hz)
+    int decimationFactor;            // 抽取因子
+    bool initialized;
+
+    // 陷波器系数与状态 (esp-dsp 布局: b0, b1, b2, a1, a2 / w0, w1)
+    float notchCoeffs[MAX_NOTCHES][5];
+    float notchState[MAX_NOTCHES][2];
+    int notchCount;
+
+    // FIR 低通系数与工作缓冲区 (前 FIR_TAPS-1 个样本为历史数据)
+    float firCoeffs[FIR_TAPS];
+    float workBuffer[FIR_TAPS - 1 + MAX_BLOCK_SIZE];
+
+    SignalFilterStats stats;
+
+    // 私有方法
+    void designNotch(float frequency, float q, float* coeffs);
+    void designLowPass(float cutoff);
+    void applyNotchScalar(float* data, int length, float* coeffs, float* state);
+    int decimateScalar(int length, float* output);
+#if SIGNAL_FILTER_USE_ESP_DSP
+    void applyNotchVector(float* data, int length, float* coeffs, float* state);
+    int decimateVector(int length, float* output);
+#endif
+    int processWith(bool vectorized, const float* input, int length, float* output);
+
+public:
+    /**
+     * 构造函数
+     */
+    SignalFilter();
+
+    /**
+     * 初始化滤波器
+     * @param sampleRateHz 输入采样率
+     * @param mainsHz 工频 (50或60Hz)
+     * @param decimation 抽取因子
+     * @return 初始化是否成功
+     */
+    bool begin(float sampleRateHz = ADC_OVERSAMPLE_RATE_HZ,
+               float mainsHz = MAINS_FREQUENCY_HZ,
+               int decimation = DSP_DECIMATION_FACTOR);
+
+    /**
+     * 重置滤波器状态
+     */
+    void reset();
+
+    /**
+     * 以稳态值预置滤波器状态，消除数据块起始处的瞬态
+     * @param value 预置值
+     */
+    void prime(float value);
+
+    /**
+     * 处理一个数据块
+     * @param input 输入样本
+     * @param length 输入样本数 (不超过 MAX_BLOCK_SIZE)
+     * @param output 输出缓冲区 (至少 length / 抽取因子 个元素)
+     * @return 输出样本数
+     */
+    int process(const float* input, int length, float* output);
+
+    /**
+     * 对独立采集的数据块滤波并返回均值
+     * 先以块均值预置状态，适用于间隔较长的单次测量
+     * @param input 输入样本
+     * @param length 输入样本数
+     * @param mean 输出滤波后的均值 (陷波和低通的输出在0附近可能为负)
+     * @return 是否得到结果 (滤波器未初始化或数据块为空时为false)
+     */
+    bool filterBlock(const float* input, int length, float& mean);
+
+    /**
+     * 基准测试：对比标量与向量路径耗时
+     * @param iterations 迭代次数
+     * @return 基准测试结果
+     */
+    SignalFilterBenchmark benchmark(int iterations = 50);
+
+    /**
+     * 向量路径是否可用
+     */
+    static bool isVectorized();
+
+    /**
+     * 获取运行统计
+     */
+    SignalFilterStats getStats() const;
+
+    /**
+     * 获取滤波器信息
+     * @return JSON格式的滤波器信息
+     */
+    String getFilterInfo() const;
+};
+
+#endif // SIGNAL_FILTER_H
@@ -0,0 +1,237 @@
+/**
+ * AI智能植物养护机器人 - 土壤湿度温度补偿实现
+ */
+
+#include "SoilMoistureEstimator.h"
+
+/**
+ * 构造函数
+ */
+SoilMoistureEstimator::SoilMoistureEstimator()
+    : moisture(0),
+      rate(0),
+      coefficient(0),
+      p00(0), p01(0), p02(0),
+      p11(0), p12(0),
+      p22(SOIL_COMP_INITIAL_COEFF_VAR),
+      soilTemperature(NAN),
+      initialized(false),
+      lastUpdate(0),
+      lastSave(0),
+      sampleCount(0),
+      stepCount(0) {
+}
+
+/**
+ * 加载已学习的温度系数
+ */
+void SoilMoistureEstimator::begin() {
+    preferences.begin(SOIL_COMP_NAMESPACE, true);
+    coefficient = preferences.getFloat("coeff", 0);
+    p22 = preferences.getFloat("coeffVar", SOIL_COMP_INITIAL_COEFF_VAR);
+    preferences.end();
+
+    if (isnan(coefficient) || fabsf(coefficient) > SOIL_COMP_COEFF_LIMIT) {
+        coefficient = 0;
+    }
+    if (isnan(p22) || p22 <= 0 || p22 > SOIL_COMP_INITIAL_COEFF_VAR) {
+        p22 = SOIL_COMP_INITIAL_COEFF_VAR;
+    }
+    lastSave = millis();
+
+    DEBUG_PRINTF("土壤温度系数: %.3f %%/°C (±%.3f)\n", coefficient, sqrtf(p22));
+}
+
+/**
+ * 重新初始化湿度和速率 (保留温度系数及其方差)
+ */
+void SoilMoistureEstimator::reinitialize(float reading, float offset) {
+    moisture = reading - coefficient * offset;
+    rate = 0;
+    p00 = SOIL_COMP_MEASUREMENT_VAR + p22 * offset * offset;
+    p01 = 0;
+    p02 = -p22 * offset;
+    p11 = SOIL_COMP_INITIAL_RATE_VAR;
+    p12 = 0;
+    initialized = true;
+}
+
+/**
+ * 输入一个样本
+ */
+float SoilMoistureEstimator::update(float reading, float airTemperature, unsigned long timestamp) {
+    if (isnan(reading)) {
+        return moisture;
+    }
+
+    float dt = initialized ? (timestamp - lastUpdate) / 3600000.0f : 0;
+    lastUpdate = timestamp;
+    sampleCount++;
+
+    // 土温估计：气温的一阶滞后
+    bool restart = !initialized || dt > SOIL_COMP_MAX_GAP_HOURS;
+    if (!isnan(airTemperature)) {
+        if (isnan(soilTemperature) || restart) {
+            soilTemperature = airTemperature;
+        } else {
+            soilTemperature += (airTemperature - soilTemperature) * dt / (SOIL_COMP_TEMP_TAU_HOURS + dt);
+        }
+    }
+    float offset = isnan(soilTemperature) ? 0 : soilTemperature - SOIL_COMP_REFERENCE_TEMP;
+
+    if (restart) {
+        reinitialize(reading, offset);
+        return constrain(moisture, 0.0f, 100.0f);
+    }
+
+    // 预测：P = F·P·Fᵀ + Q，F = [[1,dt,0],[0,1,0],[0,0,1]]
+    moisture += rate * dt;
+    p00 += dt * (2 * p01 + dt * p11) + SOIL_COMP_MOISTURE_VAR * dt;
+    p01 += dt * p11;
+    p02 += dt * p12;
+    p11 += SOIL_COMP_RATE_VAR * dt;
+    p22 += SOIL_COMP_COEFF_VAR * dt;
+
+    // 观测 h = [1, 0, offset]：新息及其方差
+    float innovation = reading - (moisture + coefficient * offset);
+    float a0 = p00 + p02 * offset;
+    float a1 = p01 + p12 * offset;
+    float a2 = p02 + p22 * offset;
+    float s = a0 + a2 * offset + SOIL_COMP_MEASUREMENT_VAR;
+
+    // 新息超出门限：湿度发生阶跃 (浇水、换盆)，放大湿度方差直接跟随，不让阶跃污染速率和温度系数
+    if (innovation * innovation > SOIL_COMP_GATE_SIGMA * SOIL_COMP_GATE_SIGMA * s) {
+        stepCount++;
+        p00 += innovation * innovation;
+        p01 = 0;
+        rate = 0;
+        p11 = SOIL_COMP_INITIAL_RATE_VAR;
+        p12 = 0;
+        a0 = p00 + p02 * offset;
+        a1 = 0;
+        a2 = p02 + p22 * offset;
+        s = a0 + a2 * offset + SOIL_COMP_MEASUREMENT_VAR;
+    }
+
+    // 更新：K = P·h / s，P -= K·(P·h)ᵀ
+    float k0 = a0 / s;
+    float k1 = a1 / s;
+    float k2 = a2 / s;
+    moisture += k0 * innovation;
+    rate += k1 * innovation;
+    coefficient += k2 * innovation;
+    p00 -= k0 * a0;
+    p01 -= k0 * a1;
+    p02 -= k0 * a2;
+    p11 -= k1 * a1;
+    p12 -= k1 * a2;
+    p22 -= k2 * a2;
+    constrainState();
+
+    // 温度系数已有一定把握后定期保存
+    if (millis() - lastSave >= SOIL_COMP_SAVE_INTERVAL && p22 < SOIL_COMP_INITIAL_COEFF_VAR / 4) {
+        saveCoefficient();
+    }
+
+    return constrain(moisture, 0.0f, 100.0f);
+}
+
+/**
+ * 限制状态和方差 (防止数值误差使方差变负)
+ */
+void SoilMoistureEstimator::constrainState() {
+    coefficient = constrain(coefficient, -SOIL_COMP_COEFF_LIMIT, SOIL_COMP_COEFF_LIMIT);
+    moisture = constrain(moisture, -20.0f, 120.0f);
+    if (p00 < 1e-6f) {
+        p00 = 1e-6f;
+    }
+    if (p11 < 1e-9f) {
+        p11 = 1e-9f;
+    }
+    if (p22 < 1e-9f) {
+        p22 = 1e-9f;
+    }
+}
+
+/**
+ * 保存温度系数
+ */
+void SoilMoistureEstimator::saveCoefficient() {
+    preferences.begin(SOIL_COMP_NAMESPACE, false);
+    preferences.putFloat("coeff", coefficient);
+    preferences.putFloat("coeffVar", p22);
+    preferences.end();
+    lastSave = millis();
+}
+
+/**
+ * 不更新状态地补偿一个读数
+ */
+float SoilMoistureEstimator::compensate(float reading) const {
+    if (isnan(soilTemperature)) {
+        return reading;
+    }
+    float compensated = reading - coefficient * (soilTemperature - SOIL_COMP_REFERENCE_TEMP);
+    return constrain(compensated, 0.0f, 100.0f);
+}
+
+/**
+ * 清除学习到的温度系数
+ */
+void SoilMoistureEstimator::resetProbe() {
+    coefficient = 0;
+    p22 = SOIL_COMP_INITIAL_COEFF_VAR;
+    initialized = false;
+    stepCount = 0;
+    saveCoefficient();
+    DEBUG_PRINTLN("土壤温度系数已清除");
+}
+
+/**
+ * 获取补偿后的湿度
+ */
+float SoilMoistureEstimator::getMoisture() const {
+    return constrain(moisture, 0.0f, 100.0f);
+}
+
+/**
+ * 获取湿度变化速率
+ */
+float SoilMoistureEstimator::getRate() const {
+    return rate;
+}
+
+/**
+ * 获取温度系数
+ */
+float SoilMoistureEstimator::getCoefficient() const {
+    return coefficient;
+}
+
+/**
+ * 获取温度系数的标准差
+ */
+float SoilMoistureEstimator::getCoefficientStdDev() const {
+    return sqrtf(p22);
+}
+
+/**
+ * 获取阶跃次数
+ */
+uint32_t SoilMoistureEstimator::getStepCount() const {
+    return stepCount;
+}
+
+/**
+ * 获取样本数
+ */
+uint32_t SoilMoistureEstimator::getSampleCount() const {
+    return sampleCount;
+}
+
+/**
+ * 是否已有估计
+ */
+bool SoilMoistureEstimator::isInitialized() const {
+    return initialized;
+}
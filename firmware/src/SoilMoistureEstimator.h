@@ -0,0 +1,120 @@
+/**
+ * AI智能植物养护机器人 - 土壤湿度温度补偿
+ * 电容式/电阻式探头的读数随土温漂移：中午显得变干、夜里显得变湿，会引起误报缺水。
+ * 这里用一个三状态卡尔曼滤波融合土壤读数和DHT22温度：
+ *
+ *   状态   x = [m 真实湿度 (%), r 变化速率 (%/h), k 探头温度系数 (%/°C)]
+ *   预测   m += r·dt，r 与 k 为随机游走 (缓慢变干的动态)
+ *   观测   z = m + k·(Ts - 参考温度) + 噪声，Ts 为气温经一阶滞后得到的土温估计
+ *
+ * 观测向量随温度变化，昼夜温差使 k 可观测，滤波器在运行中学习每个探头的温度系数
+ * (保存在NVS，重新校准探头时清除)。新息超过门限 (浇水、换盆) 时放大湿度方差，直接跟随阶跃。
+ *
+ * 每个样本固定的运算量：协方差只存6个对称元素，观测为标量不需要矩阵求逆，
+ * 只有乘加和一次除法 (土温滞后也用 dt/(τ+dt) 代替指数)，可以直接改为定点实现。
+ */
+
+#ifndef SOIL_MOISTURE_ESTIMATOR_H
+#define SOIL_MOISTURE_ESTIMATOR_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include "config.h"
+
+/**
+ * 土壤湿度估计器类
+ */
+class SoilMoistureEstimator {
+private:
+    Preferences preferences;
+
+    // 状态
+    float moisture;             // 补偿后的湿度 (%)
+    float rate;                 // 变化速率 (%/h)
+    float coefficient;          // 温度系数 (%/°C)
+
+    // 协方差 (对称，只存上三角)
+    float p00, p01, p02;
+    float p11, p12;
+    float p22;
+
+    float soilTemperature;      // 土温估计 (°C，NAN表示尚无温度)
+    bool initialized;
+    unsigned long lastUpdate;
+    unsigned long lastSave;
+    uint32_t sampleCount;
+    uint32_t stepCount;         // 新息超限 (阶跃) 次数
+
+    void reinitialize(float reading, float offset);
+    void constrainState();
+    void saveCoefficient();
+
+public:
+    /**
+     * 构造函数
+     */
+    SoilMoistureEstimator();
+
+    /**
+     * 加载已学习的温度系数
+     */
+    void begin();
+
+    /**
+     * 输入一个样本
+     * @param reading 未补偿的湿度读数 (%)
+     * @param airTemperature DHT22气温 (°C，NAN表示本次无温度)
+     * @param timestamp 采样时刻 (ms)
+     * @return 补偿后的湿度 (%)
+     */
+    float update(float reading, float airTemperature, unsigned long timestamp);
+
+    /**
+     * 用当前土温估计和温度系数补偿一个读数，不更新滤波状态 (浇水期间的快速采样)
+     * @param reading 未补偿的湿度读数 (%)
+     * @return 补偿后的湿度 (%)
+     */
+    float compensate(float reading) const;
+
+    /**
+     * 更换或重新校准探头后清除学习到的温度系数
+     */
+    void resetProbe();
+
+    /**
+     * 获取补偿后的湿度 (%)
+     */
+    float getMoisture() const;
+
+    /**
+     * 获取湿度变化速率 (%/h，负值表示变干)
+     */
+    float getRate() const;
+
+    /**
+     * 获取温度系数 (%/°C)
+     */
+    float getCoefficient() const;
+
+    /**
+     * 获取温度系数的标准差 (%/°C，越小表示学习越充分)
+     */
+    float getCoefficientStdDev() const;
+
+    /**
+     * 获取阶跃次数
+     */
+    uint32_t getStepCount() const;
+
+    /**
+     * 获取样本数
+     */
+    uint32_t getSampleCount() const;
+
+    /**
+     * 是否已有估计
+     */
+    bool isInitialized() const;
+};
+
+#endif // SOIL_MOISTURE_ESTIMATOR_H
@@ -3,6 +3,7 @@
  */
 
 #include "SoundController.h"
+#include "FactoryTest.h"
 
 // 预定义音效序列
 Tone SoundController::happyTones[] = {
@@ -103,7 +104,10 @@ SoundController::SoundController()
       soundEnabled(true),
       quietStartTime(0),
       quietEndTime(0),
-      isQuietHours(false) {
+      isQuietHours(false),
+      nightMode(false),
+      ampPowered(false),
+      ampBusyUntil(0) {
     
     // 初始化状态
     status = {
@@ -132,6 +136,7 @@ SoundController::SoundController()
  */
 SoundController::~SoundController() {
     stopSound();
+    releaseAmp();
 }
 
 /**
@@ -144,8 +149,8 @@ bool SoundController::initialize() {
     pinMode(SPEAKER_PIN, OUTPUT);
     digitalWrite(SPEAKER_PIN, LOW);
     
-    // 执行音效测试
-    if (!performTest()) {
+    // 执行音效测试 (工厂测试模式下由FactoryTest扫频检测)
+    if (!FactoryTest::isActive() && !performTest()) {
         DEBUG_PRINTLN("✗ 音效测试失败");
         return false;
     }
@@ -158,19 +163,26 @@ bool SoundController::initialize() {
  * 更新音效播放
  */
 void SoundController::update() {
+    // 最后一个音调结束后释放功放电源
+    if (ampPowered && !status.isPlaying && (long)(millis() - ampBusyUntil) >= 0) {
+        releaseAmp();
+    }
+    
     if (!status.isPlaying || !soundEnabled || status.isMuted) {
         return;
     }
     
-    // 更新静音时段状态
-    updateQuietHours();
-    
-    // 如果在静音时段，停止播放
-    if (isInQuietHours()) {
+    // 如果进入静音时段或夜间，停止非关键音效
+    if (isSuppressed(status.currentSound)) {
         stopSound();
         return;
     }
     
+    // 功放上电稳定前不开始播放，序列整体顺延
+    if (!powerAmp(0)) {
+        return;
+    }
+    
     unsigned long currentTime = millis();
     
     // 检查是否到了播放下一个音调的时间
@@ -203,14 +215,42 @@ void SoundController::update() {
  * 播放音调
  */
 void SoundController::playTone(uint16_t frequency, uint16_t duration) {
-    if (!soundEnabled || status.isMuted || isInQuietHours()) {
+    if (!soundEnabled || status.isMuted || isSuppressed(status.currentSound)) {
         return;
     }
     
-    // 使用PWM生成音调
+    // 使用PWM生成音调 (单独播放的音调不等待功放稳定，开头可能略被截短)
+    powerAmp(duration);
     tone(SPEAKER_PIN, frequency, duration);
 }
 
+/**
+ * 申请功放电源，并把占用时间延长到当前音调结束
+ * @return 功放是否已稳定
+ */
+bool SoundController::powerAmp(unsigned long busyMs) {
+    if (!ampPowered) {
+        PowerDomainManager::acquire(PowerDomain::AUDIO_AMP);
+        ampPowered = true;
+    }
+    
+    unsigned long busyUntil = millis() + busyMs;
+    if ((long)(busyUntil - ampBusyUntil) > 0) {
+        ampBusyUntil = busyUntil;
+    }
+    return PowerDomainManager::isReady(PowerDomain::AUDIO_AMP);
+}
+
+/**
+ * 释放功放电源
+ */
+void SoundController::releaseAmp() {
+    if (ampPowered) {
+        PowerDomainManager::release(PowerDomain::AUDIO_AMP);
+        ampPowered = false;
+    }
+}
+
 /**
  * 停止音调
  */
@@ -341,18 +381,10 @@ uint8_t SoundController::calculateVolume(uint8_t baseVolume) {
 }
 
 /**
- * 更新静音时段状态
+ * 音效是否被静音时段或夜间模式屏蔽 (关键音效除外)
  */
-void SoundController::updateQuietHours() {
-    // 简化实现，实际应该获取当前时间并与设置的静音时段比较
-    // 这里假设没有RTC，使用运行时间模拟
-    unsigned long currentTime = millis();
-    
-    // 如果设置了静音时段
-    if (quietStartTime != 0 && quietEndTime != 0) {
-        // 简化的时间检查逻辑
-        isQuietHours = false; // 默认不在静音时段
-    }
+bool SoundController::isSuppressed(SoundType soundType) const {
+    return (isQuietHours || nightMode) && !isCriticalSound(soundType);
 }
 
 // ============= 公共方法实现 =============
@@ -361,7 +393,7 @@ void SoundController::updateQuietHours() {
  * 播放音效
  */
 void SoundController::playSound(SoundType soundType, uint8_t volume) {
-    if (!soundEnabled || status.isMuted || isInQuietHours()) {
+    if (!soundEnabled || status.isMuted || isSuppressed(soundType)) {
         return;
     }
     
@@ -395,7 +427,7 @@ void SoundController::playSound(SoundType soundType, uint8_t volume) {
  * 播放自定义音效序列
  */
 void SoundController::playSequence(const SoundSequence& sequence) {
-    if (!soundEnabled || status.isMuted || isInQuietHours()) {
+    if (!soundEnabled || status.isMuted || isSuppressed(SoundType::NONE)) {
         return;
     }
     
@@ -418,7 +450,7 @@ void SoundController::playSequence(const SoundSequence& sequence) {
  * 播放单个音调
  */
 void SoundController::playTone(uint16_t frequency, uint16_t duration, uint8_t volume) {
-    if (!soundEnabled || status.isMuted || isInQuietHours()) {
+    if (!soundEnabled || status.isMuted || isSuppressed(SoundType::NONE)) {
         return;
     }
     
@@ -515,7 +547,7 @@ bool SoundController::isSoundEnabled() const {
  * 设置静音时段
  */
 void SoundController::setQuietHours(uint8_t startHour, uint8_t startMinute, uint8_t endHour, uint8_t endMinute) {
-    // 简化实现，将时间转换为毫秒（假设从启动开始计算）
+    // 转换为当天零点起的毫秒数，是否处于静音时段由日程调度器按本地时间判定
     quietStartTime = (startHour * 60 + startMinute) * 60 * 1000;
     quietEndTime = (endHour * 60 + endMinute) * 60 * 1000;
     
@@ -523,6 +555,21 @@ void SoundController::setQuietHours(uint8_t startHour, uint8_t startMinute, uint
                  startHour, startMinute, endHour, endMinute);
 }
 
+/**
+ * 进入/退出静音时段
+ */
+void SoundController::setQuietHoursActive(bool active) {
+    if (isQuietHours == active) {
+        return;
+    }
+    
+    isQuietHours = active;
+    DEBUG_PRINTLN(active ? "进入静音时段" : "静音时段结束");
+    if (active && status.isPlaying && isSuppressed(status.currentSound)) {
+        stopSound();
+    }
+}
+
 /**
  * 检查是否在静音时段
  */
@@ -530,6 +577,25 @@ bool SoundController::isInQuietHours() const {
     return isQuietHours;
 }
 
+/**
+ * 设置夜间模式
+ */
+void SoundController::setNightMode(bool night) {
+    nightMode = night;
+    if (night && status.isPlaying && isSuppressed(status.currentSound)) {
+        stopSound();
+    }
+}
+
+/**
+ * 是否为关键音效
+ */
+bool SoundController::isCriticalSound(SoundType soundType) {
+    return soundType == SoundType::ERROR ||
+           soundType == SoundType::WARNING ||
+           soundType == SoundType::LOW_BATTERY;
+}
+
 /**
  * 播放植物状态音效
  */
@@ -636,6 +702,10 @@ SoundStatus SoundController::getStatus() const {
 bool SoundController::performTest() {
     DEBUG_PRINTLN("执行音效测试...");
     
+    // 先给功放上电，避免第一个音调被截短
+    powerAmp(0);
+    delay(PowerDomainManager::getTimeUntilReady(PowerDomain::AUDIO_AMP));
+    
     // 测试短蜂鸣
     playTone(FREQ_BEEP, 200, 50);
     delay(300);
@@ -664,6 +734,7 @@ String SoundController::getSystemInfo() const {
     doc["is_playing"] = status.isPlaying;
     doc["current_sound"] = getSoundTypeName(status.currentSound);
     doc["is_quiet_hours"] = isQuietHours;
+    doc["night_mode"] = nightMode;
     
     String result;
     serializeJson(doc, result);
@@ -8,6 +8,7 @@
 
 #include <Arduino.h>
 #include "StateManager.h"
+#include "PowerDomain.h"
 #include "config.h"
 
 /**
@@ -79,9 +80,12 @@ private:
     SoundSequence currentSequence;
     uint8_t globalVolume;
     bool soundEnabled;
-    unsigned long quietStartTime;
-    unsigned long quietEndTime;
+    unsigned long quietStartTime;   // 静音开始 (当天零点起的毫秒数)
+    unsigned long quietEndTime;     // 静音结束 (当天零点起的毫秒数)
     bool isQuietHours;
+    bool nightMode;
+    bool ampPowered;                // 已申请功放电源域
+    unsigned long ampBusyUntil;     // 最后一个音调的结束时刻
     
     // 预定义音效序列
     static Tone happyTones[];
@@ -105,8 +109,9 @@ private:
     void stopTone();
     SoundSequence getSoundSequence(SoundType soundType);
     uint8_t calculateVolume(uint8_t baseVolume);
-    bool isInQuietHours();
-    void updateQuietHours();
+    bool isSuppressed(SoundType soundType) const;
+    bool powerAmp(unsigned long busyMs);
+    void releaseAmp();
 
 public:
     /**
@@ -210,12 +215,30 @@ public:
      */
     void setQuietHours(uint8_t startHour, uint8_t startMinute, uint8_t endHour, uint8_t endMinute);
     
+    /**
+     * 进入/退出静音时段 (由日程调度器在时段边界调用)
+     * @param active 是否处于静音时段
+     */
+    void setQuietHoursActive(bool active);
+    
     /**
      * 检查是否在静音时段
      * @return 是否在静音时段
      */
     bool isInQuietHours() const;
     
+    /**
+     * 设置夜间模式 (夜间仅播放关键音效)
+     * @param night 是否夜间
+     */
+    void setNightMode(bool night);
+    
+    /**
+     * 是否为关键音效 (静音时段和夜间仍然播放)
+     * @param soundType 音效类型
+     */
+    static bool isCriticalSound(SoundType soundType);
+    
     /**
      * 播放植物状态音效
      * @param state 植物状态
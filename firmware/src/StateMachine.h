@@ -0,0 +1,380 @@
+/**
+ * AI智能植物养护机器人 - 层次状态机框架
+ * 状态定义和转换表在编译期生成 (constexpr)，并展开为 状态×事件 查找表，
+ * 子状态未处理的事件 (或其条件转换都不成立) 自动交给父状态，通常只需一次查表；
+ * 支持进入/退出动作、条件转换、单个超时定时器，转换可记录到跟踪缓冲区。
+ * 状态机只在事件到来或定时器到期时运行，空闲状态不占用主循环时间
+ */
+
+#ifndef STATE_MACHINE_H
+#define STATE_MACHINE_H
+
+#include <Arduino.h>
+#include <array>
+#include "TraceBuffer.h"
+#include "config.h"
+
+#define HSM_NO_TRANSITION 0xFF
+
+/**
+ * 动作函数类型 (进入/退出/转换动作)
+ */
+template <typename Context>
+using HsmAction = void (*)(Context& context);
+
+/**
+ * 条件函数类型
+ */
+template <typename Context>
+using HsmGuard = bool (*)(const Context& context);
+
+/**
+ * 状态定义 (按状态枚举值顺序排列)
+ */
+template <typename State, typename Context>
+struct HsmStateDef {
+    State state;                    // 状态 (仅用于检查排列顺序)
+    State parent;                   // 父状态，等于自身表示顶层状态
+    HsmAction<Context> onEntry;     // 进入动作
+    HsmAction<Context> onExit;      // 退出动作
+};
+
+/**
+ * 转换定义
+ * 同一状态同一事件的多个条件转换需相邻排列，按顺序取第一个条件成立的
+ */
+template <typename State, typename Event, typename Context>
+struct HsmTransition {
+    State from;                     // 源状态 (可为父状态，对全部子状态生效)
+    Event event;                    // 触发事件
+    State to;                       // 目标状态 (叶子状态)
+    HsmGuard<Context> guard;        // 条件 (为空表示无条件)
+    HsmAction<Context> action;      // 转换动作
+    bool internal;                  // 内部转换：只执行动作，不退出/进入状态
+};
+
+/**
+ * 编译期生成的状态机表
+ */
+template <typename State, typename Event, typename Context, size_t NS, size_t NE, size_t NT>
+struct HsmTable {
+    std::array<HsmStateDef<State, Context>, NS> states;
+    std::array<HsmTransition<State, Event, Context>, NT> transitions;
+    uint8_t lookup[NS][NE];         // 每个状态每个事件对应的首个转换 (已包含从父状态继承的)
+    bool valid;                     // 状态定义顺序与枚举值一致、父状态有效
+};
+
+/**
+ * 生成状态机表
+ * @tparam NE 事件数量
+ * @param states 状态定义
+ * @param transitions 转换定义
+ */
+template <size_t NE, typename State, typename Event, typename Context, size_t NS, size_t NT>
+constexpr HsmTable<State, Event, Context, NS, NE, NT> makeHsmTable(
+        const std::array<HsmStateDef<State, Context>, NS>& states,
+        const std::array<HsmTransition<State, Event, Context>, NT>& transitions) {
+    static_assert(NS < HSM_NO_TRANSITION && NT < HSM_NO_TRANSITION, "状态机过大");
+
+    HsmTable<State, Event, Context, NS, NE, NT> table{states, transitions, {}, true};
+
+    for (size_t s = 0; s < NS; s++) {
+        if ((size_t)states[s].state != s || (size_t)states[s].parent >= NS) {
+            table.valid = false;
+        }
+    }
+
+    for (size_t s = 0; s < NS; s++) {
+        for (size_t e = 0; e < NE; e++) {
+            uint8_t found = HSM_NO_TRANSITION;
+
+            // 从本状态沿父状态向上查找
+            size_t current = s;
+            for (size_t depth = 0; depth < NS && found == HSM_NO_TRANSITION; depth++) {
+                for (size_t t = 0; t < NT; t++) {
+                    if ((size_t)transitions[t].from == current && (size_t)transitions[t].event == e) {
+                        found = (uint8_t)t;
+                        break;
+                    }
+                }
+                size_t parent = table.valid ? (size_t)states[current].parent : current;
+                if (parent == current) {
+                    break;
+                }
+                current = parent;
+            }
+            table.lookup[s][e] = found;
+        }
+    }
+    return table;
+}
+
+/**
+ * 层次状态机
+ * 进入/退出动作中可以调用 armTimer()，但不能再次调用 dispatch()
+ */
+template <typename State, typename Event, typename Context, size_t NS, size_t NE, size_t NT>
+class StateMachine {
+public:
+    typedef HsmTable<State, Event, Context, NS, NE, NT> Table;
+
+private:
+    const Table& table;
+    Context& context;
+    State current;
+    State initial;
+    Event timeoutEvent;
+    TraceSource traceSource;
+
+    bool timerArmed;
+    unsigned long timerDeadline;
+    unsigned long stateEnteredAt;
+    uint32_t transitionCount;
+
+    size_t parentOf(size_t state) const {
+        return (size_t)table.states[state].parent;
+    }
+
+    size_t depthOf(size_t state) const {
+        size_t depth = 0;
+        while (parentOf(state) != state) {
+            state = parentOf(state);
+            depth++;
+        }
+        return depth;
+    }
+
+    /**
+     * 执行外部转换：退出到最近公共祖先，再逐级进入目标状态
+     * 目标是当前状态或其祖先时，该状态也退出后重新进入
+     */
+    void transitionTo(size_t target, const HsmTransition<State, Event, Context>& transition) {
+        size_t source = (size_t)current;
+
+        // 求最近公共祖先 (NS表示没有公共祖先)
+        size_t a = source;
+        size_t b = target;
+        size_t depthA = depthOf(a);
+        size_t depthB = depthOf(b);
+        while (depthA > depthB) { a = parentOf(a); depthA--; }
+        while (depthB > depthA) { b = parentOf(b); depthB--; }
+        while (a != b && parentOf(a) != a) { a = parentOf(a); b = parentOf(b); }
+        size_t lca = (a == b) ? a : NS;
+        if (lca == target) {
+            lca = parentOf(target) == target ? NS : parentOf(target);
+        }
+
+        timerArmed = false;
+
+        // 逐级退出
+        size_t state = source;
+        while (state != lca) {
+            if (table.states[state].onExit != nullptr) {
+                table.states[state].onExit(context);
+            }
+            if (parentOf(state) == state) {
+                break;
+            }
+            state = parentOf(state);
+        }
+
+        if (transition.action != nullptr) {
+            transition.action(context);
+        }
+
+        // 自上而下逐级进入
+        size_t path[NS];
+        size_t length = 0;
+        for (state = target; state != lca && length < NS; state = parentOf(state)) {
+            path[length++] = state;
+            if (parentOf(state) == state) {
+                break;
+            }
+        }
+
+        current = (State)target;
+        stateEnteredAt = millis();
+        while (length > 0) {
+            size_t entering = path[--length];
+            if (table.states[entering].onEntry != nullptr) {
+                table.states[entering].onEntry(context);
+            }
+        }
+    }
+
+public:
+    /**
+     * 构造函数
+     * @param stateTable 状态机表 (应为编译期常量)
+     * @param ctx 动作函数的上下文对象
+     * @param initialState 初始状态
+     * @param timeout 定时器到期时派发的事件
+     * @param source 跟踪来源编号
+     */
+    StateMachine(const Table& stateTable, Context& ctx, State initialState, Event timeout, TraceSource source)
+        : table(stateTable),
+          context(ctx),
+          current(initialState),
+          initial(initialState),
+          timeoutEvent(timeout),
+          traceSource(source),
+          timerArmed(false),
+          timerDeadline(0),
+          stateEnteredAt(0),
+          transitionCount(0) {
+    }
+
+    /**
+     * 进入初始状态 (执行各级进入动作)
+     */
+    void start() {
+        current = initial;
+        timerArmed = false;
+        stateEnteredAt = millis();
+
+        size_t path[NS];
+        size_t length = 0;
+        size_t state = (size_t)initial;
+        while (length < NS) {
+            path[length++] = state;
+            if (parentOf(state) == state) {
+                break;
+            }
+            state = parentOf(state);
+        }
+        while (length > 0) {
+            size_t entering = path[--length];
+            if (table.states[entering].onEntry != nullptr) {
+                table.states[entering].onEntry(context);
+            }
+        }
+    }
+
+    /**
+     * 派发事件
+     * @param event 事件
+     * @return 是否发生了转换 (含内部转换)
+     */
+    bool dispatch(Event event) {
+        uint8_t index = table.lookup[(size_t)current][(size_t)event];
+        while (index != HSM_NO_TRANSITION) {
+            // 相邻的同源同事件转换按顺序检查条件
+            State from = table.transitions[index].from;
+            while (index < NT && table.transitions[index].from == from && table.transitions[index].event == event) {
+                const HsmTransition<State, Event, Context>& transition = table.transitions[index];
+                if (transition.guard == nullptr || transition.guard(context)) {
+                    State previous = current;
+                    if (transition.internal) {
+                        if (transition.action != nullptr) {
+                            transition.action(context);
+                        }
+                    } else {
+                        transitionTo((size_t)transition.to, transition);
+                    }
+                    transitionCount++;
+
+                    #if TRACE_ENABLED
+                    TraceBuffer::record(TraceCategory::STATE_TRANSITION, traceSource,
+                                        ((uint16_t)previous << 8) | (uint16_t)current, (uint32_t)event);
+                    #endif
+                    return true;
+                }
+                index++;
+            }
+
+            // 条件都不成立，交给定义这组转换的状态的父状态
+            size_t parent = parentOf((size_t)from);
+            if (parent == (size_t)from) {
+                break;
+            }
+            index = table.lookup[parent][(size_t)event];
+        }
+        return false;
+    }
+
+    /**
+     * 检查定时器 (应在主循环中调用，未设定定时器时立即返回)
+     * @return 是否因定时器到期发生了转换
+     */
+    bool poll() {
+        if (!timerArmed || (long)(millis() - timerDeadline) < 0) {
+            return false;
+        }
+        timerArmed = false;
+        return dispatch(timeoutEvent);
+    }
+
+    /**
+     * 设定定时器 (离开当前状态时自动取消)
+     * @param delayMs 延迟 (ms)
+     */
+    void armTimer(unsigned long delayMs) {
+        timerArmed = true;
+        timerDeadline = millis() + delayMs;
+    }
+
+    /**
+     * 取消定时器
+     */
+    void cancelTimer() {
+        timerArmed = false;
+    }
+
+    /**
+     * 定时器是否已设定
+     */
+    bool isTimerArmed() const {
+        return timerArmed;
+    }
+
+    /**
+     * 距离定时器到期的时间 (ms，未设定时返回0)
+     */
+    unsigned long getTimeToTimer() const {
+        if (!timerArmed) {
+            return 0;
+        }
+        long remaining = (long)(timerDeadline - millis());
+        return remaining > 0 ? remaining : 0;
+    }
+
+    /**
+     * 获取当前 (叶子) 状态
+     */
+    State getState() const {
+        return current;
+    }
+
+    /**
+     * 当前状态是否为指定状态或其子状态
+     * @param state 状态
+     */
+    bool isIn(State state) const {
+        size_t s = (size_t)current;
+        while (true) {
+            if (s == (size_t)state) {
+                return true;
+            }
+            if (parentOf(s) == s) {
+                return false;
+            }
+            s = parentOf(s);
+        }
+    }
+
+    /**
+     * 获取在当前状态停留的时间 (ms)
+     */
+    unsigned long getTimeInState() const {
+        return millis() - stateEnteredAt;
+    }
+
+    /**
+     * 获取累计转换次数
+     */
+    uint32_t getTransitionCount() const {
+        return transitionCount;
+    }
+};
+
+#endif // STATE_MACHINE_H
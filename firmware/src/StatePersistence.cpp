@@ -5,6 +5,11 @@
 #include "StatePersistence.h"
 #include <ArduinoJson.h>
 
+static_assert(sizeof(PersistentStateData) <= EEPROM_CURRENT_STATE_SLOT, "状态记录超出副本大小");
+static_assert(sizeof(PersistentStateHistory) <= EEPROM_STATE_HISTORY_SLOT, "历史记录超出副本大小");
+static_assert(sizeof(PersistentStateStats) <= EEPROM_STATE_STATS_SLOT, "统计记录超出副本大小");
+static_assert(EEPROM_STATE_END_ADDR <= EEPROM_SIZE, "持久化数据超出EEPROM大小");
+
 /**
  * 构造函数
  */
@@ -12,7 +17,9 @@ StatePersistence::StatePersistence()
     : isInitialized(false),
       lastSaveTime(0),
       saveInterval(300000), // 默认5分钟保存间隔
-      autoSaveEnabled(true) {
+      autoSaveEnabled(true),
+      activeMask(0),
+      sequence(0) {
 }
 
 /**
@@ -29,7 +36,7 @@ bool StatePersistence::initialize() {
     DEBUG_PRINTLN("初始化状态持久化管理器...");
     
     // 初始化EEPROM
-    if (!EEPROM.begin(512)) {
+    if (!EEPROM.begin(EEPROM_SIZE)) {
         DEBUG_PRINTLN("✗ EEPROM初始化失败");
         return false;
     }
@@ -38,13 +45,15 @@ bool StatePersistence::initialize() {
     if (!hasValidData()) {
         DEBUG_PRINTLN("EEPROM中无有效数据，执行初始化...");
         initializeEEPROM();
+    } else if (getDataVersion() != STATE_DATA_VERSION) {
+        migrateData(getDataVersion());
     } else {
         DEBUG_PRINTLN("✓ 发现有效的持久化数据");
     }
     
-    // 验证数据完整性
-    if (!verifyDataIntegrity()) {
-        DEBUG_PRINTLN("⚠ 数据完整性检查失败，尝试修复...");
+    // 一次扫描选出每类记录的有效副本，缺失的记录单独重建
+    if (selectActiveCopies() > 0) {
+        DEBUG_PRINTLN("⚠ 部分记录两份副本均无效，尝试修复...");
         if (!repairCorruptedData()) {
             DEBUG_PRINTLN("✗ 数据修复失败，重新初始化");
             initializeEEPROM();
@@ -54,7 +63,7 @@ bool StatePersistence::initialize() {
     }
     
     isInitialized = true;
-    DEBUG_PRINTLN("✓ 状态持久化管理器初始化成功");
+    DEBUG_PRINTF("✓ 状态持久化管理器初始化成功 (活动副本: 0x%02X, 序号: %lu)\n", activeMask, (unsigned long)sequence);
     return true;
 }
 
@@ -62,50 +71,40 @@ bool StatePersistence::initialize() {
  * 初始化EEPROM
  */
 void StatePersistence::initializeEEPROM() {
-    // 写入魔数
+    // 写入魔数和版本，两份副本都视为无效
     EEPROM.writeUShort(EEPROM_STATE_MAGIC_ADDR, STATE_MAGIC_NUMBER);
+    EEPROM.write(EEPROM_STATE_VERSION_ADDR, STATE_DATA_VERSION);
+    for (int i = EEPROM_CURRENT_STATE_ADDR; i < EEPROM_STATE_END_ADDR; i++) {
+        EEPROM.write(i, 0);
+    }
+    activeMask = 0;
+    sequence = 0;
     
     // 初始化当前状态数据
-    PersistentStateData initialState = {
-        .currentState = PlantState::UNKNOWN,
-        .previousState = PlantState::UNKNOWN,
-        .stateStartTime = 0,
-        .lastUpdateTime = 0,
-        .healthScore = 0,
-        .lastSoilMoisture = 0,
-        .lastLightLevel = 0,
-        .lastTemperature = 0,
+    PlantStatus initialStatus = {
+        .state = PlantState::UNKNOWN,
+        .soilMoisture = 0,
+        .lightLevel = 0,
+        .temperature = 0,
+        .airHumidity = 0,
+        .timestamp = 0,
         .needsAttention = false,
-        .checksum = 0
+        .statusMessage = "",
+        .healthScore = 0
     };
-    initialState.checksum = calculateChecksum(&initialState, sizeof(initialState) - sizeof(uint32_t));
-    writeToEEPROM(EEPROM_CURRENT_STATE_ADDR, &initialState, sizeof(initialState));
+    PersistentStateData initialState = buildStateData(initialStatus);
+    stageRecord(PersistentRecord::CURRENT_STATE, initialState);
     
     // 初始化历史记录
-    PersistentStateHistory initialHistory = {
-        .recordCount = 0,
-        .nextIndex = 0,
-        .checksum = 0
-    };
-    initialHistory.checksum = calculateChecksum(&initialHistory, sizeof(initialHistory) - sizeof(uint32_t));
-    writeToEEPROM(EEPROM_STATE_HISTORY_ADDR, &initialHistory, sizeof(initialHistory));
+    PersistentStateHistory initialHistory = emptyHistoryData();
+    stageRecord(PersistentRecord::HISTORY, initialHistory);
     
     // 初始化统计信息
-    PersistentStateStats initialStats = {
-        .totalEvaluations = 0,
-        .stateChanges = 0,
-        .timeInHealthy = 0,
-        .timeInNeedsWater = 0,
-        .timeInNeedsLight = 0,
-        .timeInCritical = 0,
-        .averageHealthScore = 0.0,
-        .lastStateChange = 0,
-        .checksum = 0
-    };
-    initialStats.checksum = calculateChecksum(&initialStats, sizeof(initialStats) - sizeof(uint32_t));
-    writeToEEPROM(EEPROM_STATE_STATS_ADDR, &initialStats, sizeof(initialStats));
+    StateStats emptyStats = {};
+    PersistentStateStats initialStats = buildStatsData(emptyStats);
+    stageRecord(PersistentRecord::STATS, initialStats);
     
-    EEPROM.commit();
+    commitRecords(0x07);
     DEBUG_PRINTLN("EEPROM初始化完成");
 }
 
@@ -159,14 +158,133 @@ bool StatePersistence::readFromEEPROM(int address, void* data, size_t size) {
 }
 
 /**
- * 保存当前状态
+ * 获取记录副本的地址
  */
-bool StatePersistence::saveCurrentState(const PlantStatus& status) {
-    if (!isInitialized) {
-        DEBUG_PRINTLN("持久化管理器未初始化");
+int StatePersistence::recordAddress(PersistentRecord record, int copy) {
+    switch (record) {
+        case PersistentRecord::CURRENT_STATE:
+            return EEPROM_CURRENT_STATE_ADDR + copy * EEPROM_CURRENT_STATE_SLOT;
+        case PersistentRecord::HISTORY:
+            return EEPROM_STATE_HISTORY_ADDR + copy * EEPROM_STATE_HISTORY_SLOT;
+        case PersistentRecord::STATS:
+        default:
+            return EEPROM_STATE_STATS_ADDR + copy * EEPROM_STATE_STATS_SLOT;
+    }
+}
+
+/**
+ * 获取记录的活动副本编号
+ */
+int StatePersistence::activeCopy(PersistentRecord record) const {
+    return (activeMask >> (uint8_t)record) & 0x01;
+}
+
+/**
+ * 把记录写入非活动副本 (尚未提交)
+ */
+template <typename T>
+bool StatePersistence::stageRecord(PersistentRecord record, T& data) {
+    data.sequence = ++sequence;
+    data.checksum = calculateChecksum(&data, sizeof(T) - sizeof(uint32_t));
+    return writeToEEPROM(recordAddress(record, activeCopy(record) ^ 1), &data, sizeof(T));
+}
+
+/**
+ * 读取记录的指定副本并校验
+ */
+template <typename T>
+bool StatePersistence::readRecord(PersistentRecord record, int copy, T& data) {
+    if (!readFromEEPROM(recordAddress(record, copy), &data, sizeof(T))) {
         return false;
     }
+    return data.sequence != 0 &&
+           verifyChecksum(&data, sizeof(T) - sizeof(uint32_t), data.checksum);
+}
+
+/**
+ * 提交：切换指定记录的活动副本
+ * 位图只占一个字节，写入即生效，之前写入的副本此时才成为活动副本
+ */
+bool StatePersistence::commitRecords(uint8_t mask) {
+    activeMask ^= mask;
+    EEPROM.write(EEPROM_STATE_ACTIVE_ADDR, activeMask);
+    return EEPROM.commit();
+}
+
+/**
+ * 一次扫描全部副本，选出每类记录的活动副本
+ * 位图指向的副本有效时使用它，否则退回另一副本 (上一次保存的数据)
+ * @return 两份副本均无效的记录数
+ */
+int StatePersistence::selectActiveCopies() {
+    uint8_t stored = EEPROM.read(EEPROM_STATE_ACTIVE_ADDR);
+    uint8_t selected = 0;
+    uint8_t missing = 0;
+    uint32_t newest = 0;
+    
+    for (uint8_t r = 0; r < (uint8_t)PersistentRecord::COUNT; r++) {
+        PersistentRecord record = (PersistentRecord)r;
+        bool valid[2];
+        uint32_t sequences[2] = {0, 0};
+        
+        for (int copy = 0; copy < 2; copy++) {
+            switch (record) {
+                case PersistentRecord::CURRENT_STATE: {
+                    PersistentStateData data;
+                    valid[copy] = readRecord(record, copy, data);
+                    sequences[copy] = data.sequence;
+                    break;
+                }
+                case PersistentRecord::HISTORY: {
+                    PersistentStateHistory data;
+                    valid[copy] = readRecord(record, copy, data);
+                    sequences[copy] = data.sequence;
+                    break;
+                }
+                default: {
+                    PersistentStateStats data;
+                    valid[copy] = readRecord(record, copy, data);
+                    sequences[copy] = data.sequence;
+                    break;
+                }
+            }
+            if (valid[copy] && sequences[copy] > newest) {
+                newest = sequences[copy];
+            }
+        }
+        
+        int preferred = (stored >> r) & 0x01;
+        if (valid[preferred]) {
+            selected |= preferred << r;
+        } else if (valid[preferred ^ 1]) {
+            selected |= (preferred ^ 1) << r;
+            DEBUG_PRINTF("记录%d活动副本无效，使用另一副本 (序号: %lu)\n", r, (unsigned long)sequences[preferred ^ 1]);
+        } else {
+            selected |= preferred << r;
+            missing |= 1 << r;
+        }
+    }
+    
+    activeMask = selected;
+    sequence = newest;
+    if (selected != stored) {
+        EEPROM.write(EEPROM_STATE_ACTIVE_ADDR, activeMask);
+        EEPROM.commit();
+    }
     
+    int missingCount = 0;
+    for (uint8_t r = 0; r < (uint8_t)PersistentRecord::COUNT; r++) {
+        if (missing & (1 << r)) {
+            missingCount++;
+        }
+    }
+    return missingCount;
+}
+
+/**
+ * 生成持久化状态数据
+ */
+PersistentStateData StatePersistence::buildStateData(const PlantStatus& status) {
     PersistentStateData stateData = {
         .currentState = status.state,
         .previousState = PlantState::UNKNOWN, // 这里需要从StateManager获取
@@ -177,14 +295,75 @@ bool StatePersistence::saveCurrentState(const PlantStatus& status) {
         .lastLightLevel = status.lightLevel,
         .lastTemperature = status.temperature,
         .needsAttention = status.needsAttention,
+        .sequence = 0,
         .checksum = 0
     };
+    return stateData;
+}
+
+/**
+ * 生成持久化历史数据
+ */
+bool StatePersistence::buildHistoryData(const StateChangeRecord* history, int count, PersistentStateHistory& historyData) {
+    if (!history || count <= 0) {
+        return false;
+    }
+    
+    historyData = emptyHistoryData();
+    historyData.recordCount = min(count, MAX_STORED_HISTORY);
+    
+    // 复制最近的记录
+    for (int i = 0; i < historyData.recordCount; i++) {
+        historyData.records[i].previousState = history[i].previousState;
+        historyData.records[i].currentState = history[i].currentState;
+        historyData.records[i].changeTime = history[i].changeTime;
+        historyData.records[i].triggerData = history[i].triggerData;
+    }
+    return true;
+}
+
+/**
+ * 生成空的持久化历史数据
+ */
+PersistentStateHistory StatePersistence::emptyHistoryData() {
+    PersistentStateHistory historyData;
+    memset(&historyData, 0, sizeof(historyData));
+    return historyData;
+}
+
+/**
+ * 生成持久化统计数据
+ */
+PersistentStateStats StatePersistence::buildStatsData(const StateStats& stats) {
+    PersistentStateStats statsData = {
+        .totalEvaluations = stats.totalEvaluations,
+        .stateChanges = stats.stateChanges,
+        .timeInHealthy = stats.timeInHealthy,
+        .timeInNeedsWater = stats.timeInNeedsWater,
+        .timeInNeedsLight = stats.timeInNeedsLight,
+        .timeInCritical = stats.timeInCritical,
+        .averageHealthScore = stats.averageHealthScore,
+        .lastStateChange = stats.lastStateChange,
+        .sequence = 0,
+        .checksum = 0
+    };
+    return statsData;
+}
+
+/**
+ * 保存当前状态
+ */
+bool StatePersistence::saveCurrentState(const PlantStatus& status) {
+    if (!isInitialized) {
+        DEBUG_PRINTLN("持久化管理器未初始化");
+        return false;
+    }
     
-    stateData.checksum = calculateChecksum(&stateData, sizeof(stateData) - sizeof(uint32_t));
+    PersistentStateData stateData = buildStateData(status);
     
-    bool success = writeToEEPROM(EEPROM_CURRENT_STATE_ADDR, &stateData, sizeof(stateData));
+    bool success = stageRecord(PersistentRecord::CURRENT_STATE, stateData) &&
+                   commitRecords(1 << (uint8_t)PersistentRecord::CURRENT_STATE);
     if (success) {
-        EEPROM.commit();
         lastSaveTime = millis();
         DEBUG_PRINTLN("当前状态保存成功");
     } else {
@@ -204,13 +383,7 @@ bool StatePersistence::loadCurrentState(PlantStatus& status) {
     }
     
     PersistentStateData stateData;
-    if (!readFromEEPROM(EEPROM_CURRENT_STATE_ADDR, &stateData, sizeof(stateData))) {
-        DEBUG_PRINTLN("读取状态数据失败");
-        return false;
-    }
-    
-    // 验证校验和
-    if (!verifyChecksum(&stateData, sizeof(stateData) - sizeof(uint32_t), stateData.checksum)) {
+    if (!readRecord(PersistentRecord::CURRENT_STATE, activeCopy(PersistentRecord::CURRENT_STATE), stateData)) {
         DEBUG_PRINTLN("状态数据校验和验证失败");
         return false;
     }
@@ -236,24 +409,18 @@ bool StatePersistence::loadCurrentState(PlantStatus& status) {
  * 保存状态历史记录
  */
 bool StatePersistence::saveStateHistory(const StateChangeRecord* history, int count) {
-    if (!isInitialized || !history || count <= 0) {
+    if (!isInitialized) {
         return false;
     }
     
     PersistentStateHistory historyData;
-    historyData.recordCount = min(count, MAX_STORED_HISTORY);
-    historyData.nextIndex = 0;
-    
-    // 复制最近的记录
-    for (int i = 0; i < historyData.recordCount; i++) {
-        historyData.records[i] = history[i];
+    if (!buildHistoryData(history, count, historyData)) {
+        return false;
     }
     
-    historyData.checksum = calculateChecksum(&historyData, sizeof(historyData) - sizeof(uint32_t));
-    
-    bool success = writeToEEPROM(EEPROM_STATE_HISTORY_ADDR, &historyData, sizeof(historyData));
+    bool success = stageRecord(PersistentRecord::HISTORY, historyData) &&
+                   commitRecords(1 << (uint8_t)PersistentRecord::HISTORY);
     if (success) {
-        EEPROM.commit();
         DEBUG_PRINTF("状态历史保存成功，记录数: %d\n", historyData.recordCount);
     } else {
         DEBUG_PRINTLN("状态历史保存失败");
@@ -271,22 +438,20 @@ int StatePersistence::loadStateHistory(StateChangeRecord* history, int maxCount)
     }
     
     PersistentStateHistory historyData;
-    if (!readFromEEPROM(EEPROM_STATE_HISTORY_ADDR, &historyData, sizeof(historyData))) {
-        DEBUG_PRINTLN("读取历史数据失败");
-        return 0;
-    }
-    
-    // 验证校验和
-    if (!verifyChecksum(&historyData, sizeof(historyData) - sizeof(uint32_t), historyData.checksum)) {
+    if (!readRecord(PersistentRecord::HISTORY, activeCopy(PersistentRecord::HISTORY), historyData)) {
         DEBUG_PRINTLN("历史数据校验和验证失败");
         return 0;
     }
     
     int actualCount = min(historyData.recordCount, maxCount);
     
-    // 复制记录
+    // 复制记录 (变化原因未持久化)
     for (int i = 0; i < actualCount; i++) {
-        history[i] = historyData.records[i];
+        history[i].previousState = historyData.records[i].previousState;
+        history[i].currentState = historyData.records[i].currentState;
+        history[i].changeTime = historyData.records[i].changeTime;
+        history[i].triggerData = historyData.records[i].triggerData;
+        history[i].changeReason = "";
     }
     
     DEBUG_PRINTF("状态历史加载成功，记录数: %d\n", actualCount);
@@ -301,23 +466,11 @@ bool StatePersistence::saveStateStats(const StateStats& stats) {
         return false;
     }
     
-    PersistentStateStats statsData = {
-        .totalEvaluations = stats.totalEvaluations,
-        .stateChanges = stats.stateChanges,
-        .timeInHealthy = stats.timeInHealthy,
-        .timeInNeedsWater = stats.timeInNeedsWater,
-        .timeInNeedsLight = stats.timeInNeedsLight,
-        .timeInCritical = stats.timeInCritical,
-        .averageHealthScore = stats.averageHealthScore,
-        .lastStateChange = stats.lastStateChange,
-        .checksum = 0
-    };
+    PersistentStateStats statsData = buildStatsData(stats);
     
-    statsData.checksum = calculateChecksum(&statsData, sizeof(statsData) - sizeof(uint32_t));
-    
-    bool success = writeToEEPROM(EEPROM_STATE_STATS_ADDR, &statsData, sizeof(statsData));
+    bool success = stageRecord(PersistentRecord::STATS, statsData) &&
+                   commitRecords(1 << (uint8_t)PersistentRecord::STATS);
     if (success) {
-        EEPROM.commit();
         DEBUG_PRINTLN("统计信息保存成功");
     } else {
         DEBUG_PRINTLN("统计信息保存失败");
@@ -335,13 +488,7 @@ bool StatePersistence::loadStateStats(StateStats& stats) {
     }
     
     PersistentStateStats statsData;
-    if (!readFromEEPROM(EEPROM_STATE_STATS_ADDR, &statsData, sizeof(statsData))) {
-        DEBUG_PRINTLN("读取统计数据失败");
-        return false;
-    }
-    
-    // 验证校验和
-    if (!verifyChecksum(&statsData, sizeof(statsData) - sizeof(uint32_t), statsData.checksum)) {
+    if (!readRecord(PersistentRecord::STATS, activeCopy(PersistentRecord::STATS), statsData)) {
         DEBUG_PRINTLN("统计数据校验和验证失败");
         return false;
     }
@@ -364,28 +511,37 @@ bool StatePersistence::loadStateStats(StateStats& stats) {
 
 /**
  * 保存完整状态数据
+ * 三类记录先全部写入非活动副本，再一次性切换，断电时不会出现新旧数据混合
  */
 bool StatePersistence::saveCompleteState(StateManager* stateManager) {
-    if (!stateManager) {
+    if (!stateManager || !isInitialized) {
         return false;
     }
     
     bool success = true;
+    uint8_t mask = 0;
     
-    // 保存当前状态
-    PlantStatus currentStatus = stateManager->getCurrentStatus();
-    success &= saveCurrentState(currentStatus);
+    // 当前状态
+    PersistentStateData stateData = buildStateData(stateManager->getCurrentStatus());
+    success &= stageRecord(PersistentRecord::CURRENT_STATE, stateData);
+    mask |= 1 << (uint8_t)PersistentRecord::CURRENT_STATE;
     
-    // 保存状态历史
+    // 状态历史
     StateChangeRecord history[10];
     int historyCount = stateManager->getStateHistory(history, 10);
-    if (historyCount > 0) {
-        success &= saveStateHistory(history, historyCount);
+    PersistentStateHistory historyData;
+    if (buildHistoryData(history, historyCount, historyData)) {
+        success &= stageRecord(PersistentRecord::HISTORY, historyData);
+        mask |= 1 << (uint8_t)PersistentRecord::HISTORY;
     }
     
-    // 保存统计信息
-    StateStats stats = stateManager->getStats();
-    success &= saveStateStats(stats);
+    // 统计信息
+    PersistentStateStats statsData = buildStatsData(stateManager->getStats());
+    success &= stageRecord(PersistentRecord::STATS, statsData);
+    mask |= 1 << (uint8_t)PersistentRecord::STATS;
+    
+    // 任一记录写入失败则不提交，活动副本保持不变
+    success = success && commitRecords(mask);
     
     if (success) {
         lastSaveTime = millis();
@@ -452,9 +608,11 @@ bool StatePersistence::clearAllData() {
     EEPROM.writeUShort(EEPROM_STATE_MAGIC_ADDR, 0);
     
     // 清除所有数据区域
-    for (int i = EEPROM_STATE_BASE_ADDR; i < EEPROM_STATE_BASE_ADDR + 300; i++) {
+    for (int i = EEPROM_STATE_BASE_ADDR; i < EEPROM_STATE_END_ADDR; i++) {
         EEPROM.write(i, 0);
     }
+    activeMask = 0;
+    sequence = 0;
     
     bool success = EEPROM.commit();
     
@@ -471,7 +629,7 @@ bool StatePersistence::clearAllData() {
  * 获取EEPROM使用情况
  */
 int StatePersistence::getEEPROMUsage() {
-    return sizeof(PersistentStateData) + sizeof(PersistentStateHistory) + sizeof(PersistentStateStats) + 2; // +2 for magic number
+    return EEPROM_STATE_END_ADDR - EEPROM_STATE_BASE_ADDR; // 头部 + 两份副本
 }
 
 /**
@@ -508,37 +666,25 @@ bool StatePersistence::performAutoSave(StateManager* stateManager) {
 }
 
 /**
- * 验证数据完整性
+ * 验证数据完整性 (各类记录的活动副本均有效)
  */
 bool StatePersistence::verifyDataIntegrity() {
     if (!hasValidData()) {
         return false;
     }
     
-    // 验证当前状态数据
     PersistentStateData stateData;
-    if (!readFromEEPROM(EEPROM_CURRENT_STATE_ADDR, &stateData, sizeof(stateData))) {
-        return false;
-    }
-    if (!verifyChecksum(&stateData, sizeof(stateData) - sizeof(uint32_t), stateData.checksum)) {
+    if (!readRecord(PersistentRecord::CURRENT_STATE, activeCopy(PersistentRecord::CURRENT_STATE), stateData)) {
         return false;
     }
     
-    // 验证历史数据
     PersistentStateHistory historyData;
-    if (!readFromEEPROM(EEPROM_STATE_HISTORY_ADDR, &historyData, sizeof(historyData))) {
-        return false;
-    }
-    if (!verifyChecksum(&historyData, sizeof(historyData) - sizeof(uint32_t), historyData.checksum)) {
+    if (!readRecord(PersistentRecord::HISTORY, activeCopy(PersistentRecord::HISTORY), historyData)) {
         return false;
     }
     
-    // 验证统计数据
     PersistentStateStats statsData;
-    if (!readFromEEPROM(EEPROM_STATE_STATS_ADDR, &statsData, sizeof(statsData))) {
-        return false;
-    }
-    if (!verifyChecksum(&statsData, sizeof(statsData) - sizeof(uint32_t), statsData.checksum)) {
+    if (!readRecord(PersistentRecord::STATS, activeCopy(PersistentRecord::STATS), statsData)) {
         return false;
     }
     
@@ -547,44 +693,54 @@ bool StatePersistence::verifyDataIntegrity() {
 
 /**
  * 修复损坏的数据
+ * 先退回仍然有效的另一副本，只有两份副本都损坏的记录才重新初始化
  */
 bool StatePersistence::repairCorruptedData() {
     DEBUG_PRINTLN("尝试修复损坏的数据...");
     
-    // 简单的修复策略：重新初始化损坏的部分
-    bool repaired = false;
+    selectActiveCopies();
+    
+    uint8_t mask = 0;
     
-    // 检查并修复当前状态数据
     PersistentStateData stateData;
-    if (!readFromEEPROM(EEPROM_CURRENT_STATE_ADDR, &stateData, sizeof(stateData)) ||
-        !verifyChecksum(&stateData, sizeof(stateData) - sizeof(uint32_t), stateData.checksum)) {
-        
-        // 重新初始化状态数据
-        PersistentStateData newStateData = {
-            .currentState = PlantState::UNKNOWN,
-            .previousState = PlantState::UNKNOWN,
-            .stateStartTime = millis(),
-            .lastUpdateTime = millis(),
-            .healthScore = 0,
-            .lastSoilMoisture = 0,
-            .lastLightLevel = 0,
-            .lastTemperature = 0,
+    if (!readRecord(PersistentRecord::CURRENT_STATE, activeCopy(PersistentRecord::CURRENT_STATE), stateData)) {
+        PlantStatus emptyStatus = {
+            .state = PlantState::UNKNOWN,
+            .soilMoisture = 0,
+            .lightLevel = 0,
+            .temperature = 0,
+            .airHumidity = 0,
+            .timestamp = 0,
             .needsAttention = false,
-            .checksum = 0
+            .statusMessage = "",
+            .healthScore = 0
         };
-        newStateData.checksum = calculateChecksum(&newStateData, sizeof(newStateData) - sizeof(uint32_t));
-        writeToEEPROM(EEPROM_CURRENT_STATE_ADDR, &newStateData, sizeof(newStateData));
-        repaired = true;
+        stateData = buildStateData(emptyStatus);
+        stageRecord(PersistentRecord::CURRENT_STATE, stateData);
+        mask |= 1 << (uint8_t)PersistentRecord::CURRENT_STATE;
     }
     
-    // 类似地修复其他数据...
+    PersistentStateHistory historyData;
+    if (!readRecord(PersistentRecord::HISTORY, activeCopy(PersistentRecord::HISTORY), historyData)) {
+        historyData = emptyHistoryData();
+        stageRecord(PersistentRecord::HISTORY, historyData);
+        mask |= 1 << (uint8_t)PersistentRecord::HISTORY;
+    }
     
-    if (repaired) {
-        EEPROM.commit();
-        DEBUG_PRINTLN("数据修复完成");
+    PersistentStateStats statsData;
+    if (!readRecord(PersistentRecord::STATS, activeCopy(PersistentRecord::STATS), statsData)) {
+        StateStats emptyStats = {};
+        statsData = buildStatsData(emptyStats);
+        stageRecord(PersistentRecord::STATS, statsData);
+        mask |= 1 << (uint8_t)PersistentRecord::STATS;
     }
     
-    return repaired;
+    if (mask != 0 && !commitRecords(mask)) {
+        return false;
+    }
+    
+    DEBUG_PRINTF("数据修复完成，重建记录位图: 0x%02X\n", mask);
+    return verifyDataIntegrity();
 }
 
 /**
@@ -606,6 +762,8 @@ String StatePersistence::getPersistenceInfo() const {
     doc["last_save_time"] = lastSaveTime;
     doc["eeprom_usage"] = getEEPROMUsage();
     doc["has_valid_data"] = hasValidData();
+    doc["active_copies"] = activeMask;
+    doc["sequence"] = sequence;
     
     String result;
     serializeJson(doc, result);
@@ -638,35 +796,80 @@ bool StatePersistence::performSelfTest() {
 }
 
 /**
- * 备份数据（简化实现）
+ * 备份数据：把各类记录的活动副本复制到另一副本
+ * 之后任一副本损坏都可以从另一副本恢复
  */
 bool StatePersistence::backupData() {
-    // 简化实现：这里可以实现数据备份到另一个EEPROM区域
-    DEBUG_PRINTLN("数据备份功能待实现");
-    return true;
+    if (!isInitialized || !verifyDataIntegrity()) {
+        DEBUG_PRINTLN("活动副本无效，无法备份");
+        return false;
+    }
+    
+    for (uint8_t r = 0; r < (uint8_t)PersistentRecord::COUNT; r++) {
+        PersistentRecord record = (PersistentRecord)r;
+        int from = recordAddress(record, activeCopy(record));
+        int to = recordAddress(record, activeCopy(record) ^ 1);
+        int size = recordAddress(record, 1) - recordAddress(record, 0);
+        for (int i = 0; i < size; i++) {
+            EEPROM.write(to + i, EEPROM.read(from + i));
+        }
+    }
+    
+    bool success = EEPROM.commit();
+    DEBUG_PRINTLN(success ? "数据备份完成" : "数据备份失败");
+    return success;
 }
 
 /**
- * 从备份恢复数据（简化实现）
+ * 从备份恢复数据：切换到另一副本 (上一次保存或备份的数据)
+ * 只切换另一副本有效的记录
  */
 bool StatePersistence::restoreFromBackup() {
-    // 简化实现：这里可以实现从备份区域恢复数据
-    DEBUG_PRINTLN("数据恢复功能待实现");
-    return true;
+    if (!isInitialized) {
+        return false;
+    }
+    
+    uint8_t mask = 0;
+    
+    PersistentStateData stateData;
+    if (readRecord(PersistentRecord::CURRENT_STATE, activeCopy(PersistentRecord::CURRENT_STATE) ^ 1, stateData)) {
+        mask |= 1 << (uint8_t)PersistentRecord::CURRENT_STATE;
+    }
+    
+    PersistentStateHistory historyData;
+    if (readRecord(PersistentRecord::HISTORY, activeCopy(PersistentRecord::HISTORY) ^ 1, historyData)) {
+        mask |= 1 << (uint8_t)PersistentRecord::HISTORY;
+    }
+    
+    PersistentStateStats statsData;
+    if (readRecord(PersistentRecord::STATS, activeCopy(PersistentRecord::STATS) ^ 1, statsData)) {
+        mask |= 1 << (uint8_t)PersistentRecord::STATS;
+    }
+    
+    if (mask == 0) {
+        DEBUG_PRINTLN("备用副本均无效，无法恢复");
+        return false;
+    }
+    
+    bool success = commitRecords(mask);
+    DEBUG_PRINTF("从备用副本恢复数据 (记录位图: 0x%02X) %s\n", mask, success ? "成功" : "失败");
+    return success;
 }
 
 /**
  * 获取数据版本
  */
 uint16_t StatePersistence::getDataVersion() {
-    return 1; // 当前版本号
+    return EEPROM.read(EEPROM_STATE_VERSION_ADDR);
 }
 
 /**
  * 迁移数据（简化实现）
  */
 bool StatePersistence::migrateData(uint16_t oldVersion) {
-    DEBUG_PRINTF("数据迁移: v%d -> v%d\n", oldVersion, getDataVersion());
-    // 这里可以实现版本间的数据迁移逻辑
+    DEBUG_PRINTF("数据迁移: v%d -> v%d\n", oldVersion, STATE_DATA_VERSION);
+    
+    // v1 为单副本布局，历史记录中直接保存了String对象，无法可靠迁移，重新初始化
+    initializeEEPROM();
     return true;
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 /**
  * AI智能植物养护机器人 - 状态持久化管理器
  * 负责状态数据的持久化存储和恢复
+ * 每类记录保存两份 (A/B)，写入总是写到非活动副本，最后改写头部的一个字节切换活动副本，
+ * 写入过程中断电时原活动副本保持完整
  */
 
 #ifndef STATE_PERSISTENCE_H
@@ -11,16 +13,33 @@
 #include "StateManager.h"
 #include "config.h"
 
-// EEPROM地址分配
+// EEPROM地址分配 (每类记录两个副本)
 #define EEPROM_STATE_BASE_ADDR 200
 #define EEPROM_STATE_MAGIC_ADDR EEPROM_STATE_BASE_ADDR
-#define EEPROM_CURRENT_STATE_ADDR (EEPROM_STATE_BASE_ADDR + 2)
-#define EEPROM_STATE_HISTORY_ADDR (EEPROM_STATE_BASE_ADDR + 50)
-#define EEPROM_STATE_STATS_ADDR (EEPROM_STATE_BASE_ADDR + 200)
+#define EEPROM_STATE_VERSION_ADDR (EEPROM_STATE_BASE_ADDR + 2)
+#define EEPROM_STATE_ACTIVE_ADDR (EEPROM_STATE_BASE_ADDR + 3)     // 活动副本位图 (提交点)
+#define EEPROM_CURRENT_STATE_ADDR (EEPROM_STATE_BASE_ADDR + 4)
+#define EEPROM_CURRENT_STATE_SLOT 48
+#define EEPROM_STATE_HISTORY_ADDR (EEPROM_CURRENT_STATE_ADDR + 2 * EEPROM_CURRENT_STATE_SLOT)
+#define EEPROM_STATE_HISTORY_SLOT 200
+#define EEPROM_STATE_STATS_ADDR (EEPROM_STATE_HISTORY_ADDR + 2 * EEPROM_STATE_HISTORY_SLOT)
+#define EEPROM_STATE_STATS_SLOT 48
+#define EEPROM_STATE_END_ADDR (EEPROM_STATE_STATS_ADDR + 2 * EEPROM_STATE_STATS_SLOT)
 
 #define STATE_MAGIC_NUMBER 0x5678
+#define STATE_DATA_VERSION 2  // v2: A/B 双副本布局
 #define MAX_STORED_HISTORY 5  // 存储最近5条状态变化记录
 
+/**
+ * 持久化记录类别 (对应活动副本位图中的位)
+ */
+enum class PersistentRecord : uint8_t {
+    CURRENT_STATE = 0,
+    HISTORY = 1,
+    STATS = 2,
+    COUNT = 3
+};
+
 /**
  * 持久化状态数据结构
  */
@@ -34,16 +53,28 @@ struct PersistentStateData {
     float lastLightLevel;           // 最后光照强度
     float lastTemperature;          // 最后温度
     bool needsAttention;            // 是否需要关注
+    uint32_t sequence;              // 写入序号 (0表示无效)
     uint32_t checksum;              // 数据校验和
 };
 
+/**
+ * 持久化的单条状态变化 (不含变化原因字符串)
+ */
+struct PersistentStateChange {
+    PlantState previousState;
+    PlantState currentState;
+    unsigned long changeTime;
+    SensorData triggerData;
+};
+
 /**
  * 持久化状态历史记录
  */
 struct PersistentStateHistory {
-    StateChangeRecord records[MAX_STORED_HISTORY];
+    PersistentStateChange records[MAX_STORED_HISTORY];
     int recordCount;
     int nextIndex;
+    uint32_t sequence;
     uint32_t checksum;
 };
 
@@ -59,6 +90,7 @@ struct PersistentStateStats {
     unsigned long timeInCritical;
     float averageHealthScore;
     unsigned long lastStateChange;
+    uint32_t sequence;
     uint32_t checksum;
 };
 
@@ -71,6 +103,8 @@ private:
     unsigned long lastSaveTime;
     unsigned long saveInterval;     // 保存间隔
     bool autoSaveEnabled;           // 是否启用自动保存
+    uint8_t activeMask;             // 活动副本位图 (第n位对应PersistentRecord n)
+    uint32_t sequence;              // 最近一次写入的序号
     
     // 私有方法
     uint32_t calculateChecksum(const void* data, size_t size);
@@ -78,6 +112,19 @@ private:
     bool writeToEEPROM(int address, const void* data, size_t size);
     bool readFromEEPROM(int address, void* data, size_t size);
     void initializeEEPROM();
+    
+    // A/B 副本
+    static int recordAddress(PersistentRecord record, int copy);
+    int activeCopy(PersistentRecord record) const;
+    template <typename T> bool stageRecord(PersistentRecord record, T& data);
+    template <typename T> bool readRecord(PersistentRecord record, int copy, T& data);
+    bool commitRecords(uint8_t mask);
+    int selectActiveCopies();
+    
+    PersistentStateData buildStateData(const PlantStatus& status);
+    bool buildHistoryData(const StateChangeRecord* history, int count, PersistentStateHistory& historyData);
+    PersistentStateStats buildStatsData(const StateStats& stats);
+    PersistentStateHistory emptyHistoryData();
 
 public:
     /**
@@ -228,13 +275,13 @@ public:
     bool performSelfTest();
     
     /**
-     * 备份当前数据到备用区域
+     * 备份当前数据到备用区域 (把活动副本复制到另一副本，不切换)
      * @return 备份是否成功
      */
     bool backupData();
     
     /**
-     * 从备用区域恢复数据
+     * 从备用区域恢复数据 (切换到另一副本，即回退到上一次保存的数据)
      * @return 恢复是否成功
      */
     bool restoreFromBackup();
@@ -0,0 +1,289 @@
+/**
+ * AI智能植物养护机器人 - 触摸到灯光延迟跟踪实现
+ */
+
+#include "TouchLatencyTracer.h"
+#include <ArduinoJson.h>
+#include "TraceBuffer.h"
+
+const uint16_t TouchLatencyTracer::BUCKET_LIMITS_MS[BUCKET_COUNT - 1] = {
+    10, 20, 30, 40, 50, 75, 100, 150, 200, 300, 500, 1000
+};
+
+TouchLatencyTracer::Stage TouchLatencyTracer::stage = TouchLatencyTracer::Stage::IDLE;
+uint32_t TouchLatencyTracer::hopUs[HOP_COUNT];
+uint32_t TouchLatencyTracer::detectedUs = 0;
+uint32_t TouchLatencyTracer::respondedUs = 0;
+
+uint32_t TouchLatencyTracer::buckets[BUCKET_COUNT];
+uint32_t TouchLatencyTracer::traceCount = 0;
+uint32_t TouchLatencyTracer::withinSloCount = 0;
+uint32_t TouchLatencyTracer::droppedCount = 0;
+uint32_t TouchLatencyTracer::maxTotalUs = 0;
+uint64_t TouchLatencyTracer::hopSumUs[HOP_COUNT];
+uint32_t TouchLatencyTracer::hopMaxUs[HOP_COUNT];
+uint32_t TouchLatencyTracer::dominantCounts[HOP_COUNT];
+
+/**
+ * 触摸传感器判定触摸状态变化
+ */
+void TouchLatencyTracer::onTouchDetected(uint32_t onsetUs, uint32_t onsetGapUs, uint32_t nowUs) {
+    // 已响应但还没出帧就来了新的触摸：上一次无法完成
+    if (stage == Stage::RESPONDED) {
+        droppedCount++;
+    }
+
+    // 按下时刻在上一次采样和本次采样之间均匀分布，取间隔的一半作为期望
+    hopUs[(size_t)LatencyHop::POLL] = onsetGapUs / 2;
+    hopUs[(size_t)LatencyHop::FILTER] = nowUs - onsetUs;
+    hopUs[(size_t)LatencyHop::DISPATCH] = 0;
+    hopUs[(size_t)LatencyHop::FRAME] = 0;
+    detectedUs = nowUs;
+
+    // 按下时的判定不一定有响应 (响应在抬起时给出)，未响应的判定被下一次覆盖，不计为丢弃
+    stage = Stage::DETECTED;
+}
+
+/**
+ * 交互控制器对触摸给出响应
+ */
+void TouchLatencyTracer::onResponse() {
+    if (stage != Stage::DETECTED) {
+        return;
+    }
+
+    respondedUs = micros();
+    hopUs[(size_t)LatencyHop::DISPATCH] = respondedUs - detectedUs;
+    stage = Stage::RESPONDED;
+}
+
+/**
+ * 灯带提交了一帧
+ */
+void TouchLatencyTracer::onFramePushed() {
+    if (stage != Stage::RESPONDED) {
+        return;
+    }
+
+    uint32_t now = micros();
+    if (now - respondedUs > (uint32_t)TOUCH_LATENCY_TIMEOUT_MS * 1000) {
+        // 灯带熄灭或关闭期间的响应没有及时出帧，不计入延迟分布
+        droppedCount++;
+        stage = Stage::IDLE;
+        return;
+    }
+
+    hopUs[(size_t)LatencyHop::FRAME] = now - respondedUs;
+    complete();
+}
+
+/**
+ * 完成一次跟踪，计入统计
+ */
+void TouchLatencyTracer::complete() {
+    stage = Stage::IDLE;
+
+    uint32_t totalUs = 0;
+    uint8_t dominant = 0;
+    for (uint8_t i = 0; i < HOP_COUNT; i++) {
+        totalUs += hopUs[i];
+        hopSumUs[i] += hopUs[i];
+        if (hopUs[i] > hopMaxUs[i]) {
+            hopMaxUs[i] = hopUs[i];
+        }
+        if (hopUs[i] > hopUs[dominant]) {
+            dominant = i;
+        }
+    }
+
+    uint8_t bucket = 0;
+    while (bucket < BUCKET_COUNT - 1 && totalUs > (uint32_t)BUCKET_LIMITS_MS[bucket] * 1000) {
+        bucket++;
+    }
+    buckets[bucket]++;
+
+    bool withinSlo = totalUs <= (uint32_t)TOUCH_LATENCY_SLO_MS * 1000;
+    if (withinSlo) {
+        withinSloCount++;
+    }
+    if (totalUs > maxTotalUs) {
+        maxTotalUs = totalUs;
+    }
+    dominantCounts[dominant]++;
+    traceCount++;
+
+    TraceBuffer::record(TraceCategory::LATENCY, TraceSource::TOUCH,
+                        ((uint16_t)dominant << 8) | (withinSlo ? 1 : 0), totalUs);
+
+    if (!withinSlo) {
+        DEBUG_PRINTF("TouchLatencyTracer: 触摸到灯光 %lu ms 超出目标，主要耗时 %s (%lu ms)\n",
+                     (unsigned long)(totalUs / 1000), getHopName((LatencyHop)dominant),
+                     (unsigned long)(hopUs[dominant] / 1000));
+    }
+}
+
+/**
+ * 清空统计
+ */
+void TouchLatencyTracer::reset() {
+    stage = Stage::IDLE;
+    for (uint8_t i = 0; i < BUCKET_COUNT; i++) {
+        buckets[i] = 0;
+    }
+    for (uint8_t i = 0; i < HOP_COUNT; i++) {
+        hopSumUs[i] = 0;
+        hopMaxUs[i] = 0;
+        dominantCounts[i] = 0;
+    }
+    traceCount = 0;
+    withinSloCount = 0;
+    droppedCount = 0;
+    maxTotalUs = 0;
+}
+
+uint32_t TouchLatencyTracer::getTraceCount() {
+    return traceCount;
+}
+
+uint32_t TouchLatencyTracer::getDroppedCount() {
+    return droppedCount;
+}
+
+/**
+ * 获取延迟分位数
+ */
+uint32_t TouchLatencyTracer::getPercentileMs(float q) {
+    if (traceCount == 0) {
+        return 0;
+    }
+
+    // 第 ceil(q·n) 个样本所在的桶
+    uint32_t rank = (uint32_t)ceilf(constrain(q, 0.0f, 1.0f) * traceCount);
+    if (rank == 0) {
+        rank = 1;
+    }
+
+    uint32_t cumulative = 0;
+    for (uint8_t i = 0; i < BUCKET_COUNT - 1; i++) {
+        cumulative += buckets[i];
+        if (cumulative >= rank) {
+            // 桶上限不会超过实际最大值
+            return min((uint32_t)BUCKET_LIMITS_MS[i], (maxTotalUs + 999) / 1000);
+        }
+    }
+    return (maxTotalUs + 999) / 1000;
+}
+
+/**
+ * 获取达到SLO的比例
+ */
+float TouchLatencyTracer::getSloRatio() {
+    if (traceCount == 0) {
+        return 1.0f;
+    }
+    return (float)withinSloCount / traceCount;
+}
+
+bool TouchLatencyTracer::isSloMet() {
+    return getSloRatio() >= TOUCH_LATENCY_SLO_TARGET;
+}
+
+/**
+ * 获取累计耗时最多的环节
+ */
+LatencyHop TouchLatencyTracer::getDominantHop() {
+    uint8_t dominant = 0;
+    for (uint8_t i = 1; i < HOP_COUNT; i++) {
+        if (hopSumUs[i] > hopSumUs[dominant]) {
+            dominant = i;
+        }
+    }
+    return (LatencyHop)dominant;
+}
+
+float TouchLatencyTracer::getHopAverageMs(LatencyHop hop) {
+    if (traceCount == 0 || hop >= LatencyHop::COUNT) {
+        return 0;
+    }
+    return (float)hopSumUs[(size_t)hop] / traceCount / 1000.0f;
+}
+
+const char* TouchLatencyTracer::getHopName(LatencyHop hop) {
+    switch (hop) {
+        case LatencyHop::POLL:     return "poll";
+        case LatencyHop::FILTER:   return "filter";
+        case LatencyHop::DISPATCH: return "dispatch";
+        case LatencyHop::FRAME:    return "frame";
+        default:                   return "unknown";
+    }
+}
+
+/**
+ * 获取统计信息
+ */
+String TouchLatencyTracer::getInfo() {
+    DynamicJsonDocument doc(768);
+
+    doc["traces"] = traceCount;
+    doc["dropped"] = droppedCount;
+    doc["slo_ms"] = TOUCH_LATENCY_SLO_MS;
+    doc["slo_ratio"] = getSloRatio();
+    doc["slo_met"] = isSloMet();
+    doc["p50_ms"] = getPercentileMs(0.5f);
+    doc["p95_ms"] = getPercentileMs(0.95f);
+    doc["max_ms"] = maxTotalUs / 1000.0f;
+    doc["dominant"] = getHopName(getDominantHop());
+
+    JsonObject hops = doc.createNestedObject("hops");
+    for (uint8_t i = 0; i < HOP_COUNT; i++) {
+        JsonObject hop = hops.createNestedObject(getHopName((LatencyHop)i));
+        hop["avg_ms"] = getHopAverageMs((LatencyHop)i);
+        hop["max_ms"] = hopMaxUs[i] / 1000.0f;
+        hop["dominant"] = dominantCounts[i];
+    }
+
+    JsonArray histogram = doc.createNestedArray("histogram");
+    for (uint8_t i = 0; i < BUCKET_COUNT; i++) {
+        histogram.add(buckets[i]);
+    }
+
+    String result;
+    serializeJson(doc, result);
+    return result;
+}
+
+/**
+ * 通过串口输出直方图和各环节统计
+ */
+void TouchLatencyTracer::printReport() {
+    Serial.printf("=== 触摸到灯光延迟 (%lu次，丢弃%lu) ===\n",
+                  (unsigned long)traceCount, (unsigned long)droppedCount);
+    if (traceCount == 0) {
+        return;
+    }
+
+    Serial.printf("P50 <= %lu ms  P95 <= %lu ms  最大 %lu ms\n",
+                  (unsigned long)getPercentileMs(0.5f), (unsigned long)getPercentileMs(0.95f),
+                  (unsigned long)(maxTotalUs / 1000));
+    Serial.printf("<= %d ms: %.1f%% (目标 %.0f%%) %s\n", TOUCH_LATENCY_SLO_MS,
+                  getSloRatio() * 100, TOUCH_LATENCY_SLO_TARGET * 100,
+                  isSloMet() ? "达标" : "未达标");
+
+    for (uint8_t i = 0; i < BUCKET_COUNT; i++) {
+        if (buckets[i] == 0) {
+            continue;
+        }
+        if (i < BUCKET_COUNT - 1) {
+            Serial.printf("  <= %4u ms: %lu\n", BUCKET_LIMITS_MS[i], (unsigned long)buckets[i]);
+        } else {
+            Serial.printf("  >  %4u ms: %lu\n", BUCKET_LIMITS_MS[i - 1], (unsigned long)buckets[i]);
+        }
+    }
+
+    for (uint8_t i = 0; i < HOP_COUNT; i++) {
+        Serial.printf("  %-8s 平均 %6.1f ms  最大 %6.1f ms  主要耗时 %lu次\n",
+                      getHopName((LatencyHop)i), getHopAverageMs((LatencyHop)i),
+                      hopMaxUs[i] / 1000.0f, (unsigned long)dominantCounts[i]);
+    }
+    Serial.printf("主要耗时环节: %s\n", getHopName(getDominantHop()));
+}
@@ -0,0 +1,143 @@
+/**
+ * AI智能植物养护机器人 - 触摸到灯光延迟跟踪
+ * 从手指按下到灯带亮起要经过多个环节，分别在各自的模块里计时看不出用户感受到的总延迟。
+ * 这里给每次触摸响应打时间戳，把端到端延迟拆成四段：
+ *
+ *   POLL      按下到第一次被采样 (按采样间隔的一半估计，间隔受主循环delay限制)
+ *   FILTER    第一次采到越过阈值的读数到判定触摸 (低通滤波 + 防抖)
+ *   DISPATCH  判定到交互控制器给出响应 (回调分发、提醒确认)
+ *   FRAME     响应到新的一帧提交给灯带 (50FPS帧间隔、电源稳定、RMT驱动忙)
+ *
+ * 总延迟计入固定分桶的直方图，精确统计达到 TOUCH_LATENCY_SLO_MS 的比例，
+ * 并记录每次触摸中耗时最多的环节，每日汇总时输出并清零，用来决定优先优化哪一段。
+ * 每次完成的跟踪同时写入 TraceBuffer。
+ */
+
+#ifndef TOUCH_LATENCY_TRACER_H
+#define TOUCH_LATENCY_TRACER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * 延迟环节
+ */
+enum class LatencyHop : uint8_t {
+    POLL,           // 按下到被采样
+    FILTER,         // 滤波与防抖
+    DISPATCH,       // 事件分发到响应
+    FRAME,          // 响应到灯带出帧
+    COUNT
+};
+
+/**
+ * 触摸到灯光延迟跟踪器 (全局唯一，只应在主循环中调用)
+ */
+class TouchLatencyTracer {
+public:
+    static const uint8_t HOP_COUNT = (uint8_t)LatencyHop::COUNT;
+    static const uint8_t BUCKET_COUNT = 13;
+    static const uint16_t BUCKET_LIMITS_MS[BUCKET_COUNT - 1];   // 各桶上限 (ms)，最后一桶无上限
+
+private:
+    enum class Stage : uint8_t {
+        IDLE,
+        DETECTED,       // 已判定触摸，等待响应
+        RESPONDED       // 已响应，等待出帧
+    };
+
+    static Stage stage;
+    static uint32_t hopUs[HOP_COUNT];       // 当前跟踪各环节耗时 (µs)
+    static uint32_t detectedUs;
+    static uint32_t respondedUs;
+
+    static uint32_t buckets[BUCKET_COUNT];
+    static uint32_t traceCount;
+    static uint32_t withinSloCount;
+    static uint32_t droppedCount;           // 响应后未出帧即被新触摸取代或超时
+    static uint32_t maxTotalUs;
+    static uint64_t hopSumUs[HOP_COUNT];
+    static uint32_t hopMaxUs[HOP_COUNT];
+    static uint32_t dominantCounts[HOP_COUNT];
+
+    static void complete();
+
+public:
+    /**
+     * 触摸传感器判定触摸状态变化 (在分发触摸事件之前调用)
+     * @param onsetUs 第一次采到越过阈值的读数的时刻 (µs)
+     * @param onsetGapUs 该次采样与上一次采样的间隔 (µs)
+     * @param nowUs 判定时刻 (µs)
+     */
+    static void onTouchDetected(uint32_t onsetUs, uint32_t onsetGapUs, uint32_t nowUs);
+
+    /**
+     * 交互控制器对触摸给出响应 (灯光效果已设置)
+     */
+    static void onResponse();
+
+    /**
+     * 灯带提交了一帧 (同步输出已发送完成，异步输出已开始发送)
+     */
+    static void onFramePushed();
+
+    /**
+     * 清空统计
+     */
+    static void reset();
+
+    /**
+     * 获取已完成的跟踪数
+     */
+    static uint32_t getTraceCount();
+
+    /**
+     * 获取丢弃的跟踪数
+     */
+    static uint32_t getDroppedCount();
+
+    /**
+     * 获取延迟分位数 (按直方图桶上限，偏保守)
+     * @param q 分位 (0-1)
+     * @return 延迟上限 (ms)，落在最后一桶时返回最大值，没有样本时返回0
+     */
+    static uint32_t getPercentileMs(float q);
+
+    /**
+     * 获取达到SLO的比例 (没有样本时返回1)
+     */
+    static float getSloRatio();
+
+    /**
+     * 是否满足SLO目标比例
+     */
+    static bool isSloMet();
+
+    /**
+     * 获取累计耗时最多的环节
+     */
+    static LatencyHop getDominantHop();
+
+    /**
+     * 获取环节的平均耗时 (ms)
+     */
+    static float getHopAverageMs(LatencyHop hop);
+
+    /**
+     * 获取环节名称
+     */
+    static const char* getHopName(LatencyHop hop);
+
+    /**
+     * 获取统计信息
+     * @return JSON格式的统计信息
+     */
+    static String getInfo();
+
+    /**
+     * 通过串口输出直方图和各环节统计
+     */
+    static void printReport();
+};
+
+#endif // TOUCH_LATENCY_TRACER_H
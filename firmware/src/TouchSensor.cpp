@@ -3,10 +3,12 @@
  */
 
 #include "TouchSensor.h"
+#include "AdcCalibration.h"
+#include "TouchLatencyTracer.h"
 
 // 默认配置常量
-const int DEFAULT_TOUCH_THRESHOLD = 2000;    // 触摸阈值
-const int DEFAULT_RELEASE_THRESHOLD = 1800;  // 释放阈值
+const int DEFAULT_TOUCH_THRESHOLD = 1650;    // 触摸阈值 (mV)
+const int DEFAULT_RELEASE_THRESHOLD = 1480;  // 释放阈值 (mV)
 const unsigned long DEFAULT_DEBOUNCE_TIME = 50;    // 防抖时间 (ms)
 const unsigned long DEFAULT_HOLD_TIME = 1000;      // 长按时间 (ms)
 const int FILTER_ALPHA = 8;  // 低通滤波器系数 (1/8)
@@ -24,6 +26,10 @@ TouchSensor::TouchSensor(int pin)
     , lastReadTime(0)
     , lastRawValue(0)
     , filteredValue(0)
+    , lastPollMicros(0)
+    , onsetMicros(0)
+    , onsetGapMicros(0)
+    , onsetSeen(false)
     , touchCallback(nullptr)
     , totalTouches(0)
     , totalHolds(0)
@@ -40,8 +46,9 @@ bool TouchSensor::initialize() {
     // 配置ADC引脚
     pinMode(sensorPin, INPUT);
     
-    // 设置ADC分辨率
+    // 设置ADC分辨率并加载校准查找表
     analogReadResolution(adcResolution);
+    AdcCalibration::begin();
     
     // 初始化滤波器
     int initialValue = readRawValue();
@@ -68,6 +75,20 @@ void TouchSensor::update() {
     // 检测触摸状态
     bool currentTouchState = detectTouch(filteredValue);
     
+#if TOUCH_LATENCY_TRACE_ENABLED
+    // 记录原始读数第一次越过阈值的采样，滤波和防抖的延迟从这里算起
+    unsigned long nowMicros = micros();
+    bool rawChanged = detectTouch(rawValue) != lastTouchState;
+    if (rawChanged && !onsetSeen) {
+        onsetSeen = true;
+        onsetMicros = nowMicros;
+        onsetGapMicros = nowMicros - lastPollMicros;
+    } else if (!rawChanged && currentTouchState == lastTouchState) {
+        onsetSeen = false;
+    }
+    lastPollMicros = nowMicros;
+#endif
+    
     // 处理状态变化
     if (currentTouchState != lastTouchState) {
         // 防抖处理
@@ -78,6 +99,7 @@ void TouchSensor::update() {
                 touchStartTime = currentTime;
                 lastTouchTime = currentTime;
                 totalTouches++;
+                traceDetection();
                 triggerEvent(TouchEventType::TOUCH_START, filteredValue);
                 
                 DEBUG_PRINTF("TouchSensor: 触摸开始，压力值: %d\n", filteredValue);
@@ -86,6 +108,7 @@ void TouchSensor::update() {
                 // 结束触摸
                 unsigned long duration = currentTime - touchStartTime;
                 isTouched = false;
+                traceDetection();
                 
                 // 判断是长按还是轻触
                 if (duration >= holdTime) {
@@ -113,8 +136,20 @@ void TouchSensor::update() {
     }
 }
 
+void TouchSensor::traceDetection() {
+#if TOUCH_LATENCY_TRACE_ENABLED
+    unsigned long nowMicros = micros();
+    if (onsetSeen) {
+        TouchLatencyTracer::onTouchDetected(onsetMicros, onsetGapMicros, nowMicros);
+    } else {
+        TouchLatencyTracer::onTouchDetected(nowMicros, 0, nowMicros);
+    }
+    onsetSeen = false;
+#endif
+}
+
 int TouchSensor::readRawValue() {
-    return analogRead(sensorPin);
+    return AdcCalibration::readMillivolts(sensorPin);
 }
 
 int TouchSensor::applyFilter(int rawValue) {
@@ -150,12 +185,12 @@ void TouchSensor::setTouchCallback(TouchCallback callback) {
 }
 
 void TouchSensor::setTouchThreshold(int threshold) {
-    touchThreshold = constrain(threshold, 0, (1 << adcResolution) - 1);
+    touchThreshold = constrain(threshold, 0, (int)AdcCalibration::MAX_MILLIVOLTS);
     DEBUG_PRINTF("TouchSensor: 触摸阈值设置为: %d\n", touchThreshold);
 }
 
 void TouchSensor::setReleaseThreshold(int threshold) {
-    releaseThreshold = constrain(threshold, 0, (1 << adcResolution) - 1);
+    releaseThreshold = constrain(threshold, 0, (int)AdcCalibration::MAX_MILLIVOLTS);
     DEBUG_PRINTF("TouchSensor: 释放阈值设置为: %d\n", releaseThreshold);
 }
 
@@ -25,7 +25,7 @@ enum class TouchEventType {
 struct TouchEvent {
     TouchEventType type;
     unsigned long timestamp;
-    int pressure;           // 压力值 (0-4095)
+    int pressure;           // 压力值 (mV)
     unsigned long duration; // 触摸持续时间 (ms)
 };
 
@@ -57,6 +57,12 @@ private:
     int lastRawValue;
     int filteredValue;
     
+    // 延迟跟踪：第一次采到越过阈值的原始读数的时刻
+    unsigned long lastPollMicros;
+    unsigned long onsetMicros;
+    unsigned long onsetGapMicros;
+    bool onsetSeen;
+    
     // 回调函数
     TouchCallback touchCallback;
     
@@ -71,6 +77,7 @@ private:
     bool detectTouch(int value);
     void processTouch();
     void triggerEvent(TouchEventType type, int pressure, unsigned long duration = 0);
+    void traceDetection();
 
 public:
     /**
@@ -103,13 +110,13 @@ public:
     
     /**
      * 设置触摸阈值
-     * @param threshold 触摸阈值 (0-4095)
+     * @param threshold 触摸阈值 (mV)
      */
     void setTouchThreshold(int threshold);
     
     /**
      * 设置释放阈值
-     * @param threshold 释放阈值 (0-4095)
+     * @param threshold 释放阈值 (mV)
      */
     void setReleaseThreshold(int threshold);
     
@@ -133,7 +140,7 @@ public:
     
     /**
      * 获取当前压力值
-     * @return 压力值 (0-4095)
+     * @return 压力值 (mV)
      */
     int getCurrentPressure() const;
     
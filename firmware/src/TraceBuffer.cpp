@@ -0,0 +1,80 @@
+/**
+ * AI智能植物养护机器人 - 跟踪缓冲区实现
+ */
+
+#include "TraceBuffer.h"
+
+TraceRecord TraceBuffer::records[TRACE_BUFFER_SIZE];
+uint16_t TraceBuffer::head = 0;
+uint32_t TraceBuffer::total = 0;
+
+/**
+ * 写入一条记录
+ */
+void TraceBuffer::record(TraceCategory category, TraceSource source, uint16_t arg0, uint32_t arg1) {
+    TraceRecord& r = records[head];
+    r.timestampUs = micros();
+    r.category = category;
+    r.source = source;
+    r.arg0 = arg0;
+    r.arg1 = arg1;
+
+    head = (head + 1) % TRACE_BUFFER_SIZE;
+    total++;
+}
+
+/**
+ * 读取缓冲区中的记录
+ */
+int TraceBuffer::read(TraceRecord* out, int maxCount) {
+    if (out == nullptr || maxCount <= 0) {
+        return 0;
+    }
+
+    int available = total < TRACE_BUFFER_SIZE ? (int)total : TRACE_BUFFER_SIZE;
+    int count = min(available, maxCount);
+
+    // 取最近的count条，按时间先后输出
+    int start = (head - count + TRACE_BUFFER_SIZE) % TRACE_BUFFER_SIZE;
+    for (int i = 0; i < count; i++) {
+        out[i] = records[(start + i) % TRACE_BUFFER_SIZE];
+    }
+    return count;
+}
+
+/**
+ * 获取累计写入条数
+ */
+uint32_t TraceBuffer::getTotalRecords() {
+    return total;
+}
+
+/**
+ * 清空缓冲区
+ */
+void TraceBuffer::clear() {
+    head = 0;
+    total = 0;
+}
+
+/**
+ * 通过串口输出全部记录
+ */
+void TraceBuffer::dump() {
+    TraceRecord buffer[TRACE_BUFFER_SIZE];
+    int count = read(buffer, TRACE_BUFFER_SIZE);
+
+    Serial.printf("=== Trace (%d/%lu) ===\n", count, (unsigned long)total);
+    for (int i = 0; i < count; i++) {
+        const TraceRecord& r = buffer[i];
+        if (r.category == TraceCategory::STATE_TRANSITION) {
+            Serial.printf("%10lu us  src=%u  %u -> %u  event=%lu\n",
+                          (unsigned long)r.timestampUs, (unsigned)r.source,
+                          r.arg0 >> 8, r.arg0 & 0xFF, (unsigned long)r.arg1);
+        } else {
+            Serial.printf("%10lu us  src=%u  cat=%u  %u %lu\n",
+                          (unsigned long)r.timestampUs, (unsigned)r.source, (unsigned)r.category,
+                          r.arg0, (unsigned long)r.arg1);
+        }
+    }
+}
@@ -0,0 +1,85 @@
+/**
+ * AI智能植物养护机器人 - 跟踪缓冲区
+ * 固定大小的环形缓冲区，以微秒时间戳记录状态机转换等事件，满时覆盖最旧记录，
+ * 可事后通过串口导出，用于分析事件顺序和耗时
+ */
+
+#ifndef TRACE_BUFFER_H
+#define TRACE_BUFFER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * 跟踪记录类别
+ */
+enum class TraceCategory : uint8_t {
+    STATE_TRANSITION,   // 状态机转换 (arg0 = 源状态<<8 | 目标状态，arg1 = 事件)
+    MARK,               // 自定义标记
+    LATENCY             // 端到端延迟 (arg0 = 主要耗时环节<<8 | 是否达标，arg1 = 总延迟µs)
+};
+
+/**
+ * 跟踪来源编号
+ */
+enum class TraceSource : uint8_t {
+    SYSTEM,
+    ALERT_MANAGER,
+    TOUCH
+};
+
+/**
+ * 跟踪记录
+ */
+struct TraceRecord {
+    uint32_t timestampUs;       // 时间戳 (µs)
+    TraceCategory category;     // 类别
+    TraceSource source;         // 来源
+    uint16_t arg0;              // 参数0
+    uint32_t arg1;              // 参数1
+};
+
+/**
+ * 跟踪缓冲区 (全局唯一，只应在主循环中写入)
+ */
+class TraceBuffer {
+private:
+    static TraceRecord records[TRACE_BUFFER_SIZE];
+    static uint16_t head;
+    static uint32_t total;
+
+public:
+    /**
+     * 写入一条记录
+     * @param category 类别
+     * @param source 来源
+     * @param arg0 参数0
+     * @param arg1 参数1
+     */
+    static void record(TraceCategory category, TraceSource source, uint16_t arg0, uint32_t arg1);
+
+    /**
+     * 读取缓冲区中的记录 (从旧到新)
+     * @param out 输出数组
+     * @param maxCount 最多读取条数
+     * @return 实际读取条数
+     */
+    static int read(TraceRecord* out, int maxCount);
+
+    /**
+     * 获取累计写入条数 (含已被覆盖的)
+     */
+    static uint32_t getTotalRecords();
+
+    /**
+     * 清空缓冲区
+     */
+    static void clear();
+
+    /**
+     * 通过串口输出全部记录
+     */
+    static void dump();
+};
+
+#endif // TRACE_BUFFER_H
@@ -0,0 +1,165 @@
+/**
+ * AI智能植物养护机器人 - WiFi发射功率控制器实现
+ */
+
+#include "TxPowerController.h"
+
+/**
+ * 构造函数
+ */
+TxPowerController::TxPowerController()
+    : powerDbm(WIFI_TX_POWER_MAX_DBM),
+      rssiAverage(0),
+      rssiValid(false),
+      lastRssiSample(0),
+      periodAttempts(0),
+      periodFailures(0),
+      stablePeriods(0),
+      lastAdjust(0),
+      adjustCount(0),
+      energyUj(0),
+      bytesSent(0),
+      bytesDelivered(0) {
+}
+
+/**
+ * 恢复最大发射功率
+ */
+void TxPowerController::reset() {
+    powerDbm = WIFI_TX_POWER_MAX_DBM;
+    rssiValid = false;
+    periodAttempts = 0;
+    periodFailures = 0;
+    stablePeriods = 0;
+    lastAdjust = millis();
+}
+
+/**
+ * 输入一次下行RSSI测量
+ */
+void TxPowerController::onRssiSample(int rssi) {
+    // 未连接时WiFi.RSSI()返回0
+    if (rssi >= 0) {
+        return;
+    }
+    if (rssiValid && millis() - lastRssiSample < WIFI_TX_RSSI_SAMPLE_INTERVAL) {
+        return;
+    }
+    lastRssiSample = millis();
+
+    if (!rssiValid) {
+        rssiAverage = rssi;
+        rssiValid = true;
+    } else {
+        rssiAverage += (rssi - rssiAverage) * WIFI_TX_RSSI_ALPHA;
+    }
+}
+
+/**
+ * 记录一次数据发送结果
+ */
+void TxPowerController::recordTransmission(size_t bytes, bool delivered) {
+    periodAttempts++;
+    bytesSent += bytes;
+    energyUj += bytes * energyPerByteAt(powerDbm);
+
+    if (delivered) {
+        bytesDelivered += bytes;
+    } else {
+        periodFailures++;
+    }
+}
+
+/**
+ * 周期性调整
+ * 估计上行RSSI低于目标滞回带或失败率过高时快速升功率；
+ * 高于滞回带且连续数个周期无失败时才降1dB，滞回带宽大于升降步长，稳态下不会来回调整
+ */
+bool TxPowerController::update() {
+    unsigned long currentTime = millis();
+    if (currentTime - lastAdjust < WIFI_TX_POWER_INTERVAL) {
+        return false;
+    }
+    lastAdjust = currentTime;
+
+    float failureRate = periodAttempts > 0 ? (float)periodFailures / periodAttempts : 0;
+    bool anyFailure = periodFailures > 0;
+    periodAttempts = 0;
+    periodFailures = 0;
+
+    if (!rssiValid) {
+        return false;
+    }
+
+    float uplink = getEstimatedUplinkRssi();
+    float newPower = powerDbm;
+
+    if (failureRate > WIFI_TX_FAILURE_RATE_LIMIT ||
+        uplink < WIFI_TX_TARGET_RSSI - WIFI_TX_HYSTERESIS_DB / 2) {
+        newPower = powerDbm + WIFI_TX_POWER_STEP_UP_DB;
+        stablePeriods = 0;
+    } else if (!anyFailure && uplink > WIFI_TX_TARGET_RSSI + WIFI_TX_HYSTERESIS_DB / 2) {
+        if (++stablePeriods >= WIFI_TX_STABLE_PERIODS) {
+            newPower = powerDbm - WIFI_TX_POWER_STEP_DOWN_DB;
+            stablePeriods = 0;
+        }
+    } else {
+        stablePeriods = 0;
+    }
+
+    newPower = constrain(newPower, (float)WIFI_TX_POWER_MIN_DBM, (float)WIFI_TX_POWER_MAX_DBM);
+    if (newPower == powerDbm) {
+        return false;
+    }
+
+    DEBUG_PRINTF("WiFi发射功率: %.0f -> %.0f dBm (RSSI %.0f, 上行估计 %.0f, 失败率 %.0f%%)\n",
+                 powerDbm, newPower, rssiAverage, uplink, failureRate * 100);
+    powerDbm = newPower;
+    adjustCount++;
+    return true;
+}
+
+/**
+ * 获取当前发射功率
+ */
+float TxPowerController::getPowerDbm() const {
+    return powerDbm;
+}
+
+/**
+ * 获取估计的上行RSSI
+ * 路径损耗上下行对称，上行RSSI ≈ 下行RSSI - (路由器功率 - 本机功率)
+ */
+float TxPowerController::getEstimatedUplinkRssi() const {
+    return rssiAverage - (WIFI_TX_AP_POWER_DBM - powerDbm);
+}
+
+/**
+ * 获取每送达字节的平均发射能耗
+ */
+float TxPowerController::getEnergyPerByte() const {
+    return bytesDelivered > 0 ? energyUj / bytesDelivered : 0;
+}
+
+/**
+ * 获取累计发射能耗
+ */
+float TxPowerController::getEnergyUsed() const {
+    return energyUj / 1000.0f;
+}
+
+/**
+ * 获取功率调整次数
+ */
+uint32_t TxPowerController::getAdjustCount() const {
+    return adjustCount;
+}
+
+/**
+ * 按发射电流模型估算每字节能耗
+ * E = 3.3V × I(功率) × 8bit / 有效速率
+ */
+float TxPowerController::energyPerByteAt(float dbm) {
+    float currentMa = WIFI_TX_CURRENT_BASE_MA + WIFI_TX_CURRENT_PER_DBM_MA * dbm;
+    return 3.3f * currentMa / 1000.0f * 8.0f / WIFI_TX_PHY_RATE_MBPS;
+}
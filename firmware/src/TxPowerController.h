@@ -0,0 +1,98 @@
+/**
+ * AI智能植物养护机器人 - WiFi发射功率控制器
+ * 由下行RSSI估计路由器处的上行信号强度，余量充足时逐步降低发射功率，
+ * RSSI变差或传输失败增多时快速提高 (带滞回)，并估算每字节发射能耗
+ */
+
+#ifndef TX_POWER_CONTROLLER_H
+#define TX_POWER_CONTROLLER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * 发射功率控制器类 (不直接操作射频，功率变化后由WiFiManager下发)
+ */
+class TxPowerController {
+private:
+    float powerDbm;
+    float rssiAverage;
+    bool rssiValid;
+    unsigned long lastRssiSample;
+
+    // 当前调整周期内的传输结果
+    uint32_t periodAttempts;
+    uint32_t periodFailures;
+    uint8_t stablePeriods;
+    unsigned long lastAdjust;
+    uint32_t adjustCount;
+
+    // 能耗统计
+    float energyUj;
+    uint32_t bytesSent;
+    uint32_t bytesDelivered;
+
+public:
+    /**
+     * 构造函数
+     */
+    TxPowerController();
+
+    /**
+     * 恢复最大发射功率 (连接建立或断开时调用)
+     */
+    void reset();
+
+    /**
+     * 输入一次下行RSSI测量 (按 WIFI_TX_RSSI_SAMPLE_INTERVAL 节流，可每次循环调用)
+     * @param rssi 接收信号强度 (dBm)
+     */
+    void onRssiSample(int rssi);
+
+    /**
+     * 记录一次数据发送结果
+     * @param bytes 发送字节数
+     * @param delivered 是否送达 (传输层失败视为未送达)
+     */
+    void recordTransmission(size_t bytes, bool delivered);
+
+    /**
+     * 周期性调整 (按 WIFI_TX_POWER_INTERVAL 节流)
+     * @return 发射功率是否变化
+     */
+    bool update();
+
+    /**
+     * 获取当前发射功率 (dBm)
+     */
+    float getPowerDbm() const;
+
+    /**
+     * 获取估计的路由器处上行RSSI (dBm)
+     */
+    float getEstimatedUplinkRssi() const;
+
+    /**
+     * 获取每送达字节的平均发射能耗 (µJ/字节，含失败重发的开销)
+     */
+    float getEnergyPerByte() const;
+
+    /**
+     * 获取累计发射能耗估计 (mJ)
+     */
+    float getEnergyUsed() const;
+
+    /**
+     * 获取功率调整次数
+     */
+    uint32_t getAdjustCount() const;
+
+    /**
+     * 按发射电流模型估算给定功率下每字节的发射能耗
+     * @param dbm 发射功率 (dBm)
+     * @return µJ/字节
+     */
+    static float energyPerByteAt(float dbm);
+};
+
+#endif // TX_POWER_CONTROLLER_H
@@ -0,0 +1,193 @@
+/**
+ * AI智能植物养护机器人 - 上行自适应控制器实现
+ */
+
+#include "UplinkController.h"
+
+/**
+ * 构造函数
+ */
+UplinkController::UplinkController()
+    : batchWindow(UPLINK_BATCH_INITIAL),
+      currentRssi(0),
+      rssiBaseline(0),
+      rssiValid(false),
+      roundAttempts(0),
+      roundFailures(0),
+      roundBytes(0),
+      roundAirTime(0),
+      goodput(0),
+      errorRate(0),
+      statsValid(false),
+      sessionBytes(0),
+      increases(0),
+      decreases(0),
+      deferrals(0) {
+}
+
+/**
+ * 开始新会话
+ */
+void UplinkController::startSession() {
+    batchWindow = UPLINK_BATCH_INITIAL;
+    rssiValid = false;
+    roundAttempts = 0;
+    roundFailures = 0;
+    roundBytes = 0;
+    roundAirTime = 0;
+    goodput = 0;
+    errorRate = 0;
+    statsValid = false;
+    sessionBytes = 0;
+}
+
+/**
+ * 输入当前RSSI和近期平均RSSI
+ */
+void UplinkController::onSignalSample(int rssi, float baseline) {
+    // 未连接时WiFi.RSSI()返回0，历史未填充时平均值为0
+    if (rssi >= 0 || baseline >= 0) {
+        rssiValid = false;
+        return;
+    }
+    currentRssi = rssi;
+    rssiBaseline = baseline;
+    rssiValid = true;
+}
+
+/**
+ * 记录一次发送结果
+ */
+void UplinkController::recordTransmission(size_t bytes, bool delivered, unsigned long elapsedMs) {
+    if (roundAttempts < 0xFFFF) {
+        roundAttempts++;
+    }
+    roundAirTime += elapsedMs;
+
+    if (delivered) {
+        roundBytes += bytes;
+        sessionBytes += bytes;
+    } else if (roundFailures < 0xFFFF) {
+        roundFailures++;
+    }
+}
+
+/**
+ * 结束一轮发送
+ * 有失败即乘性减小；全部送达且窗口是瓶颈时加性增大，窗口没用满说明数据不够，不能据此增大
+ */
+bool UplinkController::endRound(bool windowLimited) {
+    if (roundAttempts == 0) {
+        return false;
+    }
+
+    float roundErrorRate = (float)roundFailures / roundAttempts;
+    float roundGoodput = roundAirTime > 0 ? roundBytes * 1000.0f / roundAirTime : 0;
+    if (!statsValid) {
+        errorRate = roundErrorRate;
+        goodput = roundGoodput;
+        statsValid = true;
+    } else {
+        errorRate += (roundErrorRate - errorRate) * UPLINK_STATS_ALPHA;
+        goodput += (roundGoodput - goodput) * UPLINK_STATS_ALPHA;
+    }
+
+    float newWindow = batchWindow;
+    if (roundFailures > 0) {
+        newWindow = batchWindow * UPLINK_BATCH_DECREASE;
+    } else if (windowLimited) {
+        newWindow = batchWindow + UPLINK_BATCH_INCREASE;
+    }
+    newWindow = constrain(newWindow, (float)UPLINK_BATCH_MIN, (float)UPLINK_BATCH_MAX);
+
+    roundAttempts = 0;
+    roundFailures = 0;
+    roundBytes = 0;
+    roundAirTime = 0;
+
+    if ((int)newWindow == (int)batchWindow) {
+        batchWindow = newWindow;
+        return false;
+    }
+
+    if (newWindow > batchWindow) {
+        increases++;
+    } else {
+        decreases++;
+    }
+    DEBUG_PRINTF("上行窗口: %d -> %d (失败率 %.0f%%, 吞吐 %.0f B/s)\n",
+                 (int)batchWindow, (int)newWindow, errorRate * 100, goodput);
+    batchWindow = newWindow;
+    return true;
+}
+
+/**
+ * 获取本轮允许发送的条数
+ */
+int UplinkController::getBatchSize() const {
+    return (int)batchWindow;
+}
+
+/**
+ * 当前是否是发送非紧急数据的好时机
+ */
+bool UplinkController::isGoodMoment() const {
+    if (!rssiValid) {
+        return true;
+    }
+    return currentRssi >= UPLINK_RSSI_GOOD_DBM ||
+           currentRssi >= rssiBaseline - UPLINK_RSSI_DIP_DB;
+}
+
+/**
+ * 是否发送非紧急数据
+ */
+bool UplinkController::shouldSendDeferrable(unsigned long oldestAgeMs, float queueFill) {
+    if (isGoodMoment() || oldestAgeMs >= UPLINK_MAX_DEFER_MS || queueFill >= UPLINK_FORCE_QUEUE_FILL) {
+        return true;
+    }
+    deferrals++;
+    return false;
+}
+
+/**
+ * 获取平滑后的吞吐量
+ */
+float UplinkController::getGoodput() const {
+    return goodput;
+}
+
+/**
+ * 获取平滑后的失败率
+ */
+float UplinkController::getErrorRate() const {
+    return errorRate;
+}
+
+/**
+ * 获取本会话送达字节数
+ */
+uint32_t UplinkController::getSessionBytes() const {
+    return sessionBytes;
+}
+
+/**
+ * 获取因信号低谷推迟发送的轮数
+ */
+uint32_t UplinkController::getDeferralCount() const {
+    return deferrals;
+}
+
+/**
+ * 获取窗口增加次数
+ */
+uint32_t UplinkController::getIncreaseCount() const {
+    return increases;
+}
+
+/**
+ * 获取窗口减小次数
+ */
+uint32_t UplinkController::getDecreaseCount() const {
+    return decreases;
+}
@@ -0,0 +1,117 @@
+/**
+ * AI智能植物养护机器人 - 上行自适应控制器
+ * 按会话统计送达字节、耗时和失败率，用AIMD调整每轮发送条数：
+ * 一轮全部送达且用满窗口时加一，出现失败时减半；
+ * 非紧急数据 (普通消息、批量传输) 避开RSSI低谷，等信号回到近期平均水平再发，
+ * 推迟时间和队列占用有上限，信号长期不好时仍会发送
+ */
+
+#ifndef UPLINK_CONTROLLER_H
+#define UPLINK_CONTROLLER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * 上行自适应控制器类 (不直接发送数据，由CommunicationProtocol在发送前后调用)
+ */
+class UplinkController {
+private:
+    float batchWindow;
+    int currentRssi;
+    float rssiBaseline;
+    bool rssiValid;
+
+    // 当前一轮
+    uint16_t roundAttempts;
+    uint16_t roundFailures;
+    uint32_t roundBytes;
+    unsigned long roundAirTime;
+
+    // 会话统计
+    float goodput;
+    float errorRate;
+    bool statsValid;
+    uint32_t sessionBytes;
+    uint32_t increases;
+    uint32_t decreases;
+    uint32_t deferrals;
+
+public:
+    /**
+     * 构造函数
+     */
+    UplinkController();
+
+    /**
+     * 开始新会话 (WiFi重新连接后调用)，窗口和统计恢复初始值
+     */
+    void startSession();
+
+    /**
+     * 输入当前RSSI和近期平均RSSI
+     * @param rssi 当前RSSI (dBm，0表示未连接)
+     * @param baseline 近期平均RSSI (dBm，0表示尚无历史)
+     */
+    void onSignalSample(int rssi, float baseline);
+
+    /**
+     * 记录一次发送结果
+     * @param bytes 发送字节数
+     * @param delivered 是否送达
+     * @param elapsedMs 发送耗时 (ms)
+     */
+    void recordTransmission(size_t bytes, bool delivered, unsigned long elapsedMs);
+
+    /**
+     * 结束一轮发送，按本轮结果调整窗口
+     * @param windowLimited 本轮是否因窗口用满而停止 (未用满时不增加窗口)
+     * @return 窗口是否变化
+     */
+    bool endRound(bool windowLimited);
+
+    /**
+     * 获取本轮允许发送的条数
+     */
+    int getBatchSize() const;
+
+    /**
+     * 当前是否是发送非紧急数据的好时机 (不在信号低谷中)
+     */
+    bool isGoodMoment() const;
+
+    /**
+     * 是否发送非紧急数据：好时机、最旧数据推迟过久或队列将满时发送
+     * @param oldestAgeMs 最旧的待发数据已等待的时间 (ms)
+     * @param queueFill 队列占用比例 (0-1)
+     */
+    bool shouldSendDeferrable(unsigned long oldestAgeMs, float queueFill);
+
+    /**
+     * 获取平滑后的吞吐量 (送达字节/秒)
+     */
+    float getGoodput() const;
+
+    /**
+     * 获取平滑后的失败率 (0-1)
+     */
+    float getErrorRate() const;
+
+    /**
+     * 获取本会话送达字节数
+     */
+    uint32_t getSessionBytes() const;
+
+    /**
+     * 获取因信号低谷推迟发送的轮数
+     */
+    uint32_t getDeferralCount() const;
+
+    /**
+     * 获取窗口增加/减小次数
+     */
+    uint32_t getIncreaseCount() const;
+    uint32_t getDecreaseCount() const;
+};
+
+#endif // UPLINK_CONTROLLER_H
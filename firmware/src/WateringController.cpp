@@ -0,0 +1,588 @@
+/**
+ * AI智能植物养护机器人 - 自动浇水控制器实现
+ */
+
+#include "WateringController.h"
+#include <ArduinoJson.h>
+
+static const char* WATERING_NAMESPACE = "watering";
+static const unsigned long DAY_MS = 86400000UL;
+
+/**
+ * 构造函数
+ */
+WateringController::WateringController()
+    : state(WateringState::IDLE),
+      lastFault(WateringFault::NONE),
+      enabled(false),
+      initialized(false),
+      triggerMoisture(MOISTURE_THRESHOLD),
+      targetMoisture(MOISTURE_THRESHOLD + WATERING_TARGET_RISE),
+      lastMoisture(0),
+      lastSampleTime(0),
+      cycleStartMoisture(0),
+      cyclePumpSeconds(0),
+      cyclePulses(0),
+      dryRunCount(0),
+      cutoffTimer(nullptr),
+      pumpStartTime(0),
+      pulseMs(0),
+      pulseBaseline(0),
+      expectedRise(0),
+      soakStartTime(0),
+      soakCount(0),
+      cooldownStartTime(0),
+      dayStartTime(0),
+      pumpSecondsToday(0),
+      logHead(0),
+      logCount(0),
+      eventCallback(nullptr),
+      faultCallback(nullptr) {
+
+    model = {
+        .gainPerSecond = WATERING_DEFAULT_GAIN,
+        .infiltrationMs = WATERING_DEFAULT_INFILTRATION_MS,
+        .samples = 0
+    };
+}
+
+/**
+ * 初始化水泵输出并加载土壤响应模型
+ */
+bool WateringController::begin() {
+    DEBUG_PRINTLN("初始化自动浇水控制器...");
+
+    // 水泵默认关闭
+    pinMode(PUMP_PIN, OUTPUT);
+    digitalWrite(PUMP_PIN, LOW);
+
+    // 独立于主循环的停泵定时器，每个脉冲开泵时按脉冲时长单次启动
+    if (cutoffTimer == nullptr) {
+        esp_timer_create_args_t timerArgs = {};
+        timerArgs.callback = cutoffCallback;
+        timerArgs.arg = this;
+        timerArgs.name = "pump_cutoff";
+        if (esp_timer_create(&timerArgs, &cutoffTimer) != ESP_OK) {
+            DEBUG_PRINTLN("✗ 停泵定时器创建失败，仅由主循环停泵");
+            cutoffTimer = nullptr;
+        }
+    }
+
+    loadModel();
+    dayStartTime = millis();
+    initialized = true;
+
+    DEBUG_PRINTF("✓ 浇水模型: %.2f%%/s, 入渗%lums, 已学习%u次\n",
+                 model.gainPerSecond, model.infiltrationMs, model.samples);
+    return true;
+}
+
+/**
+ * 周期性更新
+ */
+void WateringController::update() {
+    if (!initialized) {
+        return;
+    }
+
+    unsigned long currentTime = millis();
+
+    // 每日运行时长在本地零点清零，未同步网络时间时按24小时滚动清零
+    if (currentTime - dayStartTime >= DAY_MS) {
+        dayStartTime += DAY_MS;
+        pumpSecondsToday = 0;
+    }
+
+    switch (state) {
+        case WateringState::PUMPING:
+            // 脉冲时长到达或超过硬上限时停泵
+            if (currentTime - pumpStartTime >= pulseMs ||
+                currentTime - pumpStartTime >= WATERING_MAX_PULSE_MS) {
+                stopPump();
+                state = WateringState::SOAKING;
+                soakStartTime = millis();
+                soakCount = 0;
+            }
+            break;
+
+        case WateringState::SOAKING:
+            if (currentTime - soakStartTime >= WATERING_SOAK_MAX_MS) {
+                finishSoak();
+            }
+            break;
+
+        case WateringState::COOLDOWN:
+            if (currentTime - cooldownStartTime >= WATERING_MIN_INTERVAL) {
+                state = WateringState::IDLE;
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**
+ * 输入一次土壤湿度测量 (非有限值丢弃，避免污染入渗数据和学习的模型)
+ */
+void WateringController::onMoistureSample(float moisture) {
+    if (!isfinite(moisture)) {
+        return;
+    }
+    lastMoisture = moisture;
+    lastSampleTime = millis();
+
+    if (!initialized) {
+        return;
+    }
+
+    switch (state) {
+        case WateringState::IDLE:
+            if (enabled && moisture < triggerMoisture) {
+                startCycle(moisture);
+            }
+            break;
+
+        case WateringState::SOAKING:
+            if (soakCount < MAX_SOAK_SAMPLES) {
+                soakTimes[soakCount] = lastSampleTime - soakStartTime;
+                soakValues[soakCount] = moisture;
+                soakCount++;
+            }
+            if (isSoakSettled()) {
+                finishSoak();
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**
+ * 入渗期间是否需要新的湿度采样
+ */
+bool WateringController::wantsSample() const {
+    return state == WateringState::SOAKING &&
+           millis() - lastSampleTime >= WATERING_SAMPLE_INTERVAL;
+}
+
+/**
+ * 开始浇水周期
+ */
+void WateringController::startCycle(float moisture) {
+    if (pumpSecondsToday >= WATERING_DAILY_LIMIT_S) {
+        raiseFault(WateringFault::DAILY_LIMIT);
+        state = WateringState::COOLDOWN;
+        cooldownStartTime = millis();
+        return;
+    }
+
+    DEBUG_PRINTF("开始自动浇水: 当前 %.1f%%, 目标 %.1f%%\n", moisture, targetMoisture);
+    cycleStartMoisture = moisture;
+    cyclePumpSeconds = 0;
+    cyclePulses = 0;
+    dryRunCount = 0;
+    startPulse(moisture);
+}
+
+/**
+ * 按模型计算脉冲时长并开泵
+ * 模型未学习时先用短探测脉冲；学习后按缺口的一定比例给水，从下方逼近目标
+ */
+void WateringController::startPulse(float moisture) {
+    float gap = targetMoisture - moisture;
+    if (gap <= WATERING_TOLERANCE) {
+        finishCycle(moisture);
+        return;
+    }
+
+    float fraction = model.samples >= 3 ? 0.9f : 0.6f;
+    float seconds = fraction * gap / model.gainPerSecond;
+    if (model.samples == 0 && seconds * 1000 > WATERING_PROBE_PULSE_MS) {
+        seconds = WATERING_PROBE_PULSE_MS / 1000.0f;
+    }
+
+    unsigned long ms = (unsigned long)(seconds * 1000);
+    if (ms < WATERING_MIN_PULSE_MS) {
+        ms = WATERING_MIN_PULSE_MS;
+    } else if (ms > WATERING_MAX_PULSE_MS) {
+        ms = WATERING_MAX_PULSE_MS;
+    }
+
+    // 不超过每日剩余运行时长
+    float remainingMs = (WATERING_DAILY_LIMIT_S - pumpSecondsToday) * 1000;
+    if (remainingMs < ms) {
+        if (remainingMs < WATERING_MIN_PULSE_MS) {
+            raiseFault(WateringFault::DAILY_LIMIT);
+            finishCycle(moisture);
+            return;
+        }
+        ms = (unsigned long)remainingMs;
+    }
+
+    pulseMs = ms;
+    pulseBaseline = moisture;
+    expectedRise = model.gainPerSecond * ms / 1000.0f;
+    cyclePulses++;
+
+    DEBUG_PRINTF("浇水脉冲 #%u: %lums, 预计 +%.1f%%\n", cyclePulses, ms, expectedRise);
+
+    pumpStartTime = millis();
+    digitalWrite(PUMP_PIN, HIGH);
+    state = WateringState::PUMPING;
+    if (cutoffTimer != nullptr) {
+        esp_timer_start_once(cutoffTimer, (uint64_t)ms * 1000);
+    }
+}
+
+/**
+ * 停泵定时器回调 (esp_timer任务上下文)：只关断水泵输出，
+ * 运行时长统计和状态切换仍由主循环的 update 完成
+ */
+void WateringController::cutoffCallback(void*) {
+    digitalWrite(PUMP_PIN, LOW);
+}
+
+/**
+ * 停泵并记录实际运行时长
+ */
+void WateringController::stopPump() {
+    digitalWrite(PUMP_PIN, LOW);
+    if (cutoffTimer != nullptr) {
+        esp_timer_stop(cutoffTimer);
+    }
+
+    unsigned long runMs = millis() - pumpStartTime;
+    if (runMs > pulseMs) {
+        runMs = pulseMs;
+    }
+    pulseMs = runMs;
+    pumpSecondsToday += runMs / 1000.0f;
+    cyclePumpSeconds += runMs / 1000.0f;
+}
+
+/**
+ * 入渗是否稳定：至少等待学习到的入渗延迟，
+ * 且最近一个稳定窗口内的增量相对本次脉冲总增量足够小
+ */
+bool WateringController::isSoakSettled() const {
+    unsigned long elapsed = millis() - soakStartTime;
+    if (soakCount < 3 || elapsed < model.infiltrationMs) {
+        return false;
+    }
+
+    int last = soakCount - 1;
+    float rise = soakValues[last] - pulseBaseline;
+
+    // 几乎无响应：多等一个入渗延迟后交给空转判断
+    if (rise < expectedRise * WATERING_DRY_RUN_RATIO) {
+        return elapsed >= 2 * model.infiltrationMs;
+    }
+
+    int first = last;
+    while (first > 0 && soakTimes[last] - soakTimes[first - 1] <= WATERING_SETTLE_WINDOW_MS) {
+        first--;
+    }
+    if (soakTimes[last] - soakTimes[first] < WATERING_SETTLE_WINDOW_MS / 2) {
+        return false;
+    }
+
+    return soakValues[last] - soakValues[first] < rise * WATERING_SETTLE_RATIO;
+}
+
+/**
+ * 入渗结束：检测空转、学习响应并决定下一个脉冲
+ */
+void WateringController::finishSoak() {
+    // 取最近几次读数的平均值作为稳定湿度
+    float settled = lastMoisture;
+    if (soakCount > 0) {
+        int first = soakCount > 3 ? soakCount - 3 : 0;
+        float sum = 0;
+        for (int i = first; i < soakCount; i++) {
+            sum += soakValues[i];
+        }
+        settled = sum / (soakCount - first);
+    }
+
+    float rise = settled - pulseBaseline;
+    DEBUG_PRINTF("入渗完成: +%.1f%% (预计 +%.1f%%)\n", rise, expectedRise);
+
+    // 实际增量远低于预测视为空转，连续出现则锁定
+    if (rise < expectedRise * WATERING_DRY_RUN_RATIO && rise < WATERING_TOLERANCE) {
+        dryRunCount++;
+        if (dryRunCount >= WATERING_DRY_RUN_LIMIT) {
+            raiseFault(WateringFault::DRY_RUN);
+            return;
+        }
+    } else {
+        dryRunCount = 0;
+        learnFromPulse(rise);
+    }
+
+    if (settled >= targetMoisture - WATERING_TOLERANCE) {
+        finishCycle(settled);
+    } else if (cyclePulses >= WATERING_MAX_PULSES) {
+        raiseFault(WateringFault::MAX_PULSES);
+        finishCycle(settled);
+    } else {
+        startPulse(settled);
+    }
+}
+
+/**
+ * 从一个脉冲的响应更新模型
+ */
+void WateringController::learnFromPulse(float rise) {
+    if (pulseMs == 0 || !isfinite(rise)) {
+        return;
+    }
+
+    float observedGain = rise / (pulseMs / 1000.0f);
+    observedGain = constrain(observedGain, 0.05f, 20.0f);
+    model.gainPerSecond = model.samples == 0 ? observedGain :
+                          model.gainPerSecond * 0.7f + observedGain * 0.3f;
+
+    // 入渗延迟：响应首次达到最终增量90%的时间
+    for (int i = 0; i < soakCount; i++) {
+        if (soakValues[i] - pulseBaseline >= rise * 0.9f) {
+            model.infiltrationMs = model.samples == 0 ? soakTimes[i] :
+                                   (unsigned long)(model.infiltrationMs * 0.7f + soakTimes[i] * 0.3f);
+            break;
+        }
+    }
+
+    if (model.samples < 0xFFFF) {
+        model.samples++;
+    }
+    saveModel();
+}
+
+/**
+ * 结束浇水周期
+ */
+void WateringController::finishCycle(float moisture) {
+    if (cyclePulses > 0) {
+        WateringEvent event = {
+            .timestamp = millis(),
+            .moistureBefore = cycleStartMoisture,
+            .moistureAfter = moisture,
+            .pumpSeconds = cyclePumpSeconds,
+            .pulses = cyclePulses,
+            .automatic = true
+        };
+
+        DEBUG_PRINTF("自动浇水完成: %.1f%% -> %.1f%%, %u个脉冲, %.1fs\n",
+                     event.moistureBefore, event.moistureAfter, event.pulses, event.pumpSeconds);
+
+        recordEvent(event);
+        if (eventCallback) {
+            eventCallback(event);
+        }
+    }
+
+    state = WateringState::COOLDOWN;
+    cooldownStartTime = millis();
+}
+
+/**
+ * 报告故障，空转故障锁定水泵
+ */
+void WateringController::raiseFault(WateringFault fault) {
+    lastFault = fault;
+
+    if (fault == WateringFault::DRY_RUN) {
+        if (state == WateringState::PUMPING) {
+            stopPump();
+        }
+        digitalWrite(PUMP_PIN, LOW);
+        state = WateringState::LOCKED_OUT;
+        DEBUG_PRINTLN("✗ 水泵空转，自动浇水已锁定，请检查水箱");
+    } else {
+        DEBUG_PRINTF("浇水故障: %d\n", (int)fault);
+    }
+
+    if (faultCallback) {
+        faultCallback(fault);
+    }
+}
+
+/**
+ * 启用/禁用自动浇水
+ */
+void WateringController::setEnabled(bool enable) {
+    if (!enable) {
+        abort();
+    }
+    enabled = enable;
+}
+
+/**
+ * 设置触发阈值
+ */
+void WateringController::setThreshold(float threshold) {
+    triggerMoisture = constrain(threshold, 0.0f, 100.0f);
+    targetMoisture = constrain(threshold + WATERING_TARGET_RISE, 0.0f, 100.0f);
+}
+
+/**
+ * 中止当前浇水
+ */
+void WateringController::abort() {
+    if (state == WateringState::PUMPING) {
+        stopPump();
+    }
+    if (state == WateringState::PUMPING || state == WateringState::SOAKING) {
+        DEBUG_PRINTLN("自动浇水已中止");
+        state = WateringState::IDLE;
+    }
+}
+
+/**
+ * 解除故障锁定
+ */
+void WateringController::clearFault() {
+    if (state == WateringState::LOCKED_OUT) {
+        state = WateringState::IDLE;
+    }
+    lastFault = WateringFault::NONE;
+    dryRunCount = 0;
+}
+
+/**
+ * 清零当日水泵运行时长
+ */
+void WateringController::resetDailyCounters() {
+    DEBUG_PRINTF("浇水: 新的一天，昨日水泵运行 %.0fs\n", pumpSecondsToday);
+    pumpSecondsToday = 0;
+    dayStartTime = millis();
+}
+
+/**
+ * 记录一次浇水事件
+ */
+void WateringController::recordEvent(const WateringEvent& event) {
+    eventLog[logHead] = event;
+    logHead = (logHead + 1) % WATERING_LOG_SIZE;
+    if (logCount < WATERING_LOG_SIZE) {
+        logCount++;
+    }
+}
+
+/**
+ * 获取日志中的事件数
+ */
+uint8_t WateringController::getEventCount() const {
+    return logCount;
+}
+
+/**
+ * 获取日志中的事件
+ */
+WateringEvent WateringController::getEvent(uint8_t index) const {
+    if (index >= logCount) {
+        return WateringEvent{};
+    }
+    return eventLog[(logHead + WATERING_LOG_SIZE - 1 - index) % WATERING_LOG_SIZE];
+}
+
+/**
+ * 设置浇水事件回调
+ */
+void WateringController::setEventCallback(WateringEventCallback callback) {
+    eventCallback = callback;
+}
+
+/**
+ * 设置故障回调
+ */
+void WateringController::setFaultCallback(WateringFaultCallback callback) {
+    faultCallback = callback;
+}
+
+/**
+ * 获取当前状态
+ */
+WateringState WateringController::getState() const {
+    return state;
+}
+
+/**
+ * 是否正在浇水
+ */
+bool WateringController::isActive() const {
+    return state == WateringState::PUMPING || state == WateringState::SOAKING;
+}
+
+/**
+ * 获取土壤响应模型
+ */
+WateringModel WateringController::getModel() const {
+    return model;
+}
+
+/**
+ * 获取最近一次故障
+ */
+WateringFault WateringController::getLastFault() const {
+    return lastFault;
+}
+
+/**
+ * 加载土壤响应模型
+ */
+void WateringController::loadModel() {
+    preferences.begin(WATERING_NAMESPACE, true);
+    model.gainPerSecond = preferences.getFloat("gain", WATERING_DEFAULT_GAIN);
+    model.infiltrationMs = preferences.getULong("infiltMs", WATERING_DEFAULT_INFILTRATION_MS);
+    model.samples = preferences.getUShort("samples", 0);
+    preferences.end();
+
+    if (model.gainPerSecond <= 0) {
+        model.gainPerSecond = WATERING_DEFAULT_GAIN;
+    }
+}
+
+/**
+ * 保存土壤响应模型
+ */
+void WateringController::saveModel() {
+    preferences.begin(WATERING_NAMESPACE, false);
+    preferences.putFloat("gain", model.gainPerSecond);
+    preferences.putULong("infiltMs", model.infiltrationMs);
+    preferences.putUShort("samples", model.samples);
+    preferences.end();
+}
+
+/**
+ * 获取浇水信息
+ */
+String WateringController::getInfo() const {
+    DynamicJsonDocument doc(512);
+
+    doc["enabled"] = enabled;
+    doc["state"] = (int)state;
+    doc["fault"] = (int)lastFault;
+    doc["trigger"] = triggerMoisture;
+    doc["target"] = targetMoisture;
+    doc["gain_per_second"] = model.gainPerSecond;
+    doc["infiltration_ms"] = model.infiltrationMs;
+    doc["model_samples"] = model.samples;
+    doc["pump_seconds_today"] = pumpSecondsToday;
+    doc["events_logged"] = logCount;
+
+    if (logCount > 0) {
+        WateringEvent last = getEvent(0);
+        JsonObject lastEvent = doc.createNestedObject("last_event");
+        lastEvent["age_s"] = (millis() - last.timestamp) / 1000;
+        lastEvent["before"] = last.moistureBefore;
+        lastEvent["after"] = last.moistureAfter;
+        lastEvent["pump_seconds"] = last.pumpSeconds;
+        lastEvent["automatic"] = last.automatic;
+    }
+
+    String result;
+    serializeJson(doc, result);
+    return result;
+}
@@ -0,0 +1,244 @@
+/**
+ * AI智能植物养护机器人 - 自动浇水控制器
+ * 按学习到的土壤响应 (每泵秒湿度增量、入渗延迟) 分脉冲浇水：
+ * 每个脉冲后等待入渗稳定再测量，直到达到目标湿度，避免阈值开关式浇水的过冲
+ * 带单次运行时长、每日总量和空转检测等安全联锁
+ */
+
+#ifndef WATERING_CONTROLLER_H
+#define WATERING_CONTROLLER_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <esp_timer.h>
+#include "config.h"
+
+/**
+ * 浇水状态
+ */
+enum class WateringState {
+    IDLE,           // 空闲
+    PUMPING,        // 水泵运行中
+    SOAKING,        // 等待入渗
+    COOLDOWN,       // 浇水后冷却
+    LOCKED_OUT      // 故障锁定 (需人工解除)
+};
+
+/**
+ * 浇水故障
+ */
+enum class WateringFault {
+    NONE,
+    DRY_RUN,        // 水泵空转 (水箱无水或管路堵塞)
+    DAILY_LIMIT,    // 达到每日运行上限
+    MAX_PULSES      // 达到单次最大脉冲数仍未达标
+};
+
+/**
+ * 土壤响应模型
+ */
+struct WateringModel {
+    float gainPerSecond;            // 每泵秒湿度增量 (%/s)
+    unsigned long infiltrationMs;   // 入渗延迟 (停泵到响应达到90%的时间)
+    uint16_t samples;               // 已学习的脉冲数
+};
+
+/**
+ * 浇水事件 (供预测模型和日志使用)
+ */
+struct WateringEvent {
+    unsigned long timestamp;        // 结束时间 (ms)
+    float moistureBefore;           // 浇水前湿度 (%)
+    float moistureAfter;            // 浇水后湿度 (%)
+    float pumpSeconds;              // 水泵运行时长 (秒，用户浇水为0)
+    uint8_t pulses;                 // 脉冲数
+    bool automatic;                 // 是否自动浇水
+};
+
+/**
+ * 浇水事件回调函数类型
+ */
+typedef void (*WateringEventCallback)(const WateringEvent& event);
+
+/**
+ * 浇水故障回调函数类型
+ */
+typedef void (*WateringFaultCallback)(WateringFault fault);
+
+/**
+ * 自动浇水控制器类
+ */
+class WateringController {
+public:
+    static const int MAX_SOAK_SAMPLES = 64;     // 入渗期间保存的采样数
+
+private:
+    Preferences preferences;
+    WateringModel model;
+    WateringState state;
+    WateringFault lastFault;
+    bool enabled;
+    bool initialized;
+
+    // 目标
+    float triggerMoisture;
+    float targetMoisture;
+
+    // 最近一次测量
+    float lastMoisture;
+    unsigned long lastSampleTime;
+
+    // 当前浇水周期
+    float cycleStartMoisture;
+    float cyclePumpSeconds;
+    uint8_t cyclePulses;
+    uint8_t dryRunCount;
+
+    // 当前脉冲
+    esp_timer_handle_t cutoffTimer;     // 停泵定时器，主循环停滞时也能按时停泵
+    unsigned long pumpStartTime;
+    unsigned long pulseMs;
+    float pulseBaseline;
+    float expectedRise;
+    unsigned long soakStartTime;
+    unsigned long soakTimes[MAX_SOAK_SAMPLES];
+    float soakValues[MAX_SOAK_SAMPLES];
+    int soakCount;
+
+    // 安全计数
+    unsigned long cooldownStartTime;
+    unsigned long dayStartTime;
+    float pumpSecondsToday;
+
+    // 浇水事件环形日志 (自动与用户浇水)
+    WateringEvent eventLog[WATERING_LOG_SIZE];
+    uint8_t logHead;
+    uint8_t logCount;
+
+    // 回调
+    WateringEventCallback eventCallback;
+    WateringFaultCallback faultCallback;
+
+    void startCycle(float moisture);
+    void startPulse(float moisture);
+    void stopPump();
+    void finishSoak();
+    void finishCycle(float moisture);
+    void learnFromPulse(float rise);
+    void raiseFault(WateringFault fault);
+    bool isSoakSettled() const;
+    void loadModel();
+    void saveModel();
+    static void cutoffCallback(void* arg);
+
+public:
+    /**
+     * 构造函数
+     */
+    WateringController();
+
+    /**
+     * 初始化水泵输出并加载土壤响应模型
+     * @return 初始化是否成功
+     */
+    bool begin();
+
+    /**
+     * 周期性更新 (停泵计时、入渗超时、冷却)
+     * 应在主循环中调用
+     */
+    void update();
+
+    /**
+     * 输入一次土壤湿度测量
+     * @param moisture 土壤湿度 (%，NAN等非有限值被忽略)
+     */
+    void onMoistureSample(float moisture);
+
+    /**
+     * 入渗期间是否需要新的湿度采样
+     */
+    bool wantsSample() const;
+
+    /**
+     * 启用/禁用自动浇水 (禁用时立即停泵)
+     */
+    void setEnabled(bool enable);
+
+    /**
+     * 设置触发阈值，目标湿度为阈值加 WATERING_TARGET_RISE
+     * @param threshold 触发阈值 (%)
+     */
+    void setThreshold(float threshold);
+
+    /**
+     * 中止当前浇水
+     */
+    void abort();
+
+    /**
+     * 清零当日水泵运行时长 (由日程调度器在本地零点调用)
+     */
+    void resetDailyCounters();
+
+    /**
+     * 解除故障锁定 (补水后调用)
+     */
+    void clearFault();
+
+    /**
+     * 记录一次浇水事件 (自动浇水完成时内部调用，用户浇水由检测器上报)
+     * @param event 浇水事件
+     */
+    void recordEvent(const WateringEvent& event);
+
+    /**
+     * 获取日志中的事件数
+     */
+    uint8_t getEventCount() const;
+
+    /**
+     * 获取日志中的事件
+     * @param index 0为最近一次
+     * @return 浇水事件
+     */
+    WateringEvent getEvent(uint8_t index) const;
+
+    /**
+     * 设置浇水事件回调
+     */
+    void setEventCallback(WateringEventCallback callback);
+
+    /**
+     * 设置故障回调
+     */
+    void setFaultCallback(WateringFaultCallback callback);
+
+    /**
+     * 获取当前状态
+     */
+    WateringState getState() const;
+
+    /**
+     * 是否正在浇水 (运行或入渗中)
+     */
+    bool isActive() const;
+
+    /**
+     * 获取土壤响应模型
+     */
+    WateringModel getModel() const;
+
+    /**
+     * 获取最近一次故障
+     */
+    WateringFault getLastFault() const;
+
+    /**
+     * 获取浇水信息
+     * @return JSON格式的信息
+     */
+    String getInfo() const;
+};
+
+#endif // WATERING_CONTROLLER_H
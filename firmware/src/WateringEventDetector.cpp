@@ -0,0 +1,135 @@
+/**
+ * AI智能植物养护机器人 - 浇水事件检测器实现
+ */
+
+#include "WateringEventDetector.h"
+
+/**
+ * 构造函数
+ */
+WateringEventDetector::WateringEventDetector()
+    : armed(false),
+      baselineValid(false),
+      baseline(0),
+      cusum(0),
+      lastSampleTime(0),
+      holdoffStartTime(0),
+      inHoldoff(false),
+      detectionCount(0),
+      detectedCallback(nullptr) {
+}
+
+/**
+ * 开始检测
+ */
+void WateringEventDetector::arm() {
+    if (armed) {
+        return;
+    }
+
+    DEBUG_PRINTLN("浇水事件检测已启动");
+    armed = true;
+    baselineValid = false;
+    cusum = 0;
+    inHoldoff = false;
+}
+
+/**
+ * 停止检测
+ */
+void WateringEventDetector::disarm() {
+    if (armed) {
+        DEBUG_PRINTLN("浇水事件检测已停止");
+    }
+    armed = false;
+    baselineValid = false;
+    cusum = 0;
+    inHoldoff = false;
+}
+
+/**
+ * 是否正在检测
+ */
+bool WateringEventDetector::isArmed() const {
+    return armed;
+}
+
+/**
+ * 是否到了下一次快速采样时间
+ */
+bool WateringEventDetector::wantsSample() const {
+    return armed && millis() - lastSampleTime >= WATERING_DETECT_INTERVAL;
+}
+
+/**
+ * 输入一次土壤湿度测量
+ * 单侧CUSUM：S = max(0, S + (x - 基线 - 漂移))，S超过阈值且偏离基线足够大时判定为浇水
+ */
+void WateringEventDetector::onSample(float moisture) {
+    lastSampleTime = millis();
+
+    if (!armed) {
+        return;
+    }
+
+    if (!baselineValid) {
+        baseline = moisture;
+        baselineValid = true;
+        cusum = 0;
+        return;
+    }
+
+    // 检测后水仍在下渗，基线跟随读数上升，读数不再创新高一段时间后才恢复检测，
+    // 避免同一次浇水重复触发
+    if (inHoldoff) {
+        if (moisture > baseline) {
+            baseline = moisture;
+            holdoffStartTime = lastSampleTime;
+        } else if (lastSampleTime - holdoffStartTime >= WATERING_DETECT_HOLDOFF_MS) {
+            inHoldoff = false;
+            cusum = 0;
+        }
+        return;
+    }
+
+    float deviation = moisture - baseline;
+    cusum += deviation - WATERING_DETECT_DRIFT;
+    if (cusum < 0) {
+        cusum = 0;
+    }
+
+    if (cusum >= WATERING_DETECT_THRESHOLD && deviation >= WATERING_DETECT_MIN_STEP) {
+        float before = baseline;
+        detectionCount++;
+        DEBUG_PRINTF("检测到浇水: %.1f%% -> %.1f%%\n", before, moisture);
+
+        baseline = moisture;
+        cusum = 0;
+        inHoldoff = true;
+        holdoffStartTime = lastSampleTime;
+
+        if (detectedCallback) {
+            detectedCallback(before, moisture);
+        }
+        return;
+    }
+
+    // 无阶跃迹象时基线缓慢跟随 (蒸发、温漂)
+    if (cusum == 0) {
+        baseline += (moisture - baseline) * WATERING_DETECT_BASELINE_ALPHA;
+    }
+}
+
+/**
+ * 设置检测回调
+ */
+void WateringEventDetector::setCallback(WateringDetectedCallback callback) {
+    detectedCallback = callback;
+}
+
+/**
+ * 获取累计检测次数
+ */
+uint32_t WateringEventDetector::getDetectionCount() const {
+    return detectionCount;
+}
@@ -0,0 +1,78 @@
+/**
+ * AI智能植物养护机器人 - 浇水事件检测器
+ * 缺水提醒期间以高频率采样土壤湿度，用单侧CUSUM检测用户浇水造成的阶跃上升，
+ * 使状态评估和提醒解除不必等待下一次数据采集
+ */
+
+#ifndef WATERING_EVENT_DETECTOR_H
+#define WATERING_EVENT_DETECTOR_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/**
+ * 检测到浇水的回调函数类型
+ * @param moistureBefore 阶跃前基线湿度 (%)
+ * @param moistureAfter 检测时的湿度 (%)
+ */
+typedef void (*WateringDetectedCallback)(float moistureBefore, float moistureAfter);
+
+/**
+ * 浇水事件检测器类
+ */
+class WateringEventDetector {
+private:
+    bool armed;
+    bool baselineValid;
+    float baseline;
+    float cusum;
+    unsigned long lastSampleTime;
+    unsigned long holdoffStartTime;
+    bool inHoldoff;
+    uint32_t detectionCount;
+    WateringDetectedCallback detectedCallback;
+
+public:
+    /**
+     * 构造函数
+     */
+    WateringEventDetector();
+
+    /**
+     * 开始检测 (缺水提醒激活时调用，重复调用无副作用)
+     */
+    void arm();
+
+    /**
+     * 停止检测并清除基线
+     */
+    void disarm();
+
+    /**
+     * 是否正在检测
+     */
+    bool isArmed() const;
+
+    /**
+     * 是否到了下一次快速采样时间
+     */
+    bool wantsSample() const;
+
+    /**
+     * 输入一次土壤湿度测量
+     * @param moisture 土壤湿度 (%)
+     */
+    void onSample(float moisture);
+
+    /**
+     * 设置检测回调
+     */
+    void setCallback(WateringDetectedCallback callback);
+
+    /**
+     * 获取累计检测次数
+     */
+    uint32_t getDetectionCount() const;
+};
+
+#endif // WATERING_EVENT_DETECTOR_H
@@ -1,4 +1,5 @@
 #include "WiFiManager.h"
+#include "config.h"
 #include <Preferences.h>
 #include <esp_wifi.h>
 #include <esp_smartconfig.h>
@@ -21,6 +22,7 @@ WiFiManager::WiFiManager()
   , offlineModeStartTime(0)
   , lowPowerModeEnabled(false)
   , signalQualityIndex(0)
+  , lastSignalSample(0)
 {
   setDefaultConfig();
   
@@ -34,7 +36,9 @@ WiFiManager::WiFiManager()
     .currentSessionUptime = 0,
     .averageRSSI = 0.0f,
     .lastConnectionTime = 0,
-    .lastDisconnectionTime = 0
+    .lastDisconnectionTime = 0,
+    .txPowerDbm = WIFI_TX_POWER_MAX_DBM,
+    .txEnergyPerByte = 0.0f
   };
   
   // 初始化信号质量历史
@@ -188,6 +192,13 @@ void WiFiManager::handleConnectionSuccess() {
   Serial.print("RSSI: ");
   Serial.println(WiFi.RSSI());
   
+  // 从最大发射功率开始，按信号余量逐步降低
+  txPower.reset();
+  applyTxPower();
+  
+  // 同步网络时间 (后台进行)
+  configTzTime(TIME_ZONE, NTP_SERVER);
+  
   // 保存成功的凭据
   saveCredentials({WiFi.SSID(), WiFi.psk()});
   
@@ -221,6 +232,10 @@ void WiFiManager::handleDisconnection() {
     
     Serial.println("WiFi disconnected");
     
+    // 断线后以最大功率重连
+    txPower.reset();
+    stats.txPowerDbm = txPower.getPowerDbm();
+    
     if (connectionStatusCallback) {
       connectionStatusCallback(currentStatus);
     }
@@ -260,9 +275,12 @@ void WiFiManager::update() {
     stopSmartConfig();
   }
   
-  // 更新信号质量
+  // 更新信号质量并调整发射功率
   if (isConnected()) {
     updateSignalQuality();
+    if (txPower.update()) {
+      applyTxPower();
+    }
   }
 }
 
@@ -438,7 +456,9 @@ void WiFiManager::checkConnectionHealth() {
 }
 
 void WiFiManager::updateSignalQuality() {
-  if (isConnected()) {
+  // 按RSSI采样间隔记录，历史覆盖最近约10秒，供上行避开信号低谷
+  if (isConnected() && millis() - lastSignalSample >= WIFI_TX_RSSI_SAMPLE_INTERVAL) {
+    lastSignalSample = millis();
     float rssi = (float)WiFi.RSSI();
     signalQualityHistory[signalQualityIndex] = rssi;
     signalQualityIndex = (signalQualityIndex + 1) % 10;
@@ -449,6 +469,40 @@ void WiFiManager::updateSignalQuality() {
       sum += signalQualityHistory[i];
     }
     stats.averageRSSI = sum / 10.0f;
+    
+    txPower.onRssiSample((int)rssi);
+  }
+}
+
+void WiFiManager::recordTransmission(size_t bytes, bool delivered) {
+  txPower.recordTransmission(bytes, delivered);
+  stats.txEnergyPerByte = txPower.getEnergyPerByte();
+}
+
+float WiFiManager::getRssiBaseline() const {
+  // 只统计已采样的位置，刚连接时历史未填满
+  float sum = 0;
+  int count = 0;
+  for (int i = 0; i < 10; i++) {
+    if (signalQualityHistory[i] < 0) {
+      sum += signalQualityHistory[i];
+      count++;
+    }
+  }
+  return count > 0 ? sum / count : 0.0f;
+}
+
+float WiFiManager::getTxPowerDbm() const {
+  return txPower.getPowerDbm();
+}
+
+void WiFiManager::applyTxPower() {
+  // esp_wifi_set_max_tx_power 以0.25dBm为单位
+  int8_t quarterDbm = (int8_t)(txPower.getPowerDbm() * 4);
+  if (esp_wifi_set_max_tx_power(quarterDbm) == ESP_OK) {
+    stats.txPowerDbm = txPower.getPowerDbm();
+  } else {
+    Serial.println("Warning: Failed to set WiFi TX power");
   }
 }
 
@@ -513,6 +567,10 @@ void WiFiManager::printConnectionInfo() const {
   Serial.println(getRSSI());
   Serial.print("MAC: ");
   Serial.println(getMACAddress());
+  Serial.print("TX power (dBm): ");
+  Serial.println(stats.txPowerDbm);
+  Serial.print("TX energy per byte (uJ): ");
+  Serial.println(stats.txEnergyPerByte);
   Serial.println("============================");
 }
 
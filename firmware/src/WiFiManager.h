@@ -5,6 +5,7 @@
 #include <WiFi.h>
 #include <WiFiClientSecure.h>
 #include <ArduinoJson.h>
+#include "TxPowerController.h"
 
 /**
  * Wi-Fi连接管理器
@@ -29,6 +30,7 @@ enum class ConnectionMode {
 struct WiFiCredentials {
   String ssid;
   String password;
+  bool isSet;       // 配置管理器中是否已设置
   bool isValid() const {
     return ssid.length() > 0 && password.length() >= 8;
   }
@@ -63,6 +65,8 @@ struct WiFiConnectionStats {
   float averageRSSI;
   unsigned long lastConnectionTime;
   unsigned long lastDisconnectionTime;
+  float txPowerDbm;                // 当前发射功率 (dBm)
+  float txEnergyPerByte;           // 每送达字节的发射能耗估计 (µJ)
 };
 
 class WiFiManager {
@@ -155,7 +159,10 @@ public:
   
   // 网络质量检测
   bool performConnectivityTest();
+  void recordTransmission(size_t bytes, bool delivered);
+  float getTxPowerDbm() const;
   int measureSignalQuality() const;
+  float getRssiBaseline() const;
   unsigned long measureLatency(const String& host = "8.8.8.8") const;
   
   // 凭据管理
@@ -201,6 +208,11 @@ private:
   void updateSignalQuality();
   float signalQualityHistory[10];
   int signalQualityIndex;
+  unsigned long lastSignalSample;
+  
+  // 发射功率自适应
+  TxPowerController txPower;
+  void applyTxPower();
 };
 
 // WiFi事件处理器
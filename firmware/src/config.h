@@ -16,7 +16,10 @@
 
 // LED 控制引脚
 #define LED_DATA_PIN 5               // WS2812B LED 数据引脚
-#define LED_COUNT 12                 // LED 数量
+#define LED_COUNT 12                 // 默认 LED 数量 (可在设备配置中修改)
+#define LED_MAX_COUNT 300            // 支持的最大 LED 数量 (补光灯环)
+#define LED_MAX_SEGMENTS 4           // 最大分段数
+#define LED_ASYNC_OUTPUT 1           // 使用RMT异步双缓冲输出 (0 = FastLED同步输出)
 
 // 音频输出引脚
 #define SPEAKER_PIN 25               // PWM 扬声器引脚
@@ -28,6 +31,16 @@
 // 状态指示引脚
 #define STATUS_LED_PIN 2             // 内置状态 LED
 
+// 补光灯引脚
+#define GROW_LIGHT_PIN 14            // 补光灯 PWM 输出 (MOSFET 驱动)
+
+// 水泵引脚
+#define PUMP_PIN 13                  // 水泵 MOSFET 驱动 (高电平运行)
+
+// 按键引脚
+#define USER_BUTTON_PIN 0            // 用户按键 (BOOT键，低电平有效)
+#define BUTTON_DEBOUNCE_MS 30        // 按键防抖时间 (ms)
+
 // ============= 传感器配置 =============
 
 // DHT22 传感器类型
@@ -42,6 +55,33 @@
 #define LIGHT_THRESHOLD 500          // 光照强度阈值 (lux)
 #define BATTERY_LOW_THRESHOLD 20     // 低电量阈值 (%)
 
+// 过采样与数字滤波配置
+#define ADC_OVERSAMPLE_RATE_HZ 1000  // 过采样率 (Hz)
+#define ADC_OVERSAMPLE_COUNT 256     // 每次测量的过采样样本数
+#define DSP_DECIMATION_FACTOR 8      // 抽取因子
+#define DSP_FIR_TAPS 32              // 抗混叠FIR抽头数
+#define MAINS_FREQUENCY_HZ 50        // 工频 (Hz，60Hz地区改为60)
+#define DSP_NOTCH_HARMONICS 3        // 陷波的工频谐波数 (含灯具100/120Hz闪烁)
+#define DSP_NOTCH_Q 8.0              // 陷波器品质因数
+#define ADC_QUICK_SAMPLE_COUNT 16    // 快速读数的样本数 (均匀分布在一个工频周期内，不经滤波器)
+#define ADC_BURST_SAMPLE_COUNT 4     // 短读数的样本数 (连续采样，用于高频检测)
+
+// 土壤湿度温度补偿 (卡尔曼滤波同时估计真实湿度、变化速率和探头温度系数)
+#define SOIL_COMP_ENABLED 1                  // 是否启用
+#define SOIL_COMP_REFERENCE_TEMP 20.0        // 参考温度 (°C)，补偿后的湿度相当于该温度下的读数
+#define SOIL_COMP_TEMP_TAU_HOURS 2.0         // 土温滞后气温的时间常数 (h)
+#define SOIL_COMP_MEASUREMENT_VAR 1.0        // 读数噪声方差 (%²)
+#define SOIL_COMP_MOISTURE_VAR 0.02          // 湿度过程噪声 (%²/h)
+#define SOIL_COMP_RATE_VAR 0.002             // 变化速率过程噪声 ((%/h)²/h)
+#define SOIL_COMP_COEFF_VAR 0.000001         // 温度系数过程噪声 ((%/°C)²/h，探头老化)
+#define SOIL_COMP_INITIAL_COEFF_VAR 0.25     // 未学习时温度系数的方差 ((%/°C)²)
+#define SOIL_COMP_INITIAL_RATE_VAR 0.25      // 初始化/阶跃后变化速率的方差 ((%/h)²)
+#define SOIL_COMP_COEFF_LIMIT 2.0            // 温度系数上限 (%/°C)
+#define SOIL_COMP_GATE_SIGMA 4.0             // 新息超过该倍标准差视为阶跃 (浇水、换盆)
+#define SOIL_COMP_MAX_GAP_HOURS 6.0          // 采样间隔超过该值时重新初始化湿度 (h，保留温度系数)
+#define SOIL_COMP_SAVE_INTERVAL 21600000     // 温度系数保存间隔 (ms，6小时)
+#define SOIL_COMP_NAMESPACE "soilcomp"       // 温度系数保存的NVS命名空间
+
 // ============= 时间配置 =============
 
 #define DATA_COLLECTION_INTERVAL 300000    // 数据采集间隔 (5分钟)
@@ -49,6 +89,9 @@
 #define REPEAT_ALERT_INTERVAL 7200000      // 重复提醒间隔 (2小时)
 #define STARTUP_TIMEOUT 30000              // 启动超时 (30秒)
 #define WIFI_CONNECT_TIMEOUT 10000         // WiFi连接超时 (10秒)
+#define LIGHT_SLEEP_ENABLED 1              // 电池供电的低功耗模式下，空闲时进入浅睡眠 (按键唤醒)
+#define LIGHT_SLEEP_MIN_MS 200             // 距下一项工作不足该时长时不睡眠 (ms)
+#define LIGHT_SLEEP_MAX_MS 30000           // 单次浅睡眠上限 (ms)
 
 // ============= LED 配置 =============
 
@@ -63,6 +106,101 @@
 #define COLOR_ERROR 0xFF00FF         // 紫色 - 错误
 #define COLOR_OFF 0x000000           // 关闭
 
+// ============= 补光配置 =============
+
+#define GROW_LIGHT_PWM_CHANNEL 4         // LEDC 通道
+#define GROW_LIGHT_PWM_FREQ 20000        // PWM 频率 (Hz，高于可闻范围)
+#define GROW_LIGHT_PWM_RESOLUTION 10     // PWM 分辨率 (位)
+#define GROW_LIGHT_MAX_PPFD 120.0        // 满功率时冠层 PPFD (µmol/m²/s)
+#define GROW_LIGHT_MAX_WATTS 8.0         // 满功率电功率 (W)
+#define GROW_LIGHT_SENSOR_LUX 2000.0     // 满功率时光感读数增量 (lux，传感器照不到灯时设为0)
+#define GROW_LIGHT_SATURATION_PPFD 300.0 // 光饱和点 (µmol/m²/s)，超出部分不计划补光
+#define GROW_LIGHT_DEFAULT_DLI 12.0      // 默认每日光照积分目标 (mol/m²/day)
+#define GROW_LIGHT_PHOTOPERIOD_START 6   // 光周期开始 (时)
+#define GROW_LIGHT_PHOTOPERIOD_END 22    // 光周期结束 (时)
+#define GROW_LIGHT_OFFPEAK_START 22      // 谷电开始 (时)
+#define GROW_LIGHT_OFFPEAK_END 8         // 谷电结束 (时)
+#define GROW_LIGHT_UPDATE_INTERVAL 60000 // 补光决策周期 (1分钟)
+#define GROW_LIGHT_FORECAST_WEIGHT 0.5   // 预测自然光计入比例 (按历史日内分布，打折防阴天)
+#define LUX_TO_PPFD 0.0185               // 日光 lux 到 PPFD 的换算系数
+
+// ============= 自动浇水配置 =============
+
+#define WATERING_TARGET_RISE 20.0            // 目标湿度 = 触发阈值 + 该值 (%)
+#define WATERING_TOLERANCE 2.0               // 目标容差 (%)
+#define WATERING_MIN_PULSE_MS 500            // 最短脉冲 (ms)
+#define WATERING_MAX_PULSE_MS 8000           // 单次脉冲硬上限 (ms)
+#define WATERING_PROBE_PULSE_MS 2000         // 模型未学习时的探测脉冲 (ms)
+#define WATERING_MAX_PULSES 6                // 单次浇水最大脉冲数
+#define WATERING_DAILY_LIMIT_S 120           // 每日水泵累计运行上限 (秒)
+#define WATERING_SAMPLE_INTERVAL 5000        // 入渗期间采样间隔 (ms)
+#define WATERING_SOAK_MAX_MS 300000          // 入渗等待上限 (5分钟)
+#define WATERING_SETTLE_WINDOW_MS 30000      // 入渗稳定判定窗口 (ms)
+#define WATERING_SETTLE_RATIO 0.05           // 窗口内增量低于总增量的该比例视为稳定
+#define WATERING_MIN_INTERVAL 1800000        // 两次自动浇水最小间隔 (30分钟)
+#define WATERING_DEFAULT_GAIN 2.0            // 默认每泵秒湿度增量 (%/s)
+#define WATERING_DEFAULT_INFILTRATION_MS 60000 // 默认入渗延迟 (ms)
+#define WATERING_DRY_RUN_RATIO 0.15          // 实际增量低于预计的该比例视为空转
+#define WATERING_DRY_RUN_LIMIT 2             // 连续空转次数达到后锁定
+#define WATERING_LOG_SIZE 16                 // 内存中保留的浇水事件数
+
+// ============= 浇水事件检测配置 =============
+
+#define WATERING_DETECT_INTERVAL 500         // 缺水提醒期间土壤快速采样间隔 (ms)
+#define WATERING_DETECT_DRIFT 1.0            // CUSUM漂移量，低于此的逐次上升视为噪声 (%)
+#define WATERING_DETECT_THRESHOLD 12.0       // CUSUM累计阈值 (%)
+#define WATERING_DETECT_MIN_STEP 5.0         // 相对基线的最小阶跃 (%)
+#define WATERING_DETECT_BASELINE_ALPHA 0.05  // 无阶跃时基线跟随系数
+#define WATERING_DETECT_HOLDOFF_MS 30000     // 检测后读数停止上升多久才恢复检测 (ms)
+
+// ============= 夜间模式配置 =============
+
+#define NIGHT_ENTER_LUX 5.0                  // 低于此照度视为天黑 (lux)
+#define NIGHT_EXIT_LUX 20.0                  // 高于此照度视为天亮 (lux，与进入阈值构成滞回)
+#define NIGHT_ENTER_DELAY_MS 900000          // 持续黑暗多久进入夜间模式 (15分钟)
+#define NIGHT_EXIT_DELAY_MS 120000           // 持续明亮多久退出夜间模式 (2分钟)
+#define NIGHT_LIGHT_SAMPLE_INTERVAL 10000    // 白天光照检测间隔 (ms)
+#define NIGHT_LIGHT_SAMPLE_INTERVAL_NIGHT 60000 // 夜间光照检测间隔 (ms)
+#define NIGHT_SAMPLING_FACTOR 4              // 夜间数据采集间隔倍数
+#define LED_BLANKED_REFRESH_MS 1000          // 熄灭状态下灯带刷新间隔 (ms)
+
+// ============= 日程调度配置 =============
+
+#define SCHEDULER_MAX_JOBS 8                 // 定时任务数上限
+#define SCHEDULER_MAX_WINDOWS 4              // 时段规则数上限
+#define SCHEDULER_MAX_DAY_HOOKS 4            // 跨天回调数上限
+#define SCHEDULER_CHECK_INTERVAL 1000        // 检查间隔 (ms)
+#define SCHEDULER_CATCHUP_LIMIT_S 21600      // 错过的任务在该时长内补执行一次 (6小时)
+#define SCHEDULE_EVERY_DAY 0x7F              // 星期掩码：每天 (bit0 = 周日)
+#define SCHEDULE_WEEKDAYS 0x3E               // 星期掩码：周一至周五
+#define SCHEDULE_WEEKENDS 0x41               // 星期掩码：周六、周日
+#define QUIET_HOURS_START_HOUR 22            // 默认静音时段开始 (时)
+#define QUIET_HOURS_END_HOUR 7               // 默认静音时段结束 (时)
+#define UPLOAD_WINDOW_START_HOUR 0           // 数据上传时段开始 (时，开始等于结束表示全天)
+#define UPLOAD_WINDOW_END_HOUR 0             // 数据上传时段结束 (时)
+#define DAILY_REPORT_HOUR 20                 // 每日汇总时间 (时)
+
+// ============= 数据管道配置 =============
+
+#define PIPELINE_QUEUE_SIZE 8                // 每级输入队列容量上限
+#define PIPELINE_RETRY_DELAY 5000            // 阶段暂时无法处理时的重试间隔 (ms)
+#define PIPELINE_PERSIST_INTERVAL 600000     // 状态写入闪存的最小间隔 (10分钟，期间只保留最新一条)
+#define PIPELINE_PUBLISH_BATCH 4             // 攒够多少条后集中上传
+#define PIPELINE_PUBLISH_MAX_WAIT 1800000    // 最久攒多长时间 (30分钟)
+#define PIPELINE_LATENCY_ALPHA 0.1           // 阶段耗时平滑系数
+
+// ============= 分布统计配置 =============
+
+#define QUANTILE_SKETCH_K 32                 // 顶层压缩器容量，决定分位数精度 (K=32时比例误差约±5%)
+#define QUANTILE_SKETCH_MAX_LEVELS 12        // 最多层数 (每层权重翻倍，足够数万个样本)
+#define QUANTILE_SKETCH_CAPACITY 120         // 保留样本上限 (不小于各层容量之和)
+
+// ============= 历史归档配置 =============
+
+#define HISTORY_PARTITION_LABEL "history"    // 历史数据分区名 (见 partitions.csv)
+#define HISTORY_PARTITION_SUBTYPE 0x40       // 自定义数据分区子类型
+#define HISTORY_DEFAULT_BUCKET_S 3600        // 导出时默认的降采样时间桶 (秒，0表示逐条导出)
+
 // ============= 音频配置 =============
 
 #define SPEAKER_VOLUME 50            // 扬声器音量 (0-100)
@@ -76,6 +214,61 @@
 #define TONE_ERROR 200
 #define TONE_LOW_BATTERY 300
 
+// ============= 电源域配置 =============
+
+// 负载开关控制引脚 (-1 表示该外设常供电，不做门控)
+#define LED_POWER_PIN 10             // 灯带负载开关
+#define AUDIO_POWER_PIN 11           // 功放负载开关
+#define SENSOR_POWER_PIN 18          // 温湿度传感器 (DHT22) 电源
+#define SOIL_EXCITATION_PIN 12       // 土壤探头激励 (只在测量窗口内通电，避免电阻式探头电解腐蚀)
+#define POWER_SWITCH_ACTIVE_LEVEL HIGH // 负载开关使能电平
+
+#define LED_POWER_SETTLE_MS 2        // 灯带上电后可接收数据的等待时间 (ms)
+#define AUDIO_POWER_SETTLE_MS 20     // 功放上电软启动时间 (ms)
+#define SENSOR_POWER_SETTLE_MS 1200  // DHT22上电后首次读取前的等待时间 (ms)
+#define SOIL_EXCITATION_SETTLE_MS 100 // 土壤探头激励后读数稳定时间 (ms，电容式探头需较长)
+#define SENSOR_POWER_LEAD_MS 1500    // 采集前提前给传感器上电的时间 (ms，应大于稳定时间)
+
+#define LED_POWER_OFF_DELAY 2000     // 灯带无人使用后延迟断电 (ms，避免动画间隙反复开关)
+#define AUDIO_POWER_OFF_DELAY 500    // 功放无人使用后延迟断电 (ms)
+#define SENSOR_POWER_OFF_DELAY 0     // 传感器读取完立即断电
+#define SOIL_EXCITATION_OFF_DELAY 0  // 土壤探头采样完立即断开激励
+
+// ============= 协程配置 =============
+
+#define COROUTINE_MAX_TASKS 8        // 同时调度的协程数上限
+#define MAIN_LOOP_IDLE_MS 50         // 主循环空闲延时上限 (ms，有协程到期时缩短)
+
+// ============= 工厂测试配置 =============
+
+// 进入方式：上电后的等待窗口内夹具经USB串口发送命令行，或在窗口内按下并按住BOOT键
+#define FACTORY_TEST_COMMAND "FACTORY_TEST"   // 串口命令 (一行)
+#define FACTORY_TEST_ENTRY_WINDOW_MS 1000     // 上电后等待命令/按键的时间 (ms)
+#define FACTORY_TEST_HOLD_MS 500              // 按键须连续按住的时间 (ms，窗口内按下即可)
+#define FACTORY_TEST_TIMEOUT_MS 5000          // 整个测试的超时 (ms)，超时未完成的检测项判为失败
+
+// LED与光感：依次点亮 灭/红/绿/蓝/白，夹具遮光罩把灯光导向光感
+#define FACTORY_LED_PHASE_MS 120              // 每种颜色保持时间 (ms)，结束前采样光感
+#define FACTORY_LIGHT_CHANNEL_DELTA 40        // 单色相对熄灭时光感读数的最小增量 (ADC计数)
+#define FACTORY_LIGHT_WHITE_DELTA 200         // 白色相对熄灭时光感读数的最小增量 (ADC计数)
+
+// 音频：扫频播放，夹具麦克风/分压输出接到检测引脚，由ADC过零计数估计频率
+#define FACTORY_AUDIO_SENSE_PIN -1            // 夹具音频检测ADC引脚 (-1表示没有，跳过该项)
+#define FACTORY_TONE_MS 150                   // 每个测试音时长 (ms)
+#define FACTORY_TONE_SETTLE_MS 20             // 开始测量前等待扬声器起振 (ms)
+#define FACTORY_TONE_MEASURE_MS 60            // 测量窗口 (ms，期间阻塞采样)
+#define FACTORY_TONE_TOLERANCE 0.1            // 频率允许的相对误差
+#define FACTORY_AUDIO_MIN_P2P 100             // 最小峰峰值 (ADC计数)
+
+// 传感器与存储
+#define FACTORY_ADC_RAIL_MARGIN 16            // 读数离0或满量程小于该值视为开路/短路 (ADC计数)
+#define FACTORY_TEMP_MIN 0.0                  // 产线环境温度范围 (°C)
+#define FACTORY_TEMP_MAX 50.0
+#define FACTORY_HUMIDITY_MIN 5.0              // 产线环境湿度范围 (%)
+#define FACTORY_HUMIDITY_MAX 95.0
+#define FACTORY_FLASH_NAMESPACE "factory"     // Flash读写测试使用的NVS命名空间
+#define FACTORY_FLASH_TEST_BYTES 256          // Flash读写测试数据长度 (字节)
+
 // ============= WiFi 配置 =============
 
 // 默认 WiFi 配置 (可通过配置模式修改)
@@ -88,12 +281,51 @@
 #define AP_CHANNEL 1
 #define AP_MAX_CONNECTIONS 4
 
+// 发射功率自适应 (信号余量充足时降低发射功率，链路变差时提高)
+#define WIFI_TX_POWER_MAX_DBM 20.0           // 最大发射功率 (dBm)
+#define WIFI_TX_POWER_MIN_DBM 2.0            // 最小发射功率 (dBm)
+#define WIFI_TX_POWER_STEP_DOWN_DB 1.0       // 余量充足时每次降低 (dB)
+#define WIFI_TX_POWER_STEP_UP_DB 4.0         // 链路变差时每次提高 (dB)
+#define WIFI_TX_POWER_INTERVAL 10000         // 调整周期 (ms)
+#define WIFI_TX_AP_POWER_DBM 20.0            // 假定的路由器发射功率，用于由下行RSSI估计上行RSSI (dBm)
+#define WIFI_TX_TARGET_RSSI -70.0            // 路由器处的目标上行RSSI (dBm)
+#define WIFI_TX_HYSTERESIS_DB 6.0            // 目标上下的滞回带宽 (dB)
+#define WIFI_TX_RSSI_SAMPLE_INTERVAL 1000    // RSSI采样间隔 (ms)
+#define WIFI_TX_RSSI_ALPHA 0.1               // RSSI平滑系数 (每次采样)
+#define WIFI_TX_FAILURE_RATE_LIMIT 0.1       // 周期内传输失败率超过该值即提高功率
+#define WIFI_TX_STABLE_PERIODS 3             // 连续多少个无失败周期后才降低功率
+#define WIFI_TX_CURRENT_BASE_MA 100.0        // 发射电流模型：基础电流 (mA)
+#define WIFI_TX_CURRENT_PER_DBM_MA 10.0      // 发射电流模型：每dBm增加的电流 (mA)
+#define WIFI_TX_PHY_RATE_MBPS 11.0           // 估算空口时间使用的有效速率 (Mbps)
+
+// 上行自适应 (按送达情况AIMD调整每轮发送条数，非紧急数据避开信号低谷)
+#define UPLINK_BATCH_INITIAL 5               // 每轮初始发送条数
+#define UPLINK_BATCH_MIN 1                   // 每轮最少发送条数
+#define UPLINK_BATCH_MAX 20                  // 每轮最多发送条数
+#define UPLINK_BATCH_INCREASE 1.0            // 一轮全部送达且用满窗口后增加的条数
+#define UPLINK_BATCH_DECREASE 0.5            // 一轮出现失败后窗口乘以该系数
+#define UPLINK_RSSI_DIP_DB 4.0               // 当前RSSI低于近期平均多少dB视为信号低谷
+#define UPLINK_RSSI_GOOD_DBM -60             // 当前RSSI高于该值时不论近期平均都可以发送 (dBm)
+#define UPLINK_MAX_DEFER_MS 300000           // 非紧急数据因信号低谷最长推迟时间 (ms)
+#define UPLINK_FORCE_QUEUE_FILL 0.8          // 队列占用超过该比例时不再等待好信号
+#define UPLINK_STATS_ALPHA 0.2               // 吞吐量和错误率平滑系数 (每轮)
+
+// 网络时间 (补光时段、日程依赖本地时间)
+#define NTP_SERVER "pool.ntp.org"
+#define TIME_ZONE "CST-8"            // POSIX 时区字符串
+
 // ============= 调试配置 =============
 
 #define DEBUG_ENABLED 1              // 启用调试输出
 #define DEBUG_SENSORS 1              // 传感器调试
 #define DEBUG_WIFI 1                 // WiFi 调试
 #define DEBUG_LED 1                  // LED 调试
+#define TRACE_ENABLED 1              // 记录状态机转换等事件到跟踪缓冲区
+#define TRACE_BUFFER_SIZE 64         // 跟踪缓冲区记录数 (环形覆盖)
+#define TOUCH_LATENCY_TRACE_ENABLED 1 // 跟踪触摸到灯光的端到端延迟
+#define TOUCH_LATENCY_SLO_MS 100     // 触摸到灯光的目标延迟 (ms)
+#define TOUCH_LATENCY_SLO_TARGET 0.95 // 达到目标延迟的样本比例要求
+#define TOUCH_LATENCY_TIMEOUT_MS 1000 // 响应后超过该时间仍未出帧则放弃本次跟踪 (ms)
 
 // 调试宏
 #if DEBUG_ENABLED
@@ -118,5 +350,7 @@
 // 内存配置
 #define JSON_BUFFER_SIZE 1024        // JSON 缓冲区大小
 #define SENSOR_BUFFER_SIZE 100       // 传感器数据缓冲区大小
+#define SENSOR_HISTORY_PSRAM_SIZE 8640  // 有PSRAM时的历史缓冲区大小 (5分钟采集约30天)
+#define EEPROM_SIZE 1024             // EEPROM 模拟区大小 (字节，各模块共用)
 
 #endif // CONFIG_H
\ No newline at end of file
@@ -9,21 +9,86 @@
 #include "PlantCareRobot.h"
 #include "StartupManager.h"
 #include "ConfigurationManager.h"
+#include "WiFiManager.h"
+#include "CommunicationProtocol.h"
+#include "FactoryTest.h"
+#include "HistoryLog.h"
 #include "config.h"
 
 // 全局机器人实例
 PlantCareRobot robot;
 StartupManager startupManager;
 ConfigurationManager configManager;
+WiFiManager wifiManager;
+CommunicationProtocol communication(&wifiManager);
+
+/**
+ * 上传管道样本：交给通信协议发送，网络不可用或推迟上传时由其排队并在同步时补发
+ */
+static bool publishSample(const PipelineSample& sample) {
+    String payload = MessageBuilder::buildSensorDataMessage(communication.getConfig().deviceToken,
+                                                            sample.data.soilHumidity,
+                                                            sample.data.airHumidity,
+                                                            sample.data.temperature,
+                                                            sample.data.lightIntensity);
+    communication.sendSensorData(payload);
+    return true;
+}
+
+/**
+ * 上传每日分布报告 (作为传感器数据消息，同样由通信协议排队补发)
+ */
+static bool publishReport(const String& report) {
+    communication.sendSensorData(report);
+    return true;
+}
+
+/**
+ * 处理服务器下发的消息
+ * 历史同步请求 {"from":起始Unix时间,"to":截止Unix时间,"bucket":桶宽秒} (均可省略)
+ * 从闪存归档导出并分块上传，一次只进行一个批量传输
+ */
+static void onMessageReceived(const MessageHeader& header, const String& payload) {
+    if (header.type != MessageType::SYNC_REQUEST) {
+        return;
+    }
+    if (communication.isBulkTransferActive()) {
+        Serial.println("历史同步进行中，忽略新的同步请求");
+        return;
+    }
+
+    StaticJsonDocument<256> request;
+    deserializeJson(request, payload);   // 负载为空或无法解析时文档为空，使用默认范围
+    uint32_t from = request["from"] | 0UL;
+    uint32_t to = request["to"] | 0xFFFFFFFFUL;
+    uint32_t bucket = request["bucket"] | (uint32_t)HISTORY_DEFAULT_BUCKET_S;
+
+    uint32_t length = HistoryLog::beginExport(from, to, bucket);
+    if (length == 0) {
+        Serial.println("历史同步：没有符合范围的归档数据");
+        return;
+    }
+    communication.startBulkTransfer(MessageType::SYNC_RESPONSE, HistoryLog::readExport, length);
+}
 
 void setup() {
     Serial.begin(115200);
-    delay(1000);
+    
+    // 等待串口就绪的同时检测产线夹具的工厂测试命令 (或窗口内按住BOOT键)
+    bool factoryMode = FactoryTest::checkEntry(FACTORY_TEST_ENTRY_WINDOW_MS);
     
     Serial.println("=================================");
     Serial.println("AI智能植物养护机器人 v1.0 启动中...");
     Serial.println("=================================");
     
+    // 工厂测试模式：跳过启动流程的串行检查和WiFi，初始化后并行执行硬件检测
+    if (factoryMode) {
+        Serial.println("进入工厂测试模式");
+        robot.initialize();
+        robot.runFactoryTest();
+        return;
+    }
+    
     // 开始启动流程
     startupManager.begin();
     
@@ -44,6 +109,7 @@ void setup() {
     // 初始化机器人系统
     startupManager.setPhase(StartupPhase::SYSTEM_INIT);
     if (robot.initialize()) {
+        robot.applyDeviceConfiguration(configManager.getDeviceConfiguration());
         Serial.println("✓ 机器人系统初始化成功");
     } else {
         Serial.println("✗ 机器人系统初始化失败");
@@ -53,6 +119,7 @@ void setup() {
     
     // WiFi初始化阶段
     startupManager.setPhase(StartupPhase::WIFI_INIT);
+    wifiManager.initialize();
     if (!startupManager.performWiFiCheck()) {
         startupManager.setError(StartupError::WIFI_FAILURE);
         return;
@@ -68,10 +135,26 @@ void setup() {
     // 完成启动
     startupManager.completeStartup();
     
+    // 启动通信协议，机器人的样本经其上传，夜间推迟上传等状态随之同步
+    communication.initialize();
+    robot.attachCommunication(&communication);
+    robot.setDataPublisher(publishSample);
+    robot.setReportPublisher(publishReport);
+    communication.setMessageReceivedCallback(onMessageReceived);
+    
     Serial.println("系统启动完成，开始主循环...");
 }
 
 void loop() {
+    // 工厂测试模式下只等待夹具的重测命令
+    if (FactoryTest::isActive()) {
+        if (FactoryTest::pollCommand()) {
+            robot.runFactoryTest();
+        }
+        delay(10);
+        return;
+    }
+    
     // 更新启动管理器
     startupManager.update();
     
@@ -82,6 +165,10 @@ void loop() {
         return;
     }
     
+    // 维护WiFi连接 (断线重连) 和消息收发
+    wifiManager.update();
+    communication.update();
+    
     // 更新配置管理器
     configManager.update();
     
@@ -100,6 +187,7 @@ void loop() {
     // 正常运行模式 - 执行主循环
     robot.update();
     
-    // 短暂延时，让系统有时间处理其他任务
-    delay(50);
+    // 短暂延时，让系统有时间处理其他任务 (有协程即将到期时缩短，保证动画节拍)
+    unsigned long idle = CoScheduler::getTimeToNextWake();
+    delay(idle < MAIN_LOOP_IDLE_MS ? idle : MAIN_LOOP_IDLE_MS);
 }
\ No newline at end of file
@@ -924,4 +924,435 @@ describe('通信协议属性测试', () => {
       expect(stats.currentQueueSize).toBe(0);
     });
   });
-});
\ No newline at end of file
+});
+// ============= 自适应心跳 =============
+
+type HeartbeatPowerMode = 'NORMAL' | 'POWER_SAVE' | 'EMERGENCY';
+
+const HEARTBEAT_INTERVAL = 60000;
+const HEARTBEAT_MAX_INTERVAL = 1800000;
+const HEARTBEAT_MAX_BACKOFF_SHIFT = 5;
+const HEARTBEAT_MIN_INTERVAL = 10000;
+
+/**
+ * 心跳调度模型，与固件 CommunicationProtocol 的 getHeartbeatInterval / sendHeartbeat /
+ * recordDelivery / 存活周期解析一致 (发送总是成功)
+ */
+class HeartbeatModel {
+  private idleHeartbeats = 0;
+  private lastHeartbeat = 0;
+  private lastUplink = 0;
+  private serverLivenessLimit = 0;
+  powerMode: HeartbeatPowerMode = 'NORMAL';
+  uplinks: number[] = [];
+  heartbeatsSent = 0;
+
+  getHeartbeatInterval(): number {
+    let interval = Math.min(HEARTBEAT_INTERVAL * 2 ** this.idleHeartbeats, HEARTBEAT_MAX_INTERVAL);
+    if (this.powerMode === 'POWER_SAVE') {
+      interval *= 2;
+    } else if (this.powerMode === 'EMERGENCY') {
+      interval *= 4;
+    }
+    if (this.serverLivenessLimit > 0 && interval > this.serverLivenessLimit) {
+      interval = this.serverLivenessLimit;
+    }
+    return interval;
+  }
+
+  setLivenessTimeout(timeoutSeconds: number): void {
+    let limit = Math.floor(timeoutSeconds * 1000 / 2);
+    if (timeoutSeconds > 0 && limit < HEARTBEAT_MIN_INTERVAL) {
+      limit = HEARTBEAT_MIN_INTERVAL;
+    }
+    this.serverLivenessLimit = limit;
+  }
+
+  sendBusiness(now: number): void {
+    this.lastUplink = now;
+    this.uplinks.push(now);
+    this.idleHeartbeats = 0;
+  }
+
+  update(now: number): void {
+    const interval = this.getHeartbeatInterval();
+    if (now - this.lastHeartbeat < interval) {
+      return;
+    }
+    if (now - this.lastUplink >= interval) {
+      this.lastHeartbeat = now;
+      this.lastUplink = now;
+      this.uplinks.push(now);
+      this.heartbeatsSent++;
+      if (this.idleHeartbeats < HEARTBEAT_MAX_BACKOFF_SHIFT) {
+        this.idleHeartbeats++;
+      }
+    } else {
+      this.lastHeartbeat = this.lastUplink;
+    }
+  }
+}
+
+const POWER_MODES: HeartbeatPowerMode[] = ['NORMAL', 'POWER_SAVE', 'EMERGENCY'];
+const MODE_FACTOR: Record<HeartbeatPowerMode, number> = { NORMAL: 1, POWER_SAVE: 2, EMERGENCY: 4 };
+
+describe('自适应心跳属性测试', () => {
+  const TICK = 1000;
+
+  test('Property: 空闲时心跳间隔逐次翻倍，不超过上限乘以电源模式系数', () => {
+    fc.assert(
+      fc.property(fc.constantFrom(...POWER_MODES), fc.integer({ min: 1, max: 12 }), (mode, beats) => {
+        const model = new HeartbeatModel();
+        model.powerMode = mode;
+        let now = 0;
+        let previous = 0;
+        for (let i = 0; i < beats; i++) {
+          const interval = model.getHeartbeatInterval();
+          expect(interval).toBeGreaterThanOrEqual(previous);
+          expect(interval).toBeLessThanOrEqual(HEARTBEAT_MAX_INTERVAL * MODE_FACTOR[mode]);
+          expect(interval).toBe(
+            Math.min(HEARTBEAT_INTERVAL * 2 ** Math.min(i, HEARTBEAT_MAX_BACKOFF_SHIFT), HEARTBEAT_MAX_INTERVAL) *
+            MODE_FACTOR[mode]);
+          previous = interval;
+          now += interval;
+          model.update(now);
+        }
+        expect(model.heartbeatsSent).toBe(beats);
+      })
+    );
+  });
+
+  test('Property: 业务消息送达后心跳间隔恢复基础值', () => {
+    fc.assert(
+      fc.property(fc.constantFrom(...POWER_MODES), fc.integer({ min: 1, max: 8 }), (mode, beats) => {
+        const model = new HeartbeatModel();
+        model.powerMode = mode;
+        let now = 0;
+        for (let i = 0; i < beats; i++) {
+          now += model.getHeartbeatInterval();
+          model.update(now);
+        }
+        model.sendBusiness(now + 1);
+        expect(model.getHeartbeatInterval()).toBe(HEARTBEAT_INTERVAL * MODE_FACTOR[mode]);
+      })
+    );
+  });
+
+  test('Property: 省电模式的心跳间隔不短于正常模式', () => {
+    fc.assert(
+      fc.property(fc.integer({ min: 0, max: 10 }), fc.integer({ min: 0, max: 7200 }), (beats, timeout) => {
+        const intervals = POWER_MODES.map(mode => {
+          const model = new HeartbeatModel();
+          model.powerMode = mode;
+          model.setLivenessTimeout(timeout);
+          let now = 0;
+          for (let i = 0; i < beats; i++) {
+            now += model.getHeartbeatInterval();
+            model.update(now);
+          }
+          return model.getHeartbeatInterval();
+        });
+        expect(intervals[1]).toBeGreaterThanOrEqual(intervals[0]);
+        expect(intervals[2]).toBeGreaterThanOrEqual(intervals[1]);
+      })
+    );
+  });
+
+  test('Property: 服务器声明存活周期后，任意电源模式和业务流量下上行静默都不超过周期的一半', () => {
+    fc.assert(
+      fc.property(
+        fc.constantFrom(...POWER_MODES),
+        fc.integer({ min: 1, max: 7200 }),
+        fc.array(fc.integer({ min: 0, max: 4 * 3600 }), { maxLength: 20 }),
+        (mode, timeout, businessSeconds) => {
+          const model = new HeartbeatModel();
+          model.powerMode = mode;
+          model.setLivenessTimeout(timeout);
+          const limit = Math.max(timeout * 1000 / 2, HEARTBEAT_MIN_INTERVAL);
+          const business = new Set(businessSeconds.map(s => s * 1000));
+
+          const end = 4 * 3600 * 1000;
+          for (let now = TICK; now <= end; now += TICK) {
+            if (business.has(now)) {
+              model.sendBusiness(now);
+            }
+            model.update(now);
+          }
+
+          let previous = 0;
+          for (const t of model.uplinks) {
+            expect(t - previous).toBeLessThanOrEqual(limit + TICK);
+            previous = t;
+          }
+          expect(end - previous).toBeLessThanOrEqual(limit + TICK);
+        }
+      ),
+      { numRuns: 50 }
+    );
+  });
+
+  test('存活周期解析：过短时取下限，未声明时不限制', () => {
+    const model = new HeartbeatModel();
+    model.setLivenessTimeout(4);
+    expect(model.getHeartbeatInterval()).toBe(HEARTBEAT_MIN_INTERVAL);
+
+    model.setLivenessTimeout(90);
+    expect(model.getHeartbeatInterval()).toBe(45000);
+
+    model.setLivenessTimeout(0);
+    expect(model.getHeartbeatInterval()).toBe(HEARTBEAT_INTERVAL);
+  });
+});
+
+// ============= 优先消息插队 =============
+
+const MAX_RETRY_ATTEMPTS = 3;
+
+interface PriorityMessage {
+  id: number;
+  retryCount: number;
+}
+
+/**
+ * 优先队列处理模型，与固件 CommunicationProtocol::processMessageQueue / processPriorityQueue 一致：
+ * 更新开始时处理整个优先队列，之后每发一个数据块前只处理本次更新中新产生的优先消息
+ */
+class PriorityUplinkModel {
+  priorityQueue: PriorityMessage[] = [];
+  attempts: Map<number, number> = new Map();   // 本次更新中各消息的发送次数
+  delivered: number[] = [];
+  dropped: number[] = [];
+
+  constructor(private transmitOk: (id: number) => boolean) {}
+
+  enqueue(id: number): void {
+    this.priorityQueue.push({ id, retryCount: 0 });
+  }
+
+  private processPriorityQueue(attempted: { count: number }): void {
+    let index = Math.min(attempted.count, this.priorityQueue.length);
+    while (index < this.priorityQueue.length) {
+      const message = this.priorityQueue[index];
+      this.attempts.set(message.id, (this.attempts.get(message.id) ?? 0) + 1);
+      if (this.transmitOk(message.id)) {
+        this.delivered.push(message.id);
+        this.priorityQueue.splice(index, 1);
+      } else {
+        message.retryCount++;
+        if (message.retryCount >= MAX_RETRY_ATTEMPTS) {
+          this.dropped.push(message.id);
+          this.priorityQueue.splice(index, 1);
+        } else {
+          index++;
+        }
+      }
+    }
+    attempted.count = this.priorityQueue.length;
+  }
+
+  /**
+   * 一次更新：chunks 为本次发送的数据块数，arrivals[i] 为第i块发送期间新产生的优先消息
+   */
+  update(chunks: number, arrivals: number[][]): void {
+    this.attempts.clear();
+    const attempted = { count: 0 };
+    this.processPriorityQueue(attempted);
+    for (let chunk = 0; chunk < chunks; chunk++) {
+      if (this.priorityQueue.length > attempted.count) {
+        this.processPriorityQueue(attempted);
+      }
+      for (const id of arrivals[chunk] ?? []) {
+        this.enqueue(id);
+      }
+    }
+  }
+}
+
+describe('优先消息插队属性测试', () => {
+  test('Property: 发送持续失败时每条优先消息每次更新最多尝试一次，失败次数达上限后丢弃', () => {
+    fc.assert(
+      fc.property(
+        fc.integer({ min: 1, max: 8 }),
+        fc.integer({ min: 0, max: 6 }),
+        fc.array(fc.array(fc.integer({ min: 0, max: 2 }), { maxLength: 6 }), { minLength: 1, maxLength: 6 }),
+        (initial, chunks, arrivalCounts) => {
+          const model = new PriorityUplinkModel(() => false);
+          let nextId = 0;
+          for (let i = 0; i < initial; i++) {
+            model.enqueue(nextId++);
+          }
+
+          for (const counts of arrivalCounts) {
+            const arrivals = counts.slice(0, chunks).map(n => Array.from({ length: n }, () => nextId++));
+            model.update(chunks, arrivals);
+            for (const count of model.attempts.values()) {
+              expect(count).toBe(1);
+            }
+          }
+
+          // 继续更新直到队列清空：每条消息恰好在第 MAX_RETRY_ATTEMPTS 次失败后丢弃
+          for (let i = 0; i < MAX_RETRY_ATTEMPTS; i++) {
+            model.update(chunks, []);
+          }
+          expect(model.priorityQueue.length).toBe(0);
+          expect(model.dropped.length).toBe(nextId);
+          expect(model.delivered.length).toBe(0);
+        }
+      )
+    );
+  });
+
+  test('Property: 数据块发送期间产生的优先消息在同一次更新的下一块之前发送', () => {
+    fc.assert(
+      fc.property(
+        fc.integer({ min: 2, max: 8 }),
+        fc.array(fc.integer({ min: 0, max: 3 }), { minLength: 1, maxLength: 8 }),
+        fc.integer({ min: 0, max: 100 }),
+        (chunks, counts, failSeed) => {
+          // 部分消息发送失败，其余立即送达
+          const model = new PriorityUplinkModel(id => (id * 7 + failSeed) % 3 !== 0);
+          let nextId = 0;
+          const arrivals = counts.slice(0, chunks - 1).map(n => Array.from({ length: n }, () => nextId++));
+          model.update(chunks, arrivals);
+
+          for (let id = 0; id < nextId; id++) {
+            expect(model.attempts.get(id) ?? 0).toBe(1);
+            const failed = model.priorityQueue.some(m => m.id === id);
+            expect(failed).toBe((id * 7 + failSeed) % 3 === 0);
+          }
+        }
+      )
+    );
+  });
+
+  test('失败的优先消息不在同一次更新中重试，下次更新再试', () => {
+    let fail = true;
+    const model = new PriorityUplinkModel(() => !fail);
+    model.enqueue(1);
+    model.update(4, [[2], [], [3]]);
+    expect(model.attempts.get(1)).toBe(1);
+    expect(model.attempts.get(2)).toBe(1);
+    expect(model.attempts.get(3)).toBe(1);
+    expect(model.priorityQueue.length).toBe(3);
+
+    fail = false;
+    model.update(1, []);
+    expect(model.delivered).toEqual([1, 2, 3]);
+    expect(model.priorityQueue.length).toBe(0);
+  });
+});
+
+// ============= 批量数据块消息封装 =============
+
+const UPLINK_CHUNK_SIZE = 1024;
+const EXPORT_LINE_LENGTH = 59;
+const JSON_SLOT_SIZE = 16;           // ArduinoJson 6 在ESP32上每个成员/元素的槽位大小
+const LEGACY_PAYLOAD_CAPACITY = 1024;
+
+type JsonValue = null | boolean | number | string | JsonValue[] | { [key: string]: JsonValue };
+
+// 解析后文档占用的内存 (槽位 + 字符串副本)，对应 ArduinoJson 从 String 输入反序列化
+function jsonMemoryUsage(value: JsonValue): number {
+  if (typeof value === 'string') return Buffer.byteLength(value) + 1;
+  if (Array.isArray(value)) {
+    return value.reduce<number>((sum, item) => sum + JSON_SLOT_SIZE + jsonMemoryUsage(item), 0);
+  }
+  if (value !== null && typeof value === 'object') {
+    return Object.entries(value).reduce<number>(
+      (sum, [key, item]) => sum + JSON_SLOT_SIZE + Buffer.byteLength(key) + 1 + jsonMemoryUsage(item), 0);
+  }
+  return 0;
+}
+
+// 与固件 payloadCapacity 一致：按分隔符计数估计槽位，另加payload长度的字符串空间
+function payloadCapacity(payload: string): number {
+  let values = 1;
+  for (const c of payload) {
+    if (c === ',' || c === '[' || c === '{') values++;
+  }
+  return values * JSON_SLOT_SIZE + Buffer.byteLength(payload) + 1;
+}
+
+// 与固件 serializeMessage 一致：payload能解析进文档时作为JSON对象嵌入，否则作为字符串
+function envelopePayload(payload: string, capacity: number): JsonValue {
+  const parsed = JSON.parse(payload) as JsonValue;
+  return jsonMemoryUsage(parsed) <= capacity ? parsed : payload;
+}
+
+// 与固件 sendNextChunk 一致的块负载
+function buildChunks(text: string, streamId: number): string[] {
+  const chunks: string[] = [];
+  const total = Buffer.byteLength(text);
+  let offset = 0;
+  let index = 0;
+  do {
+    const data = text.slice(offset, offset + UPLINK_CHUNK_SIZE);
+    const final = offset + data.length >= total;
+    chunks.push(JSON.stringify({ stream: streamId, index, offset, total, final, data }));
+    offset += data.length;
+    index++;
+  } while (offset < total);
+  return chunks;
+}
+
+// 定宽CSV导出行 (与 HistoryLog::formatLine 的格式相同)
+const exportLineArb = fc.tuple(
+  fc.integer({ min: 1577836800, max: 2000000000 }),
+  fc.integer({ min: 1, max: 9999 }),
+  fc.array(fc.float({ min: 0, max: 100, noNaN: true }), { minLength: 5, maxLength: 5 }),
+  fc.float({ min: 0, max: 99999, noNaN: true })
+).map(([start, count, values, light]) => {
+  const fields = [String(start), String(count).padStart(4, ' '), ...values.map(v => v.toFixed(2).padStart(6, ' ')),
+                  light.toFixed(0).padStart(7, ' ')];
+  return fields.join(',').padEnd(EXPORT_LINE_LENGTH - 1, ' ') + '\n';
+});
+
+describe('批量数据块消息封装属性测试', () => {
+  test('Property: 任意长度的导出文本，每个数据块都作为JSON对象封装，拼接后与原文相同', () => {
+    fc.assert(
+      fc.property(
+        fc.array(exportLineArb, { minLength: 1, maxLength: 60 }),
+        fc.integer({ min: 1, max: 1000 }),
+        (lines, streamId) => {
+          const text = lines.join('');
+          const chunks = buildChunks(text, streamId);
+          let assembled = '';
+          for (const chunk of chunks) {
+            const payload = envelopePayload(chunk, payloadCapacity(chunk));
+            if (typeof payload !== 'object' || payload === null || Array.isArray(payload)) return false;
+            assembled += payload.data as string;
+          }
+          return assembled === text;
+        }
+      ),
+      { numRuns: 100 }
+    );
+  });
+
+  test('Property: 含转义字符的数据块所需内存不超过估计的容量', () => {
+    fc.assert(
+      fc.property(fc.string({ maxLength: UPLINK_CHUNK_SIZE }), fc.integer({ min: 0, max: 100000 }), (data, offset) => {
+        const payload = JSON.stringify({ stream: 1, index: 3, offset, total: offset + data.length, final: true, data });
+        return jsonMemoryUsage(JSON.parse(payload)) <= payloadCapacity(payload);
+      }),
+      { numRuns: 200 }
+    );
+  });
+
+  test('满1024字节的数据块超出原固定容量，按长度估计容量后仍作为JSON对象发送', () => {
+    const line = '1700000000,  12, 41.20, 43.75, 46.10, 22.31, 55.02,  12034'.padEnd(EXPORT_LINE_LENGTH - 1, ' ') + '\n';
+    const text = line.repeat(40);
+    const chunks = buildChunks(text, 7);
+    const first = chunks[0];
+    const last = chunks[chunks.length - 1];
+    expect(JSON.parse(first).data.length).toBe(UPLINK_CHUNK_SIZE);
+    expect(first.length).toBeGreaterThan(UPLINK_CHUNK_SIZE);
+
+    // 原来的固定容量：满块退化为字符串，较短的最后一块仍是对象，同一个流混用两种格式
+    expect(typeof envelopePayload(first, LEGACY_PAYLOAD_CAPACITY)).toBe('string');
+    expect(typeof envelopePayload(last, LEGACY_PAYLOAD_CAPACITY)).toBe('object');
+
+    expect(typeof envelopePayload(first, payloadCapacity(first))).toBe('object');
+    expect(typeof envelopePayload(last, payloadCapacity(last))).toBe('object');
+  });
+});
@@ -0,0 +1,546 @@
+/**
+ * 无栈协程属性测试
+ * 验证switch续点的恢复位置、定时/条件等待和调度器的运行顺序
+ */
+
+import fc from 'fast-check';
+
+const MAX_TASKS = 8;
+const ULONG_MAX = 0xffffffff;
+
+type CoState = 'ready' | 'sleeping' | 'waiting' | 'done';
+
+/**
+ * 协程体中的一步：对应一个等待宏或一段普通代码
+ */
+type Op =
+  | { kind: 'action'; id: number }
+  | { kind: 'yield' }
+  | { kind: 'delay'; ms: number }
+  | { kind: 'await'; signal: number }
+  | { kind: 'awaitTimeout'; signal: number; ms: number };
+
+let now = 0;
+const millis = () => now;
+
+// 模拟信号（对应固件中的CoSignal）
+class MockSignal {
+  pending = 0;
+
+  notify(): void {
+    if (this.pending < 0xffff) this.pending++;
+  }
+
+  take(): boolean {
+    if (this.pending === 0) return false;
+    this.pending--;
+    return true;
+  }
+}
+
+/**
+ * 模拟协程（对应固件中的Coroutine与CO_*宏）
+ * coLine 保存续点：0表示从头开始，i+1 表示第i步的case标签
+ */
+class MockCoroutine {
+  coLine = 0;
+  coState: CoState = 'done';
+  coTimedOut = false;
+  coWakeAt = 0;
+  bodyCalls = 0;
+  log: { id: number; time: number; timedOut: boolean }[] = [];
+
+  constructor(public ops: Op[], public signals: MockSignal[] = []) {}
+
+  restart(): void {
+    this.coLine = 0;
+    this.coState = 'ready';
+    this.coTimedOut = false;
+  }
+
+  stop(): void {
+    this.coLine = 0;
+    this.coState = 'done';
+  }
+
+  resume(): boolean {
+    if (this.coState === 'done') return false;
+    if (this.coState === 'sleeping' && now - this.coWakeAt < 0) return true;
+    this.body();
+    return this.coState !== 'done';
+  }
+
+  isRunning(): boolean {
+    return this.coState !== 'done';
+  }
+
+  // CO_BEGIN: 跳到续点；等待宏在续点之前的部分只在首次到达时执行
+  private body(): void {
+    this.bodyCalls++;
+    let i = 0;
+    let atLabel = false;
+    if (this.coLine > 0) {
+      i = this.coLine - 1;
+      atLabel = true;
+    }
+
+    for (; i < this.ops.length; i++, atLabel = false) {
+      const op = this.ops[i];
+      switch (op.kind) {
+        case 'action':
+          this.log.push({ id: op.id, time: now, timedOut: this.coTimedOut });
+          break;
+        case 'yield':
+          if (!atLabel) {
+            this.coLine = i + 1;
+            this.coState = 'ready';
+            return;
+          }
+          break;
+        case 'delay':
+          if (!atLabel) {
+            this.coWakeAt = millis() + op.ms;
+            this.coLine = i + 1;
+            this.coState = 'sleeping';
+            return;
+          }
+          break;
+        case 'await':
+          this.coLine = i + 1;
+          if (!this.signals[op.signal].take()) {
+            this.coState = 'waiting';
+            return;
+          }
+          break;
+        case 'awaitTimeout':
+          if (!atLabel) {
+            this.coWakeAt = millis() + op.ms;
+            this.coTimedOut = false;
+            this.coLine = i + 1;
+          }
+          if (!this.signals[op.signal].take()) {
+            if (now - this.coWakeAt < 0) {
+              this.coState = 'waiting';
+              return;
+            }
+            this.coTimedOut = true;
+          }
+          break;
+      }
+    }
+
+    // CO_END
+    this.coLine = 0;
+    this.coState = 'done';
+  }
+}
+
+// 模拟环形队列（对应固件中的CoQueue）
+class MockQueue {
+  items: number[];
+  head = 0;
+  count = 0;
+
+  constructor(public capacity: number) {
+    this.items = new Array(capacity).fill(0);
+  }
+
+  push(item: number): boolean {
+    if (this.count >= this.capacity) return false;
+    this.items[(this.head + this.count) % this.capacity] = item;
+    this.count++;
+    return true;
+  }
+
+  pop(): number | null {
+    if (this.count === 0) return null;
+    const item = this.items[this.head];
+    this.head = (this.head + 1) % this.capacity;
+    this.count--;
+    return item;
+  }
+}
+
+// 模拟调度器（对应固件中的CoScheduler）
+class MockScheduler {
+  tasks: MockCoroutine[] = [];
+  resumeCount = 0;
+
+  spawn(task: MockCoroutine): boolean {
+    task.restart();
+    if (this.tasks.includes(task)) return true;
+    if (this.tasks.length >= MAX_TASKS) {
+      task.stop();
+      return false;
+    }
+    this.tasks.push(task);
+    return true;
+  }
+
+  cancel(task: MockCoroutine): void {
+    task.stop();
+    const index = this.tasks.indexOf(task);
+    if (index >= 0) {
+      this.tasks[index] = this.tasks[this.tasks.length - 1];
+      this.tasks.pop();
+    }
+  }
+
+  update(): void {
+    let i = 0;
+    while (i < this.tasks.length) {
+      const task = this.tasks[i];
+      if (task.coState !== 'sleeping' || now - task.coWakeAt >= 0) this.resumeCount++;
+      if (task.resume()) {
+        i++;
+      } else {
+        this.tasks[i] = this.tasks[this.tasks.length - 1];
+        this.tasks.pop();
+      }
+    }
+  }
+
+  getTimeToNextWake(): number {
+    let nearest = ULONG_MAX;
+    for (const task of this.tasks) {
+      if (task.coState === 'ready') return 0;
+      if (task.coState === 'sleeping') {
+        const remaining = task.coWakeAt - now;
+        if (remaining <= 0) return 0;
+        nearest = Math.min(nearest, remaining);
+      }
+    }
+    return nearest;
+  }
+}
+
+// 生成器：不含条件等待的协程体 (只靠时间推进就会结束)
+const timedOpArb: fc.Arbitrary<Op> = fc.oneof(
+  fc.integer({ min: 0, max: 999 }).map(id => ({ kind: 'action' as const, id })),
+  fc.constant({ kind: 'yield' as const }),
+  fc.integer({ min: 0, max: 500 }).map(ms => ({ kind: 'delay' as const, ms }))
+);
+
+function numberActions(ops: Op[]): Op[] {
+  let next = 0;
+  return ops.map(op => (op.kind === 'action' ? { kind: 'action' as const, id: next++ } : op));
+}
+
+function countActions(ops: Op[]): number {
+  return ops.filter(op => op.kind === 'action').length;
+}
+
+// 以随机步长推进时间并调度，直到全部协程结束
+function runUntilIdle(scheduler: MockScheduler, steps: number[], limit = 100000): number {
+  let updates = 0;
+  while (scheduler.tasks.length > 0 && updates < limit) {
+    scheduler.update();
+    now += steps[updates % steps.length];
+    updates++;
+  }
+  return updates;
+}
+
+describe('无栈协程属性测试', () => {
+  beforeEach(() => {
+    now = 0;
+  });
+
+  describe('属性: 续点恢复', () => {
+    test('Property: 任意调度节奏下协程体的每段代码按顺序恰好执行一次', () => {
+      fc.assert(
+        fc.property(
+          fc.array(timedOpArb, { maxLength: 20 }),
+          fc.array(fc.integer({ min: 0, max: 300 }), { minLength: 1, maxLength: 10 }),
+          (raw, steps) => {
+            now = 0;
+            const ops = numberActions(raw);
+            const task = new MockCoroutine(ops);
+            const scheduler = new MockScheduler();
+            scheduler.spawn(task);
+            runUntilIdle(scheduler, steps.map(s => s + 1));
+            const ids = task.log.map(entry => entry.id);
+            return !task.isRunning() &&
+                   JSON.stringify(ids) === JSON.stringify(Array.from({ length: countActions(ops) }, (_, i) => i));
+          }
+        ),
+        { numRuns: 200 }
+      );
+    });
+
+    test('Property: 每个让出点消耗一次恢复，协程体调用次数等于等待点数加一', () => {
+      fc.assert(
+        fc.property(fc.array(timedOpArb, { maxLength: 20 }), (ops) => {
+          now = 0;
+          const task = new MockCoroutine(ops);
+          task.restart();
+          // 每次恢复前时间足够推进，延时到期
+          while (task.isRunning()) {
+            task.resume();
+            now += 1000;
+          }
+          const waits = ops.filter(op => op.kind === 'yield' || op.kind === 'delay').length;
+          return task.bodyCalls === waits + 1;
+        }),
+        { numRuns: 200 }
+      );
+    });
+
+    test('Property: restart 放弃当前进度从头运行', () => {
+      fc.assert(
+        fc.property(fc.array(timedOpArb, { minLength: 1, maxLength: 20 }), fc.integer({ min: 0, max: 10 }), (raw, partial) => {
+          now = 0;
+          const ops = numberActions(raw);
+          const task = new MockCoroutine(ops);
+          task.restart();
+          for (let i = 0; i < partial && task.isRunning(); i++) {
+            task.resume();
+            now += 1000;
+          }
+          task.log = [];
+          task.restart();
+          while (task.isRunning()) {
+            task.resume();
+            now += 1000;
+          }
+          return task.log.map(entry => entry.id).join() ===
+                 Array.from({ length: countActions(ops) }, (_, i) => i).join();
+        }),
+        { numRuns: 200 }
+      );
+    });
+  });
+
+  describe('属性: 定时等待', () => {
+    test('Property: 延时之后的代码不早于到期时刻运行，并在到期后的第一次调度中运行', () => {
+      fc.assert(
+        fc.property(
+          fc.integer({ min: 0, max: 5000 }),
+          fc.array(fc.integer({ min: 1, max: 400 }), { minLength: 1, maxLength: 10 }),
+          (ms, steps) => {
+            now = 0;
+            const task = new MockCoroutine([{ kind: 'delay', ms }, { kind: 'action', id: 0 }]);
+            const scheduler = new MockScheduler();
+            scheduler.spawn(task);
+            const updateTimes: number[] = [];
+            let updates = 0;
+            while (scheduler.tasks.length > 0) {
+              updateTimes.push(now);
+              scheduler.update();
+              now += steps[updates++ % steps.length];
+            }
+            const ranAt = task.log[0].time;
+            const firstDue = updateTimes.find(t => t >= ms);
+            return ranAt >= ms && ranAt === firstDue;
+          }
+        ),
+        { numRuns: 200 }
+      );
+    });
+
+    test('Property: 距离下次唤醒的时间等于最早到期的睡眠协程剩余时间', () => {
+      fc.assert(
+        fc.property(
+          fc.array(fc.integer({ min: 1, max: 10000 }), { minLength: 1, maxLength: MAX_TASKS }),
+          fc.integer({ min: 0, max: 10000 }),
+          (delays, elapsed) => {
+            now = 0;
+            const scheduler = new MockScheduler();
+            delays.forEach(ms => scheduler.spawn(new MockCoroutine([{ kind: 'delay', ms }])));
+            scheduler.update();
+            now = elapsed;
+            const remaining = delays.map(ms => ms - elapsed);
+            const expected = remaining.some(r => r <= 0) ? 0 : Math.min(...remaining);
+            return scheduler.getTimeToNextWake() === expected;
+          }
+        ),
+        { numRuns: 200 }
+      );
+    });
+
+    test('只有条件等待的协程时不限定唤醒时间，有可运行协程时立即唤醒', () => {
+      const signal = new MockSignal();
+      const scheduler = new MockScheduler();
+      scheduler.spawn(new MockCoroutine([{ kind: 'await', signal: 0 }], [signal]));
+      scheduler.update();
+      expect(scheduler.getTimeToNextWake()).toBe(ULONG_MAX);
+
+      scheduler.spawn(new MockCoroutine([{ kind: 'yield' }]));
+      expect(scheduler.getTimeToNextWake()).toBe(0);
+    });
+  });
+
+  describe('属性: 条件等待', () => {
+    test('Property: 等待信号的代码在通知之前不运行，每次通知恰好放行一次等待', () => {
+      fc.assert(
+        fc.property(
+          fc.integer({ min: 1, max: 6 }),
+          fc.array(fc.boolean(), { minLength: 1, maxLength: 60 }),
+          (waits, notifyPattern) => {
+            now = 0;
+            const signal = new MockSignal();
+            const ops: Op[] = [];
+            for (let i = 0; i < waits; i++) {
+              ops.push({ kind: 'await', signal: 0 }, { kind: 'action', id: i });
+            }
+            const task = new MockCoroutine(ops, [signal]);
+            const scheduler = new MockScheduler();
+            scheduler.spawn(task);
+
+            let notified = 0;
+            for (const notify of notifyPattern) {
+              if (notify) {
+                signal.notify();
+                notified++;
+              }
+              scheduler.update();
+              now += 10;
+              if (task.log.length !== Math.min(notified, waits)) return false;
+            }
+            return task.isRunning() === (notified < waits);
+          }
+        ),
+        { numRuns: 200 }
+      );
+    });
+
+    test('Property: 带超时的等待在期限前收到通知时未超时，否则在期限后超时继续', () => {
+      fc.assert(
+        fc.property(
+          fc.integer({ min: 1, max: 2000 }),
+          fc.option(fc.integer({ min: 0, max: 4000 }), { nil: null }),
+          fc.integer({ min: 1, max: 100 }),
+          (timeout, notifyAt, step) => {
+            now = 0;
+            const signal = new MockSignal();
+            const task = new MockCoroutine(
+              [{ kind: 'awaitTimeout', signal: 0, ms: timeout }, { kind: 'action', id: 0 }], [signal]);
+            const scheduler = new MockScheduler();
+            scheduler.spawn(task);
+
+            let notified = false;
+            const checks: number[] = [];
+            while (scheduler.tasks.length > 0) {
+              if (notifyAt !== null && !notified && now >= notifyAt) {
+                signal.notify();
+                notified = true;
+              }
+              checks.push(now);
+              scheduler.update();
+              now += step;
+            }
+            // 在通知或期限中较早者之后的第一次检查时结束等待；
+            // 条件先于期限判断，检查时已收到通知就不算超时
+            const deadline = notifyAt === null ? timeout : Math.min(notifyAt, timeout);
+            const resolvedAt = checks.find(t => t >= deadline);
+            const entry = task.log[0];
+            return entry.time === resolvedAt &&
+                   entry.timedOut === !(notifyAt !== null && entry.time >= notifyAt);
+          }
+        ),
+        { numRuns: 300 }
+      );
+    });
+  });
+
+  describe('属性: 调度器', () => {
+    test('Property: 每次调度中每个到期协程恰好恢复一次，结束的协程被移出', () => {
+      fc.assert(
+        fc.property(
+          fc.array(fc.array(timedOpArb, { maxLength: 8 }), { minLength: 1, maxLength: 12 }),
+          fc.array(fc.integer({ min: 0, max: 300 }), { minLength: 1, maxLength: 6 }),
+          (bodies, steps) => {
+            now = 0;
+            const scheduler = new MockScheduler();
+            const tasks = bodies.map(ops => new MockCoroutine(ops));
+            const accepted = tasks.map(task => scheduler.spawn(task));
+
+            // 调度表满时拒绝，被拒绝的协程不运行
+            if (scheduler.tasks.length > MAX_TASKS) return false;
+            if (accepted.filter(ok => ok).length !== Math.min(tasks.length, MAX_TASKS)) return false;
+            if (tasks.some((task, i) => !accepted[i] && task.isRunning())) return false;
+
+            let updates = 0;
+            while (scheduler.tasks.length > 0 && updates < 10000) {
+              const before = tasks.map(task => task.bodyCalls);
+              const due = tasks.map(task => scheduler.tasks.includes(task) &&
+                                            (task.coState !== 'sleeping' || now >= task.coWakeAt));
+              const resumesBefore = scheduler.resumeCount;
+              scheduler.update();
+              // 到期的协程恰好恢复一次 (包括换到当前位置的末尾协程)，未到期的不运行
+              if (tasks.some((task, i) => task.bodyCalls - before[i] !== (due[i] ? 1 : 0))) return false;
+              if (scheduler.resumeCount - resumesBefore !== due.filter(d => d).length) return false;
+              if (scheduler.tasks.some(task => !task.isRunning())) return false;
+              now += steps[updates++ % steps.length] + 1;
+            }
+            return scheduler.tasks.length === 0 && tasks.every(task => !task.isRunning());
+          }
+        ),
+        { numRuns: 200 }
+      );
+    });
+
+    test('Property: 重复启动同一协程不占用新的位置并从头开始', () => {
+      fc.assert(
+        fc.property(fc.integer({ min: 1, max: 5 }), fc.array(timedOpArb, { minLength: 1, maxLength: 10 }), (times, ops) => {
+          now = 0;
+          const scheduler = new MockScheduler();
+          const task = new MockCoroutine([{ kind: 'yield' }, ...ops]);
+          for (let i = 0; i < times; i++) {
+            scheduler.spawn(task);
+            scheduler.update();
+          }
+          scheduler.spawn(task);
+          return scheduler.tasks.length === 1 && task.coLine === 0 && task.coState === 'ready';
+        }),
+        { numRuns: 100 }
+      );
+    });
+
+    test('取消的协程立即结束并移出调度', () => {
+      const scheduler = new MockScheduler();
+      const a = new MockCoroutine([{ kind: 'delay', ms: 100 }, { kind: 'action', id: 1 }]);
+      const b = new MockCoroutine([{ kind: 'delay', ms: 100 }, { kind: 'action', id: 2 }]);
+      scheduler.spawn(a);
+      scheduler.spawn(b);
+      scheduler.update();
+      scheduler.cancel(a);
+      expect(scheduler.tasks).toEqual([b]);
+      expect(a.isRunning()).toBe(false);
+
+      now = 100;
+      scheduler.update();
+      expect(a.log.length).toBe(0);
+      expect(b.log.map(entry => entry.id)).toEqual([2]);
+    });
+  });
+
+  describe('属性: 环形队列', () => {
+    test('Property: 队列按先进先出取出，满时拒绝写入且不覆盖旧数据', () => {
+      fc.assert(
+        fc.property(
+          fc.integer({ min: 1, max: 8 }),
+          fc.array(fc.option(fc.integer({ min: 0, max: 1000 }), { nil: null }), { maxLength: 100 }),
+          (capacity, actions) => {
+            const queue = new MockQueue(capacity);
+            const reference: number[] = [];
+            for (const action of actions) {
+              if (action === null) {
+                const item = queue.pop();
+                const expected = reference.length > 0 ? reference.shift() : null;
+                if (item !== expected) return false;
+              } else {
+                const accepted = queue.push(action);
+                if (accepted !== reference.length < capacity) return false;
+                if (accepted) reference.push(action);
+              }
+              if (queue.count !== reference.length) return false;
+            }
+            return true;
+          }
+        ),
+        { numRuns: 200 }
+      );
+    });
+  });
+});
@@ -0,0 +1,259 @@
+/**
+ * 数据管道属性测试
+ * 验证有界队列、慢阶段不阻塞采集、攒批处理以及样本守恒
+ */
+
+import fc from 'fast-check';
+
+const QUEUE_SIZE = 8;
+const RETRY_DELAY = 5000;
+
+const PASS = 0;
+const DROP = 1;
+const RETRY = 2;
+
+type Handler = (sequence: number, now: number) => number;
+type Predicate = (now: number) => boolean;
+
+class StageConfig {
+  constructor(
+    public handler: Handler | null,
+    public input: number,
+    public minInterval: number,
+    public queueCapacity: number,
+    public batchSize: number,
+    public maxBatchWait: number
+  ) {}
+}
+
+class Sample {
+  constructor(public sequence: number, public acquiredAt: number) {}
+}
+
+class StageStats {
+  processed = 0;
+  dropped = 0;
+  shed = 0;
+  retries = 0;
+  received = 0;
+  queueHighWater = 0;
+}
+
+// 模拟数据管道（对应固件中的DataPipeline逻辑）
+class MockDataPipeline {
+  queues: Sample[][] = [];
+  stats: StageStats[] = [];
+  private nextRun: number[] = [];
+  private flushRequested: boolean[] = [];
+  private sequence = 0;
+
+  constructor(public configs: StageConfig[]) {
+    for (let i = 0; i < configs.length; i++) {
+      this.queues.push([]);
+      this.stats.push(new StageStats());
+      this.nextRun.push(0);
+      this.flushRequested.push(false);
+    }
+  }
+
+  update(now: number): void {
+    this.runSource(now);
+    for (let i = 1; i < this.configs.length; i++) this.runStage(i, now);
+  }
+
+  flush(stage: number): void {
+    this.flushRequested[stage] = true;
+  }
+
+  private runSource(now: number): void {
+    if (now < this.nextRun[0] && !this.flushRequested[0]) return;
+    this.flushRequested[0] = false;
+    this.nextRun[0] = now + this.configs[0].minInterval;
+    const sample = new Sample(++this.sequence, now);
+    const result = this.invoke(0, sample, now);
+    if (result === PASS) this.forward(0, sample);
+  }
+
+  private runStage(stage: number, now: number): void {
+    const queue = this.queues[stage];
+    const config = this.configs[stage];
+    if (queue.length === 0) return;
+    if (now < this.nextRun[stage] && !this.flushRequested[stage]) return;
+    const ready = this.flushRequested[stage] || queue.length >= config.batchSize ||
+                  now - queue[0].acquiredAt >= config.maxBatchWait;
+    if (!ready) return;
+    this.flushRequested[stage] = false;
+    this.nextRun[stage] = now + config.minInterval;
+
+    let pending = queue.length;
+    while (pending-- > 0) {
+      const sample = queue[0];
+      const result = this.invoke(stage, sample, now);
+      if (result === RETRY) {
+        this.nextRun[stage] = now + RETRY_DELAY;
+        break;
+      }
+      queue.shift();
+      if (result === PASS) this.forward(stage, sample);
+    }
+  }
+
+  private invoke(stage: number, sample: Sample, now: number): number {
+    const handler = this.configs[stage].handler;
+    const result = handler ? handler(sample.sequence, now) : PASS;
+    const s = this.stats[stage];
+    if (result === PASS) s.processed++;
+    else if (result === DROP) { s.processed++; s.dropped++; }
+    else s.retries++;
+    return result;
+  }
+
+  private forward(stage: number, sample: Sample): void {
+    for (let i = stage + 1; i < this.configs.length; i++) {
+      if (this.configs[i].input === stage) this.push(i, sample);
+    }
+  }
+
+  private push(stage: number, sample: Sample): void {
+    const queue = this.queues[stage];
+    const s = this.stats[stage];
+    s.received++;
+    if (queue.length >= this.configs[stage].queueCapacity) {
+      queue.shift();
+      s.shed++;
+    }
+    queue.push(sample);
+    s.queueHighWater = Math.max(s.queueHighWater, queue.length);
+  }
+}
+
+// 与固件相同的拓扑：采集 → 过滤 → 派生 → 评估 → 提醒 → {持久化, 上传}
+function buildPipeline(acquireInterval: number, invalidEvery: number,
+                       persistInterval: number, publishBatch: number, publishMaxWait: number,
+                       uplinkUp: Predicate, acquired: number[]): MockDataPipeline {
+  return new MockDataPipeline([
+    new StageConfig((seq) => { acquired.push(seq); return PASS; }, 0, acquireInterval, 1, 1, 0),
+    new StageConfig((seq) => (invalidEvery > 0 && seq % invalidEvery === 0 ? DROP : PASS), 0, 0, QUEUE_SIZE, 1, 0),
+    new StageConfig(null, 1, 0, QUEUE_SIZE, 1, 0),
+    new StageConfig(null, 2, 0, QUEUE_SIZE, 1, 0),
+    new StageConfig(null, 3, 0, QUEUE_SIZE, 1, 0),
+    new StageConfig(null, 4, persistInterval, 1, 1, 0),
+    new StageConfig((seq, now) => (uplinkUp(now) ? PASS : RETRY), 4, 0, QUEUE_SIZE, publishBatch, publishMaxWait)
+  ]);
+}
+
+describe('数据管道属性测试', () => {
+  describe('属性: 背压', () => {
+    test('Property: 上传长时间不可用时采集照常进行，队列不超过容量', () => {
+      fc.assert(
+        fc.property(
+          fc.integer({ min: 1000, max: 60000 }),
+          fc.integer({ min: 0, max: 5 }),
+          fc.integer({ min: 60000, max: 3600000 }),
+          (acquireInterval, invalidEvery, outage) => {
+            const acquired: number[] = [];
+            const pipeline = buildPipeline(acquireInterval, invalidEvery, 600000, 4, 1800000,
+                                           (now) => now >= outage, acquired);
+            const duration = outage + 600000;
+            for (let t = 0; t < duration; t += 50) pipeline.update(t);
+
+            // 采集次数只取决于采集间隔
+            const expected = Math.ceil(duration / 50 / Math.ceil(acquireInterval / 50));
+            if (Math.abs(acquired.length - expected) > 1) return false;
+            return pipeline.stats.every((s, i) => s.queueHighWater <= pipeline.configs[i].queueCapacity);
+          }
+        ),
+        { numRuns: 50 }
+      );
+    });
+
+    test('Property: 每个阶段收到的样本 = 已处理 + 队列中 + 被丢弃', () => {
+      fc.assert(
+        fc.property(
+          fc.integer({ min: 1000, max: 30000 }),
+          fc.integer({ min: 0, max: 5 }),
+          fc.integer({ min: 1, max: 8 }),
+          fc.array(fc.tuple(fc.integer({ min: 0, max: 7200000 }), fc.integer({ min: 0, max: 1800000 })),
+                   { minLength: 0, maxLength: 5 }),
+          (acquireInterval, invalidEvery, batch, outages) => {
+            const acquired: number[] = [];
+            const up = (now: number) => outages.every(o => now < o[0] || now >= o[0] + o[1]);
+            const pipeline = buildPipeline(acquireInterval, invalidEvery, 600000, batch, 1800000, up, acquired);
+            for (let t = 0; t < 7200000; t += 250) pipeline.update(t);
+
+            for (let i = 1; i < pipeline.configs.length; i++) {
+              const s = pipeline.stats[i];
+              if (s.received !== s.processed + pipeline.queues[i].length + s.shed) return false;
+            }
+            return true;
+          }
+        ),
+        { numRuns: 50 }
+      );
+    });
+  });
+
+  describe('属性: 限速与攒批', () => {
+    test('Property: 持久化阶段按声明速率运行，期间只保留一条待写样本', () => {
+      fc.assert(
+        fc.property(
+          fc.integer({ min: 1000, max: 60000 }),
+          fc.integer({ min: 60000, max: 900000 }),
+          (acquireInterval, persistInterval) => {
+            const acquired: number[] = [];
+            const persisted: number[] = [];
+            const pipeline = buildPipeline(acquireInterval, 0, persistInterval, 4, 1800000, () => true, acquired);
+            pipeline.configs[5].handler = (seq, now) => { persisted.push(now); return PASS; };
+            const duration = 7200000;
+            for (let t = 0; t < duration; t += 50) pipeline.update(t);
+
+            for (let i = 1; i < persisted.length; i++) {
+              if (persisted[i] - persisted[i - 1] < persistInterval) return false;
+            }
+            return persisted.length <= Math.ceil(duration / persistInterval) + 1 &&
+                   pipeline.queues[5].length <= 1;
+          }
+        ),
+        { numRuns: 50 }
+      );
+    });
+
+    test('Property: 上传阶段攒够一批或等待超时才运行，上传时段开始可立即清空', () => {
+      fc.assert(
+        fc.property(
+          fc.integer({ min: 2, max: 8 }),
+          fc.integer({ min: 10000, max: 120000 }),
+          (batch, acquireInterval) => {
+            const acquired: number[] = [];
+            const sizes: number[] = [];
+            let current = 0;
+            let lastCall = -1;
+            const maxWait = acquireInterval * (batch + 2);
+            const pipeline = buildPipeline(acquireInterval, 0, 600000, batch, maxWait, () => true, acquired);
+            pipeline.configs[6].handler = (seq, now) => {
+              if (now !== lastCall) {
+                if (current > 0) sizes.push(current);
+                current = 0;
+                lastCall = now;
+              }
+              current++;
+              return PASS;
+            };
+            for (let t = 0; t < acquireInterval * batch * 10; t += 50) pipeline.update(t);
+            if (current > 0) sizes.push(current);
+            if (!sizes.every(n => n === batch)) return false;
+
+            // 未满一批时强制清空
+            const t0 = acquireInterval * batch * 10;
+            pipeline.update(t0);
+            const queued = pipeline.queues[6].length;
+            pipeline.flush(6);
+            pipeline.update(t0 + 50);
+            return queued === 0 || pipeline.queues[6].length === 0;
+          }
+        ),
+        { numRuns: 50 }
+      );
+    });
+  });
+});
@@ -0,0 +1,407 @@
+/**
+ * 产线工厂测试属性测试
+ * 验证进入判定 (串口命令/BOOT键)、检测项判定、超时处理和单行JSON结果记录
+ */
+
+import fc from 'fast-check';
+
+const ENTRY_WINDOW_MS = 1000;
+const HOLD_MS = 500;
+const POLL_MS = 10;
+const TEST_TIMEOUT_MS = 5000;
+const ADC_RAIL_MARGIN = 16;
+const LIGHT_CHANNEL_DELTA = 40;
+const LIGHT_WHITE_DELTA = 200;
+const TONE_TOLERANCE = 0.1;
+const AUDIO_MIN_P2P = 100;
+const TEMP_MIN = 0;
+const TEMP_MAX = 50;
+const HUMIDITY_MIN = 5;
+const HUMIDITY_MAX = 95;
+
+const LIGHT_PHASE_NAMES = ['off', 'red', 'green', 'blue', 'white'];
+const SWEEP_FREQUENCIES = [500, 1000, 2000, 4000];
+const CHECK_NAMES = ['light', 'audio', 'dht', 'soil', 'flash', 'logic'] as const;
+
+type CheckName = typeof CHECK_NAMES[number];
+type Result = 'pending' | 'pass' | 'fail' | 'skip';
+
+/**
+ * 按键时间线：[按下时刻, 松开时刻) 区间 (相对上电等待开始, ms)
+ */
+type Press = { at: number; duration: number };
+
+// 模拟进入判定（对应固件中的FactoryTest::checkEntry）
+function checkEntry(presses: Press[], commandAt: number | null, windowMs = ENTRY_WINDOW_MS): boolean {
+  const buttonLow = (t: number) => presses.some(p => t >= p.at && t < p.at + p.duration);
+  let now = 0;
+  let pressed = false;
+  let pressStart = 0;
+
+  while (pressed || now < windowMs) {
+    if (commandAt !== null && now >= commandAt) {
+      return true;
+    }
+    if (buttonLow(now)) {
+      if (!pressed) {
+        pressed = true;
+        pressStart = now;
+      } else if (now - pressStart >= HOLD_MS) {
+        return true;
+      }
+    } else {
+      pressed = false;
+    }
+    now += POLL_MS;
+  }
+  return false;
+}
+
+function isAtRail(raw: number): boolean {
+  return raw < ADC_RAIL_MARGIN || raw > 4095 - ADC_RAIL_MARGIN;
+}
+
+/**
+ * 各检测协程的结束状态 (null表示协程仍在运行)
+ */
+interface TaskOutputs {
+  light: number[] | null;
+  audio: { hz: number[]; p2p: number[] } | null;
+  soilRaw: number;
+  dht: { valid: boolean; temp: number; hum: number } | null;
+}
+
+// 模拟工厂测试（对应固件中的FactoryTest::evaluate / update / printRecord）
+class MockFactoryTest {
+  results: Record<CheckName, Result> = {
+    light: 'pending', audio: 'pending', dht: 'pending',
+    soil: 'pending', flash: 'pending', logic: 'pending'
+  };
+  reasons: Partial<Record<CheckName, string>> = {};
+  running = true;
+  timedOut = false;
+  elapsed = 0;
+
+  constructor(private startTime = 0, audioSkipped = false) {
+    if (audioSkipped) {
+      this.results.audio = 'skip';
+      this.reasons.audio = 'no_sense_pin';
+    }
+  }
+
+  setResult(check: CheckName, pass: boolean, reason: string | null): void {
+    this.results[check] = pass ? 'pass' : 'fail';
+    if (pass || reason === null) {
+      delete this.reasons[check];
+    } else {
+      this.reasons[check] = reason;
+    }
+  }
+
+  evaluate(outputs: TaskOutputs): void {
+    if (this.results.light === 'pending' && outputs.light !== null) {
+      const readings = outputs.light;
+      const dark = readings[0];
+      let reason: string | null = null;
+      if (dark < 0 || isAtRail(dark)) {
+        reason = 'adc_rail';
+      } else if (readings[4] - dark < LIGHT_WHITE_DELTA) {
+        reason = 'white';
+      } else {
+        for (let i = 1; i < 4 && reason === null; i++) {
+          if (readings[i] - dark < LIGHT_CHANNEL_DELTA) {
+            reason = LIGHT_PHASE_NAMES[i];
+          }
+        }
+      }
+      this.setResult('light', reason === null, reason);
+    }
+
+    if (this.results.audio === 'pending' && outputs.audio !== null) {
+      let reason: string | null = null;
+      for (let i = 0; i < SWEEP_FREQUENCIES.length && reason === null; i++) {
+        const expected = SWEEP_FREQUENCIES[i];
+        if (outputs.audio.p2p[i] < AUDIO_MIN_P2P) {
+          reason = 'no_signal';
+        } else if (Math.abs(outputs.audio.hz[i] - expected) > expected * TONE_TOLERANCE) {
+          reason = 'frequency';
+        }
+      }
+      this.setResult('audio', reason === null, reason);
+    }
+
+    if (this.results.soil === 'pending' && outputs.soilRaw >= 0) {
+      this.setResult('soil', !isAtRail(outputs.soilRaw), 'adc_rail');
+    }
+
+    if (this.results.dht === 'pending' && outputs.dht !== null) {
+      const { valid, temp, hum } = outputs.dht;
+      if (!valid) {
+        this.setResult('dht', false, 'no_response');
+      } else {
+        const inRange = temp >= TEMP_MIN && temp <= TEMP_MAX && hum >= HUMIDITY_MIN && hum <= HUMIDITY_MAX;
+        this.setResult('dht', inRange, 'out_of_range');
+      }
+    }
+  }
+
+  update(now: number, outputs: TaskOutputs): boolean {
+    if (!this.running) {
+      return false;
+    }
+    this.evaluate(outputs);
+
+    let pending = CHECK_NAMES.some(c => this.results[c] === 'pending');
+    if (pending && now - this.startTime >= TEST_TIMEOUT_MS) {
+      this.timedOut = true;
+      for (const check of CHECK_NAMES) {
+        if (this.results[check] === 'pending') {
+          this.setResult(check, false, 'timeout');
+        }
+      }
+      pending = false;
+    }
+
+    if (!pending) {
+      this.running = false;
+      this.elapsed = now - this.startTime;
+    }
+    return this.running;
+  }
+
+  passed(): boolean {
+    return CHECK_NAMES.every(c => this.results[c] === 'pass' || this.results[c] === 'skip');
+  }
+
+  record(): string {
+    const checks: Record<string, { result: Result; reason?: string }> = {};
+    const failed: string[] = [];
+    for (const check of CHECK_NAMES) {
+      checks[check] = { result: this.results[check] };
+      if (this.reasons[check] !== undefined) {
+        checks[check].reason = this.reasons[check];
+      }
+      if (this.results[check] === 'fail' || this.results[check] === 'pending') {
+        failed.push(check);
+      }
+    }
+    const record: Record<string, unknown> = { device: 'PlantCareRobot', pass: this.passed(), ms: this.elapsed };
+    if (this.timedOut) {
+      record.timeout = true;
+    }
+    record.failed = failed;
+    record.checks = checks;
+    return JSON.stringify({ factory_test: record });
+  }
+}
+
+// 生成器
+const railSafeReading = fc.integer({ min: ADC_RAIL_MARGIN, max: 4095 - ADC_RAIL_MARGIN - 400 });
+const goodLight = railSafeReading.map(dark => [dark, dark + 100, dark + 100, dark + 100, dark + 400]);
+const goodAudio = fc.constant({ hz: SWEEP_FREQUENCIES.slice(), p2p: [500, 500, 500, 500] });
+const goodDht = fc.record({
+  valid: fc.constant(true),
+  temp: fc.double({ min: TEMP_MIN, max: TEMP_MAX, noNaN: true }),
+  hum: fc.double({ min: HUMIDITY_MIN, max: HUMIDITY_MAX, noNaN: true })
+});
+
+const anyOutputs: fc.Arbitrary<TaskOutputs> = fc.record({
+  light: fc.option(fc.array(fc.integer({ min: -1, max: 4095 }), { minLength: 5, maxLength: 5 }), { nil: null }),
+  audio: fc.option(fc.record({
+    hz: fc.array(fc.double({ min: 0, max: 5000, noNaN: true }), { minLength: 4, maxLength: 4 }),
+    p2p: fc.array(fc.integer({ min: 0, max: 4095 }), { minLength: 4, maxLength: 4 })
+  }), { nil: null }),
+  soilRaw: fc.integer({ min: -1, max: 4095 }),
+  dht: fc.option(fc.record({
+    valid: fc.boolean(),
+    temp: fc.double({ min: -40, max: 80, noNaN: true }),
+    hum: fc.double({ min: 0, max: 100, noNaN: true })
+  }), { nil: null })
+});
+
+describe('工厂测试属性测试', () => {
+  describe('属性: 进入判定', () => {
+    test('Property: 窗口内任意时刻按下并按住足够时间即进入', () => {
+      fc.assert(
+        fc.property(
+          fc.integer({ min: 0, max: ENTRY_WINDOW_MS / POLL_MS - 1 }),
+          fc.integer({ min: HOLD_MS + POLL_MS, max: 3000 }),
+          (slot, duration) => checkEntry([{ at: slot * POLL_MS, duration }], null)
+        ),
+        { numRuns: 200 }
+      );
+    });
+
+    test('Property: 短按 (含抖动) 不会进入', () => {
+      fc.assert(
+        fc.property(
+          fc.array(fc.record({
+            at: fc.integer({ min: 0, max: ENTRY_WINDOW_MS }),
+            duration: fc.integer({ min: 1, max: HOLD_MS - POLL_MS })
+          }), { maxLength: 5 }),
+          (presses) => {
+            // 相邻按下之间至少松开一次轮询周期
+            const separated: Press[] = [];
+            for (const press of presses.slice().sort((a, b) => a.at - b.at)) {
+              const last = separated[separated.length - 1];
+              if (last === undefined || press.at >= last.at + last.duration + POLL_MS) {
+                separated.push(press);
+              }
+            }
+            return !checkEntry(separated, null);
+          }
+        ),
+        { numRuns: 200 }
+      );
+    });
+
+    test('Property: 窗口结束后才按下不会进入', () => {
+      fc.assert(
+        fc.property(
+          fc.integer({ min: ENTRY_WINDOW_MS, max: 5000 }),
+          fc.integer({ min: HOLD_MS, max: 3000 }),
+          (at, duration) => !checkEntry([{ at, duration }], null)
+        ),
+        { numRuns: 100 }
+      );
+    });
+
+    test('Property: 窗口内收到串口命令即进入，窗口外不进入', () => {
+      fc.assert(
+        fc.property(fc.integer({ min: 0, max: 3000 }), (commandAt) =>
+          checkEntry([], commandAt) === (commandAt < ENTRY_WINDOW_MS)
+        ),
+        { numRuns: 100 }
+      );
+    });
+  });
+
+  describe('属性: 检测项判定', () => {
+    test('Property: 各项读数正常时全部通过', () => {
+      fc.assert(
+        fc.property(goodLight, goodAudio, railSafeReading, goodDht, (light, audio, soilRaw, dht) => {
+          const test = new MockFactoryTest();
+          test.setResult('flash', true, null);
+          test.setResult('logic', true, null);
+          test.update(100, { light, audio, soilRaw, dht });
+          return !test.running && test.passed() && !test.timedOut;
+        }),
+        { numRuns: 100 }
+      );
+    });
+
+    test('Property: 单个颜色通道无响应时以该颜色为失败原因', () => {
+      fc.assert(
+        fc.property(goodLight, fc.integer({ min: 1, max: 3 }), (light, channel) => {
+          const readings = light.slice();
+          readings[channel] = readings[0] + LIGHT_CHANNEL_DELTA - 1;
+          const test = new MockFactoryTest();
+          test.evaluate({ light: readings, audio: null, soilRaw: -1, dht: null });
+          return test.results.light === 'fail' && test.reasons.light === LIGHT_PHASE_NAMES[channel];
+        }),
+        { numRuns: 100 }
+      );
+    });
+
+    test('Property: 频率偏差超过容差判为失败', () => {
+      fc.assert(
+        fc.property(
+          fc.integer({ min: 0, max: 3 }),
+          fc.double({ min: TONE_TOLERANCE * 1.01, max: 0.9, noNaN: true }),
+          fc.boolean(),
+          (step, deviation, above) => {
+            const hz = SWEEP_FREQUENCIES.slice();
+            hz[step] *= above ? 1 + deviation : 1 - deviation;
+            const test = new MockFactoryTest();
+            test.evaluate({ light: null, audio: { hz, p2p: [500, 500, 500, 500] }, soilRaw: -1, dht: null });
+            return test.results.audio === 'fail' && test.reasons.audio === 'frequency';
+          }
+        ),
+        { numRuns: 100 }
+      );
+    });
+
+    test('Property: 仍在运行的协程对应的检测项保持pending', () => {
+      fc.assert(
+        fc.property(anyOutputs, (outputs) => {
+          const test = new MockFactoryTest();
+          test.evaluate(outputs);
+          return (outputs.light === null) === (test.results.light === 'pending') &&
+                 (outputs.audio === null) === (test.results.audio === 'pending') &&
+                 (outputs.dht === null) === (test.results.dht === 'pending') &&
+                 (outputs.soilRaw < 0) === (test.results.soil === 'pending');
+        }),
+        { numRuns: 200 }
+      );
+    });
+  });
+
+  describe('属性: 超时', () => {
+    test('Property: 超时前不结束，超时后未完成项判为timeout失败且已有结果不变', () => {
+      fc.assert(
+        fc.property(anyOutputs, fc.integer({ min: 0, max: TEST_TIMEOUT_MS - 1 }), (outputs, before) => {
+          const test = new MockFactoryTest();
+          test.evaluate(outputs);
+          const settled = { ...test.results };
+          const pendingBefore = CHECK_NAMES.filter(c => settled[c] === 'pending');
+
+          if (!test.update(before, outputs)) {
+            return false;
+          }
+          test.update(TEST_TIMEOUT_MS, outputs);
+          return !test.running && test.timedOut && !test.passed() &&
+                 test.elapsed === TEST_TIMEOUT_MS &&
+                 CHECK_NAMES.every(c => pendingBefore.includes(c)
+                   ? test.results[c] === 'fail' && test.reasons[c] === 'timeout'
+                   : test.results[c] === settled[c]);
+        }),
+        { numRuns: 200 }
+      );
+    });
+  });
+
+  describe('属性: 结果记录', () => {
+    test('Property: 单行JSON，failed恰为未通过项，pass与failed为空一致', () => {
+      fc.assert(
+        fc.property(anyOutputs, fc.boolean(), fc.boolean(), fc.integer({ min: 0, max: 2 * TEST_TIMEOUT_MS }),
+          (outputs, flashOk, audioSkipped, now) => {
+            const test = new MockFactoryTest(0, audioSkipped);
+            test.setResult('flash', flashOk, 'readback');
+            test.setResult('logic', true, 'config');
+            test.update(now, outputs);
+
+            const line = test.record();
+            if (line.includes('\n')) {
+              return false;
+            }
+            const record = JSON.parse(line).factory_test;
+            const expectedFailed = CHECK_NAMES.filter(c => test.results[c] === 'fail' || test.results[c] === 'pending');
+            return JSON.stringify(record.failed) === JSON.stringify(expectedFailed) &&
+                   record.pass === (expectedFailed.length === 0) &&
+                   (record.timeout === true) === test.timedOut &&
+                   CHECK_NAMES.every(c => record.checks[c].result === test.results[c] &&
+                     ('reason' in record.checks[c]) === (test.results[c] === 'fail' || test.results[c] === 'skip'));
+          }
+        ),
+        { numRuns: 200 }
+      );
+    });
+
+    test('跳过的音频检测不影响通过', () => {
+      const test = new MockFactoryTest(0, true);
+      test.setResult('flash', true, null);
+      test.setResult('logic', true, null);
+      test.update(1800, {
+        light: [100, 200, 200, 200, 600],
+        audio: null,
+        soilRaw: 2000,
+        dht: { valid: true, temp: 22, hum: 45 }
+      });
+      const record = JSON.parse(test.record()).factory_test;
+      expect(record.pass).toBe(true);
+      expect(record.failed).toEqual([]);
+      expect(record.checks.audio).toEqual({ result: 'skip', reason: 'no_sense_pin' });
+      expect(record.ms).toBe(1800);
+    });
+  });
+});
@@ -0,0 +1,279 @@
+/**
+ * 补光灯控制器属性测试
+ * 验证DLI缺口补光调度的正确性属性
+ */
+
+import fc from 'fast-check';
+
+const MAX_PPFD = 120;
+const SATURATION_PPFD = 300;
+const UPDATE_INTERVAL_S = 60;
+const FORECAST_WEIGHT = 0.5;
+const MINUTES_PER_DAY = 24 * 60;
+
+type Reason = 'idle' | 'target_met' | 'dark_period' | 'ambient_saturated' |
+  'deferred' | 'usb_power' | 'off_peak' | 'peak_deadline';
+
+// 模拟补光灯控制器（对应固件中的GrowLightController决策逻辑）
+class MockGrowLightController {
+  accumulatedMol = 0;
+  lampMol = 0;
+  peakLampSeconds = 0;
+  duty = 0;
+  reason: Reason = 'idle';
+  private ambientPpfd = 0;
+  private ambientProfile: number[] = new Array(24).fill(0);
+  private todayProfile: number[] = new Array(24).fill(0);
+  private profileValid = false;
+
+  constructor(
+    private dliTarget: number,
+    private photoperiod: [number, number] = [6 * 60, 22 * 60],
+    private offPeak: [number, number] = [22 * 60, 8 * 60]
+  ) {}
+
+  static inWindow(minute: number, start: number, end: number): boolean {
+    if (start === end) return true;
+    if (start < end) return minute >= start && minute < end;
+    return minute >= start || minute < end;
+  }
+
+  remainingSeconds(minute: number, offPeakOnly: boolean): number {
+    let minutes = 0;
+    for (let m = minute; m < MINUTES_PER_DAY; m++) {
+      if (MockGrowLightController.inWindow(m, this.photoperiod[0], this.photoperiod[1]) &&
+          (!offPeakOnly || MockGrowLightController.inWindow(m, this.offPeak[0], this.offPeak[1]))) {
+        minutes++;
+      }
+    }
+    return minutes * 60;
+  }
+
+  // 每分钟调用一次
+  update(minute: number, ambientPpfd: number, usbPowered: boolean): void {
+    const newAmbient = ambientPpfd;
+    const averageAmbient = (this.ambientPpfd + newAmbient) / 2;
+    const lampPpfd = this.duty * MAX_PPFD;
+    this.accumulatedMol += (averageAmbient + lampPpfd) * UPDATE_INTERVAL_S / 1e6;
+    this.todayProfile[Math.floor(minute / 60)] += averageAmbient * UPDATE_INTERVAL_S / 1e6;
+    this.lampMol += lampPpfd * UPDATE_INTERVAL_S / 1e6;
+    if (this.duty > 0 && this.reason === 'peak_deadline') {
+      this.peakLampSeconds += UPDATE_INTERVAL_S;
+    }
+    this.ambientPpfd = newAmbient;
+    this.decide(minute, usbPowered);
+  }
+
+  rollOverDay(): void {
+    for (let h = 0; h < 24; h++) {
+      this.ambientProfile[h] = this.profileValid
+        ? (this.ambientProfile[h] + this.todayProfile[h]) / 2
+        : this.todayProfile[h];
+      this.todayProfile[h] = 0;
+    }
+    this.profileValid = true;
+    this.accumulatedMol = 0;
+    this.lampMol = 0;
+    this.peakLampSeconds = 0;
+  }
+
+  forecastAmbientMol(minute: number): number {
+    if (!this.profileValid) return 0;
+    const hour = Math.floor(minute / 60);
+    let expectedSoFar = 0;
+    let actualSoFar = 0;
+    for (let h = 0; h < hour; h++) {
+      expectedSoFar += this.ambientProfile[h];
+      actualSoFar += this.todayProfile[h];
+    }
+    let forecast = this.ambientProfile[hour] * (60 - minute % 60) / 60;
+    for (let h = hour + 1; h < 24; h++) forecast += this.ambientProfile[h];
+    if (expectedSoFar > 0.05 && actualSoFar < expectedSoFar) {
+      forecast *= actualSoFar / expectedSoFar;
+    }
+    return forecast;
+  }
+
+  private decide(minute: number, usbPowered: boolean): void {
+    const deficit = this.dliTarget - this.accumulatedMol;
+    if (deficit <= 0) return this.set('target_met', 0);
+    if (!MockGrowLightController.inWindow(minute, this.photoperiod[0], this.photoperiod[1])) {
+      return this.set('dark_period', 0);
+    }
+
+    let headroom = (SATURATION_PPFD - this.ambientPpfd) / MAX_PPFD;
+    if (headroom <= 0) return this.set('ambient_saturated', 0);
+    headroom = Math.min(headroom, 1);
+
+    const plannedDeficit = deficit - this.forecastAmbientMol(minute) * FORECAST_WEIGHT;
+    const neededSeconds = plannedDeficit * 1e6 / Math.min(MAX_PPFD, SATURATION_PPFD);
+    const margin = 2 * UPDATE_INTERVAL_S;
+
+    let reason: Reason;
+    if (plannedDeficit <= 0) {
+      return this.set('deferred', 0);
+    } else if (usbPowered) {
+      reason = 'usb_power';
+    } else if (MockGrowLightController.inWindow(minute, this.offPeak[0], this.offPeak[1]) &&
+               neededSeconds + margin >= this.remainingSeconds(minute, true)) {
+      reason = 'off_peak';
+    } else if (neededSeconds + margin >= this.remainingSeconds(minute, false)) {
+      reason = 'peak_deadline';
+    } else {
+      return this.set('deferred', 0);
+    }
+
+    const exactDuty = deficit * 1e6 / (MAX_PPFD * UPDATE_INTERVAL_S);
+    this.set(reason, Math.min(exactDuty, headroom));
+  }
+
+  private set(reason: Reason, duty: number): void {
+    this.reason = reason;
+    this.duty = Math.max(0, Math.min(1, duty));
+  }
+}
+
+// 以正弦曲线模拟一天的自然光 (PPFD)
+function ambientAt(minute: number, peak: number, sunrise: number, sunset: number): number {
+  if (minute < sunrise || minute >= sunset) return 0;
+  return peak * Math.sin(Math.PI * (minute - sunrise) / (sunset - sunrise));
+}
+
+describe('补光灯控制器属性测试', () => {
+  describe('属性: 暗期与光饱和', () => {
+    test('Property: 光周期之外从不开灯', () => {
+      fc.assert(
+        fc.property(
+          fc.float({ min: 1, max: 30, noNaN: true }),
+          fc.float({ min: 0, max: 800, noNaN: true }),
+          fc.boolean(),
+          (target, peak, usb) => {
+            const controller = new MockGrowLightController(target);
+            for (let minute = 0; minute < MINUTES_PER_DAY; minute++) {
+              controller.update(minute, ambientAt(minute, peak, 7 * 60, 19 * 60), usb);
+              const inPhotoperiod = minute >= 6 * 60 && minute < 22 * 60;
+              if (!inPhotoperiod && controller.duty > 0) return false;
+            }
+            return true;
+          }
+        ),
+        { numRuns: 50 }
+      );
+    });
+
+    test('Property: 补光与环境光合计不超过光饱和点', () => {
+      fc.assert(
+        fc.property(
+          fc.float({ min: 1, max: 30, noNaN: true }),
+          fc.float({ min: 0, max: 800, noNaN: true }),
+          (target, peak) => {
+            const controller = new MockGrowLightController(target);
+            for (let minute = 0; minute < MINUTES_PER_DAY; minute++) {
+              const ambient = ambientAt(minute, peak, 7 * 60, 19 * 60);
+              controller.update(minute, ambient, true);
+              if (controller.duty > 0 && ambient + controller.duty * MAX_PPFD > SATURATION_PPFD + 1e-3) {
+                return false;
+              }
+            }
+            return true;
+          }
+        ),
+        { numRuns: 50 }
+      );
+    });
+  });
+
+  describe('属性: 达成目标', () => {
+    test('Property: 可达目标在光周期结束前完成且超调不超过一个周期', () => {
+      fc.assert(
+        fc.property(
+          fc.float({ min: Math.fround(0.5), max: 6, noNaN: true }),
+          fc.float({ min: 0, max: 200, noNaN: true }),
+          fc.boolean(),
+          (target, peak, usb) => {
+            const controller = new MockGrowLightController(target);
+            for (let minute = 0; minute < MINUTES_PER_DAY; minute++) {
+              controller.update(minute, ambientAt(minute, peak, 7 * 60, 19 * 60), usb);
+            }
+            const oneInterval = MAX_PPFD * UPDATE_INTERVAL_S / 1e6;
+            return controller.accumulatedMol >= target - 1e-6 &&
+                   controller.lampMol <= target + oneInterval;
+          }
+        ),
+        { numRuns: 50 }
+      );
+    });
+
+    test('Property: 已达标后不再开灯', () => {
+      fc.assert(
+        fc.property(
+          fc.float({ min: 1, max: 10, noNaN: true }),
+          (target) => {
+            const controller = new MockGrowLightController(target);
+            let metAt = -1;
+            for (let minute = 0; minute < MINUTES_PER_DAY; minute++) {
+              controller.update(minute, ambientAt(minute, 1200, 6 * 60, 20 * 60), false);
+              if (metAt < 0 && controller.accumulatedMol >= target) metAt = minute;
+              if (metAt >= 0 && controller.duty > 0) return false;
+            }
+            return true;
+          }
+        ),
+        { numRuns: 50 }
+      );
+    });
+  });
+
+  describe('属性: 低价时段优先', () => {
+    test('Property: 谷电时段足以补足缺口时不在峰电时段开灯', () => {
+      fc.assert(
+        fc.property(
+          // 谷电与光周期重叠 06:00-08:00，满功率最多补 0.864 mol
+          fc.float({ min: Math.fround(0.05), max: Math.fround(0.7), noNaN: true }),
+          (target) => {
+            const controller = new MockGrowLightController(target);
+            for (let minute = 0; minute < MINUTES_PER_DAY; minute++) {
+              controller.update(minute, 0, false);
+            }
+            return controller.peakLampSeconds === 0 && controller.accumulatedMol >= target - 1e-6;
+          }
+        ),
+        { numRuns: 50 }
+      );
+    });
+
+    test('Property: 预测自然光足够时不开灯', () => {
+      const controller = new MockGrowLightController(5);
+      // 第一天建立环境光分布，第二天同样晴朗
+      for (let day = 0; day < 2; day++) {
+        if (day > 0) controller.rollOverDay();
+        for (let minute = 0; minute < MINUTES_PER_DAY; minute++) {
+          controller.update(minute, ambientAt(minute, 600, 6 * 60, 20 * 60), false);
+        }
+      }
+      expect(controller.lampMol).toBe(0);
+      expect(controller.accumulatedMol).toBeGreaterThanOrEqual(5);
+    });
+
+    test('Property: 预测落空的阴天仍在光周期结束前达标', () => {
+      fc.assert(
+        fc.property(
+          fc.float({ min: 1, max: 6, noNaN: true }),
+          fc.float({ min: 0, max: Math.fround(0.3), noNaN: true }),
+          (target, cloudFactor) => {
+            const controller = new MockGrowLightController(target);
+            for (let minute = 0; minute < MINUTES_PER_DAY; minute++) {
+              controller.update(minute, ambientAt(minute, 200, 7 * 60, 19 * 60), false);
+            }
+            controller.rollOverDay();
+            for (let minute = 0; minute < MINUTES_PER_DAY; minute++) {
+              controller.update(minute, ambientAt(minute, 200 * cloudFactor, 7 * 60, 19 * 60), false);
+            }
+            return controller.accumulatedMol >= target - 1e-6;
+          }
+        ),
+        { numRuns: 30 }
+      );
+    });
+  });
+});
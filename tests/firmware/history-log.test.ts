@@ -0,0 +1,615 @@
+/**
+ * 历史数据闪存归档属性测试
+ * 用内存中的闪存镜像模拟映射后的history分区 (擦除置0xFF、写入只能把1变0)，
+ * 读取直接在镜像上用DataView访问，验证环形覆盖、上电恢复、按时间定位、降采样，
+ * 以及分块导出在任意块大小和重传下的一致性
+ */
+
+import fc from 'fast-check';
+
+const SECTOR_SIZE = 4096;
+const HEADER_SIZE = 16;
+const RECORD_SIZE = 16;
+const RECORDS_PER_SECTOR = (SECTOR_SIZE - HEADER_SIZE) / RECORD_SIZE;
+const SECTOR_MAGIC = 0x48495354;
+const ERASED = 0xffffffff;
+const LINE_LENGTH = 59;
+const START_TIME = 1700000000;
+
+type Random = () => number;
+
+function seededRandom(seed: number): Random {
+  let s = seed >>> 0;
+  return () => {
+    s = (s * 1664525 + 1013904223) >>> 0;
+    return s / 0x100000000;
+  };
+}
+
+interface Sample {
+  time: number;
+  soil: number;
+  air: number;
+  temperature: number;
+  light: number;
+}
+
+interface Cursor {
+  sequence: number;
+  slot: number;
+}
+
+interface Bucket {
+  start: number;
+  count: number;
+  soilMin: number;
+  soilMax: number;
+  soilMean: number;
+  temperatureMean: number;
+  airMean: number;
+  lightMean: number;
+}
+
+// 模拟NOR闪存分区：擦除置0xFF，编程只能把位从1变0
+class FlashImage {
+  bytes: Uint8Array;
+  view: DataView;
+
+  constructor(sectors: number) {
+    this.bytes = new Uint8Array(sectors * SECTOR_SIZE).fill(0xff);
+    this.view = new DataView(this.bytes.buffer);
+  }
+
+  erase(offset: number): void {
+    this.bytes.fill(0xff, offset, offset + SECTOR_SIZE);
+  }
+
+  write(offset: number, data: Uint8Array): void {
+    for (let i = 0; i < data.length; i++) this.bytes[offset + i] &= data[i];
+  }
+}
+
+function encodeRecord(sample: Sample): Uint8Array {
+  const bytes = new Uint8Array(RECORD_SIZE);
+  const view = new DataView(bytes.buffer);
+  const clamp = (v: number, lo: number, hi: number) => Math.min(hi, Math.max(lo, v));
+  view.setUint32(0, sample.time, true);
+  view.setFloat32(4, sample.light, true);
+  view.setInt16(8, Math.round(clamp(sample.soil, 0, 100) * 100), true);
+  view.setInt16(10, Math.round(clamp(sample.air, 0, 100) * 100), true);
+  view.setInt16(12, Math.round(clamp(sample.temperature, -40, 125) * 100), true);
+  const checksum = () => {
+    let check = 0xa5;
+    for (let i = 0; i < RECORD_SIZE - 1; i++) check ^= bytes[i];
+    return check;
+  };
+  bytes[14] = 0;
+  bytes[15] = checksum();
+  if (bytes[15] === 0xff) {
+    // 校验字节最后写入，断电时保持0xFF，有效记录不使用该值
+    bytes[14] = 1;
+    bytes[15] = checksum();
+  }
+  return bytes;
+}
+
+// 模拟历史归档（对应固件中的HistoryLog逻辑，记录视图直接读取闪存镜像）
+class MockHistoryLog {
+  sectorCount: number;
+  headSector = 0;
+  headSequence = 0;
+  oldestSequence = 0;
+  headSlot = 0;
+
+  exportFrom = 0;
+  exportTo = 0;
+  exportBucket = 0;
+  exportLines = 0;
+  exportLine = 0;
+  exportCursor: Cursor = { sequence: 0, slot: 0 };
+  chunkLine = 0;
+  chunkCursor: Cursor = { sequence: 0, slot: 0 };
+
+  constructor(private flash: FlashImage) {
+    this.sectorCount = flash.bytes.length / SECTOR_SIZE;
+    for (let sector = 0; sector < this.sectorCount; sector++) {
+      const magic = flash.view.getUint32(sector * SECTOR_SIZE, true);
+      const sequence = flash.view.getUint32(sector * SECTOR_SIZE + 4, true);
+      if (magic === SECTOR_MAGIC && sequence > this.headSequence) {
+        this.headSequence = sequence;
+        this.headSector = sector;
+      }
+    }
+    this.oldestSequence = this.headSequence;
+    if (this.headSequence === 0) return;
+    for (let k = 1; k < this.sectorCount; k++) {
+      const sector = (this.headSector + this.sectorCount - k) % this.sectorCount;
+      const magic = flash.view.getUint32(sector * SECTOR_SIZE, true);
+      const sequence = flash.view.getUint32(sector * SECTOR_SIZE + 4, true);
+      if (magic !== SECTOR_MAGIC || sequence !== this.headSequence - k) break;
+      this.oldestSequence = this.headSequence - k;
+    }
+    while (this.headSlot < RECORDS_PER_SECTOR) {
+      const offset = this.recordOffset(this.headSector, this.headSlot);
+      let erased = true;
+      for (let w = 0; w < 4; w++) if (flash.view.getUint32(offset + w * 4, true) !== ERASED) erased = false;
+      if (erased) break;
+      this.headSlot++;
+    }
+  }
+
+  private recordOffset(sector: number, slot: number): number {
+    return sector * SECTOR_SIZE + HEADER_SIZE + slot * RECORD_SIZE;
+  }
+
+  private sectorOf(sequence: number): number {
+    return (this.headSector + this.sectorCount - ((this.headSequence - sequence) % this.sectorCount)) % this.sectorCount;
+  }
+
+  private isValid(offset: number): boolean {
+    const bytes = this.flash.bytes;
+    if (this.flash.view.getUint32(offset, true) === ERASED || bytes[offset + RECORD_SIZE - 1] === 0xff) return false;
+    let check = 0xa5;
+    for (let i = 0; i < RECORD_SIZE - 1; i++) check ^= bytes[offset + i];
+    return check === bytes[offset + RECORD_SIZE - 1];
+  }
+
+  private startSector(): void {
+    const sector = this.headSequence === 0 ? 0 : (this.headSector + 1) % this.sectorCount;
+    const sequence = this.headSequence + 1;
+    if (this.headSequence === 0) this.oldestSequence = sequence;
+    else if (sequence - this.oldestSequence >= this.sectorCount) this.oldestSequence = sequence - this.sectorCount + 1;
+    this.flash.erase(sector * SECTOR_SIZE);
+    const header = new Uint8Array(HEADER_SIZE).fill(0xff);
+    const view = new DataView(header.buffer);
+    view.setUint32(0, SECTOR_MAGIC, true);
+    view.setUint32(4, sequence, true);
+    this.flash.write(sector * SECTOR_SIZE, header);
+    this.headSector = sector;
+    this.headSequence = sequence;
+    this.headSlot = 0;
+  }
+
+  append(sample: Sample, tornBytes = RECORD_SIZE): void {
+    if (this.headSequence === 0 || this.headSlot >= RECORDS_PER_SECTOR) this.startSector();
+    const offset = this.recordOffset(this.headSector, this.headSlot);
+    this.headSlot++;
+    this.flash.write(offset, encodeRecord(sample).subarray(0, tornBytes));
+  }
+
+  recordCount(): number {
+    return this.headSequence === 0 ? 0 : (this.headSequence - this.oldestSequence) * RECORDS_PER_SECTOR + this.headSlot;
+  }
+
+  // 返回记录在镜像中的偏移 (视图)，-1表示没有更多记录
+  next(cursor: Cursor): number {
+    if (this.headSequence === 0) return -1;
+    if (cursor.sequence < this.oldestSequence) {
+      cursor.sequence = this.oldestSequence;
+      cursor.slot = 0;
+    }
+    while (cursor.sequence <= this.headSequence) {
+      const limit = cursor.sequence === this.headSequence ? this.headSlot : RECORDS_PER_SECTOR;
+      if (cursor.slot >= limit) {
+        if (cursor.sequence === this.headSequence) return -1;
+        cursor.sequence++;
+        cursor.slot = 0;
+        continue;
+      }
+      const offset = this.recordOffset(this.sectorOf(cursor.sequence), cursor.slot);
+      cursor.slot++;
+      if (this.isValid(offset)) return offset;
+    }
+    return -1;
+  }
+
+  timeAt(offset: number): number {
+    return this.flash.view.getUint32(offset, true);
+  }
+
+  private firstTimeOf(sequence: number): number {
+    const sector = this.sectorOf(sequence);
+    const limit = sequence === this.headSequence ? this.headSlot : RECORDS_PER_SECTOR;
+    for (let slot = 0; slot < limit; slot++) {
+      const offset = this.recordOffset(sector, slot);
+      if (this.isValid(offset)) return this.timeAt(offset);
+    }
+    return ERASED;
+  }
+
+  seek(fromTime: number): Cursor {
+    const cursor = { sequence: this.oldestSequence, slot: 0 };
+    if (this.headSequence === 0) return cursor;
+    let low = this.oldestSequence;
+    let high = this.headSequence;
+    while (low < high) {
+      const mid = low + Math.floor((high - low + 1) / 2);
+      if (this.firstTimeOf(mid) <= fromTime) low = mid;
+      else high = mid - 1;
+    }
+    cursor.sequence = low;
+    const probe = { ...cursor };
+    let offset: number;
+    while ((offset = this.next(probe)) >= 0 && this.timeAt(offset) < fromTime) {
+      cursor.sequence = probe.sequence;
+      cursor.slot = probe.slot;
+    }
+    return cursor;
+  }
+
+  downsample(cursor: Cursor, toTime: number, bucketSeconds: number): Bucket | null {
+    const view = this.flash.view;
+    const probe = { ...cursor };
+    let offset = this.next(probe);
+    if (offset < 0 || this.timeAt(offset) > toTime) return null;
+    const first = this.timeAt(offset);
+    const start = bucketSeconds > 0 ? first - (first % bucketSeconds) : first;
+    const firstSoil = Math.fround(view.getInt16(offset + 8, true) / 100);
+    const bucket: Bucket = {
+      start, count: 0, soilMin: firstSoil, soilMax: firstSoil,
+      soilMean: 0, temperatureMean: 0, airMean: 0, lightMean: 0
+    };
+    let soilSum = 0;
+    let temperatureSum = 0;
+    let airSum = 0;
+    let lightSum = 0;
+    while (offset >= 0) {
+      const time = this.timeAt(offset);
+      if (time > toTime || time < start || (bucket.count > 0 && time - start >= bucketSeconds)) break;
+      const soil = view.getInt16(offset + 8, true) / 100;
+      bucket.soilMin = Math.min(bucket.soilMin, soil);
+      bucket.soilMax = Math.max(bucket.soilMax, soil);
+      soilSum += soil;
+      temperatureSum += view.getInt16(offset + 12, true) / 100;
+      airSum += view.getInt16(offset + 10, true) / 100;
+      lightSum += view.getFloat32(offset + 4, true);
+      bucket.count++;
+      cursor.sequence = probe.sequence;
+      cursor.slot = probe.slot;
+      offset = this.next(probe);
+    }
+    bucket.soilMean = soilSum / bucket.count;
+    bucket.temperatureMean = temperatureSum / bucket.count;
+    bucket.airMean = airSum / bucket.count;
+    bucket.lightMean = lightSum / bucket.count;
+    return bucket;
+  }
+
+  beginExport(fromTime: number, toTime: number, bucketSeconds: number): number {
+    this.exportFrom = fromTime;
+    this.exportTo = toTime;
+    this.exportBucket = bucketSeconds;
+    const cursor = this.seek(fromTime);
+    this.exportLines = 0;
+    while (this.downsample(cursor, toTime, bucketSeconds)) this.exportLines++;
+    this.exportLine = 0;
+    this.exportCursor = this.seek(fromTime);
+    this.chunkLine = 0;
+    this.chunkCursor = { ...this.exportCursor };
+    return this.exportLines * LINE_LENGTH;
+  }
+
+  private formatLine(cursor: Cursor): string {
+    const bucket = this.downsample(cursor, this.exportTo, this.exportBucket);
+    if (!bucket) return ' '.repeat(LINE_LENGTH - 1) + '\n';
+    const f = (v: number, width: number, digits: number) => v.toFixed(digits).padStart(width);
+    return [
+      String(bucket.start).padStart(10), String(Math.min(bucket.count, 999)).padStart(3),
+      f(bucket.soilMin, 6, 1), f(bucket.soilMean, 6, 1), f(bucket.soilMax, 6, 1),
+      f(Math.min(999.9, Math.max(-99.9, bucket.temperatureMean)), 6, 1), f(bucket.airMean, 6, 1),
+      f(Math.min(99999999, Math.max(0, bucket.lightMean)), 8, 0)
+    ].join(',') + '\n';
+  }
+
+  private rewindExport(line: number): void {
+    if (line === this.chunkLine) {
+      this.exportLine = this.chunkLine;
+      this.exportCursor = { ...this.chunkCursor };
+      return;
+    }
+    if (line < this.exportLine) {
+      this.exportLine = 0;
+      this.exportCursor = this.seek(this.exportFrom);
+    }
+    while (this.exportLine < line && this.downsample(this.exportCursor, this.exportTo, this.exportBucket)) {
+      this.exportLine++;
+    }
+  }
+
+  readExport(offset: number, capacity: number): string {
+    const line = Math.floor(offset / LINE_LENGTH);
+    let skip = offset % LINE_LENGTH;
+    if (line >= this.exportLines) return '';
+    if (line !== this.exportLine) this.rewindExport(line);
+    this.chunkLine = this.exportLine;
+    this.chunkCursor = { ...this.exportCursor };
+
+    let out = '';
+    while (out.length < capacity && this.exportLine < this.exportLines) {
+      const lineStart = { ...this.exportCursor };
+      const text = this.formatLine(this.exportCursor);
+      const length = Math.min(LINE_LENGTH - skip, capacity - out.length);
+      out += text.substr(skip, length);
+      if (skip + length < LINE_LENGTH) {
+        this.exportCursor = lineStart;
+        break;
+      }
+      this.exportLine++;
+      skip = 0;
+    }
+    return out;
+  }
+}
+
+function makeSamples(count: number, random: Random): Sample[] {
+  const samples: Sample[] = [];
+  let time = START_TIME;
+  for (let i = 0; i < count; i++) {
+    time += 60 + Math.floor(random() * 600);
+    samples.push({
+      time,
+      soil: Math.round(random() * 10000) / 100,
+      air: Math.round(random() * 10000) / 100,
+      temperature: Math.round((random() * 50 - 5) * 100) / 100,
+      light: Math.round(random() * 80000)
+    });
+  }
+  return samples;
+}
+
+function readAll(log: MockHistoryLog, cursor: Cursor): number[] {
+  const times: number[] = [];
+  let offset: number;
+  while ((offset = log.next(cursor)) >= 0) times.push(log.timeAt(offset));
+  return times;
+}
+
+const MIN_VALID_TIME = 1577836800;
+
+// 模拟数据采集管理器的归档 (对应固件中的DataCollectionManager::archiveSample)：
+// 网络时间同步前样本只留在环形缓冲区，同步后按millis间隔推算Unix时间补写
+class MockArchivingCollector {
+  buffer: { millis: number; sample: Sample }[] = [];
+  unarchivedCount = 0;
+
+  constructor(private log: MockHistoryLog, private capacity: number) {}
+
+  collect(sample: Sample, millis: number, now: number): void {
+    this.buffer.push({ millis, sample });
+    if (this.buffer.length > this.capacity) this.buffer.shift();
+
+    if (now < MIN_VALID_TIME) {
+      this.unarchivedCount = Math.min(this.unarchivedCount + 1, this.buffer.length);
+      return;
+    }
+    const count = this.buffer.length;
+    const backlog = Math.min(this.unarchivedCount, count - 1);
+    for (let i = backlog; i >= 1; i--) {
+      const earlier = this.buffer[count - 1 - i];
+      this.log.append({ ...earlier.sample, time: now - Math.floor((millis - earlier.millis) / 1000) });
+    }
+    this.unarchivedCount = 0;
+    this.log.append({ ...sample, time: now });
+  }
+}
+
+describe('历史数据闪存归档属性测试', () => {
+  describe('属性: 环形日志', () => {
+    test('Property: 写满后覆盖最旧扇区，保留的记录按时间顺序完整可读', () => {
+      fc.assert(
+        fc.property(
+          fc.integer({ min: 2, max: 6 }),
+          fc.integer({ min: 0, max: 2000 }),
+          fc.integer({ min: 1, max: 0x7fffffff }),
+          (sectors, count, seed) => {
+            const log = new MockHistoryLog(new FlashImage(sectors));
+            const samples = makeSamples(count, seededRandom(seed));
+            samples.forEach(s => log.append(s));
+            const retained = log.recordCount();
+            const times = readAll(log, { sequence: 0, slot: 0 });
+            const expected = samples.slice(samples.length - retained).map(s => s.time);
+            return retained <= sectors * RECORDS_PER_SECTOR &&
+                   retained >= Math.min(count, (sectors - 1) * RECORDS_PER_SECTOR) &&
+                   JSON.stringify(times) === JSON.stringify(expected);
+          }
+        ),
+        { numRuns: 100 }
+      );
+    });
+
+    test('Property: 重新上电扫描扇区头后恢复写入位置，继续追加不丢记录', () => {
+      fc.assert(
+        fc.property(
+          fc.integer({ min: 2, max: 5 }),
+          fc.integer({ min: 1, max: 1500 }),
+          fc.integer({ min: 0, max: 600 }),
+          fc.integer({ min: 1, max: 0x7fffffff }),
+          (sectors, before, after, seed) => {
+            const flash = new FlashImage(sectors);
+            const samples = makeSamples(before + after, seededRandom(seed));
+            const first = new MockHistoryLog(flash);
+            samples.slice(0, before).forEach(s => first.append(s));
+
+            const rebooted = new MockHistoryLog(flash);
+            if (rebooted.recordCount() !== first.recordCount()) return false;
+            samples.slice(before).forEach(s => rebooted.append(s));
+            const times = readAll(rebooted, { sequence: 0, slot: 0 });
+            const expected = samples.slice(samples.length - rebooted.recordCount()).map(s => s.time);
+            return JSON.stringify(times) === JSON.stringify(expected);
+          }
+        ),
+        { numRuns: 100 }
+      );
+    });
+
+    test('Property: 写到一半断电的记录被跳过，不影响前后的记录', () => {
+      fc.assert(
+        fc.property(
+          fc.integer({ min: 1, max: 400 }),
+          fc.integer({ min: 1, max: RECORD_SIZE - 1 }),
+          fc.integer({ min: 1, max: 300 }),
+          fc.integer({ min: 1, max: 0x7fffffff }),
+          (before, tornBytes, after, seed) => {
+            const flash = new FlashImage(4);
+            const samples = makeSamples(before + 1 + after, seededRandom(seed));
+            const log = new MockHistoryLog(flash);
+            samples.slice(0, before).forEach(s => log.append(s));
+            log.append(samples[before], tornBytes);
+
+            const rebooted = new MockHistoryLog(flash);
+            samples.slice(before + 1).forEach(s => rebooted.append(s));
+            const times = readAll(rebooted, { sequence: 0, slot: 0 });
+            const expected = samples.filter((_, i) => i !== before).map(s => s.time);
+            return JSON.stringify(times) === JSON.stringify(expected);
+          }
+        ),
+        { numRuns: 100 }
+      );
+    });
+  });
+
+  describe('属性: 定位与降采样', () => {
+    test('Property: 按时间定位后读到的正好是不早于该时刻的全部记录', () => {
+      fc.assert(
+        fc.property(
+          fc.integer({ min: 1, max: 1500 }),
+          fc.float({ min: 0, max: 1, noNaN: true }),
+          fc.integer({ min: 1, max: 0x7fffffff }),
+          (count, position, seed) => {
+            const log = new MockHistoryLog(new FlashImage(8));
+            const samples = makeSamples(count, seededRandom(seed));
+            samples.forEach(s => log.append(s));
+            const from = START_TIME + Math.floor(position * (samples[count - 1].time - START_TIME + 1000));
+            const times = readAll(log, log.seek(from));
+            const expected = samples.filter(s => s.time >= from).map(s => s.time);
+            return JSON.stringify(times) === JSON.stringify(expected);
+          }
+        ),
+        { numRuns: 100 }
+      );
+    });
+
+    test('Property: 降采样各桶样本数之和等于范围内记录数，最小值≤平均值≤最大值', () => {
+      fc.assert(
+        fc.property(
+          fc.integer({ min: 1, max: 1500 }),
+          fc.constantFrom(0, 600, 3600, 86400),
+          fc.integer({ min: 1, max: 0x7fffffff }),
+          (count, bucketSeconds, seed) => {
+            const log = new MockHistoryLog(new FlashImage(8));
+            const samples = makeSamples(count, seededRandom(seed));
+            samples.forEach(s => log.append(s));
+            const from = samples[Math.floor(count / 4)].time;
+            const to = samples[Math.floor((count * 3) / 4)].time;
+            const cursor = log.seek(from);
+            let total = 0;
+            let previous = -1;
+            let bucket: Bucket | null;
+            while ((bucket = log.downsample(cursor, to, bucketSeconds)) !== null) {
+              if (bucket.start <= previous) return false;
+              if (bucket.soilMin > bucket.soilMean + 1e-9 || bucket.soilMean > bucket.soilMax + 1e-9) return false;
+              if (bucketSeconds > 0 && bucket.start % bucketSeconds !== 0) return false;
+              previous = bucket.start;
+              total += bucket.count;
+            }
+            return total === samples.filter(s => s.time >= from && s.time <= to).length;
+          }
+        ),
+        { numRuns: 100 }
+      );
+    });
+  });
+
+  describe('属性: 分块导出', () => {
+    test('Property: 任意块大小与重传下拼接的导出文本与一次读出的相同，每行定长', () => {
+      fc.assert(
+        fc.property(
+          fc.integer({ min: 1, max: 1200 }),
+          fc.constantFrom(0, 900, 3600),
+          fc.integer({ min: 16, max: 1024 }),
+          fc.integer({ min: 1, max: 0x7fffffff }),
+          (count, bucketSeconds, chunkSize, seed) => {
+            const random = seededRandom(seed);
+            const log = new MockHistoryLog(new FlashImage(8));
+            const samples = makeSamples(count, random);
+            samples.forEach(s => log.append(s));
+            const from = samples[0].time;
+            const to = samples[count - 1].time;
+
+            const total = log.beginExport(from, to, bucketSeconds);
+            const reference = log.readExport(0, total + 1);
+            if (reference.length !== total) return false;
+            if (!reference.split('\n').slice(0, -1).every(line => line.length === LINE_LENGTH - 1)) return false;
+
+            // 模拟批量上行：块发送失败时以相同偏移重读，偶尔从头重新开始
+            log.beginExport(from, to, bucketSeconds);
+            let offset = 0;
+            let assembled = '';
+            let restarted = false;
+            while (offset < total) {
+              const chunk = log.readExport(offset, chunkSize);
+              if (chunk.length === 0) return false;
+              if (random() < 0.2 && log.readExport(offset, chunkSize) !== chunk) return false;
+              if (!restarted && random() < 0.05) {
+                restarted = true;
+                offset = 0;
+                assembled = '';
+                continue;
+              }
+              assembled += chunk;
+              offset += chunk.length;
+            }
+            return assembled === reference && log.readExport(total, chunkSize) === '';
+          }
+        ),
+        { numRuns: 100 }
+      );
+    });
+  });
+
+  describe('属性: 网络时间同步前的样本', () => {
+    test('Property: 同步后补写缓冲区内的早期样本，推算时刻与真实时刻相差不超过1秒且按时间顺序', () => {
+      fc.assert(
+        fc.property(
+          fc.integer({ min: 1, max: 300 }),
+          fc.integer({ min: 0, max: 300 }),
+          fc.integer({ min: 2, max: 200 }),
+          fc.integer({ min: 1, max: 0x7fffffff }),
+          (count, syncIndex, capacity, seed) => {
+            const random = seededRandom(seed);
+            const log = new MockHistoryLog(new FlashImage(8));
+            const collector = new MockArchivingCollector(log, capacity);
+            const samples = makeSamples(count, random);
+
+            // 真实时刻 = START_TIME + millis/1000；同步前系统时间从0开始计
+            const truth: number[] = [];
+            let millis = 5000;
+            samples.forEach((sample, i) => {
+              millis += 1000 + Math.floor(random() * 600000);
+              const wall = START_TIME + millis / 1000;
+              truth.push(wall);
+              collector.collect(sample, millis, i >= syncIndex ? Math.floor(wall) : Math.floor(millis / 1000));
+            });
+
+            const times = readAll(log, log.seek(0));
+            const synced = Math.min(syncIndex, count);
+            const backfilled = synced < count ? Math.min(synced, capacity - 1) : 0;
+            if (times.length !== backfilled + count - synced) return false;
+
+            const expected = truth.slice(synced - backfilled);
+            return times.every((t, i) => Math.abs(t - expected[i]) <= 1 && (i === 0 || t >= times[i - 1]));
+          }
+        ),
+        { numRuns: 100 }
+      );
+    });
+
+    test('一直未同步时不写入归档', () => {
+      const log = new MockHistoryLog(new FlashImage(4));
+      const collector = new MockArchivingCollector(log, 16);
+      makeSamples(40, seededRandom(7)).forEach((sample, i) => collector.collect(sample, i * 300000, i * 300));
+      expect(log.recordCount()).toBe(0);
+      expect(collector.unarchivedCount).toBe(16);
+    });
+  });
+});
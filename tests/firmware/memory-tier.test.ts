@@ -0,0 +1,226 @@
+/**
+ * 分层内存管理属性测试
+ * 验证回退分配记在实际提供内存的层上，以及各层的占用、峰值、失败与回退统计
+ */
+
+import fc from 'fast-check';
+
+type Tier = 'internal' | 'psram';
+
+interface TierStats {
+  bytesInUse: number;
+  peakBytes: number;
+  allocations: number;
+  failures: number;
+  fallbacks: number;
+}
+
+interface Block {
+  id: number;
+  heap: Tier;
+  size: number;
+}
+
+// 模拟堆（对应heap_caps按能力标志分配的内部SRAM与PSRAM）
+class MockHeap {
+  used = 0;
+  constructor(public capacity: number) {}
+
+  malloc(size: number): boolean {
+    if (this.used + size > this.capacity) return false;
+    this.used += size;
+    return true;
+  }
+
+  free(size: number): void {
+    this.used -= size;
+  }
+}
+
+function emptyStats(): TierStats {
+  return { bytesInUse: 0, peakBytes: 0, allocations: 0, failures: 0, fallbacks: 0 };
+}
+
+// 模拟分层内存管理器（对应固件中的MemoryTierManager）
+class MockMemoryTierManager {
+  stats = { internal: emptyStats(), psram: emptyStats() };
+  heaps: { internal: MockHeap; psram: MockHeap };
+  private nextId = 0;
+
+  constructor(internalCapacity: number, psramCapacity: number, private psramAvailable: boolean) {
+    this.heaps = { internal: new MockHeap(internalCapacity), psram: new MockHeap(psramCapacity) };
+  }
+
+  private recordAllocation(tier: Tier, size: number): void {
+    const s = this.stats[tier];
+    s.bytesInUse += size;
+    s.allocations++;
+    if (s.bytesInUse > s.peakBytes) s.peakBytes = s.bytesInUse;
+  }
+
+  allocate(tier: Tier, size: number): Block | null {
+    if (size === 0) return null;
+
+    if (tier === 'psram' && this.psramAvailable && this.heaps.psram.malloc(size)) {
+      this.recordAllocation('psram', size);
+      return { id: this.nextId++, heap: 'psram', size };
+    }
+
+    if (!this.heaps.internal.malloc(size)) {
+      this.stats[tier].failures++;
+      return null;
+    }
+    if (tier === 'psram') this.stats.psram.fallbacks++;
+    this.recordAllocation('internal', size);
+    return { id: this.nextId++, heap: 'internal', size };
+  }
+
+  // 按指针所在的层扣减 (固件中由esp_ptr_external_ram判断)
+  release(block: Block): void {
+    this.heaps[block.heap].free(block.size);
+    const s = this.stats[block.heap];
+    s.bytesInUse = s.bytesInUse > block.size ? s.bytesInUse - block.size : 0;
+  }
+}
+
+type Action =
+  | { op: 'alloc'; tier: Tier; size: number }
+  | { op: 'free'; index: number };
+
+const actionArb: fc.Arbitrary<Action> = fc.oneof(
+  fc.record({
+    op: fc.constant('alloc' as const),
+    tier: fc.constantFrom('internal' as const, 'psram' as const),
+    size: fc.integer({ min: 0, max: 4096 })
+  }),
+  fc.record({ op: fc.constant('free' as const), index: fc.nat() })
+);
+
+const managerArb = fc.record({
+  internalCapacity: fc.integer({ min: 0, max: 16384 }),
+  psramCapacity: fc.integer({ min: 0, max: 65536 }),
+  psramAvailable: fc.boolean()
+});
+
+describe('分层内存管理属性测试', () => {
+  describe('属性: 按实际提供内存的层计数', () => {
+    test('Property: 每层的占用字节数等于该层堆上未释放块的大小之和', () => {
+      fc.assert(
+        fc.property(managerArb, fc.array(actionArb, { maxLength: 80 }), (config, actions) => {
+          const manager = new MockMemoryTierManager(config.internalCapacity, config.psramCapacity, config.psramAvailable);
+          const live: Block[] = [];
+
+          for (const action of actions) {
+            if (action.op === 'alloc') {
+              const block = manager.allocate(action.tier, action.size);
+              if (block) live.push(block);
+            } else if (live.length > 0) {
+              const [block] = live.splice(action.index % live.length, 1);
+              manager.release(block);
+            }
+
+            for (const tier of ['internal', 'psram'] as Tier[]) {
+              const expected = live.filter(b => b.heap === tier).reduce((sum, b) => sum + b.size, 0);
+              if (manager.stats[tier].bytesInUse !== expected) return false;
+              if (manager.heaps[tier].used !== expected) return false;
+              if (manager.stats[tier].peakBytes < expected) return false;
+            }
+          }
+          return true;
+        }),
+        { numRuns: 300 }
+      );
+    });
+
+    test('Property: 全部释放后两层占用归零，峰值不超过该层容量', () => {
+      fc.assert(
+        fc.property(managerArb, fc.array(actionArb, { maxLength: 80 }), (config, actions) => {
+          const manager = new MockMemoryTierManager(config.internalCapacity, config.psramCapacity, config.psramAvailable);
+          const live: Block[] = [];
+          for (const action of actions) {
+            if (action.op !== 'alloc') continue;
+            const block = manager.allocate(action.tier, action.size);
+            if (block) live.push(block);
+          }
+          live.forEach(block => manager.release(block));
+
+          return manager.stats.internal.bytesInUse === 0 &&
+                 manager.stats.psram.bytesInUse === 0 &&
+                 manager.stats.internal.peakBytes <= config.internalCapacity &&
+                 manager.stats.psram.peakBytes <= config.psramCapacity;
+        }),
+        { numRuns: 300 }
+      );
+    });
+
+    test('Property: 分配、失败与回退次数与请求结果一一对应', () => {
+      fc.assert(
+        fc.property(managerArb, fc.array(actionArb, { maxLength: 80 }), (config, actions) => {
+          const manager = new MockMemoryTierManager(config.internalCapacity, config.psramCapacity, config.psramAvailable);
+          const served = { internal: 0, psram: 0 };
+          const failed = { internal: 0, psram: 0 };
+          let fallbacks = 0;
+
+          for (const action of actions) {
+            if (action.op !== 'alloc' || action.size === 0) continue;
+            const block = manager.allocate(action.tier, action.size);
+            if (!block) {
+              failed[action.tier]++;
+              continue;
+            }
+            served[block.heap]++;
+            if (action.tier === 'psram' && block.heap === 'internal') fallbacks++;
+            // 请求内部SRAM时绝不落到PSRAM
+            if (action.tier === 'internal' && block.heap !== 'internal') return false;
+          }
+
+          return manager.stats.internal.allocations === served.internal &&
+                 manager.stats.psram.allocations === served.psram &&
+                 manager.stats.internal.failures === failed.internal &&
+                 manager.stats.psram.failures === failed.psram &&
+                 manager.stats.psram.fallbacks === fallbacks &&
+                 manager.stats.internal.fallbacks === 0 &&
+                 (config.psramAvailable || manager.stats.psram.allocations === 0);
+        }),
+        { numRuns: 300 }
+      );
+    });
+  });
+
+  describe('回退分配示例', () => {
+    test('没有PSRAM时PSRAM请求记在内部SRAM上并计入回退', () => {
+      const manager = new MockMemoryTierManager(8192, 0, false);
+      const block = manager.allocate('psram', 1024);
+
+      expect(block && block.heap).toBe('internal');
+      expect(manager.stats.internal.bytesInUse).toBe(1024);
+      expect(manager.stats.internal.allocations).toBe(1);
+      expect(manager.stats.psram.bytesInUse).toBe(0);
+      expect(manager.stats.psram.allocations).toBe(0);
+      expect(manager.stats.psram.fallbacks).toBe(1);
+
+      manager.release(block!);
+      expect(manager.stats.internal.bytesInUse).toBe(0);
+      expect(manager.stats.internal.peakBytes).toBe(1024);
+    });
+
+    test('PSRAM已满时退回内部SRAM，释放按实际所在层扣减', () => {
+      const manager = new MockMemoryTierManager(4096, 2048, true);
+      const first = manager.allocate('psram', 2048)!;
+      const second = manager.allocate('psram', 1024)!;
+
+      expect(first.heap).toBe('psram');
+      expect(second.heap).toBe('internal');
+      expect(manager.stats.psram.bytesInUse).toBe(2048);
+      expect(manager.stats.internal.bytesInUse).toBe(1024);
+
+      manager.release(second);
+      expect(manager.stats.internal.bytesInUse).toBe(0);
+      expect(manager.stats.psram.bytesInUse).toBe(2048);
+
+      expect(manager.allocate('psram', 8192)).toBeNull();
+      expect(manager.stats.psram.failures).toBe(1);
+      expect(manager.stats.internal.failures).toBe(0);
+    });
+  });
+});
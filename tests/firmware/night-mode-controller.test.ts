@@ -0,0 +1,176 @@
+/**
+ * 夜间模式控制器属性测试
+ * 验证基于环境光的昼夜判定滞回与持续时间条件
+ */
+
+import fc from 'fast-check';
+
+const ENTER_LUX = 5.0;
+const EXIT_LUX = 20.0;
+const ENTER_DELAY_MS = 900000;
+const EXIT_DELAY_MS = 120000;
+const SAMPLE_INTERVAL = 10000;
+const SAMPLE_INTERVAL_NIGHT = 60000;
+const SAMPLING_FACTOR = 4;
+
+type LuxAt = (t: number) => number;
+
+// 模拟夜间模式控制器（对应固件中的NightModeController逻辑）
+class MockNightModeController {
+  night = false;
+  switches = 0;
+  private transitionPending = false;
+  private transitionStartTime = 0;
+  private lastSampleTime = 0;
+  private sampled = false;
+
+  wantsSample(now: number): boolean {
+    if (!this.sampled) return true;
+    const interval = this.night ? SAMPLE_INTERVAL_NIGHT : SAMPLE_INTERVAL;
+    return now - this.lastSampleTime >= interval;
+  }
+
+  onLightSample(now: number, lux: number): void {
+    this.lastSampleTime = now;
+    this.sampled = true;
+
+    const wantsSwitch = this.night ? lux > EXIT_LUX : lux < ENTER_LUX;
+    if (!wantsSwitch) {
+      this.transitionPending = false;
+      return;
+    }
+    if (!this.transitionPending) {
+      this.transitionPending = true;
+      this.transitionStartTime = now;
+      return;
+    }
+    const required = this.night ? EXIT_DELAY_MS : ENTER_DELAY_MS;
+    if (now - this.transitionStartTime >= required) {
+      this.night = !this.night;
+      this.transitionPending = false;
+      this.switches++;
+    }
+  }
+
+  getSamplingFactor(): number {
+    return this.night ? SAMPLING_FACTOR : 1;
+  }
+}
+
+// 以1秒步长运行，返回控制器与夜间累计时长
+function run(durationMs: number, luxAt: LuxAt): { controller: MockNightModeController; nightMs: number } {
+  const controller = new MockNightModeController();
+  let nightMs = 0;
+  for (let t = 0; t < durationMs; t += 1000) {
+    if (controller.wantsSample(t)) controller.onLightSample(t, luxAt(t));
+    if (controller.night) nightMs += 1000;
+  }
+  return { controller, nightMs };
+}
+
+describe('夜间模式控制器属性测试', () => {
+  describe('属性: 滞回与持续时间', () => {
+    test('Property: 短于进入延迟的遮挡不会进入夜间模式', () => {
+      fc.assert(
+        fc.property(
+          fc.integer({ min: 0, max: 3600000 }),
+          fc.integer({ min: 1000, max: ENTER_DELAY_MS - SAMPLE_INTERVAL }),
+          fc.float({ min: 100, max: 10000, noNaN: true }),
+          (shadowStart, shadowLength, dayLux) => {
+            const { controller } = run(7200000, t =>
+              t >= shadowStart && t < shadowStart + shadowLength ? 0 : dayLux);
+            return controller.switches === 0;
+          }
+        ),
+        { numRuns: 50 }
+      );
+    });
+
+    test('Property: 持续黑暗在进入延迟后一个采样周期内进入夜间模式', () => {
+      fc.assert(
+        fc.property(
+          fc.integer({ min: 0, max: 3600000 }),
+          fc.float({ min: 0, max: Math.fround(4.9), noNaN: true }),
+          (darkStart, darkLux) => {
+            const controller = new MockNightModeController();
+            let enteredAt = -1;
+            for (let t = 0; t < darkStart + 2 * ENTER_DELAY_MS; t += 1000) {
+              if (controller.wantsSample(t)) controller.onLightSample(t, t >= darkStart ? darkLux : 500);
+              if (enteredAt < 0 && controller.night) enteredAt = t;
+            }
+            return enteredAt >= darkStart + ENTER_DELAY_MS &&
+                   enteredAt <= darkStart + ENTER_DELAY_MS + 2 * SAMPLE_INTERVAL;
+          }
+        ),
+        { numRuns: 50 }
+      );
+    });
+
+    test('Property: 夜间短暂开灯不会退出夜间模式', () => {
+      fc.assert(
+        fc.property(
+          fc.integer({ min: 0, max: 3600000 }),
+          fc.integer({ min: 1000, max: EXIT_DELAY_MS - SAMPLE_INTERVAL_NIGHT }),
+          (lampStart, lampLength) => {
+            const offset = ENTER_DELAY_MS + 2 * SAMPLE_INTERVAL;
+            const { controller } = run(offset + 7200000, t =>
+              t >= offset + lampStart && t < offset + lampStart + lampLength ? 300 : 0);
+            return controller.night && controller.switches === 1;
+          }
+        ),
+        { numRuns: 50 }
+      );
+    });
+
+    test('Property: 照度在两阈值之间徘徊时不切换', () => {
+      fc.assert(
+        fc.property(
+          fc.boolean(),
+          fc.integer({ min: 1, max: 0x7fffffff }),
+          (startNight, seed) => {
+            let s = seed >>> 0;
+            const random = () => {
+              s = (s * 1664525 + 1013904223) >>> 0;
+              return s / 0x100000000;
+            };
+            const controller = new MockNightModeController();
+            if (startNight) {
+              for (let t = 0; t <= ENTER_DELAY_MS + SAMPLE_INTERVAL; t += SAMPLE_INTERVAL) {
+                controller.onLightSample(t, 0);
+              }
+            }
+            const before = controller.switches;
+            for (let t = 0; t < 7200000; t += 1000) {
+              const now = 2 * ENTER_DELAY_MS + t;
+              if (controller.wantsSample(now)) {
+                controller.onLightSample(now, ENTER_LUX + random() * (EXIT_LUX - ENTER_LUX));
+              }
+            }
+            return controller.switches === before && controller.night === startNight;
+          }
+        ),
+        { numRuns: 50 }
+      );
+    });
+  });
+
+  describe('属性: 全天效果', () => {
+    test('Property: 一天中夜间时长约等于黑暗时长减去进入延迟', () => {
+      fc.assert(
+        fc.property(
+          fc.integer({ min: 6, max: 12 }),
+          fc.float({ min: 200, max: 20000, noNaN: true }),
+          (darkHours, dayLux) => {
+            const day = 24 * 3600000;
+            const darkStart = day - darkHours * 3600000;
+            const { controller, nightMs } = run(day, t => (t >= darkStart ? 0 : dayLux));
+            const expected = darkHours * 3600000 - ENTER_DELAY_MS;
+            return controller.night && Math.abs(nightMs - expected) <= 2 * SAMPLE_INTERVAL &&
+                   controller.getSamplingFactor() === SAMPLING_FACTOR;
+          }
+        ),
+        { numRuns: 30 }
+      );
+    });
+  });
+});
@@ -0,0 +1,291 @@
+/**
+ * 分位数草图属性测试
+ * 验证样本数与总权重守恒、固定内存上限、分位数/比例误差、合并以及上传格式大小
+ */
+
+import fc from 'fast-check';
+
+const K = 32;
+const MAX_LEVELS = 12;
+const CAPACITY = 120;
+
+type Random = () => number;
+
+function seededRandom(seed: number): Random {
+  let s = seed >>> 0;
+  return () => {
+    s = (s * 1664525 + 1013904223) >>> 0;
+    return s / 0x100000000;
+  };
+}
+
+// 模拟KLL草图（对应固件中的QuantileSketch逻辑，分层数组代替固件中的连续缓冲区）
+class MockQuantileSketch {
+  levels: number[][] = [[]];
+  count = 0;
+  min = NaN;
+  max = NaN;
+  saturated = false;
+
+  constructor(private random: Random) {}
+
+  private capacityOf(level: number): number {
+    const depth = this.levels.length - level - 1;
+    return Math.ceil(K * Math.pow(2 / 3, depth)) + 1;
+  }
+
+  private maxRetained(): number {
+    let total = 0;
+    for (let h = 0; h < this.levels.length; h++) total += this.capacityOf(h);
+    return total;
+  }
+
+  retained(): number {
+    return this.levels.reduce((sum, level) => sum + level.length, 0);
+  }
+
+  private compact(level: number): void {
+    const items = this.levels[level].sort((a, b) => a - b);
+    const keep = items.length & 1;
+    const offset = this.random() < 0.5 ? 0 : 1;
+    const survivors: number[] = [];
+    for (let i = keep + offset; i < items.length; i += 2) survivors.push(items[i]);
+    this.levels[level] = items.slice(0, keep);
+    this.levels[level + 1] = survivors.concat(this.levels[level + 1]);
+  }
+
+  private compress(): boolean {
+    while (this.retained() >= this.maxRetained()) {
+      let level = 0;
+      while (level < this.levels.length && this.levels[level].length < this.capacityOf(level)) level++;
+      if (level >= this.levels.length) return true;
+      if (level + 1 >= this.levels.length) {
+        if (this.levels.length >= MAX_LEVELS) {
+          this.saturated = true;
+          return false;
+        }
+        this.levels.push([]);
+      }
+      this.compact(level);
+    }
+    return true;
+  }
+
+  private insertAt(level: number, value: number): boolean {
+    if (this.retained() >= CAPACITY) return false;
+    this.levels[level].push(value);
+    return true;
+  }
+
+  add(value: number): void {
+    if (Number.isNaN(value)) return;
+    this.count++;
+    if (this.count === 1 || value < this.min) this.min = value;
+    if (this.count === 1 || value > this.max) this.max = value;
+    if (!this.saturated && this.insertAt(0, value)) this.compress();
+  }
+
+  merge(other: MockQuantileSketch): boolean {
+    if (other.count === 0) return true;
+    while (this.levels.length < other.levels.length) {
+      if (this.levels.length >= MAX_LEVELS) return false;
+      this.levels.push([]);
+    }
+    for (let h = 0; h < other.levels.length; h++) {
+      for (const value of other.levels[h]) {
+        if (this.saturated || !this.insertAt(h, value) || !this.compress()) return false;
+      }
+    }
+    if (this.count === 0 || other.min < this.min) this.min = other.min;
+    if (this.count === 0 || other.max > this.max) this.max = other.max;
+    this.count += other.count;
+    return true;
+  }
+
+  totalWeight(): number {
+    return this.levels.reduce((sum, level, h) => sum + level.length * Math.pow(2, h), 0);
+  }
+
+  getRank(value: number): number {
+    let below = 0;
+    this.levels.forEach((level, h) => {
+      for (const item of level) if (item <= value) below += Math.pow(2, h);
+    });
+    const total = this.totalWeight();
+    return total > 0 ? below / total : 0;
+  }
+
+  getQuantile(q: number): number {
+    if (this.count === 0) return NaN;
+    if (q <= 0) return this.min;
+    if (q >= 1) return this.max;
+    const weighted: Array<[number, number]> = [];
+    this.levels.forEach((level, h) => level.forEach(v => weighted.push([v, Math.pow(2, h)])));
+    weighted.sort((a, b) => a[0] - b[0]);
+    const target = q * this.totalWeight();
+    let cumulative = 0;
+    for (const [value, weight] of weighted) {
+      cumulative += weight;
+      if (cumulative >= target) return value;
+    }
+    return this.max;
+  }
+
+  toJson(scale: number): string {
+    return JSON.stringify({
+      n: this.count, min: this.min, max: this.max, k: K, scale,
+      levels: this.levels.map(level => level.map(v => Math.round(v * scale)))
+    });
+  }
+}
+
+function exactRank(sorted: number[], value: number): number {
+  let lo = 0;
+  let hi = sorted.length;
+  while (lo < hi) {
+    const mid = (lo + hi) >> 1;
+    if (sorted[mid] <= value) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo / sorted.length;
+}
+
+// 一天的土壤湿度：浇水后跳升、随后缓慢下降，叠加噪声
+function soilDay(samples: number, random: Random): number[] {
+  const values: number[] = [];
+  let moisture = 20 + random() * 40;
+  for (let i = 0; i < samples; i++) {
+    if (random() < 0.01) moisture = 55 + random() * 20;
+    moisture = Math.max(5, moisture - random() * 0.3);
+    values.push(Math.round((moisture + (random() - 0.5) * 2) * 10) / 10);
+  }
+  return values;
+}
+
+describe('分位数草图属性测试', () => {
+  describe('属性: 守恒与固定内存', () => {
+    test('Property: 样本数、最小值和最大值精确，总权重等于样本数', () => {
+      fc.assert(
+        fc.property(
+          fc.array(fc.float({ min: -40, max: 80, noNaN: true }), { maxLength: 3000 }),
+          fc.integer({ min: 1, max: 0x7fffffff }),
+          (values, seed) => {
+            const sketch = new MockQuantileSketch(seededRandom(seed));
+            values.forEach(v => sketch.add(v));
+            if (sketch.count !== values.length || sketch.totalWeight() !== values.length) return false;
+            if (values.length === 0) return Number.isNaN(sketch.min);
+            return sketch.min === Math.min(...values) && sketch.max === Math.max(...values);
+          }
+        ),
+        { numRuns: 100 }
+      );
+    });
+
+    test('Property: 任意样本数下保留量不超过固定容量', () => {
+      fc.assert(
+        fc.property(
+          fc.integer({ min: 1, max: 20000 }),
+          fc.integer({ min: 1, max: 0x7fffffff }),
+          (n, seed) => {
+            const random = seededRandom(seed);
+            const sketch = new MockQuantileSketch(random);
+            let peak = 0;
+            for (let i = 0; i < n; i++) {
+              sketch.add(random() * 100);
+              peak = Math.max(peak, sketch.retained());
+            }
+            return peak <= CAPACITY && !sketch.saturated;
+          }
+        ),
+        { numRuns: 30 }
+      );
+    });
+  });
+
+  describe('属性: 精度', () => {
+    test('Property: 一天的土壤湿度样本，低于阈值的比例误差不超过6%', () => {
+      fc.assert(
+        fc.property(
+          fc.integer({ min: 50, max: 3000 }),
+          fc.integer({ min: 1, max: 0x7fffffff }),
+          (samples, seed) => {
+            const random = seededRandom(seed);
+            const values = soilDay(samples, random);
+            const sketch = new MockQuantileSketch(random);
+            values.forEach(v => sketch.add(v));
+            const sorted = [...values].sort((a, b) => a - b);
+            return [10, 20, 30, 40, 60].every(t => Math.abs(sketch.getRank(t) - exactRank(sorted, t)) <= 0.06);
+          }
+        ),
+        { numRuns: 100 }
+      );
+    });
+
+    test('Property: 分位数结果的真实秩与所求分位相差不超过6%', () => {
+      fc.assert(
+        fc.property(
+          fc.integer({ min: 50, max: 3000 }),
+          fc.integer({ min: 1, max: 0x7fffffff }),
+          (samples, seed) => {
+            const random = seededRandom(seed);
+            const values = soilDay(samples, random);
+            const sketch = new MockQuantileSketch(random);
+            values.forEach(v => sketch.add(v));
+            const sorted = [...values].sort((a, b) => a - b);
+            return [0.1, 0.25, 0.5, 0.75, 0.9].every(q => {
+              const value = sketch.getQuantile(q);
+              // 重复值使秩成为区间，取区间内离q最近的点
+              const upper = exactRank(sorted, value);
+              const lower = exactRank(sorted, value - 1e-9);
+              const nearest = Math.min(Math.max(q, lower), upper);
+              return Math.abs(nearest - q) <= 0.06;
+            });
+          }
+        ),
+        { numRuns: 100 }
+      );
+    });
+  });
+
+  describe('属性: 合并', () => {
+    test('Property: 多天多设备合并后样本数守恒，比例误差不超过8%', () => {
+      fc.assert(
+        fc.property(
+          fc.array(fc.integer({ min: 1, max: 1500 }), { minLength: 2, maxLength: 10 }),
+          fc.integer({ min: 1, max: 0x7fffffff }),
+          (days, seed) => {
+            const random = seededRandom(seed);
+            const merged = new MockQuantileSketch(random);
+            const all: number[] = [];
+            for (const samples of days) {
+              const values = soilDay(samples, random);
+              const daily = new MockQuantileSketch(random);
+              values.forEach(v => daily.add(v));
+              if (!merged.merge(daily)) return false;
+              all.push(...values);
+            }
+            if (merged.count !== all.length || merged.totalWeight() !== all.length) return false;
+            if (merged.retained() > CAPACITY) return false;
+            const sorted = all.sort((a, b) => a - b);
+            return [15, 25, 35, 50].every(t => Math.abs(merged.getRank(t) - exactRank(sorted, t)) <= 0.08);
+          }
+        ),
+        { numRuns: 50 }
+      );
+    });
+  });
+
+  describe('属性: 上传大小', () => {
+    test('Property: 5分钟采样一天 (288个样本) 的单通道草图不超过600字节', () => {
+      fc.assert(
+        fc.property(fc.integer({ min: 1, max: 0x7fffffff }), (seed) => {
+          const random = seededRandom(seed);
+          const sketch = new MockQuantileSketch(random);
+          soilDay(288, random).forEach(v => sketch.add(v));
+          return sketch.toJson(10).length <= 600;
+        }),
+        { numRuns: 50 }
+      );
+    });
+  });
+});
@@ -0,0 +1,270 @@
+/**
+ * 日程调度器属性测试
+ * 验证定时任务的下次执行时间、跨零点时段判定、唤醒时间和错过任务的补执行
+ */
+
+import fc from 'fast-check';
+
+const DAY_S = 24 * 3600;
+const EVERY_DAY = 0x7f;
+const CATCHUP_LIMIT_S = 21600;
+
+// 测试中的本地时间按UTC处理 (固件使用localtime_r/mktime)
+interface LocalTime {
+  wday: number;
+  minuteOfDay: number;
+  sec: number;
+  yday: number;
+}
+
+class Job {
+  nextFire = 0;
+  runs = 0;
+  constructor(public hour: number, public minute: number, public weekdays: number) {}
+}
+
+class Window {
+  constructor(public startMinute: number, public endMinute: number, public weekdays: number) {}
+}
+
+function local(t: number): LocalTime {
+  const d = new Date(t * 1000);
+  const startOfYear = Date.UTC(d.getUTCFullYear(), 0, 1) / 1000;
+  return {
+    wday: d.getUTCDay(),
+    minuteOfDay: d.getUTCHours() * 60 + d.getUTCMinutes(),
+    sec: d.getUTCSeconds(),
+    yday: Math.floor((t - startOfYear) / DAY_S)
+  };
+}
+
+// 对应 ScheduleManager::computeNextFire
+function computeNextFire(job: Job, after: number): number {
+  const midnight = after - (after % DAY_S);
+  for (let d = 0; d <= 7; d++) {
+    const fire = midnight + d * DAY_S + job.hour * 3600 + job.minute * 60;
+    if (fire > after && (job.weekdays & (1 << local(fire).wday))) return fire;
+  }
+  return 0;
+}
+
+// 对应 ScheduleManager::isWindowActiveAt
+function isWindowActiveAt(w: Window, t: number): boolean {
+  const lt = local(t);
+  const today = lt.wday;
+  const yesterday = (today + 6) % 7;
+  if (w.startMinute === w.endMinute) return (w.weekdays & (1 << today)) !== 0;
+  if (w.startMinute < w.endMinute) {
+    return lt.minuteOfDay >= w.startMinute && lt.minuteOfDay < w.endMinute &&
+           (w.weekdays & (1 << today)) !== 0;
+  }
+  if (lt.minuteOfDay >= w.startMinute) return (w.weekdays & (1 << today)) !== 0;
+  if (lt.minuteOfDay < w.endMinute) return (w.weekdays & (1 << yesterday)) !== 0;
+  return false;
+}
+
+// 对应 ScheduleManager::nextMinuteOfDay
+function nextMinuteOfDay(now: number, minuteOfDay: number): number {
+  const lt = local(now);
+  let delta = (minuteOfDay - lt.minuteOfDay + 24 * 60) % (24 * 60);
+  if (delta === 0) delta = 24 * 60;
+  return now - lt.sec + delta * 60;
+}
+
+// 对应 ScheduleManager::getNextEventTime
+function getNextEventTime(now: number, jobs: Job[], windows: Window[]): number {
+  let next = nextMinuteOfDay(now, 0);
+  for (const job of jobs) {
+    if (job.nextFire !== 0 && job.nextFire < next) next = job.nextFire;
+  }
+  for (const w of windows) {
+    if (w.startMinute === w.endMinute) continue;
+    next = Math.min(next, nextMinuteOfDay(now, w.startMinute), nextMinuteOfDay(now, w.endMinute));
+  }
+  return next;
+}
+
+// 对应 ScheduleManager::checkJobs (单个任务)
+function checkJob(job: Job, now: number): void {
+  if (job.nextFire === 0) {
+    job.nextFire = computeNextFire(job, now);
+    return;
+  }
+  if (now < job.nextFire) return;
+  const stale = now - job.nextFire > CATCHUP_LIMIT_S;
+  job.nextFire = computeNextFire(job, now);
+  if (!stale) job.runs++;
+}
+
+const BASE = Date.UTC(2024, 0, 1) / 1000;
+
+type Spec = [number, number, number];
+
+const jobArb = fc.tuple(
+  fc.integer({ min: 0, max: 23 }),
+  fc.integer({ min: 0, max: 59 }),
+  fc.integer({ min: 1, max: EVERY_DAY })
+);
+
+const windowArb = fc.tuple(
+  fc.integer({ min: 0, max: 24 * 60 - 1 }),
+  fc.integer({ min: 0, max: 24 * 60 - 1 }),
+  fc.integer({ min: 1, max: EVERY_DAY })
+);
+
+function makeJob(spec: Spec): Job {
+  return new Job(spec[0], spec[1], spec[2]);
+}
+
+function makeWindow(spec: Spec): Window {
+  return new Window(spec[0], spec[1], spec[2]);
+}
+
+function countBits(mask: number): number {
+  let count = 0;
+  for (let i = 0; i < 7; i++) if (mask & (1 << i)) count++;
+  return count;
+}
+
+describe('日程调度器属性测试', () => {
+  describe('属性: 定时任务', () => {
+    test('Property: 下次执行时间是之后第一个匹配时刻和星期的时间', () => {
+      fc.assert(
+        fc.property(jobArb, fc.integer({ min: 0, max: 365 * DAY_S }), (spec, offset) => {
+          const job = makeJob(spec);
+          const after = BASE + offset;
+          const fire = computeNextFire(job, after);
+          const lt = local(fire);
+          if (fire <= after || fire - after > 7 * DAY_S) return false;
+          if (lt.minuteOfDay !== job.hour * 60 + job.minute || lt.sec !== 0) return false;
+          if (!(job.weekdays & (1 << lt.wday))) return false;
+          // 中间不存在更早的匹配时刻
+          for (let t = fire - DAY_S; t > after; t -= DAY_S) {
+            if (job.weekdays & (1 << local(t).wday)) return false;
+          }
+          return true;
+        }),
+        { numRuns: 200 }
+      );
+    });
+
+    test('Property: 连续运行时每个匹配日恰好执行一次', () => {
+      fc.assert(
+        fc.property(jobArb, fc.integer({ min: 0, max: 30 * DAY_S }), (spec, offset) => {
+          const job = makeJob(spec);
+          const start = BASE + offset;
+          const days = 14;
+          for (let t = start; t < start + days * DAY_S; t += 60) {
+            checkJob(job, t);
+          }
+          let expected = 0;
+          const firstMidnight = start - (start % DAY_S);
+          for (let d = 0; d <= days; d++) {
+            const fire = firstMidnight + d * DAY_S + job.hour * 3600 + job.minute * 60;
+            if (fire > start && fire < start + days * DAY_S - 60 &&
+                (job.weekdays & (1 << local(fire).wday))) expected++;
+          }
+          // 检查粒度为1分钟，窗口末尾一分钟内的执行可能尚未发生
+          return job.runs === expected || job.runs === expected + 1;
+        }),
+        { numRuns: 50 }
+      );
+    });
+
+    test('Property: 休眠错过的任务最多补执行一次，超过限定时长则跳过', () => {
+      fc.assert(
+        fc.property(jobArb, fc.integer({ min: 60, max: 3 * DAY_S }), (spec, sleepSeconds) => {
+          const job = makeJob(spec);
+          const start = BASE;
+          checkJob(job, start);
+          const scheduled = job.nextFire;
+          const wake = start + sleepSeconds;
+          checkJob(job, wake);
+          if (wake < scheduled) return job.runs === 0 && job.nextFire === scheduled;
+          const expectedRuns = wake - scheduled > CATCHUP_LIMIT_S ? 0 : 1;
+          return job.runs === expectedRuns && job.nextFire > wake;
+        }),
+        { numRuns: 200 }
+      );
+    });
+  });
+
+  describe('属性: 时段', () => {
+    test('Property: 每周进入时段的次数等于启用的天数', () => {
+      fc.assert(
+        fc.property(windowArb, (spec) => {
+          const w = makeWindow(spec);
+          if (w.startMinute === w.endMinute) return true;
+          let entries = 0;
+          let previous = isWindowActiveAt(w, BASE - 60);
+          for (let t = BASE; t < BASE + 7 * DAY_S; t += 60) {
+            const active = isWindowActiveAt(w, t);
+            if (active && !previous) {
+              entries++;
+              if (local(t).minuteOfDay !== w.startMinute) return false;
+            }
+            if (!active && previous && local(t).minuteOfDay !== w.endMinute) return false;
+            previous = active;
+          }
+          return entries === countBits(w.weekdays);
+        }),
+        { numRuns: 100 }
+      );
+    });
+
+    test('Property: 跨零点时段整段归属开始当天', () => {
+      fc.assert(
+        fc.property(
+          fc.integer({ min: 12 * 60, max: 24 * 60 - 1 }),
+          fc.integer({ min: 0, max: 12 * 60 - 1 }),
+          fc.integer({ min: 0, max: 6 }),
+          (start, end, day) => {
+            const w = new Window(start, end, 1 << day);
+            // 2024-01-07 为周日
+            const sunday = Date.UTC(2024, 0, 7) / 1000;
+            const startTime = sunday + day * DAY_S + start * 60;
+            const endTime = sunday + (day + 1) * DAY_S + end * 60;
+            return isWindowActiveAt(w, startTime) && isWindowActiveAt(w, endTime - 60) &&
+                   !isWindowActiveAt(w, endTime) && !isWindowActiveAt(w, startTime - 60);
+          }
+        ),
+        { numRuns: 100 }
+      );
+    });
+  });
+
+  describe('属性: 唤醒时间', () => {
+    test('Property: 按下一个日程事件唤醒不会错过任务、时段边界或跨天', () => {
+      fc.assert(
+        fc.property(
+          fc.array(jobArb, { minLength: 0, maxLength: 4 }),
+          fc.array(windowArb, { minLength: 0, maxLength: 3 }),
+          fc.integer({ min: 0, max: 60 * DAY_S }),
+          (jobSpecs, windowSpecs, offset) => {
+            const windows = windowSpecs.map(makeWindow);
+            const now = BASE + offset;
+            const jobs = jobSpecs.map(spec => {
+              const job = makeJob(spec);
+              job.nextFire = computeNextFire(job, now);
+              return job;
+            });
+            const wake = getNextEventTime(now, jobs, windows);
+            if (wake <= now || wake - now > DAY_S) return false;
+
+            // 唤醒前不发生任何事件
+            const day = local(now).yday;
+            for (let t = now - local(now).sec + 60; t < wake; t += 60) {
+              if (local(t).yday !== day) return false;
+              for (const job of jobs) if (job.nextFire <= t) return false;
+              for (const w of windows) {
+                if (isWindowActiveAt(w, t) !== isWindowActiveAt(w, now)) return false;
+              }
+            }
+            return true;
+          }
+        ),
+        { numRuns: 100 }
+      );
+    });
+  });
+});
@@ -0,0 +1,185 @@
+/**
+ * 信号滤波器属性测试
+ * 验证过采样数据块的工频陷波与抽取滤波的正确性属性
+ */
+
+import fc from 'fast-check';
+
+const SAMPLE_RATE = 1000;
+const BLOCK_SIZE = 256;
+const DECIMATION = 8;
+const FIR_TAPS = 32;
+const NOTCH_HARMONICS = 3;
+const NOTCH_Q = 8.0;
+
+// 模拟信号滤波器（对应固件中的SignalFilter标量路径）
+class MockSignalFilter {
+  private notchCoeffs: number[][] = [];
+  private notchState: number[][] = [];
+  private firCoeffs: number[] = [];
+  private history: number[] = new Array(FIR_TAPS - 1).fill(0);
+
+  constructor(private mainsFrequency: number = 50) {
+    for (let h = 1; h <= NOTCH_HARMONICS; h++) {
+      const frequency = mainsFrequency * h;
+      if (frequency >= SAMPLE_RATE * 0.45) break;
+      this.notchCoeffs.push(this.designNotch(frequency, NOTCH_Q));
+      this.notchState.push([0, 0]);
+    }
+    this.designLowPass((SAMPLE_RATE / (2 * DECIMATION)) * 0.8);
+  }
+
+  private designNotch(frequency: number, q: number): number[] {
+    const w0 = (2 * Math.PI * frequency) / SAMPLE_RATE;
+    const cosW0 = Math.cos(w0);
+    const alpha = Math.sin(w0) / (2 * q);
+    const a0 = 1 + alpha;
+    return [1 / a0, (-2 * cosW0) / a0, 1 / a0, (-2 * cosW0) / a0, (1 - alpha) / a0];
+  }
+
+  private designLowPass(cutoff: number): void {
+    const fc = cutoff / SAMPLE_RATE;
+    const center = (FIR_TAPS - 1) / 2;
+    let sum = 0;
+    for (let i = 0; i < FIR_TAPS; i++) {
+      const n = i - center;
+      const sinc = n === 0 ? 2 * fc : Math.sin(2 * Math.PI * fc * n) / (Math.PI * n);
+      const window = 0.54 - 0.46 * Math.cos((2 * Math.PI * i) / (FIR_TAPS - 1));
+      this.firCoeffs.push(sinc * window);
+      sum += sinc * window;
+    }
+    this.firCoeffs = this.firCoeffs.map(c => c / sum);
+  }
+
+  prime(value: number): void {
+    this.notchCoeffs.forEach((c, i) => {
+      const w = value / (1 + c[3] + c[4]);
+      this.notchState[i] = [w, w];
+    });
+    this.history = new Array(FIR_TAPS - 1).fill(value);
+  }
+
+  process(input: number[]): number[] {
+    const samples = [...input];
+    this.notchCoeffs.forEach((c, n) => {
+      const s = this.notchState[n];
+      for (let i = 0; i < samples.length; i++) {
+        const d0 = samples[i] - c[3] * s[0] - c[4] * s[1];
+        samples[i] = c[0] * d0 + c[1] * s[0] + c[2] * s[1];
+        s[1] = s[0];
+        s[0] = d0;
+      }
+    });
+
+    const work = [...this.history, ...samples];
+    const output: number[] = [];
+    const outputCount = Math.floor(samples.length / DECIMATION);
+    for (let k = 0; k < outputCount; k++) {
+      const start = (k + 1) * DECIMATION - 1;
+      let acc = 0;
+      for (let j = 0; j < FIR_TAPS; j++) {
+        acc += work[start + j] * this.firCoeffs[j];
+      }
+      output.push(acc);
+    }
+    this.history = work.slice(work.length - (FIR_TAPS - 1));
+    return output;
+  }
+
+  filterBlock(input: number[]): number {
+    const mean = input.reduce((a, b) => a + b, 0) / input.length;
+    this.prime(mean);
+    const output = this.process(input);
+    return output.reduce((a, b) => a + b, 0) / output.length;
+  }
+}
+
+// 生成含工频干扰的ADC数据块
+function generateBlock(dc: number, amplitude: number, phase: number, mains: number, offset = 0): number[] {
+  const block: number[] = [];
+  for (let i = 0; i < BLOCK_SIZE; i++) {
+    const t = (offset + i) / SAMPLE_RATE;
+    block.push(
+      dc +
+      amplitude * Math.sin(2 * Math.PI * mains * t + phase) +
+      amplitude * 0.4 * Math.sin(4 * Math.PI * mains * t + 2 * phase)
+    );
+  }
+  return block;
+}
+
+describe('信号滤波器属性测试', () => {
+  describe('属性: 直流增益', () => {
+    test('Property: 恒定输入经滤波后保持不变', () => {
+      fc.assert(
+        fc.property(
+          fc.float({ min: 0, max: 4095, noNaN: true }),
+          (dc) => {
+            const filter = new MockSignalFilter(50);
+            const result = filter.filterBlock(new Array(BLOCK_SIZE).fill(dc));
+            return Math.abs(result - dc) < 0.01 + dc * 1e-6;
+          }
+        ),
+        { numRuns: 100 }
+      );
+    });
+  });
+
+  describe('属性: 工频干扰抑制', () => {
+    test('Property: 单次测量的工频残差远小于干扰幅度', () => {
+      fc.assert(
+        fc.property(
+          fc.float({ min: 500, max: 3500, noNaN: true }),
+          fc.float({ min: 10, max: 400, noNaN: true }),
+          fc.float({ min: 0, max: Math.fround(2 * Math.PI), noNaN: true }),
+          fc.constantFrom(50, 60),
+          (dc, amplitude, phase, mains) => {
+            const filter = new MockSignalFilter(mains);
+            const result = filter.filterBlock(generateBlock(dc, amplitude, phase, mains));
+            return Math.abs(result - dc) < amplitude * 0.05;
+          }
+        ),
+        { numRuns: 100 }
+      );
+    });
+
+    test('Property: 连续数据块的稳态输出纹波被消除', () => {
+      fc.assert(
+        fc.property(
+          fc.float({ min: 500, max: 3500, noNaN: true }),
+          fc.float({ min: 10, max: 400, noNaN: true }),
+          fc.constantFrom(50, 60),
+          (dc, amplitude, mains) => {
+            const filter = new MockSignalFilter(mains);
+            filter.prime(dc);
+            let maxDeviation = 0;
+            for (let block = 0; block < 6; block++) {
+              const output = filter.process(generateBlock(dc, amplitude, 0, mains, block * BLOCK_SIZE));
+              if (block >= 3) {
+                output.forEach(v => { maxDeviation = Math.max(maxDeviation, Math.abs(v - dc)); });
+              }
+            }
+            return maxDeviation < amplitude * 0.02;
+          }
+        ),
+        { numRuns: 50 }
+      );
+    });
+  });
+
+  describe('属性: 抽取', () => {
+    test('Property: 输出样本数等于输入样本数除以抽取因子', () => {
+      fc.assert(
+        fc.property(
+          fc.array(fc.float({ min: 0, max: 4095, noNaN: true }), { minLength: 1, maxLength: BLOCK_SIZE }),
+          (samples) => {
+            const filter = new MockSignalFilter(50);
+            const output = filter.process(samples);
+            return output.length === Math.floor(samples.length / DECIMATION);
+          }
+        ),
+        { numRuns: 100 }
+      );
+    });
+  });
+});
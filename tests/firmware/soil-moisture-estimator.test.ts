@@ -0,0 +1,309 @@
+/**
+ * 土壤湿度温度补偿属性测试
+ * 验证温度系数的学习、补偿后误差、误报缺水的减少、浇水阶跃的跟随以及数值稳定性
+ */
+
+import fc from 'fast-check';
+
+const REFERENCE_TEMP = 20;
+const TEMP_TAU_HOURS = 2;
+const MEASUREMENT_VAR = 1.0;
+const MOISTURE_VAR = 0.02;
+const RATE_VAR = 0.002;
+const COEFF_VAR = 0.000001;
+const INITIAL_COEFF_VAR = 0.25;
+const INITIAL_RATE_VAR = 0.25;
+const COEFF_LIMIT = 2;
+const GATE_SIGMA = 4;
+const MAX_GAP_HOURS = 6;
+const MOISTURE_THRESHOLD = 30;
+const SAMPLE_INTERVAL_MS = 300000;
+
+type Random = () => number;
+
+function seededRandom(seed: number): Random {
+  let s = seed >>> 0;
+  return () => {
+    s = (s * 1664525 + 1013904223) >>> 0;
+    return s / 0x100000000;
+  };
+}
+
+function gaussian(random: Random): number {
+  const u = Math.max(random(), 1e-9);
+  return Math.sqrt(-2 * Math.log(u)) * Math.cos(2 * Math.PI * random());
+}
+
+const clamp = (v: number, lo: number, hi: number) => Math.min(hi, Math.max(lo, v));
+
+// 模拟土壤湿度估计器（对应固件中的SoilMoistureEstimator逻辑）
+class MockSoilMoistureEstimator {
+  moisture = 0;
+  rate = 0;
+  coefficient = 0;
+  p00 = 0; p01 = 0; p02 = 0;
+  p11 = 0; p12 = 0;
+  p22 = INITIAL_COEFF_VAR;
+  soilTemperature = NaN;
+  initialized = false;
+  lastUpdate = 0;
+  steps = 0;
+
+  private reinitialize(reading: number, offset: number): void {
+    this.moisture = reading - this.coefficient * offset;
+    this.rate = 0;
+    this.p00 = MEASUREMENT_VAR + this.p22 * offset * offset;
+    this.p01 = 0;
+    this.p02 = -this.p22 * offset;
+    this.p11 = INITIAL_RATE_VAR;
+    this.p12 = 0;
+    this.initialized = true;
+  }
+
+  update(reading: number, airTemperature: number, timestamp: number): number {
+    if (Number.isNaN(reading)) return this.moisture;
+
+    const dt = this.initialized ? (timestamp - this.lastUpdate) / 3600000 : 0;
+    this.lastUpdate = timestamp;
+
+    const restart = !this.initialized || dt > MAX_GAP_HOURS;
+    if (!Number.isNaN(airTemperature)) {
+      if (Number.isNaN(this.soilTemperature) || restart) this.soilTemperature = airTemperature;
+      else this.soilTemperature += (airTemperature - this.soilTemperature) * dt / (TEMP_TAU_HOURS + dt);
+    }
+    const offset = Number.isNaN(this.soilTemperature) ? 0 : this.soilTemperature - REFERENCE_TEMP;
+
+    if (restart) {
+      this.reinitialize(reading, offset);
+      return clamp(this.moisture, 0, 100);
+    }
+
+    this.moisture += this.rate * dt;
+    this.p00 += dt * (2 * this.p01 + dt * this.p11) + MOISTURE_VAR * dt;
+    this.p01 += dt * this.p11;
+    this.p02 += dt * this.p12;
+    this.p11 += RATE_VAR * dt;
+    this.p22 += COEFF_VAR * dt;
+
+    const innovation = reading - (this.moisture + this.coefficient * offset);
+    let a0 = this.p00 + this.p02 * offset;
+    let a1 = this.p01 + this.p12 * offset;
+    let a2 = this.p02 + this.p22 * offset;
+    let s = a0 + a2 * offset + MEASUREMENT_VAR;
+
+    if (innovation * innovation > GATE_SIGMA * GATE_SIGMA * s) {
+      this.steps++;
+      this.p00 += innovation * innovation;
+      this.p01 = 0;
+      this.rate = 0;
+      this.p11 = INITIAL_RATE_VAR;
+      this.p12 = 0;
+      a0 = this.p00 + this.p02 * offset;
+      a1 = 0;
+      a2 = this.p02 + this.p22 * offset;
+      s = a0 + a2 * offset + MEASUREMENT_VAR;
+    }
+
+    const k0 = a0 / s;
+    const k1 = a1 / s;
+    const k2 = a2 / s;
+    this.moisture += k0 * innovation;
+    this.rate += k1 * innovation;
+    this.coefficient += k2 * innovation;
+    this.p00 -= k0 * a0;
+    this.p01 -= k0 * a1;
+    this.p02 -= k0 * a2;
+    this.p11 -= k1 * a1;
+    this.p12 -= k1 * a2;
+    this.p22 -= k2 * a2;
+
+    this.coefficient = clamp(this.coefficient, -COEFF_LIMIT, COEFF_LIMIT);
+    this.moisture = clamp(this.moisture, -20, 120);
+    this.p00 = Math.max(this.p00, 1e-6);
+    this.p11 = Math.max(this.p11, 1e-9);
+    this.p22 = Math.max(this.p22, 1e-9);
+
+    return clamp(this.moisture, 0, 100);
+  }
+}
+
+interface Sample {
+  time: number;
+  trueMoisture: number;
+  airTemperature: number;
+  reading: number;
+}
+
+// 盆栽模拟：白天蒸发快、夜里慢；低于30%一段时间后浇水；土温为气温的一阶滞后，读数随土温漂移
+function simulatePot(days: number, coefficient: number, dryingPerHour: number, swing: number, random: Random): Sample[] {
+  const samples: Sample[] = [];
+  let moisture = 55 + random() * 10;
+  let soilTemperature = 22;
+  const dtHours = SAMPLE_INTERVAL_MS / 3600000;
+  for (let i = 0; i < days * 288; i++) {
+    const hour = i * dtHours;
+    const diurnal = Math.sin(2 * Math.PI * (hour - 9) / 24);
+    const airTemperature = 22 + swing * diurnal + gaussian(random) * 0.3;
+    soilTemperature += (airTemperature - soilTemperature) * dtHours / (TEMP_TAU_HOURS + dtHours);
+    moisture -= dryingPerHour * dtHours * (1 + 0.5 * diurnal);
+    if (moisture < 25) moisture = 60 + random() * 10;
+    const reading = moisture + coefficient * (soilTemperature - REFERENCE_TEMP) + gaussian(random);
+    samples.push({ time: i * SAMPLE_INTERVAL_MS, trueMoisture: moisture, airTemperature, reading });
+  }
+  return samples;
+}
+
+// 带2%回差的缺水判定进入次数
+function countDryEntries(values: number[]): number {
+  let dry = false;
+  let entries = 0;
+  for (const v of values) {
+    if (!dry && v < MOISTURE_THRESHOLD) {
+      dry = true;
+      entries++;
+    } else if (dry && v > MOISTURE_THRESHOLD + 2) {
+      dry = false;
+    }
+  }
+  return entries;
+}
+
+const potArbitrary = fc.record({
+  coefficient: fc.float({ min: Math.fround(-1.5), max: Math.fround(1.5), noNaN: true }),
+  drying: fc.float({ min: Math.fround(0.1), max: Math.fround(0.4), noNaN: true }),
+  swing: fc.float({ min: Math.fround(4), max: Math.fround(10), noNaN: true }),
+  seed: fc.integer({ min: 1, max: 0x7fffffff })
+});
+
+describe('土壤湿度温度补偿属性测试', () => {
+  describe('属性: 学习温度系数', () => {
+    test('Property: 一周的昼夜温差后温度系数误差不超过0.2 %/°C', () => {
+      fc.assert(
+        fc.property(potArbitrary, ({ coefficient, drying, swing, seed }) => {
+          const estimator = new MockSoilMoistureEstimator();
+          simulatePot(7, coefficient, drying, swing, seededRandom(seed))
+            .forEach(s => estimator.update(s.reading, s.airTemperature, s.time));
+          return Math.abs(estimator.coefficient - coefficient) <= 0.2;
+        }),
+        { numRuns: 40 }
+      );
+    });
+
+    test('Property: 学习到的系数在重启后沿用，补偿立即生效', () => {
+      fc.assert(
+        fc.property(potArbitrary, ({ coefficient, drying, swing, seed }) => {
+          const random = seededRandom(seed);
+          const first = new MockSoilMoistureEstimator();
+          simulatePot(7, coefficient, drying, swing, random)
+            .forEach(s => first.update(s.reading, s.airTemperature, s.time));
+
+          // 对应固件从NVS加载温度系数及其方差
+          const restarted = new MockSoilMoistureEstimator();
+          restarted.coefficient = first.coefficient;
+          restarted.p22 = first.p22;
+          const day = simulatePot(1, coefficient, drying, swing, random).slice(24);
+          let error = 0;
+          let rawError = 0;
+          day.forEach(s => {
+            error += (restarted.update(s.reading, s.airTemperature, s.time) - s.trueMoisture) ** 2;
+            rawError += (s.reading - s.trueMoisture) ** 2;
+          });
+          return Math.sqrt(error / day.length) <= Math.max(1.2, Math.sqrt(rawError / day.length) * 0.5);
+        }),
+        { numRuns: 30 }
+      );
+    });
+  });
+
+  describe('属性: 补偿效果', () => {
+    test('Property: 首日之后补偿误差 (RMS) 不超过1%，且明显小于原始读数', () => {
+      fc.assert(
+        fc.property(potArbitrary, ({ coefficient, drying, swing, seed }) => {
+          const estimator = new MockSoilMoistureEstimator();
+          let error = 0;
+          let rawError = 0;
+          let n = 0;
+          simulatePot(7, coefficient, drying, swing, seededRandom(seed)).forEach((s, i) => {
+            const estimate = estimator.update(s.reading, s.airTemperature, s.time);
+            if (i >= 288) {
+              error += (estimate - s.trueMoisture) ** 2;
+              rawError += (s.reading - s.trueMoisture) ** 2;
+              n++;
+            }
+          });
+          return Math.sqrt(error / n) <= 1.0 && error < rawError * 0.6;
+        }),
+        { numRuns: 40 }
+      );
+    });
+
+    test('Property: 补偿后进入缺水状态的次数不多于原始读数，且接近真实次数', () => {
+      fc.assert(
+        fc.property(potArbitrary, ({ coefficient, drying, swing, seed }) => {
+          const estimator = new MockSoilMoistureEstimator();
+          const samples = simulatePot(10, coefficient, drying, swing, seededRandom(seed));
+          const estimates = samples.map(s => estimator.update(s.reading, s.airTemperature, s.time));
+          const raw = countDryEntries(samples.map(s => s.reading));
+          const compensated = countDryEntries(estimates);
+          const truth = countDryEntries(samples.map(s => s.trueMoisture));
+          return compensated <= raw && compensated <= truth + 2;
+        }),
+        { numRuns: 40 }
+      );
+    });
+  });
+
+  describe('属性: 阶跃与稳定性', () => {
+    test('Property: 浇水引起的湿度阶跃在3个样本内跟上', () => {
+      fc.assert(
+        fc.property(
+          fc.float({ min: Math.fround(15), max: Math.fround(50), noNaN: true }),
+          fc.integer({ min: 1, max: 0x7fffffff }),
+          (jump, seed) => {
+            const random = seededRandom(seed);
+            const estimator = new MockSoilMoistureEstimator();
+            let t = 0;
+            for (let i = 0; i < 288; i++, t += SAMPLE_INTERVAL_MS) {
+              estimator.update(40 - i * 0.02 + gaussian(random) * 0.5, 22, t);
+            }
+            const target = 40 - 288 * 0.02 + jump;
+            let estimate = 0;
+            for (let i = 0; i < 3; i++, t += SAMPLE_INTERVAL_MS) {
+              estimate = estimator.update(target + gaussian(random) * 0.5, 22, t);
+            }
+            return Math.abs(estimate - target) <= 3 && estimator.steps >= 1;
+          }
+        ),
+        { numRuns: 50 }
+      );
+    });
+
+    test('Property: 任意读数、温度缺失和采样间隔下状态有限、方差为正', () => {
+      fc.assert(
+        fc.property(
+          fc.array(
+            fc.tuple(
+              fc.float({ min: 0, max: 100, noNaN: true }),
+              fc.option(fc.float({ min: -10, max: 50, noNaN: true })),
+              fc.integer({ min: 0, max: 12 * 3600000 })
+            ),
+            { minLength: 1, maxLength: 500 }
+          ),
+          (steps) => {
+            const estimator = new MockSoilMoistureEstimator();
+            let t = 0;
+            for (const [reading, temperature, gap] of steps) {
+              t += gap;
+              const estimate = estimator.update(reading, temperature === null ? NaN : temperature, t);
+              if (!Number.isFinite(estimate) || estimate < 0 || estimate > 100) return false;
+              if (!(estimator.p00 > 0 && estimator.p11 > 0 && estimator.p22 > 0)) return false;
+              if (Math.abs(estimator.coefficient) > COEFF_LIMIT) return false;
+            }
+            return true;
+          }
+        ),
+        { numRuns: 100 }
+      );
+    });
+  });
+});
@@ -0,0 +1,288 @@
+/**
+ * 层次状态机属性测试
+ * 验证展开后的查找表与逐级向上查找一致、条件都不成立时交给父状态、
+ * 进入/退出动作成对执行以及空闲时不派发事件
+ */
+
+import fc from 'fast-check';
+
+const NO_TRANSITION = 0xff;
+
+class Transition {
+  constructor(
+    public from: number,
+    public event: number,
+    public to: number,
+    public internal: boolean,
+    public guard: boolean = true   // 条件的求值结果
+  ) {}
+}
+
+// 对应 makeHsmTable：每个状态每个事件的首个转换 (含从父状态继承的)
+function buildLookup(parents: number[], transitions: Transition[], eventCount: number): number[][] {
+  const lookup: number[][] = [];
+  for (let s = 0; s < parents.length; s++) {
+    const row: number[] = [];
+    for (let e = 0; e < eventCount; e++) {
+      let found = NO_TRANSITION;
+      let current = s;
+      for (let depth = 0; depth < parents.length && found === NO_TRANSITION; depth++) {
+        const t = transitions.findIndex(tr => tr.from === current && tr.event === e);
+        if (t >= 0) found = t;
+        if (parents[current] === current) break;
+        current = parents[current];
+      }
+      row.push(found);
+    }
+    lookup.push(row);
+  }
+  return lookup;
+}
+
+// 模拟状态机（对应固件中的StateMachine逻辑）
+class MockStateMachine {
+  current: number;
+  active: Set<number> = new Set();
+  log: string[] = [];
+  timerArmed = false;
+  timerDeadline = 0;
+  dispatched = 0;
+  fired = NO_TRANSITION;
+  private lookup: number[][];
+
+  constructor(public parents: number[], public transitions: Transition[], eventCount: number, initial: number) {
+    this.lookup = buildLookup(parents, transitions, eventCount);
+    this.current = initial;
+    const path: number[] = [];
+    for (let s = initial; ; s = parents[s]) {
+      path.push(s);
+      if (parents[s] === s) break;
+    }
+    while (path.length > 0) this.enter(path.pop() as number);
+  }
+
+  dispatch(event: number): boolean {
+    this.dispatched++;
+    let index = this.lookup[this.current][event];
+    while (index !== NO_TRANSITION) {
+      // 相邻的同源同事件转换按顺序检查条件
+      const from = this.transitions[index].from;
+      for (; index < this.transitions.length &&
+             this.transitions[index].from === from && this.transitions[index].event === event; index++) {
+        const transition = this.transitions[index];
+        if (transition.guard) {
+          this.fired = index;
+          if (!transition.internal) this.transitionTo(transition.to);
+          return true;
+        }
+      }
+      // 条件都不成立，交给父状态
+      if (this.parents[from] === from) break;
+      index = this.lookup[this.parents[from]][event];
+    }
+    return false;
+  }
+
+  poll(now: number, timeoutEvent: number): boolean {
+    if (!this.timerArmed || now < this.timerDeadline) return false;
+    this.timerArmed = false;
+    return this.dispatch(timeoutEvent);
+  }
+
+  private depthOf(state: number): number {
+    let depth = 0;
+    while (this.parents[state] !== state) {
+      state = this.parents[state];
+      depth++;
+    }
+    return depth;
+  }
+
+  private transitionTo(target: number): void {
+    const parents = this.parents;
+    const none = parents.length;
+    let a = this.current;
+    let b = target;
+    let depthA = this.depthOf(a);
+    let depthB = this.depthOf(b);
+    while (depthA > depthB) { a = parents[a]; depthA--; }
+    while (depthB > depthA) { b = parents[b]; depthB--; }
+    while (a !== b && parents[a] !== a) { a = parents[a]; b = parents[b]; }
+    let lca = a === b ? a : none;
+    if (lca === target) lca = parents[target] === target ? none : parents[target];
+
+    this.timerArmed = false;
+    for (let s = this.current; s !== lca; s = parents[s]) {
+      this.exit(s);
+      if (parents[s] === s) break;
+    }
+    const path: number[] = [];
+    for (let s = target; s !== lca; s = parents[s]) {
+      path.push(s);
+      if (parents[s] === s) break;
+    }
+    this.current = target;
+    while (path.length > 0) this.enter(path.pop() as number);
+  }
+
+  private enter(state: number): void {
+    this.log.push('+' + state);
+    this.active.add(state);
+  }
+
+  private exit(state: number): void {
+    this.log.push('-' + state);
+    this.active.delete(state);
+  }
+}
+
+// 随机生成一棵状态树：每个状态的父状态编号小于自身，0号及部分状态为顶层
+const treeArb = fc.array(fc.integer({ min: 0, max: 100 }), { minLength: 2, maxLength: 10 })
+  .map(seeds => seeds.map((seed, i) => (i === 0 || seed % 4 === 0 ? i : seed % i)));
+
+function ancestors(parents: number[], state: number): number[] {
+  const result = [state];
+  while (parents[state] !== state) {
+    state = parents[state];
+    result.push(state);
+  }
+  return result;
+}
+
+describe('层次状态机属性测试', () => {
+  test('Property: 查找表结果与逐级向上查找的首个转换一致', () => {
+    fc.assert(
+      fc.property(
+        treeArb,
+        fc.array(fc.tuple(fc.integer({ min: 0, max: 9 }), fc.integer({ min: 0, max: 3 }), fc.integer({ min: 0, max: 9 })),
+                 { minLength: 0, maxLength: 20 }),
+        (parents, raw) => {
+          const n = parents.length;
+          const transitions = raw.map(r => new Transition(r[0] % n, r[1], r[2] % n, false));
+          const lookup = buildLookup(parents, transitions, 4);
+          for (let s = 0; s < n; s++) {
+            for (let e = 0; e < 4; e++) {
+              let expected = NO_TRANSITION;
+              for (const state of ancestors(parents, s)) {
+                const t = transitions.findIndex(tr => tr.from === state && tr.event === e);
+                if (t >= 0) { expected = t; break; }
+              }
+              if (lookup[s][e] !== expected) return false;
+            }
+          }
+          return true;
+        }
+      ),
+      { numRuns: 200 }
+    );
+  });
+
+  test('Property: 任意事件序列后，已进入未退出的状态恰好是当前状态及其祖先', () => {
+    fc.assert(
+      fc.property(
+        treeArb,
+        fc.array(fc.tuple(fc.integer({ min: 0, max: 9 }), fc.integer({ min: 0, max: 3 }), fc.integer({ min: 0, max: 9 }),
+                          fc.boolean()),
+                 { minLength: 1, maxLength: 20 }),
+        fc.array(fc.integer({ min: 0, max: 3 }), { minLength: 0, maxLength: 50 }),
+        (parents, raw, events) => {
+          const n = parents.length;
+          const transitions = raw.map(r => new Transition(r[0] % n, r[1], r[2] % n, r[3]));
+          const machine = new MockStateMachine(parents, transitions, 4, n - 1);
+          for (const event of events) {
+            machine.dispatch(event);
+            const expected = ancestors(parents, machine.current);
+            if (machine.active.size !== expected.length) return false;
+            if (!expected.every(s => machine.active.has(s))) return false;
+          }
+          return true;
+        }
+      ),
+      { numRuns: 200 }
+    );
+  });
+
+  test('Property: 自转换会退出并重新进入源状态，但不影响公共父状态', () => {
+    fc.assert(
+      fc.property(treeArb, (parents) => {
+        const n = parents.length;
+        const leaf = n - 1;
+        const machine = new MockStateMachine(parents, [new Transition(leaf, 0, leaf, false)], 1, leaf);
+        machine.log = [];
+        machine.dispatch(0);
+        return machine.log.length === 2 && machine.log[0] === '-' + leaf && machine.log[1] === '+' + leaf;
+      }),
+      { numRuns: 100 }
+    );
+  });
+
+  test('Property: 未设定定时器时轮询从不派发事件', () => {
+    fc.assert(
+      fc.property(
+        treeArb,
+        fc.array(fc.integer({ min: 0, max: 10000000 }), { minLength: 1, maxLength: 100 }),
+        (parents, times) => {
+          const n = parents.length;
+          const machine = new MockStateMachine(parents, [new Transition(n - 1, 0, 0, false)], 1, n - 1);
+          const sorted = times.slice().sort((x, y) => x - y);
+          for (const now of sorted) {
+            if (machine.poll(now, 0)) return false;
+          }
+          return machine.dispatched === 0 && machine.current === n - 1;
+        }
+      ),
+      { numRuns: 100 }
+    );
+  });
+
+  test('Property: 条件转换都不成立时，由最近的祖先状态中首个条件成立的转换处理', () => {
+    fc.assert(
+      fc.property(
+        treeArb,
+        fc.array(fc.tuple(fc.integer({ min: 0, max: 9 }), fc.integer({ min: 0, max: 3 }), fc.integer({ min: 0, max: 9 }),
+                          fc.boolean(), fc.boolean()),
+                 { minLength: 1, maxLength: 20 }),
+        fc.array(fc.integer({ min: 0, max: 3 }), { minLength: 1, maxLength: 30 }),
+        (parents, raw, events) => {
+          const n = parents.length;
+          // 同源同事件的转换相邻排列 (与固件表的约定一致)
+          const transitions = raw
+            .map(r => new Transition(r[0] % n, r[1], r[2] % n, r[3], r[4]))
+            .sort((x, y) => x.from - y.from || x.event - y.event);
+          const machine = new MockStateMachine(parents, transitions, 4, n - 1);
+          for (const event of events) {
+            let expected = NO_TRANSITION;
+            for (const state of ancestors(parents, machine.current)) {
+              const t = transitions.findIndex(tr => tr.from === state && tr.event === event && tr.guard);
+              if (t >= 0) { expected = t; break; }
+            }
+            machine.fired = NO_TRANSITION;
+            const handled = machine.dispatch(event);
+            if (handled !== (expected !== NO_TRANSITION) || machine.fired !== expected) return false;
+          }
+          return true;
+        }
+      ),
+      { numRuns: 200 }
+    );
+  });
+
+  test('子状态的条件转换都不成立时执行父状态的转换', () => {
+    // 0: 顶层  1: 0的子状态  2: 1的子状态
+    const parents = [0, 0, 1];
+    const transitions = [
+      new Transition(2, 0, 2, true, false),
+      new Transition(2, 0, 1, false, false),
+      new Transition(1, 0, 0, false, true)
+    ];
+    const machine = new MockStateMachine(parents, transitions, 1, 2);
+    expect(machine.dispatch(0)).toBe(true);
+    expect(machine.fired).toBe(2);
+    expect(machine.current).toBe(0);
+
+    // 祖先中也没有条件成立的转换时不处理
+    const blocked = new MockStateMachine(parents, [new Transition(2, 0, 1, false, false)], 1, 2);
+    expect(blocked.dispatch(0)).toBe(false);
+    expect(blocked.current).toBe(2);
+  });
+});
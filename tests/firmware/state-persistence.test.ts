@@ -863,4 +863,160 @@ describe('状态持久化测试', () => {
       expect(recoveredStatus.needsAttention).toBe(true);
     });
   });
-});
\ No newline at end of file
+});
+// 模拟逐字节写入的EEPROM（对应固件中StatePersistence的A/B双副本布局）
+// 每个副本: [值(4字节), 序号(4字节), 校验和(4字节)]，头部一个字节为活动副本位图
+const AB_SLOT_SIZE = 12;
+const AB_RECORD_COUNT = 3;
+const AB_HEADER_ADDR = 0;
+const AB_DATA_ADDR = 1;
+
+class MockAbStore {
+  flash: number[] = new Array(AB_DATA_ADDR + AB_RECORD_COUNT * 2 * AB_SLOT_SIZE).fill(0);
+  writes = 0;
+  cut = -1;
+
+  write(address: number, value: number): void {
+    if (this.cut < 0 || this.writes < this.cut) this.flash[address] = value & 0xff;
+    this.writes++;
+  }
+}
+
+function abChecksum(bytes: number[]): number {
+  let checksum = 0;
+  for (const b of bytes) {
+    checksum = (checksum + b) >>> 0;
+    checksum = ((checksum << 1) | (checksum >>> 31)) >>> 0;
+  }
+  return checksum;
+}
+
+function toBytes(value: number): number[] {
+  return [value & 0xff, (value >>> 8) & 0xff, (value >>> 16) & 0xff, (value >>> 24) & 0xff];
+}
+
+function fromBytes(bytes: number[]): number {
+  return (bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (bytes[3] << 24)) >>> 0;
+}
+
+class MockAbPersistence {
+  activeMask = 0;
+  sequence = 0;
+
+  constructor(public store: MockAbStore) {}
+
+  private address(record: number, copy: number): number {
+    return AB_DATA_ADDR + (record * 2 + copy) * AB_SLOT_SIZE;
+  }
+
+  private readCopy(record: number, copy: number): number[] | null {
+    const base = this.address(record, copy);
+    const bytes = this.store.flash.slice(base, base + AB_SLOT_SIZE);
+    const sequence = fromBytes(bytes.slice(4, 8));
+    if (sequence === 0 || abChecksum(bytes.slice(0, 8)) !== fromBytes(bytes.slice(8, 12))) return null;
+    return [fromBytes(bytes.slice(0, 4)), sequence];
+  }
+
+  // 一次扫描选出活动副本
+  boot(): void {
+    const stored = this.store.flash[AB_HEADER_ADDR];
+    this.activeMask = 0;
+    this.sequence = 0;
+    for (let r = 0; r < AB_RECORD_COUNT; r++) {
+      const preferred = (stored >> r) & 1;
+      const copies = [this.readCopy(r, 0), this.readCopy(r, 1)];
+      const chosen = copies[preferred] !== null || copies[preferred ^ 1] === null ? preferred : preferred ^ 1;
+      this.activeMask |= chosen << r;
+      for (const c of copies) if (c !== null) this.sequence = Math.max(this.sequence, c[1]);
+    }
+  }
+
+  // 写入非活动副本，最后切换位图
+  save(values: number[]): void {
+    let mask = 0;
+    for (let r = 0; r < values.length; r++) {
+      const sequence = ++this.sequence;
+      const body = toBytes(values[r]).concat(toBytes(sequence));
+      const bytes = body.concat(toBytes(abChecksum(body)));
+      const base = this.address(r, ((this.activeMask >> r) & 1) ^ 1);
+      bytes.forEach((b, i) => this.store.write(base + i, b));
+      mask |= 1 << r;
+    }
+    this.activeMask ^= mask;
+    this.store.write(AB_HEADER_ADDR, this.activeMask);
+  }
+
+  load(): number[] | null {
+    const values: number[] = [];
+    for (let r = 0; r < AB_RECORD_COUNT; r++) {
+      const copy = this.readCopy(r, (this.activeMask >> r) & 1);
+      if (copy === null) return null;
+      values.push(copy[0]);
+    }
+    return values;
+  }
+}
+
+describe('A/B双副本持久化属性测试', () => {
+  const valuesArb = fc.tuple(fc.integer({ min: 0, max: 0x7fffffff }), fc.integer({ min: 0, max: 0x7fffffff }),
+                             fc.integer({ min: 0, max: 0x7fffffff }));
+
+  test('Property: 保存过程中任意位置断电，重启后得到完整的旧数据或完整的新数据', () => {
+    fc.assert(
+      fc.property(
+        fc.array(valuesArb, { minLength: 1, maxLength: 5 }),
+        valuesArb,
+        fc.integer({ min: 0, max: AB_RECORD_COUNT * AB_SLOT_SIZE + 1 }),
+        (history, next, cut) => {
+          const store = new MockAbStore();
+          const persistence = new MockAbPersistence(store);
+          persistence.boot();
+          for (const values of history) persistence.save(values);
+          const previous = history[history.length - 1];
+
+          store.writes = 0;
+          store.cut = cut;
+          persistence.save(next);
+          store.cut = -1;
+
+          const rebooted = new MockAbPersistence(store);
+          rebooted.boot();
+          const loaded = rebooted.load();
+          if (loaded === null) return false;
+          const same = (a: number[], b: number[]) => a.every((v, i) => v === b[i]);
+          return same(loaded, previous) || same(loaded, next);
+        }
+      ),
+      { numRuns: 200 }
+    );
+  });
+
+  test('Property: 活动副本损坏时重启退回上一次保存的数据', () => {
+    fc.assert(
+      fc.property(
+        valuesArb,
+        valuesArb,
+        fc.integer({ min: 0, max: AB_RECORD_COUNT - 1 }),
+        fc.integer({ min: 0, max: AB_SLOT_SIZE - 1 }),
+        (first, second, record, offset) => {
+          const store = new MockAbStore();
+          const persistence = new MockAbPersistence(store);
+          persistence.boot();
+          persistence.save(first);
+          persistence.save(second);
+
+          const copy = (persistence.activeMask >> record) & 1;
+          const address = AB_DATA_ADDR + (record * 2 + copy) * AB_SLOT_SIZE + offset;
+          store.flash[address] ^= 0x5a;
+
+          const rebooted = new MockAbPersistence(store);
+          rebooted.boot();
+          const loaded = rebooted.load();
+          if (loaded === null) return false;
+          return loaded.every((v, i) => v === (i === record ? first[i] : second[i]));
+        }
+      ),
+      { numRuns: 200 }
+    );
+  });
+});
@@ -0,0 +1,348 @@
+/**
+ * 触摸到灯光延迟跟踪属性测试
+ * 在模拟主循环中驱动触摸传感器、交互响应和灯带刷新，验证直方图与SLO统计、
+ * 各环节耗时之和与真实端到端延迟的一致性，以及主要耗时环节的识别
+ */
+
+import fc from 'fast-check';
+
+const BUCKET_LIMITS_MS = [10, 20, 30, 40, 50, 75, 100, 150, 200, 300, 500, 1000];
+const BUCKET_COUNT = BUCKET_LIMITS_MS.length + 1;
+const SLO_MS = 100;
+const TIMEOUT_MS = 1000;
+const HOPS = ['poll', 'filter', 'dispatch', 'frame'];
+const POLL = 0;
+const FILTER = 1;
+const DISPATCH = 2;
+const FRAME = 3;
+
+const TOUCH_THRESHOLD = 1650;
+const RELEASE_THRESHOLD = 1480;
+const DEBOUNCE_MS = 50;
+const HOLD_MS = 1000;
+const FILTER_ALPHA = 8;
+const FRAME_INTERVAL_MS = 20;
+
+type Random = () => number;
+type TapHandler = (nowUs: number) => void;
+
+function seededRandom(seed: number): Random {
+  let s = seed >>> 0;
+  return () => {
+    s = (s * 1664525 + 1013904223) >>> 0;
+    return s / 0x100000000;
+  };
+}
+
+interface CompletedTrace {
+  hops: number[];
+  totalUs: number;
+  frameUs: number;
+}
+
+// 模拟延迟跟踪器（对应固件中的TouchLatencyTracer逻辑，时间由调用方传入）
+class MockTouchLatencyTracer {
+  stage: 'idle' | 'detected' | 'responded' = 'idle';
+  hopUs = [0, 0, 0, 0];
+  detectedUs = 0;
+  respondedUs = 0;
+  buckets = new Array(BUCKET_COUNT).fill(0);
+  traceCount = 0;
+  withinSloCount = 0;
+  droppedCount = 0;
+  maxTotalUs = 0;
+  hopSumUs = [0, 0, 0, 0];
+  dominantCounts = [0, 0, 0, 0];
+  completed: CompletedTrace[] = [];
+
+  onTouchDetected(onsetUs: number, onsetGapUs: number, nowUs: number): void {
+    if (this.stage === 'responded') this.droppedCount++;
+    this.hopUs = [Math.floor(onsetGapUs / 2), nowUs - onsetUs, 0, 0];
+    this.detectedUs = nowUs;
+    this.stage = 'detected';
+  }
+
+  onResponse(nowUs: number): void {
+    if (this.stage !== 'detected') return;
+    this.respondedUs = nowUs;
+    this.hopUs[DISPATCH] = nowUs - this.detectedUs;
+    this.stage = 'responded';
+  }
+
+  onFramePushed(nowUs: number): void {
+    if (this.stage !== 'responded') return;
+    if (nowUs - this.respondedUs > TIMEOUT_MS * 1000) {
+      this.droppedCount++;
+      this.stage = 'idle';
+      return;
+    }
+    this.hopUs[FRAME] = nowUs - this.respondedUs;
+    this.complete(nowUs);
+  }
+
+  record(hops: number[], frameUs = 0): void {
+    this.hopUs = hops.slice();
+    this.complete(frameUs);
+  }
+
+  private complete(frameUs: number): void {
+    this.stage = 'idle';
+    let total = 0;
+    let dominant = 0;
+    this.hopUs.forEach((us, i) => {
+      total += us;
+      this.hopSumUs[i] += us;
+      if (us > this.hopUs[dominant]) dominant = i;
+    });
+    let bucket = 0;
+    while (bucket < BUCKET_COUNT - 1 && total > BUCKET_LIMITS_MS[bucket] * 1000) bucket++;
+    this.buckets[bucket]++;
+    if (total <= SLO_MS * 1000) this.withinSloCount++;
+    this.maxTotalUs = Math.max(this.maxTotalUs, total);
+    this.dominantCounts[dominant]++;
+    this.traceCount++;
+    this.completed.push({ hops: this.hopUs.slice(), totalUs: total, frameUs });
+  }
+
+  getPercentileMs(q: number): number {
+    if (this.traceCount === 0) return 0;
+    const rank = Math.max(1, Math.ceil(Math.min(Math.max(q, 0), 1) * this.traceCount));
+    const maxMs = Math.ceil(this.maxTotalUs / 1000);
+    let cumulative = 0;
+    for (let i = 0; i < BUCKET_COUNT - 1; i++) {
+      cumulative += this.buckets[i];
+      if (cumulative >= rank) return Math.min(BUCKET_LIMITS_MS[i], maxMs);
+    }
+    return maxMs;
+  }
+
+  getSloRatio(): number {
+    return this.traceCount === 0 ? 1 : this.withinSloCount / this.traceCount;
+  }
+
+  getDominantHop(): number {
+    let dominant = 0;
+    for (let i = 1; i < HOPS.length; i++) if (this.hopSumUs[i] > this.hopSumUs[dominant]) dominant = i;
+    return dominant;
+  }
+}
+
+// 模拟触摸传感器（对应固件中的TouchSensor::update，含原始读数越过阈值时刻的记录）
+class MockTouchSensor {
+  isTouched = false;
+  lastTouchState = false;
+  touchStartTime = 0;
+  lastReadTime = 0;
+  filteredValue = 1200;
+  lastPollUs = 0;
+  onsetUs = 0;
+  onsetGapUs = 0;
+  onsetSeen = false;
+
+  constructor(private tracer: MockTouchLatencyTracer, private onTap: TapHandler) {}
+
+  private detect(value: number): boolean {
+    return this.isTouched ? value > RELEASE_THRESHOLD : value > TOUCH_THRESHOLD;
+  }
+
+  private traceDetection(nowUs: number): void {
+    if (this.onsetSeen) this.tracer.onTouchDetected(this.onsetUs, this.onsetGapUs, nowUs);
+    else this.tracer.onTouchDetected(nowUs, 0, nowUs);
+    this.onsetSeen = false;
+  }
+
+  update(nowUs: number, raw: number): void {
+    const now = Math.floor(nowUs / 1000);
+    if (now - this.lastReadTime < 10) return;
+    this.lastReadTime = now;
+
+    this.filteredValue = Math.floor((this.filteredValue * (FILTER_ALPHA - 1) + raw) / FILTER_ALPHA);
+    const state = this.detect(this.filteredValue);
+
+    const rawChanged = this.detect(raw) !== this.lastTouchState;
+    if (rawChanged && !this.onsetSeen) {
+      this.onsetSeen = true;
+      this.onsetUs = nowUs;
+      this.onsetGapUs = nowUs - this.lastPollUs;
+    } else if (!rawChanged && state === this.lastTouchState) {
+      this.onsetSeen = false;
+    }
+    this.lastPollUs = nowUs;
+
+    if (state !== this.lastTouchState && now - this.touchStartTime > DEBOUNCE_MS) {
+      if (state) {
+        this.isTouched = true;
+        this.touchStartTime = now;
+        this.traceDetection(nowUs);
+      } else {
+        const duration = now - this.touchStartTime;
+        this.isTouched = false;
+        this.traceDetection(nowUs);
+        if (duration < HOLD_MS) this.onTap(nowUs);
+      }
+      this.lastTouchState = state;
+    }
+  }
+}
+
+interface Simulation {
+  tracer: MockTouchLatencyTracer;
+  releasesUs: number[];
+}
+
+/**
+ * 模拟主循环：每轮先更新灯带 (满20ms出帧) 再轮询触摸，轮询间隔受主循环空闲延时限制
+ * @param loopDelayMs 主循环空闲延时 (ms)
+ * @param taps 轻触次数
+ */
+function simulate(loopDelayMs: number, taps: number, random: Random): Simulation {
+  const tracer = new MockTouchLatencyTracer();
+  const sensor = new MockTouchSensor(tracer, (nowUs) => {
+    // 回调分发和灯光效果设置耗时几十微秒
+    tracer.onResponse(nowUs + 20 + Math.floor(random() * 80));
+  });
+
+  // 轻触脚本：按下400-600ms (50ms主循环下低通滤波需要约5次采样才判定按下)，间隔至少1.5s
+  const presses: Array<[number, number]> = [];
+  let t = 500000;
+  for (let i = 0; i < taps; i++) {
+    const press = t + Math.floor(random() * 1000000);
+    const release = press + 400000 + Math.floor(random() * 200000);
+    presses.push([press, release]);
+    t = release + 1500000;
+  }
+  const endUs = t;
+
+  const pressureAt = (us: number) => {
+    const pressed = presses.some(([p, r]) => us >= p && us < r);
+    return (pressed ? 2200 : 1200) + Math.floor((random() - 0.5) * 100);
+  };
+
+  let nowUs = 0;
+  let lastFrameMs = 0;
+  while (nowUs < endUs) {
+    nowUs += 200 + Math.floor(random() * 2800);           // 传感器、调度等其他工作
+    if (Math.floor(nowUs / 1000) - lastFrameMs >= FRAME_INTERVAL_MS) {
+      nowUs += 400;                                       // FastLED同步输出12颗灯约0.4ms
+      tracer.onFramePushed(nowUs);
+      lastFrameMs = Math.floor(nowUs / 1000);
+    }
+    nowUs += 100;
+    sensor.update(nowUs, pressureAt(nowUs));
+    nowUs += loopDelayMs * 1000 + 50;
+  }
+
+  return { tracer, releasesUs: presses.map(([, r]) => r) };
+}
+
+function exactPercentileMs(totalsUs: number[], q: number): number {
+  const sorted = [...totalsUs].sort((a, b) => a - b);
+  const rank = Math.max(1, Math.ceil(q * sorted.length));
+  return sorted[rank - 1] / 1000;
+}
+
+describe('触摸到灯光延迟跟踪属性测试', () => {
+  describe('属性: 直方图与SLO统计', () => {
+    test('Property: 直方图计数之和等于跟踪数，SLO比例精确', () => {
+      fc.assert(
+        fc.property(
+          fc.array(fc.array(fc.integer({ min: 0, max: 400000 }), { minLength: 4, maxLength: 4 }),
+                   { minLength: 1, maxLength: 300 }),
+          (traces) => {
+            const tracer = new MockTouchLatencyTracer();
+            traces.forEach(hops => tracer.record(hops));
+            const totals = traces.map(hops => hops.reduce((a, b) => a + b, 0));
+            const within = totals.filter(us => us <= SLO_MS * 1000).length;
+            const sum = tracer.buckets.reduce((a, b) => a + b, 0);
+            return sum === traces.length && tracer.getSloRatio() === within / traces.length;
+          }
+        ),
+        { numRuns: 100 }
+      );
+    });
+
+    test('Property: 直方图分位数不低于真实分位数，且不超过其所在桶的上限', () => {
+      fc.assert(
+        fc.property(
+          fc.array(fc.integer({ min: 1000, max: 1500000 }), { minLength: 1, maxLength: 500 }),
+          fc.constantFrom(0.5, 0.9, 0.95, 0.99),
+          (totals, q) => {
+            const tracer = new MockTouchLatencyTracer();
+            totals.forEach(us => tracer.record([us, 0, 0, 0]));
+            const exact = exactPercentileMs(totals, q);
+            const estimate = tracer.getPercentileMs(q);
+            const bound = BUCKET_LIMITS_MS.find(limit => exact <= limit) ?? Math.ceil(tracer.maxTotalUs / 1000);
+            return estimate >= exact && estimate <= bound;
+          }
+        ),
+        { numRuns: 200 }
+      );
+    });
+
+    test('Property: 每次跟踪的主要耗时环节是耗时最多的一段', () => {
+      fc.assert(
+        fc.property(
+          fc.array(fc.array(fc.integer({ min: 0, max: 200000 }), { minLength: 4, maxLength: 4 }),
+                   { minLength: 1, maxLength: 100 }),
+          (traces) => {
+            const tracer = new MockTouchLatencyTracer();
+            const expected = [0, 0, 0, 0];
+            traces.forEach(hops => {
+              expected[hops.indexOf(Math.max(...hops))]++;
+              tracer.record(hops);
+            });
+            return expected.every((count, i) => tracer.dominantCounts[i] === count);
+          }
+        ),
+        { numRuns: 100 }
+      );
+    });
+  });
+
+  describe('属性: 模拟主循环', () => {
+    test('Property: 每次轻触都被跟踪，各环节之和与真实延迟相差不超过半个轮询间隔', () => {
+      fc.assert(
+        fc.property(
+          fc.constantFrom(5, 10, 20, 50),
+          fc.integer({ min: 1, max: 20 }),
+          fc.integer({ min: 1, max: 0x7fffffff }),
+          (loopDelayMs, taps, seed) => {
+            const { tracer, releasesUs } = simulate(loopDelayMs, taps, seededRandom(seed));
+            if (tracer.traceCount !== taps || tracer.droppedCount !== 0) return false;
+            return tracer.completed.every((trace, i) => {
+              const sum = trace.hops.reduce((a, b) => a + b, 0);
+              const actual = trace.frameUs - releasesUs[i];
+              // 按下时刻在上一次采样之后均匀分布，估计误差不超过间隔的一半 (即POLL段本身)
+              return sum === trace.totalUs && Math.abs(trace.totalUs - actual) <= trace.hops[POLL] + 1;
+            });
+          }
+        ),
+        { numRuns: 100 }
+      );
+    });
+
+    test('Property: 默认50ms主循环下滤波防抖是主要耗时环节，分发耗时可忽略', () => {
+      fc.assert(
+        fc.property(fc.integer({ min: 1, max: 0x7fffffff }), (seed) => {
+          const { tracer } = simulate(50, 20, seededRandom(seed));
+          const dispatchMs = tracer.hopSumUs[DISPATCH] / tracer.traceCount / 1000;
+          return tracer.getDominantHop() === FILTER && dispatchMs < 1 && tracer.getSloRatio() < 0.95;
+        }),
+        { numRuns: 50 }
+      );
+    });
+
+    test('Property: 缩短主循环空闲延时后P95延迟降低', () => {
+      fc.assert(
+        fc.property(fc.integer({ min: 1, max: 0x7fffffff }), (seed) => {
+          const slow = simulate(50, 20, seededRandom(seed)).tracer;
+          const fast = simulate(5, 20, seededRandom(seed)).tracer;
+          return fast.getPercentileMs(0.95) < slow.getPercentileMs(0.95) &&
+                 fast.hopSumUs[POLL] < slow.hopSumUs[POLL] &&
+                 fast.hopSumUs[FRAME] < slow.hopSumUs[FRAME];
+        }),
+        { numRuns: 50 }
+      );
+    });
+  });
+});
@@ -0,0 +1,237 @@
+/**
+ * WiFi发射功率控制器属性测试
+ * 验证余量充足时降功率、链路变差时升功率、滞回防振荡以及每字节能耗统计
+ */
+
+import fc from 'fast-check';
+
+const MAX_DBM = 20;
+const MIN_DBM = 2;
+const STEP_DOWN = 1;
+const STEP_UP = 4;
+const INTERVAL = 10000;
+const AP_POWER = 20;
+const TARGET_RSSI = -70;
+const HYSTERESIS = 6;
+const RSSI_ALPHA = 0.1;
+const FAILURE_RATE_LIMIT = 0.1;
+const STABLE_PERIODS = 3;
+
+type Random = () => number;
+
+// 模拟发射功率控制器（对应固件中的TxPowerController逻辑）
+class MockTxPowerController {
+  powerDbm = MAX_DBM;
+  adjustCount = 0;
+  private rssiAverage = 0;
+  private rssiValid = false;
+  private periodAttempts = 0;
+  private periodFailures = 0;
+  private stablePeriods = 0;
+  private lastAdjust = 0;
+  private energyUj = 0;
+  private bytesDelivered = 0;
+
+  onRssiSample(rssi: number): void {
+    if (rssi >= 0) return;
+    if (!this.rssiValid) {
+      this.rssiAverage = rssi;
+      this.rssiValid = true;
+    } else {
+      this.rssiAverage += (rssi - this.rssiAverage) * RSSI_ALPHA;
+    }
+  }
+
+  recordTransmission(bytes: number, delivered: boolean): void {
+    this.periodAttempts++;
+    this.energyUj += bytes * MockTxPowerController.energyPerByteAt(this.powerDbm);
+    if (delivered) this.bytesDelivered += bytes;
+    else this.periodFailures++;
+  }
+
+  update(now: number): boolean {
+    if (now - this.lastAdjust < INTERVAL) return false;
+    this.lastAdjust = now;
+
+    const failureRate = this.periodAttempts > 0 ? this.periodFailures / this.periodAttempts : 0;
+    const anyFailure = this.periodFailures > 0;
+    this.periodAttempts = 0;
+    this.periodFailures = 0;
+    if (!this.rssiValid) return false;
+
+    const uplink = this.getEstimatedUplinkRssi();
+    let newPower = this.powerDbm;
+    if (failureRate > FAILURE_RATE_LIMIT || uplink < TARGET_RSSI - HYSTERESIS / 2) {
+      newPower = this.powerDbm + STEP_UP;
+      this.stablePeriods = 0;
+    } else if (!anyFailure && uplink > TARGET_RSSI + HYSTERESIS / 2) {
+      if (++this.stablePeriods >= STABLE_PERIODS) {
+        newPower = this.powerDbm - STEP_DOWN;
+        this.stablePeriods = 0;
+      }
+    } else {
+      this.stablePeriods = 0;
+    }
+
+    newPower = Math.min(MAX_DBM, Math.max(MIN_DBM, newPower));
+    if (newPower === this.powerDbm) return false;
+    this.powerDbm = newPower;
+    this.adjustCount++;
+    return true;
+  }
+
+  getEstimatedUplinkRssi(): number {
+    return this.rssiAverage - (AP_POWER - this.powerDbm);
+  }
+
+  getEnergyPerByte(): number {
+    return this.bytesDelivered > 0 ? this.energyUj / this.bytesDelivered : 0;
+  }
+
+  static energyPerByteAt(dbm: number): number {
+    return 3.3 * (100 + 10 * dbm) / 1000 * 8 / 11;
+  }
+}
+
+function seededRandom(seed: number): Random {
+  let s = seed >>> 0;
+  return () => {
+    s = (s * 1664525 + 1013904223) >>> 0;
+    return s / 0x100000000;
+  };
+}
+
+// 链路模拟：下行RSSI = 路由器功率 - 路径损耗 + 噪声；
+// 信号良好时MAC层重传掩盖偶发丢包，路由器处上行RSSI接近灵敏度后失败概率迅速上升
+class LinkSimulation {
+  constructor(public pathLoss: number, private noise: number, private random: Random) {}
+
+  downlinkRssi(): number {
+    return Math.round(AP_POWER - this.pathLoss + (this.random() * 2 - 1) * this.noise);
+  }
+
+  delivered(txDbm: number): boolean {
+    const uplink = txDbm - this.pathLoss;
+    const lossProbability = uplink >= -80 ? 0 : Math.min(1, (-80 - uplink) * 0.1);
+    return this.random() >= lossProbability;
+  }
+}
+
+// 每秒采样RSSI并发送一次数据，运行指定秒数 (对应固件中RSSI按1秒节流采样)
+function run(controller: MockTxPowerController, link: LinkSimulation, startSecond: number, seconds: number): number {
+  let changes = 0;
+  for (let t = startSecond; t < startSecond + seconds; t++) {
+    controller.onRssiSample(link.downlinkRssi());
+    controller.recordTransmission(200, link.delivered(controller.powerDbm));
+    if (controller.update(t * 1000)) changes++;
+  }
+  return changes;
+}
+
+describe('WiFi发射功率控制器属性测试', () => {
+  describe('属性: 收敛', () => {
+    test('Property: 靠近路由器时降低功率，估计上行RSSI停在滞回带内或功率达到下限', () => {
+      fc.assert(
+        fc.property(
+          fc.integer({ min: 40, max: 70 }),
+          fc.integer({ min: 1, max: 0x7fffffff }),
+          (pathLoss, seed) => {
+            const controller = new MockTxPowerController();
+            const link = new LinkSimulation(pathLoss, 2, seededRandom(seed));
+            run(controller, link, 0, 3600);
+            const uplink = MAX_DBM - pathLoss - (AP_POWER - MAX_DBM);
+            if (uplink <= TARGET_RSSI + HYSTERESIS / 2) return true;
+            const estimated = controller.getEstimatedUplinkRssi();
+            return controller.powerDbm < MAX_DBM &&
+                   (controller.powerDbm === MIN_DBM || estimated <= TARGET_RSSI + HYSTERESIS / 2 + 2);
+          }
+        ),
+        { numRuns: 50 }
+      );
+    });
+
+    test('Property: 远离路由器时保持最大功率', () => {
+      fc.assert(
+        fc.property(
+          fc.integer({ min: 94, max: 110 }),
+          fc.integer({ min: 1, max: 0x7fffffff }),
+          (pathLoss, seed) => {
+            const controller = new MockTxPowerController();
+            const link = new LinkSimulation(pathLoss, 2, seededRandom(seed));
+            run(controller, link, 0, 1800);
+            return controller.powerDbm === MAX_DBM;
+          }
+        ),
+        { numRuns: 50 }
+      );
+    });
+
+    test('Property: 稳定链路收敛后不来回调整', () => {
+      fc.assert(
+        fc.property(
+          fc.integer({ min: 40, max: 90 }),
+          fc.integer({ min: 1, max: 0x7fffffff }),
+          (pathLoss, seed) => {
+            const controller = new MockTxPowerController();
+            const link = new LinkSimulation(pathLoss, 2, seededRandom(seed));
+            run(controller, link, 0, 3600);
+            const laterChanges = run(controller, link, 3600, 3600);
+            return laterChanges <= 2;
+          }
+        ),
+        { numRuns: 50 }
+      );
+    });
+  });
+
+  describe('属性: 链路变差', () => {
+    test('Property: 路径损耗增大使上行RSSI明显低于滞回带后四个周期内提高功率并恢复送达', () => {
+      fc.assert(
+        fc.property(
+          fc.integer({ min: 40, max: 60 }),
+          fc.integer({ min: 35, max: 45 }),
+          fc.integer({ min: 1, max: 0x7fffffff }),
+          (pathLoss, extraLoss, seed) => {
+            const random = seededRandom(seed);
+            const controller = new MockTxPowerController();
+            const link = new LinkSimulation(pathLoss, 2, random);
+            run(controller, link, 0, 3600);
+            const before = controller.powerDbm;
+
+            link.pathLoss = pathLoss + extraLoss;
+            // RSSI平滑有延迟，只检验超出滞回带3dB以上的情况
+            if (before - link.pathLoss >= TARGET_RSSI - HYSTERESIS / 2 - 3) return true;
+            run(controller, link, 3600, 4 * INTERVAL / 1000);
+            if (controller.powerDbm < Math.min(MAX_DBM, before + STEP_UP)) return false;
+
+            run(controller, link, 3600 + 4 * INTERVAL / 1000, 600);
+            let delivered = 0;
+            for (let i = 0; i < 200; i++) if (link.delivered(controller.powerDbm)) delivered++;
+            // 最大功率仍不足时至少已用尽功率余量
+            return delivered >= 180 || controller.powerDbm === MAX_DBM;
+          }
+        ),
+        { numRuns: 50 }
+      );
+    });
+  });
+
+  describe('属性: 能耗', () => {
+    test('Property: 降功率后每字节能耗不高于始终最大功率', () => {
+      fc.assert(
+        fc.property(
+          fc.integer({ min: 40, max: 80 }),
+          fc.integer({ min: 1, max: 0x7fffffff }),
+          (pathLoss, seed) => {
+            const controller = new MockTxPowerController();
+            const link = new LinkSimulation(pathLoss, 2, seededRandom(seed));
+            run(controller, link, 0, 3600);
+            const fixedPerByte = MockTxPowerController.energyPerByteAt(MAX_DBM) / 0.95;
+            return controller.getEnergyPerByte() <= fixedPerByte;
+          }
+        ),
+        { numRuns: 50 }
+      );
+    });
+  });
+});
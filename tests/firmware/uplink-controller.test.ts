@@ -0,0 +1,311 @@
+/**
+ * 上行自适应控制器属性测试
+ * 验证AIMD窗口的边界、增长和减半，信号低谷推迟非紧急上传，以及推迟时间上限
+ */
+
+import fc from 'fast-check';
+
+const BATCH_INITIAL = 5;
+const BATCH_MIN = 1;
+const BATCH_MAX = 20;
+const BATCH_INCREASE = 1;
+const BATCH_DECREASE = 0.5;
+const RSSI_DIP_DB = 4;
+const RSSI_GOOD_DBM = -60;
+const MAX_DEFER_MS = 300000;
+const FORCE_QUEUE_FILL = 0.8;
+const STATS_ALPHA = 0.2;
+
+type Random = () => number;
+
+// 模拟上行自适应控制器（对应固件中的UplinkController逻辑）
+class MockUplinkController {
+  batchWindow = BATCH_INITIAL;
+  goodput = 0;
+  errorRate = 0;
+  deferrals = 0;
+  private currentRssi = 0;
+  private rssiBaseline = 0;
+  private rssiValid = false;
+  private statsValid = false;
+  private roundAttempts = 0;
+  private roundFailures = 0;
+  private roundBytes = 0;
+  private roundAirTime = 0;
+
+  onSignalSample(rssi: number, baseline: number): void {
+    if (rssi >= 0 || baseline >= 0) {
+      this.rssiValid = false;
+      return;
+    }
+    this.currentRssi = rssi;
+    this.rssiBaseline = baseline;
+    this.rssiValid = true;
+  }
+
+  recordTransmission(bytes: number, delivered: boolean, elapsedMs: number): void {
+    this.roundAttempts++;
+    this.roundAirTime += elapsedMs;
+    if (delivered) this.roundBytes += bytes;
+    else this.roundFailures++;
+  }
+
+  endRound(windowLimited: boolean): boolean {
+    if (this.roundAttempts === 0) return false;
+
+    const roundErrorRate = this.roundFailures / this.roundAttempts;
+    const roundGoodput = this.roundAirTime > 0 ? this.roundBytes * 1000 / this.roundAirTime : 0;
+    if (!this.statsValid) {
+      this.errorRate = roundErrorRate;
+      this.goodput = roundGoodput;
+      this.statsValid = true;
+    } else {
+      this.errorRate += (roundErrorRate - this.errorRate) * STATS_ALPHA;
+      this.goodput += (roundGoodput - this.goodput) * STATS_ALPHA;
+    }
+
+    let newWindow = this.batchWindow;
+    if (this.roundFailures > 0) newWindow = this.batchWindow * BATCH_DECREASE;
+    else if (windowLimited) newWindow = this.batchWindow + BATCH_INCREASE;
+    newWindow = Math.min(BATCH_MAX, Math.max(BATCH_MIN, newWindow));
+
+    this.roundAttempts = 0;
+    this.roundFailures = 0;
+    this.roundBytes = 0;
+    this.roundAirTime = 0;
+
+    const changed = Math.floor(newWindow) !== Math.floor(this.batchWindow);
+    this.batchWindow = newWindow;
+    return changed;
+  }
+
+  getBatchSize(): number {
+    return Math.floor(this.batchWindow);
+  }
+
+  isGoodMoment(): boolean {
+    if (!this.rssiValid) return true;
+    return this.currentRssi >= RSSI_GOOD_DBM || this.currentRssi >= this.rssiBaseline - RSSI_DIP_DB;
+  }
+
+  shouldSendDeferrable(oldestAgeMs: number, queueFill: number): boolean {
+    if (this.isGoodMoment() || oldestAgeMs >= MAX_DEFER_MS || queueFill >= FORCE_QUEUE_FILL) return true;
+    this.deferrals++;
+    return false;
+  }
+}
+
+function seededRandom(seed: number): Random {
+  let s = seed >>> 0;
+  return () => {
+    s = (s * 1664525 + 1013904223) >>> 0;
+    return s / 0x100000000;
+  };
+}
+
+// 信号模拟：平时RSSI在基准附近，偶尔进入持续数十秒的低谷；低谷中失败概率明显升高
+class FadingLink {
+  private dipRemaining = 0;
+  private history: number[] = [];
+
+  constructor(private base: number, private dipDepth: number, private dipChance: number, private random: Random) {}
+
+  // 每秒推进一次，返回当前RSSI
+  step(): number {
+    if (this.dipRemaining > 0) this.dipRemaining--;
+    else if (this.random() < this.dipChance) this.dipRemaining = 10 + Math.floor(this.random() * 50);
+    const rssi = Math.round(this.base - (this.dipRemaining > 0 ? this.dipDepth : 0) + (this.random() * 2 - 1));
+    this.history.push(rssi);
+    if (this.history.length > 10) this.history.shift();
+    return rssi;
+  }
+
+  // 对应WiFiManager::getRssiBaseline：最近10次采样的平均
+  baseline(): number {
+    return this.history.reduce((a, b) => a + b, 0) / this.history.length;
+  }
+
+  delivered(rssi: number): boolean {
+    const lossProbability = rssi >= -75 ? 0.02 : Math.min(0.9, 0.3 + (-75 - rssi) * 0.05);
+    return this.random() >= lossProbability;
+  }
+}
+
+interface UplinkResult {
+  delivered: number;
+  failures: number;
+  maxWait: number;
+}
+
+// 每秒产生一条普通消息，每秒处理一轮队列；adaptive=false 对应原来固定每轮5条、不看信号
+function simulate(link: FadingLink, seconds: number, adaptive: boolean, random: Random): UplinkResult {
+  const controller = new MockUplinkController();
+  const queue: number[] = [];
+  const result: UplinkResult = { delivered: 0, failures: 0, maxWait: 0 };
+
+  for (let t = 0; t < seconds; t++) {
+    const now = t * 1000;
+    queue.push(now);
+    if (queue.length > 100) queue.shift();
+    const rssi = link.step();
+    controller.onSignalSample(rssi, link.baseline());
+
+    const oldestAge = queue.length > 0 ? now - queue[0] : 0;
+    if (adaptive && !controller.shouldSendDeferrable(oldestAge, queue.length / 100)) continue;
+
+    const batch = adaptive ? controller.getBatchSize() : 5;
+    let processed = 0;
+    while (processed < batch && queue.length > 0) {
+      const ok = link.delivered(rssi);
+      controller.recordTransmission(200, ok, 20 + Math.floor(random() * 20));
+      processed++;
+      if (ok) {
+        result.maxWait = Math.max(result.maxWait, now - queue[0]);
+        queue.shift();
+        result.delivered++;
+      } else {
+        result.failures++;
+        if (adaptive) break;
+      }
+    }
+    controller.endRound(processed >= batch);
+  }
+  return result;
+}
+
+describe('上行自适应控制器属性测试', () => {
+  describe('属性: AIMD窗口', () => {
+    test('Property: 任意送达序列下窗口保持在上下限之间', () => {
+      fc.assert(
+        fc.property(
+          fc.array(fc.tuple(fc.array(fc.boolean(), { minLength: 1, maxLength: 25 }), fc.boolean()), { maxLength: 200 }),
+          (rounds) => {
+            const controller = new MockUplinkController();
+            for (const [results, windowLimited] of rounds) {
+              for (const ok of results) controller.recordTransmission(100, ok, 10);
+              controller.endRound(windowLimited);
+              const size = controller.getBatchSize();
+              if (size < BATCH_MIN || size > BATCH_MAX) return false;
+            }
+            return true;
+          }
+        ),
+        { numRuns: 100 }
+      );
+    });
+
+    test('Property: 链路无失败且积压充足时每轮加一直到上限', () => {
+      fc.assert(
+        fc.property(fc.integer({ min: 0, max: 40 }), (extraRounds) => {
+          const controller = new MockUplinkController();
+          const rounds = BATCH_MAX - BATCH_INITIAL + extraRounds;
+          for (let r = 0; r < rounds; r++) {
+            const expected = Math.min(BATCH_MAX, BATCH_INITIAL + r);
+            if (controller.getBatchSize() !== expected) return false;
+            for (let i = 0; i < controller.getBatchSize(); i++) controller.recordTransmission(200, true, 20);
+            controller.endRound(true);
+          }
+          return controller.getBatchSize() === BATCH_MAX;
+        }),
+        { numRuns: 50 }
+      );
+    });
+
+    test('Property: 出现失败的一轮窗口减半 (不低于下限)', () => {
+      fc.assert(
+        fc.property(
+          fc.integer({ min: 0, max: 30 }),
+          fc.integer({ min: 1, max: 10 }),
+          (growRounds, failures) => {
+            const controller = new MockUplinkController();
+            for (let r = 0; r < growRounds; r++) {
+              controller.recordTransmission(200, true, 20);
+              controller.endRound(true);
+            }
+            const before = controller.batchWindow;
+            for (let i = 0; i < failures; i++) controller.recordTransmission(200, false, 20);
+            controller.endRound(true);
+            return controller.batchWindow === Math.max(BATCH_MIN, before * BATCH_DECREASE);
+          }
+        ),
+        { numRuns: 50 }
+      );
+    });
+
+    test('Property: 窗口未用满的轮次不增加窗口', () => {
+      fc.assert(
+        fc.property(fc.integer({ min: 1, max: 50 }), (rounds) => {
+          const controller = new MockUplinkController();
+          for (let r = 0; r < rounds; r++) {
+            controller.recordTransmission(200, true, 20);
+            controller.endRound(false);
+          }
+          return controller.getBatchSize() === BATCH_INITIAL;
+        }),
+        { numRuns: 50 }
+      );
+    });
+  });
+
+  describe('属性: 避开信号低谷', () => {
+    test('Property: 低于近期平均超过阈值且信号不够好时推迟，其余情况发送', () => {
+      fc.assert(
+        fc.property(
+          fc.integer({ min: -95, max: -40 }),
+          fc.integer({ min: -95, max: -40 }),
+          (rssi, baseline) => {
+            const controller = new MockUplinkController();
+            controller.onSignalSample(rssi, baseline);
+            const inDip = rssi < RSSI_GOOD_DBM && rssi < baseline - RSSI_DIP_DB;
+            return controller.shouldSendDeferrable(0, 0) === !inDip;
+          }
+        ),
+        { numRuns: 200 }
+      );
+    });
+
+    test('Property: 推迟过久或队列将满时不论信号都发送', () => {
+      fc.assert(
+        fc.property(
+          fc.integer({ min: MAX_DEFER_MS, max: MAX_DEFER_MS * 4 }),
+          fc.float({ min: Math.fround(FORCE_QUEUE_FILL), max: 1, noNaN: true }),
+          (age, fill) => {
+            const controller = new MockUplinkController();
+            controller.onSignalSample(-90, -65);
+            return controller.shouldSendDeferrable(age, 0) && controller.shouldSendDeferrable(0, fill);
+          }
+        ),
+        { numRuns: 50 }
+      );
+    });
+
+    test('Property: 有信号低谷的链路上，每条送达消息的失败次数不多于固定批量', () => {
+      fc.assert(
+        fc.property(
+          fc.integer({ min: -70, max: -62 }),
+          fc.integer({ min: 12, max: 25 }),
+          fc.integer({ min: 1, max: 0x7fffffff }),
+          (base, dipDepth, seed) => {
+            const fixed = simulate(new FadingLink(base, dipDepth, 0.02, seededRandom(seed)), 3600, false, seededRandom(seed + 1));
+            const adaptive = simulate(new FadingLink(base, dipDepth, 0.02, seededRandom(seed)), 3600, true, seededRandom(seed + 1));
+            const fixedRate = fixed.failures / Math.max(1, fixed.delivered);
+            const adaptiveRate = adaptive.failures / Math.max(1, adaptive.delivered);
+            return adaptiveRate <= fixedRate && adaptive.delivered >= fixed.delivered * 0.95;
+          }
+        ),
+        { numRuns: 30 }
+      );
+    });
+
+    test('Property: 信号持续很差时消息等待时间不超过推迟上限太多', () => {
+      fc.assert(
+        fc.property(fc.integer({ min: 1, max: 0x7fffffff }), (seed) => {
+          // 基准-70dBm，低谷几乎一直存在 (近期平均跟随低谷后不再视为低谷)
+          const result = simulate(new FadingLink(-70, 15, 0.5, seededRandom(seed)), 1800, true, seededRandom(seed + 1));
+          return result.delivered > 0 && result.maxWait <= MAX_DEFER_MS + 60000;
+        }),
+        { numRuns: 30 }
+      );
+    });
+  });
+});
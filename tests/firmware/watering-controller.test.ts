@@ -0,0 +1,410 @@
+/**
+ * 自动浇水控制器属性测试
+ * 在主机端土壤动态模型上验证脉冲浇水闭环的正确性属性
+ */
+
+import fc from 'fast-check';
+
+const TARGET_RISE = 20;
+const TOLERANCE = 2;
+const MIN_PULSE_MS = 500;
+const MAX_PULSE_MS = 8000;
+const PROBE_PULSE_MS = 2000;
+const MAX_PULSES = 6;
+const DAILY_LIMIT_S = 120;
+const SAMPLE_INTERVAL = 5000;
+const SOAK_MAX_MS = 300000;
+const SETTLE_WINDOW_MS = 30000;
+const SETTLE_RATIO = 0.05;
+const DEFAULT_GAIN = 2.0;
+const DEFAULT_INFILTRATION_MS = 60000;
+const DRY_RUN_RATIO = 0.15;
+const DRY_RUN_LIMIT = 2;
+const STEP_MS = 100;
+
+type State = 'idle' | 'pumping' | 'soaking' | 'cooldown' | 'locked_out';
+type Fault = 'none' | 'dry_run' | 'daily_limit' | 'max_pulses';
+type Random = () => number;
+
+/**
+ * 土壤动态模型：水泵出水经过管路死区后进入表层积水，
+ * 按一阶时间常数入渗到探头所在深度，同时缓慢蒸发
+ */
+class SoilSimulation {
+  private delayLine: number[] = [];
+  private pending = 0;
+
+  constructor(
+    public moisture: number,
+    private gainPerSecond: number,
+    private deadTimeS: number,
+    private tauS: number,
+    private dryingPerHour = 0.5,
+    private noise = 0.2
+  ) {}
+
+  step(pumpOn: boolean, seconds: number): void {
+    this.delayLine.push(pumpOn ? this.gainPerSecond * seconds : 0);
+    if (this.delayLine.length > this.deadTimeS / seconds) {
+      this.pending += this.delayLine.shift() as number;
+    }
+    const infiltrated = this.pending * (1 - Math.exp(-seconds / this.tauS));
+    this.pending -= infiltrated;
+    this.moisture += infiltrated - this.dryingPerHour * seconds / 3600;
+  }
+
+  read(random: Random): number {
+    return this.moisture + (random() * 2 - 1) * this.noise;
+  }
+
+  totalEventually(): number {
+    return this.moisture + this.pending + this.delayLine.reduce((a, b) => a + b, 0);
+  }
+}
+
+// 模拟浇水控制器（对应固件中的WateringController逻辑）
+class MockWateringController {
+  now = 0;
+  state: State = 'idle';
+  lastFault: Fault = 'none';
+  gainPerSecond = DEFAULT_GAIN;
+  infiltrationMs = DEFAULT_INFILTRATION_MS;
+  samples = 0;
+  pumpSecondsToday = 0;
+  cyclePulses = 0;
+  longestPulseMs = 0;
+  cycles = 0;
+
+  private lastSampleTime = -Infinity;
+  private dryRunCount = 0;
+  private pumpStartTime = 0;
+  private pulseMs = 0;
+  private pulseBaseline = 0;
+  private expectedRise = 0;
+  private soakStartTime = 0;
+  private soakTimes: number[] = [];
+  private soakValues: number[] = [];
+
+  constructor(private triggerMoisture: number, private targetMoisture = triggerMoisture + TARGET_RISE) {}
+
+  get pumpOn(): boolean {
+    return this.state === 'pumping';
+  }
+
+  update(): void {
+    if (this.state === 'pumping' && this.now - this.pumpStartTime >= this.pulseMs) {
+      this.stopPump();
+      this.state = 'soaking';
+      this.soakStartTime = this.now;
+      this.soakTimes = [];
+      this.soakValues = [];
+    } else if (this.state === 'soaking' && this.now - this.soakStartTime >= SOAK_MAX_MS) {
+      this.finishSoak();
+    }
+  }
+
+  wantsSample(): boolean {
+    return this.state === 'soaking' && this.now - this.lastSampleTime >= SAMPLE_INTERVAL;
+  }
+
+  onMoistureSample(moisture: number): void {
+    if (!Number.isFinite(moisture)) return;
+    this.lastSampleTime = this.now;
+    if (this.state === 'idle' && moisture < this.triggerMoisture) {
+      this.startCycle(moisture);
+    } else if (this.state === 'soaking') {
+      this.soakTimes.push(this.now - this.soakStartTime);
+      this.soakValues.push(moisture);
+      if (this.isSoakSettled()) this.finishSoak();
+    }
+  }
+
+  private startCycle(moisture: number): void {
+    if (this.pumpSecondsToday >= DAILY_LIMIT_S) {
+      this.lastFault = 'daily_limit';
+      this.state = 'cooldown';
+      return;
+    }
+    this.cyclePulses = 0;
+    this.dryRunCount = 0;
+    this.startPulse(moisture);
+  }
+
+  private startPulse(moisture: number): void {
+    const gap = this.targetMoisture - moisture;
+    if (gap <= TOLERANCE) return this.finishCycle(moisture);
+
+    const fraction = this.samples >= 3 ? 0.9 : 0.6;
+    let seconds = fraction * gap / this.gainPerSecond;
+    if (this.samples === 0 && seconds * 1000 > PROBE_PULSE_MS) seconds = PROBE_PULSE_MS / 1000;
+
+    let ms = Math.floor(seconds * 1000);
+    ms = Math.max(MIN_PULSE_MS, Math.min(MAX_PULSE_MS, ms));
+
+    const remainingMs = (DAILY_LIMIT_S - this.pumpSecondsToday) * 1000;
+    if (remainingMs < ms) {
+      if (remainingMs < MIN_PULSE_MS) {
+        this.lastFault = 'daily_limit';
+        return this.finishCycle(moisture);
+      }
+      ms = Math.floor(remainingMs);
+    }
+
+    this.pulseMs = ms;
+    this.pulseBaseline = moisture;
+    this.expectedRise = this.gainPerSecond * ms / 1000;
+    this.cyclePulses++;
+    this.longestPulseMs = Math.max(this.longestPulseMs, ms);
+    this.pumpStartTime = this.now;
+    this.state = 'pumping';
+  }
+
+  private stopPump(): void {
+    const runMs = Math.min(this.now - this.pumpStartTime, this.pulseMs);
+    this.pulseMs = runMs;
+    this.pumpSecondsToday += runMs / 1000;
+  }
+
+  private isSoakSettled(): boolean {
+    const elapsed = this.now - this.soakStartTime;
+    const count = this.soakValues.length;
+    if (count < 3 || elapsed < this.infiltrationMs) return false;
+
+    const last = count - 1;
+    const rise = this.soakValues[last] - this.pulseBaseline;
+    if (rise < this.expectedRise * DRY_RUN_RATIO) return elapsed >= 2 * this.infiltrationMs;
+
+    let first = last;
+    while (first > 0 && this.soakTimes[last] - this.soakTimes[first - 1] <= SETTLE_WINDOW_MS) first--;
+    if (this.soakTimes[last] - this.soakTimes[first] < SETTLE_WINDOW_MS / 2) return false;
+
+    return this.soakValues[last] - this.soakValues[first] < rise * SETTLE_RATIO;
+  }
+
+  private finishSoak(): void {
+    const tail = this.soakValues.slice(-3);
+    const settled = tail.reduce((a, b) => a + b, 0) / tail.length;
+    const rise = settled - this.pulseBaseline;
+
+    if (rise < this.expectedRise * DRY_RUN_RATIO && rise < TOLERANCE) {
+      this.dryRunCount++;
+      if (this.dryRunCount >= DRY_RUN_LIMIT) {
+        this.lastFault = 'dry_run';
+        this.state = 'locked_out';
+        return;
+      }
+    } else {
+      this.dryRunCount = 0;
+      this.learnFromPulse(rise);
+    }
+
+    if (settled >= this.targetMoisture - TOLERANCE) {
+      this.finishCycle(settled);
+    } else if (this.cyclePulses >= MAX_PULSES) {
+      this.lastFault = 'max_pulses';
+      this.finishCycle(settled);
+    } else {
+      this.startPulse(settled);
+    }
+  }
+
+  private learnFromPulse(rise: number): void {
+    if (this.pulseMs === 0 || !Number.isFinite(rise)) return;
+    const observed = Math.max(0.05, Math.min(20, rise / (this.pulseMs / 1000)));
+    this.gainPerSecond = this.samples === 0 ? observed : this.gainPerSecond * 0.7 + observed * 0.3;
+    for (let i = 0; i < this.soakValues.length; i++) {
+      if (this.soakValues[i] - this.pulseBaseline >= rise * 0.9) {
+        this.infiltrationMs = this.samples === 0 ? this.soakTimes[i]
+          : Math.floor(this.infiltrationMs * 0.7 + this.soakTimes[i] * 0.3);
+        break;
+      }
+    }
+    this.samples++;
+  }
+
+  private finishCycle(moisture: number): void {
+    if (this.cyclePulses > 0) this.cycles++;
+    this.state = 'cooldown';
+  }
+
+  // 冷却结束 (测试中直接跳过最小间隔)
+  endCooldown(): void {
+    if (this.state === 'cooldown') this.state = 'idle';
+  }
+}
+
+// 伪随机数 (可复现的传感器噪声)
+function lcg(seed: number): Random {
+  let s = seed >>> 0;
+  return () => {
+    s = (s * 1664525 + 1013904223) >>> 0;
+    return s / 0x100000000;
+  };
+}
+
+// 运行一个浇水周期直到控制器离开运行/入渗状态
+function runCycle(controller: MockWateringController, soil: SoilSimulation, random: Random,
+                  limitMs = 3600000): void {
+  controller.onMoistureSample(soil.read(random));
+  const end = controller.now + limitMs;
+  while ((controller.state === 'pumping' || controller.state === 'soaking') && controller.now < end) {
+    soil.step(controller.pumpOn, STEP_MS / 1000);
+    controller.now += STEP_MS;
+    controller.update();
+    if (controller.wantsSample()) controller.onMoistureSample(soil.read(random));
+  }
+}
+
+const soilArb = fc.record({
+  gain: fc.float({ min: Math.fround(1.5), max: 6, noNaN: true }),
+  deadTime: fc.integer({ min: 0, max: 30 }),
+  tau: fc.integer({ min: 5, max: 60 }),
+  start: fc.float({ min: 18, max: 28, noNaN: true }),
+  seed: fc.integer({ min: 1, max: 0x7fffffff })
+});
+
+describe('自动浇水控制器属性测试', () => {
+  describe('属性: 收敛到目标', () => {
+    test('Property: 从下方逼近目标湿度，入渗完成后不超过目标加容差', () => {
+      fc.assert(
+        fc.property(soilArb, ({ gain, deadTime, tau, start, seed }) => {
+          const random = lcg(seed);
+          const soil = new SoilSimulation(start, gain, deadTime, tau);
+          const controller = new MockWateringController(30);
+          runCycle(controller, soil, random);
+
+          // 等待剩余的水全部入渗后再检查
+          const final = soil.totalEventually();
+          return controller.state === 'cooldown' &&
+                 controller.lastFault === 'none' &&
+                 final >= 50 - TOLERANCE - 1 &&
+                 final <= 50 + TOLERANCE + 1;
+        }),
+        { numRuns: 100 }
+      );
+    });
+
+    test('Property: 学习后的后续周期脉冲更少', () => {
+      fc.assert(
+        fc.property(soilArb, ({ gain, deadTime, tau, start, seed }) => {
+          const random = lcg(seed);
+          const soil = new SoilSimulation(start, gain, deadTime, tau);
+          const controller = new MockWateringController(30);
+          runCycle(controller, soil, random);
+          const firstPulses = controller.cyclePulses;
+
+          // 土壤重新变干后再次浇水
+          for (let day = 0; day < 3; day++) {
+            controller.endCooldown();
+            controller.pumpSecondsToday = 0;
+            soil.moisture = start;
+            runCycle(controller, soil, random);
+          }
+          return controller.cyclePulses <= firstPulses && controller.lastFault === 'none';
+        }),
+        { numRuns: 50 }
+      );
+    });
+  });
+
+  describe('属性: 安全联锁', () => {
+    test('Property: 单次脉冲从不超过硬上限', () => {
+      fc.assert(
+        fc.property(
+          fc.float({ min: Math.fround(0.1), max: 10, noNaN: true }),
+          fc.float({ min: 0, max: 29, noNaN: true }),
+          fc.integer({ min: 1, max: 0x7fffffff }),
+          (gain, start, seed) => {
+            const random = lcg(seed);
+            const soil = new SoilSimulation(start, gain, 5, 20);
+            const controller = new MockWateringController(30);
+            runCycle(controller, soil, random);
+            return controller.longestPulseMs <= MAX_PULSE_MS &&
+                   controller.cyclePulses <= MAX_PULSES;
+          }
+        ),
+        { numRuns: 100 }
+      );
+    });
+
+    test('Property: 每日运行时长不超过上限', () => {
+      fc.assert(
+        fc.property(
+          fc.float({ min: Math.fround(0.1), max: 3, noNaN: true }),
+          fc.integer({ min: 1, max: 0x7fffffff }),
+          (gain, seed) => {
+            const random = lcg(seed);
+            const soil = new SoilSimulation(5, gain, 2, 10);
+            const controller = new MockWateringController(30);
+            // 干燥且响应很弱的土壤会反复触发浇水
+            for (let cycle = 0; cycle < 10; cycle++) {
+              controller.endCooldown();
+              soil.moisture = 5;
+              runCycle(controller, soil, random);
+              if (controller.pumpSecondsToday > DAILY_LIMIT_S + 1e-6) return false;
+            }
+            return true;
+          }
+        ),
+        { numRuns: 50 }
+      );
+    });
+
+    test('Property: 水箱无水时连续两个脉冲后锁定', () => {
+      fc.assert(
+        fc.property(
+          fc.float({ min: 5, max: 28, noNaN: true }),
+          fc.integer({ min: 1, max: 0x7fffffff }),
+          (start, seed) => {
+            const random = lcg(seed);
+            const soil = new SoilSimulation(start, 0, 5, 20);
+            const controller = new MockWateringController(30);
+            runCycle(controller, soil, random);
+            return controller.state === 'locked_out' &&
+                   controller.lastFault === 'dry_run' &&
+                   controller.cyclePulses === DRY_RUN_LIMIT;
+          }
+        ),
+        { numRuns: 50 }
+      );
+    });
+
+    test('Property: 读数中夹杂NaN时学习到的模型保持有限值', () => {
+      fc.assert(
+        fc.property(soilArb, fc.float({ min: Math.fround(0.05), max: Math.fround(0.5), noNaN: true }), (p, dropout) => {
+          const random = lcg(p.seed);
+          const soil = new SoilSimulation(p.start, p.gain, p.deadTime, p.tau);
+          const controller = new MockWateringController(30);
+          const readFaulty = () => (random() < dropout ? NaN : soil.read(random));
+          for (let cycle = 0; cycle < 2; cycle++) {
+            controller.onMoistureSample(soil.read(random));
+            const end = controller.now + 3600000;
+            while ((controller.state === 'pumping' || controller.state === 'soaking') && controller.now < end) {
+              soil.step(controller.pumpOn, STEP_MS / 1000);
+              controller.now += STEP_MS;
+              controller.update();
+              if (controller.wantsSample()) controller.onMoistureSample(readFaulty());
+            }
+            controller.endCooldown();
+          }
+          return Number.isFinite(controller.gainPerSecond) && Number.isFinite(controller.infiltrationMs) &&
+                 controller.samples > 0;
+        }),
+        { numRuns: 30 }
+      );
+    });
+
+    test('Property: 已学习模型遇到无水时同样锁定', () => {
+      const random = lcg(42);
+      const soil = new SoilSimulation(20, 3, 5, 20);
+      const controller = new MockWateringController(30);
+      runCycle(controller, soil, random);
+      expect(controller.samples).toBeGreaterThan(0);
+
+      controller.endCooldown();
+      const dry = new SoilSimulation(20, 0, 5, 20);
+      runCycle(controller, dry, random);
+      expect(controller.state).toBe('locked_out');
+    });
+  });
+});
@@ -0,0 +1,182 @@
+/**
+ * 浇水事件检测器属性测试
+ * 验证CUSUM阶跃检测的灵敏度与抗噪性
+ */
+
+import fc from 'fast-check';
+
+const DETECT_INTERVAL = 500;
+const DRIFT = 1.0;
+const THRESHOLD = 12.0;
+const MIN_STEP = 5.0;
+const BASELINE_ALPHA = 0.05;
+const HOLDOFF_MS = 30000;
+
+type Random = () => number;
+type Reading = (t: number) => number;
+
+// 模拟浇水事件检测器（对应固件中的WateringEventDetector逻辑）
+class MockWateringEventDetector {
+  detections: number[] = [];
+  private baselineValid = false;
+  private baseline = 0;
+  private cusum = 0;
+  private inHoldoff = false;
+  private holdoffStartTime = 0;
+
+  onSample(now: number, moisture: number): void {
+    if (!this.baselineValid) {
+      this.baseline = moisture;
+      this.baselineValid = true;
+      this.cusum = 0;
+      return;
+    }
+
+    if (this.inHoldoff) {
+      if (moisture > this.baseline) {
+        this.baseline = moisture;
+        this.holdoffStartTime = now;
+      } else if (now - this.holdoffStartTime >= HOLDOFF_MS) {
+        this.inHoldoff = false;
+        this.cusum = 0;
+      }
+      return;
+    }
+
+    const deviation = moisture - this.baseline;
+    this.cusum = Math.max(0, this.cusum + deviation - DRIFT);
+
+    if (this.cusum >= THRESHOLD && deviation >= MIN_STEP) {
+      this.detections.push(now);
+      this.baseline = moisture;
+      this.cusum = 0;
+      this.inHoldoff = true;
+      this.holdoffStartTime = now;
+      return;
+    }
+
+    if (this.cusum === 0) {
+      this.baseline += (moisture - this.baseline) * BASELINE_ALPHA;
+    }
+  }
+}
+
+function lcg(seed: number): Random {
+  let s = seed >>> 0;
+  return () => {
+    s = (s * 1664525 + 1013904223) >>> 0;
+    return s / 0x100000000;
+  };
+}
+
+/**
+ * 浇水后探头读数：经过延迟后按一阶响应上升到新水平
+ */
+function moistureAt(t: number, start: number, pourAt: number, rise: number, delayMs: number, tauMs: number,
+                    dryingPerHour: number): number {
+  let value = start - dryingPerHour * t / 3600000;
+  if (t > pourAt + delayMs) {
+    value += rise * (1 - Math.exp(-(t - pourAt - delayMs) / tauMs));
+  }
+  return value;
+}
+
+function run(durationMs: number, reading: Reading): MockWateringEventDetector {
+  const detector = new MockWateringEventDetector();
+  for (let t = 0; t <= durationMs; t += DETECT_INTERVAL) {
+    detector.onSample(t, reading(t));
+  }
+  return detector;
+}
+
+describe('浇水事件检测器属性测试', () => {
+  describe('属性: 灵敏度', () => {
+    test('Property: 浇水阶跃在响应开始后数秒内被检测到', () => {
+      fc.assert(
+        fc.property(
+          fc.float({ min: 5, max: 30, noNaN: true }),
+          fc.float({ min: 10, max: 50, noNaN: true }),
+          fc.integer({ min: 0, max: 5000 }),
+          fc.integer({ min: 200, max: 3000 }),
+          fc.integer({ min: 1, max: 0x7fffffff }),
+          (start, rise, delayMs, tauMs, seed) => {
+            const random = lcg(seed);
+            const pourAt = 60000;
+            const detector = run(180000, t =>
+              moistureAt(t, start, pourAt, rise, delayMs, tauMs, 0.5) + (random() * 2 - 1) * 0.5);
+            return detector.detections.length === 1 &&
+                   detector.detections[0] >= pourAt &&
+                   detector.detections[0] - (pourAt + delayMs) <= 5000;
+          }
+        ),
+        { numRuns: 100 }
+      );
+    });
+
+    test('Property: 同一次浇水的持续下渗只触发一次', () => {
+      fc.assert(
+        fc.property(
+          fc.float({ min: 20, max: 50, noNaN: true }),
+          fc.integer({ min: 5000, max: 20000 }),
+          (rise, tauMs) => {
+            const detector = run(300000, t => moistureAt(t, 15, 30000, rise, 0, tauMs, 0));
+            return detector.detections.length === 1;
+          }
+        ),
+        { numRuns: 50 }
+      );
+    });
+
+    test('Property: 间隔足够的两次浇水分别被检测', () => {
+      const detector = run(300000, t =>
+        moistureAt(t, 10, 30000, 15, 0, 1000, 0) + moistureAt(t, 0, 150000, 15, 0, 1000, 0));
+      expect(detector.detections.length).toBe(2);
+    });
+  });
+
+  describe('属性: 抗噪性', () => {
+    test('Property: 仅有传感器噪声时从不误报', () => {
+      fc.assert(
+        fc.property(
+          fc.float({ min: 5, max: 60, noNaN: true }),
+          fc.float({ min: 0, max: Math.fround(1.5), noNaN: true }),
+          fc.integer({ min: 1, max: 0x7fffffff }),
+          (level, noise, seed) => {
+            const random = lcg(seed);
+            const detector = run(600000, () => level + (random() * 2 - 1) * noise);
+            return detector.detections.length === 0;
+          }
+        ),
+        { numRuns: 100 }
+      );
+    });
+
+    test('Property: 缓慢漂移 (蒸发、温漂) 不触发', () => {
+      fc.assert(
+        fc.property(
+          fc.float({ min: 20, max: 60, noNaN: true }),
+          fc.float({ min: -10, max: 10, noNaN: true }),
+          (level, driftPerHour) => {
+            const detector = run(3600000, t => level + driftPerHour * t / 3600000);
+            return detector.detections.length === 0;
+          }
+        ),
+        { numRuns: 50 }
+      );
+    });
+
+    test('Property: 低于最小阶跃的小幅上升不触发', () => {
+      fc.assert(
+        fc.property(
+          fc.float({ min: 5, max: 40, noNaN: true }),
+          fc.float({ min: 0, max: Math.fround(4.5), noNaN: true }),
+          (start, rise) => {
+            const detector = run(180000, t => moistureAt(t, start, 60000, rise, 0, 1000, 0));
+            return detector.detections.length === 0;
+          }
+        ),
+        { numRuns: 50 }
+      );
+    });
+  });
+});